@@ -15,11 +15,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 uniform vec2 corner;
 uniform vec2 dimensions;
+// The part of the mask that the drawn rectangle covers.
+uniform vec2 texCorner;
+uniform vec2 texDimensions;
 
 in vec2 vert;
 out vec2 fragTexCoord;
 
 void main() {
 	gl_Position = vec4(corner + vert * dimensions, 0, 1);
-	fragTexCoord = vert;
+	fragTexCoord = texCorner + vert * texDimensions;
 }
@@ -18,6 +18,9 @@ precision mediump float;
 // The user must supply a texture and a color (white by default).
 uniform sampler2D tex;
 uniform vec4 color;
+// Whether the texture holds signed distance fields in its red channel, with the
+// glyph outlines at 0.5, rather than the glyphs' coverage in its alpha channel.
+uniform bool distanceField;
 
 // This comes from the vertex shader.
 in vec2 texCoord;
@@ -27,5 +30,13 @@ out vec4 finalColor;
 
 // Multiply the texture by the user-specified color (including alpha).
 void main() {
-	finalColor = texture(tex, texCoord).a * color;
+	if(distanceField)
+	{
+		// Blend across about one screen pixel around the outline, whatever the scale.
+		float distance = texture(tex, texCoord).r;
+		float width = .7 * fwidth(distance);
+		finalColor = smoothstep(.5 - width, .5 + width, distance) * color;
+	}
+	else
+		finalColor = texture(tex, texCoord).a * color;
 }
@@ -17,10 +17,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 uniform vec2 scale;
 // The (x, y) coordinates of the top left corner of the glyph.
 uniform vec2 position;
-// The glyph to draw. (ASCII value - 32).
+// The glyph to draw: its cell in the atlas, counting along each row in turn.
 uniform int glyph;
-// Number of glyphs in the atlas row (98 or 164 for extended/Cyrillic).
-uniform int glyphCount;
+// Number of columns and rows of glyph cells in the atlas.
+uniform ivec2 grid;
 // Aspect ratio of rendered glyph (unity by default).
 uniform float aspect;
 // Glyph size (in pixels).
@@ -35,7 +35,8 @@ out vec2 texCoord;
 
 // Pick the proper glyph out of the texture.
 void main() {
-	texCoord = vec2((float(glyph) + corner.x) / float(glyphCount), corner.y);
+	ivec2 cell = ivec2(glyph % grid.x, glyph / grid.x);
+	texCoord = (vec2(cell) + corner) / vec2(grid);
 	vec2 pos = vert * glyphSize;
 	gl_Position = vec4((aspect * pos.x + position.x) * scale.x, (pos.y + position.y) * scale.y, 0.f, 1.f);
 }
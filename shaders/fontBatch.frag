@@ -0,0 +1,40 @@
+/* fontBatch.frag
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+precision mediump float;
+
+// The glyph atlas, drawn the same way as by the font shader.
+uniform sampler2D tex;
+uniform bool distanceField;
+
+// This comes from the vertex shader.
+in vec2 texCoord;
+in vec4 color;
+
+// Output color.
+out vec4 finalColor;
+
+// Multiply the texture by the text's color (including alpha).
+void main() {
+	if(distanceField)
+	{
+		// Blend across about one screen pixel around the outline, whatever the scale.
+		float distance = texture(tex, texCoord).r;
+		float width = .7 * fwidth(distance);
+		finalColor = smoothstep(.5 - width, .5 + width, distance) * color;
+	}
+	else
+		finalColor = texture(tex, texCoord).a * color;
+}
@@ -0,0 +1,33 @@
+/* fontBatch.vert
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// scale maps pixel coordinates to GL coordinates (-1 to 1).
+uniform vec2 scale;
+
+// Each vertex is the corner of one glyph, with its position in pixels, its
+// place in the atlas, and the color of the text it belongs to.
+in vec2 vert;
+in vec2 corner;
+in vec4 vertColor;
+
+// Output to the fragment shader.
+out vec2 texCoord;
+out vec4 color;
+
+void main() {
+	texCoord = corner;
+	color = vertColor;
+	gl_Position = vec4(vert * scale, 0.f, 1.f);
+}
@@ -0,0 +1,52 @@
+/* lineInstanced.vert
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+precision mediump float;
+
+uniform vec2 scale;
+
+in vec2 vert;
+// The remaining inputs are the same for every vertex of one instance.
+in highp vec2 start;
+in highp vec2 end;
+in float width;
+// 1 if the line has round caps, and 0 if it does not.
+in float cap;
+in vec4 startColor;
+in vec4 endColor;
+
+out vec2 pos;
+out vec4 color;
+flat out highp vec2 fragStart;
+flat out highp vec2 fragEnd;
+flat out float fragWidth;
+flat out float fragCap;
+
+void main() {
+	// This constructs the same rectangle around the line as the regular line shader.
+	vec2 unit = normalize(end - start);
+	highp vec2 origin = vert.y > 0.0 ? start : end;
+	color = vert.y > 0.0 ? startColor : endColor;
+	float widthOffset = width + 1.;
+	float capOffset = (cap > .5) ? widthOffset : 1.;
+	pos = origin + vec2(unit.y, -unit.x) * vert.x * widthOffset - unit * capOffset * vert.y;
+	gl_Position = vec4(pos / scale, 0, 1);
+	gl_Position.y = -gl_Position.y;
+	gl_Position.xy *= 2.0;
+	fragStart = start;
+	fragEnd = end;
+	fragWidth = width;
+	fragCap = cap;
+}
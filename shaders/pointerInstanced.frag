@@ -0,0 +1,30 @@
+/* pointerInstanced.frag
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+precision mediump float;
+
+in vec2 coord;
+flat in vec2 fragSize;
+flat in vec4 fragColor;
+out vec4 finalColor;
+
+void main() {
+	float height = (coord.x + coord.y) / fragSize.x;
+	float taper = height * height * height;
+	taper *= taper * .5 * fragSize.x;
+	float alpha = clamp(.8 * min(coord.x, coord.y) - taper, 0.f, 1.f);
+	alpha *= clamp(1.8 * (1. - height), 0.f, 1.f);
+	finalColor = fragColor * alpha;
+}
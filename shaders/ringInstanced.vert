@@ -0,0 +1,39 @@
+/* ringInstanced.vert
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+precision mediump float;
+
+uniform vec2 scale;
+
+in vec2 vert;
+// The remaining inputs are the same for every vertex of one instance.
+in vec2 position;
+// The radius, width, angle, and start angle of the ring.
+in vec4 shape;
+in float dash;
+in vec4 color;
+
+out vec2 coord;
+flat out vec4 fragShape;
+flat out float fragDash;
+flat out vec4 fragColor;
+
+void main() {
+	coord = (shape.x + shape.y) * vert;
+	gl_Position = vec4((coord + position) * scale, 0.f, 1.f);
+	fragShape = shape;
+	fragDash = dash;
+	fragColor = color;
+}
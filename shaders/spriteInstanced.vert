@@ -0,0 +1,44 @@
+/* spriteInstanced.vert
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+precision mediump float;
+
+uniform vec2 scale;
+
+in vec2 vert;
+// The remaining inputs are the same for every vertex of one instance.
+in vec2 position;
+in vec4 transform;
+in vec2 blur;
+// The frame, clip, alpha, and swizzle mode: 0 for none, 1 for a swizzle that
+// applies to the whole sprite, and 2 for one that is limited by the swizzle mask.
+in vec4 parameters;
+// The index of the swizzle matrix in the palette.
+in float swizzle;
+
+out vec2 fragTexCoord;
+flat out vec2 fragBlur;
+flat out vec4 fragParameters;
+flat out int fragSwizzle;
+
+void main() {
+	vec2 blurOff = 2.f * vec2(vert.x * abs(blur.x), vert.y * abs(blur.y));
+	gl_Position = vec4((mat2(transform) * (vert + blurOff) + position) * scale, 0, 1);
+	vec2 texCoord = vert + vec2(.5, .5);
+	fragTexCoord = vec2(texCoord.x, min(parameters.y, texCoord.y)) + blurOff;
+	fragBlur = blur;
+	fragParameters = parameters;
+	fragSwizzle = int(swizzle);
+}
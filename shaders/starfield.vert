@@ -19,15 +19,85 @@ uniform vec2 scale;
 uniform float elongation;
 uniform float brightness;
 
-in vec2 offset;
-in float size;
-in float corner;
+// The stars are not stored anywhere. Instead, the field is split into a grid of
+// cells, each with a few slots that may hold a star, and each vertex works out
+// which cell and slot it belongs to from its index alone. Hashing the cell's
+// coordinates then gives the same star in that slot every frame.
+uniform ivec2 firstCell;
+uniform int columns;
+uniform int slots;
+uniform float cellSize;
+// The star pattern repeats after this many cells. This must be a power of two.
+uniform int wrapCells;
+// Each parallax layer has its own stars.
+uniform int layer;
+// The chance of a slot holding a star, for the densest part of the field.
+uniform float slotChance;
+
 out float fragmentAlpha;
 out vec2 coord;
 
+// The corners of the two triangles that make up each star.
+const vec2 CORNERS[6] = vec2[6](vec2(0., 1.), vec2(1., 0.), vec2(-1., 0.),
+	vec2(1., 0.), vec2(-1., 0.), vec2(0., -1.));
+
+uint Hash(uint x) {
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+float Random(inout uint state) {
+	state = Hash(state);
+	return float(state >> 8) * (1. / 16777216.);
+}
+
+// Get how dense the stars are around the given point, as smooth noise that
+// repeats along with the stars. This clumps the stars together, which is more
+// interesting to look at than if they were evenly spread out.
+float Noise(vec2 position, float period) {
+	int mask = int(float(wrapCells) * cellSize / period) - 1;
+	vec2 grid = position / period;
+	ivec2 cell = ivec2(floor(grid));
+	vec2 t = grid - vec2(cell);
+	t = t * t * (3. - 2. * t);
+
+	float corner[4];
+	for(int i = 0; i < 4; ++i)
+	{
+		ivec2 lattice = (cell + ivec2(i & 1, i >> 1)) & mask;
+		corner[i] = float(Hash(uint(lattice.x) ^ Hash(uint(lattice.y) + 0x68e31da4u)) >> 8) * (1. / 16777216.);
+	}
+	return mix(mix(corner[0], corner[1], t.x), mix(corner[2], corner[3], t.x), t.y);
+}
+
 void main() {
+	int star = gl_VertexID / 6;
+	int cellIndex = star / slots;
+	int slot = star - cellIndex * slots;
+	ivec2 offset = ivec2(cellIndex % columns, cellIndex / columns);
+	ivec2 cell = (firstCell + offset) & (wrapCells - 1);
+
+	uint state = Hash(uint(cell.x) ^ Hash(uint(cell.y) ^ Hash(uint(slot) + uint(layer) * 0x9e3779b9u)));
+	vec2 position = (vec2(offset) + vec2(Random(state), Random(state))) * cellSize;
+	float size = 1.25 + floor(Random(state) * 16.) * .0625;
+
+	vec2 center = (vec2(cell) + .5) * cellSize;
+	float density = smoothstep(.2, .8, .65 * Noise(center, 512.) + .35 * Noise(center, 128.));
+	if(Random(state) >= density * slotChance)
+	{
+		// Move every corner of an empty slot to the same point off screen, so nothing is drawn.
+		fragmentAlpha = 0.;
+		coord = vec2(0., 0.);
+		gl_Position = vec4(2., 2., 0., 1.);
+		return;
+	}
+
 	fragmentAlpha = brightness * (4. / (4. + elongation)) * size * .2 + .05;
-	coord = vec2(sin(corner), cos(corner));
+	coord = CORNERS[gl_VertexID % 6];
 	vec2 elongated = vec2(coord.x * size, coord.y * (size + elongation));
-	gl_Position = vec4((rotate * elongated + translate + offset) * scale, 0, 1);
+	gl_Position = vec4((rotate * elongated + translate + position) * scale, 0, 1);
 }
@@ -42,12 +42,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Preferences.h"
 #include "Random.h"
 #include "RoutePlan.h"
+#include "RouteTable.h"
 #include "Ship.h"
 #include "ship/ShipAICache.h"
 #include "ShipEvent.h"
 #include "ShipJumpNavigation.h"
 #include "StellarObject.h"
 #include "System.h"
+#include "TaskQueue.h"
 #include "UI.h"
 #include "Weapon.h"
 #include "Wormhole.h"
@@ -249,9 +251,8 @@ namespace {
 			for(Ship *ship : toDeploy)
 				ship->SetDeployOrder(true);
 			size_t count = toDeploy.size();
-			map<string, string> rep = {{"count", to_string(count)},
-				{"noun", Translation::Tr(count == 1 ? "message.ship" : "message.ships")}};
-			Messages::Add({Translation::Tr("message.deployed_carried", rep),
+			Messages::Add({Translation::Tr("message.deployed_carried", {{"count", to_string(count)},
+					{"noun", Translation::Tr(count == 1 ? "message.ship" : "message.ships")}}),
 				GameData::MessageCategories().Get("normal")});
 		}
 		// Otherwise, instruct the carried ships to return to their berth.
@@ -260,9 +261,8 @@ namespace {
 			for(Ship *ship : toRecall)
 				ship->SetDeployOrder(false);
 			size_t count = toRecall.size();
-			map<string, string> rep = {{"count", to_string(count)},
-				{"noun", Translation::Tr(count == 1 ? "message.ship" : "message.ships")}};
-			Messages::Add({Translation::Tr("message.recalled_carried", rep),
+			Messages::Add({Translation::Tr("message.recalled_carried", {{"count", to_string(count)},
+					{"noun", Translation::Tr(count == 1 ? "message.ship" : "message.ships")}}),
 				GameData::MessageCategories().Get("normal")});
 		}
 	}
@@ -399,12 +399,48 @@ namespace {
 	// another in case they become too close.
 	constexpr double SCATTER_TOO_CLOSE = 20. * 20.;
 	constexpr double SCATTER_TRACK = 100. * 100.;
+
+	// The number of firing decisions to evaluate at once on each thread.
+	constexpr size_t FIRING_CHUNK_SIZE = 16;
+
+	// The most that FindTarget's preferences (for its old target, for foes who
+	// have plundered it, and for foes it can plunder) can lower the effective
+	// range of a foe, with some slack. Foes farther away than this beyond the
+	// search range can never be picked.
+	constexpr double MAX_TARGET_RANGE_BONUS = 4000.;
+
+	// Ships that are farther than this from the player's flagship, and that have
+	// nothing to do with the player or with any fight, only decide what to do
+	// once every LOD_INTERVAL steps. This must be a power of two.
+	constexpr double LOD_DISTANCE = 6000.;
+	constexpr int LOD_INTERVAL = 4;
+
+	// Check if the given ship is idle enough, and far enough from the player,
+	// that it can keep following its previous commands for a few steps.
+	bool IsDistantAndIdle(const Ship &ship, const Ship *flagship)
+	{
+		if(ship.IsYours() || ship.CanBeCarried() || ship.IsFleeing() || ship.IsBoarding()
+				|| ship.IsHyperspacing() || ship.Zoom() < 1. || ship.FiringCommands().IsFiring())
+			return false;
+		if(ship.GetTargetShip() || ship.GetTargetAsteroid() || ship.GetTargetFlotsam() || ship.GetShipToAssist())
+			return false;
+		shared_ptr<Ship> parent = ship.GetParent();
+		if(parent && parent->IsYours())
+			return false;
+		// Ships in other systems are always far enough away.
+		if(!flagship || flagship->GetSystem() != ship.GetSystem())
+			return true;
+		if(flagship->GetTargetShip().get() == &ship)
+			return false;
+		return ship.Position().Distance(flagship->Position()) > LOD_DISTANCE;
+	}
 }
 
 
 
-AI::AI(PlayerInfo &player, const List<Ship> &ships, const List<Minable> &minables, const List<Flotsam> &flotsam)
-	: player(player), ships(ships), minables(minables), flotsam(flotsam), routeCache()
+AI::AI(PlayerInfo &player, const Array<Ship> &ships, const List<Minable> &minables, const Array<Flotsam> &flotsam)
+	: player(player), ships(ships), minables(minables), flotsam(flotsam),
+	shipIndex(1024u, 64u, CollisionType::SHIP), routeCache()
 {
 	// Allocate a starting amount of hardpoints for ships.
 	firingCommands.SetHardpoints(12);
@@ -473,16 +509,14 @@ void AI::IssueFormationChange(PlayerInfo &player)
 	}
 
 	unsigned int count = targetShips.size();
-	map<string, string> rep = {{"count", to_string(count)},
-		{"noun", Translation::Tr(count == 1 ? "message.ship" : "message.ships")}};
+	const string countText = to_string(count);
+	const string noun = Translation::Tr(count == 1 ? "message.ship" : "message.ships");
 	string message;
 	if(toSet)
-	{
-		rep["name"] = Translation::TrFormation(toSet->TrueName());
-		message = Translation::Tr("message.ships_will_assume_formation", rep);
-	}
+		message = Translation::Tr("message.ships_will_assume_formation", {{"count", countText}, {"noun", noun},
+			{"name", Translation::TrFormation(toSet->TrueName())}});
 	else
-		message = Translation::Tr("message.ships_will_no_formation", rep);
+		message = Translation::Tr("message.ships_will_no_formation", {{"count", countText}, {"noun", noun}});
 	Messages::Add({message, GameData::MessageCategories().Get("low")});
 }
 
@@ -496,10 +530,8 @@ void AI::IssueShipTarget(const shared_ptr<Ship> &target)
 		target->IsDisabled() ? Orders::Types::FINISH_OFF : Orders::Types::ATTACK
 		: Orders::Types::KEEP_STATION);
 	newOrder.SetTargetShip(target);
-	{
-		map<string, string> rep = {{"name", target->GivenName()}};
-		IssueOrder(newOrder, Translation::Tr(isEnemy ? "message.focusing_fire_on" : "message.following", rep));
-	}
+	IssueOrder(newOrder, Translation::Tr(isEnemy ? "message.focusing_fire_on" : "message.following",
+		{{"name", target->GivenName()}}));
 }
 
 
@@ -508,10 +540,8 @@ void AI::IssueAsteroidTarget(const shared_ptr<Minable> &targetAsteroid)
 {
 	OrderSingle newOrder{Orders::Types::MINE};
 	newOrder.SetTargetAsteroid(targetAsteroid);
-	{
-		map<string, string> rep = {{"name", targetAsteroid->DisplayName()}, {"noun", targetAsteroid->Noun()}};
-		IssueOrder(newOrder, Translation::Tr("message.focusing_fire_asteroid", rep));
-	}
+	IssueOrder(newOrder, Translation::Tr("message.focusing_fire_asteroid",
+		{{"name", targetAsteroid->DisplayName()}, {"noun", targetAsteroid->Noun()}}));
 }
 
 
@@ -523,10 +553,7 @@ void AI::IssueMoveTarget(const Point &target, const System *moveToSystem)
 	newOrder.SetTargetSystem(moveToSystem);
 	string description = Translation::Tr("message.moving_to_location");
 	if(player.GetSystem() != moveToSystem)
-	{
-		map<string, string> rep = {{"system", moveToSystem->DisplayName()}};
-		description += Translation::Tr("message.moving_to_system", rep);
-	}
+		description += Translation::Tr("message.moving_to_system", {{"system", moveToSystem->DisplayName()}});
 	else
 		description += ".";
 	IssueOrder(newOrder, description);
@@ -594,10 +621,7 @@ void AI::UpdateKeys(PlayerInfo &player, const Command &activeCommands)
 	{
 		OrderSingle newOrder{target->IsDisabled() ? Orders::Types::FINISH_OFF : Orders::Types::ATTACK};
 		newOrder.SetTargetShip(target);
-		{
-			map<string, string> rep = {{"name", target->GivenName()}};
-			IssueOrder(newOrder, Translation::Tr("message.focusing_fire_on", rep));
-		}
+		IssueOrder(newOrder, Translation::Tr("message.focusing_fire_on", {{"name", target->GivenName()}}));
 	}
 	else if(activeCommands.Has(Command::FIGHT) && !shift && targetAsteroid)
 		IssueAsteroidTarget(targetAsteroid);
@@ -633,7 +657,7 @@ void AI::UpdateKeys(PlayerInfo &player, const Command &activeCommands)
 
 
 
-void AI::UpdateEvents(const list<ShipEvent> &events)
+void AI::UpdateEvents(const vector<ShipEvent> &events)
 {
 	for(const ShipEvent &event : events)
 	{
@@ -643,18 +667,21 @@ void AI::UpdateEvents(const list<ShipEvent> &events)
 
 		if(event.Actor())
 		{
-			actions[event.Actor()][target] |= event.Type();
+			const uint64_t targetId = GetState(*target).id;
+			ShipState &actorState = GetState(*event.Actor());
+			actorState.actions[targetId] |= event.Type();
 			if(event.TargetGovernment())
-				notoriety[event.Actor()][event.TargetGovernment()] |= event.Type();
+				actorState.notoriety[event.TargetGovernment()] |= event.Type();
 		}
 
 		const auto &actorGovernment = event.ActorGovernment();
 		if(actorGovernment)
 		{
-			governmentActions[actorGovernment][target] |= event.Type();
+			ShipState &state = GetState(*target);
+			state.governmentActions[actorGovernment] |= event.Type();
 			if(actorGovernment->IsPlayer() && event.TargetGovernment())
 			{
-				int &bitmap = playerActions[target];
+				int &bitmap = state.playerActions;
 				int newActions = event.Type() - (event.Type() & bitmap);
 				bitmap |= event.Type();
 				// If you provoke the same ship twice, it should have an effect both times.
@@ -673,27 +700,15 @@ void AI::UpdateEvents(const list<ShipEvent> &events)
 void AI::Clean()
 {
 	// Records of what various AI ships and factions have done.
-	actions.clear();
-	notoriety.clear();
-	governmentActions.clear();
 	scanPermissions.clear();
-	playerActions.clear();
-	swarmCount.clear();
-	fenceCount.clear();
-	cargoScans.clear();
-	outfitScans.clear();
-	scanTime.clear();
-	miningAngle.clear();
-	miningRadius.clear();
-	miningTime.clear();
-	appeasementThreshold.clear();
-	boarders.clear();
-	closeBy.clear();
+	// Records of individual ships, apart from who has been asked to help them.
+	for(ShipState &state : shipStates)
+		state.Clear();
+	boarderCount = 0;
 	routeCache.clear();
 	// Records for formations flying around lead ships and other objects.
 	formations.clear();
 	// Records that affect the combat behavior of various governments.
-	shipStrength.clear();
 	enemyStrength.clear();
 	allyStrength.clear();
 }
@@ -704,7 +719,8 @@ void AI::Clean()
 // when the player lands, but not when they change systems.
 void AI::ClearOrders()
 {
-	helperList.clear();
+	for(ShipState &state : shipStates)
+		state.helper.reset();
 	orders.clear();
 }
 
@@ -715,27 +731,26 @@ void AI::Step(Command &activeCommands)
 	// First, figure out the comparative strengths of the present governments.
 	const System *playerSystem = player.GetSystem();
 	map<const Government *, int64_t> strength;
+	ReleaseStates();
 	UpdateStrengths(strength, playerSystem);
 	CacheShipLists();
 
 	// Update the counts of how long ships have been outside the "invisible fence."
-	// If a ship ceases to exist, this also ensures that it will be removed from
-	// the fence count map after a few seconds.
-	for(auto it = fenceCount.begin(); it != fenceCount.end(); )
-	{
-		it->second -= FENCE_DECAY;
-		if(it->second < 0)
-			it = fenceCount.erase(it);
-		else
-			++it;
-	}
+	// Once a ship has been back inside for a few seconds, it no longer has a count.
+	for(ShipState &state : shipStates)
+		if(state.fenceCount)
+		{
+			*state.fenceCount -= FENCE_DECAY;
+			if(*state.fenceCount < 0)
+				state.fenceCount.reset();
+		}
 	for(const auto &it : ships)
 	{
 		const System *system = it->GetActualSystem();
 		if(system && it->Position().Length() >= system->InvisibleFenceRadius())
 		{
-			int &value = fenceCount[&*it];
-			value = min(FENCE_MAX, value + FENCE_DECAY + 1);
+			optional<int> &count = GetState(*it).fenceCount;
+			count = min(FENCE_MAX, count.value_or(0) + FENCE_DECAY + 1);
 		}
 	}
 
@@ -746,6 +761,7 @@ void AI::Step(Command &activeCommands)
 			positionerIt.second.Step();
 
 	const Ship *flagship = player.Flagship();
+	firingPlanCount = 0;
 	// Step increments from 0 to 62. Using a bitwise and instead of a modulus for the better performance it provides,
 	// even if it's minor. This means that things occur slightly off of exactly once per second, but the difference in
 	// behavior between the two methods is negligible.
@@ -759,6 +775,8 @@ void AI::Step(Command &activeCommands)
 	const int maxMinerCount = minables.empty() ? 0 : 9;
 	bool opportunisticEscorts = !Preferences::Has("Turrets focus fire");
 	bool fightersRetreat = Preferences::Has("Damaged fighters retreat");
+	bool reduceDistantAI = Preferences::Has("Reduce distant ship AI");
+	int lodTurn = 0;
 	const int npcMaxMiningTime = GameData::GetGamerules().NPCMaxMiningTime();
 	for(const auto &it : ships)
 	{
@@ -801,7 +819,7 @@ void AI::Step(Command &activeCommands)
 				if(personality.IsAppeasing())
 				{
 					double health = .5 * it->Shields() + it->Hull();
-					double &threshold = appeasementThreshold[it.get()];
+					double &threshold = GetState(*it).appeasementThreshold;
 					threshold = max((1. - health) + .1, threshold);
 				}
 				continue;
@@ -810,6 +828,15 @@ void AI::Step(Command &activeCommands)
 		// Overheated ships are effectively disabled, and cannot fire, cloak, etc.
 		if(it->IsOverheated())
 			continue;
+		// Distant ships that are not doing anything important only make a new
+		// decision on one step in LOD_INTERVAL, spread out so that only some of
+		// them do so on each step. In between, they keep their previous commands.
+		if(reduceDistantAI && IsDistantAndIdle(*it, flagship))
+		{
+			lodTurn = (lodTurn + 1) & (LOD_INTERVAL - 1);
+			if(lodTurn != (step & (LOD_INTERVAL - 1)))
+				continue;
+		}
 
 		Command command;
 		firingCommands.SetHardpoints(it->Weapons().size());
@@ -865,11 +892,12 @@ void AI::Step(Command &activeCommands)
 			if((cargoScan || outfitScan) && target && !target->IsDisabled()
 				&& !target->GetGovernment()->IsEnemy(gov) && target->GetGovernment() != gov)
 			{
-				++scanTime[&*it];
+				ShipState &state = GetState(*it);
+				++state.scanTime;
 				if(it->CargoScanFraction() == 1.)
-					cargoScans[&*it].insert(&*target);
+					state.cargoScans.insert(&*target);
 				if(it->OutfitScanFraction() == 1.)
-					outfitScans[&*it].insert(&*target);
+					state.outfitScans.insert(&*target);
 			}
 		}
 		if(isPresent && !personality.IsSwarming())
@@ -885,21 +913,20 @@ void AI::Step(Command &activeCommands)
 				it->SetTargetShip(target);
 			}
 		}
-		if(isPresent)
+		// Ships that are present aim their turrets and fire their weapons, but that
+		// is only evaluated once every ship has decided what it is going to do.
+		const bool opportunistic = it->IsYours() ? opportunisticEscorts : personality.IsOpportunistic();
+		auto queueFiring = [&]() -> void
 		{
-			AimTurrets(*it, firingCommands, it->IsYours() ? opportunisticEscorts : personality.IsOpportunistic());
-			if(targetAsteroid)
-				AutoFire(*it, firingCommands, *targetAsteroid);
-			else
-				AutoFire(*it, firingCommands);
-		}
+			QueueFiring(*it, isPresent, opportunistic, targetAsteroid.get());
+		};
 
 		// If this ship is hyperspacing, or in the act of
 		// launching or landing, it can't do anything else.
 		if(it->IsHyperspacing() || it->Zoom() < 1.)
 		{
 			it->SetCommands(command);
-			it->SetCommands(firingCommands);
+			queueFiring();
 			continue;
 		}
 
@@ -948,7 +975,7 @@ void AI::Step(Command &activeCommands)
 			}
 			// Appeasing ships jettison cargo to distract their pursuers.
 			if(personality.IsAppeasing() && it->Cargo().Used())
-				DoAppeasing(it, &appeasementThreshold[it.get()]);
+				DoAppeasing(it, &GetState(*it).appeasementThreshold);
 		}
 
 		// If recruited to assist a ship, follow through on the commitment
@@ -979,7 +1006,7 @@ void AI::Step(Command &activeCommands)
 			{
 				it->SetTargetShip(shipToAssist);
 				it->SetCommands(command);
-				it->SetCommands(firingCommands);
+				queueFiring();
 				continue;
 			}
 		}
@@ -1011,7 +1038,7 @@ void AI::Step(Command &activeCommands)
 			// Flock between allied, in-system ships.
 			DoSwarming(*it, command, target);
 			it->SetCommands(command);
-			it->SetCommands(firingCommands);
+			queueFiring();
 			continue;
 		}
 
@@ -1031,7 +1058,7 @@ void AI::Step(Command &activeCommands)
 		{
 			DoSurveillance(*it, command, target);
 			it->SetCommands(command);
-			it->SetCommands(firingCommands);
+			queueFiring();
 			continue;
 		}
 
@@ -1039,7 +1066,7 @@ void AI::Step(Command &activeCommands)
 		if(isPresent && personality.Harvests() && DoHarvesting(*it, command))
 		{
 			it->SetCommands(command);
-			it->SetCommands(firingCommands);
+			queueFiring();
 			continue;
 		}
 
@@ -1049,7 +1076,7 @@ void AI::Step(Command &activeCommands)
 			// Miners with free cargo space and available mining time should mine. Mission NPCs
 			// should mine even if there are other miners or they have been mining a while.
 			if(it->Cargo().Free() >= 5 && IsArmed(*it) && (it->IsSpecial()
-					|| (++miningTime[&*it] < npcMaxMiningTime && ++minerCount < maxMinerCount)))
+					|| (++GetState(*it).miningTime < npcMaxMiningTime && ++minerCount < maxMinerCount)))
 			{
 				if(it->HasBays())
 				{
@@ -1058,12 +1085,12 @@ void AI::Step(Command &activeCommands)
 				}
 				DoMining(*it, command);
 				it->SetCommands(command);
-				it->SetCommands(firingCommands);
+				queueFiring();
 				continue;
 			}
 			// Fighters and drones should assist their parent's mining operation if they cannot
 			// carry ore, and the asteroid is near enough that the parent can harvest the ore.
-			if(it->CanBeCarried() && parent && miningTime[parent.get()] < 3601)
+			if(it->CanBeCarried() && parent && GetState(*parent).miningTime < 3601)
 			{
 				const shared_ptr<Minable> &minable = parent->GetTargetAsteroid();
 				if(minable && minable->Position().Distance(parent->Position()) < 600.)
@@ -1072,7 +1099,7 @@ void AI::Step(Command &activeCommands)
 					MoveToAttack(*it, command, *minable);
 					AutoFire(*it, firingCommands, *minable);
 					it->SetCommands(command);
-					it->SetCommands(firingCommands);
+					queueFiring();
 					continue;
 				}
 			}
@@ -1096,7 +1123,7 @@ void AI::Step(Command &activeCommands)
 				// Find the possible parents for orphaned fighters and drones.
 				auto parentChoices = vector<shared_ptr<Ship>>{};
 				parentChoices.reserve(ships.size() * .1);
-				auto getParentFrom = [&it, &gov, &parentChoices](const list<shared_ptr<Ship>> &otherShips) -> shared_ptr<Ship>
+				auto getParentFrom = [&it, &gov, &parentChoices](const auto &otherShips) -> shared_ptr<Ship>
 				{
 					for(const auto &other : otherShips)
 						if(other->GetGovernment() == gov && other->GetSystem() == it->GetSystem() && !other->CanBeCarried())
@@ -1167,7 +1194,7 @@ void AI::Step(Command &activeCommands)
 				MoveTo(*it, command, parent->Position(), parent->Velocity(), 40., .8);
 				command |= Command::BOARD;
 				it->SetCommands(command);
-				it->SetCommands(firingCommands);
+				queueFiring();
 				continue;
 			}
 			// If we get here, it means that the ship has not decided to return
@@ -1274,8 +1301,13 @@ void AI::Step(Command &activeCommands)
 		DoScatter(*it, command, scatterTurn == step);
 
 		it->SetCommands(command);
-		it->SetCommands(firingCommands);
+		queueFiring();
 	}
+
+	FireQueued();
+
+	// Once this step is over, the ships will move, so the index is out of date.
+	hasShipIndex = false;
 }
 
 
@@ -1377,6 +1409,97 @@ bool AI::RouteCacheKey::operator!=(const RouteCacheKey &other) const
 
 
 
+// Forget everything that Clean() is supposed to forget.
+void AI::ShipState::Clear()
+{
+	const Ship *keepShip = ship;
+	weak_ptr<const Ship> keepOwner = std::move(owner);
+	const uint64_t keepId = id;
+	optional<weak_ptr<Ship>> keepHelper = std::move(helper);
+	*this = ShipState();
+	ship = keepShip;
+	owner = std::move(keepOwner);
+	id = keepId;
+	helper = std::move(keepHelper);
+}
+
+
+
+// Get the AI's record of the given ship, creating one if it has none.
+AI::ShipState &AI::GetState(const Ship &ship)
+{
+	const int slot = ship.AISlot();
+	if(slot >= 0 && static_cast<size_t>(slot) < shipStates.size() && shipStates[slot].ship == &ship)
+		return shipStates[slot];
+
+	int newSlot;
+	if(freeShipStates.empty())
+	{
+		newSlot = shipStates.size();
+		shipStates.emplace_back();
+	}
+	else
+	{
+		newSlot = freeShipStates.back();
+		freeShipStates.pop_back();
+	}
+	ShipState &state = shipStates[newSlot];
+	state.ship = &ship;
+	state.owner = ship.weak_from_this();
+	state.id = nextStateId++;
+	ship.SetAISlot(newSlot);
+	return state;
+}
+
+
+
+// Get the AI's record of the given ship, or nullptr if it has none.
+const AI::ShipState *AI::FindState(const Ship &ship) const
+{
+	const int slot = ship.AISlot();
+	if(slot >= 0 && static_cast<size_t>(slot) < shipStates.size() && shipStates[slot].ship == &ship)
+		return &shipStates[slot];
+	return nullptr;
+}
+
+
+
+// Release the records of ships that no longer exist.
+void AI::ReleaseStates()
+{
+	for(size_t i = 0; i < shipStates.size(); ++i)
+	{
+		ShipState &state = shipStates[i];
+		if(!state.ship || !state.owner.expired())
+			continue;
+
+		if(state.boarding)
+			--boarderCount;
+		state = ShipState();
+		freeShipStates.push_back(i);
+	}
+}
+
+
+
+// Change which ship the given ship is moving in to board.
+void AI::SetBoarding(ShipState &state, const Ship *target)
+{
+	boarderCount += (target != nullptr) - (state.boarding != nullptr);
+	state.boarding = target;
+}
+
+
+
+// Check if the given ship has recently been beyond the "invisible fence."
+bool AI::IsBeyondFence(const Ship &ship) const
+{
+	const ShipState *state = FindState(ship);
+	return state && state->fenceCount;
+}
+
+
+
 // Check if the given target can be pursued by this ship.
 bool AI::CanPursue(const Ship &ship, const Ship &target) const
 {
@@ -1389,11 +1512,9 @@ bool AI::CanPursue(const Ship &ship, const Ship &target) const
 		return true;
 
 	// Check if the target is beyond the "invisible fence" for this system.
-	const auto fit = fenceCount.find(&target);
-	if(fit == fenceCount.end())
+	if(!IsBeyondFence(target))
 		return true;
-	else
-		return (fit->second != FENCE_MAX);
+	return *FindState(target)->fenceCount != FENCE_MAX;
 }
 
 
@@ -1465,7 +1586,7 @@ void AI::AskForHelp(Ship &ship, bool &isStranded, const Ship *flagship)
 		{
 			Ship *helper = canHelp[Random::Int(canHelp.size())];
 			helper->SetShipToAssist(ship.weak_from_this());
-			helperList[&ship] = helper->weak_from_this();
+			GetState(ship).helper = helper->weak_from_this();
 			isStranded = true;
 		}
 		else
@@ -1481,7 +1602,8 @@ void AI::AskForHelp(Ship &ship, bool &isStranded, const Ship *flagship)
 bool AI::CanHelp(const Ship &ship, const Ship &helper, const bool needsFuel, const bool needsEnergy) const
 {
 	// A ship being assisted cannot assist.
-	if(helperList.find(&helper) != helperList.end())
+	const ShipState *helperState = FindState(helper);
+	if(helperState && helperState->helper)
 		return false;
 
 	// Fighters, drones, and disabled / absent ships can't offer assistance.
@@ -1512,13 +1634,14 @@ bool AI::CanHelp(const Ship &ship, const Ship &helper, const bool needsFuel, con
 bool AI::HasHelper(const Ship &ship, const bool needsFuel, const bool needsEnergy)
 {
 	// Do we have an existing ship that was asked to assist?
-	if(helperList.find(&ship) != helperList.end())
+	ShipState &state = GetState(ship);
+	if(state.helper)
 	{
-		shared_ptr<Ship> helper = helperList[&ship].lock();
+		shared_ptr<Ship> helper = state.helper->lock();
 		if(helper && helper->GetShipToAssist().get() == &ship && CanHelp(ship, *helper, needsFuel, needsEnergy))
 			return true;
 		else
-			helperList.erase(&ship);
+			state.helper.reset();
 	}
 
 	return false;
@@ -1576,7 +1699,7 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship) const
 	// Ships with 'plunders' personality always destroy the ships they have boarded
 	// unless they also have either or both of the 'disables' or 'merciful' personalities.
 	if(oldTarget && person.Plunders() && !person.Disables() && !person.IsMerciful()
-			&& oldTarget->IsDisabled() && Has(ship, oldTarget, ShipEvent::BOARD))
+			&& oldTarget->IsDisabled() && Has(ship, *oldTarget, ShipEvent::BOARD))
 		return oldTarget;
 	shared_ptr<Ship> parentTarget;
 	if(ship.GetParent() && !ship.GetParent()->GetGovernment()->IsEnemy(gov))
@@ -1595,12 +1718,19 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship) const
 	bool canPlunder = person.Plunders() && ship.Cargo().Free() && !ship.CanBeCarried();
 	// Figure out how strong this ship is.
 	int64_t maxStrength = 0;
-	auto strengthIt = shipStrength.find(&ship);
-	if(!person.IsDaring() && strengthIt != shipStrength.end())
-		maxStrength = 2 * strengthIt->second;
-
-	// Get a list of all targetable, hostile ships in this system.
-	const auto enemies = GetShipsList(ship, true);
+	const ShipState *state = FindState(ship);
+	if(!person.IsDaring() && state)
+		maxStrength = 2 * state->strength;
+
+	// Get a list of all targetable, hostile ships in this system. Unless this
+	// ship will pick any foe in the system, only those near enough that they
+	// might be preferred over a foe at the search range need to be considered.
+	// The range is estimated a second from now, so allow for how far the ships
+	// could move until then.
+	double searchRange = -1.;
+	if(!person.IsHunting() && !person.IsNemesis())
+		searchRange = closest + MAX_TARGET_RANGE_BONUS + 60. * (ship.Velocity().Length() + shipIndexMaxSpeed);
+	const auto enemies = GetShipsList(ship, true, searchRange);
 	for(const auto &foe : enemies)
 	{
 		// If this is a "nemesis" ship and it has found one of the player's
@@ -1624,8 +1754,8 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship) const
 		// Unless this ship is "daring", it should not chase much stronger ships.
 		if(maxStrength && range > 1000. && !foe->IsDisabled())
 		{
-			const auto otherStrengthIt = shipStrength.find(foe);
-			if(otherStrengthIt != shipStrength.end() && otherStrengthIt->second > maxStrength)
+			const ShipState *foeState = FindState(*foe);
+			if(foeState && foeState->strength > maxStrength)
 				continue;
 		}
 
@@ -1635,7 +1765,7 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship) const
 
 		// Ships which only disable never target already-disabled ships.
 		if((person.Disables() || (!person.IsNemesis() && foe != oldTarget.get()))
-				&& foe->IsDisabled() && (!canPlunder || Has(ship, foe->weak_from_this(), ShipEvent::BOARD)))
+				&& foe->IsDisabled() && (!canPlunder || Has(ship, *foe, ShipEvent::BOARD)))
 			continue;
 
 		foe->UpdateTargeterStrength();
@@ -1660,10 +1790,10 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship) const
 		// While those that do, do so only if no "live" enemies are nearby.
 		else
 		{
-			if(any_of(boarders.begin(), boarders.end(), [&ship, &foe](auto &it)
-					{ return it.first != &ship && it.second == foe; }))
+			if(boarderCount && any_of(shipStates.begin(), shipStates.end(), [&ship, &foe](const ShipState &other)
+					{ return other.ship != &ship && other.boarding == foe; }))
 				continue;
-			range += 2000. * (2 * foe->IsDisabled() - !Has(ship, foe->weak_from_this(), ShipEvent::BOARD));
+			range += 2000. * (2 * foe->IsDisabled() - !Has(ship, *foe, ShipEvent::BOARD));
 		}
 
 		// Prefer to go after armed targets, especially if you're not a pirate.
@@ -1723,12 +1853,9 @@ shared_ptr<Ship> AI::FindNonHostileTarget(const Ship &ship) const
 
 	double cargoScan = ship.Attributes().Get("cargo scan power");
 	double outfitScan = ship.Attributes().Get("outfit scan power");
-	auto cargoScansIt = cargoScans.find(&ship);
-	auto outfitScansIt = outfitScans.find(&ship);
-	auto scanTimeIt = scanTime.find(&ship);
-	int shipScanCount = cargoScansIt != cargoScans.end() ? cargoScansIt->second.size() : 0;
-	shipScanCount += outfitScansIt != outfitScans.end() ? outfitScansIt->second.size() : 0;
-	int shipScanTime = scanTimeIt != scanTime.end() ? scanTimeIt->second : 0;
+	const ShipState *state = FindState(ship);
+	int shipScanCount = state ? state->cargoScans.size() + state->outfitScans.size() : 0;
+	int shipScanTime = state ? state->scanTime : 0;
 	if((cargoScan || outfitScan) && shipScanCount < maxScanCount && shipScanTime < forfeitTime)
 	{
 		// If this ship already has a target, and is in the process of scanning it, prioritise that,
@@ -1758,13 +1885,12 @@ shared_ptr<Ship> AI::FindNonHostileTarget(const Ship &ship) const
 			// to pursue in DoSurveillance.
 			double closest = max(cargoScan, outfitScan) * 2.;
 			const Government *gov = ship.GetGovernment();
-			for(const auto &it : GetShipsList(ship, false))
+			for(const auto &it : GetShipsList(ship, false, 100. * sqrt(closest)))
 				if(it->GetGovernment() != gov)
 				{
-					shared_ptr<Ship> ptr = it->shared_from_this();
 					// Scan friendly ships that are as-yet unscanned by this ship's government.
-					if((!cargoScan || Has(gov, ptr, ShipEvent::SCAN_CARGO))
-							&& (!outfitScan || Has(gov, ptr, ShipEvent::SCAN_OUTFITS)))
+					if((!cargoScan || Has(gov, *it, ShipEvent::SCAN_CARGO))
+							&& (!outfitScan || Has(gov, *it, ShipEvent::SCAN_OUTFITS)))
 						continue;
 
 					// Divide the distance by 10,000 to normalize to the scan range that
@@ -1773,7 +1899,7 @@ shared_ptr<Ship> AI::FindNonHostileTarget(const Ship &ship) const
 					if(range < closest)
 					{
 						closest = range;
-						target = std::move(ptr);
+						target = it->shared_from_this();
 					}
 				}
 		}
@@ -1794,25 +1920,47 @@ vector<Ship *> AI::GetShipsList(const Ship &ship, bool targetEnemies, double max
 
 	auto targets = vector<Ship *>();
 
-	// The cached lists are built each step based on the current ships in the player's system.
-	const auto &rosters = targetEnemies ? enemyLists : allyLists;
+	const System *here = ship.GetSystem();
+	const Point &p = ship.Position();
+	auto isTarget = [&ship, here, &p, maxRange](const Ship &target) -> bool
+	{
+		return target.IsTargetable() && target.GetSystem() == here
+			&& !(target.IsHyperspacing() && target.Velocity().Length() > 10.)
+			&& p.Distance(target.Position()) < maxRange
+			&& (ship.IsYours() || !target.GetPersonality().IsMarked())
+			&& (target.IsYours() || !ship.GetPersonality().IsMarked());
+	};
 
-	const auto it = rosters.find(ship.GetGovernment());
-	if(it != rosters.end() && !it->second.empty())
+	// Within a limited range, only look up the ships nearby in the index.
+	// This may be called from several threads at once, while turrets are aimed.
+	if(hasShipIndex && maxRange < numeric_limits<double>::infinity())
 	{
-		targets.reserve(it->second.size());
+		if(!ship.GetGovernment())
+			return targets;
 
-		const System *here = ship.GetSystem();
-		const Point &p = ship.Position();
-		for(const auto &target : it->second)
-			if(target->IsTargetable() && target->GetSystem() == here
-					&& !(target->IsHyperspacing() && target->Velocity().Length() > 10.)
-					&& p.Distance(target->Position()) < maxRange
-					&& (ship.IsYours() || !target->GetPersonality().IsMarked())
-					&& (target->IsYours() || !ship.GetPersonality().IsMarked()))
+		thread_local vector<Body *> nearby;
+		nearby.clear();
+		shipIndex.Nearby(p, maxRange, nearby, ship.GetGovernment(), targetEnemies);
+		for(Body *body : nearby)
+		{
+			Ship *target = static_cast<Ship *>(body);
+			if(isTarget(*target))
 				targets.emplace_back(target);
+		}
+		return targets;
 	}
 
+	// The rosters are built each step based on the current ships in the player's system.
+	// Only the governments with the desired hostility need to have their ships checked.
+	const Government *gov = ship.GetGovernment();
+	if(!gov)
+		return targets;
+	for(const auto &roster : governmentRosters)
+		if(gov->IsEnemy(roster.first) == targetEnemies)
+			for(Ship *target : roster.second)
+				if(isTarget(*target))
+					targets.emplace_back(target);
+
 	return targets;
 }
 
@@ -2012,25 +2160,25 @@ void AI::MoveIndependent(Ship &ship, Command &command)
 	else if(target && (gov->IsEnemy(target->GetGovernment()) || friendlyOverride))
 	{
 		bool shouldBoard = ship.Cargo().Free() && ship.GetPersonality().Plunders();
-		bool hasBoarded = Has(ship, target, ShipEvent::BOARD);
+		bool hasBoarded = Has(ship, *target, ShipEvent::BOARD);
 		if(shouldBoard && target->IsDisabled() && !hasBoarded)
 		{
 			if(ship.IsBoarding())
 				return;
 			MoveTo(ship, command, target->Position(), target->Velocity(), 40., .8);
 			command |= Command::BOARD;
-			boarders[&ship] = target.get();
+			SetBoarding(GetState(ship), target.get());
 		}
 		else
 		{
 			Attack(ship, command, *target);
-			boarders.erase(&ship);
+			SetBoarding(GetState(ship), nullptr);
 		}
 		return;
 	}
 	else
 	{
-		boarders.erase(&ship);
+		SetBoarding(GetState(ship), nullptr);
 		if(target)
 		{
 			// An AI ship that is targeting a non-hostile ship should scan it, or move on.
@@ -2043,8 +2191,8 @@ void AI::MoveIndependent(Ship &ship, Command &command)
 				ship.SetTargetShip(nullptr);
 			}
 			// Detarget if I cannot scan, or if I already scanned the ship.
-			else if((!cargoScan || Has(gov, target, ShipEvent::SCAN_CARGO))
-					&& (!outfitScan || Has(gov, target, ShipEvent::SCAN_OUTFITS)))
+			else if((!cargoScan || Has(gov, *target, ShipEvent::SCAN_CARGO))
+					&& (!outfitScan || Has(gov, *target, ShipEvent::SCAN_OUTFITS)))
 			{
 				target.reset();
 				ship.SetTargetShip(nullptr);
@@ -3090,7 +3238,7 @@ void AI::DoAppeasing(const shared_ptr<Ship> &ship, double *threshold) const
 	const Government *government = ship->GetGovernment();
 	const string &language = government->Language();
 	if(language.empty() || player.Conditions().Get("language: " + language))
-		Messages::Add({Translation::TrGovernment(government->DisplayName()) + " " + ship->Noun() + " \"" + ship->GivenName()
+		Messages::Add({government->TranslatedDisplayName() + " " + ship->Noun() + " \"" + ship->GivenName()
 			+ "\": Please, just take my cargo and leave me alone.",
 			GameData::MessageCategories().Get("low")});
 
@@ -3108,9 +3256,9 @@ void AI::DoSwarming(Ship &ship, Command &command, shared_ptr<Ship> &target)
 		if(target)
 		{
 			// Allow another swarming ship to consider the target.
-			auto sit = swarmCount.find(target.get());
-			if(sit != swarmCount.end() && sit->second > 0)
-				--sit->second;
+			ShipState &targetState = GetState(*target);
+			if(targetState.swarmCount > 0)
+				--targetState.swarmCount;
 			// Release the current target.
 			target.reset();
 			ship.SetTargetShip(target);
@@ -3126,7 +3274,7 @@ void AI::DoSwarming(Ship &ship, Command &command, shared_ptr<Ship> &target)
 			if(!other->GetPersonality().IsSwarming())
 			{
 				// Prefer to swarm ships that are not already being heavily swarmed.
-				int count = swarmCount[other] + Random::Int(4);
+				int count = GetState(*other).swarmCount + Random::Int(4);
 				if(count < lowestCount)
 				{
 					target = other->shared_from_this();
@@ -3135,7 +3283,7 @@ void AI::DoSwarming(Ship &ship, Command &command, shared_ptr<Ship> &target)
 			}
 		ship.SetTargetShip(target);
 		if(target)
-			++swarmCount[target.get()];
+			++GetState(*target).swarmCount;
 	}
 	// If a friendly ship to flock with was not found, return to an available planet.
 	if(target)
@@ -3197,8 +3345,8 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 		bool outfitScan = ship.Attributes().Get("outfit scan power");
 		// If the pointer to the target ship exists, it is targetable and in-system.
 		const Government *gov = ship.GetGovernment();
-		bool mustScanCargo = cargoScan && !Has(gov, target, ShipEvent::SCAN_CARGO);
-		bool mustScanOutfits = outfitScan && !Has(gov, target, ShipEvent::SCAN_OUTFITS);
+		bool mustScanCargo = cargoScan && !Has(gov, *target, ShipEvent::SCAN_CARGO);
+		bool mustScanOutfits = outfitScan && !Has(gov, *target, ShipEvent::SCAN_OUTFITS);
 		if(!mustScanCargo && !mustScanOutfits)
 			ship.SetTargetShip(shared_ptr<Ship>());
 		else
@@ -3224,20 +3372,16 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 		vector<Ship *> targetShips;
 		bool cargoScan = ship.Attributes().Get("cargo scan power");
 		bool outfitScan = ship.Attributes().Get("outfit scan power");
-		auto cargoScansIt = cargoScans.find(&ship);
-		auto outfitScansIt = outfitScans.find(&ship);
-		auto scanTimeIt = scanTime.find(&ship);
-		int shipScanCount = cargoScansIt != cargoScans.end() ? cargoScansIt->second.size() : 0;
-		shipScanCount += outfitScansIt != outfitScans.end() ? outfitScansIt->second.size() : 0;
-		int shipScanTime = scanTimeIt != scanTime.end() ? scanTimeIt->second : 0;
+		const ShipState *state = FindState(ship);
+		int shipScanCount = state ? state->cargoScans.size() + state->outfitScans.size() : 0;
+		int shipScanTime = state ? state->scanTime : 0;
 		if((cargoScan || outfitScan) && shipScanCount < 12 && shipScanTime < 18000)
 		{
 			for(const auto &it : GetShipsList(ship, false))
 				if(it->GetGovernment() != gov)
 				{
-					weak_ptr<Ship> ptr = it->weak_from_this();
-					if((!cargoScan || Has(gov, ptr, ShipEvent::SCAN_CARGO))
-							&& (!outfitScan || Has(gov, ptr, ShipEvent::SCAN_OUTFITS)))
+					if((!cargoScan || Has(gov, *it, ShipEvent::SCAN_CARGO))
+							&& (!outfitScan || Has(gov, *it, ShipEvent::SCAN_OUTFITS)))
 						continue;
 
 					if(it->IsTargetable())
@@ -3294,15 +3438,15 @@ void AI::DoMining(Ship &ship, Command &command)
 {
 	// This function is only called for ships that are in the player's system.
 	// Update the radius that the ship is searching for asteroids at.
-	bool isNew = !miningAngle.contains(&ship);
-	Angle &angle = miningAngle[&ship];
-	if(isNew)
+	ShipState &state = GetState(ship);
+	if(!state.miningAngle)
 	{
-		angle = Angle::Random();
-		miningRadius[&ship] = ship.GetSystem()->AsteroidBeltRadius();
+		state.miningAngle = Angle::Random();
+		state.miningRadius = ship.GetSystem()->AsteroidBeltRadius();
 	}
+	Angle &angle = *state.miningAngle;
 	angle += Angle::Random(1.) - Angle::Random(1.);
-	double radius = miningRadius[&ship] * pow(2., angle.Unit().X());
+	double radius = state.miningRadius * pow(2., angle.Unit().X());
 
 	shared_ptr<Minable> target = ship.GetTargetAsteroid();
 	if(!target || target->Velocity().Length() > ship.MaxVelocity())
@@ -3507,7 +3651,7 @@ bool AI::DoCloak(const Ship &ship, Command &command) const
 			// TODO: This could use an "Avoid" method, to account for other in-system hazards.
 			// Simple approximation: move equally away from both the system center and the
 			// nearest enemy, until the constrainment boundary is reached.
-			if(ship.GetPersonality().IsUnconstrained() || !fenceCount.contains(&ship))
+			if(ship.GetPersonality().IsUnconstrained() || !IsBeyondFence(ship))
 				safety = 2 * ship.Position().Unit() - nearestEnemy->Position().Unit();
 			else
 				safety = -ship.Position().Unit();
@@ -3577,7 +3721,7 @@ void AI::DoScatter(const Ship &ship, Command &command, bool recheckCloseShips)
 	if(!command.Has(Command::FORWARD) && !command.Has(Command::BACK))
 		return;
 
-	auto &close = closeBy[&ship];
+	auto &close = GetState(ship).closeBy;
 	if(recheckCloseShips)
 	{
 		close.clear();
@@ -3633,7 +3777,7 @@ void AI::DoScatter(const Ship &ship, Command &command, bool recheckCloseShips)
 		{
 			command.SetTurn(flip * offset.Cross(ship.Facing().Unit()) > 0. ? 1. : -1.);
 			// The other ship should also know to turn away from this one.
-			closeBy[other.get()].insert(ship.weak_from_this());
+			GetState(*other).closeBy.insert(ship.weak_from_this());
 			return;
 		}
 		else
@@ -3669,7 +3813,7 @@ bool AI::DoSecretive(Ship &ship, Command &command) const
 		if(distance < maxScanRange)
 		{
 			Point away;
-			if(ship.GetPersonality().IsUnconstrained() || !fenceCount.contains(&ship))
+			if(ship.GetPersonality().IsUnconstrained() || !IsBeyondFence(ship))
 				away = pos - scanningPos;
 			else
 				away = -pos;
@@ -3883,8 +4027,18 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic,
 			// Get the turret's current facing, in absolute coordinates:
 			Angle aim = ship.Facing() + hardpoint.GetAngle();
 			// Get this projectile's average velocity.
-			const Weapon *weapon = hardpoint.GetWeapon();
-			double vp = weapon->WeightedVelocity() + .5 * weapon->RandomVelocity();
+			int index = &hardpoint - &ship.Weapons().front();
+			const ShipAICache::WeaponData weapon = ship.GetAICache().GetWeaponData(index, hardpoint.GetWeapon());
+			double vp = weapon.velocity;
+			// These are the same for every target, and some of them take a
+			// lookup, so only get them once.
+			const double turnRate = hardpoint.TurnRate(ship);
+			const double totalLifetime = weapon.totalLifetime;
+			const bool isInstantaneous = (totalLifetime == 1.);
+			const bool hasAcceleration = weapon.hasAcceleration;
+			const bool isOmnidirectional = hardpoint.IsOmnidirectional();
+			const Angle minArc = hardpoint.GetMinArc() + ship.Facing();
+			const Angle maxArc = hardpoint.GetMaxArc() + ship.Facing();
 			// Loop through each body this hardpoint could shoot at. Find the
 			// one that is the "best" in terms of how many frames it will take
 			// to aim at it and for a projectile to hit it.
@@ -3896,7 +4050,7 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic,
 
 				// Only take the ship's velocity into account if this weapon
 				// does not have its own acceleration.
-				if(!weapon->Acceleration())
+				if(!hasAcceleration)
 					v -= ship.Velocity();
 				// By the time this action is performed, the target will
 				// have moved forward one time step.
@@ -3905,7 +4059,6 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic,
 				double rendezvousTime = numeric_limits<double>::quiet_NaN();
 				double distance = p.Length();
 				// Beam weapons hit instantaneously if they are in range.
-				bool isInstantaneous = weapon->TotalLifetime() == 1.;
 				if(isInstantaneous && distance < vp)
 					rendezvousTime = 0.;
 				else
@@ -3917,46 +4070,41 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic,
 					// If there is no intersection (i.e. the turret is not facing the target),
 					// consider this target "out-of-range" but still targetable.
 					if(std::isnan(rendezvousTime))
-						rendezvousTime = max(distance / (vp ? vp : 1.), 2 * weapon->TotalLifetime());
+						rendezvousTime = max(distance / (vp ? vp : 1.), 2 * totalLifetime);
 
 					// Determine where the target will be at that point.
 					p += v * rendezvousTime;
 
 					// All bodies within weapons range have the same basic
 					// weight. Outside that range, give them lower priority.
-					rendezvousTime = max(0., rendezvousTime - weapon->TotalLifetime());
+					rendezvousTime = max(0., rendezvousTime - totalLifetime);
 				}
 
 				// Determine how much the turret must turn to face that vector.
 				double degrees = 0.;
 				Angle angleToPoint = Angle(p);
-				if(hardpoint.IsOmnidirectional())
+				if(isOmnidirectional)
 					degrees = (angleToPoint - aim).Degrees();
 				else
 				{
 					// For turret with limited arc, determine the turn up to the nearest arc limit.
 					// Also reduce priority of target if it's not within the firing arc.
-					const Angle facing = ship.Facing();
-					const Angle minArc = hardpoint.GetMinArc() + facing;
-					const Angle maxArc = hardpoint.GetMaxArc() + facing;
 					if(!angleToPoint.IsInRange(minArc, maxArc))
 					{
 						// Decrease the priority of the target.
-						rendezvousTime += 2. * weapon->TotalLifetime();
+						rendezvousTime += 2. * totalLifetime;
 
 						// Point to the nearer edge of the arc.
-						const double minDegree = (minArc - angleToPoint).Degrees();
-						const double maxDegree = (maxArc - angleToPoint).Degrees();
-						if(fabs(minDegree) < fabs(maxDegree))
+						if(angleToPoint.Distance(minArc) < angleToPoint.Distance(maxArc))
 							angleToPoint = minArc;
 						else
 							angleToPoint = maxArc;
 					}
 					degrees = (angleToPoint - minArc).AbsDegrees() - (aim - minArc).AbsDegrees();
 				}
-				double turnTime = fabs(degrees) / hardpoint.TurnRate(ship);
+				double turnTime = fabs(degrees) / turnRate;
 				// Always prefer targets that you are able to hit.
-				double score = turnTime + (180. / hardpoint.TurnRate(ship)) * rendezvousTime;
+				double score = turnTime + (180. / turnRate) * rendezvousTime;
 				if(score < bestScore)
 				{
 					bestScore = score;
@@ -3964,11 +4112,7 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic,
 				}
 			}
 			if(bestAngle)
-			{
-				// Get the index of this weapon.
-				int index = &hardpoint - &ship.Weapons().front();
-				command.SetAim(index, bestAngle / hardpoint.TurnRate(ship));
-			}
+				command.SetAim(index, bestAngle / turnRate);
 		}
 }
 
@@ -4032,16 +4176,18 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 
 	// Find the longest range of any of your non-homing weapons. Homing weapons
 	// that don't consume ammo may also fire in non-homing mode.
+	const ShipAICache &aiCache = ship.GetAICache();
 	double maxRange = 0.;
 	for(const Hardpoint &hardpoint : ship.Weapons())
 		if(hardpoint.IsReady())
 		{
-			const Weapon *weapon = hardpoint.GetWeapon();
-			if(!(!currentTarget && hardpoint.IsHoming() && weapon->Ammo())
-					&& !(!secondary && weapon->Icon())
-					&& !(beFrugal && weapon->Ammo())
-					&& !(isWaitingToJump && weapon->FiringForce()))
-				maxRange = max(maxRange, weapon->Range());
+			const ShipAICache::WeaponData weapon = aiCache.GetWeaponData(
+				&hardpoint - &ship.Weapons().front(), hardpoint.GetWeapon());
+			if(!(!currentTarget && weapon.isHoming && weapon.usesAmmo)
+					&& !(!secondary && weapon.isSecondary)
+					&& !(beFrugal && weapon.usesAmmo)
+					&& !(isWaitingToJump && weapon.hasFiringForce))
+				maxRange = max(maxRange, weapon.range);
 		}
 	// Extend the weapon range slightly to account for velocity differences.
 	maxRange *= 1.5;
@@ -4073,25 +4219,26 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 		}
 
 		const Weapon *weapon = hardpoint.GetWeapon();
+		const ShipAICache::WeaponData data = aiCache.GetWeaponData(index, weapon);
 		// Don't expend ammo for homing weapons that have no target selected.
-		if(!currentTarget && weapon->Homing() && weapon->Ammo())
+		if(!currentTarget && data.isHoming && data.usesAmmo)
 			continue;
 		// Don't fire secondary weapons if told not to.
-		if(!secondary && weapon->Icon())
+		if(!secondary && data.isSecondary)
 			continue;
 		// Don't expend ammo if trying to be frugal.
-		if(beFrugal && weapon->Ammo())
+		if(beFrugal && data.usesAmmo)
 			continue;
 		// Don't use weapons with firing force if you are preparing to jump.
-		if(isWaitingToJump && weapon->FiringForce())
+		if(isWaitingToJump && data.hasFiringForce)
 			continue;
 
 		// Special case: if the weapon uses fuel, be careful not to spend so much
 		// fuel that you cannot leave the system if necessary.
-		if(weapon->FiringFuel())
+		if(data.firingFuel)
 		{
 			double fuel = ship.Fuel() * ship.Attributes().Get("fuel capacity");
-			fuel -= weapon->FiringFuel();
+			fuel -= data.firingFuel;
 			// If the ship is not ever leaving this system, it does not need to
 			// reserve any fuel.
 			bool isStaying = person.IsStaying();
@@ -4103,18 +4250,18 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 		Point start = ship.Position() + ship.Facing().Rotate(hardpoint.GetPoint());
 		start += person.Confusion();
 
-		double vp = weapon->WeightedVelocity() + .5 * weapon->RandomVelocity();
-		double lifetime = weapon->TotalLifetime();
+		double vp = data.velocity;
+		double lifetime = data.totalLifetime;
 
 		// Homing weapons revert to "dumb firing" if they have no target.
-		if(weapon->Homing() && currentTarget)
+		if(data.isHoming && currentTarget)
 		{
 			// NPCs shoot ships that they just plundered.
-			bool hasBoarded = !ship.IsYours() && Has(ship, currentTarget, ShipEvent::BOARD);
+			bool hasBoarded = !ship.IsYours() && Has(ship, *currentTarget, ShipEvent::BOARD);
 			if(currentTarget->IsDisabled() && (disables || (plunders && !hasBoarded)) && !disabledOverride)
 				continue;
 			// Don't fire secondary weapons at targets that have started jumping.
-			if(weapon->Icon() && currentTarget->IsEnteringHyperspace())
+			if(data.isSecondary && currentTarget->IsEnteringHyperspace())
 				continue;
 
 			// For homing weapons, don't take the velocity of the ship firing it
@@ -4145,7 +4292,7 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 		for(const auto &target : enemies)
 		{
 			// NPCs shoot ships that they just plundered.
-			bool hasBoarded = !ship.IsYours() && Has(ship, target->weak_from_this(), ShipEvent::BOARD);
+			bool hasBoarded = !ship.IsYours() && Has(ship, *target, ShipEvent::BOARD);
 			if(target->IsDisabled() && (disables || (plunders && !hasBoarded)) && !disabledOverride)
 				continue;
 			// Merciful ships let fleeing ships go.
@@ -4159,7 +4306,7 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 			Point v = target->Velocity();
 			// Only take the ship's velocity into account if this weapon
 			// does not have its own acceleration.
-			if(!weapon->Acceleration())
+			if(!data.hasAcceleration)
 				v -= ship.Velocity();
 			// By the time this action is performed, the ships will have moved
 			// forward one time step.
@@ -4231,6 +4378,68 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, const Body &target) co
 
 
 
+// Queue up the firing decision for the given ship, to be evaluated by FireQueued().
+void AI::QueueFiring(Ship &ship, bool aim, bool opportunistic, const Minable *targetAsteroid)
+{
+	if(firingPlanCount == firingPlans.size())
+		firingPlans.emplace_back();
+	FiringPlan &plan = firingPlans[firingPlanCount++];
+	plan.ship = &ship;
+	plan.aim = aim;
+	plan.opportunistic = opportunistic;
+	plan.targetAsteroid = targetAsteroid;
+	// Keep any firing commands that were decided on while stepping this ship.
+	plan.command.SetHardpoints(ship.Weapons().size());
+	plan.command.UpdateWith(firingCommands);
+}
+
+
+
+// Evaluate every queued firing decision, then give each ship its firing commands.
+void AI::FireQueued()
+{
+	// Aiming checks the collision mask of each target, which caches the current
+	// animation frame. Update those caches now so that they are only read below.
+	for(const shared_ptr<Ship> &ship : ships)
+		ship->GetMask(step);
+	for(const shared_ptr<Minable> &minable : minables)
+		minable->GetMask(step);
+
+	// Idle turrets sweep back and forth at random. To make the results independent
+	// of which thread evaluates which ship, deterministic mode gives each plan a
+	// stream of random numbers of its own.
+	const bool isDeterministic = Random::IsDeterministic();
+	const uint64_t seed = isDeterministic ? (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int() : 0;
+
+	auto evaluate = [this, isDeterministic, seed](size_t begin, size_t end) -> void
+	{
+		for(size_t i = begin; i < end; ++i)
+		{
+			FiringPlan &plan = firingPlans[i];
+			if(!plan.aim)
+				continue;
+			if(isDeterministic)
+				Random::Seed(seed, i);
+			AimTurrets(*plan.ship, plan.command, plan.opportunistic);
+			if(plan.targetAsteroid)
+				AutoFire(*plan.ship, plan.command, *plan.targetAsteroid);
+			else
+				AutoFire(*plan.ship, plan.command);
+		}
+	};
+
+	TaskQueue::ParallelFor(0, firingPlanCount, FIRING_CHUNK_SIZE, evaluate);
+	// This thread may have evaluated some of the plans itself.
+	if(isDeterministic)
+		Random::Seed(seed, firingPlanCount);
+
+	// Hand out the results in the same order the ships were stepped in.
+	for(size_t i = 0; i < firingPlanCount; ++i)
+		firingPlans[i].ship->SetCommands(firingPlans[i].command);
+}
+
+
+
 // Get the amount of time it would take the given weapon to reach the given
 // target, assuming it can be fired in any direction (i.e. turreted). For
 // non-turreted weapons this can be used to calculate the ideal direction to
@@ -4517,13 +4726,13 @@ void AI::MovePlayer(Ship &ship, Command &activeCommands)
 						return [this, &ship](const Ship &other) noexcept -> double
 						{
 							// Use the exact cost if the ship was scanned, otherwise use an estimation.
-							return this->Has(ship, other.weak_from_this(), ShipEvent::SCAN_OUTFITS) ?
+							return this->Has(ship, other, ShipEvent::SCAN_OUTFITS) ?
 								other.Cost() : (other.ChassisCost() * 2.);
 						};
 					case Preferences::BoardingPriority::MIXED:
 						return [this, &ship, current](const Ship &other) noexcept -> double
 						{
-							double cost = this->Has(ship, other.weak_from_this(), ShipEvent::SCAN_OUTFITS) ?
+							double cost = this->Has(ship, other, ShipEvent::SCAN_OUTFITS) ?
 								other.Cost() : (other.ChassisCost() * 2.);
 							// Even if we divide by 0, doubles can contain and handle infinity,
 							// and we should definitely board that one then.
@@ -5013,32 +5222,27 @@ void AI::DisengageAutopilot()
 
 
 
-bool AI::Has(const Ship &ship, const weak_ptr<const Ship> &other, int type) const
+bool AI::Has(const Ship &ship, const Ship &other, int type) const
 {
-	auto sit = actions.find(ship.weak_from_this());
-	if(sit == actions.end())
-		return false;
-
-	auto oit = sit->second.find(other);
-	if(oit == sit->second.end())
+	const ShipState *state = FindState(ship);
+	const ShipState *otherState = FindState(other);
+	if(!state || !otherState)
 		return false;
 
-	return (oit->second & type);
+	auto it = state->actions.find(otherState->id);
+	return it != state->actions.end() && (it->second & type);
 }
 
 
 
-bool AI::Has(const Government *government, const weak_ptr<const Ship> &other, int type) const
+bool AI::Has(const Government *government, const Ship &other, int type) const
 {
-	auto git = governmentActions.find(government);
-	if(git == governmentActions.end())
+	const ShipState *state = FindState(other);
+	if(!state)
 		return false;
 
-	auto oit = git->second.find(other);
-	if(oit == git->second.end())
-		return false;
-
-	return (oit->second & type);
+	auto it = state->governmentActions.find(government);
+	return it != state->governmentActions.end() && (it->second & type);
 }
 
 
@@ -5047,15 +5251,12 @@ bool AI::Has(const Government *government, const weak_ptr<const Ship> &other, in
 // example, if the player boarded any ship belonging to that government.
 bool AI::Has(const Ship &ship, const Government *government, int type) const
 {
-	auto sit = notoriety.find(ship.weak_from_this());
-	if(sit == notoriety.end())
-		return false;
-
-	auto git = sit->second.find(government);
-	if(git == sit->second.end())
+	const ShipState *state = FindState(ship);
+	if(!state)
 		return false;
 
-	return (git->second & type);
+	auto it = state->notoriety.find(government);
+	return it != state->notoriety.end() && (it->second & type);
 }
 
 
@@ -5072,23 +5273,34 @@ void AI::UpdateStrengths(map<const Government *, int64_t> &strength, const Syste
 				strength[it->GetGovernment()] += it->Strength();
 		}
 
-	// Strengths of enemies and allies are rebuilt every step.
+	// Strengths of enemies and allies are rebuilt every step. Check whether each
+	// pair of governments are enemies only once, rather than for every pair of
+	// a government's enemies and potential allies.
 	enemyStrength.clear();
 	allyStrength.clear();
-	for(const auto &gov : strength)
-	{
-		set<const Government *> allies;
-		for(const auto &enemy : strength)
-			if(enemy.first->IsEnemy(gov.first))
+	const vector<pair<const Government *, int64_t>> present(strength.begin(), strength.end());
+	const size_t count = present.size();
+	// Whether the j-th government considers the i-th one an enemy.
+	vector<bool> isEnemyOf(count * count);
+	for(size_t i = 0; i < count; ++i)
+		for(size_t j = 0; j < count; ++j)
+			isEnemyOf[i * count + j] = present[j].first->IsEnemy(present[i].first);
+	vector<bool> isAlly(count);
+	for(size_t i = 0; i < count; ++i)
+	{
+		const Government *gov = present[i].first;
+		isAlly.assign(count, false);
+		for(size_t enemy = 0; enemy < count; ++enemy)
+			if(isEnemyOf[i * count + enemy])
 			{
 				// "Know your enemies."
-				enemyStrength[gov.first] += enemy.second;
-				for(const auto &ally : strength)
-					if(ally.first->IsEnemy(enemy.first) && !allies.contains(ally.first))
+				enemyStrength[gov] += present[enemy].second;
+				for(size_t ally = 0; ally < count; ++ally)
+					if(isEnemyOf[enemy * count + ally] && !isAlly[ally])
 					{
 						// "The enemy of my enemy is my friend."
-						allyStrength[gov.first] += ally.second;
-						allies.insert(ally.first);
+						allyStrength[gov] += present[ally].second;
+						isAlly[ally] = true;
 					}
 			}
 	}
@@ -5106,7 +5318,7 @@ void AI::UpdateStrengths(map<const Government *, int64_t> &strength, const Syste
 		if(!gov || it->GetSystem() != playerSystem || it->IsDisabled() || Random::Int(60))
 			continue;
 
-		int64_t &myStrength = shipStrength[it.get()];
+		int64_t &myStrength = GetState(*it).strength;
 		for(const auto &allies : governmentRosters)
 		{
 			// If this is not an allied government, its ships will not assist this ship when attacked.
@@ -5121,24 +5333,21 @@ void AI::UpdateStrengths(map<const Government *, int64_t> &strength, const Syste
 
 
 
-// Cache various lists of all targetable ships in the player's system for this Step.
+// Index all the ships in the player's system by position for this Step.
 void AI::CacheShipLists()
 {
-	allyLists.clear();
-	enemyLists.clear();
-	for(const auto &git : governmentRosters)
-	{
-		allyLists.emplace(git.first, vector<Ship *>());
-		allyLists.at(git.first).reserve(ships.size());
-		enemyLists.emplace(git.first, vector<Ship *>());
-		enemyLists.at(git.first).reserve(ships.size());
-		for(const auto &oit : governmentRosters)
+	// A negative step means that adding them does not change their animation frames.
+	const System *playerSystem = player.GetSystem();
+	shipIndex.Clear(-1);
+	shipIndexMaxSpeed = 0.;
+	for(const auto &it : ships)
+		if(it->GetGovernment() && it->GetSystem() == playerSystem)
 		{
-			auto &list = git.first->IsEnemy(oit.first)
-					? enemyLists[git.first] : allyLists[git.first];
-			list.insert(list.end(), oit.second.begin(), oit.second.end());
+			shipIndex.Add(*it);
+			shipIndexMaxSpeed = max(shipIndexMaxSpeed, it->Velocity().Length());
 		}
-	}
+	shipIndex.Finish();
+	hasShipIndex = true;
 }
 
 
@@ -5154,6 +5363,7 @@ void AI::RegisterDerivedConditions(ConditionsStore &conditions)
 				strength += ship->Strength();
 		return strength;
 	});
+	conditions["government strength: "].CacheUntilNextFrame();
 	conditions["ally strength"].ProvideNamed([this](const ConditionEntry &ce) -> int64_t {
 		return allyStrength[GameData::PlayerGovernment()];
 	});
@@ -5252,6 +5462,7 @@ void AI::IssueOrder(const OrderSingle &newOrder, const string &description)
 	bool alreadyHarvesting = false;
 	if(isValidTarget)
 	{
+		orders.reserve(orders.size() + ships.size());
 		for(const Ship *ship : ships)
 		{
 			// Never issue orders to a ship to target itself.
@@ -5330,6 +5541,11 @@ RoutePlan AI::GetRoutePlan(const Ship &ship, const System *targetSystem)
 	if(player.RecacheJumpRoutes())
 		routeCache.clear();
 
+	// NPC routes do not depend on what the player knows, so they are shared
+	// between every ship with the same travel capabilities.
+	if(!ship.IsYours())
+		return RouteTable::Get(ship, *targetSystem);
+
 	size_t personalityHash = 0;
 	Hasher::Hash(personalityHash, ship.GetGovernment());
 	Hasher::Hash(personalityHash, ship.GetPersonality().IsRestricted());
@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "Angle.h"
+#include "CollisionSet.h"
 #include "Command.h"
 #include "FireCommand.h"
 #include "FormationPositioner.h"
@@ -31,7 +33,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <unordered_map>
 #include <vector>
 
-class Angle;
 class AsteroidField;
 class Body;
 class ConditionsStore;
@@ -54,11 +55,14 @@ class System;
 // the same target over and over.
 class AI {
 public:
-	// Any object that can be a ship's target is in a list of this type:
+	// Any object that can be a ship's target is in a list of one of these types.
+	// Ships and flotsam are stored contiguously, since they are looped over often.
 	template<class Type>
 	using List = std::list<std::shared_ptr<Type>>;
+	template<class Type>
+	using Array = std::vector<std::shared_ptr<Type>>;
 	// Constructor, giving the AI access to the player and various object lists.
-	AI(PlayerInfo &player, const List<Ship> &ships, const List<Minable> &minables, const List<Flotsam> &flotsam);
+	AI(PlayerInfo &player, const Array<Ship> &ships, const List<Minable> &minables, const Array<Flotsam> &flotsam);
 
 	// Fleet commands from the player.
 	void IssueFormationChange(PlayerInfo &player);
@@ -70,7 +74,7 @@ public:
 	void UpdateKeys(PlayerInfo &player, const Command &activeCommands);
 
 	// Allow the AI to track any events it is interested in.
-	void UpdateEvents(const std::list<ShipEvent> &events);
+	void UpdateEvents(const std::vector<ShipEvent> &events);
 	// Reset the AI's memory of events.
 	void Clean();
 	// Clear ship orders. This should be done when the player lands on a planet,
@@ -126,8 +130,81 @@ private:
 		std::vector<std::string> wormholeKeys;
 	};
 
+	// The information needed to decide how a ship should aim and fire its weapons.
+	// Those decisions only read the state of the system, so they are gathered while
+	// stepping each ship and then evaluated for all ships in parallel.
+	struct FiringPlan {
+		Ship *ship = nullptr;
+		// Whether the ship should aim its turrets and look for something to fire at.
+		bool aim = false;
+		bool opportunistic = false;
+		const Minable *targetAsteroid = nullptr;
+		// The firing commands already decided on while stepping the ship.
+		FireCommand command;
+	};
+
+	// Everything the AI remembers about a single ship. These records are kept
+	// in one contiguous vector, and each ship stores the index of its own.
+	class ShipState {
+	public:
+		// Forget everything that Clean() is supposed to forget.
+		void Clear();
+
+	public:
+		// The ship this record belongs to. Once the owner has expired, the
+		// record is released so that another ship can use it.
+		const Ship *ship = nullptr;
+		std::weak_ptr<const Ship> owner;
+		// A number that no other ship's record has ever had, for keeping track
+		// of this ship in other records even after this one is released.
+		uint64_t id = 0;
+
+		// The ship that was asked to assist this one, if any. Unlike the rest
+		// of this record, this is only forgotten by ClearOrders().
+		std::optional<std::weak_ptr<Ship>> helper;
+		// How many swarming ships have picked this ship to swarm around.
+		int swarmCount = 0;
+		// How long this ship has been beyond the "invisible fence," if it has
+		// been there recently.
+		std::optional<int> fenceCount;
+		// The ships that this ship has scanned, and how long it has spent scanning.
+		std::set<const Ship *> cargoScans;
+		std::set<const Ship *> outfitScans;
+		int scanTime = 0;
+		// Where this ship looks for asteroids, once it has started mining.
+		std::optional<Angle> miningAngle;
+		double miningRadius = 0.;
+		int miningTime = 0;
+		double appeasementThreshold = 0.;
+		// The ship that this ship is moving in to board, if any.
+		const Ship *boarding = nullptr;
+		// Ships that were recently near enough that this ship may need to scatter away from them.
+		std::set<std::weak_ptr<const Ship>, std::owner_less<std::weak_ptr<const Ship>>> closeBy;
+		// This ship's estimate of its own and its nearby allies' strength.
+		int64_t strength = 0;
+
+		// What this ship has done to other ships, by their IDs, and to each
+		// government.
+		std::unordered_map<uint64_t, int> actions;
+		std::unordered_map<const Government *, int> notoriety;
+		// What each government, including the player's, has done to this ship.
+		std::unordered_map<const Government *, int> governmentActions;
+		int playerActions = 0;
+	};
+
 
 private:
+	// Get the AI's record of the given ship, creating one if it has none.
+	ShipState &GetState(const Ship &ship);
+	// Get the AI's record of the given ship, or nullptr if it has none.
+	const ShipState *FindState(const Ship &ship) const;
+	// Release the records of ships that no longer exist.
+	void ReleaseStates();
+	// Change which ship the given ship is moving in to board.
+	void SetBoarding(ShipState &state, const Ship *target);
+	// Check if the given ship has recently been beyond the "invisible fence."
+	bool IsBeyondFence(const Ship &ship) const;
+
 	// Check if a ship can pursue its target (i.e. beyond the "fence").
 	bool CanPursue(const Ship &ship, const Ship &target) const;
 	// Disabled or stranded ships coordinate with other ships to get assistance.
@@ -199,6 +276,10 @@ private:
 	// Return a bitmask giving the weapons to fire.
 	void AutoFire(const Ship &ship, FireCommand &command, bool secondary = true, bool isFlagship = false) const;
 	void AutoFire(const Ship &ship, FireCommand &command, const Body &target) const;
+	// Queue up the firing decision for the given ship, to be evaluated by FireQueued().
+	void QueueFiring(Ship &ship, bool aim, bool opportunistic, const Minable *targetAsteroid);
+	// Evaluate every queued firing decision, then give each ship its firing commands.
+	void FireQueued();
 
 	// Calculate how long it will take a projectile to reach a target given the
 	// target's relative position and velocity and the velocity of the
@@ -208,9 +289,9 @@ private:
 	// True if found asteroid.
 	bool TargetMinable(Ship &ship) const;
 	// True if the ship performed the indicated event to the other ship.
-	bool Has(const Ship &ship, const std::weak_ptr<const Ship> &other, int type) const;
+	bool Has(const Ship &ship, const Ship &other, int type) const;
 	// True if the government performed the indicated event to the other ship.
-	bool Has(const Government *government, const std::weak_ptr<const Ship> &other, int type) const;
+	bool Has(const Government *government, const Ship &other, int type) const;
 	// True if the ship has performed the indicated event against any member of the government.
 	bool Has(const Ship &ship, const Government *government, int type) const;
 
@@ -233,9 +314,9 @@ private:
 	// TODO: Figure out a way to remove the player dependency.
 	PlayerInfo &player;
 	// Data from the game engine.
-	const List<Ship> &ships;
+	const Array<Ship> &ships;
 	const List<Minable> &minables;
-	const List<Flotsam> &flotsam;
+	const Array<Flotsam> &flotsam;
 
 	// The current step count for the AI, incremented once per frame.
 	// Its value helps limit how often certain actions occur (such as changing targets).
@@ -249,6 +330,10 @@ private:
 	// thrashing the heap, since we can reuse the storage for
 	// each ship.
 	FireCommand firingCommands;
+	// Firing decisions queued up during this step. Only the first firingPlanCount
+	// entries are in use; the rest are kept to reuse their storage.
+	std::vector<FiringPlan> firingPlans;
+	size_t firingPlanCount = 0;
 
 	bool isCloaking = false;
 
@@ -260,39 +345,39 @@ private:
 
 	// Current orders for the player's ships. Because this map only applies to
 	// player ships, which are never deleted except when landed, it can use
-	// ordinary pointers instead of weak pointers.
-	std::map<const Ship *, OrderSet> orders;
-
-	// Records of what various AI ships and factions have done.
-	typedef std::owner_less<std::weak_ptr<const Ship>> Comp;
-	std::map<std::weak_ptr<const Ship>, std::map<std::weak_ptr<const Ship>, int, Comp>, Comp> actions;
-	std::map<std::weak_ptr<const Ship>, std::map<const Government *, int>, Comp> notoriety;
-	std::map<const Government *, std::map<std::weak_ptr<const Ship>, int, Comp>> governmentActions;
+	// ordinary pointers instead of weak pointers. Each ship's orders are looked
+	// up several times a step, so they are kept in a hash table.
+	std::unordered_map<const Ship *, OrderSet> orders;
+
+	// Records of what various AI ships and factions have done. What was done
+	// to or by each ship is kept in that ship's record.
 	std::map<const Government *, bool> scanPermissions;
-	std::map<std::weak_ptr<const Ship>, int, Comp> playerActions;
-	std::map<const Ship *, std::weak_ptr<Ship>> helperList;
-	std::map<const Ship *, int> swarmCount;
-	std::map<const Ship *, int> fenceCount;
-	std::map<const Ship *, std::set<const Ship *>> cargoScans;
-	std::map<const Ship *, std::set<const Ship *>> outfitScans;
-	std::map<const Ship *, int> scanTime;
-	std::map<const Ship *, Angle> miningAngle;
-	std::map<const Ship *, double> miningRadius;
-	std::map<const Ship *, int> miningTime;
-	std::map<const Ship *, double> appeasementThreshold;
-	std::map<const Ship *, const Ship *> boarders;
-	std::map<const Ship *, std::set<std::weak_ptr<const Ship>, std::owner_less<std::weak_ptr<const Ship>>>> closeBy;
+
+	// Records of individual ships, indexed by the slot stored in each ship.
+	std::vector<ShipState> shipStates;
+	// Slots that have been released, and can be given to new ships.
+	std::vector<int> freeShipStates;
+	// The ID that the next ship to be given a record will get.
+	uint64_t nextStateId = 1;
+	// How many ships are moving in to board another ship.
+	int boarderCount = 0;
 
 	// Records for formations flying around leadships and other objects.
 	std::map<const Body *, std::map<const FormationPattern *, FormationPositioner>> formations;
 
 	// Records that affect the combat behavior of various governments.
-	std::map<const Ship *, int64_t> shipStrength;
 	std::map<const Government *, int64_t> enemyStrength;
 	std::map<const Government *, int64_t> allyStrength;
+	// The ships of each government in the player's system. A government's enemies
+	// and allies are found by checking each other government's roster.
 	std::map<const Government *, std::vector<Ship *>> governmentRosters;
-	std::map<const Government *, std::vector<Ship *>> enemyLists;
-	std::map<const Government *, std::vector<Ship *>> allyLists;
+	// The same ships indexed by position, so that a search for ships within a
+	// certain range only needs to look at the ones nearby. It is only valid
+	// during Step(), since the ships move afterward.
+	CollisionSet shipIndex;
+	bool hasShipIndex = false;
+	// The highest speed of any of the ships in the index.
+	double shipIndexMaxSpeed = 0.;
 
 	// Route planning cache:
 	std::unordered_map<RouteCacheKey, RoutePlan, RouteCacheKey::HashFunction> routeCache;
@@ -19,9 +19,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Random.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdlib>
-#include <vector>
 
 using namespace std;
 
@@ -29,29 +29,28 @@ namespace {
 	// Suppose you want to be able to turn 360 degrees in one second. Then you are
 	// turning 6 degrees per time step. If the Angle lookup is 2^16 steps, then 6
 	// degrees is 1092 steps, and your turn speed is accurate to +- 0.05%. That seems
-	// plenty accurate to me. At that step size, the lookup table is exactly 1 MB.
+	// plenty accurate to me.
 	constexpr int32_t STEPS = 0x10000;
 	constexpr int32_t MASK = STEPS - 1;
+	constexpr int32_t QUARTER = STEPS / 4;
 	constexpr double DEG_TO_STEP = STEPS / 360.;
 	constexpr double STEP_TO_RAD = PI / (STEPS / 2);
+	constexpr double RAD_TO_STEP = (STEPS / 2) / PI;
 
-	vector<Point> InitUnitCache()
+	// The sine of every step of the first quarter turn, including its end. Every
+	// other sine and cosine is one of these, possibly negated, so the table is
+	// only 128 KB, and the parts of it in use are far more likely to be cached
+	// than a table of every unit vector would be.
+	array<double, QUARTER + 1> InitSineTable()
 	{
-		vector<Point> cache;
-		cache.reserve(STEPS);
-		for(int i = 0; i < STEPS; ++i)
-		{
-			const double radians = i * STEP_TO_RAD;
-			// The graphics use the usual screen coordinate system, meaning that
-			// positive Y is down rather than up. Angles are clock angles, i.e.
-			// 0 is 12:00 and angles increase in the clockwise direction. So, an
-			// angle of 0 degrees is pointing in the direction (0, -1).
-			cache.emplace_back(sin(radians), -cos(radians));
-		}
-		return cache;
+		array<double, QUARTER + 1> table;
+		for(int i = 0; i < QUARTER; ++i)
+			table[i] = sin(i * STEP_TO_RAD);
+		table[QUARTER] = 1.;
+		return table;
 	}
 
-	const vector<Point> unitCache = InitUnitCache();
+	const array<double, QUARTER + 1> sineTable = InitSineTable();
 }
 
 
@@ -89,7 +88,7 @@ Angle::Angle(const double degrees) noexcept
 
 // Construct an angle pointing in the direction of the given vector.
 Angle::Angle(const Point &point) noexcept
-	: Angle(TO_DEG * atan2(point.X(), -point.Y()))
+	: angle(llround(atan2(point.X(), -point.Y()) * RAD_TO_STEP) & MASK)
 {
 }
 
@@ -155,7 +154,21 @@ bool Angle::operator!=(const Angle &other) const
 // Get a unit vector in the direction of this angle.
 Point Angle::Unit() const
 {
-	return unitCache[angle];
+	// The graphics use the usual screen coordinate system, meaning that
+	// positive Y is down rather than up. Angles are clock angles, i.e.
+	// 0 is 12:00 and angles increase in the clockwise direction. So, an
+	// angle of 0 degrees is pointing in the direction (0, -1).
+	// Within each quarter turn, the coordinates are the sine and cosine of the
+	// angle within that quarter, with signs that depend on which quarter it is.
+	// In odd quarters they trade places, which is the same as counting the steps
+	// back from the end of the quarter. This is done without branching, since
+	// the quarter is hard to predict.
+	const int32_t quarter = angle / QUARTER;
+	const int32_t odd = -(quarter & 1);
+	const int32_t step = ((angle & (QUARTER - 1)) ^ odd) - odd + (QUARTER & odd);
+	static constexpr double SIGN_X[4] = {1., 1., -1., -1.};
+	static constexpr double SIGN_Y[4] = {-1., 1., 1., -1.};
+	return Point(SIGN_X[quarter] * sineTable[step], SIGN_Y[quarter] * sineTable[QUARTER - step]);
 }
 
 
@@ -191,6 +204,17 @@ Point Angle::Rotate(const Point &point) const
 
 
 
+// Get how far this angle is from the given one, turning whichever way is
+// shorter. This is in the fixed-point units that angles are stored in, so it
+// is only meant for comparing which of several angles is nearest.
+int32_t Angle::Distance(const Angle &other) const
+{
+	const int32_t difference = (angle - other.angle) & MASK;
+	return min(difference, STEPS - difference);
+}
+
+
+
 // Judge whether this is inside from "base" to "limit."
 // The range from "base" to "limit" is expressed by "clock" orientation.
 bool Angle::IsInRange(const Angle &base, const Angle &limit) const
@@ -61,6 +61,11 @@ public:
 	// Return a point rotated by this angle around (0, 0).
 	Point Rotate(const Point &point) const;
 
+	// Get how far this angle is from the given one, turning whichever way is
+	// shorter. This is in the fixed-point units that angles are stored in, so it
+	// is only meant for comparing which of several angles is nearest.
+	int32_t Distance(const Angle &other) const;
+
 	// Judge whether this is inside from "base" to "limit."
 	// The range from "base" to "limit" is expressed by "clock" orientation.
 	bool IsInRange(const Angle &base, const Angle &limit) const;
@@ -73,7 +78,7 @@ private:
 private:
 	// The angle is stored as an integer value between 0 and 2^16 - 1. This is
 	// so that any angle can be mapped to a unit vector (a very common operation)
-	// with just a single array lookup. It also means that "wrapping" angles
+	// with just a lookup in a table of sines. It also means that "wrapping" angles
 	// to the range of 0 to 360 degrees can be done via a bit mask.
 	int32_t angle = 0;
 };
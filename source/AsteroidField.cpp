@@ -52,6 +52,7 @@ AsteroidField::AsteroidField()
 void AsteroidField::Clear()
 {
 	asteroids.clear();
+	maxRadius = 0.;
 	minables.clear();
 }
 
@@ -63,6 +64,8 @@ void AsteroidField::Add(const string &name, int count, double energy)
 	const Sprite *sprite = SpriteSet::Get("asteroid/" + name + "/spin");
 	for(int i = 0; i < count; ++i)
 		asteroids.emplace_back(sprite, energy);
+	if(count > 0)
+		maxRadius = max(maxRadius, asteroids.back().Radius());
 }
 
 
@@ -116,8 +119,12 @@ void AsteroidField::Step(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flo
 // Draw the asteroids, centered on the given location.
 void AsteroidField::Draw(DrawList &draw, const Point &center, double zoom) const
 {
+	// Any asteroid within this range must be drawn.
+	Point size = Point(1., 1.) * maxRadius;
+	Point topLeft = center + (Screen::TopLeft() - size) / zoom;
+	Point bottomRight = center + (Screen::BottomRight() + size) / zoom;
 	for(const Asteroid &asteroid : asteroids)
-		asteroid.Draw(draw, center, zoom);
+		asteroid.Draw(draw, topLeft, bottomRight);
 	for(const shared_ptr<Minable> &minable : minables)
 		draw.Add(*minable);
 }
@@ -198,10 +205,6 @@ AsteroidField::Asteroid::Asteroid(const Sprite *sprite, double energy)
 
 	// The asteroid's velocity is also determined by the energy level.
 	velocity = angle.Unit() * Random::Real() * energy;
-
-	// Store how big an area the asteroid can cover, so we can figure out when
-	// it is potentially on screen.
-	size = Point(1., 1.) * Radius();
 }
 
 
@@ -226,13 +229,9 @@ void AsteroidField::Asteroid::Step()
 
 
 
-// Draw any instances of this asteroid that are on screen.
-void AsteroidField::Asteroid::Draw(DrawList &draw, const Point &center, double zoom) const
+// Draw any instances of this asteroid within the given part of the map.
+void AsteroidField::Asteroid::Draw(DrawList &draw, const Point &topLeft, const Point &bottomRight) const
 {
-	// Any object within this range must be drawn.
-	Point topLeft = center + (Screen::TopLeft() - size) / zoom;
-	Point bottomRight = center + (Screen::BottomRight() + size) / zoom;
-
 	// Figure out the position of the first instance of this asteroid that is to
 	// the right of and below the top left corner of the screen.
 	double startX = fmod(position.X() - topLeft.X(), WRAP);
@@ -78,16 +78,19 @@ private:
 		Asteroid(const Sprite *sprite, double energy);
 
 		void Step();
-		void Draw(DrawList &draw, const Point &center, double zoom) const;
+		// Draw any instances of this asteroid within the given part of the map.
+		void Draw(DrawList &draw, const Point &topLeft, const Point &bottomRight) const;
 
 	private:
 		Angle spin;
-		Point size;
 	};
 
 
 private:
 	std::vector<Asteroid> asteroids;
+	// The radius of the largest asteroid, so that the part of the map that an
+	// asteroid may be visible in only has to be found once for all of them.
+	double maxRadius = 0.;
 	std::list<std::shared_ptr<Minable>> minables;
 
 	CollisionSet asteroidCollisions;
@@ -0,0 +1,219 @@
+/* AttributeKey.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+
+
+// The attributes that are read for every ship in every frame, while it moves,
+// recharges and cools down, and those read whenever a ship is hit or scanned.
+// Each of them has a fixed ID, which a Dictionary can
+// use to find its value directly instead of searching for its name. Any other
+// attribute, including those only defined by plugins, is still looked up by name.
+enum class AttributeKey : int {
+	HULL_REPAIR_RATE,
+	DELAYED_HULL_REPAIR_RATE,
+	HULL_REPAIR_MULTIPLIER,
+	CLOAKED_REPAIR_MULTIPLIER,
+	HULL_ENERGY,
+	DELAYED_HULL_ENERGY,
+	HULL_ENERGY_MULTIPLIER,
+	HULL_FUEL,
+	DELAYED_HULL_FUEL,
+	HULL_FUEL_MULTIPLIER,
+	HULL_HEAT,
+	DELAYED_HULL_HEAT,
+	HULL_HEAT_MULTIPLIER,
+	SHIELD_GENERATION,
+	DELAYED_SHIELD_GENERATION,
+	SHIELD_GENERATION_MULTIPLIER,
+	CLOAKED_REGEN_MULTIPLIER,
+	SHIELD_ENERGY,
+	DELAYED_SHIELD_ENERGY,
+	SHIELD_ENERGY_MULTIPLIER,
+	SHIELD_FUEL,
+	DELAYED_SHIELD_FUEL,
+	SHIELD_FUEL_MULTIPLIER,
+	SHIELD_HEAT,
+	DELAYED_SHIELD_HEAT,
+	SHIELD_HEAT_MULTIPLIER,
+	SHIELDS,
+	SHIELD_MULTIPLIER,
+	HULL,
+	HULL_MULTIPLIER,
+	ABSOLUTE_THRESHOLD,
+	THRESHOLD_PERCENTAGE,
+	DISABLED_RECOVERY_TIME,
+	ENERGY_CAPACITY,
+	FUEL_CAPACITY,
+	ENERGY_GENERATION,
+	ENERGY_CONSUMPTION,
+	FUEL_GENERATION,
+	HEAT_GENERATION,
+	FUEL_CONSUMPTION,
+	FUEL_ENERGY,
+	FUEL_HEAT,
+	RAMSCOOP,
+	SOLAR_COLLECTION,
+	SOLAR_HEAT,
+	COOLING,
+	ACTIVE_COOLING,
+	COOLING_ENERGY,
+	COOLING_INEFFICIENCY,
+	HEAT_DISSIPATION,
+	HEAT_CAPACITY,
+	OVERHEAT_DAMAGE_THRESHOLD,
+	OVERHEAT_DAMAGE_RATE,
+	CLOAK,
+	CLOAK_BY_MASS,
+	CLOAK_PHASING,
+	DRAG,
+	DRAG_REDUCTION,
+	INERTIA_REDUCTION,
+	THRUST,
+	REVERSE_THRUST,
+	AFTERBURNER_THRUST,
+	ACCELERATION_MULTIPLIER,
+	TURN,
+	TURN_MULTIPLIER,
+
+	// Protection against each kind of damage.
+	PIERCING_PROTECTION,
+	PIERCING_RESISTANCE,
+	HIGH_SHIELD_PERMEABILITY,
+	LOW_SHIELD_PERMEABILITY,
+	CLOAKED_SHIELD_PERMEABILITY,
+	SHIELD_PROTECTION,
+	CLOAK_SHIELD_PROTECTION,
+	HULL_PROTECTION,
+	CLOAK_HULL_PROTECTION,
+	ENERGY_PROTECTION,
+	HEAT_PROTECTION,
+	FUEL_PROTECTION,
+	DISCHARGE_PROTECTION,
+	CORROSION_PROTECTION,
+	ION_PROTECTION,
+	BURN_PROTECTION,
+	LEAK_PROTECTION,
+	SLOWING_PROTECTION,
+	SCRAMBLE_PROTECTION,
+	DISRUPTION_PROTECTION,
+	FORCE_PROTECTION,
+
+	// Whether an outfit or ship is illegal, checked for everything on a ship
+	// whenever it is scanned.
+	ILLEGAL,
+	ATROCITY,
+
+	// The number of keys. This must stay last.
+	COUNT
+};
+
+
+
+// The name of each attribute key, in the same order as the keys.
+constexpr std::array<const char *, static_cast<size_t>(AttributeKey::COUNT)> ATTRIBUTE_KEY_NAMES = {
+	"hull repair rate",
+	"delayed hull repair rate",
+	"hull repair multiplier",
+	"cloaked repair multiplier",
+	"hull energy",
+	"delayed hull energy",
+	"hull energy multiplier",
+	"hull fuel",
+	"delayed hull fuel",
+	"hull fuel multiplier",
+	"hull heat",
+	"delayed hull heat",
+	"hull heat multiplier",
+	"shield generation",
+	"delayed shield generation",
+	"shield generation multiplier",
+	"cloaked regen multiplier",
+	"shield energy",
+	"delayed shield energy",
+	"shield energy multiplier",
+	"shield fuel",
+	"delayed shield fuel",
+	"shield fuel multiplier",
+	"shield heat",
+	"delayed shield heat",
+	"shield heat multiplier",
+	"shields",
+	"shield multiplier",
+	"hull",
+	"hull multiplier",
+	"absolute threshold",
+	"threshold percentage",
+	"disabled recovery time",
+	"energy capacity",
+	"fuel capacity",
+	"energy generation",
+	"energy consumption",
+	"fuel generation",
+	"heat generation",
+	"fuel consumption",
+	"fuel energy",
+	"fuel heat",
+	"ramscoop",
+	"solar collection",
+	"solar heat",
+	"cooling",
+	"active cooling",
+	"cooling energy",
+	"cooling inefficiency",
+	"heat dissipation",
+	"heat capacity",
+	"overheat damage threshold",
+	"overheat damage rate",
+	"cloak",
+	"cloak by mass",
+	"cloak phasing",
+	"drag",
+	"drag reduction",
+	"inertia reduction",
+	"thrust",
+	"reverse thrust",
+	"afterburner thrust",
+	"acceleration multiplier",
+	"turn",
+	"turn multiplier",
+	"piercing protection",
+	"piercing resistance",
+	"high shield permeability",
+	"low shield permeability",
+	"cloaked shield permeability",
+	"shield protection",
+	"cloak shield protection",
+	"hull protection",
+	"cloak hull protection",
+	"energy protection",
+	"heat protection",
+	"fuel protection",
+	"discharge protection",
+	"corrosion protection",
+	"ion protection",
+	"burn protection",
+	"leak protection",
+	"slowing protection",
+	"scramble protection",
+	"disruption protection",
+	"force protection",
+	"illegal",
+	"atrocity"
+};
@@ -0,0 +1,255 @@
+/* BinaryDataFile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "BinaryDataFile.h"
+
+#include "DataFile.h"
+#include "DataWriter.h"
+#include "Files.h"
+#include "Logger.h"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+	// This must be changed whenever the layout of the binary form changes.
+	const char MAGIC[8] = {'E', 'S', 'B', 'I', 'N', 'A', 'R', '1'};
+
+	// Numbers are written seven bits at a time, so that the small indices and
+	// counts that make up most of a file only take a single byte each.
+	void WriteNumber(string &out, uint64_t value)
+	{
+		while(value >= 0x80)
+		{
+			out += static_cast<char>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		out += static_cast<char>(value);
+	}
+
+	bool ReadNumber(const char *&it, const char *end, uint64_t &value)
+	{
+		value = 0;
+		for(int shift = 0; it != end && shift < 64; shift += 7)
+		{
+			const unsigned char byte = *it++;
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if(!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+}
+
+
+
+bool BinaryDataFile::IsBinary(string_view data)
+{
+	return data.size() >= sizeof(MAGIC) && !memcmp(data.data(), MAGIC, sizeof(MAGIC));
+}
+
+
+
+string BinaryDataFile::Encode(const DataFile &file)
+{
+	// Give every distinct token an index, in the order they are first used.
+	string nodes;
+	unordered_map<string_view, uint32_t> ids;
+	WriteNumber(nodes, file.root.children.size());
+	for(const DataNode &node : file.root.children)
+		WriteNode(nodes, node, ids);
+
+	vector<string_view> strings(ids.size());
+	for(const auto &[token, id] : ids)
+		strings[id] = token;
+	string payload;
+	WriteNumber(payload, strings.size());
+	for(const string_view &token : strings)
+	{
+		WriteNumber(payload, token.size());
+		payload += token;
+	}
+	payload += nodes;
+
+	// The header holds the size of the payload, so it can be decompressed in one go.
+	uLongf compressedSize = compressBound(payload.size());
+	string out(MAGIC, sizeof(MAGIC));
+	const uint64_t payloadSize = payload.size();
+	out.append(reinterpret_cast<const char *>(&payloadSize), sizeof(payloadSize));
+	const size_t header = out.size();
+	out.resize(header + compressedSize);
+	if(compress2(reinterpret_cast<Bytef *>(out.data() + header), &compressedSize,
+			reinterpret_cast<const Bytef *>(payload.data()), payload.size(), Z_BEST_SPEED) != Z_OK)
+		return {};
+	out.resize(header + compressedSize);
+	return out;
+}
+
+
+
+string BinaryDataFile::Encode(const string &text)
+{
+	istringstream in(text);
+	DataFile file(in);
+	return Encode(file);
+}
+
+
+
+bool BinaryDataFile::Decode(string_view data, DataFile &file)
+{
+	uint64_t payloadSize = 0;
+	if(!IsBinary(data) || data.size() < sizeof(MAGIC) + sizeof(payloadSize))
+		return false;
+	memcpy(&payloadSize, data.data() + sizeof(MAGIC), sizeof(payloadSize));
+	data.remove_prefix(sizeof(MAGIC) + sizeof(payloadSize));
+
+	// Each byte of compressed data expands to at most about a thousand bytes,
+	// so a larger size means the header is corrupt.
+	if(payloadSize > 1032 * static_cast<uint64_t>(data.size()) + 1024)
+		return false;
+	string payload(payloadSize, '\0');
+	uLongf size = payloadSize;
+	if(uncompress(reinterpret_cast<Bytef *>(payload.data()), &size,
+			reinterpret_cast<const Bytef *>(data.data()), data.size()) != Z_OK || size != payloadSize)
+		return false;
+
+	const char *it = payload.data();
+	const char *end = it + payload.size();
+	uint64_t count = 0;
+	// Every string takes up at least one byte.
+	if(!ReadNumber(it, end, count) || count > static_cast<size_t>(end - it))
+		return false;
+	vector<string_view> table;
+	table.reserve(count);
+	for(uint64_t i = 0; i < count; ++i)
+	{
+		uint64_t length = 0;
+		if(!ReadNumber(it, end, length) || length > static_cast<size_t>(end - it))
+			return false;
+		table.emplace_back(it, length);
+		it += length;
+	}
+
+	// The line numbers are those that the nodes would have in the text form,
+	// if it had no blank lines or comments.
+	size_t lineNumber = 0;
+	DataNode &root = file.root;
+	if(!ReadNumber(it, end, count) || count > static_cast<size_t>(end - it))
+		return false;
+	root.children.reserve(count);
+	for(uint64_t i = 0; i < count; ++i)
+	{
+		root.children.emplace_back(&root);
+		if(!ReadNode(it, end, table, root.children.back(), lineNumber, 1))
+		{
+			root.children.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+string BinaryDataFile::ToText(const DataFile &file)
+{
+	DataWriter out;
+	for(const DataNode &node : file)
+		out.Write(node);
+	return out.SaveToString();
+}
+
+
+
+bool BinaryDataFile::Convert(const filesystem::path &path)
+{
+	string data = Files::Read(path);
+	if(data.empty())
+		return false;
+
+	DataFile file;
+	if(IsBinary(data))
+	{
+		if(!Decode(data, file))
+		{
+			Logger::Log("Could not read \"" + path.string() + "\", because it is corrupt.", Logger::Level::WARNING);
+			return false;
+		}
+		data = ToText(file);
+	}
+	else
+	{
+		istringstream in(data);
+		file.Load(in);
+		data = Encode(file);
+	}
+	// Saved games may share their contents with snapshots, so they must be
+	// replaced rather than written in place.
+	filesystem::path temporary = path;
+	temporary += ".tmp";
+	Files::Write(temporary, data);
+	Files::Move(temporary, path);
+	return true;
+}
+
+
+
+void BinaryDataFile::WriteNode(string &out, const DataNode &node, unordered_map<string_view, uint32_t> &ids)
+{
+	WriteNumber(out, node.tokens.size());
+	for(const string &token : node.tokens)
+		WriteNumber(out, ids.emplace(token, static_cast<uint32_t>(ids.size())).first->second);
+	WriteNumber(out, node.children.size());
+	for(const DataNode &child : node.children)
+		WriteNode(out, child, ids);
+}
+
+
+
+bool BinaryDataFile::ReadNode(const char *&it, const char *end, const vector<string_view> &table,
+	DataNode &node, size_t &lineNumber, int depth)
+{
+	if(depth > DataNode::MAX_DEPTH)
+		return false;
+	node.lineNumber = ++lineNumber;
+	uint64_t count = 0;
+	// Every token and child takes up at least one byte.
+	if(!ReadNumber(it, end, count) || count > static_cast<size_t>(end - it))
+		return false;
+	node.tokens.reserve(count);
+	for(uint64_t i = 0; i < count; ++i)
+	{
+		uint64_t id = 0;
+		if(!ReadNumber(it, end, id) || id >= table.size())
+			return false;
+		node.tokens.emplace_back(table[id]);
+	}
+
+	if(!ReadNumber(it, end, count) || count > static_cast<size_t>(end - it))
+		return false;
+	node.children.reserve(count);
+	for(uint64_t i = 0; i < count; ++i)
+	{
+		node.children.emplace_back(&node);
+		if(!ReadNode(it, end, table, node.children.back(), lineNumber, depth + 1))
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,60 @@
+/* BinaryDataFile.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class DataFile;
+class DataNode;
+
+
+
+// A compact binary form of a data file, which saved games are written in when
+// the "Compact save files" preference is on. Each distinct token is stored only
+// once, in a table of strings that the nodes refer to by index, and the whole
+// file is compressed with zlib. DataFile recognizes this form by its first few
+// bytes and reads it straight into nodes, so anything that can read a text
+// file, such as a SavedGame, can read a binary one as well.
+class BinaryDataFile {
+public:
+	// Check if the given file contents are in the binary form.
+	static bool IsBinary(std::string_view data);
+
+	// Get the binary form of the given file's nodes.
+	static std::string Encode(const DataFile &file);
+	// Get the binary form of the given text.
+	static std::string Encode(const std::string &text);
+	// Read the binary form into the given file's nodes. Returns false if the data
+	// is corrupt, in which case the file is left empty.
+	static bool Decode(std::string_view data, DataFile &file);
+	// Get the text form of the given file's nodes.
+	static std::string ToText(const DataFile &file);
+
+	// Rewrite the given file in whichever form it is not in now. Returns false
+	// if the file could not be read.
+	static bool Convert(const std::filesystem::path &path);
+
+
+private:
+	static void WriteNode(std::string &out, const DataNode &node, std::unordered_map<std::string_view, uint32_t> &ids);
+	static bool ReadNode(const char *&it, const char *end, const std::vector<std::string_view> &table,
+		DataNode &node, size_t &lineNumber, int depth);
+};
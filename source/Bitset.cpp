@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Bitset.h"
 
 #include <algorithm>
+#include <bit>
 
 
 
@@ -26,7 +27,7 @@ using namespace std;
 // Returns the number of bits this bitset can hold.
 size_t Bitset::Size() const noexcept
 {
-	return bits.size() * BITS_PER_BLOCK;
+	return blocks * BITS_PER_BLOCK;
 }
 
 
@@ -34,7 +35,7 @@ size_t Bitset::Size() const noexcept
 // Returns the number of bits this bitset has reserved.
 size_t Bitset::Capacity() const noexcept
 {
-	return bits.capacity() * BITS_PER_BLOCK;
+	return (blocks > INLINE_BLOCKS ? heapBits.capacity() : blocks) * BITS_PER_BLOCK;
 }
 
 
@@ -42,7 +43,22 @@ size_t Bitset::Capacity() const noexcept
 // Resizes the bitset to hold at least the specific amount of bits.
 void Bitset::Resize(size_t size)
 {
-	bits.resize(size / BITS_PER_BLOCK + 1);
+	const size_t count = size / BITS_PER_BLOCK + 1;
+	if(count > INLINE_BLOCKS)
+	{
+		// Move the bits to the heap if they were stored in place.
+		if(blocks <= INLINE_BLOCKS)
+			heapBits.assign(inlineBits.begin(), inlineBits.begin() + blocks);
+		heapBits.resize(count);
+	}
+	else
+	{
+		if(blocks > INLINE_BLOCKS)
+			copy_n(heapBits.begin(), count, inlineBits.begin());
+		// Any blocks that were dropped must be clear if they come back.
+		fill(inlineBits.begin() + count, inlineBits.end(), uint64_t(0));
+	}
+	blocks = count;
 }
 
 
@@ -50,7 +66,9 @@ void Bitset::Resize(size_t size)
 // Clears the bitset. After this call this bitset is empty.
 void Bitset::Clear() noexcept
 {
-	bits.clear();
+	blocks = 0;
+	inlineBits.fill(0);
+	heapBits.clear();
 }
 
 
@@ -58,9 +76,11 @@ void Bitset::Clear() noexcept
 // Whether the given bitset has any bits that are also set in this bitset.
 bool Bitset::Intersects(const Bitset &other) const noexcept
 {
-	const auto size = min(bits.size(), other.bits.size());
+	const uint64_t *bits = Blocks();
+	const uint64_t *otherBits = other.Blocks();
+	const auto size = min(blocks, other.blocks);
 	for(size_t i = 0; i < size; ++i)
-		if(bits[i] & other.bits[i])
+		if(bits[i] & otherBits[i])
 			return true;
 	return false;
 }
@@ -72,7 +92,7 @@ bool Bitset::Test(size_t index) const noexcept
 {
 	const auto blockIndex = index / BITS_PER_BLOCK;
 	const auto pos = index % BITS_PER_BLOCK;
-	return bits[blockIndex] & (uint64_t(1) << pos);
+	return Blocks()[blockIndex] & (uint64_t(1) << pos);
 }
 
 
@@ -82,7 +102,17 @@ void Bitset::Set(size_t index) noexcept
 {
 	const auto blockIndex = index / BITS_PER_BLOCK;
 	const auto pos = index % BITS_PER_BLOCK;
-	bits[blockIndex] |= (uint64_t(1) << pos);
+	Blocks()[blockIndex] |= (uint64_t(1) << pos);
+}
+
+
+
+// Resets the bit at the specified index.
+void Bitset::Reset(size_t index) noexcept
+{
+	const auto blockIndex = index / BITS_PER_BLOCK;
+	const auto pos = index % BITS_PER_BLOCK;
+	Blocks()[blockIndex] &= ~(uint64_t(1) << pos);
 }
 
 
@@ -90,8 +120,7 @@ void Bitset::Set(size_t index) noexcept
 // Resets all bits in the bitset.
 void Bitset::Reset() noexcept
 {
-	for(auto &it : bits)
-		it = uint64_t(0);
+	fill_n(Blocks(), blocks, uint64_t(0));
 }
 
 
@@ -99,8 +128,9 @@ void Bitset::Reset() noexcept
 // Whether any bits are set.
 bool Bitset::Any() const noexcept
 {
-	for(uint64_t block : bits)
-		if(block)
+	const uint64_t *bits = Blocks();
+	for(size_t i = 0; i < blocks; ++i)
+		if(bits[i])
 			return true;
 	return false;
 }
@@ -115,10 +145,95 @@ bool Bitset::None() const noexcept
 
 
 
+// Returns the number of bits that are set.
+size_t Bitset::Count() const noexcept
+{
+	const uint64_t *bits = Blocks();
+	size_t count = 0;
+	for(size_t i = 0; i < blocks; ++i)
+		count += popcount(bits[i]);
+	return count;
+}
+
+
+
+// Returns the index of the first set bit at or after the given index, or
+// Size() if there is none.
+size_t Bitset::FindNext(size_t index) const noexcept
+{
+	if(index >= Size())
+		return Size();
+
+	const uint64_t *bits = Blocks();
+	size_t blockIndex = index / BITS_PER_BLOCK;
+	// Ignore the bits before the index in its block.
+	uint64_t block = bits[blockIndex] & (~uint64_t(0) << (index % BITS_PER_BLOCK));
+	while(!block)
+	{
+		if(++blockIndex == blocks)
+			return Size();
+		block = bits[blockIndex];
+	}
+	return blockIndex * BITS_PER_BLOCK + countr_zero(block);
+}
+
+
+
 // Fills the current bitset with the bits of other.
 void Bitset::UpdateWith(const Bitset &other)
 {
-	const auto size = min(bits.size(), other.bits.size());
+	copy_n(other.Blocks(), min(blocks, other.blocks), Blocks());
+}
+
+
+
+// Combine this bitset with other, a whole block of bits at a time. Any bits
+// beyond the end of other count as not set.
+Bitset &Bitset::operator&=(const Bitset &other) noexcept
+{
+	uint64_t *bits = Blocks();
+	const uint64_t *otherBits = other.Blocks();
+	const size_t size = min(blocks, other.blocks);
 	for(size_t i = 0; i < size; ++i)
-		bits[i] = other.bits[i];
+		bits[i] &= otherBits[i];
+	fill(bits + size, bits + blocks, uint64_t(0));
+	return *this;
+}
+
+
+
+Bitset &Bitset::operator|=(const Bitset &other) noexcept
+{
+	uint64_t *bits = Blocks();
+	const uint64_t *otherBits = other.Blocks();
+	const size_t size = min(blocks, other.blocks);
+	for(size_t i = 0; i < size; ++i)
+		bits[i] |= otherBits[i];
+	return *this;
+}
+
+
+
+// Clear every bit that is set in other.
+void Bitset::AndNot(const Bitset &other) noexcept
+{
+	uint64_t *bits = Blocks();
+	const uint64_t *otherBits = other.Blocks();
+	const size_t size = min(blocks, other.blocks);
+	for(size_t i = 0; i < size; ++i)
+		bits[i] &= ~otherBits[i];
+}
+
+
+
+uint64_t *Bitset::Blocks() noexcept
+{
+	return blocks > INLINE_BLOCKS ? heapBits.data() : inlineBits.data();
+}
+
+
+
+const uint64_t *Bitset::Blocks() const noexcept
+{
+	return blocks > INLINE_BLOCKS ? heapBits.data() : inlineBits.data();
 }
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -22,7 +23,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 
 
-// Class representing a bitset with a dynamic size.
+// Class representing a bitset with a dynamic size. Small bitsets, such as the
+// weapon commands of almost every ship, are stored inline rather than on the heap.
 class Bitset {
 public:
 	// Returns the number of bits this bitset can hold.
@@ -41,20 +43,44 @@ public:
 	bool Test(size_t index) const noexcept;
 	// Sets the bit at the specified index.
 	void Set(size_t index) noexcept;
+	// Resets the bit at the specified index.
+	void Reset(size_t index) noexcept;
 	// Resets all bits in the bitset.
 	void Reset() noexcept;
 	// Whether any bits are set.
 	bool Any() const noexcept;
 	// Whether no bits are set.
 	bool None() const noexcept;
+	// Returns the number of bits that are set.
+	size_t Count() const noexcept;
+
+	// Returns the index of the first set bit at or after the given index, or
+	// Size() if there is none. To visit every set bit:
+	// for(size_t i = bitset.FindNext(0); i < bitset.Size(); i = bitset.FindNext(i + 1))
+	size_t FindNext(size_t index) const noexcept;
 
 	// Fills the current bitset with the bits of other.
 	void UpdateWith(const Bitset &other);
+	// Combine this bitset with other, a whole block of bits at a time. Any bits
+	// beyond the end of other count as not set.
+	Bitset &operator&=(const Bitset &other) noexcept;
+	Bitset &operator|=(const Bitset &other) noexcept;
+	// Clear every bit that is set in other.
+	void AndNot(const Bitset &other) noexcept;
+
+
+private:
+	uint64_t *Blocks() noexcept;
+	const uint64_t *Blocks() const noexcept;
 
 
 private:
 	static constexpr size_t BITS_PER_BLOCK = std::numeric_limits<uint64_t>::digits;
+	static constexpr size_t INLINE_BLOCKS = 2;
 
-	// Stores the bits of the bitset.
-	std::vector<uint64_t> bits;
+	// The number of blocks in use. Up to INLINE_BLOCKS are stored in place, and
+	// any more are stored on the heap.
+	size_t blocks = 0;
+	std::array<uint64_t, INLINE_BLOCKS> inlineBits{};
+	std::vector<uint64_t> heapBits;
 };
@@ -59,10 +59,21 @@ const Mask &Body::GetMask(int step) const
 	if(!sprite || current < 0)
 		return EMPTY;
 
-	const vector<Mask> &masks = GameData::GetMaskManager().GetMasks(sprite, Scale());
+	// Collision checks ask for the same body's mask many times each step, so
+	// remember where its masks are rather than looking them up every time.
+	if(!masks || maskSprite != sprite || maskScale != Scale())
+	{
+		const vector<Mask> &found = GameData::GetMaskManager().GetMasks(sprite, Scale());
+		// The masks of a sprite that is still loading may be filled in later.
+		if(found.empty())
+			return EMPTY;
+		masks = &found;
+		maskSprite = sprite;
+		maskScale = Scale();
+	}
 
 	// Assume that if a masks array exists, it has the right number of frames.
-	return masks.empty() ? EMPTY : masks[current % masks.size()];
+	return masks->empty() ? EMPTY : (*masks)[current % masks->size()];
 }
 
 
@@ -20,6 +20,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Angle.h"
 #include "Point.h"
 
+#include <vector>
+
 class Government;
 class Mask;
 class Sprite;
@@ -89,4 +91,10 @@ protected:
 private:
 	// Record when this object is marked for removal from the game.
 	bool shouldBeRemoved = false;
+
+	// The masks for the sprite and scale that were last asked for. The
+	// manager never moves a sprite's list of masks once it exists.
+	mutable const std::vector<Mask> *masks = nullptr;
+	mutable const Sprite *maskSprite = nullptr;
+	mutable Point maskScale;
 };
@@ -126,6 +126,24 @@ int BookEntry::Draw(const Point &topLeft, WrappedText &wrap, const Color &color)
 
 
 
+int BookEntry::Height(WrappedText &wrap) const
+{
+	int height = 0;
+	for(const Item &item : items)
+	{
+		if(holds_alternative<string>(item))
+		{
+			wrap.Wrap(std::get<string>(item));
+			height += wrap.Height();
+		}
+		else
+			height += std::get<const Sprite *>(item)->Height();
+	}
+	return height;
+}
+
+
+
 void BookEntry::LoadSingle(const DataNode &node, int startAt)
 {
 	if(node.Size() - startAt == 2 && node.Token(startAt) == "scene")
@@ -50,6 +50,8 @@ public:
 
 	// Returns height.
 	int Draw(const Point &topLeft, WrappedText &wrap, const Color &color) const;
+	// Get the height that Draw() would return, without drawing anything.
+	int Height(WrappedText &wrap) const;
 
 
 private:
@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <functional>
+#include <utility>
 
 using namespace std;
 
@@ -41,6 +42,13 @@ void CaptureOdds::Calculate()
 	if(powerD.empty() || powerA.empty() || !capture.empty())
 		return;
 
+	// Each table has one entry for every combination of crew members, so make
+	// room for all of them at once instead of growing the tables row by row.
+	const size_t size = powerA.size() * powerD.size();
+	capture.reserve(size);
+	casualtiesA.reserve(size);
+	casualtiesD.reserve(size);
+
 	// The first row represents the case where the attacker has only one crew left.
 	// In that case, the defending ship can never be successfully captured.
 	capture.resize(powerD.size(), 0.);
@@ -178,17 +186,23 @@ vector<double> CaptureOdds::Power(const Ship &ship, bool isDefender)
 
 	// Each crew member can wield one weapon. They use the most powerful ones
 	// that can be wielded by the remaining crew.
+	vector<pair<double, int>> weapons;
 	for(const auto &it : ship.Outfits())
 	{
 		double value = it.first->Get(attribute);
 		if(value > 0. && it.second > 0)
-			power.insert(power.end(), it.second, value);
+			weapons.emplace_back(value, it.second);
 	}
-	// Use the best weapons first.
-	sort(power.begin(), power.end(), greater<double>());
+	// Use the best weapons first. There is no need to list more of them than
+	// there are crew members to wield them.
+	sort(weapons.begin(), weapons.end(), greater<pair<double, int>>());
+	const size_t crew = ship.Crew();
+	power.reserve(crew);
+	for(const auto &[value, count] : weapons)
+		power.insert(power.end(), min<size_t>(count, crew - power.size()), value);
 
 	// Resize the vector to have exactly one entry per crew member.
-	power.resize(ship.Crew(), 0.);
+	power.resize(crew, 0.);
 
 	// Calculate partial sums. That is, power[N - 1] should be your total crew
 	// power when you have N crew left.
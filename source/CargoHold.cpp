@@ -60,6 +60,9 @@ void CargoHold::Clear()
 	outfits.clear();
 	missionCargo.clear();
 	passengers.clear();
+	commoditiesSize = 0;
+	outfitsSize = 0.;
+	missionCargoSize = 0;
 }
 
 
@@ -79,6 +82,7 @@ void CargoHold::Load(const DataNode &node)
 				{
 					int tons = grand.Value(1);
 					commodities[grand.Token(0)] += tons;
+					commoditiesSize += tons;
 				}
 		}
 		else if(key == "outfits")
@@ -89,6 +93,7 @@ void CargoHold::Load(const DataNode &node)
 				int count = (grand.Size() < 2) ? 1 : grand.Value(1);
 				outfits[outfit] += count;
 			}
+			UpdateOutfitsSize();
 		}
 	}
 }
@@ -205,10 +210,7 @@ double CargoHold::UsedPrecise() const
 // Get the total number of tons of commodities.
 int CargoHold::CommoditiesSize() const
 {
-	int size = 0;
-	for(const auto &it : commodities)
-		size += it.second;
-	return size;
+	return commoditiesSize;
 }
 
 
@@ -223,10 +225,7 @@ int CargoHold::OutfitsSize() const
 
 double CargoHold::OutfitsSizePrecise() const
 {
-	double size = 0.;
-	for(const auto &it : outfits)
-		size += it.second * it.first->Mass();
-	return size;
+	return outfitsSize;
 }
 
 
@@ -249,10 +248,7 @@ bool CargoHold::HasOutfits() const
 // Get the total mass of mission cargo.
 int CargoHold::MissionCargoSize() const
 {
-	int size = 0;
-	for(const auto &it : missionCargo)
-		size += it.second;
-	return size;
+	return missionCargoSize;
 }
 
 
@@ -384,6 +380,7 @@ int CargoHold::Transfer(const string &commodity, int amount, CargoHold &to)
 	int removed = Remove(commodity, amount);
 	int added = to.Add(commodity, removed);
 	commodities[commodity] += removed - added;
+	commoditiesSize += removed - added;
 
 	return added;
 }
@@ -403,6 +400,8 @@ int CargoHold::Transfer(const Outfit *outfit, int amount, CargoHold &to)
 	int removed = Remove(outfit, amount);
 	int added = to.Add(outfit, removed);
 	outfits[outfit] += removed - added;
+	if(removed != added)
+		UpdateOutfitsSize();
 
 	return added;
 }
@@ -429,7 +428,9 @@ int CargoHold::Transfer(const Mission *mission, int amount, CargoHold &to)
 		return 0;
 
 	missionCargo[mission] -= amount;
+	missionCargoSize -= amount;
 	to.missionCargo[mission] += amount;
+	to.missionCargoSize += amount;
 
 	return amount;
 }
@@ -496,6 +497,7 @@ int CargoHold::Add(const string &commodity, int amount)
 	if(size >= 0)
 		amount = max(0, min(amount, Free()));
 	commodities[commodity] += amount;
+	commoditiesSize += amount;
 	return amount;
 }
 
@@ -512,6 +514,8 @@ int CargoHold::Add(const Outfit *outfit, int amount)
 	if(size >= 0 && mass > 0.)
 		amount = max(0, min(amount, static_cast<int>(FreePrecise() / mass)));
 	outfits[outfit] += amount;
+	if(amount)
+		UpdateOutfitsSize();
 	return amount;
 }
 
@@ -525,6 +529,7 @@ int CargoHold::Remove(const string &commodity, int amount)
 
 	amount = min(amount, commodities[commodity]);
 	commodities[commodity] -= amount;
+	commoditiesSize -= amount;
 	return amount;
 }
 
@@ -538,6 +543,8 @@ int CargoHold::Remove(const Outfit *outfit, int amount)
 
 	amount = min(amount, outfits[outfit]);
 	outfits[outfit] -= amount;
+	if(amount)
+		UpdateOutfitsSize();
 	return amount;
 }
 
@@ -550,7 +557,10 @@ void CargoHold::AddMissionCargo(const Mission *mission)
 	// cargo size is zero. This is so that, for example, your cargo listing can
 	// show "important documents" even if the documents take up no cargo space.
 	if(mission && !mission->Cargo().empty())
+	{
 		missionCargo[mission] += mission->CargoSize();
+		missionCargoSize += mission->CargoSize();
+	}
 	if(mission && mission->Passengers())
 		passengers[mission] += mission->Passengers();
 }
@@ -560,7 +570,12 @@ void CargoHold::AddMissionCargo(const Mission *mission)
 // Remove all the cargo and passengers (if any) associated with the given mission.
 void CargoHold::RemoveMissionCargo(const Mission *mission)
 {
-	missionCargo.erase(mission);
+	auto it = missionCargo.find(mission);
+	if(it != missionCargo.end())
+	{
+		missionCargoSize -= it->second;
+		missionCargo.erase(it);
+	}
 	passengers.erase(mission);
 }
 
@@ -658,3 +673,15 @@ int CargoHold::IllegalCargoAmount() const
 
 	return count;
 }
+
+
+
+// Add up the mass of the outfits again, after they have changed. This is done
+// from scratch rather than by adding the change, so that rounding errors
+// cannot build up and change how many whole tons the outfits take up.
+void CargoHold::UpdateOutfitsSize()
+{
+	outfitsSize = 0.;
+	for(const auto &it : outfits)
+		outfitsSize += it.second * it.first->Mass();
+}
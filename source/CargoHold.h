@@ -117,6 +117,11 @@ public:
 	int IllegalCargoAmount() const;
 
 
+private:
+	// Add up the mass of the outfits again, after they have changed.
+	void UpdateOutfitsSize();
+
+
 private:
 	// Use -1 to indicate unlimited capacity.
 	int size = -1;
@@ -127,4 +132,10 @@ private:
 	std::map<const Outfit *, int> outfits;
 	std::map<const Mission *, int> missionCargo;
 	std::map<const Mission *, int> passengers;
+
+	// The space taken up by each kind of cargo. A ship's mass includes its
+	// cargo, so these are kept up to date rather than added up every time.
+	int commoditiesSize = 0;
+	double outfitsSize = 0.;
+	int missionCargoSize = 0;
 };
@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "text/Translation.h"
+
 #include <iterator>
 #include <string>
 #include <utility>
@@ -36,8 +38,11 @@ public:
 	// name.
 	class Category {
 	public:
-		Category(const std::string &name, int precedence) : name(name), precedence(precedence) {}
+		Category(const std::string &name, int precedence)
+			: name(name), precedence(precedence), translation("category.", name) {}
 		const std::string &Name() const { return name; }
+		// Get the name in the current language.
+		const std::string &TranslatedName() const { return translation.Get(name); }
 		const bool operator<(const Category &other) const { return SortHelper(*this, other); }
 		const bool operator()(const Category &a, const Category &b) const { return SortHelper(a, b); }
 
@@ -49,6 +54,7 @@ public:
 		friend class CategoryList;
 		std::string name;
 		int precedence = 0;
+		Translation::Handle translation;
 	};
 
 public:
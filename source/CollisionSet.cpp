@@ -23,8 +23,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Point.h"
 #include "Projectile.h"
 #include "Ship.h"
+#include "TaskQueue.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstdlib>
 #include <numeric>
 #include <set>
@@ -38,9 +41,83 @@ namespace {
 	// Velocity used for any projectiles with v > MAX_VELOCITY
 	constexpr int USED_MAX_VELOCITY = MAX_VELOCITY - 1;
 	// Warn the user only once about too-large projectile velocities.
-	bool warned = false;
+	atomic<bool> warned = false;
+
+	// How many grid cells, or possible collisions, each thread handles at a time
+	// during a batched line query.
+	constexpr size_t CELL_CHUNK_SIZE = 64;
+	constexpr size_t CANDIDATE_CHUNK_SIZE = 32;
+
+	// A line in a batched query.
+	struct BatchLine {
+		Point from;
+		Point velocity;
+		const Government *gov;
+		const Body *target;
+	};
+
+	// A grid cell that one of the lines of a batched query passes through.
+	struct CellVisit {
+		int x;
+		int y;
+		unsigned line;
+	};
+
+	// A line and an object that it might collide with.
+	struct Candidate {
+		unsigned line;
+		unsigned object;
+
+		bool operator<(const Candidate &other) const
+		{
+			return line < other.line || (line == other.line && object < other.object);
+		}
+		bool operator==(const Candidate &other) const = default;
+	};
+
+	// The limits of the grid that an adaptive collision set may choose.
+	constexpr unsigned MIN_CELL_SIZE = 64u;
+	constexpr unsigned MAX_CELL_SIZE = 2048u;
+	constexpr unsigned MIN_CELL_COUNT = 8u;
+	constexpr unsigned MAX_CELL_COUNT = 128u;
+	// How much each step's objects count towards the averages that the grid
+	// size is chosen from. A lower weight makes the grid slower to change.
+	constexpr double AVERAGE_WEIGHT = 1. / 16.;
 
 	thread_local vector<bool> seen;
+
+	// Scratch space for batched line queries.
+	thread_local vector<BatchLine> batchLines;
+	thread_local vector<const Government *> objectGovernments;
+	thread_local vector<CellVisit> visits;
+	thread_local vector<CellVisit> sortedVisits;
+	thread_local vector<unsigned> visitCounts;
+	thread_local vector<vector<Candidate>> chunkCandidates;
+	thread_local vector<Candidate> candidates;
+	thread_local vector<double> candidateRanges;
+	thread_local vector<pair<double, unsigned>> nearest;
+
+	// Cap the length of the given line to prevent integer overflows.
+	Point CapLength(const Point &from, const Point &to)
+	{
+		const Point velocity = to - from;
+		if(velocity.LengthSquared() <= static_cast<double>(MAX_VELOCITY) * MAX_VELOCITY)
+			return to;
+
+		if(!warned.exchange(true))
+			Logger::Log("A projectile exceeded the maximum allowed velocity (" + to_string(MAX_VELOCITY) + ").",
+				Logger::Level::WARNING);
+		return from + velocity.Unit() * USED_MAX_VELOCITY;
+	}
+
+	// The smallest power of two that is at least the given value.
+	unsigned RoundUpToPowerOfTwo(double value)
+	{
+		unsigned result = 1u;
+		while(result < value && result < (1u << 30))
+			result <<= 1;
+		return result;
+	}
 }
 
 
@@ -49,18 +126,7 @@ namespace {
 CollisionSet::CollisionSet(unsigned cellSize, unsigned cellCount, CollisionType collisionType)
 	: collisionType(collisionType)
 {
-	// Right shift amount to convert from (x, y) location to grid (x, y).
-	SHIFT = 0u;
-	while(cellSize >>= 1u)
-		++SHIFT;
-	CELL_SIZE = (1u << SHIFT);
-	CELL_MASK = CELL_SIZE - 1u;
-
-	// Number of grid rows and columns.
-	CELLS = 1u;
-	while(cellCount >>= 1u)
-		CELLS <<= 1;
-	WRAP_MASK = CELLS - 1u;
+	SetGrid(cellSize, cellCount);
 
 	// Just in case Clear() isn't called before objects are added:
 	Clear(0);
@@ -68,15 +134,36 @@ CollisionSet::CollisionSet(unsigned cellSize, unsigned cellCount, CollisionType
 
 
 
+// Initialize a collision set that picks its own cell size and count.
+CollisionSet::CollisionSet(CollisionType collisionType)
+	: CollisionSet(256u, 32u, collisionType)
+{
+	// Start from the averages that this grid size would be chosen for.
+	isAdaptive = true;
+	averageEntries = .5 * CELLS * CELLS;
+	averageRadius = .25 * CELL_SIZE;
+}
+
+
+
 // Clear all objects in the set.
 void CollisionSet::Clear(int step)
 {
 	this->step = step;
+	if(isAdaptive)
+		Adapt();
+
+	statistics = Statistics();
+	cellsVisited.store(0, memory_order_relaxed);
+	totalRadius = 0.;
 
 	added.clear();
-	sorted.clear();
+	sortedX.clear();
+	sortedY.clear();
+	sortedIndex.clear();
 	counts.clear();
 	all.clear();
+	masks.clear();
 	// The counts vector starts with two sentinel slots that will be used in the
 	// course of performing the radix sort.
 	counts.resize(CELLS * CELLS + 2u, 0u);
@@ -106,7 +193,9 @@ void CollisionSet::Add(Body &body)
 	}
 
 	// Also save a pointer to this object irrespective of its grid location.
+	totalRadius += body.Radius();
 	all.emplace_back(&body);
+	masks.emplace_back(&body.GetMask(step));
 }
 
 
@@ -114,12 +203,29 @@ void CollisionSet::Add(Body &body)
 // Finish adding objects (and organize them into the final lookup table).
 void CollisionSet::Finish()
 {
+	statistics.objects = all.size();
+	statistics.entries = added.size();
+	for(auto it = counts.begin() + 2; it != counts.end(); ++it)
+		if(*it)
+		{
+			++statistics.occupiedCells;
+			statistics.maxCellLoad = max(statistics.maxCellLoad, *it);
+		}
+	if(!all.empty())
+	{
+		const double meanRadius = totalRadius / all.size();
+		averageEntries += (added.size() - averageEntries) * AVERAGE_WEIGHT;
+		averageRadius += (meanRadius - averageRadius) * AVERAGE_WEIGHT;
+	}
+
 	// Perform a partial sum to convert the counts of items in each bin into the
 	// index of the output element where that bin begins.
 	partial_sum(counts.begin(), counts.end(), counts.begin());
 
 	// Allocate space for a sorted copy of the vector.
-	sorted.resize(added.size());
+	sortedX.resize(added.size());
+	sortedY.resize(added.size());
+	sortedIndex.resize(added.size());
 
 	// Now, perform a radix sort.
 	for(const Entry &entry : added)
@@ -128,7 +234,10 @@ void CollisionSet::Finish()
 		auto gy = entry.y & WRAP_MASK;
 		auto index = gy * CELLS + gx + 1;
 
-		sorted[counts[index]++] = entry;
+		const unsigned i = counts[index]++;
+		sortedX[i] = entry.x;
+		sortedY[i] = entry.y;
+		sortedIndex[i] = entry.seenIndex;
 	}
 	// Now, counts[index] is where a certain bin begins.
 }
@@ -152,65 +261,430 @@ void CollisionSet::Line(const Projectile &projectile, vector<Collision> &result)
 
 // Get all possible collisions along a line. Collisions are not necessarily sorted by
 // distance.
-void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &lineResult,
+void CollisionSet::Line(const Point &from, const Point &uncappedTo, vector<Collision> &lineResult,
 		const Government *pGov, const Body *target) const
 {
-	const int x = from.X();
-	const int y = from.Y();
-	const int endX = to.X();
-	const int endY = to.Y();
-
-	// Figure out which grid cell the line starts and ends in.
-	int gx = x >> SHIFT;
-	int gy = y >> SHIFT;
-	const int endGX = endX >> SHIFT;
-	const int endGY = endY >> SHIFT;
+	const Point to = CapLength(from, uncappedTo);
 
 	// Special case, very common: the projectile is contained in one grid cell.
-	// In this case, all the complicated code below can be skipped.
-	if(gx == endGX && gy == endGY)
+	// In this case, no object can be encountered twice.
+	const bool isSingleCell = (static_cast<int>(from.X()) >> SHIFT) == (static_cast<int>(to.X()) >> SHIFT)
+		&& (static_cast<int>(from.Y()) >> SHIFT) == (static_cast<int>(to.Y()) >> SHIFT);
+	if(!isSingleCell)
+	{
+		seen.clear();
+		seen.resize(all.size());
+	}
+
+	uint64_t visited = 0;
+	ForEachCell(from, to, [&](int gx, int gy)
 	{
+		++visited;
 		// Examine all objects in the current grid cell.
 		const auto index = (gy & WRAP_MASK) * CELLS + (gx & WRAP_MASK);
-		vector<Entry>::const_iterator it = sorted.begin() + counts[index];
-		vector<Entry>::const_iterator end = sorted.begin() + counts[index + 1];
-		for( ; it != end; ++it)
+		for(unsigned i = counts[index]; i < counts[index + 1]; ++i)
 		{
 			// Skip objects that were put in this same grid cell only because
 			// of the cell coordinates wrapping around.
-			if(it->x != gx || it->y != gy)
+			if(sortedX[i] != gx || sortedY[i] != gy)
 				continue;
 
+			const unsigned seenIndex = sortedIndex[i];
+			if(!isSingleCell)
+			{
+				if(seen[seenIndex])
+					continue;
+				seen[seenIndex] = true;
+			}
+
 			// Check if this projectile can hit this object. If either the
 			// projectile or the object has no government, it will always hit.
-			const Government *iGov = it->body->GetGovernment();
-			if(it->body != target && iGov && pGov && !iGov->IsEnemy(pGov))
+			Body *body = all[seenIndex];
+			const Government *iGov = body->GetGovernment();
+			if(body != target && iGov && pGov && !iGov->IsEnemy(pGov))
 				continue;
 
-			const Mask &mask = it->body->GetMask(step);
-			Point offset = from - it->body->Position();
-			const double range = mask.Collide(offset, to - from, it->body->Facing());
+			Point offset = from - body->Position();
+			const double range = masks[seenIndex]->Collide(offset, to - from, body->Facing());
 
 			if(range < 1.)
-				lineResult.emplace_back(it->body, collisionType, range);
+				lineResult.emplace_back(body, collisionType, range);
 		}
+	});
+	cellsVisited.fetch_add(visited, memory_order_relaxed);
+}
+
+
 
+// Get all possible collisions for every one of the given projectiles at once.
+// Afterwards, the collisions of projectiles[i] are stored in the result from
+// index offsets[i] up to offsets[i + 1]. Collisions are not necessarily sorted
+// by distance.
+void CollisionSet::Lines(const vector<const Projectile *> &projectiles, vector<Collision> &result,
+	vector<unsigned> &offsets) const
+{
+	result.clear();
+	offsets.assign(projectiles.size() + 1, 0u);
+	if(projectiles.empty() || all.empty())
 		return;
+
+	// Gather everything the queries need to know about each line and each object,
+	// so that the loops below do not need to look at the projectiles or bodies.
+	batchLines.clear();
+	for(const Projectile *projectile : projectiles)
+	{
+		if(!projectile)
+		{
+			batchLines.push_back({Point(), Point(), nullptr, nullptr});
+			continue;
+		}
+		const Point &from = projectile->Position();
+		const Point to = CapLength(from, from + projectile->Velocity());
+		batchLines.push_back({from, to - from, projectile->GetGovernment(), projectile->Target()});
 	}
+	objectGovernments.resize(all.size());
+	for(size_t i = 0; i < all.size(); ++i)
+		objectGovernments[i] = all[i]->GetGovernment();
+
+	// Find every grid cell that each line passes through, and sort those visits
+	// by cell in the same way that the objects are sorted.
+	visits.clear();
+	visitCounts.assign(CELLS * CELLS + 2u, 0u);
+	for(unsigned line = 0; line < batchLines.size(); ++line)
+	{
+		if(!projectiles[line])
+			continue;
+		const BatchLine &batchLine = batchLines[line];
+		ForEachCell(batchLine.from, batchLine.from + batchLine.velocity, [&](int gx, int gy)
+		{
+			visits.push_back({gx, gy, line});
+			++visitCounts[(gy & WRAP_MASK) * CELLS + (gx & WRAP_MASK) + 2];
+		});
+	}
+	cellsVisited.fetch_add(visits.size(), memory_order_relaxed);
+	partial_sum(visitCounts.begin(), visitCounts.end(), visitCounts.begin());
+	sortedVisits.resize(visits.size());
+	for(const CellVisit &visit : visits)
+		sortedVisits[visitCounts[(visit.y & WRAP_MASK) * CELLS + (visit.x & WRAP_MASK) + 1]++] = visit;
+
+	// The scratch space belongs to this thread, so the worker threads must be
+	// given references to it rather than using their own.
+	const vector<BatchLine> &lines = batchLines;
+	const vector<const Government *> &governments = objectGovernments;
+	const vector<CellVisit> &cellVisits = sortedVisits;
+	const vector<unsigned> &cellVisitCounts = visitCounts;
+	vector<vector<Candidate>> &found = chunkCandidates;
+	vector<Candidate> &possible = candidates;
+	vector<double> &ranges = candidateRanges;
+
+	// Each cell can now be checked independently of the others. Find every object
+	// that each line might hit, based only on the grid and the governments.
+	const size_t cellCount = CELLS * CELLS;
+	found.resize((cellCount + CELL_CHUNK_SIZE - 1) / CELL_CHUNK_SIZE);
+	TaskQueue::ParallelFor(0, cellCount, CELL_CHUNK_SIZE, [&](size_t begin, size_t end)
+	{
+		vector<Candidate> &chunk = found[begin / CELL_CHUNK_SIZE];
+		chunk.clear();
+		for(size_t index = begin; index < end; ++index)
+		{
+			const unsigned objectsBegin = counts[index];
+			const unsigned objectsEnd = counts[index + 1];
+			if(objectsBegin == objectsEnd)
+				continue;
 
-	const Point pVelocity = (to - from);
-	if(pVelocity.Length() > MAX_VELOCITY)
+			for(unsigned v = cellVisitCounts[index]; v < cellVisitCounts[index + 1]; ++v)
+			{
+				const CellVisit &visit = cellVisits[v];
+				const BatchLine &line = lines[visit.line];
+				for(unsigned i = objectsBegin; i < objectsEnd; ++i)
+				{
+					// Skip objects that were put in this same grid cell only because
+					// of the cell coordinates wrapping around.
+					if(sortedX[i] != visit.x || sortedY[i] != visit.y)
+						continue;
+
+					// Check if this projectile can hit this object. If either the
+					// projectile or the object has no government, it will always hit.
+					const unsigned object = sortedIndex[i];
+					const Government *iGov = governments[object];
+					if(all[object] != line.target && iGov && line.gov && !iGov->IsEnemy(line.gov))
+						continue;
+
+					chunk.push_back({visit.line, object});
+				}
+			}
+		}
+	});
+
+	// A line that passes through several cells may have found the same object
+	// more than once.
+	possible.clear();
+	for(const vector<Candidate> &chunk : found)
+		possible.insert(possible.end(), chunk.begin(), chunk.end());
+	sort(possible.begin(), possible.end());
+	possible.erase(unique(possible.begin(), possible.end()), possible.end());
+
+	// Check each possible collision against the object's mask.
+	ranges.resize(possible.size());
+	TaskQueue::ParallelFor(0, possible.size(), CANDIDATE_CHUNK_SIZE, [&](size_t begin, size_t end)
 	{
-		// Cap projectile velocity to prevent integer overflows.
-		if(!warned)
+		for(size_t i = begin; i < end; ++i)
 		{
-			Logger::Log("A projectile exceeded the maximum allowed velocity (" + to_string(MAX_VELOCITY) + ").",
-				Logger::Level::WARNING);
-			warned = true;
+			const Candidate &candidate = possible[i];
+			const BatchLine &line = lines[candidate.line];
+			const Body &body = *all[candidate.object];
+			ranges[i] = masks[candidate.object]->Collide(line.from - body.Position(), line.velocity, body.Facing());
+		}
+	});
+
+	// The candidates are sorted by line, so the collisions will be too.
+	for(size_t i = 0; i < possible.size(); ++i)
+		if(ranges[i] < 1.)
+		{
+			result.emplace_back(all[possible[i].object], collisionType, ranges[i]);
+			++offsets[possible[i].line + 1];
 		}
-		Point newEnd = from + pVelocity.Unit() * USED_MAX_VELOCITY;
+	partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+}
+
+
+
+// Get all objects within the given range of the given point.
+void CollisionSet::Circle(const Point &center, double radius, vector<Body *> &result) const
+{
+	Ring(center, 0., radius, result);
+}
+
+
+
+// Get all objects touching a ring with a given inner and outer range
+// centered at the given point.
+void CollisionSet::Ring(const Point &center, double inner, double outer, vector<Body *> &circleResult) const
+{
+	// Calculate the range of (x, y) grid coordinates this ring covers.
+	const int minX = static_cast<int>(center.X() - outer) >> SHIFT;
+	const int minY = static_cast<int>(center.Y() - outer) >> SHIFT;
+	const int maxX = static_cast<int>(center.X() + outer) >> SHIFT;
+	const int maxY = static_cast<int>(center.Y() + outer) >> SHIFT;
+	cellsVisited.fetch_add(static_cast<uint64_t>(maxX - minX + 1) * (maxY - minY + 1), memory_order_relaxed);
+
+	seen.clear();
+	seen.resize(all.size());
+
+	for(int y = minY; y <= maxY; ++y)
+	{
+		const auto gy = y & WRAP_MASK;
+		for(int x = minX; x <= maxX; ++x)
+		{
+			const auto gx = x & WRAP_MASK;
+			const auto index = gy * CELLS + gx;
+			for(unsigned i = counts[index]; i < counts[index + 1]; ++i)
+			{
+				// Skip objects that were put in this same grid cell only because
+				// of the cell coordinates wrapping around.
+				if(sortedX[i] != x || sortedY[i] != y)
+					continue;
+
+				const unsigned seenIndex = sortedIndex[i];
+				if(seen[seenIndex])
+					continue;
+				seen[seenIndex] = true;
+
+				Body *body = all[seenIndex];
+				Point offset = center - body->Position();
+				const double length = offset.Length();
+				if((length <= outer && length >= inner)
+					|| masks[seenIndex]->WithinRing(offset, body->Facing(), inner, outer))
+					circleResult.push_back(body);
+			}
+		}
+	}
+}
+
+
+
+// Get all objects whose centers are within the given range of the given point.
+// If a government is given, only include objects of governments that it is
+// hostile to (or, if hostile is false, that it is not hostile to).
+void CollisionSet::Nearby(const Point &center, double radius, vector<Body *> &result,
+	const Government *gov, bool hostile) const
+{
+	FindNearby(center, radius, gov, hostile);
+
+	// Report the objects in the order they were added, no matter which cells
+	// they were found in.
+	sort(nearest.begin(), nearest.end(),
+		[](const pair<double, unsigned> &a, const pair<double, unsigned> &b) { return a.second < b.second; });
+	for(const pair<double, unsigned> &it : nearest)
+		result.push_back(all[it.second]);
+}
+
+
+
+// Like Nearby(), but only get the given number of objects closest to the
+// point, sorted from nearest to farthest.
+void CollisionSet::Nearest(const Point &center, double radius, size_t count, vector<Body *> &result,
+	const Government *gov, bool hostile) const
+{
+	FindNearby(center, radius, gov, hostile);
+
+	// Objects at the same distance are sorted in the order they were added.
+	const size_t kept = min(count, nearest.size());
+	partial_sort(nearest.begin(), nearest.begin() + kept, nearest.end());
+	for(size_t i = 0; i < kept; ++i)
+		result.push_back(all[nearest[i].second]);
+}
+
+
+
+const vector<Body *> &CollisionSet::All() const
+{
+	return all;
+}
+
 
-		Line(from, newEnd, lineResult, pGov, target);
+
+// Get the statistics of the objects added since the last Clear(), and of
+// the queries made since then.
+CollisionSet::Statistics CollisionSet::GetStatistics() const
+{
+	Statistics result = statistics;
+	result.cellsVisited = cellsVisited.load(memory_order_relaxed);
+	return result;
+}
+
+
+
+unsigned CollisionSet::CellSize() const
+{
+	return CELL_SIZE;
+}
+
+
+
+unsigned CollisionSet::CellCount() const
+{
+	return CELLS;
+}
+
+
+
+// Set the size of the grid, rounding both numbers down to a power of two.
+void CollisionSet::SetGrid(unsigned cellSize, unsigned cellCount)
+{
+	// Right shift amount to convert from (x, y) location to grid (x, y).
+	SHIFT = 0u;
+	while(cellSize >>= 1u)
+		++SHIFT;
+	CELL_SIZE = (1u << SHIFT);
+	CELL_MASK = CELL_SIZE - 1u;
+
+	// Number of grid rows and columns.
+	CELLS = 1u;
+	while(cellCount >>= 1u)
+		CELLS <<= 1;
+	WRAP_MASK = CELLS - 1u;
+}
+
+
+
+// Choose a grid size for the recent number and size of the objects.
+void CollisionSet::Adapt()
+{
+	// Cells a few times wider than the objects keep most of them in only one
+	// or two cells, while a projectile's path still only passes through a few.
+	const unsigned cellSize = clamp(RoundUpToPowerOfTwo(4. * averageRadius), MIN_CELL_SIZE, MAX_CELL_SIZE);
+	// Having about twice as many slots in the grid as entries keeps objects that
+	// are far apart from sharing a slot because the grid wraps around, without
+	// making the queries that scan every slot needlessly slow.
+	const unsigned cellCount = clamp(RoundUpToPowerOfTwo(sqrt(2. * averageEntries)), MIN_CELL_COUNT, MAX_CELL_COUNT);
+	if(cellSize != CELL_SIZE || cellCount != CELLS)
+		SetGrid(cellSize, cellCount);
+}
+
+
+
+// Find the distance to and index of every object that Nearby() or Nearest()
+// should consider.
+void CollisionSet::FindNearby(const Point &center, double radius, const Government *gov, bool hostile) const
+{
+	nearest.clear();
+	const double radiusSquared = radius * radius;
+	auto check = [&](unsigned index) -> void
+	{
+		Body *body = all[index];
+		const Government *bodyGov = body->GetGovernment();
+		if(gov && (!bodyGov || gov->IsEnemy(bodyGov) != hostile))
+			return;
+		const double distanceSquared = center.DistanceSquared(body->Position());
+		if(distanceSquared <= radiusSquared)
+			nearest.emplace_back(distanceSquared, index);
+	};
+
+	// If the range covers the whole grid, every cell would be visited at least
+	// once, and it is faster to simply check every object.
+	if(!(radius < .5 * CELLS * CELL_SIZE))
+	{
+		for(unsigned i = 0; i < all.size(); ++i)
+			check(i);
+	}
+	else
+	{
+		const int minX = static_cast<int>(center.X() - radius) >> SHIFT;
+		const int minY = static_cast<int>(center.Y() - radius) >> SHIFT;
+		const int maxX = static_cast<int>(center.X() + radius) >> SHIFT;
+		const int maxY = static_cast<int>(center.Y() + radius) >> SHIFT;
+		cellsVisited.fetch_add(static_cast<uint64_t>(maxX - minX + 1) * (maxY - minY + 1), memory_order_relaxed);
+
+		seen.clear();
+		seen.resize(all.size());
+		for(int y = minY; y <= maxY; ++y)
+		{
+			const auto gy = y & WRAP_MASK;
+			for(int x = minX; x <= maxX; ++x)
+			{
+				const auto gx = x & WRAP_MASK;
+				const auto index = gy * CELLS + gx;
+				for(unsigned i = counts[index]; i < counts[index + 1]; ++i)
+				{
+					if(sortedX[i] != x || sortedY[i] != y)
+						continue;
+
+					const unsigned seenIndex = sortedIndex[i];
+					if(seen[seenIndex])
+						continue;
+					seen[seenIndex] = true;
+					check(seenIndex);
+				}
+			}
+		}
+	}
+}
+
+
+
+
+// Call the given function with the (x, y) coordinates of every grid cell that
+// the given line passes through, in order.
+template<class Callback>
+void CollisionSet::ForEachCell(const Point &from, const Point &to, Callback &&callback) const
+{
+	const int x = from.X();
+	const int y = from.Y();
+	const int endX = to.X();
+	const int endY = to.Y();
+
+	// Figure out which grid cell the line starts and ends in.
+	int gx = x >> SHIFT;
+	int gy = y >> SHIFT;
+	const int endGX = endX >> SHIFT;
+	const int endGY = endY >> SHIFT;
+
+	// Special case, very common: the line is contained in one grid cell.
+	// In this case, all the complicated code below can be skipped.
+	if(gx == endGX && gy == endGY)
+	{
+		callback(gx, gy);
 		return;
 	}
 
@@ -235,39 +709,9 @@ void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &l
 	if(stepY > 0)
 		ry = fullScale - ry;
 
-	seen.clear();
-	seen.resize(all.size());
-
 	while(true)
 	{
-		// Examine all objects in the current grid cell.
-		auto i = (gy & WRAP_MASK) * CELLS + (gx & WRAP_MASK);
-		vector<Entry>::const_iterator it = sorted.begin() + counts[i];
-		vector<Entry>::const_iterator end = sorted.begin() + counts[i + 1];
-		for( ; it != end; ++it)
-		{
-			// Skip objects that were put in this same grid cell only because
-			// of the cell coordinates wrapping around.
-			if(it->x != gx || it->y != gy)
-				continue;
-
-			if(seen[it->seenIndex])
-				continue;
-			seen[it->seenIndex] = true;
-
-			// Check if this projectile can hit this object. If either the
-			// projectile or the object has no government, it will always hit.
-			const Government *iGov = it->body->GetGovernment();
-			if(it->body != target && iGov && pGov && !iGov->IsEnemy(pGov))
-				continue;
-
-			const Mask &mask = it->body->GetMask(step);
-			Point offset = from - it->body->Position();
-			const double range = mask.Collide(offset, to - from, it->body->Facing());
-
-			if(range < 1.)
-				lineResult.emplace_back(it->body, collisionType, range);
-		}
+		callback(gx, gy);
 
 		// Check if we've reached the final grid cell.
 		if(gx == endGX && gy == endGY)
@@ -306,65 +750,3 @@ void CollisionSet::Line(const Point &from, const Point &to, vector<Collision> &l
 		}
 	}
 }
-
-
-
-// Get all objects within the given range of the given point.
-void CollisionSet::Circle(const Point &center, double radius, vector<Body *> &result) const
-{
-	Ring(center, 0., radius, result);
-}
-
-
-
-// Get all objects touching a ring with a given inner and outer range
-// centered at the given point.
-void CollisionSet::Ring(const Point &center, double inner, double outer, vector<Body *> &circleResult) const
-{
-	// Calculate the range of (x, y) grid coordinates this ring covers.
-	const int minX = static_cast<int>(center.X() - outer) >> SHIFT;
-	const int minY = static_cast<int>(center.Y() - outer) >> SHIFT;
-	const int maxX = static_cast<int>(center.X() + outer) >> SHIFT;
-	const int maxY = static_cast<int>(center.Y() + outer) >> SHIFT;
-
-	seen.clear();
-	seen.resize(all.size());
-
-	for(int y = minY; y <= maxY; ++y)
-	{
-		const auto gy = y & WRAP_MASK;
-		for(int x = minX; x <= maxX; ++x)
-		{
-			const auto gx = x & WRAP_MASK;
-			const auto index = gy * CELLS + gx;
-			vector<Entry>::const_iterator it = sorted.begin() + counts[index];
-			vector<Entry>::const_iterator end = sorted.begin() + counts[index + 1];
-
-			for( ; it != end; ++it)
-			{
-				// Skip objects that were put in this same grid cell only because
-				// of the cell coordinates wrapping around.
-				if(it->x != x || it->y != y)
-					continue;
-
-				if(seen[it->seenIndex])
-					continue;
-				seen[it->seenIndex] = true;
-
-				const Mask &mask = it->body->GetMask(step);
-				Point offset = center - it->body->Position();
-				const double length = offset.Length();
-				if((length <= outer && length >= inner)
-					|| mask.WithinRing(offset, it->body->Facing(), inner, outer))
-					circleResult.push_back(it->body);
-			}
-		}
-	}
-}
-
-
-
-const vector<Body *> &CollisionSet::All() const
-{
-	return all;
-}
@@ -18,10 +18,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Collision.h"
 #include "CollisionType.h"
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
 class Body;
 class Government;
+class Mask;
 class Point;
 class Projectile;
 
@@ -29,12 +32,35 @@ class Projectile;
 
 // A CollisionSet allows efficient collision detection by splitting space up
 // into a grid and keeping track of which objects are in each grid cell. A check
-// for collisions can then only examine objects in certain cells.
+// for collisions can then only examine objects in certain cells. Once it is
+// finished, a collision set can be queried from several threads at once.
 class CollisionSet {
+public:
+	// How crowded the grid was during the last step, for telling whether its
+	// size suits the objects in it.
+	class Statistics {
+	public:
+		// The number of objects, and the number of grid cells they were added to.
+		unsigned objects = 0;
+		unsigned entries = 0;
+		// The number of cells that held any objects, and the most that any one
+		// cell held. Cells that share a slot because the grid wraps around are
+		// counted as one.
+		unsigned occupiedCells = 0;
+		unsigned maxCellLoad = 0;
+		// The number of grid cells that queries looked at.
+		uint64_t cellsVisited = 0;
+	};
+
+
 public:
 	// Initialize a collision set. The cell size and cell count should both be
 	// powers of two; otherwise, they are rounded down to a power of two.
 	CollisionSet(unsigned cellSize, unsigned cellCount, CollisionType collisionType);
+	// Initialize a collision set that picks its own cell size and count, based
+	// on how many objects it has held recently and how big they were. The grid
+	// is only resized when Clear() is called.
+	explicit CollisionSet(CollisionType collisionType);
 
 	// Clear all objects in the set. Specify which engine step we are on, so we
 	// know what animation frame each object is on.
@@ -52,6 +78,12 @@ public:
 	// distance.
 	void Line(const Point &from, const Point &to, std::vector<Collision> &result,
 		const Government *pGov = nullptr, const Body *target = nullptr) const;
+	// Get all possible collisions for every one of the given projectiles at once.
+	// Afterwards, the collisions of projectiles[i] are stored in the result from
+	// index offsets[i] up to offsets[i + 1]. Null projectiles are skipped and have
+	// no collisions. Collisions are not necessarily sorted by distance.
+	void Lines(const std::vector<const Projectile *> &projectiles, std::vector<Collision> &result,
+		std::vector<unsigned> &offsets) const;
 
 	// Get all objects within the given range of the given point.
 	void Circle(const Point &center, double radius, std::vector<Body *> &result) const;
@@ -59,9 +91,39 @@ public:
 	// centered at the given point.
 	void Ring(const Point &center, double inner, double outer, std::vector<Body *> &result) const;
 
+	// Get all objects whose centers are within the given range of the given point.
+	// If a government is given, only include objects of governments that it is
+	// hostile to (or, if hostile is false, that it is not hostile to).
+	void Nearby(const Point &center, double radius, std::vector<Body *> &result,
+		const Government *gov = nullptr, bool hostile = true) const;
+	// Like Nearby(), but only get the given number of objects closest to the
+	// point, sorted from nearest to farthest.
+	void Nearest(const Point &center, double radius, size_t count, std::vector<Body *> &result,
+		const Government *gov = nullptr, bool hostile = true) const;
+
 	// Get all objects within this collision set.
 	const std::vector<Body *> &All() const;
 
+	// Get the statistics of the objects added since the last Clear(), and of
+	// the queries made since then.
+	Statistics GetStatistics() const;
+	unsigned CellSize() const;
+	unsigned CellCount() const;
+
+
+private:
+	// Set the size of the grid, rounding both numbers down to a power of two.
+	void SetGrid(unsigned cellSize, unsigned cellCount);
+	// Choose a grid size for the recent number and size of the objects.
+	void Adapt();
+	// Find the distance to and index of every object that Nearby() or Nearest()
+	// should consider.
+	void FindNearby(const Point &center, double radius, const Government *gov, bool hostile) const;
+	// Call the given function with the (x, y) coordinates of every grid cell that
+	// the given line passes through, in order.
+	template<class Callback>
+	void ForEachCell(const Point &from, const Point &to, Callback &&callback) const;
+
 
 private:
 	class Entry {
@@ -92,10 +154,27 @@ private:
 	// The current game engine step.
 	int step;
 
+	// Whether the grid size is chosen automatically, and the averages of the
+	// last few steps that it is chosen from.
+	bool isAdaptive = false;
+	double averageEntries = 0.;
+	double averageRadius = 0.;
+	double totalRadius = 0.;
+	Statistics statistics;
+	mutable std::atomic<uint64_t> cellsVisited = 0;
+
 	// Vectors to store the objects in the collision set.
 	std::vector<Body *> all;
+	// The mask of each object for the current step. Looking these up in advance
+	// means that queries never need to update an object's animation frame.
+	std::vector<const Mask *> masks;
 	std::vector<Entry> added;
-	std::vector<Entry> sorted;
+	// After Finish(), the grid coordinates and the index in the "all" vector of
+	// every entry, sorted by grid cell. These are kept in separate arrays so that
+	// scanning a cell does not need to look at the objects themselves.
+	std::vector<int> sortedX;
+	std::vector<int> sortedY;
+	std::vector<unsigned> sortedIndex;
 	// After Finish(), counts[index] is where a certain bin begins.
 	std::vector<unsigned> counts;
 };
@@ -40,6 +40,49 @@ namespace {
 	map<int, int> keycodeCount;
 	// Need a uint64_t 1 to generate Commands.
 	const uint64_t ONE = 1;
+
+	// The names of the commands that can be given in an input file.
+	const map<string, Command> &CommandNames()
+	{
+		static const map<string, Command> names = {
+			{"none", Command::NONE},
+			{"menu", Command::MENU},
+			{"forward", Command::FORWARD},
+			{"left", Command::LEFT},
+			{"right", Command::RIGHT},
+			{"back", Command::BACK},
+			{"primary", Command::PRIMARY},
+			{"secondary", Command::SECONDARY},
+			{"select", Command::SELECT},
+			{"land", Command::LAND},
+			{"board", Command::BOARD},
+			{"hail", Command::HAIL},
+			{"scan", Command::SCAN},
+			{"jump", Command::JUMP},
+			{"mouse turning hold", Command::MOUSE_TURNING_HOLD},
+			{"aim turret hold", Command::AIM_TURRET_HOLD},
+			{"fleet jump", Command::FLEET_JUMP},
+			{"target", Command::TARGET},
+			{"nearest", Command::NEAREST},
+			{"deploy", Command::DEPLOY},
+			{"afterburner", Command::AFTERBURNER},
+			{"cloak", Command::CLOAK},
+			{"map", Command::MAP},
+			{"info", Command::INFO},
+			{"fullscreen", Command::FULLSCREEN},
+			{"fastforward", Command::FASTFORWARD},
+			{"fight", Command::FIGHT},
+			{"hold fire", Command::HOLD_FIRE},
+			{"gather", Command::GATHER},
+			{"hold", Command::HOLD_POSITION},
+			{"ammo", Command::AMMO},
+			{"nearest asteroid", Command::NEAREST_ASTEROID},
+			{"wait", Command::WAIT},
+			{"stop", Command::STOP},
+			{"shift", Command::SHIFT}
+		};
+		return names;
+	}
 }
 
 
@@ -262,46 +305,9 @@ bool Command::HasConflict() const
 // Load this command from an input file (for testing or scripted missions).
 void Command::Load(const DataNode &node)
 {
+	const map<string, Command> &lookup = CommandNames();
 	for(int i = 1; i < node.Size(); ++i)
 	{
-		static const map<string, Command> lookup = {
-			{"none", Command::NONE},
-			{"menu", Command::MENU},
-			{"forward", Command::FORWARD},
-			{"left", Command::LEFT},
-			{"right", Command::RIGHT},
-			{"back", Command::BACK},
-			{"primary", Command::PRIMARY},
-			{"secondary", Command::SECONDARY},
-			{"select", Command::SELECT},
-			{"land", Command::LAND},
-			{"board", Command::BOARD},
-			{"hail", Command::HAIL},
-			{"scan", Command::SCAN},
-			{"jump", Command::JUMP},
-			{"mouse turning hold", Command::MOUSE_TURNING_HOLD},
-			{"aim turret hold", Command::AIM_TURRET_HOLD},
-			{"fleet jump", Command::FLEET_JUMP},
-			{"target", Command::TARGET},
-			{"nearest", Command::NEAREST},
-			{"deploy", Command::DEPLOY},
-			{"afterburner", Command::AFTERBURNER},
-			{"cloak", Command::CLOAK},
-			{"map", Command::MAP},
-			{"info", Command::INFO},
-			{"fullscreen", Command::FULLSCREEN},
-			{"fastforward", Command::FASTFORWARD},
-			{"fight", Command::FIGHT},
-			{"hold fire", Command::HOLD_FIRE},
-			{"gather", Command::GATHER},
-			{"hold", Command::HOLD_POSITION},
-			{"ammo", Command::AMMO},
-			{"nearest asteroid", Command::NEAREST_ASTEROID},
-			{"wait", Command::WAIT},
-			{"stop", Command::STOP},
-			{"shift", Command::SHIFT}
-		};
-
 		auto it = lookup.find(node.Token(i));
 		if(it != lookup.end())
 			Set(it->second);
@@ -312,6 +318,16 @@ void Command::Load(const DataNode &node)
 
 
 
+// Save this command to an input file, in the same form that Load() reads.
+void Command::Save(DataWriter &out) const
+{
+	for(const auto &[name, command] : CommandNames())
+		if(Has(command))
+			out.WriteToken(name);
+}
+
+
+
 // Reset this to an empty command.
 void Command::Clear()
 {
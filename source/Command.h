@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <string>
 
 class DataNode;
+class DataWriter;
 
 
 
@@ -116,6 +117,8 @@ public:
 
 	// Load this command from an input file (for testing or scripted missions).
 	void Load(const DataNode &node);
+	// Save this command to an input file, in the same form that Load() reads.
+	void Save(DataWriter &out) const;
 
 	// Reset this to an empty command.
 	void Clear();
@@ -15,9 +15,20 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "ConditionEntry.h"
 
+#include "ConditionsStore.h"
+
+#include <atomic>
 
 using namespace std;
 
+namespace {
+	// The number of times that any condition has been set, or given a provider.
+	atomic<uint64_t> changes = 0;
+	// The number of frames begun. This starts at 1, so that no cache is current
+	// before it has been filled.
+	atomic<uint64_t> frames = 1;
+}
+
 
 
 ConditionEntry::ConditionEntry(const string &name)
@@ -50,11 +61,11 @@ ConditionEntry::operator int64_t() const
 {
 	// Prefixed provider; use the other function to get the value.
 	if(providingEntry)
-		return providingEntry->getFunction(*this);
+		return providingEntry->isCached ? GetCached(providingEntry->getFunction) : providingEntry->getFunction(*this);
 
 	// Named provider; use the local getFunction to get the value.
 	if(getFunction)
-		return getFunction(*this);
+		return isCached ? GetCached(getFunction) : getFunction(*this);
 
 	// This is not a provider, just return the value.
 	return value;
@@ -129,6 +140,9 @@ void ConditionEntry::ProvidePrefixed(function<int64_t(const ConditionEntry &)> g
 {
 	this->getFunction = std::move(getFunction);
 	this->providingEntry = this;
+	if(store)
+		store->AddPrefixProvider(*this);
+	++changes;
 }
 
 
@@ -146,6 +160,7 @@ void ConditionEntry::ProvideNamed(function<int64_t(const ConditionEntry &)> getF
 {
 	this->getFunction = std::move(getFunction);
 	this->providingEntry = nullptr;
+	++changes;
 }
 
 
@@ -159,8 +174,71 @@ void ConditionEntry::ProvideNamed(function<int64_t(const ConditionEntry &)> getF
 
 
 
+// Reuse the value that the provider of this entry gives until the next frame, or until any condition is set.
+void ConditionEntry::CacheUntilNextFrame()
+{
+	isCached = true;
+	cachedFrame = 0;
+}
+
+
+
 void ConditionEntry::NotifyUpdate(uint64_t value)
 {
-	// Subscribing is not implemented yet.
-	return;
+	// Rather than calling back to subscribers, the change is recorded so that
+	// anything that depends on this condition can check whether it changed.
+	++version;
+	++changes;
+}
+
+
+
+bool ConditionEntry::IsDerived() const
+{
+	return getFunction || providingEntry;
+}
+
+
+
+uint64_t ConditionEntry::Version() const
+{
+	return version;
+}
+
+
+
+uint64_t ConditionEntry::Changes()
+{
+	return changes.load(memory_order_relaxed);
+}
+
+
+
+// Begin a new frame, in which the values of cached providers are computed again.
+void ConditionEntry::NextFrame()
+{
+	frames.fetch_add(1, memory_order_relaxed);
+}
+
+
+
+void ConditionEntry::CountChange()
+{
+	++changes;
+}
+
+
+
+// Get the value of a derived condition, from the cache if it is still current.
+int64_t ConditionEntry::GetCached(const function<int64_t(const ConditionEntry &)> &get) const
+{
+	const uint64_t frame = frames.load(memory_order_relaxed);
+	const uint64_t changed = changes.load(memory_order_relaxed);
+	if(cachedFrame != frame || cachedChanges != changed)
+	{
+		cachedValue = get(*this);
+		cachedFrame = frame;
+		cachedChanges = changed;
+	}
+	return cachedValue;
 }
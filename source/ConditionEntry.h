@@ -67,9 +67,34 @@ public:
 	void ProvideNamed(std::function<int64_t(const ConditionEntry &)> getFunction,
 		std::function<void(ConditionEntry &, int64_t)> setFunction);
 
+	/// Reuse the value that the provider of this entry gives until the next frame, or until any condition is set.
+	/// This is for providers that are slow to compute, e.g. because they look at every ship in the fleet, but
+	/// that are checked many times in a frame. Prefixed conditions that are read without being added to the
+	/// store are computed every time.
+	void CacheUntilNextFrame();
+
 	/// Notify all subscribed listeners that the value of the condition changed.
 	void NotifyUpdate(uint64_t value);
 
+	/// Check if this condition's value comes from a provider. The value of such a condition can change without it
+	/// being set, so it cannot be known whether a result that depends on it is still up to date.
+	bool IsDerived() const;
+	/// A number that changes whenever this condition is set.
+	uint64_t Version() const;
+	/// A number that changes whenever any condition is set or gets a provider, or the contents of a store are
+	/// replaced, so that results that depend only on conditions can be reused for as long as it stays the same.
+	static uint64_t Changes();
+	/// Begin a new frame, in which the values of cached providers are computed again.
+	static void NextFrame();
+
+
+private:
+	/// Record a change that affects many conditions at once.
+	static void CountChange();
+
+	/// Get the value of a derived condition, from the cache if it is still current.
+	int64_t GetCached(const std::function<int64_t(const ConditionEntry &)> &get) const;
+
 
 private:
 	std::string name; ///< Name of this entry, set during construction of the entry object.
@@ -82,4 +107,17 @@ private:
 
 	/// conditionEntry that provides the prefixed condition, or nullptr if this is a regular or named condition.
 	const ConditionEntry *providingEntry = nullptr;
+	/// The store that this entry is part of, if any, which must know about prefixed providers.
+	ConditionsStore *store = nullptr;
+
+	/// The number of times that this condition has been set.
+	uint64_t version = 0;
+
+	/// Whether the provider of this entry wants its values cached.
+	bool isCached = false;
+	/// The last value the provider gave for this entry, and when it was computed. Like the providers themselves,
+	/// this is only used from the main thread.
+	mutable int64_t cachedValue = 0;
+	mutable uint64_t cachedFrame = 0;
+	mutable uint64_t cachedChanges = 0;
 };
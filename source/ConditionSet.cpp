@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "ConditionSet.h"
 
+#include "ConditionEntry.h"
 #include "ConditionsStore.h"
 #include "DataNode.h"
 #include "DataWriter.h"
@@ -187,6 +188,7 @@ ConditionSet &ConditionSet::operator=(const ConditionSet &&other) noexcept
 	conditionName = std::move(other.conditionName);
 	children = std::move(other.children);
 	conditions = other.conditions;
+	program.clear();
 
 	return *this;
 }
@@ -210,6 +212,7 @@ ConditionSet &ConditionSet::operator=(const ConditionSet &other)
 	conditionName = other.conditionName;
 	children = other.children;
 	conditions = other.conditions;
+	program.clear();
 
 	return *this;
 }
@@ -222,6 +225,7 @@ void ConditionSet::Load(const DataNode &node, const ConditionsStore *conditions)
 	if(!conditions)
 		throw runtime_error("Unable to Load ConditionSet without a pointer to a ConditionsStore!");
 	this->conditions = conditions;
+	program.clear();
 
 	// The top-node is always an 'and' node, without the keyword.
 	expressionOperator = ExpressionOp::AND;
@@ -350,6 +354,7 @@ void ConditionSet::MakeNever()
 	children.clear();
 	expressionOperator = ExpressionOp::LIT;
 	literal = 0;
+	program.clear();
 }
 
 
@@ -382,61 +387,121 @@ bool ConditionSet::Test() const
 
 
 
+bool ConditionSet::HasStableResult() const
+{
+	return hasResult;
+}
+
+
+
 int64_t ConditionSet::Evaluate() const
 {
-	switch(expressionOperator)
+	if(program.empty())
 	{
-		case ExpressionOp::VAR:
+		slots.clear();
+		Compile(program, slots);
+		resolvedGeneration = 0;
+		hasResult = false;
+
+		// Find the deepest that the stack can get. Jumps only skip ahead, so
+		// the path that does not take any of them is the deepest one.
+		size_t depth = 0;
+		stackSize = 0;
+		for(const Instruction &instruction : program)
 		{
-			if(!conditions)
-				throw runtime_error("Unable to Evaluate ExpressionOp::VAR with condition name \"" + conditionName
-					+ "\" in ConditionSet without a pointer to a ConditionsStore!");
-			return conditions->Get(conditionName);
+			if(instruction.code == Instruction::Code::PUSH_LITERAL
+					|| instruction.code == Instruction::Code::PUSH_CONDITION)
+				stackSize = max(stackSize, ++depth);
+			else if(instruction.code != Instruction::Code::JUMP_IF_ZERO)
+				--depth;
 		}
-		case ExpressionOp::LIT:
-			return literal;
-		case ExpressionOp::AND:
-		{
-			// An empty AND section returns true.
-			if(children.empty())
-				return 1;
+	}
 
-			int64_t result = 0;
-			for(const ConditionSet &child : children)
+	// Conditions only have to be looked up again if entries were added to the store.
+	if(!slots.empty() && resolvedGeneration != conditions->Generation())
+	{
+		for(Slot &slot : slots)
+			slot.entry = conditions->Resolve(slot.name);
+		resolvedGeneration = conditions->Generation();
+		hasResult = false;
+	}
+
+	// If none of the conditions that this expression uses have been set since it
+	// was last evaluated, and none of them come from providers, the result is the same.
+	const uint64_t changes = ConditionEntry::Changes();
+	if(hasResult && changes != resultChanges)
+	{
+		for(const Slot &slot : slots)
+			if(slot.entry && (slot.entry->IsDerived() || slot.entry->Version() != slot.version))
 			{
-				int64_t childResult = child.Evaluate();
-				if(!childResult)
-					return 0;
-				// Assign the first non-zero result to the result variable.
-				if(!result)
-					result = childResult;
+				hasResult = false;
+				break;
 			}
-			return result;
-		}
-		case ExpressionOp::OR:
-			for(const ConditionSet &child : children)
+		resultChanges = changes;
+	}
+	if(hasResult)
+		return result;
+
+	// Most expressions are shallow enough for the stack to fit in a small buffer.
+	int64_t buffer[16];
+	vector<int64_t> heap;
+	int64_t *stack = buffer;
+	if(stackSize > size(buffer))
+	{
+		heap.resize(stackSize);
+		stack = heap.data();
+	}
+
+	int64_t *top = stack - 1;
+	for(size_t i = 0; i < program.size(); ++i)
+	{
+		const Instruction &instruction = program[i];
+		switch(instruction.code)
+		{
+			case Instruction::Code::PUSH_LITERAL:
+				*++top = instruction.value;
+				break;
+			case Instruction::Code::PUSH_CONDITION:
 			{
-				int64_t childResult = child.Evaluate();
-				// Return the first non-zero result.
-				if(childResult)
-					return childResult;
+				const Slot &slot = slots[instruction.value];
+				*++top = conditions->Get(slot.entry, slot.name);
+				break;
 			}
-			return 0;
-		default:
-			break;
+			case Instruction::Code::APPLY:
+				--top;
+				*top = instruction.function(top[0], top[1]);
+				break;
+			case Instruction::Code::JUMP_IF_ZERO:
+				if(!*top)
+					i = instruction.value - 1;
+				break;
+			case Instruction::Code::JUMP_IF_NONZERO:
+				if(*top)
+					i = instruction.value - 1;
+				else
+					--top;
+				break;
+			case Instruction::Code::AND_NEXT:
+				if(!*top--)
+				{
+					*top = 0;
+					i = instruction.value - 1;
+				}
+				break;
+		}
 	}
 
-	// If we have an accumulator function and children, then let's use the accumulator on the children.
-	// MAX and MIN are also handled by the accumulator.
-	BinFun accumulatorOp = Op(expressionOperator);
-	if(accumulatorOp != nullptr && !children.empty())
-		return accumulate(next(children.begin()), children.end(), children[0].Evaluate(),
-			[&accumulatorOp](int64_t accumulated, const ConditionSet &b) -> int64_t {
-				return accumulatorOp(accumulated, b.Evaluate());
-		});
-
-	// If we don't have an accumulator function, or no children, then return the default value.
-	return 0;
+	// Remember the result, unless it depends on a provided condition that could change at any time.
+	result = *top;
+	hasResult = true;
+	resultChanges = changes;
+	for(Slot &slot : slots)
+		if(slot.entry)
+		{
+			hasResult &= !slot.entry->IsDerived();
+			slot.version = slot.entry->Version();
+		}
+	return result;
 }
 
 
@@ -456,6 +521,74 @@ set<string> ConditionSet::RelevantConditions() const
 
 
 
+void ConditionSet::Compile(vector<Instruction> &program, vector<Slot> &slots) const
+{
+	switch(expressionOperator)
+	{
+		case ExpressionOp::VAR:
+		{
+			if(!conditions)
+				throw runtime_error("Unable to Evaluate ExpressionOp::VAR with condition name \"" + conditionName
+					+ "\" in ConditionSet without a pointer to a ConditionsStore!");
+			auto it = find_if(slots.begin(), slots.end(), [this](const Slot &slot) { return slot.name == conditionName; });
+			if(it == slots.end())
+				it = slots.insert(slots.end(), Slot{conditionName});
+			program.push_back({Instruction::Code::PUSH_CONDITION, it - slots.begin()});
+			return;
+		}
+		case ExpressionOp::LIT:
+			program.push_back({Instruction::Code::PUSH_LITERAL, literal});
+			return;
+		case ExpressionOp::AND:
+		case ExpressionOp::OR:
+		{
+			const bool isAnd = expressionOperator == ExpressionOp::AND;
+			// An empty AND section returns true, and an empty OR section false.
+			if(children.empty())
+			{
+				program.push_back({Instruction::Code::PUSH_LITERAL, isAnd});
+				return;
+			}
+
+			// AND returns 0 at the first child that is 0, and the value of the first
+			// child otherwise. OR returns the value of the first child that is not 0.
+			vector<size_t> jumps;
+			for(size_t i = 0; i < children.size(); ++i)
+			{
+				children[i].Compile(program, slots);
+				if(!isAnd && i + 1 == children.size())
+					break;
+				jumps.push_back(program.size());
+				program.push_back({!isAnd ? Instruction::Code::JUMP_IF_NONZERO
+					: i ? Instruction::Code::AND_NEXT : Instruction::Code::JUMP_IF_ZERO});
+			}
+			for(size_t jump : jumps)
+				program[jump].value = program.size();
+			return;
+		}
+		default:
+			break;
+	}
+
+	// If we have an accumulator function and children, then let's use the accumulator on the children.
+	// MAX and MIN are also handled by the accumulator.
+	BinFun accumulatorOp = Op(expressionOperator);
+	if(accumulatorOp == nullptr || children.empty())
+	{
+		// If we don't have an accumulator function, or no children, then return the default value.
+		program.push_back({Instruction::Code::PUSH_LITERAL, 0});
+		return;
+	}
+	children[0].Compile(program, slots);
+	for(auto it = next(children.begin()); it != children.end(); ++it)
+	{
+		it->Compile(program, slots);
+		program.push_back({Instruction::Code::APPLY, 0, accumulatorOp});
+	}
+}
+
+
+
 bool ConditionSet::ParseFromStart(const DataNode &node)
 {
 	if(!conditions)
@@ -538,6 +671,7 @@ bool ConditionSet::ParseNode(const DataNode &node, int &tokenNr)
 {
 	if(!conditions)
 		throw runtime_error("Unable to ParseNode(indexed) for a ConditionSet without a pointer to a ConditionsStore!");
+	program.clear();
 
 	// Nodes beyond this point should not have children.
 	if(node.HasChildren())
@@ -558,6 +692,7 @@ bool ConditionSet::ParseNode(const DataNode &node, int &tokenNr)
 /// Optimize this node, this optimization also removes intermediate sections that were used for tracking brackets.
 bool ConditionSet::Optimize(const DataNode &node)
 {
+	program.clear();
 	bool returnValue = true;
 	// First optimize all the child nodes below.
 	for(ConditionSet &child : children)
@@ -579,9 +714,6 @@ bool ConditionSet::Optimize(const DataNode &node)
 		case ExpressionOp::GE:
 		case ExpressionOp::LT:
 		case ExpressionOp::GT:
-			// TODO: Optimize boolean equality operators.
-			break;
-
 		case ExpressionOp::ADD:
 		case ExpressionOp::SUB:
 		case ExpressionOp::MUL:
@@ -589,7 +721,18 @@ bool ConditionSet::Optimize(const DataNode &node)
 		case ExpressionOp::MOD:
 		case ExpressionOp::MAX:
 		case ExpressionOp::MIN:
-			// TODO: Optimize arithmetic operators.
+			// If all the operands are literals, then the result is a literal as well.
+			if(!children.empty() && all_of(children.begin(), children.end(),
+					[](const ConditionSet &child) { return child.expressionOperator == ExpressionOp::LIT; }))
+			{
+				BinFun accumulatorOp = Op(expressionOperator);
+				int64_t result = children[0].literal;
+				for(auto it = next(children.begin()); it != children.end(); ++it)
+					result = accumulatorOp(result, it->literal);
+				children.clear();
+				expressionOperator = ExpressionOp::LIT;
+				literal = result;
+			}
 			break;
 
 		case ExpressionOp::LIT:
@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <string>
 #include <vector>
 
+class ConditionEntry;
 class ConditionsStore;
 class DataNode;
 class DataWriter;
@@ -104,6 +105,9 @@ public:
 
 	// Evaluate this expression into a numerical value. (The value can also be used as boolean.)
 	int64_t Evaluate() const;
+	// Check if the last result of Test() or Evaluate() will stay the same until a condition is
+	// set, because it does not depend on any condition that comes from a provider.
+	bool HasStableResult() const;
 
 	/// Parse the remainder of a node into this ConditionSet.
 	bool ParseNode(const DataNode &node, int &tokenNr);
@@ -115,6 +119,34 @@ public:
 	std::set<std::string> RelevantConditions() const;
 
 
+private:
+	/// One step of an expression that has been compiled for a stack machine.
+	class Instruction {
+	public:
+		enum class Code {
+			PUSH_LITERAL, ///< Push the value.
+			PUSH_CONDITION, ///< Push the condition in the slot with this index.
+			APPLY, ///< Replace the top two values with the result of the function.
+			JUMP_IF_ZERO, ///< Jump to the instruction at this index if the top value is 0.
+			JUMP_IF_NONZERO, ///< Jump if the top value is not 0, otherwise pop it.
+			AND_NEXT, ///< Pop the top value. If it was 0, replace the new top value with 0 and jump.
+		};
+
+		Code code;
+		int64_t value = 0;
+		int64_t (*function)(int64_t, int64_t) = nullptr;
+	};
+
+	/// A condition that a compiled expression uses, and the entry in the ConditionsStore that provides it.
+	class Slot {
+	public:
+		std::string name;
+		const ConditionEntry *entry = nullptr;
+		/// The version of the entry when the expression was last evaluated.
+		uint64_t version = 0;
+	};
+
+
 private:
 	/// Parse a node completely into this expression; all tokens on the line and all children if there are any.
 	bool ParseFromStart(const DataNode &node);
@@ -161,6 +193,9 @@ private:
 	/// @param node Node on which to report the failures (using node.PrintTrace()).
 	bool PushDownLast(const DataNode &node);
 
+	/// Flatten this expression into the given program, adding the conditions that it uses to the slots.
+	void Compile(std::vector<Instruction> &program, std::vector<Slot> &slots) const;
+
 	/// Handles a failure in parsing of lower-level nodes, for higher-level nodes;
 	/// - Clears the sub-expressions and sets the operator to INVALID.
 	bool FailParse();
@@ -191,6 +226,18 @@ private:
 	/// Nested sets of conditions to be tested.
 	std::vector<ConditionSet> children;
 
+	/// This expression compiled into a flat program, the first time that it is evaluated, so that evaluating it does
+	/// not need to recurse through the children or look up each condition by name.
+	mutable std::vector<Instruction> program;
+	mutable std::vector<Slot> slots;
+	mutable size_t stackSize = 0;
+	/// The generation of the ConditionsStore when the slots were last resolved to entries.
+	mutable uint64_t resolvedGeneration = 0;
+	/// The last result of evaluating this expression, which stays valid until one of its conditions is set.
+	mutable bool hasResult = false;
+	mutable int64_t result = 0;
+	mutable uint64_t resultChanges = 0;
+
 	// Let the assignment class call internal functions and parsers.
 	friend class ConditionAssignments;
 };
@@ -19,7 +19,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "DataWriter.h"
 #include "Logger.h"
+#include "MemoryProfile.h"
 
+#include <algorithm>
 #include <utility>
 
 using namespace std;
@@ -52,8 +54,22 @@ ConditionsStore::ConditionsStore(const map<string, int64_t> &initialConditions)
 
 
 
+ConditionsStore &ConditionsStore::operator=(ConditionsStore &&other) noexcept
+{
+	storage = std::move(other.storage);
+	other.storage.clear();
+	Reindex();
+	other.Reindex();
+	++generation;
+	++other.generation;
+	return *this;
+}
+
+
+
 void ConditionsStore::Load(const DataNode &node)
 {
+	MemoryProfile::Scope memoryScope(MemoryProfile::Tag::CONDITIONS);
 	for(const DataNode &child : node)
 	{
 		const string &key = child.Token(0);
@@ -94,8 +110,13 @@ void ConditionsStore::Save(DataWriter &out) const
 int64_t ConditionsStore::Get(const string &name) const
 {
 	// Look for a relevant entry, either the exact entry, or a prefixed provider.
-	const ConditionEntry *ce = GetEntry(name);
+	return Get(GetEntry(name), name);
+}
+
+
 
+int64_t ConditionsStore::Get(const ConditionEntry *ce, const string &name) const
+{
 	// If no entry is found, then we simply don't have any relevant data.
 	if(!ce)
 		return 0;
@@ -130,16 +151,18 @@ void ConditionsStore::Set(const string &name, int64_t value)
 ConditionEntry &ConditionsStore::operator[](const string &name)
 {
 	// Search for an exact match and return it if it exists.
-	auto it = storage.find(name);
-	if(it != storage.end())
-		return it->second;
+	auto found = index.find(name);
+	if(found != index.end())
+		return *found->second;
 
 	// Check for a prefix provider.
 	ConditionEntry *ceprov = GetEntry(name);
 
 	// Create the entry (name is used as key, and as ConditionEntry constructor argument.
-	auto emp = storage.emplace(make_pair(name, name));
-	it = emp.first;
+	auto it = storage.emplace(make_pair(name, name)).first;
+	index.emplace(it->first, &it->second);
+	it->second.store = this;
+	++generation;
 
 	// If a relevant prefix provider is found, then provision this entry with the provider.
 	if(ceprov != nullptr)
@@ -151,6 +174,20 @@ ConditionEntry &ConditionsStore::operator[](const string &name)
 
 
 
+const ConditionEntry *ConditionsStore::Resolve(const string &name) const
+{
+	return GetEntry(name);
+}
+
+
+
+uint64_t ConditionsStore::Generation() const
+{
+	return generation;
+}
+
+
+
 int64_t ConditionsStore::PrimariesSize() const
 {
 	int64_t result = 0;
@@ -176,24 +213,63 @@ ConditionEntry *ConditionsStore::GetEntry(const string &name)
 
 const ConditionEntry *ConditionsStore::GetEntry(const string &name) const
 {
-	if(storage.empty())
-		return nullptr;
+	// The entry is matching if we have an exact string match.
+	auto it = index.find(name);
+	if(it != index.end())
+		return it->second;
 
-	// Perform a single search for values, named providers, and prefixed providers.
-	auto it = storage.upper_bound(name);
-	if(it == storage.begin())
-		return nullptr;
+	// If we don't have an exact match, then look for the longest prefix-provider
+	// whose name the name starts with.
+	const ConditionEntry *ceProv = nullptr;
+	size_t node = 0;
+	for(char c : name)
+	{
+		const vector<pair<char, size_t>> &next = prefixes[node].next;
+		auto child = find_if(next.begin(), next.end(), [c](const pair<char, size_t> &link) { return link.first == c; });
+		if(child == next.end())
+			break;
+		node = child->second;
+		if(prefixes[node].provider)
+			ceProv = prefixes[node].provider;
+	}
+	return ceProv;
+}
 
-	--it;
-	// The entry is matching if we have an exact string match.
-	if(name == it->first)
-		return &(it->second);
 
-	// If we don't have an exact match, but we have a matching prefix-provider, then we return that one.
-	const ConditionEntry *ceProv = it->second.providingEntry;
-	if(ceProv && name.starts_with(ceProv->name))
-		return ceProv;
 
-	// And otherwise we don't have a match.
-	return nullptr;
+void ConditionsStore::AddPrefixProvider(const ConditionEntry &entry)
+{
+	size_t node = 0;
+	for(char c : entry.name)
+	{
+		vector<pair<char, size_t>> &next = prefixes[node].next;
+		auto child = find_if(next.begin(), next.end(), [c](const pair<char, size_t> &link) { return link.first == c; });
+		if(child != next.end())
+			node = child->second;
+		else
+		{
+			next.emplace_back(c, prefixes.size());
+			node = prefixes.size();
+			prefixes.emplace_back();
+		}
+	}
+	prefixes[node].provider = &entry;
+	++generation;
+}
+
+
+
+void ConditionsStore::Reindex()
+{
+	index.clear();
+	prefixes.assign(1, PrefixNode());
+	for(auto &[name, entry] : storage)
+	{
+		index.emplace(name, &entry);
+		entry.store = this;
+		if(entry.providingEntry == &entry)
+			AddPrefixProvider(entry);
+	}
+	// Every condition may now have a different value.
+	ConditionEntry::CountChange();
 }
@@ -17,10 +17,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "ConditionEntry.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <map>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -38,6 +43,8 @@ class DataWriter;
 // data types than int64_t (for example double, float or even complex
 // formulae).
 class ConditionsStore {
+	friend ConditionEntry;
+
 public:
 	// Constructors to initialize this class.
 	ConditionsStore() = default;
@@ -48,7 +55,7 @@ public:
 	ConditionsStore(const ConditionsStore &) = delete;
 	ConditionsStore &operator=(const ConditionsStore &) = delete;
 	ConditionsStore(ConditionsStore &&) = delete;
-	ConditionsStore &operator=(ConditionsStore &&) = default;
+	ConditionsStore &operator=(ConditionsStore &&other) noexcept;
 
 	// Serialization support for this class.
 	void Load(const DataNode &node);
@@ -67,6 +74,15 @@ public:
 	/// Direct access to a specific condition (using the ConditionEntry as proxy).
 	ConditionEntry &operator[](const std::string &name);
 
+	/// Find the entry that provides the given condition: its own entry, the prefixed provider that supplies it, or
+	/// nullptr if there is none. The result stays valid until the generation of this store changes.
+	const ConditionEntry *Resolve(const std::string &name) const;
+	/// Get the value of a condition, given the entry that Resolve() returned for it.
+	int64_t Get(const ConditionEntry *entry, const std::string &name) const;
+	/// A number that changes whenever entries are added to this store or it is replaced, so that any condition names
+	/// that were resolved to entries must be resolved again.
+	uint64_t Generation() const;
+
 	// Helper for testing; check how many primary conditions are registered.
 	int64_t PrimariesSize() const;
 
@@ -78,8 +94,31 @@ private:
 	ConditionEntry *GetEntry(const std::string &name);
 	const ConditionEntry *GetEntry(const std::string &name) const;
 
+	// Add an entry that provides all the conditions that start with its name.
+	void AddPrefixProvider(const ConditionEntry &entry);
+	// Rebuild the index and prefixes after the storage has been replaced.
+	void Reindex();
+
+
+private:
+	// A node in the tree of the names of the prefixed providers, which has a
+	// child for each character that can follow the characters leading to it.
+	class PrefixNode {
+	public:
+		const ConditionEntry *provider = nullptr;
+		// The characters that follow, and the index of the node for each.
+		std::vector<std::pair<char, size_t>> next;
+	};
+
 
 private:
-	// Storage for both the primary conditions as well as the providers.
+	// Storage for both the primary conditions as well as the providers. It is
+	// kept in order of the names, which is also the order they are saved in.
 	std::map<std::string, ConditionEntry> storage;
+	// A hash index of the storage, so finding a condition by its name does not
+	// need to compare it to log(n) other names. The keys refer to the storage.
+	std::unordered_map<std::string_view, ConditionEntry *> index;
+	// The tree of prefixed provider names, starting from the empty prefix.
+	std::vector<PrefixNode> prefixes = std::vector<PrefixNode>(1);
+	uint64_t generation = 1;
 };
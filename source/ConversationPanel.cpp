@@ -95,6 +95,8 @@ ConversationPanel::ConversationPanel(PlayerInfo &player, const Conversation &con
 		subs["<ship>"] = ship->GivenName();
 		subs["<model>"] = ship->TranslatedDisplayModelName();
 	}
+	// Translate the substitutions once, rather than for every paragraph.
+	Translation::TranslateSubstitutionValues(subs);
 
 	// Start a PlayerInfo transaction to prevent saves during the conversation
 	// from recording partial results.
@@ -462,7 +464,7 @@ void ConversationPanel::Goto(int index, int selectedChoice)
 		{
 			// This is an ordinary conversation node which should be displayed.
 			// Perform any necessary text replacement, and add the text to the display.
-			string altered = Format::ExpandConditions(Format::ReplaceTranslated(conversation.Text(node), subs), getter);
+			string altered = Format::ExpandConditions(Format::Replace(conversation.Text(node), subs), getter);
 			text.emplace_back(altered, conversation.Scene(node), text.empty());
 		}
 		else
@@ -478,7 +480,7 @@ void ConversationPanel::Goto(int index, int selectedChoice)
 	for(int i = 0; i < conversation.Choices(node); ++i)
 		if(conversation.ShouldDisplayNode(node, i))
 		{
-			string altered = Format::ExpandConditions(Format::ReplaceTranslated(conversation.Text(node, i), subs), getter);
+			string altered = Format::ExpandConditions(Format::Replace(conversation.Text(node, i), subs), getter);
 			choices.emplace_back(Paragraph(altered), i);
 		}
 	// This is a safeguard in case of logic errors, to ensure we don't set the player name.
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DamageProfile.h"
 
+#include "AttributeKey.h"
 #include "DamageDealt.h"
 #include "image/Mask.h"
 #include "Minable.h"
@@ -137,11 +138,11 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 	double shields = ship.ShieldLevel();
 	if(shields > 0.)
 	{
-		double piercing = max(0., min(1., weapon.Piercing() / (1. + attributes.Get("piercing protection"))
-			- attributes.Get("piercing resistance")));
-		double highPermeability = attributes.Get("high shield permeability");
-		double lowPermeability = attributes.Get("low shield permeability");
-		double permeability = ship.Cloaking() * attributes.Get("cloaked shield permeability");
+		double piercing = max(0., min(1., weapon.Piercing() / (1. + attributes.Get(AttributeKey::PIERCING_PROTECTION))
+			- attributes.Get(AttributeKey::PIERCING_RESISTANCE)));
+		double highPermeability = attributes.Get(AttributeKey::HIGH_SHIELD_PERMEABILITY);
+		double lowPermeability = attributes.Get(AttributeKey::LOW_SHIELD_PERMEABILITY);
+		double permeability = ship.Cloaking() * attributes.Get(AttributeKey::CLOAKED_SHIELD_PERMEABILITY);
 		if(highPermeability || lowPermeability)
 		{
 			// Determine what portion of its maximum shields the ship is currently at.
@@ -155,8 +156,8 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 
 		damage.shieldDamage = (weapon.ShieldDamage()
 			+ weapon.RelativeShieldDamage() * ship.MaxShields())
-			* ScaleType(0., 0., attributes.Get("shield protection")
-			+ (ship.IsCloaked() ? attributes.Get("cloak shield protection") : 0.));
+			* ScaleType(0., 0., attributes.Get(AttributeKey::SHIELD_PROTECTION)
+			+ (ship.IsCloaked() ? attributes.Get(AttributeKey::CLOAK_SHIELD_PROTECTION) : 0.));
 		if(damage.shieldDamage > shields)
 			shieldFraction = min(shieldFraction, shields / damage.shieldDamage);
 	}
@@ -166,8 +167,8 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 	// Hull damage is blocked 100%.
 	// Shield damage is blocked 0%.
 	damage.shieldDamage *= shieldFraction;
-	double totalHullProtection = (ScaleType(1., 0., attributes.Get("hull protection") +
-		(ship.IsCloaked() ? attributes.Get("cloak hull protection") : 0.)));
+	double totalHullProtection = (ScaleType(1., 0., attributes.Get(AttributeKey::HULL_PROTECTION) +
+		(ship.IsCloaked() ? attributes.Get(AttributeKey::CLOAK_HULL_PROTECTION) : 0.)));
 	damage.hullDamage = (weapon.HullDamage()
 		+ weapon.RelativeHullDamage() * ship.MaxHull())
 		* totalHullProtection;
@@ -182,34 +183,34 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 			* (1. - hullFraction);
 	}
 	damage.energyDamage = (weapon.EnergyDamage()
-		+ weapon.RelativeEnergyDamage() * attributes.Get("energy capacity"))
-		* ScaleType(.5, 0., attributes.Get("energy protection"));
+		+ weapon.RelativeEnergyDamage() * attributes.Get(AttributeKey::ENERGY_CAPACITY))
+		* ScaleType(.5, 0., attributes.Get(AttributeKey::ENERGY_PROTECTION));
 	damage.heatDamage = (weapon.HeatDamage()
 		+ weapon.RelativeHeatDamage() * ship.MaximumHeat())
-		* ScaleType(.5, 0., attributes.Get("heat protection"));
+		* ScaleType(.5, 0., attributes.Get(AttributeKey::HEAT_PROTECTION));
 	damage.fuelDamage = (weapon.FuelDamage()
-		+ weapon.RelativeFuelDamage() * attributes.Get("fuel capacity"))
-		* ScaleType(.5, 0., attributes.Get("fuel protection"));
+		+ weapon.RelativeFuelDamage() * attributes.Get(AttributeKey::FUEL_CAPACITY))
+		* ScaleType(.5, 0., attributes.Get(AttributeKey::FUEL_PROTECTION));
 
 	// DoT damage types with an instantaneous analog.
 	// Ion and burn damage are blocked 50% by shields.
 	// Corrosion and leak damage are blocked 100%.
 	// Discharge damage is blocked 50% by the absence of shields.
-	damage.dischargeDamage = weapon.DischargeDamage() * ScaleType(0., .5, attributes.Get("discharge protection"));
-	damage.corrosionDamage = weapon.CorrosionDamage() * ScaleType(1., 0., attributes.Get("corrosion protection"));
-	damage.ionDamage = weapon.IonDamage() * ScaleType(.5, 0., attributes.Get("ion protection"));
-	damage.burnDamage = weapon.BurnDamage() * ScaleType(.5, 0., attributes.Get("burn protection"));
-	damage.leakDamage = weapon.LeakDamage() * ScaleType(1., 0., attributes.Get("leak protection"));
+	damage.dischargeDamage = weapon.DischargeDamage() * ScaleType(0., .5, attributes.Get(AttributeKey::DISCHARGE_PROTECTION));
+	damage.corrosionDamage = weapon.CorrosionDamage() * ScaleType(1., 0., attributes.Get(AttributeKey::CORROSION_PROTECTION));
+	damage.ionDamage = weapon.IonDamage() * ScaleType(.5, 0., attributes.Get(AttributeKey::ION_PROTECTION));
+	damage.burnDamage = weapon.BurnDamage() * ScaleType(.5, 0., attributes.Get(AttributeKey::BURN_PROTECTION));
+	damage.leakDamage = weapon.LeakDamage() * ScaleType(1., 0., attributes.Get(AttributeKey::LEAK_PROTECTION));
 
 	// Unique special damage types.
 	// Slowing and scrambling are blocked 50% by shields.
 	// Disruption is blocked 50% by the absence of shields.
-	damage.slowingDamage = weapon.SlowingDamage() * ScaleType(.5, 0., attributes.Get("slowing protection"));
-	damage.scramblingDamage = weapon.ScramblingDamage() * ScaleType(.5, 0., attributes.Get("scramble protection"));
-	damage.disruptionDamage = weapon.DisruptionDamage() * ScaleType(0., .5, attributes.Get("disruption protection"));
+	damage.slowingDamage = weapon.SlowingDamage() * ScaleType(.5, 0., attributes.Get(AttributeKey::SLOWING_PROTECTION));
+	damage.scramblingDamage = weapon.ScramblingDamage() * ScaleType(.5, 0., attributes.Get(AttributeKey::SCRAMBLE_PROTECTION));
+	damage.disruptionDamage = weapon.DisruptionDamage() * ScaleType(0., .5, attributes.Get(AttributeKey::DISRUPTION_PROTECTION));
 
 	// Hit force is unaffected by shields.
-	double hitForce = weapon.HitForce() * ScaleType(0., 0., attributes.Get("force protection"));
+	double hitForce = weapon.HitForce() * ScaleType(0., 0., attributes.Get(AttributeKey::FORCE_PROTECTION));
 	if(hitForce)
 	{
 		Point d = ship.Position() - position;
@@ -15,11 +15,76 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DataFile.h"
 
+#include "BinaryDataFile.h"
 #include "Files.h"
+#include "Logger.h"
+#include "MemoryProfile.h"
 #include "text/Utf8.h"
 
+#include <bit>
+#include <cstring>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
+namespace {
+	// Every character that separates tokens or ends them is ASCII, and no byte
+	// of a multi-byte UTF-8 code point is, so tokens and comments can be scanned
+	// as bytes instead of decoding every code point in them.
+
+	// Find the first whitespace or control character at or after the given
+	// position. The data must end in a newline, so there always is one.
+	size_t FindSeparator(const string &data, size_t pos)
+	{
+		const char *bytes = data.data();
+		const size_t size = data.size();
+#ifdef __AVX2__
+		const __m256i space = _mm256_set1_epi8(' ');
+		for( ; pos + 32 <= size; pos += 32)
+		{
+			// A byte is at most a space if the larger of it and a space is a space.
+			const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + pos));
+			const unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(chunk, space), space));
+			if(mask)
+				return pos + countr_zero(mask);
+		}
+#endif
+#if defined(__SSE2__)
+		const __m128i space16 = _mm_set1_epi8(' ');
+		for( ; pos + 16 <= size; pos += 16)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + pos));
+			const unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, space16), space16));
+			if(mask)
+				return pos + countr_zero(mask);
+		}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		for( ; pos + 16 <= size; pos += 16)
+			if(vmaxvq_u8(vcleq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(bytes + pos)), vdupq_n_u8(' '))))
+				break;
+#endif
+		while(static_cast<unsigned char>(bytes[pos]) > ' ')
+			++pos;
+		return pos;
+	}
+
+	// Find the given closing quotation mark on the line starting at the given
+	// position, or the end of the line if it is missing.
+	size_t FindQuote(const string &data, size_t pos, char quote)
+	{
+		const size_t lineEnd = data.find('\n', pos);
+		const void *found = memchr(data.data() + pos, quote, lineEnd - pos);
+		return found ? static_cast<const char *>(found) - data.data() : lineEnd;
+	}
+}
+
 
 
 // Constructor, taking a file path (in UTF-8).
@@ -41,7 +106,24 @@ DataFile::DataFile(istream &in)
 // Load from a file path (in UTF-8).
 void DataFile::Load(const filesystem::path &path)
 {
+	MemoryProfile::Scope memoryScope(MemoryProfile::Tag::DATA_NODES);
 	string data = Files::Read(path);
+	if(BinaryDataFile::IsBinary(data))
+	{
+		root.tokens.push_back("file");
+		root.tokens.push_back(path.string());
+		if(!BinaryDataFile::Decode(data, *this))
+			Logger::Log("Could not read \"" + path.string() + "\", because it is corrupt.", Logger::Level::WARNING);
+		return;
+	}
+	Parse(path, data);
+}
+
+
+
+// Parse the given text, which was read from the given path.
+void DataFile::Parse(const filesystem::path &path, string &data)
+{
 	if(data.empty())
 		return;
 
@@ -61,6 +143,7 @@ void DataFile::Load(const filesystem::path &path)
 // Constructor, taking an istream. This can be cin or a file.
 void DataFile::Load(istream &in)
 {
+	MemoryProfile::Scope memoryScope(MemoryProfile::Tag::DATA_NODES);
 	string data;
 
 	static const size_t BLOCK = 4096;
@@ -81,7 +164,7 @@ void DataFile::Load(istream &in)
 
 
 // Get an iterator to the start of the list of nodes in this file.
-list<DataNode>::const_iterator DataFile::begin() const
+vector<DataNode>::const_iterator DataFile::begin() const
 {
 	return root.begin();
 }
@@ -89,7 +172,7 @@ list<DataNode>::const_iterator DataFile::begin() const
 
 
 // Get an iterator to the end of the list of nodes in this file.
-list<DataNode>::const_iterator DataFile::end() const
+vector<DataNode>::const_iterator DataFile::end() const
 {
 	return root.end();
 }
@@ -147,9 +230,12 @@ void DataFile::LoadData(const string &data)
 		if(c == '#')
 		{
 			if(mixedIndentation)
+			{
 				root.PrintTrace("Mixed whitespace usage for comment at line " + to_string(lineNumber));
-			while(c != '\n')
-				c = Utf8::DecodeCodePoint(data, pos);
+				hasWarnings = true;
+			}
+			pos = data.find('\n', pos) + 1;
+			c = '\n';
 		}
 		// Skip empty lines (including comment lines).
 		if(c == '\n')
@@ -164,8 +250,10 @@ void DataFile::LoadData(const string &data)
 		}
 
 		// Add this node as a child of the proper node.
-		list<DataNode> &children = stack.back()->children;
+		vector<DataNode> &children = stack.back()->children;
+		const size_t capacity = children.capacity();
 		children.emplace_back(stack.back());
+		stack.back()->FinishAddingChild(capacity);
 		DataNode &node = children.back();
 		node.lineNumber = lineNumber;
 
@@ -181,19 +269,12 @@ void DataFile::LoadData(const string &data)
 			char32_t endQuote = c;
 			bool isQuoted = (endQuote == '"' || endQuote == '`');
 			if(isQuoted)
-			{
 				tokenPos = pos;
-				c = Utf8::DecodeCodePoint(data, pos);
-			}
-
-			size_t endPos = tokenPos;
 
 			// Find the end of this token.
-			while(c != '\n' && (isQuoted ? (c != endQuote) : (c > ' ')))
-			{
-				endPos = pos;
-				c = Utf8::DecodeCodePoint(data, pos);
-			}
+			const size_t endPos = isQuoted ? FindQuote(data, tokenPos, endQuote) : FindSeparator(data, tokenPos);
+			pos = endPos;
+			c = Utf8::DecodeCodePoint(data, pos);
 
 			// It ought to be legal to construct a string from an empty iterator
 			// range, but it appears that some libraries do not handle that case
@@ -204,7 +285,10 @@ void DataFile::LoadData(const string &data)
 				node.tokens.emplace_back(data, tokenPos, endPos - tokenPos);
 			// This is not a fatal error, but it may indicate a format mistake:
 			if(isQuoted && c == '\n')
+			{
 				node.PrintTrace("Closing quotation mark is missing:");
+				hasWarnings = true;
+			}
 
 			if(c != '\n')
 			{
@@ -225,8 +309,8 @@ void DataFile::LoadData(const string &data)
 				// of this line of the file.
 				if(c == '#')
 				{
-					while(c != '\n')
-						c = Utf8::DecodeCodePoint(data, pos);
+					pos = data.find('\n', pos) + 1;
+					c = '\n';
 				}
 			}
 		}
@@ -235,6 +319,9 @@ void DataFile::LoadData(const string &data)
 
 		// Now that we've tokenized this node, print any mixed whitespace warnings.
 		if(mixedIndentation)
+		{
 			node.PrintTrace("Mixed whitespace usage at line");
+			hasWarnings = true;
+		}
 	}
 }
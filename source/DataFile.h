@@ -19,8 +19,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <filesystem>
 #include <istream>
-#include <list>
 #include <string>
+#include <vector>
 
 
 
@@ -41,15 +41,22 @@ public:
 	void Load(std::istream &in);
 
 	// Functions for iterating through all DataNodes in this file.
-	std::list<DataNode>::const_iterator begin() const;
-	std::list<DataNode>::const_iterator end() const;
+	std::vector<DataNode>::const_iterator begin() const;
+	std::vector<DataNode>::const_iterator end() const;
 
 
 private:
+	void Parse(const std::filesystem::path &path, std::string &data);
 	void LoadData(const std::string &data);
 
 
 private:
 	// This is the container for all DataNodes in this file.
 	DataNode root;
+	// Whether any formatting mistakes were reported while parsing this file.
+	bool hasWarnings = false;
+
+	// Allow the cache and the binary form to store and restore the parsed contents of a file.
+	friend class BinaryDataFile;
+	friend class DataFileCache;
 };
@@ -0,0 +1,204 @@
+/* DataFileCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DataFileCache.h"
+
+#include "DataFile.h"
+#include "DiskCache.h"
+#include "Files.h"
+#include "MappedFile.h"
+#include "MemoryProfile.h"
+
+#include <cstring>
+#include <system_error>
+
+using namespace std;
+
+namespace {
+	// This must be changed whenever the layout of the cached files changes.
+	const char MAGIC[8] = {'E', 'S', 'N', 'O', 'D', 'E', 'S', '1'};
+
+	// The file in which the parsed nodes of the given data file are cached.
+	filesystem::path CachePath(const filesystem::path &path)
+	{
+		return DiskCache::Path(DiskCache::Hash(path.string()), ".bin");
+	}
+
+	// Read a value from a cached file, checking that it does not run past the end.
+	// A cache file that is truncated or corrupt just causes the text to be parsed.
+	template<class Type>
+	bool Read(const char *&it, const char *end, Type &value)
+	{
+		if(static_cast<size_t>(end - it) < sizeof(Type))
+			return false;
+		memcpy(&value, it, sizeof(Type));
+		it += sizeof(Type);
+		return true;
+	}
+
+	bool Read(const char *&it, const char *end, string &value)
+	{
+		uint32_t length;
+		if(!Read(it, end, length) || static_cast<size_t>(end - it) < length)
+			return false;
+		value.assign(it, length);
+		it += length;
+		return true;
+	}
+
+	template<class Type>
+	void Write(string &out, Type value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(Type));
+	}
+
+	void Write(string &out, const string &value)
+	{
+		Write(out, static_cast<uint32_t>(value.size()));
+		out += value;
+	}
+}
+
+
+
+// Load the given file, using the cached copy of its nodes if it is up to date.
+// Otherwise, the file is parsed and the result stored in the cache.
+void DataFileCache::Load(const filesystem::path &path, DataFile &file)
+{
+	MemoryProfile::Scope memoryScope(MemoryProfile::Tag::DATA_NODES);
+	// Files inside of zipped plugins have no timestamp, so they are always parsed.
+	error_code error;
+	if(!filesystem::is_regular_file(path, error))
+	{
+		file.Load(path);
+		return;
+	}
+
+	const filesystem::path cachePath = CachePath(path);
+	Header header;
+	header.path = path.string();
+	header.size = filesystem::file_size(path, error);
+	header.timestamp = Files::Timestamp(path).time_since_epoch().count();
+
+	string data;
+	bool isUnchanged = false;
+	{
+		MappedFile cached(cachePath);
+		const char *it = cached.Data();
+		const char *end = cached.Data() + cached.Size();
+		Header stored;
+		const bool isValid = cached.Data() && ReadHeader(it, end, stored) && stored.path == header.path
+			&& stored.size == header.size;
+		const char *nodes = it;
+		if(isValid && stored.timestamp == header.timestamp && ReadNode(it, end, file.root, 0))
+		{
+			DiskCache::Hit("data files", cachePath);
+			return;
+		}
+
+		// If only the timestamp has changed, the cached nodes can still be used
+		// as long as the contents of the file have not.
+		data = Files::Read(path);
+		header.hash = DiskCache::Hash(data);
+		file.root = DataNode();
+		it = nodes;
+		isUnchanged = isValid && stored.hash == header.hash && ReadNode(it, end, file.root, 0);
+	}
+	if(isUnchanged)
+		DiskCache::Hit("data files", cachePath);
+	else
+		DiskCache::Miss("data files");
+
+	if(!isUnchanged)
+	{
+		file.root = DataNode();
+		file.Parse(path, data);
+		if(file.hasWarnings)
+			return;
+	}
+	Store(cachePath, header, file);
+}
+
+
+
+// Write the parsed nodes of a file to the cache.
+void DataFileCache::Store(const filesystem::path &cachePath, const Header &header, const DataFile &file)
+{
+	string out(MAGIC, sizeof(MAGIC));
+	Write(out, header.size);
+	Write(out, header.timestamp);
+	Write(out, header.hash);
+	Write(out, header.path);
+	WriteNode(out, file.root);
+	DiskCache::Store(cachePath, out);
+}
+
+
+
+bool DataFileCache::ReadHeader(const char *&it, const char *end, Header &header)
+{
+	if(static_cast<size_t>(end - it) < sizeof(MAGIC) || memcmp(it, MAGIC, sizeof(MAGIC)))
+		return false;
+	it += sizeof(MAGIC);
+	return Read(it, end, header.size) && Read(it, end, header.timestamp) && Read(it, end, header.hash)
+		&& Read(it, end, header.path);
+}
+
+
+
+// Read a node and all of its children from the cache.
+bool DataFileCache::ReadNode(const char *&it, const char *end, DataNode &node, int depth)
+{
+	if(depth > DataNode::MAX_DEPTH)
+		return false;
+	uint32_t lineNumber;
+	uint32_t tokenCount;
+	if(!Read(it, end, lineNumber) || !Read(it, end, tokenCount))
+		return false;
+	node.lineNumber = lineNumber;
+	// Every token takes up at least four bytes and every child at least twelve,
+	// so a count that does not fit in the rest of the file means it is corrupt.
+	if(tokenCount > static_cast<size_t>(end - it) / sizeof(uint32_t))
+		return false;
+	node.tokens.resize(tokenCount);
+	for(string &token : node.tokens)
+		if(!Read(it, end, token))
+			return false;
+
+	uint32_t childCount;
+	if(!Read(it, end, childCount) || childCount > static_cast<size_t>(end - it) / (3 * sizeof(uint32_t)))
+		return false;
+	node.children.reserve(childCount);
+	for(uint32_t i = 0; i < childCount; ++i)
+	{
+		node.children.emplace_back(&node);
+		if(!ReadNode(it, end, node.children.back(), depth + 1))
+			return false;
+	}
+	return true;
+}
+
+
+
+void DataFileCache::WriteNode(string &out, const DataNode &node)
+{
+	Write(out, static_cast<uint32_t>(node.lineNumber));
+	Write(out, static_cast<uint32_t>(node.tokens.size()));
+	for(const string &token : node.tokens)
+		Write(out, token);
+	Write(out, static_cast<uint32_t>(node.children.size()));
+	for(const DataNode &child : node.children)
+		WriteNode(out, child);
+}
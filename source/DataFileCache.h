@@ -0,0 +1,56 @@
+/* DataFileCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+class DataFile;
+class DataNode;
+
+
+
+// An on-disk cache of the parsed contents of data files, so that the text of
+// files that have not changed since the last launch does not need to be
+// tokenized again. Each file's node tree is stored in a binary form in the
+// "cache" folder of the config directory, along with the size, timestamp and
+// a hash of the contents of the file it was parsed from. A file whose size or
+// timestamp has changed is read again, and the cached copy is only used if the
+// contents are still the same. Files which produce any warnings while parsing
+// are not cached, so that the warnings are shown every time they are loaded.
+class DataFileCache {
+public:
+	// Load the given file, using the cached copy of its nodes if it is up to date.
+	// Otherwise, the file is parsed and the result stored in the cache.
+	static void Load(const std::filesystem::path &path, DataFile &file);
+
+
+private:
+	// The parts of a cached file that identify which data file it was parsed from.
+	class Header {
+	public:
+		std::string path;
+		uint64_t size = 0;
+		int64_t timestamp = 0;
+		uint64_t hash = 0;
+	};
+
+	static void Store(const std::filesystem::path &cachePath, const Header &header, const DataFile &file);
+	static bool ReadHeader(const char *&it, const char *end, Header &header);
+	static bool ReadNode(const char *&it, const char *end, DataNode &node, int depth);
+	static void WriteNode(std::string &out, const DataNode &node);
+};
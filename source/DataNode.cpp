@@ -24,6 +24,55 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	// Convert a token that has already been checked to be a number.
+	// Allowed format: "[+-]?[0-9]*[.]?[0-9]*([eE][+-]?[0-9]*)?".
+	double ParseNumber(const string &token)
+	{
+		const char *it = token.c_str();
+
+		// Check for leading sign.
+		double sign = (*it == '-') ? -1. : 1.;
+		it += (*it == '-' || *it == '+');
+
+		// Digits before the decimal point.
+		int64_t value = 0;
+		while(*it >= '0' && *it <= '9')
+			value = (value * 10) + (*it++ - '0');
+
+		// Digits after the decimal point (if any).
+		int64_t power = 0;
+		if(*it == '.')
+		{
+			++it;
+			while(*it >= '0' && *it <= '9')
+			{
+				value = (value * 10) + (*it++ - '0');
+				--power;
+			}
+		}
+
+		// Exponent.
+		if(*it == 'e' || *it == 'E')
+		{
+			++it;
+			int64_t sign = (*it == '-') ? -1 : 1;
+			it += (*it == '-' || *it == '+');
+
+			int64_t exponent = 0;
+			while(*it >= '0' && *it <= '9')
+				exponent = (exponent * 10) + (*it++ - '0');
+
+			power += sign * exponent;
+		}
+
+		// Compose the return value. Most numbers have no fraction or exponent.
+		if(!power)
+			return copysign(static_cast<double>(value), sign);
+		return copysign(value * pow(10., power), sign);
+	}
+}
+
 
 
 // Construct a DataNode and remember what its parent is.
@@ -126,7 +175,7 @@ double DataNode::Value(int index) const
 	else if(!IsNumber(tokens[index]))
 		PrintTrace("Cannot convert value \"" + tokens[index] + "\" to a number:");
 	else
-		return Value(tokens[index]);
+		return ParseNumber(tokens[index]);
 
 	return 0.;
 }
@@ -142,45 +191,7 @@ double DataNode::Value(const string &token)
 		Logger::Log("Cannot convert value \"" + token + "\" to a number.", Logger::Level::WARNING);
 		return 0.;
 	}
-	const char *it = token.c_str();
-
-	// Check for leading sign.
-	double sign = (*it == '-') ? -1. : 1.;
-	it += (*it == '-' || *it == '+');
-
-	// Digits before the decimal point.
-	int64_t value = 0;
-	while(*it >= '0' && *it <= '9')
-		value = (value * 10) + (*it++ - '0');
-
-	// Digits after the decimal point (if any).
-	int64_t power = 0;
-	if(*it == '.')
-	{
-		++it;
-		while(*it >= '0' && *it <= '9')
-		{
-			value = (value * 10) + (*it++ - '0');
-			--power;
-		}
-	}
-
-	// Exponent.
-	if(*it == 'e' || *it == 'E')
-	{
-		++it;
-		int64_t sign = (*it == '-') ? -1 : 1;
-		it += (*it == '-' || *it == '+');
-
-		int64_t exponent = 0;
-		while(*it >= '0' && *it <= '9')
-			exponent = (exponent * 10) + (*it++ - '0');
-
-		power += sign * exponent;
-	}
-
-	// Compose the return value.
-	return copysign(value * pow(10., power), sign);
+	return ParseNumber(token);
 }
 
 
@@ -297,7 +308,9 @@ bool DataNode::IsConditionName(const string &token)
 // Add a new child. The child's parent must be this node.
 void DataNode::AddChild(const DataNode &child)
 {
+	const size_t capacity = children.capacity();
 	children.emplace_back(child);
+	FinishAddingChild(capacity);
 }
 
 
@@ -311,7 +324,7 @@ bool DataNode::HasChildren() const noexcept
 
 
 // Iterator to the beginning of the list of children.
-list<DataNode>::const_iterator DataNode::begin() const noexcept
+vector<DataNode>::const_iterator DataNode::begin() const noexcept
 {
 	return children.begin();
 }
@@ -319,7 +332,7 @@ list<DataNode>::const_iterator DataNode::begin() const noexcept
 
 
 // Iterator to the end of the list of children.
-list<DataNode>::const_iterator DataNode::end() const noexcept
+vector<DataNode>::const_iterator DataNode::end() const noexcept
 {
 	return children.end();
 }
@@ -357,12 +370,23 @@ int DataNode::PrintTrace(const string &message) const
 
 
 
-// Adjust the parent pointers when a copy is made of a DataNode.
+// If adding a child moved the existing ones, they no longer point to this node
+// as their parent, and neither does a copied child.
+void DataNode::FinishAddingChild(size_t oldCapacity) noexcept
+{
+	if(children.capacity() != oldCapacity)
+		Reparent();
+	else
+		children.back().parent = this;
+}
+
+
+
+// Adjust the parent pointers when a copy is made of a DataNode. Only the direct
+// children need to be updated: copying a child already updates its own children,
+// and moving this node does not move the children's storage.
 void DataNode::Reparent() noexcept
 {
 	for(DataNode &child : children)
-	{
 		child.parent = this;
-		child.Reparent();
-	}
 }
@@ -16,7 +16,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <cstdint>
-#include <list>
 #include <string>
 #include <vector>
 
@@ -72,21 +71,29 @@ public:
 	// Check if this node has any children. If so, the iterator functions below
 	// can be used to access them.
 	bool HasChildren() const noexcept;
-	std::list<DataNode>::const_iterator begin() const noexcept;
-	std::list<DataNode>::const_iterator end() const noexcept;
+	std::vector<DataNode>::const_iterator begin() const noexcept;
+	std::vector<DataNode>::const_iterator end() const noexcept;
 
 	// Print a message followed by a "trace" of this node and its parents.
 	int PrintTrace(const std::string &message = "") const;
 
 
 private:
+	// No real data is nested anywhere near this deeply, so a binary or cached
+	// file that is must be corrupt. Readers of those files stop here instead of
+	// using up the stack.
+	static constexpr int MAX_DEPTH = 256;
+
+
+private:
+	void FinishAddingChild(size_t oldCapacity) noexcept;
 	// Adjust the parent pointers when a copy is made of a DataNode.
 	void Reparent() noexcept;
 
 
 private:
 	// These are "child" nodes found on subsequent lines with deeper indentation.
-	std::list<DataNode> children;
+	std::vector<DataNode> children;
 	// These are the tokens found in this particular line of the data file.
 	std::vector<std::string> tokens;
 	// The parent pointer is used only for printing stack traces.
@@ -95,5 +102,7 @@ private:
 	size_t lineNumber = 0;
 
 	// Allow DataFile to modify the internal structure of DataNodes.
+	friend class BinaryDataFile;
 	friend class DataFile;
+	friend class DataFileCache;
 };
@@ -18,8 +18,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "Files.h"
 
+#include <ostream>
+
 using namespace std;
 
+namespace {
+	// How much output a DataWriter that writes to a stream collects before
+	// writing it out.
+	constexpr size_t BLOCK_SIZE = 1 << 16;
+}
+
 
 
 // This string constant is just used for remembering what string needs to be
@@ -41,7 +49,16 @@ DataWriter::DataWriter(const filesystem::path &path)
 DataWriter::DataWriter()
 	: before(&indent)
 {
-	out.precision(8);
+}
+
+
+
+// Constructor for a DataWriter that writes to the given stream as it goes.
+DataWriter::DataWriter(ostream &stream)
+	: DataWriter()
+{
+	this->stream = &stream;
+	out.reserve(BLOCK_SIZE);
 }
 
 
@@ -49,7 +66,12 @@ DataWriter::DataWriter()
 // Destructor, which saves the file all in one block.
 DataWriter::~DataWriter()
 {
-	if(!path.empty())
+	if(stream)
+	{
+		stream->write(out.data(), out.size());
+		stream->flush();
+	}
+	else if(!path.empty())
 		SaveToPath(path);
 }
 
@@ -58,7 +80,7 @@ DataWriter::~DataWriter()
 // Save the contents to a file.
 void DataWriter::SaveToPath(const filesystem::path &filepath)
 {
-	Files::Write(filepath, out.str());
+	Files::Write(filepath, out);
 }
 
 
@@ -66,7 +88,7 @@ void DataWriter::SaveToPath(const filesystem::path &filepath)
 // Get the contents as a string.
 string DataWriter::SaveToString() const
 {
-	return out.str();
+	return out;
 }
 
 
@@ -96,8 +118,9 @@ void DataWriter::Write(const DataNode &node)
 // Begin a new line of the file.
 void DataWriter::Write()
 {
-	out << '\n';
+	out += '\n';
 	before = &indent;
+	FlushIfFull();
 }
 
 
@@ -121,7 +144,9 @@ void DataWriter::EndChild()
 // Write a comment line, at the current indentation level.
 void DataWriter::WriteComment(const string &str)
 {
-	out << *before << "# " << str;
+	out += *before;
+	out += "# ";
+	out += str;
 	Write();
 }
 
@@ -138,8 +163,8 @@ void DataWriter::WriteToken(const char *a)
 // Write a token, given as a string object.
 void DataWriter::WriteToken(const string &a)
 {
-	out << *before;
-	out << Quote(a);
+	out += *before;
+	out += Quote(a);
 
 	// The next token written will not be the first one on this line, so it only
 	// needs to have a single space before it.
@@ -164,3 +189,14 @@ string DataWriter::Quote(const string &a)
 	else
 		return a;
 }
+
+
+
+void DataWriter::FlushIfFull()
+{
+	if(!stream || out.size() < BLOCK_SIZE)
+		return;
+
+	stream->write(out.data(), out.size());
+	out.clear();
+}
@@ -16,10 +16,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include <algorithm>
+#include <charconv>
 #include <filesystem>
+#include <iosfwd>
 #include <map>
-#include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 class DataNode;
@@ -37,6 +39,10 @@ public:
 	explicit DataWriter(const std::filesystem::path &path);
 	// Constructor for a DataWriter that will not save its contents automatically
 	DataWriter();
+	// Constructor for a DataWriter that writes to the given stream as it goes,
+	// a block at a time, instead of keeping everything in memory. The stream
+	// must outlive this object, and the last block is written by the destructor.
+	explicit DataWriter(std::ostream &stream);
 	DataWriter(const DataWriter &) = delete;
 	DataWriter(DataWriter &&) = delete;
 	DataWriter &operator=(const DataWriter &) = delete;
@@ -47,7 +53,8 @@ public:
 
 	// Save the contents to a file.
 	void SaveToPath(const std::filesystem::path &path);
-	// Get the contents as a string.
+	// Get the contents as a string. For a DataWriter that writes to a stream,
+	// this only has whatever has not been written to it yet.
 	std::string SaveToString() const;
 
 	// The Write() function can take any number of arguments. Each argument is
@@ -81,6 +88,12 @@ public:
 	static std::string Quote(const std::string &text);
 
 
+private:
+	// If writing to a stream, write the finished lines to it once there are
+	// enough of them.
+	void FlushIfFull();
+
+
 private:
 	// Save path (in UTF-8). Empty string for in-memory DataWriter.
 	std::filesystem::path path;
@@ -93,7 +106,9 @@ private:
 	// "indent" for the first token in a line and "space" for subsequent tokens.
 	const std::string *before;
 	// Compose the output in memory before writing it to file.
-	std::ostringstream out;
+	std::string out;
+	// The stream to write to as the output is composed, if any.
+	std::ostream *stream = nullptr;
 };
 
 
@@ -116,7 +131,22 @@ void DataWriter::WriteToken(const A &a)
 	static_assert(std::is_arithmetic_v<A>,
 		"DataWriter cannot output anything but strings and arithmetic types.");
 
-	out << *before << a;
+	out += *before;
+	// Format numbers the same way as a stream with a precision of 8 would.
+	if constexpr(std::is_same_v<A, bool>)
+		out += a ? '1' : '0';
+	else if constexpr(std::is_same_v<A, char> || std::is_same_v<A, signed char> || std::is_same_v<A, unsigned char>)
+		out += static_cast<char>(a);
+	else
+	{
+		char buffer[64];
+		std::to_chars_result result;
+		if constexpr(std::is_floating_point_v<A>)
+			result = std::to_chars(buffer, buffer + sizeof(buffer), a, std::chars_format::general, 8);
+		else
+			result = std::to_chars(buffer, buffer + sizeof(buffer), a);
+		out.append(buffer, result.ptr);
+	}
 	before = &space;
 }
 
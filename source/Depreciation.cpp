@@ -51,6 +51,23 @@ namespace {
 
 	// Names for the two kinds of depreciation records.
 	string NAME[2] = {"fleet depreciation", "stock depreciation"};
+
+	// Save one item's records. Anything older than the maximum age is worth
+	// the same, so a planet's stock saves all of those as a single record,
+	// and the player's fleet does not need to save them at all.
+	void WriteRecord(DataWriter &out, const map<int, int> &record, int day, bool isStock)
+	{
+		const int oldest = day - MaxAge();
+		auto it = record.begin();
+		int depreciated = 0;
+		for( ; it != record.end() && it->first <= oldest; ++it)
+			depreciated += it->second;
+		if(isStock && depreciated)
+			out.Write(oldest, depreciated);
+		for( ; it != record.end(); ++it)
+			if(it->second)
+				out.Write(it->first, it->second);
+	}
 }
 
 
@@ -110,9 +127,7 @@ void Depreciation::Save(DataWriter &out, int day) const
 					// stock are fully depreciated. If it's the player's stock,
 					// anything not recorded is considered fully depreciated, so
 					// there is no reason to save records for those items.
-					for(const auto &it : sit.second)
-						if(isStock || (it.second && it.first > day - MaxAge()))
-							out.Write(it.first, it.second);
+					WriteRecord(out, sit.second, day, isStock);
 				}
 				out.EndChild();
 			});
@@ -125,9 +140,7 @@ void Depreciation::Save(DataWriter &out, int day) const
 				out.Write("outfit", oit.first->TrueName());
 				out.BeginChild();
 				{
-					for(const auto &it : oit.second)
-						if(isStock || (it.second && it.first > day - MaxAge()))
-							out.Write(it.first, it.second);
+					WriteRecord(out, oit.second, day, isStock);
 				}
 				out.EndChild();
 			});
@@ -174,6 +187,7 @@ void Depreciation::Buy(const Ship &ship, int day, Depreciation *source, bool cha
 
 	// Then, check the base day for the ship chassis itself.
 	const Ship *base = GameData::Ships().Get(ship.TrueModelName());
+	const int today = day;
 	if(source)
 	{
 		// Check if the source has any instances of this ship.
@@ -193,7 +207,9 @@ void Depreciation::Buy(const Ship &ship, int day, Depreciation *source, bool cha
 	}
 
 	// Increment our count for this ship on this day.
-	++ships[base][day];
+	map<int, int> &record = ships[base];
+	++record[day];
+	Compact(record, today);
 }
 
 
@@ -204,6 +220,7 @@ void Depreciation::Buy(const Outfit *outfit, int day, Depreciation *source)
 	if(outfit->Get("installable") < 0.)
 		return;
 
+	const int today = day;
 	if(source)
 	{
 		// Check if the source has any instances of this outfit.
@@ -223,7 +240,9 @@ void Depreciation::Buy(const Outfit *outfit, int day, Depreciation *source)
 	}
 
 	// Increment our count for this outfit on this day.
-	++outfits[outfit][day];
+	map<int, int> &record = outfits[outfit];
+	++record[day];
+	Compact(record, today);
 }
 
 
@@ -316,6 +335,28 @@ int Depreciation::Sell(map<int, int> &record) const
 
 
 
+// Merge all the records of items that are fully depreciated, so that an item
+// that is bought and sold every day does not keep adding more of them.
+void Depreciation::Compact(map<int, int> &record, int day) const
+{
+	const int oldest = day - MaxAge();
+	auto end = record.upper_bound(oldest);
+	// Nothing needs to be done if there are no such records, or if they have
+	// already been merged into one.
+	if(end == record.begin() || (isStock && next(record.begin()) == end && record.begin()->first == oldest))
+		return;
+
+	int depreciated = 0;
+	for(auto it = record.begin(); it != end; ++it)
+		depreciated += it->second;
+	record.erase(record.begin(), end);
+	// The player's fleet treats items with no record as fully depreciated.
+	if(isStock && depreciated)
+		record[oldest] = depreciated;
+}
+
+
+
 // Calculate depreciation for some number of items.
 double Depreciation::Depreciate(const map<int, int> &record, int day, int count) const
 {
@@ -66,6 +66,8 @@ private:
 	// "Sell" an item, removing it from the given record and returning the base
 	// day for its depreciation.
 	int Sell(std::map<int, int> &record) const;
+	// Merge the records of all the items that are fully depreciated on the given day.
+	void Compact(std::map<int, int> &record, int day) const;
 	// Calculate depreciation:
 	double Depreciate(const std::map<int, int> &record, int day, int count = 1) const;
 	double Depreciate(int age) const;
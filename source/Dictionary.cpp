@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "StringInterner.h"
 
+#include <array>
 #include <cstring>
 #include <mutex>
 #include <set>
@@ -37,6 +38,10 @@ namespace {
 		while(low != high)
 		{
 			size_t mid = (low + high) / 2;
+			// The keys are interned, so if the given key is as well, it can be
+			// found without comparing any characters.
+			if(key == v[mid].first)
+				return make_pair(mid, true);
 			int cmp = strcmp(key, v[mid].first);
 			if(!cmp)
 				return make_pair(mid, true);
@@ -48,6 +53,30 @@ namespace {
 		}
 		return make_pair(low, false);
 	}
+
+	// Find which key, if any, the given interned string is the name of.
+	int FindKey(const char *interned)
+	{
+		using Names = array<const char *, ATTRIBUTE_KEY_NAMES.size()>;
+		static const Names names = []() -> Names
+		{
+			Names result;
+			for(size_t i = 0; i < result.size(); ++i)
+				result[i] = StringInterner::Intern(ATTRIBUTE_KEY_NAMES[i]);
+			return result;
+		}();
+		for(size_t i = 0; i < names.size(); ++i)
+			if(names[i] == interned)
+				return i;
+		return -1;
+	}
+}
+
+
+
+Dictionary::Dictionary() noexcept
+{
+	keyIndex.fill(-1);
 }
 
 
@@ -58,7 +87,15 @@ double &Dictionary::operator[](const char *key)
 	if(pos.second)
 		return data()[pos.first].second;
 
-	return insert(begin() + pos.first, make_pair(StringInterner::Intern(key), 0.))->second;
+	// Inserting the new key moves every key after it back by one.
+	for(int &index : keyIndex)
+		if(index >= static_cast<int>(pos.first))
+			++index;
+	const char *interned = StringInterner::Intern(key);
+	const int attributeKey = FindKey(interned);
+	if(attributeKey >= 0)
+		keyIndex[attributeKey] = pos.first;
+	return insert(begin() + pos.first, make_pair(interned, 0.))->second;
 }
 
 
@@ -88,6 +125,15 @@ double Dictionary::Get(const string &key) const
 void Dictionary::Erase(const char *key)
 {
 	auto [pos, exists] = Search(key, *this);
-	if(exists)
-		erase(next(this->begin(), pos));
+	if(!exists)
+		return;
+
+	erase(next(this->begin(), pos));
+	for(int &index : keyIndex)
+	{
+		if(index == static_cast<int>(pos))
+			index = -1;
+		else if(index > static_cast<int>(pos))
+			--index;
+	}
 }
@@ -15,6 +15,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "AttributeKey.h"
+
+#include <array>
 #include <string>
 #include <utility>
 #include <vector>
@@ -24,15 +27,19 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // This class stores a mapping from character string keys to values, in a way
 // that prioritizes fast lookup time at the expense of longer construction time
 // compared to an STL map. That makes it suitable for ship attributes, which are
-// changed much less frequently than they are queried.
+// changed much less frequently than they are queried. The attributes that have
+// an AttributeKey can also be read through it, without any search at all.
 class Dictionary : private std::vector<std::pair<const char *, double>> {
 public:
+	Dictionary() noexcept;
+
 	// Access a key for modifying it:
 	double &operator[](const char *key);
 	double &operator[](const std::string &key);
 	// Get the value of a key, or 0 if it does not exist:
 	double Get(const char *key) const;
 	double Get(const std::string &key) const;
+	double Get(AttributeKey key) const noexcept;
 	// Erase the given element.
 	void Erase(const char *key);
 
@@ -40,4 +47,18 @@ public:
 	using std::vector<std::pair<const char *, double>>::empty;
 	using std::vector<std::pair<const char *, double>>::begin;
 	using std::vector<std::pair<const char *, double>>::end;
+
+
+private:
+	// The index in the vector of each attribute that has a key, or -1 if this
+	// dictionary does not contain it.
+	std::array<int, static_cast<size_t>(AttributeKey::COUNT)> keyIndex;
 };
+
+
+
+inline double Dictionary::Get(AttributeKey key) const noexcept
+{
+	const int index = keyIndex[static_cast<size_t>(key)];
+	return index < 0 ? 0. : data()[index].second;
+}
@@ -0,0 +1,191 @@
+/* DiskCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DiskCache.h"
+
+#include "Files.h"
+#include "GameVersion.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// Leave room for the compressed textures of every sprite in the game and
+	// in a few large plugins, which are by far the largest cached files.
+	constexpr uintmax_t BUDGET = 2ull << 30;
+
+	// The file that records which version of the game wrote the cache.
+	const string VERSION_FILE = "version.txt";
+
+	mutex statisticsMutex;
+	// The number of hits and misses of each kind of cached file.
+	map<string, pair<int64_t, int64_t>> statistics;
+
+	string ToHex(uint64_t value)
+	{
+		static const char DIGITS[] = "0123456789abcdef";
+		string result(16, '0');
+		for(int i = 15; i >= 0; --i, value >>= 4)
+			result[i] = DIGITS[value & 0xF];
+		return result;
+	}
+
+	// Create the cache folder the first time it is used. If it was written by a
+	// different version of the game, none of its files can be trusted, so they
+	// are deleted rather than each kind of file having to check the version.
+	const filesystem::path &Directory()
+	{
+		static const filesystem::path directory = Files::Config() / "cache";
+		static once_flag checked;
+		call_once(checked, []() -> void
+		{
+			error_code error;
+			filesystem::create_directories(directory, error);
+
+			const string version = GameVersion::Running().ToString();
+			if(Files::Read(directory / VERSION_FILE) == version)
+				return;
+			for(const auto &entry : filesystem::directory_iterator(directory, error))
+				filesystem::remove_all(entry.path(), error);
+			DiskCache::Store(directory / VERSION_FILE, version);
+		});
+		return directory;
+	}
+}
+
+
+
+filesystem::path DiskCache::Path(const string &name)
+{
+	return Directory() / name;
+}
+
+
+
+filesystem::path DiskCache::Path(uint64_t key, const string &extension)
+{
+	return Path(ToHex(key) + extension);
+}
+
+
+
+// 64-bit FNV-1a, which is fast enough to hash every changed source file.
+uint64_t DiskCache::Hash(string_view data, uint64_t hash)
+{
+	for(char c : data)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+
+
+bool DiskCache::Store(const filesystem::path &path, string_view data)
+{
+	filesystem::path temporary = path;
+	temporary += '.' + to_string(hash<thread::id>{}(this_thread::get_id())) + ".tmp";
+	{
+		ofstream stream(temporary, ios::out | ios::binary | ios::trunc);
+		if(!stream.write(data.data(), data.size()))
+			return false;
+	}
+	error_code error;
+	filesystem::rename(temporary, path, error);
+	if(!error)
+		return true;
+	filesystem::remove(temporary, error);
+	return false;
+}
+
+
+
+void DiskCache::Hit(const char *kind, const filesystem::path &path)
+{
+	// The modification time of each cached file is when it was last used, so
+	// that trimming the cache removes the ones that have gone unused longest.
+	error_code error;
+	filesystem::last_write_time(path, filesystem::file_time_type::clock::now(), error);
+
+	lock_guard<mutex> lock(statisticsMutex);
+	++statistics[kind].first;
+}
+
+
+
+void DiskCache::Miss(const char *kind)
+{
+	lock_guard<mutex> lock(statisticsMutex);
+	++statistics[kind].second;
+}
+
+
+
+string DiskCache::Report()
+{
+	lock_guard<mutex> lock(statisticsMutex);
+	string out = "Cached files used and missed:\n";
+	for(const auto &[kind, counts] : statistics)
+		out += "  " + kind + ": " + to_string(counts.first) + " used, " + to_string(counts.second) + " missed\n";
+	return out;
+}
+
+
+
+void DiskCache::Trim()
+{
+	vector<pair<filesystem::file_time_type, filesystem::path>> files;
+	uintmax_t total = 0;
+	error_code error;
+	for(const auto &entry : filesystem::directory_iterator(Directory(), error))
+	{
+		if(!entry.is_regular_file(error) || entry.path().filename() == VERSION_FILE)
+			continue;
+		const uintmax_t size = entry.file_size(error);
+		if(error)
+			continue;
+		total += size;
+		files.emplace_back(entry.last_write_time(error), entry.path());
+	}
+	if(total <= BUDGET)
+		return;
+
+	sort(files.begin(), files.end());
+	size_t removed = 0;
+	for(const auto &[time, path] : files)
+	{
+		if(total <= BUDGET)
+			break;
+		const uintmax_t size = filesystem::file_size(path, error);
+		if(!error && filesystem::remove(path, error))
+		{
+			total -= size;
+			++removed;
+		}
+	}
+	Logger::Log("Removed " + to_string(removed) + " of the least recently used files from the cache.",
+		Logger::Level::INFO);
+}
@@ -0,0 +1,70 @@
+/* DiskCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+
+// The "cache" folder of the config directory, which is shared by everything
+// that stores the results of slow work between launches: parsed data files,
+// collision masks, compressed textures, shader programs and translation
+// catalogs. Each kind of cached file still checks that it is up to date on its
+// own, but this takes care of what they have in common: where the files go,
+// writing them so that a partial file is never read, throwing them all away
+// when a different version of the game runs, keeping their total size within a
+// budget, and counting how often each kind of file was found.
+class DiskCache {
+public:
+	// Get the path of the cached file with the given name.
+	static std::filesystem::path Path(const std::string &name);
+	// Get the path of a cached file that is named after the given key.
+	static std::filesystem::path Path(uint64_t key, const std::string &extension);
+
+	// Hash the given data, continuing from the given hash if there is one.
+	static uint64_t Hash(std::string_view data, uint64_t hash = 14695981039346656037ull);
+	// Hash the bytes of a plain value, such as a size or a timestamp.
+	template<class Type>
+	static uint64_t HashValue(const Type &value, uint64_t hash = 14695981039346656037ull);
+
+	// Write the given data to a cached file. This is done through a temporary
+	// file, so that a partially written file is never read. Failing to write
+	// it is not an error, since whatever was cached can always be made again.
+	static bool Store(const std::filesystem::path &path, std::string_view data);
+
+	// Count a cached file of the given kind as having been used, or as having
+	// been missing or out of date. The kind must be a string literal.
+	static void Hit(const char *kind, const std::filesystem::path &path);
+	static void Miss(const char *kind);
+	// A table of how many cached files of each kind were used and missed.
+	static std::string Report();
+
+	// Delete the least recently used files until the cache is within its budget.
+	static void Trim();
+};
+
+
+
+template<class Type>
+uint64_t DiskCache::HashValue(const Type &value, uint64_t hash)
+{
+	static_assert(std::is_trivially_copyable_v<Type>, "Only plain values can be hashed by their bytes.");
+	return Hash(std::string_view(reinterpret_cast<const char *>(&value), sizeof(value)), hash);
+}
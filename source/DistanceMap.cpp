@@ -23,10 +23,84 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 #include "Wormhole.h"
 
+#include <algorithm>
+#include <cstdint>
+
 using namespace std;
 
 
 
+class DistanceMap::Scratch {
+public:
+	// Start a new search.
+	void Begin();
+	// Check whether the search has found a route to the system with this index.
+	bool Has(int index) const;
+	// Record the best route found so far to the given system.
+	void Set(const System &system, const RouteEdge &edge);
+
+
+public:
+	// The best route found so far to each system, by the system's index. An
+	// entry is only part of the current search if its stamp matches.
+	vector<RouteEdge> edges;
+	vector<const System *> systems;
+	vector<uint32_t> stamps;
+	uint32_t stamp = 0;
+	// The indices of the systems that the current search has reached.
+	vector<int> reached;
+
+	// 'edgesTodo' is a heap of unfinished candidate Edges - Only the 'prev' value
+	// is up-to-date. Other values are one step behind, awaiting an update.
+	// The front() value is the best route among uncertain systems. Once
+	// popped, that's the best route to that system - and then adjacent links
+	// from that system are processed, which will build upon the popped Edge.
+	vector<RouteEdge> edgesTodo;
+};
+
+
+
+void DistanceMap::Scratch::Begin()
+{
+	// When the stamp wraps around, old stamps could match again.
+	if(!++stamp)
+	{
+		fill(stamps.begin(), stamps.end(), 0);
+		stamp = 1;
+	}
+	reached.clear();
+	edgesTodo.clear();
+}
+
+
+
+bool DistanceMap::Scratch::Has(int index) const
+{
+	return static_cast<size_t>(index) < stamps.size() && stamps[index] == stamp;
+}
+
+
+
+void DistanceMap::Scratch::Set(const System &system, const RouteEdge &edge)
+{
+	const size_t index = system.Index();
+	if(index >= stamps.size())
+	{
+		edges.resize(index + 1);
+		systems.resize(index + 1);
+		stamps.resize(index + 1);
+	}
+	if(stamps[index] != stamp)
+	{
+		stamps[index] = stamp;
+		systems[index] = &system;
+		reached.push_back(index);
+	}
+	edges[index] = edge;
+}
+
+
+
 // Find paths from the given system. If the given maximum count is above zero,
 // it is a limit on how many systems should be returned. If it is below zero
 // it specifies the maximum distance away that paths should be found.
@@ -99,10 +173,22 @@ DistanceMap::DistanceMap(const Ship &ship, const System &destination, const Play
 
 
 
+// Calculate the paths for the given NPC ship to every system it can reach,
+// so that RoutePlans to any of them can be made without searching again.
+DistanceMap::DistanceMap(const Ship &ship)
+	: center(ship.GetSystem())
+{
+	Init(&ship);
+	// The ship is only needed while searching.
+	this->ship = nullptr;
+}
+
+
+
 // Find out if the given system is reachable
 bool DistanceMap::HasRoute(const System &target) const
 {
-	return route.contains(&target);
+	return Find(&target);
 }
 
 
@@ -110,8 +196,8 @@ bool DistanceMap::HasRoute(const System &target) const
 // Find out how many days away the given system is.
 int DistanceMap::Days(const System &target) const
 {
-	auto it = route.find(&target);
-	return (it == route.end() ? -1 : it->second.days);
+	const RouteEdge *edge = Find(&target);
+	return (edge ? edge->days : -1);
 }
 
 
@@ -120,8 +206,8 @@ int DistanceMap::Days(const System &target) const
 set<const System *> DistanceMap::Systems() const
 {
 	set<const System *> systems;
-	for(const auto &it : route)
-		systems.insert(it.first);
+	for(const Step &step : route)
+		systems.insert(step.system);
 	return systems;
 }
 
@@ -138,7 +224,7 @@ vector<const System *> DistanceMap::Plan(const System &target) const
 	while(nextStep != center)
 	{
 		plan.push_back(nextStep);
-		nextStep = route.at(nextStep).prev;
+		nextStep = Find(nextStep)->prev;
 	}
 	return plan;
 }
@@ -153,9 +239,30 @@ void DistanceMap::Init(const Ship *ship)
 	if(!center || (ship && ship->IsRestrictedFrom(*center)) || center == destination)
 		return;
 
+	thread_local Scratch threadScratch;
+	scratch = &threadScratch;
+	scratch->Begin();
+
+	Search(ship);
+
+	// Keep only the systems that were reached, in order of their indices.
+	sort(scratch->reached.begin(), scratch->reached.end());
+	route.reserve(scratch->reached.size());
+	for(int index : scratch->reached)
+		route.push_back({scratch->systems[index], scratch->edges[index]});
+	scratch = nullptr;
+}
+
+
+
+void DistanceMap::Search(const Ship *ship)
+{
 	// To get to the starting point, there is no previous system,
 	// and it takes no fuel or days.
-	route[center] = RouteEdge();
+	// Systems that have not been indexed are not part of the map.
+	if(center->Index() < 0)
+		return;
+	scratch->Set(*center, RouteEdge());
 	if(!maxDays)
 		return;
 
@@ -190,7 +297,8 @@ void DistanceMap::Init(const Ship *ship)
 	// jumps, break the tie by using how "dangerous" the route is.
 
 	// Add this fake edge "from center" so it's the first popped value.
-	edgesTodo.emplace(center);
+	vector<RouteEdge> &edgesTodo = scratch->edgesTodo;
+	edgesTodo.emplace_back(center);
 	// Find all edges from that route, add better routes to the map, and continue.
 	while(maxSystems && !edgesTodo.empty())
 	{
@@ -201,8 +309,9 @@ void DistanceMap::Init(const Ship *ship)
 		// are built upon to determine if this new edge from 'prev' to 'X' is
 		// the best. If so, it's added as route[X], and a copy is added to
 		// edgesTodo to process later.
-		RouteEdge nextEdge = edgesTodo.top();
-		edgesTodo.pop();
+		pop_heap(edgesTodo.begin(), edgesTodo.end());
+		RouteEdge nextEdge = edgesTodo.back();
+		edgesTodo.pop_back();
 
 		const System *currentSystem = nextEdge.prev;
 
@@ -270,7 +379,7 @@ bool DistanceMap::Propagate(const RouteEdge &curEdge)
 	// JumpNeighbors will use the system's jump range, overriding jumpRangeMax.
 	// JumpNeighbors also includes normal hyperspace links. Remember that jump drives
 	// can use hyperlanes, though it still costs more fuel.
-	auto links = currentSystem->Links();
+	const auto &links = currentSystem->Links();
 	for(const System *link : (jumpRangeMax > 0 ? currentSystem->JumpNeighbors(jumpRangeMax) : links))
 	{
 		// Copy the edge to be used for this link, and build upon its fields.
@@ -312,8 +421,11 @@ bool DistanceMap::Propagate(const RouteEdge &curEdge)
 // Check if we already have a better path to the given system.
 bool DistanceMap::HasBetter(const System &to, const RouteEdge &edge)
 {
-	auto it = route.find(&to);
-	return (it != route.end() && !(it->second < edge));
+	// Systems that have not been indexed cannot be part of a route.
+	const int index = to.Index();
+	if(index < 0)
+		return true;
+	return scratch->Has(index) && !(scratch->edges[index] < edge);
 }
 
 
@@ -323,13 +435,28 @@ void DistanceMap::Add(const System &to, RouteEdge edge)
 {
 	// This is the best path we have found so far to this system, but it is
 	// conceivable that a better one will be found.
-	route[&to] = edge;
+	scratch->Set(to, edge);
 
 	// Start building upon this edge and enqueue - this copy of edge
 	// is in an incomplete state and needs to be dequeued and worked on.
 	edge.prev = &to;
 	if(maxDays < 0 || edge.days < maxDays)
-		edgesTodo.emplace(edge);
+	{
+		scratch->edgesTodo.push_back(edge);
+		push_heap(scratch->edgesTodo.begin(), scratch->edgesTodo.end());
+	}
+}
+
+
+
+const RouteEdge *DistanceMap::Find(const System *system) const
+{
+	if(!system)
+		return nullptr;
+	const int index = system->Index();
+	auto it = lower_bound(route.begin(), route.end(), index,
+		[](const Step &step, int index) { return step.system->Index() < index; });
+	return (it != route.end() && it->system == system) ? &it->edge : nullptr;
 }
 
 
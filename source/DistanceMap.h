@@ -18,10 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "RouteEdge.h"
 #include "WormholeStrategy.h"
 
-#include <map>
-#include <queue>
 #include <set>
-#include <utility>
 #include <vector>
 
 class PlayerInfo;
@@ -71,11 +68,17 @@ private:
 	// Calculate the path for the given ship to get to the given system. The
 	// ship will use a jump drive or hyperdrive depending on what it has.
 	explicit DistanceMap(const Ship &ship, const System &destination, const PlayerInfo *player = nullptr);
+	// Calculate the paths for the given NPC ship to every system it can reach,
+	// so that RoutePlans to any of them can be made without searching again.
+	explicit DistanceMap(const Ship &ship);
 
 	// Depending on the capabilities of the given ship, use hyperspace paths,
 	// jump drive paths, or both to find the shortest route. Bail out if the
 	// destination system or the maximum count is reached.
 	void Init(const Ship *ship = nullptr);
+	void Search(const Ship *ship);
+	// Get the final route to the given system, or nullptr if there is none.
+	const RouteEdge *Find(const System *system) const;
 	// Add the given links to the map. Return false if an end condition is hit.
 	bool Propagate(const RouteEdge &curEdge);
 	// Check if we already have a better path to the given system.
@@ -88,17 +91,26 @@ private:
 	bool CheckLink(const System &from, const System &to, bool linked, bool useJump, double &fuelCost) const;
 
 
+private:
+	// The arrays that a search works in, which are reused by every search on
+	// the same thread.
+	class Scratch;
+
+	// A system that can be reached, and the last step of the route to it.
+	class Step {
+	public:
+		const System *system;
+		RouteEdge edge;
+	};
+
+
 private:
 	// Final route, each Edge pointing to the previous step along the route.
-	std::map<const System *, RouteEdge> route;
+	// The steps are sorted by the index of their system.
+	std::vector<Step> route;
 
 	// Variables only used during construction:
-	// 'edgesTodo' holds unfinished candidate Edges - Only the 'prev' value
-	// is up-to-date. Other values are one step behind, awaiting an update.
-	// The top() value is the best route among uncertain systems. Once
-	// popped, that's the best route to that system - and then adjacent links
-	// from that system are processed, which will build upon the popped Edge.
-	std::priority_queue<RouteEdge> edgesTodo;
+	Scratch *scratch = nullptr;
 	const PlayerInfo *player = nullptr;
 	const System *center = nullptr;
 	int maxSystems = -1;
@@ -110,4 +122,5 @@ private:
 	const Ship *ship = nullptr;
 
 	friend class RoutePlan;
+	friend class RouteTable;
 };
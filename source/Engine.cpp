@@ -36,10 +36,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameData.h"
 #include "Gamerules.h"
 #include "Government.h"
+#include "shader/GpuProfiler.h"
 #include "Hazard.h"
 #include "Interface.h"
 #include "Logger.h"
 #include "MapPanel.h"
+#include "MemoryProfile.h"
 #include "image/Mask.h"
 #include "Messages.h"
 #include "Minable.h"
@@ -53,6 +55,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PlayerInfo.h"
 #include "shader/PointerShader.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Projectile.h"
 #include "Random.h"
 #include "shader/RingShader.h"
@@ -78,6 +81,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <iterator>
 #include <map>
 #include <string>
 
@@ -110,8 +115,27 @@ namespace {
 	constexpr auto Prune = [](auto &objects) { erase_if(objects,
 			[](const auto &obj) { return obj.ShouldBeRemoved(); }); };
 
-	template<class Type>
-	void Append(vector<Type> &objects, vector<Type> &added)
+	// Add the given value to an FNV-1a hash.
+	void AddToHash(uint64_t &hash, double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		for(int i = 0; i < 8; ++i)
+		{
+			hash ^= (bits >> (8 * i)) & 0xFF;
+			hash *= 0x100000001B3ull;
+		}
+	}
+
+	// How many projectiles each thread handles at a time when finding collisions.
+	constexpr size_t COLLISION_CHUNK_SIZE = 16;
+	// How many ships each thread handles at a time when filling in the radar.
+	constexpr size_t RADAR_CHUNK_SIZE = 64;
+	// How many projectiles and visuals each thread adds to the draw list at a time.
+	constexpr size_t DRAW_CHUNK_SIZE = 512;
+
+	template<class Type, class Container>
+	void Append(vector<Type> &objects, Container &added)
 	{
 		objects.insert(objects.end(), make_move_iterator(added.begin()), make_move_iterator(added.end()));
 		added.clear();
@@ -125,7 +149,7 @@ namespace {
 
 		// If this ship has no name, show its model name instead.
 		string tag;
-		const string &gov = Translation::TrGovernment(ship->GetGovernment()->DisplayName());
+		const string &gov = ship->GetGovernment()->TranslatedDisplayName();
 		if(!ship->GivenName().empty())
 			tag = gov + " " + ship->Noun() + " \"" + ship->GivenName() + "\": ";
 		else
@@ -251,7 +275,7 @@ namespace {
 
 Engine::Engine(PlayerInfo &player)
 	: player(player), ai(player, ships, asteroids.Minables(), flotsam),
-	ammoDisplay(player), minimap(player), shipCollisions(256u, 32u, CollisionType::SHIP)
+	ammoDisplay(player), minimap(player), shipCollisions(CollisionType::SHIP)
 {
 	zoom.base = Preferences::ViewZoom();
 	zoom.modifier = Preferences::Has("Landing zoom") ? 2. : 1.;
@@ -270,6 +294,8 @@ Engine::Engine(PlayerInfo &player)
 	}
 	queue.Wait();
 	queue.ProcessSyncTasks();
+	// The sprites of the systems the player may visit next can load in the background.
+	SpriteLoadManager::Prefetch(asyncQueue, player);
 
 	// Figure out what planet the player is landed on, if any.
 	const StellarObject *object = player.GetStellarObject();
@@ -401,7 +427,7 @@ void Engine::Place()
 	}
 	// Move any ships that were randomly spawned into the main list, now
 	// that all special ships have been repositioned.
-	ships.splice(ships.end(), newShips);
+	Append(ships, newShips);
 
 	camera.SnapTo(flagship->Center());
 
@@ -493,7 +519,10 @@ void Engine::Place(const list<NPC> &npcs, const shared_ptr<Ship> &flagship)
 void Engine::Wait()
 {
 	queue.Wait();
-	currentDrawBuffer = currentCalcBuffer;
+	// If the last step skipped preparing its draw buffers, keep drawing the
+	// ones from the step before it.
+	if(isPreparingDraw)
+		currentDrawBuffer = currentCalcBuffer;
 }
 
 
@@ -506,7 +535,7 @@ void Engine::Step(bool isActive)
 
 	// Process any outstanding sprites that need to be uploaded to the GPU.
 	queue.ProcessSyncTasks();
-	asyncQueue.ProcessSyncTasks();
+	asyncQueue.ProcessSyncTasks(TaskQueue::BACKGROUND_SYNC_TIME);
 
 	// A recently triggered event may have caused new objects to appear in the current system.
 	// Ensure that they are loaded.
@@ -558,6 +587,7 @@ void Engine::Step(bool isActive)
 		else
 			ai.UpdateKeys(player, activeCommands);
 	}
+	stepCommands = activeCommands;
 
 	wasActive = isActive;
 	Audio::Update(camera.Center());
@@ -597,7 +627,7 @@ void Engine::Step(bool isActive)
 
 	outlines.clear();
 	const Color &cloakColor = *GameData::Colors().Get("cloak highlight");
-	if(Preferences::Has("Cloaked ship outlines"))
+	if(isThisStepDrawn && Preferences::Has("Cloaked ship outlines"))
 		for(const auto &ship : player.Ships())
 		{
 			if(ship->IsParked() || ship->GetSystem() != player.GetSystem() || ship->Cloaking() == 0.)
@@ -608,7 +638,7 @@ void Engine::Step(bool isActive)
 		}
 
 	// Add the flagship outline last to distinguish the flagship from other ships.
-	if(flagship && !flagship->IsDestroyed() && Preferences::Has("Highlight player's flagship"))
+	if(isThisStepDrawn && flagship && !flagship->IsDestroyed() && Preferences::Has("Highlight player's flagship"))
 	{
 		outlines.emplace_back(flagship->GetSprite(),
 			(flagship->Center() - camera.Center()) * zoom,
@@ -700,7 +730,7 @@ void Engine::Step(bool isActive)
 	statuses.clear();
 	missileLabels.clear();
 	turretOverlays.clear();
-	if(isActive)
+	if(isActive && isThisStepDrawn)
 	{
 		// Create the status overlays.
 		CreateStatusOverlays();
@@ -888,7 +918,7 @@ void Engine::Step(bool isActive)
 		if(!target->GetGovernment())
 			info.SetString("target government", Translation::Tr("ui.no_government"));
 		else
-			info.SetString("target government", Translation::TrGovernment(target->GetGovernment()->DisplayName()));
+			info.SetString("target government", target->GetGovernment()->TranslatedDisplayName());
 		info.SetString("mission target", target->GetPersonality().IsTarget() ? "(mission target)" : "");
 
 		// Only update the "active" state shown for the target if it is
@@ -1153,8 +1183,26 @@ void Engine::Go()
 {
 	if(!timePaused)
 		++step;
-	currentCalcBuffer = currentCalcBuffer ? 0 : 1;
-	queue.Run([this] { CalculateStep(); });
+	currentCalcBuffer = currentDrawBuffer ? 0 : 1;
+	isPreparingDraw = isNextStepDrawn;
+	isThisStepDrawn = true;
+	isNextStepDrawn = true;
+	queue.Run([this]
+		{
+			MemoryProfile::Scope memoryScope(MemoryProfile::Tag::ENGINE);
+			const int64_t allocations = MemoryProfile::ThreadAllocations();
+			CalculateStep();
+			stepAllocations = MemoryProfile::ThreadAllocations() - allocations;
+		});
+}
+
+
+
+// Say whether the results of the coming steps will be drawn.
+void Engine::SetDrawnSteps(bool isThisStepDrawn, bool isNextStepDrawn)
+{
+	this->isThisStepDrawn = isThisStepDrawn;
+	this->isNextStepDrawn = isNextStepDrawn;
 }
 
 
@@ -1175,9 +1223,66 @@ void Engine::GiveCommand(const Command &command)
 
 
 
+// Get the commands that the player gave for the step that Step() prepared,
+// so that they can be recorded and given again in a replay.
+const Command &Engine::StepCommands() const
+{
+	return stepCommands;
+}
+
+
+
+// Get a checksum of the state of every ship and projectile, used to check
+// that a benchmark simulated exactly the same thing every time it ran.
+uint64_t Engine::StateChecksum() const
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	AddToHash(hash, step);
+	for(const shared_ptr<Ship> &ship : ships)
+	{
+		AddToHash(hash, ship->Position().X());
+		AddToHash(hash, ship->Position().Y());
+		AddToHash(hash, ship->Velocity().X());
+		AddToHash(hash, ship->Velocity().Y());
+		AddToHash(hash, ship->Facing().Degrees());
+		AddToHash(hash, ship->Shields());
+		AddToHash(hash, ship->Hull());
+		AddToHash(hash, ship->Energy());
+		AddToHash(hash, ship->Fuel());
+	}
+	for(const Projectile &projectile : projectiles)
+	{
+		AddToHash(hash, projectile.Position().X());
+		AddToHash(hash, projectile.Position().Y());
+		AddToHash(hash, projectile.Velocity().X());
+		AddToHash(hash, projectile.Velocity().Y());
+	}
+	return hash;
+}
+
+
+
+// Get every ship in the current system, used to report the outcome of a
+// benchmark's battle. Only safe to call while the calculations are paused.
+const vector<shared_ptr<Ship>> &Engine::Ships() const
+{
+	return ships;
+}
+
+
+
+// Get how many allocations the last step of calculations made, if the game
+// was built to count them.
+int64_t Engine::StepAllocations() const
+{
+	return stepAllocations;
+}
+
+
+
 // Pass the list of game events to MainPanel for handling by the player, and any
 // UI element generation.
-list<ShipEvent> &Engine::Events()
+vector<ShipEvent> &Engine::Events()
 {
 	return events;
 }
@@ -1187,7 +1292,10 @@ list<ShipEvent> &Engine::Events()
 // Draw a frame.
 void Engine::Draw() const
 {
-	++uiStep;
+	Profiler::Scope profilerScope("Engine::Draw");
+	// Frames drawn in between steps should not speed up blinking UI elements.
+	if(!drawProgress)
+		++uiStep;
 
 	Point motionBlur = camera.Velocity();
 	double baseBlur = Preferences::Has("Render motion blur") ? 1. : 0.;
@@ -1199,83 +1307,104 @@ void Engine::Draw() const
 	else
 		motionBlur *= baseBlur;
 
-	GameData::Background().Draw(motionBlur,
-		(player.Flagship() ? player.Flagship()->GetSystem() : player.GetSystem()));
+	{
+		GpuProfiler::Pass pass("Star field");
+		GameData::Background().Draw(motionBlur,
+			(player.Flagship() ? player.Flagship()->GetSystem() : player.GetSystem()), timePaused ? 0. : drawProgress);
+	}
 
 	static const Set<Color> &colors = GameData::Colors();
 	const Interface *hud = GameData::Interfaces().Get("hud");
 
 	// Draw any active planet labels.
 	if(Preferences::Has("Show planet labels"))
+	{
+		GpuProfiler::Pass pass("Overlays");
 		for(const PlanetLabel &label : labels)
 			label.Draw();
-
-	draw[currentDrawBuffer].Draw();
-	batchDraw[currentDrawBuffer].Draw();
-
-	for(const auto &it : statuses)
-	{
-		static const Color color[16] = {
-			*colors.Get("overlay flagship shields"),
-			*colors.Get("overlay friendly shields"),
-			*colors.Get("overlay hostile shields"),
-			*colors.Get("overlay neutral shields"),
-			*colors.Get("overlay outfit scan"),
-			*colors.Get("overlay outfit scan out of range"),
-			*colors.Get("overlay flagship hull"),
-			*colors.Get("overlay friendly hull"),
-			*colors.Get("overlay hostile hull"),
-			*colors.Get("overlay neutral hull"),
-			*colors.Get("overlay cargo scan"),
-			*colors.Get("overlay cargo scan out of range"),
-			*colors.Get("overlay flagship disabled"),
-			*colors.Get("overlay friendly disabled"),
-			*colors.Get("overlay hostile disabled"),
-			*colors.Get("overlay neutral disabled")
-		};
-		Point pos = it.position * zoom;
-		double radius = it.radius * zoom;
-		int colorIndex = static_cast<int>(it.type);
-		if(it.outer > 0.)
-			RingShader::Draw(pos, radius + 3., 1.5f, it.outer,
-				Color::Multiply(it.alpha, color[colorIndex]), 0.f, it.angle);
-		double dashes = (it.type >= Status::Type::SCAN) ? 0. : 20. * min<double>(1., zoom);
-		colorIndex += static_cast<int>(Status::Type::COUNT);
-		if(it.inner > 0.)
-			RingShader::Draw(pos, radius, 1.5f, it.inner,
-				Color::Multiply(it.alpha, color[colorIndex]), dashes, it.angle);
-		colorIndex += static_cast<int>(Status::Type::COUNT);
-		if(it.disabled > 0.)
-			RingShader::Draw(pos, radius, 1.5f, it.disabled,
-				Color::Multiply(it.alpha, color[colorIndex]), dashes, it.angle);
-	}
-
-	// Draw labels on missiles
-	for(const AlertLabel &label : missileLabels)
-		label.Draw();
-
-	for(const auto &outline : outlines)
-	{
-		if(!outline.sprite)
-			continue;
-		Point size(outline.sprite->Width(), outline.sprite->Height());
-		OutlineShader::Draw(outline.sprite, outline.position, size, outline.color, outline.unit, outline.frame);
 	}
 
-	// Draw turret overlays.
-	if(!turretOverlays.empty())
 	{
-		const Color &blindspot = *GameData::Colors().Get("overlay turret blindspot");
-		const Color &normal = *GameData::Colors().Get("overlay turret");
-		PointerShader::Bind();
-		for(const TurretOverlay &it : turretOverlays)
-			PointerShader::Add(it.position, it.angle, 8 * it.scale, 24 * it.scale, 24 * it.scale,
-				it.isBlind ? blindspot : normal);
-		PointerShader::Unbind();
+		GpuProfiler::Pass pass("Draw list");
+		draw[currentDrawBuffer].Draw(timePaused ? 0. : drawProgress);
+	}
+	{
+		GpuProfiler::Pass pass("Batch draw list");
+		batchDraw[currentDrawBuffer].Draw(timePaused ? 0. : drawProgress);
 	}
 
-	if(flash)
-		FillShader::Fill(Point(), Screen::Dimensions(), Color(flash, flash));
+	// The status rings, turret overlays, and target crosshairs are each drawn
+	// with a single batched call, since there may be hundreds of them.
+	static vector<RingShader::Item> ringItems;
+	static vector<PointerShader::Item> pointerItems;
+	{
+		GpuProfiler::Pass pass("Overlays");
+		ringItems.clear();
+		for(const auto &it : statuses)
+		{
+			static const Color color[16] = {
+				*colors.Get("overlay flagship shields"),
+				*colors.Get("overlay friendly shields"),
+				*colors.Get("overlay hostile shields"),
+				*colors.Get("overlay neutral shields"),
+				*colors.Get("overlay outfit scan"),
+				*colors.Get("overlay outfit scan out of range"),
+				*colors.Get("overlay flagship hull"),
+				*colors.Get("overlay friendly hull"),
+				*colors.Get("overlay hostile hull"),
+				*colors.Get("overlay neutral hull"),
+				*colors.Get("overlay cargo scan"),
+				*colors.Get("overlay cargo scan out of range"),
+				*colors.Get("overlay flagship disabled"),
+				*colors.Get("overlay friendly disabled"),
+				*colors.Get("overlay hostile disabled"),
+				*colors.Get("overlay neutral disabled")
+			};
+			Point pos = it.position * zoom;
+			double radius = it.radius * zoom;
+			int colorIndex = static_cast<int>(it.type);
+			if(it.outer > 0.)
+				ringItems.push_back(RingShader::Prepare(pos, radius + 3., 1.5f, it.outer,
+					Color::Multiply(it.alpha, color[colorIndex]), 0.f, it.angle));
+			double dashes = (it.type >= Status::Type::SCAN) ? 0. : 20. * min<double>(1., zoom);
+			colorIndex += static_cast<int>(Status::Type::COUNT);
+			if(it.inner > 0.)
+				ringItems.push_back(RingShader::Prepare(pos, radius, 1.5f, it.inner,
+					Color::Multiply(it.alpha, color[colorIndex]), dashes, it.angle));
+			colorIndex += static_cast<int>(Status::Type::COUNT);
+			if(it.disabled > 0.)
+				ringItems.push_back(RingShader::Prepare(pos, radius, 1.5f, it.disabled,
+					Color::Multiply(it.alpha, color[colorIndex]), dashes, it.angle));
+		}
+		RingShader::Draw(ringItems);
+
+		// Draw labels on missiles
+		for(const AlertLabel &label : missileLabels)
+			label.Draw();
+
+		for(const auto &outline : outlines)
+		{
+			if(!outline.sprite)
+				continue;
+			Point size(outline.sprite->Width(), outline.sprite->Height());
+			OutlineShader::Draw(outline.sprite, outline.position, size, outline.color, outline.unit, outline.frame);
+		}
+
+		// Draw turret overlays.
+		if(!turretOverlays.empty())
+		{
+			const Color &blindspot = *GameData::Colors().Get("overlay turret blindspot");
+			const Color &normal = *GameData::Colors().Get("overlay turret");
+			pointerItems.clear();
+			for(const TurretOverlay &it : turretOverlays)
+				pointerItems.push_back(PointerShader::Prepare(it.position, it.angle, 8 * it.scale, 24 * it.scale,
+					24 * it.scale, it.isBlind ? blindspot : normal));
+			PointerShader::Draw(pointerItems);
+		}
+
+		if(flash)
+			FillShader::Fill(Point(), Screen::Dimensions(), Color(flash, flash));
+	}
 
 	// Draw messages. Draw the most recent messages first, as some messages
 	// may be wrapped onto multiple lines.
@@ -1292,66 +1421,79 @@ void Engine::Draw() const
 	{
 		return (1000 + animationDuration - age) * .001f;
 	};
-	WrappedText messageLine(font);
-	messageLine.SetWrapWidth(messageBox.Width());
-	messageLine.SetParagraphBreak(0.);
-	Point messagePoint{messageBox.Left(), messagesReversed ? messageBox.Top() : messageBox.Bottom()};
-	for(auto it = messages.rbegin(); it != messages.rend(); ++it)
-	{
-		messageLine.Wrap(it->message);
-		int height = messageLine.Height();
-		if(messagesReversed && it == messages.rbegin())
-			messagePoint.Y() -= height;
-		// Dying messages are those scheduled for removal as duplicates.
-		bool isDying = it->deathStep >= 0;
-		int naturalAge = uiStep - it->step;
-		// New messages should fade in, while dying ones should fade out.
-		int age = isDying ? it->deathStep - uiStep : naturalAge;
-		bool isAnimating = age < animationDuration;
-		if(isAnimating)
-			height *= messageAnimation(age);
-		if(messagesReversed)
-		{
-			messagePoint.Y() += height;
-			if(messagePoint.Y() > messageBox.Bottom())
-				break;
-		}
-		else
+	{
+		GpuProfiler::Pass pass("Text");
+		WrappedText messageLine(font);
+		messageLine.SetWrapWidth(messageBox.Width());
+		messageLine.SetParagraphBreak(0.);
+		Point messagePoint{messageBox.Left(), messagesReversed ? messageBox.Top() : messageBox.Bottom()};
+		for(auto it = messages.rbegin(); it != messages.rend(); ++it)
 		{
-			messagePoint.Y() -= height;
-			if(messagePoint.Y() < messageBox.Top())
-				break;
+			messageLine.Wrap(it->message);
+			int height = messageLine.Height();
+			if(messagesReversed && it == messages.rbegin())
+				messagePoint.Y() -= height;
+			// Dying messages are those scheduled for removal as duplicates.
+			bool isDying = it->deathStep >= 0;
+			int naturalAge = uiStep - it->step;
+			// New messages should fade in, while dying ones should fade out.
+			int age = isDying ? it->deathStep - uiStep : naturalAge;
+			bool isAnimating = age < animationDuration;
+			if(isAnimating)
+				height *= messageAnimation(age);
+			if(messagesReversed)
+			{
+				messagePoint.Y() += height;
+				if(messagePoint.Y() > messageBox.Bottom())
+					break;
+			}
+			else
+			{
+				messagePoint.Y() -= height;
+				if(messagePoint.Y() < messageBox.Top())
+					break;
+			}
+			float alpha = isAnimating ? isDying ? min<double>(messageAnimation(age), naturalDecay(naturalAge))
+				: messageAnimation(age) : naturalDecay(age);
+			messageLine.Draw(messagePoint, it->category->MainColor().Additive(alpha));
 		}
-		float alpha = isAnimating ? isDying ? min<double>(messageAnimation(age), naturalDecay(naturalAge))
-			: messageAnimation(age) : naturalDecay(age);
-		messageLine.Draw(messagePoint, it->category->MainColor().Additive(alpha));
 	}
 
 	// Draw crosshairs around anything that is targeted.
-	for(const Target &target : targets)
 	{
-		Angle a = target.angle;
-		Angle da(360. / target.count);
-
-		PointerShader::Bind();
-		for(int i = 0; i < target.count; ++i)
+		GpuProfiler::Pass pass("Overlays");
+		pointerItems.clear();
+		for(const Target &target : targets)
 		{
-			PointerShader::Add(target.center * zoom, a.Unit(), 12.f, 14.f, -target.radius * zoom, target.color);
-			a += da;
+			Angle a = target.angle;
+			Angle da(360. / target.count);
+
+			for(int i = 0; i < target.count; ++i)
+			{
+				pointerItems.push_back(PointerShader::Prepare(target.center * zoom, a.Unit(), 12.f, 14.f,
+					-target.radius * zoom, target.color));
+				a += da;
+			}
 		}
-		PointerShader::Unbind();
+		PointerShader::Draw(pointerItems);
 	}
 
 	// Draw the heads-up display.
-	hud->Draw(info);
+	{
+		GpuProfiler::Pass pass("Interface");
+		hud->Draw(info);
+	}
 	if(hud->HasPoint("radar"))
 	{
+		GpuProfiler::Pass pass("Radar");
 		radar[currentDrawBuffer].Draw(
 			hud->GetPoint("radar"),
 			hud->GetValue("radar scale"),
 			hud->GetValue("radar radius"),
 			hud->GetValue("radar pointer radius"));
 	}
+	// Everything else drawn here is part of the heads-up display.
+	GpuProfiler::Pass interfacePass("Interface");
 	if(hud->HasPoint("target") && targetVector.Length() > 20.)
 	{
 		Point center = hud->GetPoint("target");
@@ -1386,6 +1528,14 @@ void Engine::Draw() const
 
 
 
+// Set how far along the current step is toward the next one.
+void Engine::SetDrawProgress(double progress)
+{
+	drawProgress = progress;
+}
+
+
+
 // Select the object the player clicked on.
 void Engine::Click(const Point &from, const Point &to, bool hasShift, bool hasControl)
 {
@@ -1470,6 +1620,8 @@ void Engine::BreakTargeting(const Government *gov)
 void Engine::EnterSystem()
 {
 	ai.Clean();
+	// The system, or the persons who may appear in it, may have changed.
+	personSystem = nullptr;
 
 	Ship *flagship = player.Flagship();
 	if(!flagship)
@@ -1507,8 +1659,9 @@ void Engine::EnterSystem()
 				usedWormhole = &object;
 		}
 	}
-	// Cull images that haven't been seen in a while.
-	SpriteLoadManager::CullOldImages(asyncQueue);
+	// Start loading the sprites of the systems the player may visit next, and
+	// make room for them by unloading images that haven't been seen in a while.
+	SpriteLoadManager::Prefetch(asyncQueue, player);
 
 	// Advance the positions of every StellarObject and update politics.
 	// Remove expired bribes, clearance, and grace periods from past fines.
@@ -1583,16 +1736,17 @@ void Engine::EnterSystem()
 				CreateWeather(hazard, stellar.Position());
 	}
 
+	const pair<double, double> raidFactors = player.RaidFleetFactors();
 	for(const auto &raidFleet : system->RaidFleets())
 	{
-		double attraction = player.RaidFleetAttraction(raidFleet, system);
+		double attraction = PlayerInfo::RaidFleetAttraction(raidFleet, system, raidFactors);
 		if(attraction > 0.)
 			for(int i = 0; i < 10; ++i)
 				if(Random::Real() < attraction)
 				{
 					raidFleet.GetFleet()->Place(*system, newShips);
 					{
-					map<string, string> rep = {{"gov", Translation::TrGovernment(raidFleet.GetFleet()->GetGovernment()->DisplayName())}};
+					map<string, string> rep = {{"gov", raidFleet.GetFleet()->GetGovernment()->TranslatedDisplayName()}};
 					Messages::Add({Translation::Tr("message.raid_attracted", rep),
 						GameData::MessageCategories().Get("high")});
 				}
@@ -1636,15 +1790,25 @@ void Engine::EnterSystem()
 
 void Engine::CalculateStep()
 {
+	Profiler::Scope profilerScope("Engine::CalculateStep");
+
+	// Each step may be calculated on a different thread. In deterministic mode,
+	// make the random numbers that this step uses depend only on which step it is.
+	if(Random::IsDeterministic())
+		Random::Seed(step);
+
 	// If there is a pending zoom update then use it
 	// because the zoom will get updated in the main thread
 	// as soon as the calculation thread is finished.
 	const double zoom = nextZoom ? nextZoom : this->zoom;
 
 	// Clear the list of objects to draw.
-	draw[currentCalcBuffer].Clear(step, zoom);
-	batchDraw[currentCalcBuffer].Clear(step, zoom);
-	radar[currentCalcBuffer].Clear();
+	if(isPreparingDraw)
+	{
+		draw[currentCalcBuffer].Clear(step, zoom);
+		batchDraw[currentCalcBuffer].Clear(step, zoom);
+		radar[currentCalcBuffer].Clear();
+	}
 
 	if(!player.GetSystem())
 		return;
@@ -1675,36 +1839,47 @@ void Engine::CalculateStep()
 			hyperspacePercentage = 0.;
 		newCamera.MoveTo(flagship->Center(), hyperspacePercentage);
 	}
-	draw[currentCalcBuffer].SetCenter(newCamera.Center(), newCamera.Velocity());
-	batchDraw[currentCalcBuffer].SetCenter(newCamera.Center());
-	radar[currentCalcBuffer].SetCenter(newCamera.Center());
+	if(isPreparingDraw)
+	{
+		draw[currentCalcBuffer].SetCenter(newCamera.Center(), newCamera.Velocity());
+		batchDraw[currentCalcBuffer].SetCenter(newCamera.Center(), newCamera.Velocity());
+		radar[currentCalcBuffer].SetCenter(newCamera.Center());
 
-	// Populate the radar.
-	FillRadar();
+		// Populate the radar.
+		FillRadar();
+	}
 
-	// Draw the planets.
-	for(const StellarObject &object : playerSystem->Objects())
-		if(object.HasSprite())
-		{
-			// Don't apply motion blur to very large planets and stars.
-			if(object.Width() >= 280.)
-				draw[currentCalcBuffer].AddUnblurred(object);
-			else
-				draw[currentCalcBuffer].Add(object);
-		}
-	// Draw the asteroids and minables.
-	asteroids.Draw(draw[currentCalcBuffer], newCamera.Center(), zoom);
-	// Draw the flotsam.
-	for(const shared_ptr<Flotsam> &it : flotsam)
-		draw[currentCalcBuffer].Add(*it);
+	Profiler::Scope drawListScope("Build draw lists");
+	if(isPreparingDraw)
+	{
+		// Draw the planets.
+		for(const StellarObject &object : playerSystem->Objects())
+			if(object.HasSprite())
+			{
+				// Don't apply motion blur to very large planets and stars.
+				if(object.Width() >= 280.)
+					draw[currentCalcBuffer].AddUnblurred(object);
+				else
+					draw[currentCalcBuffer].Add(object);
+			}
+		// Draw the asteroids and minables.
+		asteroids.Draw(draw[currentCalcBuffer], newCamera.Center(), zoom);
+		// Draw the flotsam.
+		for(const shared_ptr<Flotsam> &it : flotsam)
+			draw[currentCalcBuffer].Add(*it);
+	}
 	// Draw the ships. Skip the flagship, then draw it on top of all the others.
+	// Ships' engine sounds are played even if the step will not be drawn.
 	bool showFlagship = false;
 	for(const shared_ptr<Ship> &ship : ships)
 		if(ship->GetSystem() == playerSystem && ship->HasSprite())
 		{
 			if(ship.get() != flagship)
 			{
-				DrawShipSprites(*ship);
+				if(isPreparingDraw)
+					DrawShipSprites(*ship);
+				else
+					ship->PositionFighters();
 				if(timePaused)
 					continue;
 				if(ship->IsThrusting() && !ship->EnginePoints().empty())
@@ -1728,7 +1903,12 @@ void Engine::CalculateStep()
 		}
 
 	if(flagship && showFlagship)
-		DrawShipSprites(*flagship);
+	{
+		if(isPreparingDraw)
+			DrawShipSprites(*flagship);
+		else
+			flagship->PositionFighters();
+	}
 	if(!timePaused && flagship && showFlagship)
 	{
 		if(flagship->IsThrusting() && !flagship->EnginePoints().empty())
@@ -1747,12 +1927,51 @@ void Engine::CalculateStep()
 				Audio::Play(it.first, SoundCategory::ENGINE);
 		}
 	}
-	// Draw the projectiles.
-	for(const Projectile &projectile : projectiles)
-		batchDraw[currentCalcBuffer].Add(projectile, projectile.Clip());
-	// Draw the visuals.
-	for(const Visual &visual : visuals)
-		batchDraw[currentCalcBuffer].AddVisual(visual);
+	if(!isPreparingDraw)
+		return;
+	// Draw the projectiles, then the visuals.
+	FillBatchDraw();
+}
+
+
+
+// Add the projectiles and visuals to the batch draw list. Each thread fills in
+// its own part of the list, and then the parts are appended in order, so that
+// the sprites are drawn in the same order as if they were added one by one.
+void Engine::FillBatchDraw()
+{
+	BatchDrawList &list = batchDraw[currentCalcBuffer];
+	const size_t count = projectiles.size() + visuals.size();
+	auto fill = [this](BatchDrawList &part, size_t begin, size_t end)
+	{
+		for(size_t i = begin; i < end; ++i)
+		{
+			if(i < projectiles.size())
+				part.Add(projectiles[i], projectiles[i].Clip());
+			else
+				part.AddVisual(visuals[i - projectiles.size()]);
+		}
+	};
+
+	// The first time a randomly animated sprite is drawn, it draws a random
+	// frame to start on, which would not be repeatable on other threads.
+	if(count <= DRAW_CHUNK_SIZE || Random::IsDeterministic())
+	{
+		fill(list, 0, count);
+		return;
+	}
+
+	const size_t parts = (count + DRAW_CHUNK_SIZE - 1) / DRAW_CHUNK_SIZE;
+	if(batchDrawParts.size() < parts)
+		batchDrawParts.resize(parts);
+	TaskQueue::ParallelFor(0, count, DRAW_CHUNK_SIZE, [this, &list, &fill](size_t begin, size_t end)
+	{
+		BatchDrawList &part = batchDrawParts[begin / DRAW_CHUNK_SIZE];
+		part.ClearFor(list);
+		fill(part, begin, end);
+	});
+	for(size_t i = 0; i < parts; ++i)
+		list.Append(batchDrawParts[i]);
 }
 
 
@@ -1761,7 +1980,10 @@ void Engine::CalculateStep()
 void Engine::CalculateUnpaused(const Ship *flagship, const System *playerSystem)
 {
 	// Now, all the ships must decide what they are doing next.
-	ai.Step(activeCommands);
+	{
+		Profiler::Scope scope("AI");
+		ai.Step(activeCommands);
+	}
 
 	// Clear the active player's commands, because they are all processed at this point.
 	activeCommands.Clear();
@@ -1791,17 +2013,20 @@ void Engine::CalculateUnpaused(const Ship *flagship, const System *playerSystem)
 	bool flagshipIsTargetable = (flagship && flagship->IsTargetable());
 	bool flagshipBecameTargetable = flagshipWasUntargetable && flagshipIsTargetable;
 	// Then, move the other ships.
-	for(const shared_ptr<Ship> &it : ships)
 	{
-		if(it == player.FlagshipPtr())
-			continue;
-		bool wasUntargetable = !it->IsTargetable();
-		MoveShip(it);
-		bool isTargetable = it->IsTargetable();
-		if(flagshipSystem == it->GetSystem()
-			&& ((wasUntargetable && isTargetable) || flagshipBecameTargetable)
-			&& isTargetable && flagshipIsTargetable)
-				eventQueue.emplace_back(player.FlagshipPtr(), it, ShipEvent::ENCOUNTER);
+		Profiler::Scope scope("Move ships");
+		for(const shared_ptr<Ship> &it : ships)
+		{
+			if(it == player.FlagshipPtr())
+				continue;
+			bool wasUntargetable = !it->IsTargetable();
+			MoveShip(it);
+			bool isTargetable = it->IsTargetable();
+			if(flagshipSystem == it->GetSystem()
+				&& ((wasUntargetable && isTargetable) || flagshipBecameTargetable)
+				&& isTargetable && flagshipIsTargetable)
+					eventQueue.emplace_back(player.FlagshipPtr(), it, ShipEvent::ENCOUNTER);
+		}
 	}
 	// If the flagship just began jumping, play the appropriate sound.
 	if(!wasHyperspacing && flagship && flagship->IsEnteringHyperspace())
@@ -1818,10 +2043,11 @@ void Engine::CalculateUnpaused(const Ship *flagship, const System *playerSystem)
 		else
 			for(const auto &sound : jumpSounds)
 				Audio::Play(sound.first, SoundCategory::JUMP);
-		// Begin loading the sprites in the next system.
+		// Begin loading the sprites and the music in the next system.
 		for(const StellarObject &object : flagship->GetTargetSystem()->Objects())
 			if(object.HasSprite())
 				SpriteLoadManager::LoadDeferred(asyncQueue, object.GetSprite());
+		Audio::PrefetchMusic(flagship->GetTargetSystem()->MusicName());
 	}
 	// Check if the flagship just entered a new system.
 	if(flagship && playerSystem != flagship->GetSystem())
@@ -1849,44 +2075,77 @@ void Engine::CalculateUnpaused(const Ship *flagship, const System *playerSystem)
 
 	// Move the asteroids. This must be done before collision detection. Minables
 	// may create visuals or flotsam.
-	asteroids.Step(newVisuals, newFlotsam, step);
+	{
+		Profiler::Scope scope("Asteroids");
+		asteroids.Step(newVisuals, newFlotsam, step);
+	}
 
 	// Move the flotsam. This must happen after the ships move, because flotsam
 	// checks if any ship has picked it up.
-	for(const shared_ptr<Flotsam> &it : flotsam)
-		it->Move(newVisuals);
-	PrunePointers(flotsam);
+	{
+		Profiler::Scope scope("Move flotsam");
+		for(const shared_ptr<Flotsam> &it : flotsam)
+			it->Move(newVisuals);
+		PrunePointers(flotsam);
+	}
 
 	// Move the projectiles.
-	for(Projectile &projectile : projectiles)
-		projectile.Move(newVisuals, newProjectiles);
-	Prune(projectiles);
+	{
+		Profiler::Scope scope("Move projectiles");
+		// Steer each projectile, then update all their positions and velocities at once.
+		projectileKinematics.Clear();
+		movingProjectiles.clear();
+		for(Projectile &projectile : projectiles)
+		{
+			Point acceleration;
+			double drag;
+			if(projectile.Steer(newVisuals, newProjectiles, acceleration, drag))
+			{
+				projectileKinematics.Add(projectile.Position(), projectile.Velocity(), acceleration, drag);
+				movingProjectiles.push_back(&projectile);
+			}
+		}
+		projectileKinematics.Integrate();
+		for(size_t i = 0; i < movingProjectiles.size(); ++i)
+			movingProjectiles[i]->FinishMove(projectileKinematics.Position(i), projectileKinematics.Velocity(i));
+		Prune(projectiles);
+	}
 
 	// Step the weather.
-	for(Weather &weather : activeWeather)
-		weather.Step(newVisuals, flagship ? flagship->Position() : camera.Center());
-	Prune(activeWeather);
+	{
+		Profiler::Scope scope("Weather");
+		for(Weather &weather : activeWeather)
+			weather.Step(newVisuals, flagship ? flagship->Position() : camera.Center());
+		Prune(activeWeather);
+	}
 
 	// Move the visuals.
-	for(Visual &visual : visuals)
-		visual.Move();
-	Prune(visuals);
+	{
+		Profiler::Scope scope("Move visuals");
+		for(Visual &visual : visuals)
+			visual.Move();
+		Prune(visuals);
+	}
 
 	// Perform various minor actions.
-	SpawnFleets();
-	SpawnPersons();
-	GenerateWeather();
-	SendHails();
-	HandleMouseClicks();
+	{
+		Profiler::Scope scope("Spawning and hails");
+		ScheduleSpawns();
+		SpawnFleets();
+		SpawnPersons();
+		GenerateWeather();
+		SendHails();
+		HandleMouseClicks();
+	}
 
 	// Now, take the new objects that were generated this step and splice them
 	// on to the ends of the respective lists of objects. These new objects will
 	// be drawn this step (and the projectiles will participate in collision
 	// detection) but they should not be moved, which is why we put off adding
 	// them to the lists until now.
-	ships.splice(ships.end(), newShips);
+	Append(ships, newShips);
 	Append(projectiles, newProjectiles);
-	flotsam.splice(flotsam.end(), newFlotsam);
+	Append(flotsam, newFlotsam);
 	Append(visuals, newVisuals);
 
 	// Decrement the count of how long it's been since a ship last asked for help.
@@ -1897,27 +2156,42 @@ void Engine::CalculateUnpaused(const Ship *flagship, const System *playerSystem)
 	FillCollisionSets();
 
 	// Perform collision detection.
-	for(Projectile &projectile : projectiles)
-		DoCollisions(projectile);
+	{
+		Profiler::Scope scope("Collisions");
+		// Find everything each projectile might hit in parallel, then apply the
+		// hits in order so that the outcome does not depend on the threads.
+		FindCollisions();
+		for(size_t i = 0; i < projectiles.size(); ++i)
+			DoCollisions(projectiles[i], projectileHits[i]);
+	}
 	// Now that collision detection is done, clear the cache of ships with anti-
 	// missile systems ready to fire.
 	hasAntiMissile.clear();
 
 	// Damage ships from any active weather events.
-	for(Weather &weather : activeWeather)
-		DoWeather(weather);
+	{
+		Profiler::Scope scope("Weather damage");
+		for(Weather &weather : activeWeather)
+			DoWeather(weather);
+	}
 
 	// Check for flotsam collection (collisions with ships).
-	for(const shared_ptr<Flotsam> &it : flotsam)
-		DoCollection(*it);
+	{
+		Profiler::Scope scope("Flotsam collection");
+		for(const shared_ptr<Flotsam> &it : flotsam)
+			DoCollection(*it);
+	}
 
 	// Now that flotsam collection is done, clear the cache of ships with
 	// tractor beam systems ready to fire.
 	hasTractorBeam.clear();
 
 	// Check for ship scanning.
-	for(const shared_ptr<Ship> &it : ships)
-		DoScanning(it);
+	{
+		Profiler::Scope scope("Scanning");
+		for(const shared_ptr<Ship> &it : ships)
+			DoScanning(it);
+	}
 }
 
 
@@ -1940,7 +2214,12 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 	// Give the ship the list of visuals so that it can draw explosions,
 	// ion sparks, jump drive flashes, etc.
 	ship->Move(newVisuals, newFlotsam);
-	eventQueue.splice(eventQueue.end(), ship->HandleEvents());
+	vector<ShipEvent> &shipEvents = ship->HandleEvents();
+	if(!shipEvents.empty())
+	{
+		eventQueue.insert(eventQueue.end(), make_move_iterator(shipEvents.begin()), make_move_iterator(shipEvents.end()));
+		shipEvents.clear();
+	}
 
 	// Bail out if the ship just died.
 	if(ship->ShouldBeRemoved())
@@ -2025,6 +2304,21 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 // Populate the ship collision detection set for projectile & flotsam computations.
 void Engine::FillCollisionSets()
 {
+	Profiler::Scope profilerScope("Fill collision sets");
+
+	// Record how crowded the ship grid was during the last step, before it is
+	// cleared (and possibly resized).
+	if(Profiler::IsEnabled())
+	{
+		const CollisionSet::Statistics statistics = shipCollisions.GetStatistics();
+		Profiler::AddCounter("Ship grid cell size", shipCollisions.CellSize());
+		Profiler::AddCounter("Ship grid cell count", shipCollisions.CellCount());
+		Profiler::AddCounter("Ship grid entries", statistics.entries);
+		Profiler::AddCounter("Ship grid occupied cells", statistics.occupiedCells);
+		Profiler::AddCounter("Ship grid max cell load", statistics.maxCellLoad);
+		Profiler::AddCounter("Ship grid cells visited", statistics.cellsVisited);
+	}
+
 	shipCollisions.Clear(step);
 	for(const shared_ptr<Ship> &it : ships)
 		if(it->GetSystem() == player.GetSystem() && it->Zoom() == 1.)
@@ -2032,6 +2326,62 @@ void Engine::FillCollisionSets()
 
 	// Get the ship collision set ready to query.
 	shipCollisions.Finish();
+
+	antiMissileGrid.Clear();
+	for(const Ship *ship : hasAntiMissile)
+		antiMissileGrid.Add(ship->Position(), ship->AntiMissileRange());
+	antiMissileGrid.Finish();
+	tractorBeamGrid.Clear();
+	for(const Ship *ship : hasTractorBeam)
+		tractorBeamGrid.Add(ship->Position(), ship->TractorBeamRange());
+	tractorBeamGrid.Finish();
+}
+
+
+
+// Work out when the current system's fleets and hazards will next try to
+// spawn, if that has not been done since entering it or since any of their
+// chances changed, such as when an event replaced one of them.
+void Engine::ScheduleSpawns()
+{
+	const System &system = *player.GetSystem();
+	const double fleetMultiplier = GameData::GetGamerules().FleetMultiplier();
+
+	// Each fleet has a one in (period / multiplier) chance of trying to spawn
+	// on each step. Whether its conditions allow it is checked when it does.
+	fleetChances.clear();
+	for(const RandomEvent<Fleet> &fleet : system.Fleets())
+	{
+		const uint32_t period = fleetMultiplier ? fleet.Period() / fleetMultiplier : 0;
+		fleetChances.push_back(!fleetMultiplier ? 0. : period ? 1. / period : 1.);
+	}
+
+	hazardChances.clear();
+	hazardSources.clear();
+	auto addHazards = [this](const vector<RandomEvent<Hazard>> &hazards, int object)
+	{
+		for(size_t i = 0; i < hazards.size(); ++i)
+		{
+			hazardChances.push_back(hazards[i].Get()->IsValid() ? 1. / hazards[i].Period() : 0.);
+			hazardSources.emplace_back(object, i);
+		}
+	};
+	addHazards(system.Hazards(), -1);
+	for(size_t i = 0; i < system.Objects().size(); ++i)
+		addHazards(system.Objects()[i].Hazards(), i);
+
+	if(&system == scheduledSystem && fleetSchedule.Matches(fleetChances)
+			&& hazardSchedule.Matches(hazardChances) && hazardSources == scheduledHazards)
+		return;
+
+	scheduledSystem = &system;
+	fleetSchedule.Clear();
+	for(double chance : fleetChances)
+		fleetSchedule.Add(chance);
+	hazardSchedule.Clear();
+	for(double chance : hazardChances)
+		hazardSchedule.Add(chance);
+	scheduledHazards.swap(hazardSources);
 }
 
 
@@ -2049,23 +2399,22 @@ void Engine::SpawnFleets()
 
 	// Non-mission NPCs spawn at random intervals in neighboring systems,
 	// or coming from planets in the current one.
-	double fleetMultiplier = GameData::GetGamerules().FleetMultiplier();
-	for(const auto &fleet : player.GetSystem()->Fleets())
-		if(fleetMultiplier ? !Random::Int(fleet.Period() / fleetMultiplier) && fleet.CanTrigger() : false)
-		{
-			const Government *gov = fleet.Get()->GetGovernment();
-			if(!gov)
-				continue;
+	for(size_t index : fleetSchedule.Step())
+	{
+		const RandomEvent<Fleet> &fleet = player.GetSystem()->Fleets()[index];
+		const Government *gov = fleet.Get()->GetGovernment();
+		if(!fleet.CanTrigger() || !gov)
+			continue;
 
-			// Don't spawn a fleet if its allies in-system already far outnumber
-			// its enemies. This is to avoid having a system get mobbed with
-			// massive numbers of "reinforcements" during a battle.
-			int64_t enemyStrength = ai.EnemyStrength(gov);
-			if(enemyStrength && ai.AllyStrength(gov) > 2 * enemyStrength)
-				continue;
+		// Don't spawn a fleet if its allies in-system already far outnumber
+		// its enemies. This is to avoid having a system get mobbed with
+		// massive numbers of "reinforcements" during a battle.
+		int64_t enemyStrength = ai.EnemyStrength(gov);
+		if(enemyStrength && ai.AllyStrength(gov) > 2 * enemyStrength)
+			continue;
 
-			fleet.Get()->Enter(*player.GetSystem(), newShips);
-		}
+		fleet.Get()->Enter(*player.GetSystem(), newShips);
+	}
 }
 
 
@@ -2076,11 +2425,26 @@ void Engine::SpawnPersons()
 	if(Random::Int(GameData::GetGamerules().PersonSpawnPeriod()) || player.GetSystem()->Links().empty())
 		return;
 
-	// Loop through all persons once to see if there are any who can enter
-	// this system.
+	// Only the persons whose location matches this system can ever enter it,
+	// so find those once per system.
+	const System *system = player.GetSystem();
+	if(system != personSystem)
+	{
+		personSystem = system;
+		personCandidates.clear();
+		for(const auto &it : GameData::Persons())
+			if(it.second.CanAppearIn(system))
+				personCandidates.push_back(&it);
+	}
+
+	// Find out which of them can enter this system right now.
+	personWeights.clear();
 	int sum = 0;
-	for(const auto &it : GameData::Persons())
-		sum += it.second.Frequency(player.GetSystem());
+	for(const auto *it : personCandidates)
+	{
+		sum += it->second.Frequency(system);
+		personWeights.push_back(sum);
+	}
 	// Bail out if there are no eligible persons.
 	if(!sum)
 		return;
@@ -2088,34 +2452,29 @@ void Engine::SpawnPersons()
 	// Although an attempt to spawn a person is specified by a gamerule,
 	// that attempt can still fail due to an added weight for no person to spawn.
 	sum = Random::Int(sum + GameData::GetGamerules().NoPersonSpawnWeight());
-	for(const auto &it : GameData::Persons())
-	{
-		const Person &person = it.second;
-		sum -= person.Frequency(player.GetSystem());
-		if(sum < 0)
-		{
-			const System *source = nullptr;
-			shared_ptr<Ship> parent;
-			for(const shared_ptr<Ship> &ship : person.Ships())
-			{
-				ship->Recharge();
-				if(ship->GivenName().empty())
-					ship->SetGivenName(it.first);
-				ship->SetGovernment(person.GetGovernment());
-				ship->SetPersonality(person.GetPersonality());
-				ship->SetHailPhrase(person.GetHail());
-				if(!parent)
-					parent = ship;
-				else
-					ship->SetParent(parent);
-				// Make sure all ships in a "person" definition enter from the
-				// same source system.
-				source = Fleet::Enter(*player.GetSystem(), *ship, source);
-				newShips.push_back(ship);
-			}
+	auto chosen = upper_bound(personWeights.begin(), personWeights.end(), sum);
+	if(chosen == personWeights.end())
+		return;
 
-			break;
-		}
+	const auto &[name, person] = *personCandidates[chosen - personWeights.begin()];
+	const System *source = nullptr;
+	shared_ptr<Ship> parent;
+	for(const shared_ptr<Ship> &ship : person.Ships())
+	{
+		ship->Recharge();
+		if(ship->GivenName().empty())
+			ship->SetGivenName(name);
+		ship->SetGovernment(person.GetGovernment());
+		ship->SetPersonality(person.GetPersonality());
+		ship->SetHailPhrase(person.GetHail());
+		if(!parent)
+			parent = ship;
+		else
+			ship->SetParent(parent);
+		// Make sure all ships in a "person" definition enter from the
+		// same source system.
+		source = Fleet::Enter(*system, *ship, source);
+		newShips.push_back(ship);
 	}
 }
 
@@ -2124,23 +2483,22 @@ void Engine::SpawnPersons()
 // Generate weather from the current system's hazards.
 void Engine::GenerateWeather()
 {
-	auto CreateWeather = [this](const RandomEvent<Hazard> &hazard, Point origin)
+	// If this system has any hazards, see if any have activated this frame.
+	const System &system = *player.GetSystem();
+	for(size_t index : hazardSchedule.Step())
 	{
-		if(hazard.Get()->IsValid() && !Random::Int(hazard.Period()) && hazard.CanTrigger())
+		const auto [object, i] = scheduledHazards[index];
+		const RandomEvent<Hazard> &hazard = (object < 0) ? system.Hazards()[i] : system.Objects()[object].Hazards()[i];
+		if(hazard.CanTrigger())
 		{
 			const Hazard *weather = hazard.Get();
 			// If a hazard has activated, generate a duration and strength of the
 			// resulting weather and place it in the list of active weather.
 			int duration = weather->RandomDuration();
+			Point origin = (object < 0) ? Point() : system.Objects()[object].Position();
 			activeWeather.emplace_back(weather, duration, duration, weather->RandomStrength(), origin);
 		}
-	};
-	// If this system has any hazards, see if any have activated this frame.
-	for(const auto &hazard : player.GetSystem()->Hazards())
-		CreateWeather(hazard, Point());
-	for(const auto &stellar : player.GetSystem()->Objects())
-		for(const auto &hazard : stellar.Hazards())
-			CreateWeather(hazard, stellar.Position());
+	}
 }
 
 
@@ -2416,15 +2774,59 @@ void Engine::HandleMouseInput(Command &activeCommands)
 
 
 
-// Perform collision detection. Note that unlike the preceding functions, this
-// one adds any visuals that are created directly to the main visuals list. If
-// this is multi-threaded in the future, that will need to change.
-void Engine::DoCollisions(Projectile &projectile)
+void Engine::ProjectileHits::Clear()
 {
+	triggers.clear();
+	collisions.clear();
+	blastShips.clear();
+	blastShipOffsets.assign(1, 0);
+	blastMinables.clear();
+	blastMinableOffsets.assign(1, 0);
+}
+
+
+
+// Find everything that each projectile might hit during this step. Nothing is
+// modified here, so the projectiles can be handled in parallel.
+void Engine::FindCollisions()
+{
+	// Look up every projectile's possible collisions with ships along its path in
+	// a single batch.
+	shipLineQueries.clear();
+	for(const Projectile &projectile : projectiles)
+	{
+		const Weapon &weapon = projectile.GetWeapon();
+		const bool hasPhasingTarget = weapon.IsPhasing() && projectile.Target();
+		// Phasing projectiles are checked against their target, which may not be
+		// in the collision set. Make sure its animation frame is up to date before
+		// its mask is used from several threads at once.
+		if(hasPhasingTarget && !projectile.ShouldExplode())
+			projectile.Target()->GetMask(step);
+		const bool needsLine = !projectile.ShouldExplode() && !hasPhasingTarget && weapon.CanCollideShips();
+		shipLineQueries.push_back(needsLine ? &projectile : nullptr);
+	}
+	shipCollisions.Lines(shipLineQueries, shipLineCollisions, shipLineOffsets);
+
+	if(projectileHits.size() < projectiles.size())
+		projectileHits.resize(projectiles.size());
+	TaskQueue::ParallelFor(0, projectiles.size(), COLLISION_CHUNK_SIZE, [this](size_t begin, size_t end)
+	{
+		for(size_t i = begin; i < end; ++i)
+			FindCollisions(projectiles[i], i, projectileHits[i]);
+	});
+}
+
+
+
+// Find everything that the given projectile might hit during this step.
+void Engine::FindCollisions(const Projectile &projectile, size_t index, ProjectileHits &hits) const
+{
+	hits.Clear();
+
 	// The asteroids can collide with projectiles, the same as any other
 	// object. If the asteroid turns out to be closer than the ship, it
 	// shields the ship (unless the projectile has a blast radius).
-	vector<Collision> collisions;
+	vector<Collision> &collisions = hits.collisions;
 	const Government *gov = projectile.GetGovernment();
 	const Weapon &weapon = projectile.GetWeapon();
 
@@ -2439,51 +2841,90 @@ void Engine::DoCollisions(Projectile &projectile)
 		if(target)
 		{
 			Point offset = projectile.Position() - target->Position();
-			double range = target->GetMask(step).Collide(offset, projectile.Velocity(), target->Facing());
+			double range = target->GetMask().Collide(offset, projectile.Velocity(), target->Facing());
 			if(range < 1.)
 				collisions.emplace_back(target.get(), CollisionType::SHIP, range);
 		}
 	}
 	else
 	{
-		// For weapons with a trigger radius, check if any detectable object will set it off.
+		// For weapons with a trigger radius, find every ship that might set it off.
+		// Whether they actually do depends on the state they are in by the time
+		// the projectile's collisions are applied.
 		double triggerRadius = weapon.TriggerRadius();
 		if(triggerRadius)
 		{
-			vector<Body *> inRadius;
-			inRadius.reserve(min(static_cast<vector<Body *>::size_type>(triggerRadius), ships.size()));
-			shipCollisions.Circle(projectile.Position(), triggerRadius, inRadius);
-			for(const Body *body : inRadius)
+			shipCollisions.Circle(projectile.Position(), triggerRadius, hits.triggers);
+			erase_if(hits.triggers, [&projectile, gov](const Body *body)
 			{
-				const Ship *ship = static_cast<const Ship *>(body);
-				// Don't trigger off of carried ships that are disabled and not directly targeted.
-				if(body == projectile.Target() || (gov->IsEnemy(body->GetGovernment())
-						&& !ship->IsCloaked() && FighterHitHelper::IsValidTarget(ship)))
-				{
-					collisions.emplace_back(nullptr, CollisionType::NONE, 0.);
-					break;
-				}
-			}
+				return body != projectile.Target() && !gov->IsEnemy(body->GetGovernment());
+			});
 		}
 
-		// If nothing triggered the projectile, check for collisions with ships and asteroids.
-		if(collisions.empty())
-		{
-			if(weapon.CanCollideShips())
-				shipCollisions.Line(projectile, collisions);
-			if(weapon.CanCollideAsteroids())
-				asteroids.CollideAsteroids(projectile, collisions);
-			if(weapon.CanCollideMinables())
-				asteroids.CollideMinables(projectile, collisions);
-		}
+		// Also find any collisions with ships and asteroids, in case nothing sets it off.
+		if(weapon.CanCollideShips())
+			collisions.insert(collisions.end(), shipLineCollisions.begin() + shipLineOffsets[index],
+				shipLineCollisions.begin() + shipLineOffsets[index + 1]);
+		if(weapon.CanCollideAsteroids())
+			asteroids.CollideAsteroids(projectile, collisions);
+		if(weapon.CanCollideMinables())
+			asteroids.CollideMinables(projectile, collisions);
 	}
 
 	// Sort the Collisions by increasing range so that the closer collisions are evaluated first.
 	sort(collisions.begin(), collisions.end());
 
+	// If this projectile has a blast radius, find all ships and minables within its
+	// radius for each of the places where it might explode.
+	const double blastRadius = weapon.BlastRadius();
+	if(!blastRadius)
+		return;
+	auto findBlast = [&](double range)
+	{
+		Point hitPos = projectile.Position() + range * projectile.Velocity();
+		shipCollisions.Circle(hitPos, blastRadius, hits.blastShips);
+		hits.blastShipOffsets.push_back(hits.blastShips.size());
+		asteroids.MinablesCollisionsCircle(hitPos, blastRadius, hits.blastMinables);
+		hits.blastMinableOffsets.push_back(hits.blastMinables.size());
+	};
+	for(const Collision &collision : collisions)
+		findBlast(collision.IntersectionRange());
+	if(!hits.triggers.empty())
+		findBlast(0.);
+}
+
+
+
+// Apply the collisions of the given projectile. Note that unlike the preceding
+// functions, this one adds any visuals that are created directly to the main
+// visuals list.
+void Engine::DoCollisions(Projectile &projectile, const ProjectileHits &hits)
+{
+	const Government *gov = projectile.GetGovernment();
+	const Weapon &weapon = projectile.GetWeapon();
+
+	// Check if any detectable object within the trigger radius sets the projectile off.
+	bool isTriggered = false;
+	for(const Body *body : hits.triggers)
+	{
+		const Ship *ship = static_cast<const Ship *>(body);
+		// Don't trigger off of carried ships that are disabled and not directly targeted.
+		if(body == projectile.Target() || (!ship->IsCloaked() && FighterHitHelper::IsValidTarget(ship)))
+		{
+			isTriggered = true;
+			break;
+		}
+	}
+	// If the projectile was set off, it explodes where it is, and the blast of
+	// that explosion is the last one that was found.
+	const Collision triggered(nullptr, CollisionType::NONE, 0.);
+	const size_t collisionCount = isTriggered ? 1 : hits.collisions.size();
+
 	// Run all collisions until either the projectile dies or there are no more collisions left.
-	for(Collision &collision : collisions)
+	for(size_t i = 0; i < collisionCount; ++i)
 	{
+		Collision collision = isTriggered ? triggered : hits.collisions[i];
+		const size_t blast = isTriggered ? hits.collisions.size() : i;
 		Body *hit = collision.HitBody();
 		CollisionType collisionType = collision.GetCollisionType();
 		double range = collision.IntersectionRange();
@@ -2507,21 +2948,16 @@ void Engine::DoCollisions(Projectile &projectile)
 
 		const DamageProfile damage(projectile.GetInfo(range));
 
-		// If this projectile has a blast radius, find all ships and minables within its
+		// If this projectile has a blast radius, damage all ships and minables within its
 		// radius. Otherwise, only one is damaged.
-		double blastRadius = weapon.BlastRadius();
-		if(blastRadius)
+		if(weapon.BlastRadius())
 		{
 			// Even friendly ships can be hit by the blast, unless it is a
 			// "safe" weapon.
-			Point hitPos = projectile.Position() + range * projectile.Velocity();
 			bool isSafe = weapon.IsSafe();
-			vector<Body *> blastCollisions;
-			blastCollisions.reserve(32);
-			shipCollisions.Circle(hitPos, blastRadius, blastCollisions);
-			for(Body *body : blastCollisions)
+			for(unsigned j = hits.blastShipOffsets[blast]; j < hits.blastShipOffsets[blast + 1]; ++j)
 			{
-				Ship *ship = static_cast<Ship *>(body);
+				Ship *ship = static_cast<Ship *>(hits.blastShips[j]);
 				bool targeted = (projectile.Target() == ship);
 				// Phasing cloaked ship will have a chance to ignore the effects of the explosion.
 				if((isSafe && !targeted && !gov->IsEnemy(ship->GetGovernment())) || ship->Phases(projectile))
@@ -2533,11 +2969,9 @@ void Engine::DoCollisions(Projectile &projectile)
 				if(eventType)
 					eventQueue.emplace_back(gov, ship->shared_from_this(), eventType);
 			}
-			blastCollisions.clear();
-			asteroids.MinablesCollisionsCircle(hitPos, blastRadius, blastCollisions);
-			for(Body *body : blastCollisions)
+			for(unsigned j = hits.blastMinableOffsets[blast]; j < hits.blastMinableOffsets[blast + 1]; ++j)
 			{
-				auto minable = static_cast<Minable *>(body);
+				auto minable = static_cast<Minable *>(hits.blastMinables[j]);
 				minable->TakeDamage(damage.CalculateDamage(*minable));
 			}
 		}
@@ -2565,13 +2999,18 @@ void Engine::DoCollisions(Projectile &projectile)
 	// If the projectile is still alive, give the anti-missile systems a chance to shoot it down.
 	if(!projectile.IsDead() && projectile.MissileStrength())
 	{
-		for(Ship *ship : hasAntiMissile)
+		// Only the ships that can reach the missile could fire at it, and they are
+		// found in the same order as they are in the list.
+		for(int index : antiMissileGrid.InRange(projectile.Position()))
+		{
+			Ship *ship = hasAntiMissile[index];
 			if(ship == projectile.Target() || gov->IsEnemy(ship->GetGovernment()))
 				if(ship->FireAntiMissile(projectile, visuals))
 				{
 					projectile.Kill();
 					break;
 				}
+		}
 	}
 }
 
@@ -2636,8 +3075,9 @@ void Engine::DoCollection(Flotsam &flotsam)
 		// Also determine the average velocity of the ships pulling on this flotsam.
 		Point avgShipVelocity;
 		int count = 0;
-		for(Ship *ship : hasTractorBeam)
+		for(int index : tractorBeamGrid.InRange(flotsam.Position()))
 		{
+			Ship *ship = hasTractorBeam[index];
 			Point shipPull = ship->FireTractorBeam(flotsam, visuals);
 			if(shipPull)
 			{
@@ -2759,6 +3199,8 @@ void Engine::DoScanning(const shared_ptr<Ship> &ship)
 // Fill in all the objects in the radar display.
 void Engine::FillRadar()
 {
+	Profiler::Scope profilerScope("Radar");
+
 	const Ship *flagship = player.Flagship();
 	const System *playerSystem = player.GetSystem();
 
@@ -2792,27 +3234,41 @@ void Engine::FillRadar()
 		radar[currentCalcBuffer].AddViewportBoundary(Screen::BottomRight() / zoom);
 	}
 
-	// Add ships. Also check if hostile ships have newly appeared.
-	bool hasHostiles = false;
-	for(shared_ptr<Ship> &ship : ships)
-		if(ship->GetSystem() == playerSystem)
+	// Classify the ships in parallel, since that checks each one's government
+	// against the player's, and then add them in order.
+	const Ship *flagshipTarget = flagship ? flagship->GetTargetShip().get() : nullptr;
+	radarShips.resize(ships.size());
+	TaskQueue::ParallelFor(0, ships.size(), RADAR_CHUNK_SIZE,
+		[this, playerSystem, flagshipTarget](size_t begin, size_t end)
+	{
+		for(size_t i = begin; i < end; ++i)
 		{
+			const Ship &ship = *ships[i];
+			RadarShip &result = radarShips[i];
+			result.type = -1;
 			// Do not show cloaked ships on the radar, except the player's ships, and those who should show on radar.
-			bool isYours = ship->IsYours();
-			if(ship->IsCloaked() && !isYours)
+			if(ship.GetSystem() != playerSystem || (ship.IsCloaked() && !ship.IsYours()))
 				continue;
 
 			// Figure out what radar color should be used for this ship.
-			bool isYourTarget = (flagship && ship == flagship->GetTargetShip());
-			int type = isYourTarget ? Radar::SPECIAL : RadarType(*ship, uiStep);
+			bool isYourTarget = (&ship == flagshipTarget);
+			result.type = isYourTarget ? Radar::SPECIAL : RadarType(ship, uiStep);
 			// Calculate how big the radar dot should be.
-			double size = sqrt(ship->Width() + ship->Height()) * .14 + .5;
-
-			radar[currentCalcBuffer].Add(type, ship->Position(), size);
+			result.size = sqrt(ship.Width() + ship.Height()) * .14 + .5;
 
 			// Check if this is a hostile ship.
-			hasHostiles |= (!ship->IsDisabled() && ship->GetGovernment()->IsEnemy()
-				&& ship->GetTargetShip() && ship->GetTargetShip()->IsYours());
+			const shared_ptr<Ship> target = ship.GetTargetShip();
+			result.isHostile = (!ship.IsDisabled() && ship.GetGovernment()->IsEnemy() && target && target->IsYours());
+		}
+	});
+
+	// Add ships. Also check if hostile ships have newly appeared.
+	bool hasHostiles = false;
+	for(size_t i = 0; i < ships.size(); ++i)
+		if(radarShips[i].type >= 0)
+		{
+			radar[currentCalcBuffer].Add(radarShips[i].type, ships[i]->Position(), radarShips[i].size);
+			hasHostiles |= radarShips[i].isHostile;
 		}
 	// If hostile ships have appeared, play the siren.
 	if(alarmTime)
@@ -27,6 +27,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "shader/DrawList.h"
 #include "EscortDisplay.h"
 #include "Information.h"
+#include "Kinematics.h"
 #include "MiniMap.h"
 #include "MouseButton.h"
 #include "PlanetLabel.h"
@@ -34,13 +35,18 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Preferences.h"
 #include "Projectile.h"
 #include "Radar.h"
+#include "RandomEventSchedule.h"
+#include "RangeGrid.h"
 #include "Rectangle.h"
 #include "TaskQueue.h"
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -48,6 +54,7 @@ class Flotsam;
 class Government;
 class NPC;
 class Outfit;
+class Person;
 class PlayerInfo;
 class Ship;
 class ShipEvent;
@@ -81,18 +88,38 @@ public:
 	void Step(bool isActive);
 	// Begin the next step of calculations.
 	void Go();
+	// Say whether the state after the coming call to Step(), and after the step
+	// that the call to Go() after it begins, will be drawn. When fast-forwarding,
+	// most steps are not, so nothing that is only used for drawing is prepared
+	// for them. This only applies until the next call to Go().
+	void SetDrawnSteps(bool isThisStepDrawn, bool isNextStepDrawn);
 	// Whether the player has the game paused.
 	bool IsPaused() const;
 
 	// Give a command on behalf of the player, used for integration tests.
 	void GiveCommand(const Command &command);
+	// Get the commands that the player gave for the step that Step() prepared,
+	// so that they can be recorded and given again in a replay.
+	const Command &StepCommands() const;
+	// Get a checksum of the state of every ship and projectile, used to check
+	// that a benchmark simulated exactly the same thing every time it ran.
+	uint64_t StateChecksum() const;
+	// Get every ship in the current system, used to report the outcome of a
+	// benchmark's battle. Only safe to call while the calculations are paused.
+	const std::vector<std::shared_ptr<Ship>> &Ships() const;
+	// Get how many allocations the last step of calculations made, if the game
+	// was built to count them.
+	int64_t StepAllocations() const;
 
 	// Get any special events that happened in this step.
 	// MainPanel::Step will clear this list.
-	std::list<ShipEvent> &Events();
+	std::vector<ShipEvent> &Events();
 
 	// Draw a frame.
 	void Draw() const;
+	// Set how far along the current step is toward the next one, so that frames
+	// drawn in between steps can show objects moving smoothly.
+	void SetDrawProgress(double progress);
 
 	// Select the object the player clicked on.
 	void Click(const Point &from, const Point &to, bool hasShift, bool hasControl);
@@ -166,6 +193,38 @@ private:
 		bool isBlind;
 	};
 
+	// Everything a projectile might hit this step. This is found for every projectile
+	// in parallel, based on where everything is at the start of collision detection,
+	// and then applied to each projectile in turn.
+	class ProjectileHits {
+	public:
+		void Clear();
+
+		// Ships within the projectile's trigger radius that might set it off.
+		std::vector<Body *> triggers;
+		// Every possible collision, sorted by increasing range.
+		std::vector<Collision> collisions;
+		// For weapons with a blast radius, the ships and minables within the blast
+		// of each collision. The bodies for collision i start at blastShipOffsets[i]
+		// and end at blastShipOffsets[i + 1]. If the projectile might be set off by
+		// a ship within its trigger radius, one more entry follows for that blast.
+		std::vector<Body *> blastShips;
+		std::vector<unsigned> blastShipOffsets;
+		std::vector<Body *> blastMinables;
+		std::vector<unsigned> blastMinableOffsets;
+	};
+
+	// How one ship is shown on the radar. This is found for every ship in
+	// parallel, and then the ships are added to the radar in order.
+	class RadarShip {
+	public:
+		// The radar type, or -1 if the ship is not shown.
+		int type = -1;
+		double size = 0.;
+		// Whether this is an active enemy ship that is targeting one of the player's.
+		bool isHostile = false;
+	};
+
 	class Zoom {
 	public:
 		constexpr Zoom() : base(0.) {}
@@ -187,6 +246,7 @@ private:
 
 	void MoveShip(const std::shared_ptr<Ship> &ship);
 
+	void ScheduleSpawns();
 	void SpawnFleets();
 	void SpawnPersons();
 	void GenerateWeather();
@@ -197,12 +257,15 @@ private:
 
 	void FillCollisionSets();
 
-	void DoCollisions(Projectile &projectile);
+	void FindCollisions();
+	void FindCollisions(const Projectile &projectile, size_t index, ProjectileHits &hits) const;
+	void DoCollisions(Projectile &projectile, const ProjectileHits &hits);
 	void DoWeather(Weather &weather);
 	void DoCollection(Flotsam &flotsam);
 	void DoScanning(const std::shared_ptr<Ship> &ship);
 
 	void FillRadar();
+	void FillBatchDraw();
 
 	void DrawShipSprites(const Ship &ship);
 
@@ -216,10 +279,10 @@ private:
 private:
 	PlayerInfo &player;
 
-	std::list<std::shared_ptr<Ship>> ships;
+	std::vector<std::shared_ptr<Ship>> ships;
 	std::vector<Projectile> projectiles;
 	std::vector<Weather> activeWeather;
-	std::list<std::shared_ptr<Flotsam>> flotsam;
+	std::vector<std::shared_ptr<Flotsam>> flotsam;
 	std::vector<Visual> visuals;
 	AsteroidField asteroids;
 
@@ -233,6 +296,33 @@ private:
 	// tractor beams ready to fire.
 	std::vector<Ship *> hasAntiMissile;
 	std::vector<Ship *> hasTractorBeam;
+	// Where those ships are, so that each missile or flotsam only has to be
+	// checked against the ones that can reach it.
+	RangeGrid antiMissileGrid;
+	RangeGrid tractorBeamGrid;
+
+	// When each of the current system's fleets and hazards will next try to
+	// spawn, and what the schedules were made for.
+	RandomEventSchedule fleetSchedule;
+	RandomEventSchedule hazardSchedule;
+	const System *scheduledSystem = nullptr;
+	// The stellar object each scheduled hazard belongs to (or -1 for the
+	// system itself), and its index in that object's list of hazards.
+	std::vector<std::pair<int, size_t>> scheduledHazards;
+	// The chances and hazards that the schedules should have on this step,
+	// which are compared against what they were made with.
+	std::vector<double> fleetChances;
+	std::vector<double> hazardChances;
+	std::vector<std::pair<int, size_t>> hazardSources;
+	// The persons that may appear in the current system, and the total of the
+	// frequencies of those that can appear right now, in the same order.
+	const System *personSystem = nullptr;
+	std::vector<const std::pair<const std::string, Person> *> personCandidates;
+	std::vector<int> personWeights;
+
+	// The projectiles that are moving this step, and their positions and velocities.
+	std::vector<Projectile *> movingProjectiles;
+	Kinematics projectileKinematics;
 
 	AI ai;
 
@@ -245,8 +335,18 @@ private:
 	// currently rendering buffer.
 	size_t currentCalcBuffer = 0;
 	size_t currentDrawBuffer = 0;
+	bool isThisStepDrawn = true;
+	bool isNextStepDrawn = true;
+	// Whether the calculation thread is filling in the draw buffers.
+	bool isPreparingDraw = true;
+	// The number of allocations the calculation thread made in the last step.
+	// This is read while the next step is being calculated.
+	std::atomic<int64_t> stepAllocations = 0;
 	DrawList draw[2];
 	BatchDrawList batchDraw[2];
+	// The parts of the batch draw list that are filled in on different threads,
+	// before being appended to it in order.
+	std::vector<BatchDrawList> batchDrawParts;
 	Radar radar[2];
 
 	bool wasActive = false;
@@ -280,15 +380,27 @@ private:
 	int step = 0;
 	// Count steps for UI elements separately, because they shouldn't be affected by pausing.
 	mutable int uiStep = 0;
+	double drawProgress = 0.;
 	bool timePaused = false;
 
-	std::list<ShipEvent> eventQueue;
-	std::list<ShipEvent> events;
+	// The events of the step being calculated, and of the last one. These are
+	// swapped each step, so both keep their capacity rather than reallocating.
+	std::vector<ShipEvent> eventQueue;
+	std::vector<ShipEvent> events;
 	// Keep track of who has asked for help in fighting whom.
 	std::map<const Government *, std::weak_ptr<const Ship>> grudge;
 	int grudgeTime = 0;
 
 	CollisionSet shipCollisions;
+	// The results of the batched query for collisions between projectiles and ships.
+	std::vector<const Projectile *> shipLineQueries;
+	std::vector<Collision> shipLineCollisions;
+	std::vector<unsigned> shipLineOffsets;
+	// What each projectile might hit during the current step. This is never
+	// shrunk, so that the buffers can be reused from one step to the next.
+	std::vector<ProjectileHits> projectileHits;
+	// How each ship is shown on the radar during the current step.
+	std::vector<RadarShip> radarShips;
 
 	int alarmTime = 0;
 	int nukeAlarmTime = 0;
@@ -304,6 +416,8 @@ private:
 	// Commands that are currently active (and not yet handled). This is a combination
 	// of keyboard and mouse commands (and any other available input device).
 	Command activeCommands;
+	// The commands that the player gave for the step that was begun last.
+	Command stepCommands;
 	// Keyboard commands that were active in the previous step.
 	Command keyHeld;
 	// Pressing "land" or "board" rapidly toggles targets; pressing it once re-engages landing or boarding.
@@ -15,11 +15,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Entity.h"
 
+using namespace std;
+
 
 
 const Outfit &Entity::Attributes() const
 {
-	return attributes;
+	return *attributes;
 }
 
 
@@ -29,3 +31,12 @@ double Entity::Heat() const
 	double maximum = this->MaximumHeat();
 	return maximum ? heat / maximum : 1.;
 }
+
+
+
+Outfit &Entity::MutableAttributes()
+{
+	if(attributes.use_count() > 1)
+		attributes = make_shared<Outfit>(*attributes);
+	return *attributes;
+}
@@ -19,6 +19,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Outfit.h"
 
+#include <memory>
+
 
 
 // A class containing common elements for objects like ships and minable asteroids.
@@ -39,7 +41,15 @@ protected:
 
 
 protected:
-	Outfit attributes;
+	// Get the attributes for modifying them, first making a copy of them if
+	// they are still shared with the entity this one was copied from.
+	Outfit &MutableAttributes();
+
+
+protected:
+	// The attributes are shared by all the copies of an entity, such as the
+	// ships in a fleet, until one of them changes them.
+	std::shared_ptr<Outfit> attributes = std::make_shared<Outfit>();
 	// The current heat value of this entity.
 	double heat = 0.;
 };
@@ -27,6 +27,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 
 #include <algorithm>
+#include <map>
 #include <set>
 
 using namespace std;
@@ -230,9 +231,14 @@ void EscortDisplay::Icon::Merge(const Icon &other)
 
 void EscortDisplay::MergeStacks(int maxHeight) const
 {
-	if(icons.empty())
+	if(icons.empty() || MergeAsBefore(maxHeight))
 		return;
 
+	// Remember which ship each icon started out with.
+	map<const Ship *, size_t> indices;
+	for(const Icon &icon : icons)
+		indices.emplace(icon.ships.front().lock().get(), indices.size());
+
 	set<const Sprite *> unstackable;
 	while(true)
 	{
@@ -282,4 +288,54 @@ void EscortDisplay::MergeStacks(int maxHeight) const
 		}
 		unstackable.insert(sprite);
 	}
+
+	// Record which icon each one was merged into, for the next frame.
+	lastStacks.resize(indices.size());
+	for(const Icon &icon : icons)
+	{
+		const size_t root = indices[icon.ships.front().lock().get()];
+		for(const weak_ptr<Ship> &ship : icon.ships)
+			lastStacks[indices[ship.lock().get()]] = root;
+	}
+}
+
+
+
+// Merge the icons the same way they were merged the last time, if nothing
+// that decides which icons are merged has changed since then.
+bool EscortDisplay::MergeAsBefore(int maxHeight) const
+{
+	bool isSame = (maxHeight == lastMaxHeight && icons.size() == lastIcons.size());
+	lastIcons.resize(icons.size());
+	auto last = lastIcons.begin();
+	for(const Icon &icon : icons)
+	{
+		auto current = make_tuple(icon.ships.front().lock().get(), icon.sprite, icon.isHostile, icon.system, icon.cost);
+		if(*last != current)
+		{
+			isSame = false;
+			*last = std::move(current);
+		}
+		++last;
+	}
+	lastMaxHeight = maxHeight;
+	if(!isSame || lastStacks.size() != icons.size())
+		return false;
+
+	// Each icon is merged into an icon that comes before it.
+	vector<Icon *> roots;
+	roots.reserve(icons.size());
+	size_t index = 0;
+	for(auto it = icons.begin(); it != icons.end(); ++index)
+	{
+		roots.push_back(&*it);
+		if(lastStacks[index] == index)
+			++it;
+		else
+		{
+			roots[lastStacks[index]]->Merge(*it);
+			it = icons.erase(it);
+		}
+	}
+	return true;
 }
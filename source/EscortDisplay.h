@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <list>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 class Interface;
@@ -74,10 +75,19 @@ private:
 
 private:
 	void MergeStacks(int maxHeight) const;
+	// Merge the icons the same way they were merged the last time, if nothing
+	// that decides which icons are merged has changed since then.
+	bool MergeAsBefore(int maxHeight) const;
 
 
 private:
 	mutable std::list<Icon> icons;
+	// Everything about each icon that decides how it is merged: the ship, its
+	// sprite, whether it is hostile, the system it is in, and its cost.
+	mutable std::vector<std::tuple<const Ship *, const Sprite *, bool, std::string, int64_t>> lastIcons;
+	mutable int lastMaxHeight = 0;
+	// The index of the icon that each icon was merged into, or its own index.
+	mutable std::vector<size_t> lastStacks;
 	mutable std::vector<std::vector<std::weak_ptr<Ship>>> stacks;
 	mutable std::vector<Rectangle> zones;
 
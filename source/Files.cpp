@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Files.h"
 
 #include "Logger.h"
+#include "PackFile.h"
 #include "ZipFile.h"
 
 #include <SDL2/SDL.h>
@@ -289,13 +290,12 @@ vector<filesystem::path> Files::List(const filesystem::path &directory)
 
 	if(!Exists(directory) || !is_directory(directory))
 	{
-		// Check if the requested file is in a known zip.
-		shared_ptr<ZipFile> zip = GetZipFile(directory);
-		if(zip)
-		{
+		// Check if the requested file is in a known pack or zip.
+		if(shared_ptr<const PackFile> pack = PackFile::Get(directory))
+			list = pack->ListFiles(directory, false, false);
+		else if(shared_ptr<ZipFile> zip = GetZipFile(directory))
 			list = zip->ListFiles(directory, false, false);
-			sort(list.begin(), list.end());
-		}
+		sort(list.begin(), list.end());
 		return list;
 	}
 
@@ -318,13 +318,12 @@ vector<filesystem::path> Files::ListDirectories(const filesystem::path &director
 
 	if(!Exists(directory) || !is_directory(directory))
 	{
-		// Check if the requested file is in a known zip.
-		shared_ptr<ZipFile> zip = GetZipFile(directory);
-		if(zip)
-		{
+		// Check if the requested file is in a known pack or zip.
+		if(shared_ptr<const PackFile> pack = PackFile::Get(directory))
+			list = pack->ListFiles(directory, false, true);
+		else if(shared_ptr<ZipFile> zip = GetZipFile(directory))
 			list = zip->ListFiles(directory, false, true);
-			sort(list.begin(), list.end());
-		}
+		sort(list.begin(), list.end());
 		return list;
 	}
 
@@ -343,13 +342,12 @@ vector<filesystem::path> Files::RecursiveList(const filesystem::path &directory)
 	vector<filesystem::path> list;
 	if(!Exists(directory) || !is_directory(directory))
 	{
-		// Check if the requested file is in a known zip.
-		shared_ptr<ZipFile> zip = GetZipFile(directory);
-		if(zip)
-		{
+		// Check if the requested file is in a known pack or zip.
+		if(shared_ptr<const PackFile> pack = PackFile::Get(directory))
+			list = pack->ListFiles(directory, true, false);
+		else if(shared_ptr<ZipFile> zip = GetZipFile(directory))
 			list = zip->ListFiles(directory, true, false);
-			sort(list.begin(), list.end());
-		}
+		sort(list.begin(), list.end());
 		return list;
 	}
 
@@ -368,6 +366,8 @@ bool Files::Exists(const filesystem::path &filePath)
 	if(exists(filePath))
 		return true;
 
+	if(shared_ptr<const PackFile> pack = PackFile::Get(filePath))
+		return pack->Exists(filePath);
 	shared_ptr<ZipFile> zip = GetZipFile(filePath);
 	if(zip)
 		return zip->Exists(filePath);
@@ -403,6 +403,32 @@ bool Files::Copy(const filesystem::path &from, const filesystem::path &to)
 
 
 
+// Make the second path refer to the same contents as the first one, without
+// copying them if the file system allows it. This is only safe for files that
+// are never written in place, but always replaced by moving a new file over them.
+bool Files::Link(const filesystem::path &from, const filesystem::path &to)
+{
+	// Link under a temporary name and move that into place, so that an existing
+	// file is replaced at once.
+	filesystem::path temporary = to;
+	temporary += ".tmp";
+	error_code error;
+	filesystem::remove(temporary, error);
+	filesystem::create_hard_link(from, temporary, error);
+	if(error)
+		return Copy(from, to);
+
+	filesystem::rename(temporary, to, error);
+	if(error)
+	{
+		filesystem::remove(temporary, error);
+		return Copy(from, to);
+	}
+	return true;
+}
+
+
+
 void Files::Move(const filesystem::path &from, const filesystem::path &to)
 {
 	rename(from, to);
@@ -438,7 +464,9 @@ shared_ptr<iostream> Files::Open(const filesystem::path &path, bool write)
 {
 	if(!exists(path) && !write)
 	{
-		// Writing to a zip is not supported.
+		// Writing to a pack or a zip is not supported.
+		if(shared_ptr<const PackFile> pack = PackFile::Get(path))
+			return shared_ptr<iostream>(new stringstream(pack->ReadFile(path), ios::in | ios::binary));
 		shared_ptr<ZipFile> zip = GetZipFile(path);
 		if(zip)
 			return shared_ptr<iostream>(new stringstream(zip->ReadFile(path), ios::in | ios::binary));
@@ -458,6 +486,14 @@ shared_ptr<iostream> Files::Open(const filesystem::path &path, bool write)
 
 string Files::Read(const filesystem::path &path)
 {
+	// Files in a zip are decompressed directly into the result.
+	if(!exists(path))
+	{
+		if(shared_ptr<const PackFile> pack = PackFile::Get(path))
+			return pack->ReadFile(path);
+		shared_ptr<ZipFile> zip = GetZipFile(path);
+		return zip ? zip->ReadFile(path) : string();
+	}
 	return Read(Open(path));
 }
 
@@ -467,7 +503,21 @@ string Files::Read(shared_ptr<iostream> file)
 {
 	if(!file)
 		return "";
-	return string{istreambuf_iterator<char>{*file}, {}};
+
+	// If the size of the file is known, read it all at once rather than one
+	// character at a time.
+	file->seekg(0, ios::end);
+	const streamoff size = file->tellg();
+	file->seekg(0, ios::beg);
+	if(size <= 0 || !*file)
+	{
+		file->clear();
+		return string{istreambuf_iterator<char>{*file}, {}};
+	}
+	string data(size, '\0');
+	file->read(data.data(), size);
+	data.resize(file->gcount());
+	return data;
 }
 
 
@@ -58,6 +58,10 @@ public:
 	static bool Exists(const std::filesystem::path &filePath);
 	static std::filesystem::file_time_type Timestamp(const std::filesystem::path &filePath);
 	static bool Copy(const std::filesystem::path &from, const std::filesystem::path &to);
+	// Make the second path refer to the same contents as the first one, without
+	// copying them if the file system allows it. This is only safe for files that
+	// are never written in place, but always replaced by moving a new file over them.
+	static bool Link(const std::filesystem::path &from, const std::filesystem::path &to);
 	static void Move(const std::filesystem::path &from, const std::filesystem::path &to);
 	static void Delete(const std::filesystem::path &filePath);
 
@@ -102,10 +102,9 @@ Point FormationPositioner::Position(const Ship *ship)
 // Re-generate the list of (relative) positions for the ships in the formation.
 void FormationPositioner::CalculatePositions()
 {
-	// Run the position iterator for the ships in the formation.
-	auto itPos = pattern->begin(centerBodyRadius);
+	CalculateSlots(shipsInFormation.size());
 
-	// Run the iterator.
+	// Assign the slots to the ships in the formation, in order.
 	size_t shipIndex = 0;
 	while(shipIndex < shipsInFormation.size())
 	{
@@ -137,12 +136,11 @@ void FormationPositioner::CalculatePositions()
 		{
 			// Calculate the new coordinate for the current ship.
 			Point &shipRelPos = itCoor->second.first;
-			shipRelPos = *itPos;
+			shipRelPos = slots[shipIndex];
 			if(flippedY)
 				shipRelPos.Set(-shipRelPos.X(), shipRelPos.Y());
 			if(flippedX)
 				shipRelPos.Set(shipRelPos.X(), -shipRelPos.Y());
-			++itPos;
 			++shipIndex;
 		}
 	}
@@ -153,6 +151,27 @@ void FormationPositioner::CalculatePositions()
 
 
 
+// Make sure that the coordinates of the pattern's first count slots are known.
+void FormationPositioner::CalculateSlots(size_t count)
+{
+	if(slots.size() >= count)
+		return;
+
+	// The pattern can only be iterated from the start, so calculate some
+	// extra slots to leave room for the formation to grow.
+	count = max<size_t>(count, 2 * slots.size());
+	slots.clear();
+	slots.reserve(count);
+	auto itPos = pattern->begin(centerBodyRadius);
+	while(slots.size() < count)
+	{
+		slots.push_back(*itPos);
+		++itPos;
+	}
+}
+
+
+
 void FormationPositioner::CalculateDirection()
 {
 	// Any direction is fine, just keep initial direction.
@@ -17,8 +17,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Angle.h"
 
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 class Body;
@@ -45,6 +45,8 @@ public:
 private:
 	// Re-generate the list of (relative) positions for the ships in the formation.
 	void CalculatePositions();
+	// Make sure that the coordinates of the pattern's first count slots are known.
+	void CalculateSlots(size_t count);
 
 	// Calculate the direction the formation is facing.
 	void CalculateDirection();
@@ -64,7 +66,11 @@ private:
 	std::vector<std::weak_ptr<const Ship>> shipsInFormation;
 	// Lookup/cache of the ship coordinates in the formation, its ring-section and
 	// an indicator if it was seen since last generate loop.
-	std::map<const Ship *, std::pair<Point, bool>> shipPositions;
+	std::unordered_map<const Ship *, std::pair<Point, bool>> shipPositions;
+	// The coordinates of the slots in the pattern, in the order in which they
+	// are handed out. These only depend on the pattern and the center radius,
+	// so they are only calculated once.
+	std::vector<Point> slots;
 
 	// Timer that controls the (re)generation of ship positions.
 	int positionsTimer = 0;
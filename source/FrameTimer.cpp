@@ -19,12 +19,20 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #define STRICT
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
-#else
-#include <thread>
 #endif
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 using namespace std;
 
+namespace {
+	// Put a limit on how early a sleep may end, so that a single very late
+	// wakeup can't turn the wait into a busy loop.
+	const chrono::steady_clock::duration MAX_SLACK = chrono::milliseconds(4);
+}
+
 
 
 // Create a timer that is just responsible for measuring the time that
@@ -32,6 +40,7 @@ using namespace std;
 FrameTimer::FrameTimer()
 {
 	next = chrono::steady_clock::now();
+	lastFrame = next;
 }
 
 
@@ -44,6 +53,7 @@ FrameTimer::FrameTimer(int fps, int maxLagMsec)
 	maxLag(chrono::milliseconds(maxLagMsec))
 {
 	next = chrono::steady_clock::now();
+	lastFrame = next;
 	Step();
 }
 
@@ -65,20 +75,38 @@ void FrameTimer::Wait()
 		if(now + step + maxLag < next)
 			next = now + step;
 
+		// Sleep until shortly before the frame should begin, leaving as much time
+		// as the OS timer has recently overshot by, then yield until it arrives.
 		// The Winpthreads implementation of sleep on MinGW > 8 is inaccurate when
 		// compared to the native Windows Sleep function.
 		// See the thread starting with https://sourceforge.net/p/mingw-w64/mailman/message/37013810/.
+		chrono::steady_clock::time_point wake = next - slack;
+		if(now < wake)
+		{
 #ifdef _WIN32
-		Sleep(chrono::duration_cast<chrono::milliseconds>(next - now).count());
+			Sleep(chrono::duration_cast<chrono::milliseconds>(wake - now).count());
 #else
-		this_thread::sleep_until(next);
+			this_thread::sleep_until(wake);
 #endif
-		now = chrono::steady_clock::now();
+			now = chrono::steady_clock::now();
+			// Track the overshoot with a moving average, so that one late wakeup
+			// only has a small effect on the next sleep.
+			chrono::steady_clock::duration late = max(now - wake, chrono::steady_clock::duration::zero());
+			slack = min((slack * 7 + late) / 8, min(MAX_SLACK, step / 2));
+		}
+		while(now < next)
+		{
+			this_thread::yield();
+			now = chrono::steady_clock::now();
+		}
 	}
 	// If the lag is too high, don't try to do catch-up.
 	if(now - next > maxLag)
 		next = now;
 
+	frameTimes[frameCount++ % frameTimes.size()] = now - lastFrame;
+	lastFrame = now;
+
 	Step();
 }
 
@@ -101,6 +129,29 @@ void FrameTimer::SetFrameRate(int fps)
 
 
 
+// Get the distribution of the most recent frame times.
+FrameTimer::Percentiles FrameTimer::FrameTimes() const
+{
+	Percentiles result;
+	size_t count = min(frameCount, frameTimes.size());
+	if(!count)
+		return result;
+
+	vector<chrono::steady_clock::duration> sorted(frameTimes.begin(), frameTimes.begin() + count);
+	auto Get = [&sorted](double fraction) -> chrono::steady_clock::duration
+	{
+		auto it = sorted.begin() + min(static_cast<size_t>(fraction * sorted.size()), sorted.size() - 1);
+		nth_element(sorted.begin(), it, sorted.end());
+		return *it;
+	};
+	result.p50 = Get(.5);
+	result.p95 = Get(.95);
+	result.p99 = Get(.99);
+	return result;
+}
+
+
+
 // Calculate when the next frame should begin.
 void FrameTimer::Step()
 {
@@ -15,7 +15,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <cstddef>
 
 
 
@@ -24,6 +26,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // the graphics cannot keep up it will allow things to go slower for a few frames
 // without trying to "catch up" by making the subsequent frame faster.
 class FrameTimer {
+public:
+	// How long recent frames took, from the start of one to the start of the next.
+	class Percentiles {
+	public:
+		std::chrono::steady_clock::duration p50{};
+		std::chrono::steady_clock::duration p95{};
+		std::chrono::steady_clock::duration p99{};
+	};
+
+
 public:
 	// Create a timer that is just responsible for measuring the time that
 	// elapses until Time() is called.
@@ -41,6 +53,10 @@ public:
 	// Change the frame rate (for viewing in slow motion).
 	void SetFrameRate(int fps);
 
+	// Get the distribution of the most recent frame times. This is empty
+	// until at least one frame has been waited for.
+	Percentiles FrameTimes() const;
+
 
 private:
 	// Calculate when the next frame should begin.
@@ -51,4 +67,13 @@ private:
 	std::chrono::steady_clock::time_point next;
 	std::chrono::steady_clock::duration step;
 	std::chrono::steady_clock::duration maxLag;
+
+	// How much later than asked for the OS wakes this thread up, on average.
+	// Sleeps end this much early, and the remainder is spent yielding.
+	std::chrono::steady_clock::duration slack{};
+
+	// The times of the most recent frames, used as a ring buffer.
+	std::array<std::chrono::steady_clock::duration, 240> frameTimes{};
+	size_t frameCount = 0;
+	std::chrono::steady_clock::time_point lastFrame;
 };
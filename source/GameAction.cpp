@@ -85,6 +85,15 @@ namespace {
 			cargo.Remove(outfit, moved);
 			didCargo = true;
 		}
+		// If all of them fit, install them at once rather than one at a time.
+		// Otherwise, find out how many fit by installing them one by one.
+		const int fits = count ? flagship->Attributes().CanAdd(*outfit, count) : 0;
+		if(count && (count > 0 ? fits >= count : fits <= count))
+		{
+			flagship->AddOutfit(outfit, count);
+			didShip = true;
+			count = 0;
+		}
 		while(count)
 		{
 			int moved = (count > 0) ? 1 : -1;
@@ -40,7 +40,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "image/ImageFileData.h"
 #include "image/ImageSet.h"
 #include "Interface.h"
+#include "JumpTable.h"
 #include "shader/LineShader.h"
+#include "LocationFilter.h"
 #include "image/MaskManager.h"
 #include "Minable.h"
 #include "Mission.h"
@@ -51,20 +53,26 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Person.h"
 #include "Phrase.h"
 #include "Planet.h"
+#include "PlayerInfo.h"
 #include "Plugins.h"
 #include "Preferences.h"
 #include "shader/PointerShader.h"
 #include "Politics.h"
 #include "RenderBuffer.h"
+#include "RouteTable.h"
 #include "shader/RingShader.h"
 #include "Ship.h"
+#include "ShipJumpNavigation.h"
 #include "image/Sprite.h"
 #include "image/SpriteLoadManager.h"
 #include "shader/SpriteShader.h"
 #include "shader/StarField.h"
 #include "StartConditions.h"
+#include "StartupProfile.h"
 #include "System.h"
+#include "TaskGroup.h"
 #include "TaskQueue.h"
+#include "text/TextBatch.h"
 #include "text/Translation.h"
 #include "test/Test.h"
 #include "test/TestData.h"
@@ -75,6 +83,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <filesystem>
 #include <iostream>
 #include <queue>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -108,6 +117,9 @@ namespace {
 
 	ConditionsStore globalConditions;
 
+	// While changed data files are being reloaded, only their objects are checked for references.
+	const set<string> *referenceScope = nullptr;
+
 	void LoadPlugin(TaskQueue &queue, const filesystem::path &path)
 	{
 		const auto *plugin = Plugins::Load(path);
@@ -146,13 +158,42 @@ namespace {
 			SpriteLoadManager::LoadSprite(queue, icon);
 		}
 	}
+
+	// Get every object that is in the given set now, so that the ones that are
+	// added to it later can be told apart.
+	template<class Type>
+	set<const Type *> Contents(const Set<Type> &objects)
+	{
+		set<const Type *> contents;
+		for(const auto &it : objects)
+			contents.insert(&it.second);
+		return contents;
+	}
+
+	// Give a default state to every object that was added to the given set after
+	// its contents were recorded. This is needed when objects are first referred
+	// to after the default state was saved, so that reverting to it does not
+	// remove objects that are still being pointed to. Objects that were already
+	// in the set, such as those that events created, are left alone.
+	template<class Type>
+	void AddDefaults(const Set<Type> &current, const set<const Type *> &before, Set<Type> &defaults)
+	{
+		// Objects are never removed while a mission is parsed, so if the sizes
+		// match, nothing was added.
+		if(static_cast<size_t>(current.size()) == before.size())
+			return;
+		for(const auto &it : current)
+			if(!before.contains(&it.second) && !defaults.Has(it.first))
+				defaults.Get(it.first);
+	}
 }
 
 
 
 shared_future<void> GameData::BeginLoad(TaskQueue &queue, const PlayerInfo &player,
-		bool onlyLoadData, bool debugMode, bool preventUpload)
+		bool onlyLoadData, bool debugMode, bool preventUpload, bool loadLazily)
 {
+	StartupProfile::Scope scope("GameData::BeginLoad");
 	if(preventUpload)
 		SpriteLoadManager::PreventSpriteUpload();
 	SpriteLoadManager::FindDeferredFolders();
@@ -169,24 +210,14 @@ shared_future<void> GameData::BeginLoad(TaskQueue &queue, const PlayerInfo &play
 		});
 	}
 
-	return objects.Load(queue, sources, player, &globalConditions, debugMode);
+	return objects.Load(queue, sources, player, &globalConditions, debugMode, loadLazily);
 }
 
 
 
 void GameData::FinishLoading()
 {
-	// Store the current state, to revert back to later.
-	defaultFleets = objects.fleets;
-	defaultGovernments = objects.governments;
-	defaultPlanets = objects.planets;
-	defaultSystems = objects.systems;
-	defaultGalaxies = objects.galaxies;
-	defaultShipSales = objects.shipSales;
-	defaultOutfitSales = objects.outfitSales;
-	defaultWormholes = objects.wormholes;
-	defaultPersons = objects.persons;
-	defaultSubstitutions = objects.substitutions;
+	StoreDefaults();
 
 	activeGamerules = objects.gamerulesPresets.Get("Default");
 	playerGovernment = objects.governments.Get("Escort");
@@ -197,16 +228,92 @@ void GameData::FinishLoading()
 
 
 
+// Parse the rest of a stock mission that was loaded lazily.
+void GameData::LoadDeferredMission(const Mission &mission)
+{
+	const auto fleets = Contents(objects.fleets);
+	const auto governments = Contents(objects.governments);
+	const auto planets = Contents(objects.planets);
+	const auto systems = Contents(objects.systems);
+	const auto galaxies = Contents(objects.galaxies);
+	const auto shipSales = Contents(objects.shipSales);
+	const auto outfitSales = Contents(objects.outfitSales);
+	const auto wormholes = Contents(objects.wormholes);
+	const auto persons = Contents(objects.persons);
+
+	objects.missions.Get(mission.TrueName())->LoadDeferred();
+
+	// If this mission had been fully parsed while the game data was being loaded,
+	// any objects that it refers to would have been part of the default state.
+	AddDefaults(objects.fleets, fleets, defaultFleets);
+	AddDefaults(objects.governments, governments, defaultGovernments);
+	AddDefaults(objects.planets, planets, defaultPlanets);
+	AddDefaults(objects.systems, systems, defaultSystems);
+	AddDefaults(objects.galaxies, galaxies, defaultGalaxies);
+	AddDefaults(objects.shipSales, shipSales, defaultShipSales);
+	AddDefaults(objects.outfitSales, outfitSales, defaultOutfitSales);
+	AddDefaults(objects.wormholes, wormholes, defaultWormholes);
+	AddDefaults(objects.persons, persons, defaultPersons);
+}
+
+
+
 void GameData::CheckReferences()
 {
-	objects.CheckReferences();
+	StartupProfile::Scope scope("GameData::CheckReferences");
+	objects.CheckReferences(referenceScope);
+}
+
+
+
+// Keep track of the data files that are loaded, so that they can be reloaded
+// while the game is running. This must be called before BeginLoad().
+void GameData::WatchDataFiles()
+{
+	objects.WatchFiles();
+}
+
+
+
+// Check whether any watched data files have changed since they were loaded.
+bool GameData::HasChangedData()
+{
+	return !objects.ChangedFiles().empty();
+}
+
+
+
+// Reload any data files that have changed since they were loaded, and reload
+// the player's last save on top of them. Returns whether anything changed.
+bool GameData::ReloadChangedData(PlayerInfo &player)
+{
+	const vector<filesystem::path> changed = objects.ChangedFiles();
+	if(changed.empty())
+		return false;
+
+	// The changed files must be applied to the default state of the universe,
+	// so that none of the player's changes become part of it.
+	Revert();
+	const set<string> tokens = objects.Reload(changed, player, &globalConditions);
+	StoreDefaults();
+	activeGamerules = objects.gamerulesPresets.Get("Default");
+	playerGovernment = objects.governments.Get("Escort");
+
+	// Only warn about objects that the reloaded files refer to.
+	referenceScope = &tokens;
+	if(player.IsLoaded())
+		player.Reload();
+	else
+		CheckReferences();
+	referenceScope = nullptr;
+	return true;
 }
 
 
 
 void GameData::LoadSettings()
 {
-	Translation::SetLanguage(Preferences::Language());
+	Translation::Load(Preferences::Language());
 	Command::LoadSettings(Files::Resources() / "keys.txt");
 	Command::LoadSettings(Files::Config() / "keys.txt");
 }
@@ -215,6 +322,7 @@ void GameData::LoadSettings()
 
 void GameData::LoadShaders()
 {
+	StartupProfile::Scope scope("GameData::LoadShaders");
 	// The found shader files. The first element is the vertex shader,
 	// the second is the fragment shader.
 	map<string, pair<string, string>> loaded;
@@ -257,6 +365,7 @@ void GameData::LoadShaders()
 	SpriteShader::Init();
 	BatchShader::Init();
 	RenderBuffer::Init();
+	TextBatch::Init();
 
 	FontSet::Add(Files::Images() / "font/ubuntu14r.png", 14, "en");
 	FontSet::Add(Files::Images() / "font/ubuntu18r.png", 18, "en");
@@ -293,6 +402,20 @@ bool GameData::IsLoaded()
 
 
 
+double GameData::GetMenuProgress()
+{
+	return min(SpriteLoadManager::Progress(), objects.GetProgress());
+}
+
+
+
+bool GameData::IsReadyForMenu()
+{
+	return GetMenuProgress() == 1.;
+}
+
+
+
 // Get the list of resource sources (i.e. plugin folders).
 const vector<filesystem::path> &GameData::Sources()
 {
@@ -322,6 +445,10 @@ void GameData::Revert()
 	objects.wormholes.Revert(defaultWormholes);
 	objects.persons.Revert(defaultPersons);
 	objects.substitutions.Revert(defaultSubstitutions);
+	LocationFilter::Invalidate();
+	JumpTable::Invalidate();
+	ShipJumpNavigation::Invalidate();
+	objects.tradeNetwork.Invalidate();
 
 	activeGamerules = objects.gamerulesPresets.Get("Default");
 
@@ -412,8 +539,8 @@ void GameData::WriteEconomy(DataWriter &out)
 				continue;
 
 			out.WriteToken(sit.second.TrueName());
-			for(const auto &cit : GameData::Commodities())
-				out.WriteToken(static_cast<int>(sit.second.Supply(cit.name)));
+			for(size_t i = 0; i < GameData::Commodities().size(); ++i)
+				out.WriteToken(static_cast<int>(sit.second.Supply(i)));
 			out.Write();
 		}
 	}
@@ -441,22 +568,7 @@ void GameData::StepEconomy()
 	// Finally, send out the trade goods. This has to be done in a separate step
 	// because otherwise whichever systems trade last would already have gotten
 	// supplied by the other systems.
-	for(auto &it : objects.systems)
-	{
-		System &system = it.second;
-		if(!system.Links().empty())
-			for(const Trade::Commodity &commodity : Commodities())
-			{
-				double supply = system.Supply(commodity.name);
-				for(const System *neighbor : system.Links())
-				{
-					double scale = neighbor->Links().size();
-					if(scale)
-						supply += neighbor->Exports(commodity.name) / scale;
-				}
-				system.SetSupply(commodity.name, supply);
-			}
-	}
+	objects.tradeNetwork.Distribute(objects.systems, Commodities());
 }
 
 
@@ -473,6 +585,13 @@ void GameData::AddPurchase(const System &system, const string &commodity, int to
 void GameData::Change(const DataNode &node, PlayerInfo &player)
 {
 	objects.Change(node, player);
+	// A change to a government may change where its ships are allowed to travel,
+	// and which other governments are its enemies.
+	if(node.Token(0) == "government")
+	{
+		RouteTable::Invalidate();
+		politics.UpdateAttitudes();
+	}
 }
 
 
@@ -482,6 +601,8 @@ void GameData::Change(const DataNode &node, PlayerInfo &player)
 void GameData::UpdateSystems()
 {
 	objects.UpdateSystems();
+	RouteTable::Invalidate();
+	ShipJumpNavigation::Invalidate();
 }
 
 
@@ -489,6 +610,8 @@ void GameData::UpdateSystems()
 void GameData::RecomputeWormholeRequirements()
 {
 	objects.RecomputeWormholeRequirements();
+	RouteTable::Invalidate();
+	JumpTable::Invalidate();
 }
 
 
@@ -624,6 +747,13 @@ const Set<Mission> &GameData::Missions()
 
 
 
+vector<const Mission *> GameData::MissionsOfferedAt(const Planet *planet)
+{
+	return objects.missionIndex.Candidates(planet);
+}
+
+
+
 const Set<News> &GameData::SpaceportNews()
 {
 	return objects.news;
@@ -949,10 +1079,10 @@ void GameData::LoadSources(TaskQueue &queue)
 	for(const auto &path : globalPlugins)
 		if(Plugins::IsPlugin(path))
 			LoadPlugin(queue, path);
-	// Load unzipped plugins first to give them precedence, then load the zipped plugins.
+	// Load unzipped plugins first to give them precedence, then load the packed and zipped plugins.
 	globalPlugins = Files::List(Files::GlobalPlugins());
 	for(const auto &path : globalPlugins)
-		if(path.extension() == ".zip" && Plugins::IsPlugin(path))
+		if((path.extension() == ".pack" || path.extension() == ".zip") && Plugins::IsPlugin(path))
 			LoadPlugin(queue, path);
 
 	vector<filesystem::path> localPlugins = Files::ListDirectories(Files::UserPlugins());
@@ -961,7 +1091,7 @@ void GameData::LoadSources(TaskQueue &queue)
 			LoadPlugin(queue, path);
 	localPlugins = Files::List(Files::UserPlugins());
 	for(const auto &path : localPlugins)
-		if(path.extension() == ".zip" && Plugins::IsPlugin(path))
+		if((path.extension() == ".pack" || path.extension() == ".zip") && Plugins::IsPlugin(path))
 			LoadPlugin(queue, path);
 }
 
@@ -969,30 +1099,60 @@ void GameData::LoadSources(TaskQueue &queue)
 
 map<string, shared_ptr<ImageSet>> GameData::FindImages()
 {
-	map<string, shared_ptr<ImageSet>> images;
-	for(const auto &source : sources)
+	// Walk each source's image directory in parallel, since with many plugins
+	// most of the time is spent waiting on the file system.
+	vector<vector<ImageFileData>> found(sources.size());
 	{
-		// All names will only include the portion of the path that comes after
-		// this directory prefix.
-		filesystem::path directoryPath = source / "images";
-
-		vector<filesystem::path> imageFiles = Files::RecursiveList(directoryPath);
-		for(auto &path : imageFiles)
-			if(ImageSet::IsImage(path))
-			{
-				ImageFileData data(path, directoryPath);
-
-				shared_ptr<ImageSet> &imageSet = images[data.name];
-				if(!imageSet)
-					imageSet.reset(new ImageSet(data.name));
-				imageSet->Add(std::move(data));
-			}
+		TaskGroup group;
+		for(size_t i = 0; i < sources.size(); ++i)
+			group.Run([&found, i]() -> void
+				{
+					StartupProfile::Scope scope("GameData::FindImages", sources[i]);
+					// All names will only include the portion of the path that comes after
+					// this directory prefix.
+					filesystem::path directoryPath = sources[i] / "images";
+
+					vector<filesystem::path> imageFiles = Files::RecursiveList(directoryPath);
+					for(auto &path : imageFiles)
+						if(ImageSet::IsImage(path))
+							found[i].emplace_back(path, directoryPath);
+				});
+		group.Wait();
 	}
+
+	// Add the images in the order of their sources, so that images from later
+	// sources still take precedence.
+	map<string, shared_ptr<ImageSet>> images;
+	for(vector<ImageFileData> &list : found)
+		for(ImageFileData &data : list)
+		{
+			shared_ptr<ImageSet> &imageSet = images[data.name];
+			if(!imageSet)
+				imageSet.reset(new ImageSet(data.name));
+			imageSet->Add(std::move(data));
+		}
 	return images;
 }
 
 
 
+// Store the current state, to revert back to later.
+void GameData::StoreDefaults()
+{
+	defaultFleets = objects.fleets;
+	defaultGovernments = objects.governments;
+	defaultPlanets = objects.planets;
+	defaultSystems = objects.systems;
+	defaultGalaxies = objects.galaxies;
+	defaultShipSales = objects.shipSales;
+	defaultOutfitSales = objects.outfitSales;
+	defaultWormholes = objects.wormholes;
+	defaultPersons = objects.persons;
+	defaultSubstitutions = objects.substitutions;
+}
+
+
+
 // Thread-safe way to draw the menu background.
 void GameData::DrawMenuBackground(Panel *panel)
 {
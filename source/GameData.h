@@ -82,15 +82,29 @@ class Wormhole;
 class GameData {
 public:
 	static std::shared_future<void> BeginLoad(TaskQueue &queue, const PlayerInfo &player,
-		bool onlyLoadData, bool debugMode, bool preventUpload);
+		bool onlyLoadData, bool debugMode, bool preventUpload, bool loadLazily = false);
 	static void FinishLoading();
+	// Parse the rest of a stock mission that was loaded lazily.
+	static void LoadDeferredMission(const Mission &mission);
 	// Check for objects that are referred to but never defined.
 	static void CheckReferences();
+	// Keep track of the data files that are loaded, so that they can be reloaded
+	// while the game is running. This must be called before BeginLoad().
+	static void WatchDataFiles();
+	// Check whether any watched data files have changed since they were loaded.
+	static bool HasChangedData();
+	// Reload any data files that have changed since they were loaded, and reload
+	// the player's last save on top of them. Returns whether anything changed.
+	static bool ReloadChangedData(PlayerInfo &player);
 	static void LoadSettings();
 	static void LoadShaders();
 	static double GetProgress();
 	// Whether initial game loading is complete (data, sprites and audio are loaded).
 	static bool IsLoaded();
+	// The progress of loading what the main menu needs, which is everything but
+	// the sounds. They can finish loading in the background once it is shown.
+	static double GetMenuProgress();
+	static bool IsReadyForMenu();
 
 	// Get the list of resource sources (i.e. plugin folders).
 	static const std::vector<std::filesystem::path> &Sources();
@@ -135,6 +149,8 @@ public:
 	static const Set<Message> &Messages();
 	static const Set<Minable> &Minables();
 	static const Set<Mission> &Missions();
+	// Get the missions that might be offered when landing on the given planet.
+	static std::vector<const Mission *> MissionsOfferedAt(const Planet *planet);
 	static const Set<News> &SpaceportNews();
 	static const Set<Outfit> &Outfits();
 	static const Set<Shop<Outfit>> &Outfitters();
@@ -199,4 +215,6 @@ public:
 private:
 	static void LoadSources(TaskQueue &queue);
 	static std::map<std::string, std::shared_ptr<ImageSet>> FindImages();
+	// Store the current state, to revert back to later.
+	static void StoreDefaults();
 };
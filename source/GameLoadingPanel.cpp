@@ -15,10 +15,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "GameLoadingPanel.h"
 
-#include "audio/Audio.h"
 #include "Conversation.h"
 #include "ConversationPanel.h"
 #include "GameData.h"
+#include "image/MaskCache.h"
 #include "image/MaskManager.h"
 #include "MenuAnimationPanel.h"
 #include "MenuPanel.h"
@@ -45,15 +45,16 @@ GameLoadingPanel::GameLoadingPanel(PlayerInfo &player, TaskQueue &queue, const C
 
 void GameLoadingPanel::Step()
 {
-	progress = GameData::GetProgress();
+	progress = GameData::GetMenuProgress();
 
 	queue.ProcessSyncTasks();
-	if(GameData::IsLoaded())
+	// The sounds may still be loading, but nothing in the menu needs them. The
+	// ones that have been loaded can already be played.
+	if(GameData::IsReadyForMenu())
 	{
-		// Now that we have finished loading all the basic sprites and sounds, we can look for invalid file paths,
-		// e.g. due to capitalization errors or other typos.
+		// Now that we have finished loading all the basic sprites, we can look for invalid file paths,
+		// e.g. due to capitalization errors or other typos. The sounds are checked once they are loaded.
 		SpriteSet::CheckReferences();
-		Audio::CheckReferences();
 		// Set the game's initial internal state.
 		GameData::FinishLoading();
 
@@ -62,6 +63,7 @@ void GameLoadingPanel::Step()
 		// All sprites with collision masks should also have their 1x scaled versions, so create
 		// any additional scaled masks from the default one.
 		GameData::GetMaskManager().ScaleMasks();
+		MaskCache::Save();
 
 		GetUI().Pop(this);
 		if(conversation.IsEmpty())
@@ -143,8 +143,8 @@ Government::Government()
 
 
 // Load a government's definition from a file.
-void Government::Load(const DataNode &node, const set<const System *> *visitedSystems,
-	const set<const Planet *> *visitedPlanets)
+void Government::Load(const DataNode &node, const IndexedSet<System> *visitedSystems,
+	const IndexedSet<Planet> *visitedPlanets)
 {
 	if(node.Size() >= 2)
 	{
@@ -528,6 +528,8 @@ void Government::Load(const DataNode &node, const set<const System *> *visitedSy
 	if(reputationMin > reputationMax)
 		reputationMin = reputationMax;
 	SetReputation(Reputation());
+
+	displayNameTranslation = Translation::Handle("government.", displayName);
 }
 
 
@@ -540,6 +542,14 @@ const string &Government::DisplayName() const
 
 
 
+// Get the display name in the current language.
+const string &Government::TranslatedDisplayName() const
+{
+	return displayNameTranslation.Get(displayName);
+}
+
+
+
 // Set / Get the true name used for this government in the data files.
 void Government::SetTrueName(const string &trueName)
 {
@@ -555,6 +565,14 @@ const string &Government::TrueName() const
 
 
 
+// Get the number that identifies this government.
+unsigned Government::Id() const
+{
+	return id;
+}
+
+
+
 // Get the color swizzle to use for ships of this government.
 const Swizzle *Government::GetSwizzle() const
 {
@@ -614,10 +632,17 @@ Government::PenaltyEffect Government::PenaltyFor(int eventType, const Government
 	if(it == customPenalties.end())
 		return PenaltyHelper(eventType, penalties);
 
-	map<int, PenaltyEffect> tempPenalties = penalties;
-	for(const auto &penalty : it->second)
-		tempPenalties[penalty.first] = penalty.second;
-	return PenaltyHelper(eventType, tempPenalties);
+	// Each custom penalty replaces the usual one for the same event, so only
+	// count the usual ones that have no replacement.
+	const map<int, PenaltyEffect> &custom = it->second;
+	PenaltyEffect penalty = PenaltyHelper(eventType, custom);
+	for(const auto &[type, effect] : penalties)
+		if((eventType & type) && !custom.contains(type))
+		{
+			penalty.reputationChange += effect.reputationChange;
+			penalty.specialPenalty = max(penalty.specialPenalty, effect.specialPenalty);
+		}
+	return penalty;
 }
 
 
@@ -856,7 +881,7 @@ Government::Atrocity Government::Condemns(const Outfit *outfit) const
 {
 	const auto it = atrocityOutfits.find(outfit);
 	return it != atrocityOutfits.cend() ? it->second
-		: Atrocity{!IgnoresUniversalAtrocities() && outfit->Get("atrocity") > 0., nullptr};
+		: Atrocity{!IgnoresUniversalAtrocities() && outfit->Attributes().Get(AttributeKey::ATROCITY) > 0., nullptr};
 }
 
 
@@ -865,7 +890,7 @@ Government::Atrocity Government::Condemns(const Ship *ship) const
 {
 	const auto it = atrocityShips.find(ship->TrueModelName());
 	return it != atrocityShips.cend() ? it->second
-		: Atrocity{!IgnoresUniversalAtrocities() && ship->BaseAttributes().Get("atrocity") > 0., nullptr};
+		: Atrocity{!IgnoresUniversalAtrocities() && ship->BaseAttributes().Get(AttributeKey::ATROCITY) > 0., nullptr};
 }
 
 
@@ -883,10 +908,10 @@ int Government::Fines(const Outfit *outfit) const
 	if(!fine)
 		return 0;
 
-	for(const auto &it : illegalOutfits)
-		if(it.first == outfit)
-			return it.second;
-	return IgnoresUniversalIllegals() ? 0 : outfit->Get("illegal");
+	const auto it = illegalOutfits.find(outfit);
+	if(it != illegalOutfits.end())
+		return it->second;
+	return IgnoresUniversalIllegals() ? 0 : outfit->Attributes().Get(AttributeKey::ILLEGAL);
 }
 
 
@@ -897,10 +922,10 @@ int Government::Fines(const Ship *ship) const
 	if(!fine)
 		return 0;
 
-	for(const auto &it : illegalShips)
-		if(it.first == ship->TrueModelName())
-			return it.second;
-	return IgnoresUniversalIllegals() ? 0 : ship->BaseAttributes().Get("illegal");
+	const auto it = illegalShips.find(ship->TrueModelName());
+	if(it != illegalShips.end())
+		return it->second;
+	return IgnoresUniversalIllegals() ? 0 : ship->BaseAttributes().Get(AttributeKey::ILLEGAL);
 }
 
 
@@ -17,9 +17,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Color.h"
 #include "ExclusiveItem.h"
+#include "IndexedSet.h"
 #include "LocationFilter.h"
 #include "RaidFleet.h"
 #include "Swizzle.h"
+#include "text/Translation.h"
 
 #include <limits>
 #include <map>
@@ -76,14 +78,19 @@ public:
 	Government();
 
 	// Load a government's definition from a file.
-	void Load(const DataNode &node, const std::set<const System *> *visitedSystems,
-		const std::set<const Planet *> *visitedPlanets);
+	void Load(const DataNode &node, const IndexedSet<System> *visitedSystems,
+		const IndexedSet<Planet> *visitedPlanets);
 
 	// Get the display name of this government.
 	const std::string &DisplayName() const;
+	// Get the display name in the current language.
+	const std::string &TranslatedDisplayName() const;
 	// Set / Get the true name used for this government in the data files.
 	void SetTrueName(const std::string &trueName);
 	const std::string &TrueName() const;
+	// Get the number that identifies this government. Governments are numbered
+	// from zero up in the order they are created.
+	unsigned Id() const;
 	// Get the color swizzle to use for ships of this government.
 	const Swizzle *GetSwizzle() const;
 	// Get the color to use for displaying this government on the map.
@@ -197,6 +204,8 @@ private:
 	unsigned id;
 	std::string trueName;
 	std::string displayName;
+	// The translation of the display name, which is keyed by the display name itself.
+	Translation::Handle displayNameTranslation;
 	const Swizzle *swizzle = Swizzle::None();
 	ExclusiveItem<Color> color;
 
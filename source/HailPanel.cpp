@@ -57,9 +57,9 @@ HailPanel::HailPanel(PlayerInfo &player, const shared_ptr<Ship> &ship, function<
 
 	const Government *gov = ship->GetGovernment();
 	if(!ship->GivenName().empty())
-		header = Translation::TrGovernment(gov->DisplayName()) + " " + ship->Noun() + " \"" + ship->GivenName() + "\":";
+		header = gov->TranslatedDisplayName() + " " + ship->Noun() + " \"" + ship->GivenName() + "\":";
 	else
-		header = ship->TranslatedDisplayModelName() + " (" + Translation::TrGovernment(gov->DisplayName()) + "):";
+		header = ship->TranslatedDisplayModelName() + " (" + gov->TranslatedDisplayName() + "):";
 	// Drones are always unpiloted, so they never respond to hails.
 	bool isMute = ship->GetPersonality().IsMute() || (ship->Attributes().Category() == "Drone");
 	hasLanguage = !isMute && (gov->Language().empty() || player.Conditions().Get("language: " + gov->Language()));
@@ -152,7 +152,7 @@ HailPanel::HailPanel(PlayerInfo &player, const StellarObject *object)
 
 	const Government *gov = planet ? planet->GetGovernment() : player.GetSystem()->GetGovernment();
 	if(planet)
-		header = Translation::TrGovernment(gov->DisplayName()) + " " + planet->Noun() + " \"" + planet->DisplayName() + "\":";
+		header = gov->TranslatedDisplayName() + " " + planet->Noun() + " \"" + planet->DisplayName() + "\":";
 	hasLanguage = (gov->Language().empty() || player.Conditions().Get("language: " + gov->Language()));
 
 	// If the player is hailing a planet, determine if a mission grants them clearance before checking
@@ -422,7 +422,7 @@ bool HailPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 					bribed = ship->GetGovernment();
 					bribed->Bribe();
 					{
-						map<string, string> rep = {{"gov", Translation::TrGovernment(bribed->DisplayName())}, {"credits", Format::CreditString(bribe)}};
+						map<string, string> rep = {{"gov", bribed->TranslatedDisplayName()}, {"credits", Format::CreditString(bribe)}};
 						Messages::Add({Translation::Tr("message.bribed_ship", rep),
 							GameData::MessageCategories().Get("normal")});
 					}
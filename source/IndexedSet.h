@@ -0,0 +1,155 @@
+/* IndexedSet.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Bitset.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <set>
+#include <vector>
+
+
+
+// A set of pointers to objects that are each given a number from 0 up, such as
+// systems and planets. Checking whether an object is in the set only has to
+// test one bit, rather than search a tree. Objects that have not been given a
+// number yet (Index() returns -1) are kept in an ordinary set instead.
+//
+// The objects can be iterated over like those of a std::set, but in the order
+// that they were inserted rather than sorted.
+template<class Type>
+class IndexedSet {
+public:
+	using const_iterator = typename std::vector<const Type *>::const_iterator;
+
+
+public:
+	bool contains(const Type *object) const;
+	size_t size() const noexcept;
+	bool empty() const noexcept;
+
+	const_iterator begin() const noexcept;
+	const_iterator end() const noexcept;
+
+	// Add the given object. Returns false if it was already in the set.
+	bool insert(const Type *object);
+	// Remove the given object. Returns false if it was not in the set.
+	bool erase(const Type *object);
+	void clear() noexcept;
+
+
+private:
+	// The bit for each object that has a number.
+	Bitset bits;
+	// Objects that did not have a number when they were inserted.
+	std::set<const Type *> unindexed;
+	// Every object in the set, for iterating over them.
+	std::vector<const Type *> objects;
+};
+
+
+
+template<class Type>
+bool IndexedSet<Type>::contains(const Type *object) const
+{
+	const int index = object->Index();
+	if(index >= 0 && static_cast<size_t>(index) < bits.Size() && bits.Test(index))
+		return true;
+	// An object may have been given its number after it was inserted.
+	return !unindexed.empty() && unindexed.contains(object);
+}
+
+
+
+template<class Type>
+size_t IndexedSet<Type>::size() const noexcept
+{
+	return objects.size();
+}
+
+
+
+template<class Type>
+bool IndexedSet<Type>::empty() const noexcept
+{
+	return objects.empty();
+}
+
+
+
+template<class Type>
+typename IndexedSet<Type>::const_iterator IndexedSet<Type>::begin() const noexcept
+{
+	return objects.begin();
+}
+
+
+
+template<class Type>
+typename IndexedSet<Type>::const_iterator IndexedSet<Type>::end() const noexcept
+{
+	return objects.end();
+}
+
+
+
+template<class Type>
+bool IndexedSet<Type>::insert(const Type *object)
+{
+	if(contains(object))
+		return false;
+
+	const int index = object->Index();
+	if(index < 0)
+		unindexed.insert(object);
+	else
+	{
+		if(static_cast<size_t>(index) >= bits.Size())
+			bits.Resize(index + 1);
+		bits.Set(index);
+	}
+	objects.push_back(object);
+	return true;
+}
+
+
+
+template<class Type>
+bool IndexedSet<Type>::erase(const Type *object)
+{
+	auto it = std::find(objects.begin(), objects.end(), object);
+	if(it == objects.end())
+		return false;
+
+	// Removing objects is rare, so it is fine for it to take linear time.
+	objects.erase(it);
+	unindexed.erase(object);
+	const int index = object->Index();
+	if(index >= 0 && static_cast<size_t>(index) < bits.Size())
+		bits.Reset(index);
+	return true;
+}
+
+
+
+template<class Type>
+void IndexedSet<Type>::clear() noexcept
+{
+	bits.Clear();
+	unindexed.clear();
+	objects.clear();
+}
@@ -46,10 +46,7 @@ bool Information::HasCustomRegion() const
 void Information::SetSprite(const string &name, const Sprite *sprite, const Point &unit,
 	float frame, const Swizzle *swizzle)
 {
-	sprites[name] = sprite;
-	spriteUnits[name] = unit;
-	spriteFrames[name] = frame;
-	spriteSwizzles[name] = swizzle;
+	sprites[name] = SpriteInfo{sprite, unit, frame, swizzle};
 }
 
 
@@ -59,7 +56,7 @@ const Sprite *Information::GetSprite(const string &name) const
 	static const Sprite empty;
 
 	auto it = sprites.find(name);
-	return (it == sprites.end()) ? &empty : it->second;
+	return (it == sprites.end()) ? &empty : it->second.sprite;
 }
 
 
@@ -68,24 +65,24 @@ const Point &Information::GetSpriteUnit(const string &name) const
 {
 	static const Point up(0., -1.);
 
-	auto it = spriteUnits.find(name);
-	return (it == spriteUnits.end()) ? up : it->second;
+	auto it = sprites.find(name);
+	return (it == sprites.end()) ? up : it->second.unit;
 }
 
 
 
 float Information::GetSpriteFrame(const string &name) const
 {
-	auto it = spriteFrames.find(name);
-	return (it == spriteFrames.end()) ? 0.f : it->second;
+	auto it = sprites.find(name);
+	return (it == sprites.end()) ? 0.f : it->second.frame;
 }
 
 
 
 const Swizzle *Information::GetSwizzle(const string &name) const
 {
-	auto it = spriteSwizzles.find(name);
-	return it == spriteSwizzles.end() ? 0 : it->second;
+	auto it = sprites.find(name);
+	return it == sprites.end() ? 0 : it->second.swizzle;
 }
 
 
@@ -109,8 +106,7 @@ const string &Information::GetString(const string &name) const
 
 void Information::SetBar(const string &name, double value, double segments)
 {
-	bars[name] = value;
-	barSegments[name] = segments;
+	bars[name] = Bar{value, segments};
 }
 
 
@@ -119,16 +115,16 @@ double Information::BarValue(const string &name) const
 {
 	auto it = bars.find(name);
 
-	return (it == bars.end()) ? 0. : it->second;
+	return (it == bars.end()) ? 0. : it->second.value;
 }
 
 
 
 double Information::BarSegments(const string &name) const
 {
-	auto it = barSegments.find(name);
+	auto it = bars.find(name);
 
-	return (it == barSegments.end()) ? 1. : it->second;
+	return (it == bars.end()) ? 1. : it->second.segments;
 }
 
 
@@ -140,7 +136,7 @@ void Information::SetCondition(const string &condition)
 
 
 
-bool Information::HasCondition(const string &condition) const
+bool Information::HasCondition(string_view condition) const
 {
 	if(condition.empty())
 		return true;
@@ -148,7 +144,7 @@ bool Information::HasCondition(const string &condition) const
 	if(condition.front() == '!')
 		return !HasCondition(condition.substr(1));
 
-	return conditions.contains(condition);
+	return conditions.find(condition) != conditions.end();
 }
 
 
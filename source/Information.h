@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <map>
 #include <set>
 #include <string>
+#include <string_view>
 
 class Sprite;
 
@@ -51,25 +52,40 @@ public:
 	double BarSegments(const std::string &name) const;
 
 	void SetCondition(const std::string &condition);
-	bool HasCondition(const std::string &condition) const;
+	bool HasCondition(std::string_view condition) const;
 
 	void SetOutlineColor(const Color &color);
 	const Color &GetOutlineColor() const;
 
 
+private:
+	// Everything about a sprite is stored together, so that setting it only
+	// takes one lookup.
+	class SpriteInfo {
+	public:
+		const Sprite *sprite = nullptr;
+		Point unit;
+		float frame = 0.f;
+		const Swizzle *swizzle = nullptr;
+	};
+
+	class Bar {
+	public:
+		double value = 0.;
+		double segments = 0.;
+	};
+
+
 private:
 	Rectangle region;
 	bool hasCustomRegion = false;
 
-	std::map<std::string, const Sprite *> sprites;
-	std::map<std::string, Point> spriteUnits;
-	std::map<std::string, float> spriteFrames;
-	std::map<std::string, const Swizzle *> spriteSwizzles;
+	std::map<std::string, SpriteInfo> sprites;
 	std::map<std::string, std::string> strings;
-	std::map<std::string, double> bars;
-	std::map<std::string, double> barSegments;
+	std::map<std::string, Bar> bars;
 
-	std::set<std::string> conditions;
+	// Conditions can be looked up without making a string out of them.
+	std::set<std::string, std::less<>> conditions;
 
 	Color outlineColor;
 };
@@ -35,6 +35,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "image/Sprite.h"
 #include "image/SpriteSet.h"
 #include "shader/SpriteShader.h"
+#include "text/TextBatch.h"
 #include "UI.h"
 
 #include <algorithm>
@@ -150,6 +151,8 @@ void Interface::Load(const DataNode &node)
 // Draw this interface.
 void Interface::Draw(const Information &info, Panel *panel) const
 {
+	// Interfaces draw many labels, and never draw anything over their own text.
+	TextBatch batch;
 	for(const unique_ptr<Element> &element : elements)
 		element->Draw(info, panel);
 }
@@ -0,0 +1,108 @@
+/* JumpTable.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "JumpTable.h"
+
+#include "DistanceMap.h"
+#include "System.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// The number of jumps to a system is stored in a byte. Anything this far
+	// away or further is looked up with a new search instead.
+	constexpr uint8_t FAR = 254;
+	constexpr uint8_t UNREACHABLE = 255;
+
+	// There is a table for each wormhole strategy, with and without a jump drive.
+	constexpr size_t TABLE_COUNT = 6;
+
+	// Invalidate() may be called from any thread, so it only marks the tables
+	// as out of date. They are thrown out on the next lookup.
+	atomic<unsigned> generation = 0;
+
+	size_t TableIndex(const DistanceCalculationSettings &settings)
+	{
+		return 2 * static_cast<size_t>(settings.WormholeStrat()) + settings.AssumesJumpDrive();
+	}
+}
+
+
+
+// Get the number of jumps it takes to get from one system to the other, or
+// -1 if there is no route between them.
+int JumpTable::Jumps(const System &from, const System &to, const DistanceCalculationSettings &settings)
+{
+	// Systems that have not been indexed cannot be reached.
+	const int fromIndex = from.Index();
+	const int toIndex = to.Index();
+	if(fromIndex < 0 || toIndex < 0)
+		return -1;
+
+	static mutex tablesMutex;
+	// Each table has a row of jumps for every system that has been asked about,
+	// by the index of the system. A row is empty until it is needed.
+	static vector<vector<uint8_t>> tables[TABLE_COUNT];
+	static unsigned tablesGeneration = 0;
+
+	unique_lock<mutex> lock(tablesMutex);
+	if(tablesGeneration != generation)
+	{
+		for(auto &table : tables)
+			table.clear();
+		tablesGeneration = generation;
+	}
+
+	vector<vector<uint8_t>> &table = tables[TableIndex(settings)];
+	if(static_cast<size_t>(fromIndex) >= table.size())
+		table.resize(fromIndex + 1);
+	vector<uint8_t> &row = table[fromIndex];
+	if(row.empty())
+	{
+		DistanceMap distance(&from, settings.WormholeStrat(), settings.AssumesJumpDrive());
+		set<const System *> systems = distance.Systems();
+		int size = 0;
+		for(const System *system : systems)
+			size = max(size, system->Index() + 1);
+		row.assign(size, UNREACHABLE);
+		for(const System *system : systems)
+			row[system->Index()] = min(distance.Days(*system), static_cast<int>(FAR));
+	}
+
+	const uint8_t jumps = (static_cast<size_t>(toIndex) < row.size() ? row[toIndex] : UNREACHABLE);
+	if(jumps == UNREACHABLE)
+		return -1;
+	if(jumps < FAR)
+		return jumps;
+
+	lock.unlock();
+	return DistanceMap(&from, settings.WormholeStrat(), settings.AssumesJumpDrive()).Days(to);
+}
+
+
+
+// Forget every stored distance. This must be done whenever the links between
+// systems or the wormholes may have changed.
+void JumpTable::Invalidate()
+{
+	++generation;
+}
@@ -0,0 +1,41 @@
+/* JumpTable.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "DistanceCalculationSettings.h"
+
+class System;
+
+
+
+// The number of jumps between any two systems, for the features that only need
+// to know how far apart systems are rather than the route between them, such as
+// location filters, mission deadlines, and the "hyperjumps to" conditions. The
+// jumps from a system to every other system are found by a single search the
+// first time that system is asked about, and are stored one byte per system, so
+// every later question about that system is a lookup.
+class JumpTable {
+public:
+	// Get the number of jumps it takes to get from one system to the other, or
+	// -1 if there is no route between them. This is the same as the days that a
+	// DistanceMap from the first system with the given settings would give.
+	static int Jumps(const System &from, const System &to,
+		const DistanceCalculationSettings &settings = DistanceCalculationSettings());
+
+	// Forget every stored distance. This must be done whenever the links between
+	// systems or the wormholes may have changed.
+	static void Invalidate();
+};
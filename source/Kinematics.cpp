@@ -0,0 +1,123 @@
+/* Kinematics.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Kinematics.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+
+
+// Remove all objects.
+void Kinematics::Clear()
+{
+	positionX.clear();
+	positionY.clear();
+	velocityX.clear();
+	velocityY.clear();
+	accelerationX.clear();
+	accelerationY.clear();
+	retained.clear();
+}
+
+
+
+// Add an object. When it moves, its velocity is first multiplied by
+// (1 - drag), and then the acceleration is added to it.
+void Kinematics::Add(const Point &position, const Point &velocity, const Point &acceleration, double drag)
+{
+	positionX.push_back(position.X());
+	positionY.push_back(position.Y());
+	velocityX.push_back(velocity.X());
+	velocityY.push_back(velocity.Y());
+	accelerationX.push_back(acceleration.X());
+	accelerationY.push_back(acceleration.Y());
+	retained.push_back(1. - drag);
+}
+
+
+
+// Move every object forward one step.
+void Kinematics::Integrate()
+{
+	const size_t count = Size();
+	double *px = positionX.data();
+	double *py = positionY.data();
+	double *vx = velocityX.data();
+	double *vy = velocityY.data();
+	const double *ax = accelerationX.data();
+	const double *ay = accelerationY.data();
+	const double *r = retained.data();
+
+	// Handle as many objects as possible with vector instructions, and then any
+	// that are left over one at a time.
+	size_t i = 0;
+#ifdef __AVX2__
+	for( ; i + 4 <= count; i += 4)
+	{
+		const __m256d retain = _mm256_loadu_pd(r + i);
+		const __m256d newVX = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(vx + i), retain), _mm256_loadu_pd(ax + i));
+		const __m256d newVY = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(vy + i), retain), _mm256_loadu_pd(ay + i));
+		_mm256_storeu_pd(vx + i, newVX);
+		_mm256_storeu_pd(vy + i, newVY);
+		_mm256_storeu_pd(px + i, _mm256_add_pd(_mm256_loadu_pd(px + i), newVX));
+		_mm256_storeu_pd(py + i, _mm256_add_pd(_mm256_loadu_pd(py + i), newVY));
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	for( ; i + 2 <= count; i += 2)
+	{
+		const float64x2_t retain = vld1q_f64(r + i);
+		const float64x2_t newVX = vaddq_f64(vmulq_f64(vld1q_f64(vx + i), retain), vld1q_f64(ax + i));
+		const float64x2_t newVY = vaddq_f64(vmulq_f64(vld1q_f64(vy + i), retain), vld1q_f64(ay + i));
+		vst1q_f64(vx + i, newVX);
+		vst1q_f64(vy + i, newVY);
+		vst1q_f64(px + i, vaddq_f64(vld1q_f64(px + i), newVX));
+		vst1q_f64(py + i, vaddq_f64(vld1q_f64(py + i), newVY));
+	}
+#endif
+	for( ; i < count; ++i)
+	{
+		vx[i] = vx[i] * r[i] + ax[i];
+		vy[i] = vy[i] * r[i] + ay[i];
+		px[i] += vx[i];
+		py[i] += vy[i];
+	}
+}
+
+
+
+size_t Kinematics::Size() const
+{
+	return positionX.size();
+}
+
+
+
+Point Kinematics::Position(size_t index) const
+{
+	return Point(positionX[index], positionY[index]);
+}
+
+
+
+Point Kinematics::Velocity(size_t index) const
+{
+	return Point(velocityX[index], velocityY[index]);
+}
@@ -0,0 +1,54 @@
+/* Kinematics.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Point.h"
+
+#include <cstddef>
+#include <vector>
+
+
+
+// The positions and velocities of many objects, which can all be moved forward
+// one step at once. Each coordinate is stored in an array of its own so that
+// the integration can use the widest vector instructions the processor has
+// (AVX2 or NEON, if the game was compiled for them).
+class Kinematics {
+public:
+	// Remove all objects.
+	void Clear();
+	// Add an object. When it moves, its velocity is first multiplied by
+	// (1 - drag), and then the acceleration is added to it.
+	void Add(const Point &position, const Point &velocity, const Point &acceleration, double drag);
+
+	// Move every object forward one step.
+	void Integrate();
+
+	size_t Size() const;
+	Point Position(size_t index) const;
+	Point Velocity(size_t index) const;
+
+
+private:
+	std::vector<double> positionX;
+	std::vector<double> positionY;
+	std::vector<double> velocityX;
+	std::vector<double> velocityY;
+	std::vector<double> accelerationX;
+	std::vector<double> accelerationY;
+	// The fraction of each object's velocity that remains after drag.
+	std::vector<double> retained;
+};
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "LoadPanel.h"
 
 #include "text/Alignment.h"
+#include "audio/Audio.h"
 #include "Color.h"
 #include "Command.h"
 #include "ConversationPanel.h"
@@ -33,11 +34,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Interface.h"
 #include "MainPanel.h"
 #include "image/MaskManager.h"
+#include "Planet.h"
 #include "PlayerInfo.h"
 #include "Preferences.h"
 #include "Rectangle.h"
+#include "image/SpriteLoadManager.h"
 #include "shader/StarField.h"
 #include "StartConditionsPanel.h"
+#include "StellarObject.h"
+#include "System.h"
 #include "text/Truncate.h"
 #include "UI.h"
 
@@ -94,11 +99,29 @@ LoadPanel::LoadPanel(PlayerInfo &player, UI &gamePanels)
 	if(player.GetPlanet() && !player.IsDead() && !gamePanels.IsTop(&*gamePanels.Root())
 			&& gamePanels.CanSave())
 		player.Save();
+	// The list of saves must include the one that was just made.
+	PlayerInfo::FinishSaving();
 	UpdateLists();
 }
 
 
 
+LoadPanel::~LoadPanel()
+{
+	// Finish uploading any sprites that were loaded for the selected save.
+	queue.Wait();
+	queue.ProcessSyncTasks();
+}
+
+
+
+void LoadPanel::Step()
+{
+	queue.ProcessSyncTasks(TaskQueue::BACKGROUND_SYNC_TIME);
+}
+
+
+
 void LoadPanel::Draw()
 {
 	glClear(GL_COLOR_BUFFER_BIT);
@@ -377,7 +400,7 @@ bool LoadPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 			}
 			selectedFile = it->first;
 		}
-		loadedInfo.Load(Files::Saves() / selectedFile);
+		LoadSelectedInfo();
 	}
 	else if(key == SDLK_LEFT)
 		sideHasFocus = true;
@@ -435,7 +458,7 @@ bool LoadPanel::Click(int x, int y, MouseButton button, int clicks)
 		return false;
 
 	if(!selectedFile.empty())
-		loadedInfo.Load(Files::Saves() / selectedFile);
+		LoadSelectedInfo();
 
 	return true;
 }
@@ -531,7 +554,7 @@ void LoadPanel::UpdateLists()
 			if(it != files.end())
 			{
 				selectedFile = it->second.front().first;
-				loadedInfo.Load(Files::Saves() / selectedFile);
+				LoadSelectedInfo();
 			}
 		}
 	}
@@ -540,6 +563,38 @@ void LoadPanel::UpdateLists()
 
 
 // Snapshot name callback.
+void LoadPanel::LoadSelectedInfo()
+{
+	loadedInfo.Load(Files::Saves() / selectedFile);
+	PrepareSelected();
+}
+
+
+
+void LoadPanel::PrepareSelected()
+{
+	if(!loadedInfo.IsLoaded() || loadedInfo.Path() == preparedPath)
+		return;
+
+	preparedPath = loadedInfo.Path();
+	preparedSave = make_shared<DataFile>();
+	preparing = queue.Run([save = preparedSave, path = preparedPath]() -> void { save->Load(path); });
+
+	// The player will see their system, and the landscape of the planet they
+	// are on, as soon as the save is loaded.
+	if(const System *system = loadedInfo.StartingSystem())
+	{
+		for(const StellarObject &object : system->Objects())
+			if(object.HasSprite())
+				SpriteLoadManager::LoadDeferred(queue, object.GetSprite());
+		Audio::PrefetchMusic(system->MusicName());
+	}
+	if(const Planet *planet = loadedInfo.StartingPlanet())
+		SpriteLoadManager::LoadDeferred(queue, planet->Landscape());
+}
+
+
+
 void LoadPanel::SnapshotCallback(const string &name)
 {
 	auto it = files.find(selectedPilot);
@@ -571,12 +626,13 @@ void LoadPanel::SnapshotCallback(const string &name)
 // This name is the one to be used, even if it already exists.
 void LoadPanel::WriteSnapshot(const filesystem::path &sourceFile, const filesystem::path &snapshotName)
 {
-	// Copy the autosave to a new, named file.
-	if(Files::Copy(sourceFile, snapshotName))
+	// Link the autosave to a new, named file. Saved games are only ever replaced,
+	// not written in place, so the snapshot keeps its contents without a copy.
+	if(Files::Link(sourceFile, snapshotName))
 	{
 		UpdateLists();
 		selectedFile = Files::Name(snapshotName);
-		loadedInfo.Load(Files::Saves() / selectedFile);
+		LoadSelectedInfo();
 	}
 	else
 		{
@@ -595,7 +651,14 @@ void LoadPanel::LoadCallback()
 	gamePanels.Reset();
 	gamePanels.CanSave(true);
 
-	player.Load(loadedInfo.Path());
+	// Use the copy of the save that was read in the background, if there is one.
+	if(preparedSave && preparedPath == loadedInfo.Path())
+	{
+		preparing.wait();
+		player.Load(loadedInfo.Path(), *preparedSave);
+	}
+	else
+		player.Load(loadedInfo.Path());
 
 	// Scale any new masks that might have been added by the newly loaded save file.
 	GameData::GetMaskManager().ScaleMasks();
@@ -655,7 +718,7 @@ void LoadPanel::DeleteSave()
 	{
 		selectedFile = it->second.front().first;
 		selectedPilot = pilot;
-		loadedInfo.Load(Files::Saves() / selectedFile);
+		LoadSelectedInfo();
 		sideHasFocus = false;
 	}
 }
@@ -20,15 +20,19 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Point.h"
 #include "Rectangle.h"
 #include "SavedGame.h"
+#include "TaskQueue.h"
 #include "Tooltip.h"
 
 #include <ctime>
 #include <filesystem>
+#include <future>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+class DataFile;
 class PlayerInfo;
 class UI;
 
@@ -40,7 +44,9 @@ class UI;
 class LoadPanel : public Panel {
 public:
 	LoadPanel(PlayerInfo &player, UI &gamePanels);
+	virtual ~LoadPanel() override;
 
+	virtual void Step() override;
 	virtual void Draw() override;
 
 	virtual void UpdateTooltipActivation() override;
@@ -57,6 +63,12 @@ protected:
 
 private:
 	void UpdateLists();
+	// Show the summary of the selected save, and start preparing to load it.
+	void LoadSelectedInfo();
+	// Read the selected save in the background, and begin loading the sprites
+	// and music that the player will need first if it is loaded, so that
+	// loading it takes as little time as possible.
+	void PrepareSelected();
 
 	// Snapshot name callback.
 	void SnapshotCallback(const std::string &name);
@@ -88,4 +100,10 @@ private:
 	bool sideHasFocus = false;
 	double sideScroll = 0;
 	double centerScroll = 0;
+
+	// The tasks that prepare the selected save to be loaded.
+	TaskQueue queue;
+	std::filesystem::path preparedPath;
+	std::shared_ptr<DataFile> preparedSave;
+	std::shared_future<void> preparing;
 };
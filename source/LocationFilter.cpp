@@ -19,9 +19,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "CategoryType.h"
 #include "DataNode.h"
 #include "DataWriter.h"
-#include "DistanceMap.h"
 #include "GameData.h"
 #include "Government.h"
+#include "JumpTable.h"
 #include "Planet.h"
 #include "Port.h"
 #include "Random.h"
@@ -30,11 +30,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 
 #include <algorithm>
-#include <mutex>
+#include <atomic>
 
 using namespace std;
 
 namespace {
+	// This changes whenever the galaxy does, so that anything that was worked
+	// out from the old galaxy is known to be out of date.
+	atomic<uint64_t> generation = 1;
+
 	bool SetsIntersect(const set<string> &a, const set<string> &b)
 	{
 		// Quickest way to find out if two sets contain common elements: iterate
@@ -74,37 +78,8 @@ namespace {
 	// Check if the given system is within the given distance of the center.
 	int Distance(const System *center, const System *system, int maximum, DistanceCalculationSettings distanceSettings)
 	{
-		// This function should only ever be called from the main thread, but
-		// just to be sure, use mutex protection on the static locals.
-		static mutex distanceMutex;
-		lock_guard<mutex> lock(distanceMutex);
-
-		static const System *previousCenter = center;
-		static DistanceMap distance(
-			center,
-			distanceSettings.WormholeStrat(),
-			distanceSettings.AssumesJumpDrive(),
-			-1,
-			maximum
-		);
-		static int previousMaximum = maximum;
-		static DistanceCalculationSettings previousDistanceSettings = distanceSettings;
-
-		if(center != previousCenter || maximum > previousMaximum || distanceSettings != previousDistanceSettings)
-		{
-			previousCenter = center;
-			previousMaximum = maximum;
-			previousDistanceSettings = distanceSettings;
-			distance = DistanceMap(
-				center,
-				distanceSettings.WormholeStrat(),
-				distanceSettings.AssumesJumpDrive(),
-				-1,
-				maximum
-			);
-		}
 		// If the distance is greater than the maximum, this is not a match.
-		int d = distance.Days(*system);
+		int d = JumpTable::Jumps(*center, *system, distanceSettings);
 		return (d > maximum) ? -1 : d;
 	}
 
@@ -162,17 +137,18 @@ namespace {
 
 
 // Construct and Load() at the same time.
-LocationFilter::LocationFilter(const DataNode &node, const set<const System *> *visitedSystems,
-	const set<const Planet *> *visitedPlanets)
+LocationFilter::LocationFilter(const DataNode &node, const IndexedSet<System> *visitedSystems,
+	const IndexedSet<Planet> *visitedPlanets)
 {
 	Load(node, visitedSystems, visitedPlanets);
 }
 
 
 
-void LocationFilter::Load(const DataNode &node, const set<const System *> *visitedSystems,
-	const set<const Planet *> *visitedPlanets)
+void LocationFilter::Load(const DataNode &node, const IndexedSet<System> *visitedSystems,
+	const IndexedSet<Planet> *visitedPlanets)
 {
+	matching = make_shared<Matching>();
 	for(const DataNode &child : node)
 	{
 		// Handle filters that must not match, or must apply to a
@@ -448,6 +424,39 @@ bool LocationFilter::Matches(const Ship &ship) const
 
 
 
+const set<const Planet *> &LocationFilter::Planets() const
+{
+	return planets;
+}
+
+
+
+const set<const System *> &LocationFilter::Systems() const
+{
+	return systems;
+}
+
+
+
+const set<const Government *> &LocationFilter::Governments() const
+{
+	return governments;
+}
+
+
+
+const set<string> &LocationFilter::RequiredAttributes() const
+{
+	static const set<string> EMPTY;
+	const set<string> *smallest = &EMPTY;
+	for(const set<string> &attr : attributes)
+		if(smallest->empty() || attr.size() < smallest->size())
+			smallest = &attr;
+	return *smallest;
+}
+
+
+
 // Convert a "distance" filter into a "near" filter.
 LocationFilter LocationFilter::SetOrigin(const System *origin) const
 {
@@ -471,6 +480,7 @@ LocationFilter LocationFilter::SetOrigin(const System *origin) const
 	result.originMinDistance = 0;
 	result.originMaxDistance = -1;
 	result.originDistanceOptions = DistanceCalculationSettings{};
+	result.matching = make_shared<Matching>();
 
 	return result;
 }
@@ -480,6 +490,20 @@ LocationFilter LocationFilter::SetOrigin(const System *origin) const
 // Pick a random system that matches this filter, based on the given origin.
 const System *LocationFilter::PickSystem(const System *origin) const
 {
+	// If this filter always matches the same systems, they only have to be
+	// found again after the galaxy changes.
+	const bool isStatic = matching && IsStatic();
+	unique_lock<mutex> lock;
+	if(isStatic)
+	{
+		lock = unique_lock<mutex>(matching->mutex);
+		if(matching->systemsGeneration == generation)
+		{
+			const vector<const System *> &options = matching->systems;
+			return options.empty() ? nullptr : options[Random::Int(options.size())];
+		}
+	}
+
 	// Find a planet that satisfies the filter.
 	vector<const System *> options;
 	for(const auto &it : GameData::Systems())
@@ -491,7 +515,13 @@ const System *LocationFilter::PickSystem(const System *origin) const
 		if(Matches(&system, origin))
 			options.push_back(&system);
 	}
-	return options.empty() ? nullptr : options[Random::Int(options.size())];
+	const System *result = options.empty() ? nullptr : options[Random::Int(options.size())];
+	if(isStatic)
+	{
+		matching->systems = std::move(options);
+		matching->systemsGeneration = generation;
+	}
+	return result;
 }
 
 
@@ -499,31 +529,64 @@ const System *LocationFilter::PickSystem(const System *origin) const
 // Pick a random planet that matches this filter, based on the given origin.
 const Planet *LocationFilter::PickPlanet(const System *origin, bool hasClearance, bool requireSpaceport) const
 {
+	// Whether the player can land on a planet can change at any time, so a
+	// static filter remembers every planet that it matches, and those are
+	// checked for everything else each time.
+	const bool isStatic = matching && IsStatic();
+	unique_lock<mutex> lock;
+	vector<const Planet *> candidates;
+	const vector<const Planet *> *matches = &candidates;
+	if(isStatic)
+	{
+		lock = unique_lock<mutex>(matching->mutex);
+		matches = &matching->planets;
+	}
+	if(!isStatic || matching->planetsGeneration != generation)
+	{
+		candidates.clear();
+		for(const auto &it : GameData::Planets())
+		{
+			const Planet &planet = it.second;
+			// Skip planets with incomplete data or which are from inaccessible systems.
+			if(!planet.IsValid() || (planet.GetSystem() && planet.GetSystem()->Inaccessible()))
+				continue;
+			if(Matches(&planet, origin))
+				candidates.push_back(&planet);
+		}
+		if(isStatic)
+		{
+			matching->planets = std::move(candidates);
+			matching->planetsGeneration = generation;
+		}
+	}
+
 	// Find a planet that satisfies the filter.
 	vector<const Planet *> options;
-	for(const auto &it : GameData::Planets())
+	for(const Planet *planet : *matches)
 	{
-		const Planet &planet = it.second;
-		// Skip planets with incomplete data or which are from inaccessible systems.
-		if(!planet.IsValid() || (planet.GetSystem() && planet.GetSystem()->Inaccessible()))
-			continue;
 		// Skip planets that do not offer special jobs or missions, unless they were explicitly listed as options.
-		if(planet.IsWormhole()
-				|| (requireSpaceport && !planet.GetPort().HasService(Port::ServicesType::OffersMissions))
-				|| (!hasClearance && !planet.CanLand()))
-			if(planets.empty() || !planets.contains(&planet))
+		if(planet->IsWormhole()
+				|| (requireSpaceport && !planet->GetPort().HasService(Port::ServicesType::OffersMissions))
+				|| (!hasClearance && !planet->CanLand()))
+			if(planets.empty() || !planets.contains(planet))
 				continue;
-		if(Matches(&planet, origin))
-			options.push_back(&planet);
+		options.push_back(planet);
 	}
 	return options.empty() ? nullptr : options[Random::Int(options.size())];
 }
 
 
 
+void LocationFilter::Invalidate()
+{
+	++generation;
+}
+
+
+
 // Load one particular line of conditions.
-void LocationFilter::LoadChild(const DataNode &child, const set<const System *> *visitedSystems,
-	const set<const Planet *> *visitedPlanets)
+void LocationFilter::LoadChild(const DataNode &child, const IndexedSet<System> *visitedSystems,
+	const IndexedSet<Planet> *visitedPlanets)
 {
 	if(!visitedSystems || !visitedPlanets)
 		throw runtime_error("LocationFilters must be provided pointers to the player's visited systems and planets.");
@@ -686,3 +749,15 @@ bool LocationFilter::Matches(const System *system, const System *origin, bool di
 
 	return true;
 }
+
+
+
+bool LocationFilter::IsStatic() const
+{
+	if(systemIsVisited || planetIsVisited || originMaxDistance >= 0)
+		return false;
+
+	auto isStatic = [](const LocationFilter &filter) noexcept -> bool { return filter.IsStatic(); };
+	return all_of(notFilters.begin(), notFilters.end(), isStatic)
+		&& all_of(neighborFilters.begin(), neighborFilters.end(), isStatic);
+}
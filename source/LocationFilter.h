@@ -16,10 +16,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include "DistanceCalculationSettings.h"
+#include "IndexedSet.h"
 
+#include <cstdint>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -39,12 +44,12 @@ class LocationFilter {
 public:
 	LocationFilter() noexcept = default;
 	// Construct and Load() at the same time.
-	explicit LocationFilter(const DataNode &node, const std::set<const System *> *visitedSystems,
-		const std::set<const Planet *> *visitedPlanets);
+	explicit LocationFilter(const DataNode &node, const IndexedSet<System> *visitedSystems,
+		const IndexedSet<Planet> *visitedPlanets);
 
 	// Examine all the children of the given node and load any that are filters.
-	void Load(const DataNode &node, const std::set<const System *> *visitedSystems,
-		const std::set<const Planet *> *visitedPlanets);
+	void Load(const DataNode &node, const IndexedSet<System> *visitedSystems,
+		const IndexedSet<Planet> *visitedPlanets);
 	// This only saves the children. Save the root node separately. It does
 	// handle indenting, however.
 	void Save(DataWriter &out) const;
@@ -60,6 +65,16 @@ public:
 	// of ship, outfits installed/carried, and their total attributes.
 	bool Matches(const Ship &ship) const;
 
+	// The planets that a planet must be one of to match this filter, the systems
+	// it must be in, and the governments it must belong to. Each is empty if the
+	// filter places no such limit.
+	const std::set<const Planet *> &Planets() const;
+	const std::set<const System *> &Systems() const;
+	const std::set<const Government *> &Governments() const;
+	// The smallest set of attributes that a planet must have at least one of to
+	// match this filter, or an empty set if it needs no particular attribute.
+	const std::set<std::string> &RequiredAttributes() const;
+
 	// Return a new LocationFilter with any "distance" conditions converted
 	// into "near" references, relative to the given system.
 	LocationFilter SetOrigin(const System *origin) const;
@@ -68,23 +83,43 @@ public:
 	const System *PickSystem(const System *origin) const;
 	const Planet *PickPlanet(const System *origin, bool hasClearance = false, bool requireSpaceport = true) const;
 
+	// Forget which systems and planets each filter matches, because the galaxy
+	// has been changed by an event, or by loading or reverting game data.
+	static void Invalidate();
+
 
 private:
 	// Load one particular line of conditions.
-	void LoadChild(const DataNode &child, const std::set<const System *> *visitedSystems,
-		const std::set<const Planet *> *visitedPlanets);
+	void LoadChild(const DataNode &child, const IndexedSet<System> *visitedSystems,
+		const IndexedSet<Planet> *visitedPlanets);
 	// Check if the filter matches the given system. If it did not, return true
 	// only if the filter wasn't looking for planet characteristics or if the
 	// didPlanet argument is set (meaning we already checked those).
 	bool Matches(const System *system, const System *origin, bool didPlanet) const;
+	// Check whether this filter matches the same systems and planets no matter
+	// what the origin is or where the player has been.
+	bool IsStatic() const;
+
+
+private:
+	// The systems and planets that a static filter matches, which are shared by
+	// the copies of the filter and remembered until the galaxy changes.
+	class Matching {
+	public:
+		std::mutex mutex;
+		uint64_t systemsGeneration = 0;
+		std::vector<const System *> systems;
+		uint64_t planetsGeneration = 0;
+		std::vector<const Planet *> planets;
+	};
 
 
 private:
 	bool isEmpty = true;
 
 	// Pointers to the PlayerInfo's visited systems and planets.
-	const std::set<const System *> *visitedSystems = nullptr;
-	const std::set<const Planet *> *visitedPlanets = nullptr;
+	const IndexedSet<System> *visitedSystems = nullptr;
+	const IndexedSet<Planet> *visitedPlanets = nullptr;
 
 	// The player must have visited the system or planet.
 	bool systemIsVisited = false;
@@ -118,4 +153,6 @@ private:
 	std::list<LocationFilter> notFilters;
 	// These filters store all the things the planet or system must border.
 	std::list<LocationFilter> neighborFilters;
+
+	std::shared_ptr<Matching> matching;
 };
@@ -26,6 +26,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PlayerInfo.h"
 #include "Preferences.h"
 #include "Screen.h"
+#include "image/Sprite.h"
 #include "image/SpriteLoadManager.h"
 #include "image/SpriteSet.h"
 #include "UI.h"
@@ -144,6 +145,30 @@ void LogbookPanel::Draw()
 	// Draw the main text.
 	pos = Screen::TopLeft() + Point(SIDEBAR_WIDTH + PAD, PAD + .5 * (LINE_HEIGHT - font.Height()) - scroll);
 
+	// Only draw the entries that are at least partly on screen. The rest are
+	// skipped over using their remembered heights.
+	size_t index = 0;
+	bool canRemember = true;
+	auto drawEntry = [&](const BookEntry &entry) -> void
+	{
+		int entryHeight;
+		if(index < heights.size())
+			entryHeight = heights[index];
+		else
+		{
+			entryHeight = entry.Height(wrap);
+			// A scene that has not finished loading does not know its size yet.
+			canRemember &= all_of(entry.GetScenes().begin(), entry.GetScenes().end(),
+				[](const Sprite *scene) { return scene->IsLoaded(); });
+			if(canRemember)
+				heights.push_back(entryHeight);
+		}
+		++index;
+		if(pos.Y() < Screen::Bottom() && pos.Y() + entryHeight > Screen::Top())
+			entry.Draw(pos, wrap, medium);
+		pos.Y() += entryHeight + GAP;
+	};
+
 	// Branch based on whether this is an ordinary log month or a special page.
 	auto pit = player.SpecialLogs().find(selectedName);
 	if(selectedDate && begin != end)
@@ -155,8 +180,7 @@ void LogbookPanel::Draw()
 			font.Draw({date, layout}, pos + Point(0., textOffset.Y()), dim);
 			pos.Y() += LINE_HEIGHT;
 
-			pos.Y() += datedEntry->second.Draw(pos, wrap, medium);
-			pos.Y() += GAP;
+			drawEntry(datedEntry->second);
 		}
 	}
 	else if(!selectedDate && pit != player.SpecialLogs().end())
@@ -166,8 +190,7 @@ void LogbookPanel::Draw()
 			font.Draw(heading, pos + textOffset, bright);
 			pos.Y() += LINE_HEIGHT;
 
-			pos.Y() += entry.Draw(pos, wrap, medium);
-			pos.Y() += GAP;
+			drawEntry(entry);
 		}
 	}
 
@@ -318,6 +341,7 @@ bool LogbookPanel::Hover(int x, int y)
 
 void LogbookPanel::Update(bool selectLast)
 {
+	heights.clear();
 	contents.clear();
 	dates.clear();
 	for(const auto &it : player.SpecialLogs())
@@ -65,6 +65,9 @@ private:
 	std::string selectedName;
 	std::map<Date, BookEntry>::const_iterator begin;
 	std::map<Date, BookEntry>::const_iterator end;
+	// The height of each entry on the current page, so that entries which are
+	// scrolled out of view do not need to be wrapped again every frame.
+	std::vector<int> heights;
 	// Other months available for display:
 	std::vector<std::string> contents;
 	std::vector<Date> dates;
@@ -24,14 +24,109 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <sys/utsname.h>
 #endif
 
+#include <condition_variable>
+#include <cstdint>
 #include <iostream>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
 namespace {
 	function<void(const string &message, Logger::Level)> logCallback = nullptr;
+	// This is held while a message is written out.
 	mutex logMutex;
+
+	// Messages that are waiting for the background thread to write them. This
+	// lock is only held long enough to add a message to the list, or to take
+	// the whole list.
+	vector<pair<string, Logger::Level>> pending;
+	mutex pendingMutex;
+	condition_variable pendingCondition;
+	// The number of messages that have been queued and written so far.
+	uint64_t queuedCount = 0;
+	uint64_t writtenCount = 0;
+	bool isAsync = false;
+	bool shouldQuit = false;
+	thread writer;
+
+	// Where this thread's messages go instead, while it is capturing them.
+	thread_local Logger::Messages *captured = nullptr;
+
+	// The last message that was written, and how many times in a row it has
+	// been logged again since then, so that a burst of identical messages
+	// only takes up two lines.
+	string lastMessage;
+	Logger::Level lastLevel = Logger::Level::INFO;
+	int repeats = 0;
+
+
+	void Write(const string &message, Logger::Level level)
+	{
+		string formatted = Format::TimestampString(chrono::system_clock::now(), true)
+			+ " | " + static_cast<char>(level) + " | " + message;
+		(level == Logger::Level::INFO ? cout : cerr) << formatted << endl;
+		// Perform additional logging through callback if any is registered.
+		if(logCallback)
+			logCallback(formatted, level);
+	}
+
+
+	void WriteRepeats()
+	{
+		if(repeats > 1)
+			Write("(The previous message was repeated " + to_string(repeats) + " more times.)", lastLevel);
+		else if(repeats == 1)
+			Write(lastMessage, lastLevel);
+		repeats = 0;
+	}
+
+
+	void WriteBatch(const vector<pair<string, Logger::Level>> &batch)
+	{
+		lock_guard<mutex> lock(logMutex);
+		for(const auto &[message, level] : batch)
+		{
+			if(message == lastMessage && level == lastLevel)
+			{
+				++repeats;
+				continue;
+			}
+			WriteRepeats();
+			Write(message, level);
+			lastMessage = message;
+			lastLevel = level;
+		}
+	}
+
+
+	void WriterThread()
+	{
+		vector<pair<string, Logger::Level>> batch;
+		unique_lock<mutex> lock(pendingMutex);
+		while(true)
+		{
+			pendingCondition.wait(lock, [] { return shouldQuit || !pending.empty(); });
+			if(pending.empty())
+				break;
+
+			batch.swap(pending);
+			lock.unlock();
+			WriteBatch(batch);
+			// Make sure that the repeats of a message are written once a burst of
+			// messages has been handled, rather than waiting for the next one.
+			{
+				lock_guard<mutex> writeLock(logMutex);
+				WriteRepeats();
+			}
+			lock.lock();
+			writtenCount += batch.size();
+			batch.clear();
+			pendingCondition.notify_all();
+		}
+	}
 }
 
 
@@ -52,6 +147,11 @@ Logger::Session::Session(bool quiet)
 	message += string(uName.sysname) + ' ' + uName.release + ' ' + uName.version + '.';
 #endif
 	Log(message, Level::INFO);
+
+	lock_guard<mutex> lock(pendingMutex);
+	shouldQuit = false;
+	isAsync = true;
+	writer = thread(&WriterThread);
 }
 
 
@@ -62,6 +162,29 @@ Logger::Session::~Session()
 		return;
 
 	Log("Logger session end.", Level::INFO);
+
+	{
+		lock_guard<mutex> lock(pendingMutex);
+		shouldQuit = true;
+	}
+	pendingCondition.notify_all();
+	writer.join();
+	isAsync = false;
+}
+
+
+
+Logger::Capture::Capture(Messages &messages)
+	: previous(captured)
+{
+	captured = &messages;
+}
+
+
+
+Logger::Capture::~Capture()
+{
+	captured = previous;
 }
 
 
@@ -75,11 +198,49 @@ void Logger::SetLogCallback(function<void(const string &message, Level)> callbac
 
 void Logger::Log(const string &message, Level level)
 {
+	if(captured)
+	{
+		captured->emplace_back(message, level);
+		return;
+	}
+
+	bool queued = false;
+	{
+		lock_guard<mutex> lock(pendingMutex);
+		if(isAsync)
+		{
+			pending.emplace_back(message, level);
+			++queuedCount;
+			queued = true;
+		}
+	}
+	if(queued)
+	{
+		pendingCondition.notify_all();
+		// Errors may be followed by the game exiting, so make sure that they
+		// have been written before going on.
+		if(level == Level::ERROR)
+			Flush();
+		return;
+	}
+
 	lock_guard<mutex> lock(logMutex);
-	string formatted = Format::TimestampString(chrono::system_clock::now(), true)
-		+ " | " + static_cast<char>(level) + " | " + message;
-	(level == Level::INFO ? cout : cerr) << formatted << endl;
-	// Perform additional logging through callback if any is registered.
-	if(logCallback)
-		logCallback(formatted, level);
+	Write(message, level);
+}
+
+
+
+void Logger::Log(const Messages &messages)
+{
+	for(const auto &[message, level] : messages)
+		Log(message, level);
+}
+
+
+
+void Logger::Flush()
+{
+	unique_lock<mutex> lock(pendingMutex);
+	uint64_t target = queuedCount;
+	pendingCondition.wait(lock, [target] { return !isAsync || writtenCount >= target; });
 }
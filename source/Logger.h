@@ -17,6 +17,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 
@@ -36,7 +38,13 @@ public:
 		ERROR = 'E'
 	};
 
-	// Print additional control messages when a session begins or ends.
+	using Messages = std::vector<std::pair<std::string, Level>>;
+
+	// Print additional control messages when a session begins or ends. While a
+	// session that is not quiet exists, messages are written out by a
+	// background thread, so that threads that log many messages at once (for
+	// example while loading broken plugin data) do not have to wait on each
+	// other. Otherwise, each message is written before Log() returns.
 	class Session {
 	public:
 		Session(bool quiet);
@@ -47,8 +55,26 @@ public:
 		bool quiet;
 	};
 
+	// While this exists, the messages that this thread logs are added to the
+	// given list instead of being written. Work that is split between threads
+	// can then write its messages in the same order every time.
+	class Capture {
+	public:
+		explicit Capture(Messages &messages);
+		Capture(const Capture &) = delete;
+		Capture &operator=(const Capture &) = delete;
+		~Capture();
+
+
+	private:
+		Messages *previous;
+	};
+
 
 public:
 	static void SetLogCallback(std::function<void(const std::string &message, Level)> callback);
 	static void Log(const std::string &message, Level level);
+	static void Log(const Messages &messages);
+	// Wait until every message that has been logged so far has been written.
+	static void Flush();
 };
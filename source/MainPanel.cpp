@@ -44,6 +44,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "opengl.h"
 
 #include <cmath>
+#include <iterator>
 #include <map>
 #include <sstream>
 #include <string>
@@ -126,9 +127,11 @@ void MainPanel::Step()
 	if(isActive && !engine.IsPaused())
 		player.StepMissionTimers(GetUI());
 
-	// Splice new events onto the eventQueue for (eventual) handling. No
+	// Move new events onto the eventQueue for (eventual) handling. No
 	// other classes use Engine::Events() after Engine::Step() completes.
-	eventQueue.splice(eventQueue.end(), engine.Events());
+	vector<ShipEvent> &newEvents = engine.Events();
+	eventQueue.insert(eventQueue.end(), make_move_iterator(newEvents.begin()), make_move_iterator(newEvents.end()));
+	newEvents.clear();
 	// Handle as many ShipEvents as possible (stopping if no longer active
 	// and updating the isActive flag).
 	StepEvents(isActive);
@@ -608,9 +611,12 @@ bool MainPanel::ShowHelp(bool force)
 // oldest and then process events until any create a new UI element.
 void MainPanel::StepEvents(bool &isActive)
 {
-	while(isActive && !eventQueue.empty())
+	// Nothing else adds to the queue while it is being processed, so the handled
+	// events can all be removed at once afterwards.
+	size_t handled = 0;
+	while(isActive && handled < eventQueue.size())
 	{
-		const ShipEvent &event = eventQueue.front();
+		const ShipEvent &event = eventQueue[handled];
 		const Government *actor = event.ActorGovernment();
 
 		// Pass this event to the player, to update conditions and make
@@ -694,8 +700,9 @@ void MainPanel::StepEvents(bool &isActive)
 		if((event.Type() & ShipEvent::JUMP) && flagship && event.Actor().get() == flagship)
 			player.CreateEnteringMissions();
 
-		// Remove the fully-handled event.
-		eventQueue.pop_front();
+		// Move past the fully-handled event.
+		++handled;
 		handledFront = false;
 	}
+	eventQueue.erase(eventQueue.begin(), eventQueue.begin() + handled);
 }
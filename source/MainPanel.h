@@ -20,7 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Command.h"
 #include "Engine.h"
 
-#include <list>
+#include <vector>
 
 class PlayerInfo;
 class ShipEvent;
@@ -72,7 +72,7 @@ private:
 	Engine engine;
 
 	// These are the pending ShipEvents that have yet to be processed.
-	std::list<ShipEvent> eventQueue;
+	std::vector<ShipEvent> eventQueue;
 	bool handledFront = false;
 
 	Command show;
@@ -653,7 +653,7 @@ void MapDetailPanel::DrawKey()
 		for(const auto &it : distances)
 		{
 			const string &rawName = it.second->DisplayName();
-			const string displayName = Translation::TrGovernment(rawName);
+			const string &displayName = it.second->TranslatedDisplayName();
 			const Color &displayColor = it.second->GetColor();
 			auto foundIt = find(alreadyDisplayed.begin(), alreadyDisplayed.end(),
 					make_pair(rawName, displayColor));
@@ -816,7 +816,7 @@ void MapDetailPanel::DrawInfo()
 	font.Draw({systemName, alignLeft}, uiPoint + Point(0., -7.), medium);
 
 	governmentY = uiPoint.Y() + textMargin;
-	string gov = canView ? Translation::TrGovernment(selectedSystem->GetGovernment()->DisplayName())
+	string gov = canView ? selectedSystem->GetGovernment()->TranslatedDisplayName()
 		: Translation::Tr("ui.unknown_government");
 	font.Draw({gov, alignLeft}, uiPoint + Point(0., 13.), (commodity == SHOW_GOVERNMENT) ? medium : dim);
 	if(commodity == SHOW_GOVERNMENT)
@@ -859,10 +859,10 @@ void MapDetailPanel::DrawInfo()
 	bool otherIsInhabited = selectedSystem->IsInhabited(player.Flagship());
 	if(!noCompare && canView && otherIsInhabited)
 	{
-		for(const Trade::Commodity &commodity : GameData::Commodities())
+		for(size_t c = 0; c < GameData::Commodities().size(); ++c)
 		{
-			value = selectedSystem->Trade(commodity.name);
-			int localValue = player.GetSystem()->Trade(commodity.name);
+			value = selectedSystem->Trade(c);
+			int localValue = player.GetSystem()->Trade(c);
 			if(value && localValue)
 			{
 				value -= localValue;
@@ -894,8 +894,8 @@ void MapDetailPanel::DrawInfo()
 		string price;
 		if(canView && otherIsInhabited)
 		{
-			value = selectedSystem->Trade(commodity.name);
-			int localValue = (player.GetSystem() ? player.GetSystem()->Trade(commodity.name) : 0);
+			value = selectedSystem->Trade(static_cast<size_t>(i));
+			int localValue = (player.GetSystem() ? player.GetSystem()->Trade(static_cast<size_t>(i)) : 0);
 			if(!value)
 				price = "----";
 			else if(noCompare || player.GetSystem() == selectedSystem || !localValue)
@@ -965,7 +965,7 @@ void MapDetailPanel::DrawInfo()
 			descriptionVisible = true;
 		}
 		description->SetFont(FontSet::Get(14));
-		description->SetText(Translation::TrPlanetDescription(selectedPlanet->TrueName(), selectedPlanet->Description().ToString()));
+		description->SetText(selectedPlanet->TranslatedDescription());
 
 		selectedSystemOffset = -150;
 	}
@@ -52,6 +52,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "shader/SpriteShader.h"
 #include "StellarObject.h"
 #include "System.h"
+#include "text/TextBatch.h"
 #include "Trade.h"
 #include "text/Truncate.h"
 #include "UI.h"
@@ -179,12 +180,13 @@ namespace {
 	}
 
 	// Return total value of raid fleet (if any) and 60 frames worth of system danger.
-	double DangerFleetTotal(const PlayerInfo &player, const System &system, const bool withRaids)
+	// Raid fleets are only counted if the player's raid fleet factors are given.
+	double DangerFleetTotal(const System &system, const pair<double, double> *raidFactors)
 	{
 		double danger = system.Danger() * 60.;
-		if(withRaids)
+		if(raidFactors)
 			for(const auto &raidFleet : system.GetGovernment()->RaidFleets())
-				danger += 10. * player.RaidFleetAttraction(raidFleet, &system) *
+				danger += 10. * PlayerInfo::RaidFleetAttraction(raidFleet, &system, *raidFactors) *
 					raidFleet.GetFleet()->Strength();
 		return danger;
 	}
@@ -530,18 +532,25 @@ bool MapPanel::Click(int x, int y, MouseButton button, int clicks)
 	if(button != MouseButton::LEFT)
 		return false;
 
-	// Figure out if a system was clicked on.
+	// Figure out if a system was clicked on. The systems that are drawn on the
+	// map are the ones that can be selected.
+	if(commodity != cachedCommodity)
+		UpdateCache();
 	Point click = Point(x, y) / Zoom() - center;
-	for(const auto &it : GameData::Systems())
+	const System *clicked = nullptr;
+	double closest = 10.;
+	auto [begin, end] = NodesBetween(click.X() - closest, click.X() + closest);
+	for(auto it = begin; it != end; ++it)
 	{
-		const System &system = it.second;
-		if(system.IsValid() && !system.Inaccessible() && click.Distance(system.Position()) < 10.
-				&& (player.HasSeen(system) || &system == specialSystem))
+		double distance = click.Distance(it->position);
+		if(distance < closest)
 		{
-			Select(&system);
-			break;
+			closest = distance;
+			clicked = it->system;
 		}
 	}
+	if(clicked)
+		Select(clicked);
 
 	return true;
 }
@@ -709,7 +718,7 @@ void MapPanel::Select(const System *system)
 
 	selectedSystem = system;
 	// Update the cache to apply any visual changes needed after the selected system was changed.
-	UpdateCache();
+	UpdateNameColors();
 
 	vector<const System *> &plan = player.TravelPlan();
 	Ship *flagship = player.Flagship();
@@ -776,7 +785,7 @@ void MapPanel::Find(const string &name)
 			{
 				bestIndex = index;
 				selectedSystem = &system;
-				UpdateCache();
+				UpdateNameColors();
 				CenterOnSystem(selectedSystem);
 				if(!index)
 				{
@@ -887,8 +896,11 @@ void MapPanel::UpdateCache()
 	// Get danger level range so we can scale by it.
 	double dangerMax = 0.;
 	double dangerScale = 1.;
+	// The player's fleet is the same for every system, so only add it up once.
+	pair<double, double> raidFactors;
 	if(commodity == SHOW_DANGER)
 	{
+		raidFactors = player.RaidFleetFactors();
 		// Scale danger to span [0, 1] based on known systems, without including raid fleets
 		// as those can greatly skew the range once they start having a chance of appearing,
 		// leading to silly (and not very useful) displays.
@@ -901,7 +913,7 @@ void MapPanel::UpdateCache()
 			if(!system.IsValid() || system.Inaccessible() || !player.HasVisited(system))
 				continue;
 
-			const double danger = DangerFleetTotal(player, system, false);
+			const double danger = DangerFleetTotal(system, nullptr);
 			if(danger > 0.)
 			{
 				if(dangerMax < danger)
@@ -941,7 +953,7 @@ void MapPanel::UpdateCache()
 				if(commodity >= 0)
 				{
 					const Trade::Commodity &com = GameData::Commodities()[commodity];
-					double price = system.Trade(com.name);
+					double price = system.Trade(static_cast<size_t>(commodity));
 					if(!price)
 						value = numeric_limits<double>::quiet_NaN();
 					else
@@ -992,7 +1004,7 @@ void MapPanel::UpdateCache()
 			}
 			else if(commodity == SHOW_DANGER)
 			{
-				const double danger = DangerFleetTotal(player, system, true);
+				const double danger = DangerFleetTotal(system, &raidFactors);
 				if(danger > 0.)
 					color = DangerColor(1. - dangerScale * log(danger / dangerMax));
 				else
@@ -1035,13 +1047,15 @@ void MapPanel::UpdateCache()
 		static const vector<const Sprite *> unmappedSystem = {SpriteSet::Get("map/unexplored-star")};
 
 		const bool canViewSystem = player.CanView(system);
-		nodes.emplace_back(system.Position(), color,
+		nodes.emplace_back(&system, system.Position(), color,
 			player.KnowsName(system) ? system.DisplayName() : "",
 			(&system == &playerSystem || &system == selectedSystem) ? closeNameColor : farNameColor,
 			canViewSystem ? system.GetGovernment() : nullptr,
 			canViewSystem ? system.GetMapIcons() : unmappedSystem);
 	}
 
+	sort(nodes.begin(), nodes.end(), [](const Node &a, const Node &b) { return a.position.X() < b.position.X(); });
+
 	// Now, update the cache of the links.
 	links.clear();
 
@@ -1071,6 +1085,55 @@ void MapPanel::UpdateCache()
 
 
 
+void MapPanel::UpdateNameColors()
+{
+	if(commodity != cachedCommodity || nodes.empty())
+	{
+		UpdateCache();
+		return;
+	}
+
+	const Color &closeNameColor = *GameData::Colors().Get("map name");
+	const Color &farNameColor = closeNameColor.Transparent(.5);
+	for(Node &node : nodes)
+		node.nameColor = (node.system == &playerSystem || node.system == selectedSystem)
+			? closeNameColor : farNameColor;
+}
+
+
+
+pair<vector<MapPanel::Node>::const_iterator, vector<MapPanel::Node>::const_iterator> MapPanel::NodesBetween(
+	double minX, double maxX) const
+{
+	auto begin = lower_bound(nodes.begin(), nodes.end(), minX,
+		[](const Node &node, double x) { return node.position.X() < x; });
+	auto end = upper_bound(begin, nodes.end(), maxX,
+		[](double x, const Node &node) { return x < node.position.X(); });
+	return {begin, end};
+}
+
+
+
+pair<vector<MapPanel::Node>::const_iterator, vector<MapPanel::Node>::const_iterator> MapPanel::NodesOnScreen(
+	double leftMargin, double rightMargin) const
+{
+	// Something drawn to the right of a node can be seen even if the node is
+	// to the left of the screen, and vice versa.
+	double zoom = Zoom();
+	return NodesBetween((Screen::Left() - rightMargin) / zoom - center.X(),
+		(Screen::Right() + leftMargin) / zoom - center.X());
+}
+
+
+
+bool MapPanel::IsOnScreen(const Point &pos, double margin)
+{
+	return pos.X() >= Screen::Left() - margin && pos.X() <= Screen::Right() + margin
+		&& pos.Y() >= Screen::Top() - margin && pos.Y() <= Screen::Bottom() + margin;
+}
+
+
+
 void MapPanel::DrawTravelPlan()
 {
 	const Set<Color> &colors = GameData::Colors();
@@ -1261,6 +1324,8 @@ void MapPanel::DrawWormholes()
 	static const Angle RIGHT(-30.);
 	const double zoom = Zoom();
 
+	static vector<LineShader::Item> lineItems;
+	lineItems.clear();
 	for(const WormholeArrow &link : arrowsToDraw)
 	{
 		// Get the wormhole link color.
@@ -1279,7 +1344,7 @@ void MapPanel::DrawWormholes()
 		if(link.from < link.to || !count_if(arrowsToDraw.begin(), arrowsToDraw.end(),
 			[&link](const WormholeArrow &cmp)
 			{ return cmp.from == link.to && cmp.to == link.from; }))
-				LineShader::Draw(from, to, LINK_WIDTH, wormholeDim);
+				lineItems.push_back(LineShader::Prepare(from, to, LINK_WIDTH, wormholeDim));
 
 		// Compute the start and end positions of the arrow edges.
 		Point arrowStem = zoom * ARROW_LENGTH * offset;
@@ -1288,10 +1353,11 @@ void MapPanel::DrawWormholes()
 
 		// Draw the arrowhead.
 		Point fromTip = from - arrowStem;
-		LineShader::Draw(from, fromTip, LINK_WIDTH, arrowColor);
-		LineShader::Draw(from - arrowLeft, fromTip, LINK_WIDTH, arrowColor);
-		LineShader::Draw(from - arrowRight, fromTip, LINK_WIDTH, arrowColor);
+		lineItems.push_back(LineShader::Prepare(from, fromTip, LINK_WIDTH, arrowColor));
+		lineItems.push_back(LineShader::Prepare(from - arrowLeft, fromTip, LINK_WIDTH, arrowColor));
+		lineItems.push_back(LineShader::Prepare(from - arrowRight, fromTip, LINK_WIDTH, arrowColor));
 	}
+	LineShader::Draw(lineItems);
 }
 
 
@@ -1299,16 +1365,23 @@ void MapPanel::DrawWormholes()
 void MapPanel::DrawLinks()
 {
 	double zoom = Zoom();
+	static vector<LineShader::Item> lineItems;
+	lineItems.clear();
 	for(const Link &link : links)
 	{
 		Point from = zoom * (link.start + center);
 		Point to = zoom * (link.end + center);
+		// Skip links that are entirely off one side of the screen.
+		if(max(from.X(), to.X()) < Screen::Left() || min(from.X(), to.X()) > Screen::Right()
+				|| max(from.Y(), to.Y()) < Screen::Top() || min(from.Y(), to.Y()) > Screen::Bottom())
+			continue;
 		Point unit = (from - to).Unit() * LINK_OFFSET;
 		from -= unit;
 		to += unit;
 
-		LineShader::Draw(from, to, LINK_WIDTH, link.color);
+		lineItems.push_back(LineShader::Prepare(from, to, LINK_WIDTH, link.color));
 	}
+	LineShader::Draw(lineItems);
 }
 
 
@@ -1325,13 +1398,31 @@ void MapPanel::DrawSystems()
 		closeGovernments.clear();
 
 	// Draw the circles for the systems.
+	static vector<RingShader::Item> ringItems;
+	ringItems.clear();
 	BatchDrawList starBatch;
 	double zoom = Zoom();
 	for(const Node &node : nodes)
 	{
 		Point pos = zoom * (node.position + center);
+		if(commodity == SHOW_GOVERNMENT && node.government && node.government->DisplayName() != "Uninhabited")
+		{
+			// For every government that is drawn, keep track of how close it
+			// is to the center of the view. The four closest governments
+			// will be displayed in the key.
+			double distance = pos.Length();
+			auto it = closeGovernments.find(node.government);
+			if(it == closeGovernments.end())
+				closeGovernments[node.government] = distance;
+			else
+				it->second = min(it->second, distance);
+		}
+
+		// Star icons may be drawn some distance away from the system's position.
+		if(!IsOnScreen(pos, 100.))
+			continue;
 		if(commodity != SHOW_STARS)
-			RingShader::Draw(pos, OUTER, INNER, node.color);
+			ringItems.push_back(RingShader::Prepare(pos, OUTER, INNER, node.color));
 		else
 		{
 			// Ensures every multiple-star system has a characteristic, deterministic rotation.
@@ -1357,20 +1448,8 @@ void MapPanel::DrawSystems()
 				starBatch.Add(starBody);
 			}
 		}
-
-		if(commodity == SHOW_GOVERNMENT && node.government && node.government->DisplayName() != "Uninhabited")
-		{
-			// For every government that is drawn, keep track of how close it
-			// is to the center of the view. The four closest governments
-			// will be displayed in the key.
-			double distance = pos.Length();
-			auto it = closeGovernments.find(node.government);
-			if(it == closeGovernments.end())
-				closeGovernments[node.government] = distance;
-			else
-				it->second = min(it->second, distance);
-		}
 	}
+	RingShader::Draw(ringItems);
 	starBatch.Draw();
 	starBatch.Clear();
 }
@@ -1388,8 +1467,17 @@ void MapPanel::DrawNames()
 	bool useBigFont = (zoom > 2.);
 	const Font &font = FontSet::Get(useBigFont ? 18 : 14);
 	Point offset(useBigFont ? 8. : 6., -.5 * font.Height());
-	for(const Node &node : nodes)
-		font.Draw(node.name, zoom * (node.position + center) + offset, node.nameColor.Transparent(alpha));
+	// Names are drawn to the right of each system.
+	static const double NAME_WIDTH = 300.;
+	TextBatch batch;
+	auto [begin, end] = NodesOnScreen(0., NAME_WIDTH);
+	for(auto it = begin; it != end; ++it)
+	{
+		Point pos = zoom * (it->position + center) + offset;
+		if(pos.Y() < Screen::Top() - font.Height() || pos.Y() > Screen::Bottom())
+			continue;
+		font.Draw(it->name, pos, it->nameColor.Transparent(alpha));
+	}
 }
 
 
@@ -164,6 +164,9 @@ protected:
 	// Cache the map layout, so it doesn't have to be re-calculated every frame.
 	// The cache must be updated when the coloring mode changes.
 	void UpdateCache();
+	// Update only the colors of the system names, because the selected system
+	// has changed. This rebuilds the whole cache if it is out of date.
+	void UpdateNameColors();
 
 	// For tooltips:
 	const System *hoverSystem = nullptr;
@@ -179,11 +182,12 @@ protected:
 private:
 	class Node {
 	public:
-		Node(const Point &position, const Color &color, const std::string &name,
+		Node(const System *system, const Point &position, const Color &color, const std::string &name,
 			const Color &nameColor, const Government *government, const std::vector<const Sprite *> &mapIcons)
-			: position(position), color(color), name(name), nameColor(nameColor),
+			: system(system), position(position), color(color), name(name), nameColor(nameColor),
 			government(government), mapIcons(mapIcons) {}
 
+		const System *system;
 		Point position;
 		Color color;
 		std::string name;
@@ -217,6 +221,16 @@ private:
 	void DrawMissions();
 	void DrawPointer(const System *system, unsigned &systemCount, unsigned max, const Color &color, bool bigger = false);
 
+	// Get the nodes whose map x coordinate is within the given range.
+	std::pair<std::vector<Node>::const_iterator, std::vector<Node>::const_iterator> NodesBetween(
+		double minX, double maxX) const;
+	// Get the nodes that may be seen on the screen, if they are drawn at most
+	// the given number of pixels to their left or right.
+	std::pair<std::vector<Node>::const_iterator, std::vector<Node>::const_iterator> NodesOnScreen(
+		double leftMargin, double rightMargin) const;
+	// Check whether a point on the screen is within the given margin of its edges.
+	static bool IsOnScreen(const Point &pos, double margin);
+
 	void IncrementZoom();
 	void DecrementZoom();
 
@@ -225,6 +239,7 @@ private:
 	// This is the coloring mode currently used in the cache.
 	int cachedCommodity = -10;
 
+	// The systems that are drawn on the map, sorted by their x coordinate.
 	std::vector<Node> nodes;
 	std::vector<Link> links;
 };
@@ -16,7 +16,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "MapPlanetCard.h"
 
 #include "Color.h"
-#include "text/Translation.h"
 #include "text/DisplayText.h"
 #include "shader/FillShader.h"
 #include "text/Font.h"
@@ -51,8 +50,8 @@ MapPlanetCard::MapPlanetCard(const StellarObject &object, unsigned number, bool
 	hasSpaceport = planet->HasServices();
 	hasShipyard = planet->HasShipyard();
 	hasOutfitter = planet->HasOutfitter();
-	governmentName = Translation::TrGovernment(planet->GetGovernment()->DisplayName());
-	string systemGovernmentName = Translation::TrGovernment(planet->GetSystem()->GetGovernment()->DisplayName());
+	governmentName = planet->GetGovernment()->TranslatedDisplayName();
+	string systemGovernmentName = planet->GetSystem()->GetGovernment()->TranslatedDisplayName();
 	if(governmentName != "Uninhabited" && governmentName != systemGovernmentName)
 		hasGovernments = true;
 
@@ -0,0 +1,101 @@
+/* MappedFile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "MappedFile.h"
+
+#include "Files.h"
+#include "PackFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+
+MappedFile::MappedFile(const filesystem::path &path)
+{
+#ifndef _WIN32
+	int descriptor = open(path.c_str(), O_RDONLY);
+	if(descriptor >= 0)
+	{
+		struct stat info;
+		if(!fstat(descriptor, &info) && info.st_size > 0)
+		{
+			void *mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if(mapping != MAP_FAILED)
+			{
+				data = static_cast<const char *>(mapping);
+				size = info.st_size;
+				isMapped = true;
+			}
+		}
+		close(descriptor);
+		if(isMapped)
+			return;
+	}
+#endif
+	// Files inside a pack are viewed where they are in the pack's own mapping.
+	if(!exists(path))
+	{
+		pack = PackFile::Get(path);
+		string_view contents;
+		if(pack && pack->View(path, contents))
+		{
+			data = contents.data();
+			size = contents.size();
+			return;
+		}
+		pack.reset();
+	}
+
+	// Files that cannot be mapped, including those inside a zip, are read
+	// into a buffer instead.
+	buffer = Files::Read(path);
+	if(!buffer.empty())
+	{
+		data = buffer.data();
+		size = buffer.size();
+	}
+}
+
+
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+	if(isMapped)
+		munmap(const_cast<char *>(data), size);
+#endif
+}
+
+
+
+const char *MappedFile::Data() const
+{
+	return data;
+}
+
+
+
+size_t MappedFile::Size() const
+{
+	return size;
+}
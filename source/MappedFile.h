@@ -0,0 +1,52 @@
+/* MappedFile.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+class PackFile;
+
+
+
+// A read-only view of the contents of a file. Where possible the file is
+// memory-mapped, so that it is not copied before being read. Files inside a
+// pack are viewed in place, and those inside a plugin's zip are decompressed
+// into a buffer instead. If the file cannot be opened, the view is empty.
+class MappedFile {
+public:
+	explicit MappedFile(const std::filesystem::path &path);
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	~MappedFile();
+
+	const char *Data() const;
+	size_t Size() const;
+
+
+private:
+	const char *data = nullptr;
+	size_t size = 0;
+	bool isMapped = false;
+
+	// The pack that the file is in, which must stay open while it is viewed.
+	std::shared_ptr<const PackFile> pack;
+	// The contents, if the file could not be mapped.
+	std::string buffer;
+};
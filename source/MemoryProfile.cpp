@@ -0,0 +1,253 @@
+/* MemoryProfile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "MemoryProfile.h"
+
+#include "Files.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	constexpr size_t TAGS = static_cast<size_t>(MemoryProfile::Tag::COUNT);
+
+	const char *const NAMES[TAGS] = {
+		"other",
+		"data nodes",
+		"missions",
+		"conditions",
+		"translations",
+		"sprites",
+		"masks",
+		"audio",
+		"engine"
+	};
+
+	// The counts for each subsystem. These are only ever changed with relaxed
+	// operations, so a report may be slightly out of date, but never torn.
+	atomic<int64_t> bytes[TAGS];
+	atomic<int64_t> blocks[TAGS];
+	atomic<int64_t> allocations[TAGS];
+
+	thread_local MemoryProfile::Tag currentTag = MemoryProfile::Tag::OTHER;
+	thread_local int64_t threadAllocations = 0;
+
+	filesystem::path reportPath;
+
+	// Every allocation is preceded by this, so that freeing it can tell how big
+	// it was, which subsystem it was counted for, and where the block starts.
+	struct Header {
+		void *block;
+		size_t size;
+		MemoryProfile::Tag tag;
+	};
+
+	string Pad(string text, size_t width)
+	{
+		if(text.length() < width)
+			text.insert(0, width - text.length(), ' ');
+		return text;
+	}
+}
+
+
+
+MemoryProfile::Scope::Scope(Tag tag) noexcept
+	: previous(currentTag)
+{
+	currentTag = tag;
+}
+
+
+
+MemoryProfile::Scope::~Scope() noexcept
+{
+	currentTag = previous;
+}
+
+
+
+const char *MemoryProfile::Name(Tag tag) noexcept
+{
+	return NAMES[static_cast<size_t>(tag)];
+}
+
+
+
+MemoryProfile::Usage MemoryProfile::Get(Tag tag) noexcept
+{
+	const size_t index = static_cast<size_t>(tag);
+	Usage usage;
+	usage.bytes = bytes[index].load(memory_order_relaxed);
+	usage.blocks = blocks[index].load(memory_order_relaxed);
+	usage.allocations = allocations[index].load(memory_order_relaxed);
+	return usage;
+}
+
+
+
+// The bytes that are still allocated by all the subsystems together.
+int64_t MemoryProfile::TotalBytes() noexcept
+{
+	int64_t total = 0;
+	for(const atomic<int64_t> &it : bytes)
+		total += it.load(memory_order_relaxed);
+	return total;
+}
+
+
+
+// The number of allocations that the calling thread has made so far. The
+// difference between two calls is how many allocations happened in between.
+int64_t MemoryProfile::ThreadAllocations() noexcept
+{
+	return threadAllocations;
+}
+
+
+
+// Write the report to the given path, once the game quits.
+void MemoryProfile::Enable(const filesystem::path &path)
+{
+	reportPath = path;
+}
+
+
+
+// Write a table of every subsystem's memory, if a path was given.
+void MemoryProfile::WriteReport()
+{
+	if(reportPath.empty())
+		return;
+
+	Files::Write(reportPath, Report());
+	Logger::Log("Wrote the memory report to \"" + reportPath.string() + "\".", Logger::Level::INFO);
+}
+
+
+
+string MemoryProfile::Report()
+{
+	if(!IsAvailable())
+		return "The game was not built with the ES_MEMORY_PROFILE option, so its memory was not counted.\n";
+
+	vector<Tag> tags;
+	for(size_t i = 0; i < TAGS; ++i)
+		tags.push_back(static_cast<Tag>(i));
+	// Load the counts first, so that building the report does not change them.
+	vector<Usage> usage;
+	for(Tag tag : tags)
+		usage.push_back(Get(tag));
+	sort(tags.begin(), tags.end(),
+		[&usage](Tag a, Tag b) { return usage[static_cast<size_t>(a)].bytes > usage[static_cast<size_t>(b)].bytes; });
+
+	string out = "Memory still allocated by each part of the game:\n";
+	out += Pad("bytes", 14) + Pad("blocks", 12) + Pad("allocations", 14) + "  name\n";
+	for(Tag tag : tags)
+	{
+		const Usage &it = usage[static_cast<size_t>(tag)];
+		out += Pad(to_string(it.bytes), 14) + Pad(to_string(it.blocks), 12)
+			+ Pad(to_string(it.allocations), 14) + "  " + Name(tag) + '\n';
+	}
+	return out;
+}
+
+
+
+void *MemoryProfile::Allocate(size_t size, size_t alignment) noexcept
+{
+	alignment = max(alignment, alignof(max_align_t));
+	void *block = malloc(size + sizeof(Header) + alignment);
+	if(!block)
+		return nullptr;
+
+	// Leave room for the header, then round up to the alignment.
+	uintptr_t address = reinterpret_cast<uintptr_t>(block) + sizeof(Header);
+	address = (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+	Header *header = reinterpret_cast<Header *>(address) - 1;
+	header->block = block;
+	header->size = size;
+	header->tag = currentTag;
+
+	const size_t index = static_cast<size_t>(currentTag);
+	bytes[index].fetch_add(size, memory_order_relaxed);
+	blocks[index].fetch_add(1, memory_order_relaxed);
+	allocations[index].fetch_add(1, memory_order_relaxed);
+	++threadAllocations;
+	return reinterpret_cast<void *>(address);
+}
+
+
+
+void MemoryProfile::Free(void *pointer) noexcept
+{
+	if(!pointer)
+		return;
+
+	const Header *header = static_cast<const Header *>(pointer) - 1;
+	const size_t index = static_cast<size_t>(header->tag);
+	bytes[index].fetch_sub(header->size, memory_order_relaxed);
+	blocks[index].fetch_sub(1, memory_order_relaxed);
+	free(header->block);
+}
+
+
+
+#ifdef ES_MEMORY_PROFILE
+// Route every allocation that the game makes through the profile.
+namespace {
+	void *AllocateOrThrow(size_t size, size_t alignment = 0)
+	{
+		void *pointer = MemoryProfile::Allocate(size, alignment);
+		if(!pointer)
+			throw bad_alloc();
+		return pointer;
+	}
+}
+
+void *operator new(size_t size) { return AllocateOrThrow(size); }
+void *operator new[](size_t size) { return AllocateOrThrow(size); }
+void *operator new(size_t size, align_val_t alignment) { return AllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, align_val_t alignment) { return AllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void *operator new(size_t size, const nothrow_t &) noexcept { return MemoryProfile::Allocate(size, 0); }
+void *operator new[](size_t size, const nothrow_t &) noexcept { return MemoryProfile::Allocate(size, 0); }
+void *operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+	return MemoryProfile::Allocate(size, static_cast<size_t>(alignment));
+}
+void *operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept
+{
+	return MemoryProfile::Allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept { MemoryProfile::Free(pointer); }
+void operator delete[](void *pointer) noexcept { MemoryProfile::Free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { MemoryProfile::Free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { MemoryProfile::Free(pointer); }
+void operator delete(void *pointer, align_val_t) noexcept { MemoryProfile::Free(pointer); }
+void operator delete[](void *pointer, align_val_t) noexcept { MemoryProfile::Free(pointer); }
+void operator delete(void *pointer, size_t, align_val_t) noexcept { MemoryProfile::Free(pointer); }
+void operator delete[](void *pointer, size_t, align_val_t) noexcept { MemoryProfile::Free(pointer); }
+void operator delete(void *pointer, const nothrow_t &) noexcept { MemoryProfile::Free(pointer); }
+void operator delete[](void *pointer, const nothrow_t &) noexcept { MemoryProfile::Free(pointer); }
+void operator delete(void *pointer, align_val_t, const nothrow_t &) noexcept { MemoryProfile::Free(pointer); }
+void operator delete[](void *pointer, align_val_t, const nothrow_t &) noexcept { MemoryProfile::Free(pointer); }
+#endif
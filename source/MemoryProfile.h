@@ -0,0 +1,104 @@
+/* MemoryProfile.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+
+
+// Counts the memory that each part of the game has allocated and not yet freed,
+// so that it is clear which subsystems to target when trying to use less memory.
+// Every allocation is attributed to the subsystem that the allocating thread is
+// working for at the time, and freeing it later subtracts it from that same one.
+//
+// Counting every allocation has a cost, so the game only does it when it was
+// built with the ES_MEMORY_PROFILE option. Otherwise, marking a subsystem costs
+// nothing, and every count is zero.
+class MemoryProfile {
+public:
+	enum class Tag : uint8_t {
+		OTHER,
+		DATA_NODES,
+		MISSIONS,
+		CONDITIONS,
+		TRANSLATIONS,
+		SPRITES,
+		MASKS,
+		AUDIO,
+		ENGINE,
+		COUNT
+	};
+
+	// Attributes the memory that this thread allocates to the given subsystem,
+	// from the construction of this object until it goes out of scope.
+	class Scope {
+	public:
+		explicit Scope(Tag tag) noexcept;
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+		~Scope() noexcept;
+
+	private:
+		Tag previous;
+	};
+
+	// The memory attributed to one subsystem.
+	class Usage {
+	public:
+		// The bytes and the number of blocks that are still allocated.
+		int64_t bytes = 0;
+		int64_t blocks = 0;
+		// The number of allocations made since the start of the game.
+		int64_t allocations = 0;
+	};
+
+
+public:
+	// Whether the game was built to count its allocations.
+	static constexpr bool IsAvailable() noexcept;
+
+	static const char *Name(Tag tag) noexcept;
+	static Usage Get(Tag tag) noexcept;
+	// The bytes that are still allocated by all the subsystems together.
+	static int64_t TotalBytes() noexcept;
+	// The number of allocations that the calling thread has made so far. The
+	// difference between two calls is how many allocations happened in between.
+	static int64_t ThreadAllocations() noexcept;
+
+	// Write the report to the given path, once the game quits.
+	static void Enable(const std::filesystem::path &path);
+	// Write a table of every subsystem's memory, if a path was given.
+	static void WriteReport();
+	static std::string Report();
+
+	// Used by the replacements of the global operator new and delete.
+	static void *Allocate(std::size_t size, std::size_t alignment) noexcept;
+	static void Free(void *pointer) noexcept;
+};
+
+
+
+constexpr bool MemoryProfile::IsAvailable() noexcept
+{
+#ifdef ES_MEMORY_PROFILE
+	return true;
+#else
+	return false;
+#endif
+}
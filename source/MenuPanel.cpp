@@ -60,7 +60,7 @@ namespace {
 MenuPanel::MenuPanel(PlayerInfo &player, UI &gamePanels)
 	: player(player), gamePanels(gamePanels), mainMenuUi(GameData::Interfaces().Get("main menu"))
 {
-	assert(GameData::IsLoaded() && "MenuPanel should only be created after all data is fully loaded");
+	assert(GameData::IsReadyForMenu() && "MenuPanel should only be created after all data is fully loaded");
 	SetIsFullScreen(true);
 
 	if(mainMenuUi->GetBox("credits").Dimensions())
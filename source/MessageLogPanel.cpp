@@ -83,17 +83,32 @@ void MessageLogPanel::Draw()
 		messageLine.SetAlignment(Alignment::LEFT);
 		messageLine.SetWrapWidth(width - 2. * PAD);
 
+		if(heights.size() != messages.size())
+		{
+			heights.clear();
+			heights.reserve(messages.size());
+			for(const auto &it : messages)
+			{
+				messageLine.Wrap(it.first);
+				heights.push_back(messageLine.Height());
+			}
+		}
+
 		// Draw messages.
 		Point pos = Screen::BottomLeft() + Point(PAD, scroll);
+		auto height = heights.begin();
 		for(const auto &[text, category] : messages)
 		{
+			const int lineHeight = *height++;
 			if(importantOnly && !category->IsImportant())
 				continue;
 
-			messageLine.Wrap(text);
-			pos.Y() -= messageLine.Height();
-			if(pos.Y() >= Screen::Top() - 3 * font.Height())
+			pos.Y() -= lineHeight;
+			if(pos.Y() >= Screen::Top() - 3 * font.Height() && pos.Y() < Screen::Bottom())
+			{
+				messageLine.Wrap(text);
 				messageLine.Draw(pos, category->LogColor());
+			}
 		}
 
 		maxScroll = max(0., scroll - pos.Y() + Screen::Top());
@@ -19,6 +19,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Messages.h"
 
+#include <vector>
+
 
 
 // User interface panel that displays the message log.
@@ -39,6 +41,10 @@ protected:
 
 private:
 	const std::deque<std::pair<std::string, const Message::Category *>> &messages;
+	// The wrapped height of each message, so that only the ones on screen need
+	// to be laid out again each frame. The log does not grow while this panel
+	// is open, but it may be cleared.
+	std::vector<int> heights;
 
 	const double width;
 	bool importantOnly = false;
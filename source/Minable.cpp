@@ -73,7 +73,7 @@ void Minable::Load(const DataNode &node, const ConditionsStore *playerConditions
 		bool hasValue = child.Size() >= 2;
 
 		if(key == "attributes")
-			attributes.Load(child, playerConditions);
+			MutableAttributes().Load(child, playerConditions);
 		else if(!hasValue)
 			child.PrintTrace("Expected key to have a value:");
 		else if(key == "display name")
@@ -291,14 +291,14 @@ double Minable::MaxHull() const
 
 double Minable::Mass() const
 {
-	return attributes.Mass();
+	return attributes->Mass();
 }
 
 
 
 double Minable::MaximumHeat() const
 {
-	return MAXIMUM_TEMPERATURE * (attributes.Mass() + attributes.Get("heat capacity"));
+	return MAXIMUM_TEMPERATURE * (attributes->Mass() + attributes->Get("heat capacity"));
 }
 
 
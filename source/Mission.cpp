@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Mission.h"
 
+#include "ConditionEntry.h"
 #include "DataNode.h"
 #include "DataWriter.h"
 #include "DialogPanel.h"
@@ -24,7 +25,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "text/Translation.h"
 #include "GameData.h"
 #include "Government.h"
+#include "JumpTable.h"
 #include "Logger.h"
+#include "MemoryProfile.h"
 #include "Messages.h"
 #include "Phrase.h"
 #include "Planet.h"
@@ -35,6 +38,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 #include "UI.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <sstream>
@@ -48,11 +52,11 @@ namespace {
 	{
 		vector<int> weight;
 		int total = 0;
-		for(const Trade::Commodity &commodity : GameData::Commodities())
+		for(size_t i = 0; i < GameData::Commodities().size(); ++i)
 		{
 			// For every 100 credits in profit you can make, double the chance
 			// of this commodity being chosen.
-			double profit = to.Trade(commodity.name) - from.Trade(commodity.name);
+			double profit = to.Trade(i) - from.Trade(i);
 			int w = max<int>(1, 100. * pow(2., profit * .01));
 			weight.push_back(w);
 			total += w;
@@ -112,23 +116,36 @@ namespace {
 				return "unknown trigger";
 		}
 	}
+
+	// Only these actions can prevent a mission from being offered, so they can
+	// never be deferred when a mission is loaded lazily.
+	bool IsNeededToOffer(const DataNode &child)
+	{
+		if(child.Token(0) != "on" || child.Size() < 2)
+			return false;
+		const string &trigger = child.Token(1);
+		return trigger == "offer" || trigger == "accept" || trigger == "decline" || trigger == "defer";
+	}
 }
 
 
 
 // Construct and Load() at the same time.
 Mission::Mission(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	Load(node, playerConditions, visitedSystems, visitedPlanets);
 }
 
 
 
-// Load a mission, either from the game data or from a saved game.
+// Load a mission, either from the game data or from a saved game. If it is
+// loaded lazily, only the parts needed to decide whether to offer it are
+// parsed, and the rest are kept until LoadDeferred() is called.
 void Mission::Load(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets, bool isLazy)
 {
+	MemoryProfile::Scope memoryScope(MemoryProfile::Tag::MISSIONS);
 	// All missions need a name.
 	if(node.Size() < 2)
 	{
@@ -326,55 +343,17 @@ void Mission::Load(const DataNode &node, const ConditionsStore *playerConditions
 		}
 		else if(key == "substitutions" && child.HasChildren())
 			substitutions.Load(child, playerConditions);
-		else if(key == "npc")
-			npcs.emplace_back(child, playerConditions, visitedSystems, visitedPlanets);
-		else if(key == "timer" && hasValue)
-			timers.emplace_back(child, playerConditions, visitedSystems, visitedPlanets);
-		else if(key == "on" && hasValue && child.Token(1) == "enter")
-		{
-			// "on enter" nodes may either name a specific system or use a LocationFilter
-			// to control the triggering system.
-			if(child.Size() >= 3)
-			{
-				MissionAction &action = onEnter[GameData::Systems().Get(child.Token(2))];
-				action.Load(child, playerConditions, visitedSystems, visitedPlanets);
-			}
-			else
-				genericOnEnter.emplace_back(child, playerConditions, visitedSystems, visitedPlanets);
-		}
-		else if(key == "on" && hasValue && child.Token(1) == "land")
+		else if(key == "npc" || (key == "timer" && hasValue) || (key == "on" && hasValue))
 		{
-			// "on land" nodes may either name a specific planet or use a LocationFilter
-			// to control the triggering planet.
-			if(child.Size() >= 3)
+			if(isLazy && !IsNeededToOffer(child))
 			{
-				MissionAction &action = onLand[GameData::Planets().Get(child.Token(2))];
-				action.Load(child, playerConditions, visitedSystems, visitedPlanets);
+				if(!deferred.Size())
+					for(const string &token : node.Tokens())
+						deferred.AddToken(token);
+				deferred.AddChild(child);
 			}
 			else
-				genericOnLand.emplace_back(child, playerConditions, visitedSystems, visitedPlanets);
-		}
-		else if(key == "on" && hasValue)
-		{
-			static const map<string, Trigger> trigger = {
-				{"complete", COMPLETE},
-				{"offer", OFFER},
-				{"accept", ACCEPT},
-				{"decline", DECLINE},
-				{"fail", FAIL},
-				{"abort", ABORT},
-				{"defer", DEFER},
-				{"visit", VISIT},
-				{"stopover", STOPOVER},
-				{"waypoint", WAYPOINT},
-				{"daily", DAILY},
-				{"disabled", DISABLED},
-			};
-			auto it = trigger.find(child.Token(1));
-			if(it != trigger.end())
-				actions[it->second].Load(child, playerConditions, visitedSystems, visitedPlanets);
-			else
-				child.PrintTrace("Skipping unrecognized attribute:");
+				LoadInstanceData(child, playerConditions, visitedSystems, visitedPlanets);
 		}
 		else if(key == "color" && child.Size() >= 3)
 		{
@@ -401,6 +380,31 @@ void Mission::Load(const DataNode &node, const ConditionsStore *playerConditions
 	if(displayName.empty())
 		displayName = trueName;
 	hasTrackedNpcs = ranges::any_of(npcs, [](const NPC &npc) { return npc.GetPersonality().IsTracked(); });
+	if(deferred.HasChildren())
+	{
+		deferredConditions = playerConditions;
+		deferredSystems = visitedSystems;
+		deferredPlanets = visitedPlanets;
+	}
+}
+
+
+
+// Parse the parts of a lazily loaded mission that were skipped by Load().
+void Mission::LoadDeferred()
+{
+	MemoryProfile::Scope memoryScope(MemoryProfile::Tag::MISSIONS);
+	for(const DataNode &child : deferred)
+		LoadInstanceData(child, deferredConditions, deferredSystems, deferredPlanets);
+	deferred = DataNode();
+	hasTrackedNpcs = ranges::any_of(npcs, [](const NPC &npc) { return npc.GetPersonality().IsTracked(); });
+}
+
+
+
+bool Mission::HasDeferred() const noexcept
+{
+	return deferred.HasChildren();
 }
 
 
@@ -765,6 +769,20 @@ bool Mission::IsAtLocation(Location location) const
 
 
 // Information about what you are doing.
+const Planet *Mission::Source() const
+{
+	return source;
+}
+
+
+
+const LocationFilter &Mission::SourceFilter() const
+{
+	return sourceFilter;
+}
+
+
+
 const Ship *Mission::SourceShip() const
 {
 	return sourceShip;
@@ -1207,8 +1225,8 @@ string Mission::BlockedMessage(const PlayerInfo &player)
 		out << "no additional space";
 	subs["<capacity>"] = out.str();
 
-	for(const auto &keyValue : subs)
-		subs[keyValue.first] = Phrase::ExpandPhrases(keyValue.second);
+	for(auto &keyValue : subs)
+		keyValue.second = Phrase::ExpandPhrases(keyValue.second);
 	Format::Expand(subs);
 
 	string message = Format::ReplaceTranslated(blocked, subs);
@@ -1373,8 +1391,19 @@ const list<NPC> &Mission::NPCs() const
 // Update which NPCs are active based on their spawn and despawn conditions.
 void Mission::UpdateNPCs(const PlayerInfo &player)
 {
+	// If no condition has been set since the last update, and none of the NPCs
+	// depend on provided conditions, none of them can have changed.
+	const uint64_t changes = ConditionEntry::Changes();
+	if(areNPCsSettled && changes == npcChanges)
+		return;
+
+	areNPCsSettled = true;
 	for(auto &npc : npcs)
+	{
 		npc.UpdateSpawning(player);
+		areNPCsSettled &= npc.IsSpawningSettled();
+	}
+	npcChanges = changes;
 }
 
 
@@ -1457,6 +1486,9 @@ void Mission::Do(const ShipEvent &event, PlayerInfo &player, UI &ui)
 			UpdateNPCs(player);
 	}
 
+	// Most events are for ships that none of this mission's NPCs care about.
+	if(!IsNPCShip(event.Target().get()))
+		return;
 	for(NPC &npc : npcs)
 	{
 		bool isTarget = npc.Do(event, player, ui, this, isVisible);
@@ -1465,6 +1497,27 @@ void Mission::Do(const ShipEvent &event, PlayerInfo &player, UI &ui)
 		if((event.Type() & (ShipEvent::JUMP | ShipEvent::DESTROY)) && isTarget)
 			RecalculateTrackedSystems();
 	}
+	// A captured NPC ship is replaced by a destroyed copy of it.
+	if(event.Type() & ShipEvent::CAPTURE)
+		npcShipsAreStale = true;
+}
+
+
+
+// Check whether the given ship is one of this mission's NPCs, using the
+// index of their ships rather than searching each NPC.
+bool Mission::IsNPCShip(const Ship *ship)
+{
+	if(npcShipsAreStale)
+	{
+		npcShips.clear();
+		for(const NPC &npc : npcs)
+			for(const shared_ptr<Ship> &npcShip : npc.Ships())
+				npcShips.push_back(npcShip.get());
+		sort(npcShips.begin(), npcShips.end());
+		npcShipsAreStale = false;
+	}
+	return binary_search(npcShips.begin(), npcShips.end(), ship);
 }
 
 
@@ -1485,6 +1538,10 @@ const MissionAction &Mission::GetAction(Trigger trigger) const
 // with a single choice, and then replacing any wildcard text as well.
 Mission Mission::Instantiate(const PlayerInfo &player, const shared_ptr<Ship> &boardingShip) const
 {
+	// A stock mission that was loaded lazily must be fully parsed before it can be instantiated.
+	if(HasDeferred())
+		GameData::LoadDeferredMission(*this);
+
 	Mission result;
 	// If anything goes wrong below, this mission should not be offered.
 	result.hasFailed = true;
@@ -1671,8 +1728,8 @@ Mission Mission::Instantiate(const PlayerInfo &player, const shared_ptr<Ship> &b
 		subs["<marks>"] = Format::List<set, const System *>(result.markedSystems, getDisplayName);
 
 	// Done making subs, so expand the phrases and recursively substitute.
-	for(const auto &keyValue : subs)
-		subs[keyValue.first] = Phrase::ExpandPhrases(keyValue.second);
+	for(auto &keyValue : subs)
+		keyValue.second = Phrase::ExpandPhrases(keyValue.second);
 	Format::Expand(subs);
 
 	// Instantiate the NPCs. This also fills in the "<npc>" substitution.
@@ -1788,20 +1845,21 @@ int Mission::CalculateJumps(const System *sourceSystem)
 	for(const Planet *planet : stopovers)
 		destinations.push_back(planet->GetSystem());
 
+	auto Days = [this](const System *from, const System &to) -> int
+	{
+		return from ? JumpTable::Jumps(*from, to, distanceCalcSettings) : -1;
+	};
 	while(!destinations.empty())
 	{
 		// Find the closest destination to this location.
-		DistanceMap distance(sourceSystem,
-				distanceCalcSettings.WormholeStrat(),
-				distanceCalcSettings.AssumesJumpDrive());
 		auto it = destinations.begin();
 		auto bestIt = it;
-		int bestDays = distance.Days(**bestIt);
+		int bestDays = Days(sourceSystem, **bestIt);
 		if(bestDays < 0)
 			bestDays = numeric_limits<int>::max();
 		for(++it; it != destinations.end(); ++it)
 		{
-			int days = distance.Days(**it);
+			int days = Days(sourceSystem, **it);
 			if(days >= 0 && days < bestDays)
 			{
 				bestIt = it;
@@ -1814,11 +1872,8 @@ int Mission::CalculateJumps(const System *sourceSystem)
 		expectedJumps += bestDays == numeric_limits<int>::max() ? -1 : bestDays;
 		destinations.erase(bestIt);
 	}
-	DistanceMap distance(sourceSystem,
-			distanceCalcSettings.WormholeStrat(),
-			distanceCalcSettings.AssumesJumpDrive());
 	// If currently unreachable, this system adds -1 to the deadline, to match previous behavior.
-	expectedJumps += distance.Days(*destination->GetSystem());
+	expectedJumps += Days(sourceSystem, *destination->GetSystem());
 
 	return expectedJumps;
 }
@@ -1875,6 +1930,71 @@ bool Mission::Land(const Planet *planet, PlayerInfo &player, UI &ui)
 
 
 
+// Parse a child node that is only needed once the mission is instantiated:
+// its NPCs, timers and most of its actions.
+void Mission::LoadInstanceData(const DataNode &child, const ConditionsStore *playerConditions,
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
+{
+	const string &key = child.Token(0);
+	bool hasValue = child.Size() >= 2;
+	if(key == "npc")
+	{
+		npcs.emplace_back(child, playerConditions, visitedSystems, visitedPlanets);
+		npcShipsAreStale = true;
+		areNPCsSettled = false;
+	}
+	else if(key == "timer" && hasValue)
+		timers.emplace_back(child, playerConditions, visitedSystems, visitedPlanets);
+	else if(key == "on" && hasValue && child.Token(1) == "enter")
+	{
+		// "on enter" nodes may either name a specific system or use a LocationFilter
+		// to control the triggering system.
+		if(child.Size() >= 3)
+		{
+			MissionAction &action = onEnter[GameData::Systems().Get(child.Token(2))];
+			action.Load(child, playerConditions, visitedSystems, visitedPlanets);
+		}
+		else
+			genericOnEnter.emplace_back(child, playerConditions, visitedSystems, visitedPlanets);
+	}
+	else if(key == "on" && hasValue && child.Token(1) == "land")
+	{
+		// "on land" nodes may either name a specific planet or use a LocationFilter
+		// to control the triggering planet.
+		if(child.Size() >= 3)
+		{
+			MissionAction &action = onLand[GameData::Planets().Get(child.Token(2))];
+			action.Load(child, playerConditions, visitedSystems, visitedPlanets);
+		}
+		else
+			genericOnLand.emplace_back(child, playerConditions, visitedSystems, visitedPlanets);
+	}
+	else if(key == "on" && hasValue)
+	{
+		static const map<string, Trigger> trigger = {
+			{"complete", COMPLETE},
+			{"offer", OFFER},
+			{"accept", ACCEPT},
+			{"decline", DECLINE},
+			{"fail", FAIL},
+			{"abort", ABORT},
+			{"defer", DEFER},
+			{"visit", VISIT},
+			{"stopover", STOPOVER},
+			{"waypoint", WAYPOINT},
+			{"daily", DAILY},
+			{"disabled", DISABLED},
+		};
+		auto it = trigger.find(child.Token(1));
+		if(it != trigger.end())
+			actions[it->second].Load(child, playerConditions, visitedSystems, visitedPlanets);
+		else
+			child.PrintTrace("Skipping unrecognized attribute:");
+	}
+}
+
+
+
 // For legacy code, contraband definitions can be placed in two different
 // locations, so move that parsing out to a helper function.
 bool Mission::ParseContraband(const DataNode &node)
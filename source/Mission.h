@@ -17,24 +17,27 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Color.h"
 #include "ConditionSet.h"
+#include "DataNode.h"
 #include "Date.h"
 #include "DistanceCalculationSettings.h"
 #include "EsUuid.h"
 #include "ExclusiveItem.h"
+#include "IndexedSet.h"
 #include "LocationFilter.h"
 #include "MissionAction.h"
 #include "MissionTimer.h"
 #include "NPC.h"
 #include "TextReplacements.h"
 
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 class ConditionsStore;
-class DataNode;
 class DataWriter;
 class Planet;
 class PlayerInfo;
@@ -62,11 +65,17 @@ public:
 
 	// Construct and Load() at the same time.
 	explicit Mission(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 
-	// Load a mission, either from the game data or from a saved game.
+	// Load a mission, either from the game data or from a saved game. If it is
+	// loaded lazily, only the parts needed to decide whether to offer it are
+	// parsed, and the rest are kept until LoadDeferred() is called.
 	void Load(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets,
+		bool isLazy = false);
+	// Parse the parts of a lazily loaded mission that were skipped by Load().
+	void LoadDeferred();
+	bool HasDeferred() const noexcept;
 	// Save a mission. It is safe to assume that any mission that is being saved
 	// is already "instantiated," so only a subset of the data must be saved.
 	void Save(DataWriter &out, const std::string &tag = "mission") const;
@@ -108,6 +117,10 @@ public:
 	enum Location {SPACEPORT, LANDING, JOB, ASSISTING, BOARDING, SHIPYARD, OUTFITTER, JOB_BOARD, ENTERING, TRANSITION};
 	bool IsAtLocation(Location location) const;
 
+	// Where this mission may be offered, if it is offered on landing.
+	const Planet *Source() const;
+	const LocationFilter &SourceFilter() const;
+
 	// Information about what you are doing.
 	const Ship *SourceShip() const;
 	const Planet *Destination() const;
@@ -217,6 +230,13 @@ private:
 	// For legacy code, contraband definitions can be placed in two different
 	// locations, so move that parsing out to a helper function.
 	bool ParseContraband(const DataNode &node);
+	// Parse a child node that is only needed once the mission is instantiated:
+	// its NPCs, timers and most of its actions.
+	void LoadInstanceData(const DataNode &child, const ConditionsStore *playerConditions,
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
+	// Check whether the given ship is one of this mission's NPCs, using the
+	// index of their ships rather than searching each NPC.
+	bool IsNPCShip(const Ship *ship);
 
 
 private:
@@ -298,11 +318,27 @@ private:
 	bool hasTrackedNpcs = false;
 	std::set<const System *> trackedSystems;
 
+	// The child nodes that LoadDeferred() still needs to parse, as children of a
+	// copy of the mission's own node so that their traces show which mission they
+	// are in, and what to parse them with.
+	DataNode deferred;
+	const ConditionsStore *deferredConditions = nullptr;
+	const IndexedSet<System> *deferredSystems = nullptr;
+	const IndexedSet<Planet> *deferredPlanets = nullptr;
+
 	// User-defined text replacements unique to this mission:
 	TextReplacements substitutions;
 
 	// NPCs:
 	std::list<NPC> npcs;
+	// The condition changes as of the last update of the NPCs' spawn states, and
+	// whether those states can only change once another condition is set.
+	uint64_t npcChanges = 0;
+	bool areNPCsSettled = false;
+	// The ships of all the NPCs, sorted, so that an event for any other ship
+	// does not have to be checked against each NPC.
+	std::vector<const Ship *> npcShips;
+	bool npcShipsAreStale = true;
 	// Timers:
 	std::list<MissionTimer> timers;
 
@@ -60,7 +60,7 @@ namespace {
 
 // Construct and Load() at the same time.
 MissionAction::MissionAction(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	Load(node, playerConditions, visitedSystems, visitedPlanets);
 }
@@ -68,7 +68,7 @@ MissionAction::MissionAction(const DataNode &node, const ConditionsStore *player
 
 
 void MissionAction::Load(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	if(node.Size() >= 2)
 		trigger = node.Token(1);
@@ -82,7 +82,7 @@ void MissionAction::Load(const DataNode &node, const ConditionsStore *playerCond
 
 
 void MissionAction::LoadSingle(const DataNode &child, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	const string &key = child.Token(0);
 	bool hasValue = child.Size() >= 2;
@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DialogSettings.h"
 #include "ExclusiveItem.h"
 #include "GameAction.h"
+#include "IndexedSet.h"
 #include "LocationFilter.h"
 
 #include <map>
@@ -46,12 +47,12 @@ public:
 	MissionAction() = default;
 	// Construct and Load() at the same time.
 	MissionAction(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 
 	void Load(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 	void LoadSingle(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 	// Note: the Save() function can assume this is an instantiated mission, not
 	// a template, so it only has to save a subset of the data.
 	void Save(DataWriter &out) const;
@@ -0,0 +1,116 @@
+/* MissionIndex.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "MissionIndex.h"
+
+#include "LocationFilter.h"
+#include "Mission.h"
+#include "Planet.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// Add the missions stored under the given key, if there are any.
+	template<class Key>
+	void Append(const map<Key, vector<size_t>> &index, const Key &key, vector<size_t> &result)
+	{
+		auto it = index.find(key);
+		if(it != index.end())
+			result.insert(result.end(), it->second.begin(), it->second.end());
+	}
+}
+
+
+
+void MissionIndex::Build(const Set<Mission> &missions)
+{
+	this->missions.clear();
+	anywhere.clear();
+	byPlanet.clear();
+	bySystem.clear();
+	byGovernment.clear();
+	byAttribute.clear();
+
+	for(const auto &[name, mission] : missions)
+	{
+		// Missions that are offered in space are not offered on landing.
+		if(mission.IsAtLocation(Mission::BOARDING) || mission.IsAtLocation(Mission::ASSISTING)
+				|| mission.IsAtLocation(Mission::ENTERING) || mission.IsAtLocation(Mission::TRANSITION))
+			continue;
+
+		size_t index = this->missions.size();
+		this->missions.push_back(&mission);
+		if(mission.Source())
+		{
+			byPlanet[mission.Source()].push_back(index);
+			continue;
+		}
+
+		// A planet must meet every part of the filter, so index the mission under
+		// whichever part names the fewest planets, systems, governments or attributes.
+		const LocationFilter &filter = mission.SourceFilter();
+		const set<const Planet *> &planets = filter.Planets();
+		const set<const System *> &systems = filter.Systems();
+		const set<const Government *> &governments = filter.Governments();
+		const set<string> &attributes = filter.RequiredAttributes();
+		size_t smallest = 0;
+		for(size_t size : {planets.size(), systems.size(), governments.size(), attributes.size()})
+			if(size && (!smallest || size < smallest))
+				smallest = size;
+
+		if(!smallest)
+			anywhere.push_back(index);
+		else if(planets.size() == smallest)
+			for(const Planet *planet : planets)
+				byPlanet[planet].push_back(index);
+		else if(systems.size() == smallest)
+			for(const System *system : systems)
+				bySystem[system].push_back(index);
+		else if(governments.size() == smallest)
+			for(const Government *government : governments)
+				byGovernment[government].push_back(index);
+		else
+			for(const string &attribute : attributes)
+				byAttribute[attribute].push_back(index);
+	}
+}
+
+
+
+vector<const Mission *> MissionIndex::Candidates(const Planet *planet) const
+{
+	vector<const Mission *> result;
+	if(!planet)
+		return result;
+
+	// Planets, systems and governments can change when events happen, so the
+	// planet's current state is what is looked up here.
+	vector<size_t> indices = anywhere;
+	Append(byPlanet, planet, indices);
+	Append(bySystem, planet->GetSystem(), indices);
+	Append(byGovernment, planet->GetGovernment(), indices);
+	for(const string &attribute : planet->Attributes())
+		Append(byAttribute, attribute, indices);
+
+	sort(indices.begin(), indices.end());
+	indices.erase(unique(indices.begin(), indices.end()), indices.end());
+
+	result.reserve(indices.size());
+	for(size_t index : indices)
+		result.push_back(missions[index]);
+	return result;
+}
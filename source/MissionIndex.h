@@ -0,0 +1,57 @@
+/* MissionIndex.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Set.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+class Government;
+class Mission;
+class Planet;
+class System;
+
+
+
+// An index of the missions that may be offered when the player lands, sorted by
+// the planet, system, government or attribute that each one's source requires.
+// This way, landing only needs to check the missions that could be offered on
+// that planet, instead of every mission in the game.
+class MissionIndex {
+public:
+	// Index the given missions, replacing anything that was indexed before.
+	void Build(const Set<Mission> &missions);
+
+	// Get the missions that might be offered on the given planet, in the order
+	// that they are defined. Whether each one is actually offered must still be
+	// checked with Mission::CanOffer().
+	std::vector<const Mission *> Candidates(const Planet *planet) const;
+
+
+private:
+	// Missions are referred to by their position in this list, so that the
+	// candidates from each part of the index can be merged back into order.
+	std::vector<const Mission *> missions;
+	// The missions whose source does not need any of the indexed properties.
+	std::vector<size_t> anywhere;
+	std::map<const Planet *, std::vector<size_t>> byPlanet;
+	std::map<const System *, std::vector<size_t>> bySystem;
+	std::map<const Government *, std::vector<size_t>> byGovernment;
+	std::map<std::string, std::vector<size_t>> byAttribute;
+};
@@ -46,7 +46,7 @@ namespace {
 
 
 MissionTimer::MissionTimer(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	Load(node, playerConditions, visitedSystems, visitedPlanets);
 }
@@ -54,7 +54,7 @@ MissionTimer::MissionTimer(const DataNode &node, const ConditionsStore *playerCo
 
 
 void MissionTimer::Load(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	if(node.Size() < 2)
 	{
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "IndexedSet.h"
 #include "LocationFilter.h"
 
 #include <cstdint>
@@ -51,10 +52,10 @@ public:
 public:
 	MissionTimer() = default;
 	MissionTimer(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 	// Set up the timer from its data file node.
 	void Load(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 	void Save(DataWriter &out) const;
 
 	// Calculate the total time to wait, including any random value.
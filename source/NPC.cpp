@@ -71,7 +71,7 @@ namespace {
 
 // Construct and Load() at the same time.
 NPC::NPC(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	Load(node, playerConditions, visitedSystems, visitedPlanets);
 }
@@ -79,7 +79,7 @@ NPC::NPC(const DataNode &node, const ConditionsStore *playerConditions,
 
 
 void NPC::Load(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	// Any tokens after the "npc" tag list the things that must happen for this
 	// mission to succeed.
@@ -421,6 +421,17 @@ bool NPC::ShouldSpawn() const
 
 
 
+bool NPC::IsSpawningSettled() const
+{
+	if(!checkedSpawnConditions)
+		return false;
+	if(!passedSpawnConditions)
+		return toSpawn.HasStableResult();
+	return toDespawn.IsEmpty() || passedDespawnConditions || toDespawn.HasStableResult();
+}
+
+
+
 const Personality &NPC::GetPersonality() const
 {
 	return personality;
@@ -429,7 +440,7 @@ const Personality &NPC::GetPersonality() const
 
 
 // Get the ships associated with this set of NPCs.
-const list<shared_ptr<Ship>> NPC::Ships() const
+const list<shared_ptr<Ship>> &NPC::Ships() const
 {
 	return ships;
 }
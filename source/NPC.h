@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ExclusiveItem.h"
 #include "Fleet.h"
 #include "FleetCargo.h"
+#include "IndexedSet.h"
 #include "LocationFilter.h"
 #include "NPCAction.h"
 #include "Personality.h"
@@ -77,10 +78,10 @@ public:
 
 	// Construct and Load() at the same time.
 	explicit NPC(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 
 	void Load(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 	// Note: the Save() function can assume this is an instantiated mission, not
 	// a template, so fleets will be replaced by individual ships already.
 	void Save(DataWriter &out) const;
@@ -94,11 +95,14 @@ public:
 	// Update or check spawning and despawning for this NPC.
 	void UpdateSpawning(const PlayerInfo &player);
 	bool ShouldSpawn() const;
+	// Check if the spawn state can only change once a condition has been set,
+	// because the conditions that would be tested next do not use any provided conditions.
+	bool IsSpawningSettled() const;
 
 	// Get the personality that dictates the behavior of the ships associated with this set of NPCs.
 	const Personality &GetPersonality() const;
 	// Get the ships associated with this set of NPCs.
-	const std::list<std::shared_ptr<Ship>> Ships() const;
+	const std::list<std::shared_ptr<Ship>> &Ships() const;
 
 	// Handle the given ShipEvent. Return true if the event target is within this NPC.
 	bool Do(const ShipEvent &event, PlayerInfo &player, UI &ui,
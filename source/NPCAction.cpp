@@ -27,7 +27,7 @@ using namespace std;
 
 // Construct and Load() at the same time.
 NPCAction::NPCAction(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	Load(node, playerConditions, visitedSystems, visitedPlanets);
 }
@@ -35,7 +35,7 @@ NPCAction::NPCAction(const DataNode &node, const ConditionsStore *playerConditio
 
 
 void NPCAction::Load(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	if(node.Size() >= 2)
 		trigger = node.Token(1);
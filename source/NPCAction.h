@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "IndexedSet.h"
 #include "MissionAction.h"
 
 class ConditionsStore;
@@ -38,10 +39,10 @@ public:
 	NPCAction() = default;
 	// Construct and Load() at the same time.
 	explicit NPCAction(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 
 	void Load(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 	// Note: the Save() function can assume this is an instantiated mission, not
 	// a template, so it only has to save a subset of the data.
 	void Save(DataWriter &out) const;
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
 #include "ConditionSet.h"
+#include "IndexedSet.h"
 #include "LocationFilter.h"
 #include "Phrase.h"
 
@@ -35,7 +36,7 @@ class System;
 class News {
 public:
 	void Load(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 
 	// Check whether this news item has anything to say.
 	bool IsEmpty() const;
@@ -214,7 +214,7 @@ namespace {
 void Outfit::Load(const DataNode &node, const ConditionsStore *playerConditions)
 {
 	if(node.Size() >= 2)
-		trueName = node.Token(1);
+		SetTrueName(node.Token(1));
 
 	isDefined = true;
 
@@ -428,6 +428,9 @@ const string &Outfit::TrueName() const
 void Outfit::SetTrueName(const string &name)
 {
 	this->trueName = name;
+	displayNameTranslation = Translation::Handle("outfit.name.", name);
+	pluralNameTranslation = Translation::Handle("outfit.plural.", name);
+	descriptionTranslation = Translation::Handle("outfit.desc.", name);
 }
 
 
@@ -446,23 +449,24 @@ const string &Outfit::PluralName() const
 
 
 
-string Outfit::TranslatedDisplayName() const
+const string &Outfit::TranslatedDisplayName() const
 {
-	return Translation::TrOutfitName(trueName, displayName);
+	return displayNameTranslation.Get(displayName);
 }
 
 
 
-string Outfit::TranslatedPluralName() const
+const string &Outfit::TranslatedPluralName() const
 {
-	return Translation::TrOutfitPluralName(trueName, pluralName);
+	return pluralNameTranslation.Get(pluralName);
 }
 
 
 
 string Outfit::TranslatedDescription() const
 {
-	return Translation::TrOutfitDescription(trueName, description.ToString());
+	const string *translation = descriptionTranslation.Get();
+	return translation ? *translation : description.ToString();
 }
 
 
@@ -532,6 +536,13 @@ double Outfit::Get(const string &attribute) const
 
 
 
+double Outfit::Get(AttributeKey attribute) const
+{
+	return attributes.Get(attribute);
+}
+
+
+
 const Dictionary &Outfit::Attributes() const
 {
 	return attributes;
@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Dictionary.h"
 #include "Paragraphs.h"
+#include "text/Translation.h"
 
 #include <map>
 #include <memory>
@@ -61,9 +62,9 @@ public:
 	const std::string &DisplayName() const;
 	const std::string &PluralName() const;
 	/// Display name in the current language; falls back to DisplayName() if no translation.
-	std::string TranslatedDisplayName() const;
+	const std::string &TranslatedDisplayName() const;
 	/// Plural name in the current language; falls back to PluralName() if no translation.
-	std::string TranslatedPluralName() const;
+	const std::string &TranslatedPluralName() const;
 	/// Description in the current language; falls back to Description() if no translation.
 	std::string TranslatedDescription() const;
 	const std::string &Category() const;
@@ -81,6 +82,7 @@ public:
 
 	double Get(const char *attribute) const;
 	double Get(const std::string &attribute) const;
+	double Get(AttributeKey attribute) const;
 	const Dictionary &Attributes() const;
 
 	// Determine whether the given number of instances of the given outfit can
@@ -142,6 +144,10 @@ private:
 	std::string series;
 	int index = 0;
 	Paragraphs description;
+	// The translations of the names and description, which are keyed by the true name.
+	Translation::Handle displayNameTranslation;
+	Translation::Handle pluralNameTranslation;
+	Translation::Handle descriptionTranslation;
 	const Sprite *thumbnail = nullptr;
 	int64_t cost = 0;
 	double mass = 0.;
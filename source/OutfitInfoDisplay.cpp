@@ -267,7 +267,15 @@ void OutfitInfoDisplay::Update(const Outfit &outfit, const PlayerInfo &player, b
 {
 	UpdateDescription(outfit.TranslatedDescription(), outfit.Licenses(), false);
 	UpdateRequirements(outfit, player, canSell, descriptionCollapsed);
-	UpdateAttributes(outfit);
+	// The attributes table only depends on the outfit and the language, and
+	// the panels that show it update it every frame.
+	int generation = Translation::Generation();
+	if(&outfit != attributesOutfit || generation != attributesGeneration)
+	{
+		UpdateAttributes(outfit);
+		attributesOutfit = &outfit;
+		attributesGeneration = generation;
+	}
 
 	maximumHeight = max(descriptionHeight, max(requirementsHeight, attributesHeight));
 }
@@ -62,4 +62,8 @@ private:
 	std::vector<std::string> requirementValues;
 	std::vector<std::string> requirementTooltipKeys;
 	int requirementsHeight = 0;
+
+	// The outfit and language that the attributes table was made for.
+	const Outfit *attributesOutfit = nullptr;
+	int attributesGeneration = 0;
 };
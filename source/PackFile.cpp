@@ -0,0 +1,313 @@
+/* PackFile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "PackFile.h"
+
+#include "DiskCache.h"
+#include "Files.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+
+using namespace std;
+
+namespace {
+	const string MAGIC = "ESPACK\r\n";
+	constexpr uint32_t VERSION = 1;
+	constexpr size_t HEADER_SIZE = 24;
+	constexpr size_t RECORD_SIZE = 32;
+	// Each file starts on a cache line.
+	constexpr uint64_t ALIGNMENT = 64;
+
+	// The directories of a source that are packed, in addition to the files
+	// directly inside it.
+	const set<string> ASSET_DIRECTORIES = {"data", "images", "shaders", "sounds"};
+
+	uint64_t ReadNumber(const char *data, size_t bytes)
+	{
+		uint64_t value = 0;
+		for(size_t i = 0; i < bytes; ++i)
+			value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+		return value;
+	}
+
+	void WriteNumber(string &out, uint64_t value, size_t bytes)
+	{
+		for(size_t i = 0; i < bytes; ++i)
+			out += static_cast<char>((value >> (8 * i)) & 0xFF);
+	}
+}
+
+
+
+PackFile::PackFile(const filesystem::path &packPath)
+	: basePath(packPath), file(packPath)
+{
+	const char *data = file.Data();
+	const uint64_t size = file.Size();
+	if(size < HEADER_SIZE || string_view(data, MAGIC.size()) != MAGIC)
+	{
+		Logger::Log("\"" + packPath.string() + "\" is not a pack file.", Logger::Level::ERROR);
+		return;
+	}
+	if(ReadNumber(data + 8, 4) != VERSION)
+	{
+		Logger::Log("\"" + packPath.string() + "\" was made for a different version of the game.",
+			Logger::Level::ERROR);
+		return;
+	}
+	const uint64_t count = ReadNumber(data + 12, 4);
+	const uint64_t indexOffset = ReadNumber(data + 16, 8);
+	if(indexOffset > size || count > (size - indexOffset) / RECORD_SIZE)
+	{
+		Logger::Log("The index of \"" + packPath.string() + "\" is damaged.", Logger::Level::ERROR);
+		return;
+	}
+
+	const char *record = data + indexOffset;
+	const uint64_t namesOffset = indexOffset + count * RECORD_SIZE;
+	entries.reserve(count);
+	for(uint64_t i = 0; i < count; ++i, record += RECORD_SIZE)
+	{
+		Entry entry;
+		entry.hash = ReadNumber(record, 8);
+		entry.offset = ReadNumber(record + 8, 8);
+		entry.size = ReadNumber(record + 16, 8);
+		const uint64_t nameOffset = namesOffset + ReadNumber(record + 24, 4);
+		const uint64_t nameLength = ReadNumber(record + 28, 4);
+		if(entry.offset > size || entry.size > size - entry.offset
+				|| nameOffset > size || nameLength > size - nameOffset)
+		{
+			Logger::Log("The index of \"" + packPath.string() + "\" is damaged.", Logger::Level::ERROR);
+			entries.clear();
+			return;
+		}
+		entry.name = string_view(data + nameOffset, nameLength);
+		entries.push_back(entry);
+	}
+}
+
+
+
+shared_ptr<const PackFile> PackFile::Get(const filesystem::path &filePath)
+{
+	// Most paths are not in a pack, and that can be told without touching the
+	// file system.
+	if(none_of(filePath.begin(), filePath.end(),
+			[](const filesystem::path &part) { return part.extension() == ".pack"; }))
+		return {};
+
+	static mutex openMutex;
+	static map<filesystem::path, shared_ptr<const PackFile>> openPacks;
+	lock_guard<mutex> lock(openMutex);
+	for(const auto &[packPath, pack] : openPacks)
+		if(Files::IsParent(packPath, filePath))
+			return pack;
+
+	filesystem::path packPath = filePath;
+	while(!exists(packPath))
+	{
+		if(!packPath.has_parent_path() || packPath.parent_path() == packPath)
+			return {};
+		packPath = packPath.parent_path();
+	}
+	if(packPath.extension() == ".pack" && is_regular_file(packPath))
+		return openPacks.emplace(packPath, make_shared<const PackFile>(packPath)).first->second;
+	return {};
+}
+
+
+
+bool PackFile::Build(const filesystem::path &directory, const filesystem::path &packPath)
+{
+	if(!is_directory(directory))
+	{
+		Logger::Log("\"" + directory.string() + "\" is not a directory.", Logger::Level::ERROR);
+		return false;
+	}
+
+	// Collect the files to pack, by their path within the pack.
+	vector<pair<string, filesystem::path>> files;
+	for(const auto &entry : filesystem::directory_iterator(directory))
+	{
+		const filesystem::path &path = entry.path();
+		if(entry.is_directory() && ASSET_DIRECTORIES.contains(path.filename().string()))
+		{
+			for(const auto &child : filesystem::recursive_directory_iterator(path))
+				if(child.is_regular_file())
+					files.emplace_back(child.path().lexically_relative(directory).generic_string(), child.path());
+		}
+		else if(entry.is_regular_file() && (path.extension() == ".txt" || path.extension() == ".png"))
+			files.emplace_back(path.filename().string(), path);
+	}
+
+	vector<tuple<uint64_t, string, filesystem::path>> sorted;
+	sorted.reserve(files.size());
+	for(auto &[name, path] : files)
+		sorted.emplace_back(DiskCache::Hash(name), std::move(name), std::move(path));
+	sort(sorted.begin(), sorted.end());
+
+	ofstream out(packPath, ios::out | ios::binary | ios::trunc);
+	if(!out)
+	{
+		Logger::Log("Unable to write \"" + packPath.string() + "\".", Logger::Level::ERROR);
+		return false;
+	}
+	out.write(string(HEADER_SIZE, '\0').data(), HEADER_SIZE);
+
+	// Write each file's contents, and its record in the index.
+	string records;
+	string names;
+	uint64_t offset = HEADER_SIZE;
+	for(const auto &[hash, name, path] : sorted)
+	{
+		const uint64_t padding = (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT;
+		out.write(string(padding, '\0').data(), padding);
+		offset += padding;
+
+		const string contents = Files::Read(path);
+		out.write(contents.data(), contents.size());
+
+		WriteNumber(records, hash, 8);
+		WriteNumber(records, offset, 8);
+		WriteNumber(records, contents.size(), 8);
+		WriteNumber(records, names.size(), 4);
+		WriteNumber(records, name.size(), 4);
+		names += name;
+		offset += contents.size();
+	}
+	out.write(records.data(), records.size());
+	out.write(names.data(), names.size());
+
+	string header = MAGIC;
+	WriteNumber(header, VERSION, 4);
+	WriteNumber(header, sorted.size(), 4);
+	WriteNumber(header, offset, 8);
+	out.seekp(0);
+	out.write(header.data(), header.size());
+	if(!out)
+	{
+		Logger::Log("Unable to write \"" + packPath.string() + "\".", Logger::Level::ERROR);
+		return false;
+	}
+
+	Logger::Log("Packed " + to_string(sorted.size()) + " files into \"" + packPath.string() + "\".",
+		Logger::Level::INFO);
+	return true;
+}
+
+
+
+vector<filesystem::path> PackFile::ListFiles(const filesystem::path &directory, bool recursive,
+	bool directories) const
+{
+	string prefix = GetPathInPack(directory);
+	if(!prefix.empty() && prefix.back() != '/')
+		prefix += '/';
+
+	// A directory only exists as a part of the paths of the files inside it.
+	set<string> found;
+	for(const Entry &entry : entries)
+	{
+		if(!entry.name.starts_with(prefix))
+			continue;
+		const string_view rest = entry.name.substr(prefix.size());
+		const size_t slash = rest.find('/');
+		if(!directories)
+		{
+			if(recursive || slash == string_view::npos)
+				found.emplace(entry.name);
+		}
+		else if(slash != string_view::npos)
+		{
+			if(recursive)
+				for(size_t end = slash; end != string_view::npos; end = rest.find('/', end + 1))
+					found.emplace(prefix + string(rest.substr(0, end)));
+			else
+				found.emplace(prefix + string(rest.substr(0, slash)));
+		}
+	}
+
+	vector<filesystem::path> list;
+	list.reserve(found.size());
+	for(const string &name : found)
+		list.push_back(basePath / name);
+	return list;
+}
+
+
+
+bool PackFile::Exists(const filesystem::path &filePath) const
+{
+	const string name = GetPathInPack(filePath);
+	if(name.empty() || Find(name))
+		return true;
+
+	const string prefix = name + '/';
+	return any_of(entries.begin(), entries.end(),
+		[&prefix](const Entry &entry) { return entry.name.starts_with(prefix); });
+}
+
+
+
+bool PackFile::View(const filesystem::path &filePath, string_view &contents) const
+{
+	const Entry *entry = Find(GetPathInPack(filePath));
+	if(!entry)
+		return false;
+
+	contents = string_view(file.Data() + entry->offset, entry->size);
+	return true;
+}
+
+
+
+string PackFile::ReadFile(const filesystem::path &filePath) const
+{
+	string_view contents;
+	return View(filePath, contents) ? string(contents) : string();
+}
+
+
+
+string PackFile::GetPathInPack(const filesystem::path &path) const
+{
+	string name = path.lexically_relative(basePath).generic_string();
+	if(name == ".")
+		name.clear();
+	while(!name.empty() && name.back() == '/')
+		name.pop_back();
+	return name;
+}
+
+
+
+const PackFile::Entry *PackFile::Find(const string &name) const
+{
+	const uint64_t hash = DiskCache::Hash(name);
+	auto it = lower_bound(entries.begin(), entries.end(), make_pair(hash, string_view(name)),
+		[](const Entry &entry, const pair<uint64_t, string_view> &key)
+		{
+			return entry.hash < key.first || (entry.hash == key.first && entry.name < key.second);
+		});
+	if(it == entries.end() || it->hash != hash || it->name != name)
+		return nullptr;
+	return &*it;
+}
@@ -0,0 +1,88 @@
+/* PackFile.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+// A single ".pack" file holding the resources of the game or of a plugin, so
+// that loading them only has to open one file instead of thousands. The pack is
+// memory-mapped, and its files are read in place, so unlike a zip it can be read
+// from any number of threads at once.
+//
+// A pack begins with a header: the magic "ESPACK\r\n", the format version and
+// the number of files (32 bits each), and the offset of the index (64 bits).
+// The contents of the files follow, each starting on a 64-byte boundary. The
+// index is a table of fixed-size records, sorted by the hash of each file's
+// path and then by the path, so that a file can be found with a binary search,
+// followed by the paths themselves. All numbers are little-endian.
+class PackFile {
+public:
+	explicit PackFile(const std::filesystem::path &packPath);
+	PackFile(const PackFile &) = delete;
+	PackFile &operator=(const PackFile &) = delete;
+
+	// Get the pack that contains the given path, if there is one. Each pack is
+	// only opened once, and stays open until the game quits.
+	static std::shared_ptr<const PackFile> Get(const std::filesystem::path &filePath);
+	// Pack the resources in the given directory (its data, images, shaders and
+	// sounds, and the text and image files beside them) into a single file.
+	static bool Build(const std::filesystem::path &directory, const std::filesystem::path &packPath);
+
+	// Lists the files or the directories in a directory inside the pack.
+	// @param directory The complete file path, including the pack's path.
+	std::vector<std::filesystem::path> ListFiles(const std::filesystem::path &directory, bool recursive,
+		bool directories) const;
+	// Checks whether the given file or directory exists in the pack.
+	bool Exists(const std::filesystem::path &filePath) const;
+	// Get a view of the given file's contents, which is valid for as long as
+	// the pack is. Returns false if the pack does not contain the file.
+	bool View(const std::filesystem::path &filePath, std::string_view &contents) const;
+	std::string ReadFile(const std::filesystem::path &filePath) const;
+
+
+private:
+	class Entry {
+	public:
+		uint64_t hash;
+		uint64_t offset;
+		uint64_t size;
+		std::string_view name;
+	};
+
+
+private:
+	// Translates a global filesystem path to a relative path within the pack.
+	std::string GetPathInPack(const std::filesystem::path &path) const;
+	const Entry *Find(const std::string &name) const;
+
+
+private:
+	std::filesystem::path basePath;
+	MappedFile file;
+	// The index of the pack, sorted by hash and then by name. The names point
+	// into the mapped file.
+	std::vector<Entry> entries;
+};
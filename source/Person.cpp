@@ -27,7 +27,7 @@ using namespace std;
 
 
 void Person::Load(const DataNode &node, const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	isLoaded = true;
 	for(const DataNode &child : node)
@@ -97,10 +97,24 @@ int Person::Frequency(const System *system) const
 {
 	// Because persons always enter a system via one of the regular hyperspace
 	// links, don't create them in systems with no links.
-	if(!system || IsDestroyed() || IsPlaced() || system->Links().empty())
+	if(IsDestroyed() || IsPlaced())
 		return 0;
 
-	return (location.IsEmpty() || location.Matches(system)) ? frequency : 0;
+	return CanAppearIn(system) ? frequency : 0;
+}
+
+
+
+// Check whether this person may ever appear in the given system, whether
+// or not it is dead or already active.
+bool Person::CanAppearIn(const System *system) const
+{
+	// Because persons always enter a system via one of the regular hyperspace
+	// links, don't create them in systems with no links.
+	if(!system || system->Links().empty())
+		return false;
+
+	return location.IsEmpty() || location.Matches(system);
 }
 
 
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "IndexedSet.h"
 #include "LocationFilter.h"
 #include "Personality.h"
 #include "Phrase.h"
@@ -35,7 +36,7 @@ class System;
 class Person {
 public:
 	void Load(const DataNode &node, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 	// Finish loading all the ships in this person specification.
 	void FinishLoading();
 	bool IsLoaded() const;
@@ -45,6 +46,9 @@ public:
 	// Find out how often this person should appear in the given system. If this
 	// person is dead or already active, this will return zero.
 	int Frequency(const System *system) const;
+	// Check whether this person may ever appear in the given system, whether
+	// or not it is dead or already active.
+	bool CanAppearIn(const System *system) const;
 
 	// Get the person's characteristics. The ship object is persistent, i.e. it
 	// will be recycled every time this person appears.
@@ -17,11 +17,26 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DataNode.h"
 #include "text/Translation.h"
-#include "text/Format.h"
 #include "GameData.h"
 
 using namespace std;
 
+namespace {
+	// Replace each occurrence of the target in the text after the given
+	// position, without building a new string.
+	void ReplaceAfter(string &text, size_t start, const string &target, const string &replacement)
+	{
+		if(target.empty())
+			return;
+
+		for(size_t pos = text.find(target, start); pos != string::npos; pos = text.find(target, pos))
+		{
+			text.replace(pos, target.length(), replacement);
+			pos += replacement.length();
+		}
+	}
+}
+
 
 
 // Replace all occurrences ${phrase name} with the expanded phrase from GameData::Phrases()
@@ -42,7 +57,10 @@ string Phrase::ExpandPhrases(const string &source)
 		++next;
 		string phraseName = string{source, var + 2, next - var - 3};
 		const Phrase *phrase = GameData::Phrases().Find(phraseName);
-		result.append(phrase ? phrase->Get() : phraseName);
+		if(phrase)
+			phrase->AppendTo(result);
+		else
+			result.append(phraseName);
 	}
 	// Optimization for most common case: no phrase in string:
 	if(!next)
@@ -73,6 +91,7 @@ void Phrase::Load(const DataNode &node)
 		return;
 	}
 
+	translation = Translation::Handle("phrase.", name);
 	sentences.emplace_back(node, this);
 	if(sentences.back().empty())
 	{
@@ -103,23 +122,44 @@ const string &Phrase::Name() const
 string Phrase::Get() const
 {
 	string result;
+	AppendTo(result);
+	return result;
+}
+
+
+
+// Expand this phrase onto the end of the given text. Every subphrase writes
+// into the same string, rather than each returning a string of its own.
+void Phrase::AppendTo(string &result) const
+{
 	if(sentences.empty())
-		return result;
+		return;
 
+	// A translated phrase replaces everything that it would have expanded to.
+	if(const string *translated = translation.Get())
+	{
+		result += *translated;
+		return;
+	}
+
+	const size_t start = result.length();
 	for(const auto &part : sentences[Random::Int(sentences.size())])
 	{
 		if(!part.choices.empty())
 		{
 			const auto &choice = part.choices.Get();
 			for(const auto &element : choice)
-				result += element.second ? element.second->Get() : element.first;
+			{
+				if(element.second)
+					element.second->AppendTo(result);
+				else
+					result += element.first;
+			}
 		}
 		else if(!part.replacements.empty())
 			for(const auto &pair : part.replacements)
-				Format::ReplaceAll(result, pair.first, pair.second);
+				ReplaceAfter(result, start, pair.first, pair.second);
 	}
-
-	return Translation::TrPhrase(name, result);
 }
 
 
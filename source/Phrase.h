@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "text/Translation.h"
 #include "WeightedList.h"
 
 #include <functional>
@@ -48,6 +49,8 @@ public:
 
 
 private:
+	// Expand this phrase onto the end of the given text.
+	void AppendTo(std::string &result) const;
 	bool ReferencesPhrase(const Phrase *phrase) const;
 
 
@@ -93,6 +96,8 @@ private:
 
 private:
 	std::string name;
+	// The translation of the whole phrase, which takes the place of its own text.
+	Translation::Handle translation;
 	// Each time this phrase is defined, a new sentence is created.
 	std::vector<Sentence> sentences;
 };
@@ -37,6 +37,9 @@ namespace {
 	const string WORMHOLE = "wormhole";
 	const string PLANET = "planet";
 
+	// The number that the next planet to be indexed will get.
+	int nextIndex = 0;
+
 	// Planet attributes in the form "requires: <attribute>" restrict the ability of ships to land
 	// unless the ship has all required attributes.
 	void SetRequiredAttributes(const set<string> &attributes, set<string> &required)
@@ -59,6 +62,8 @@ void Planet::Load(const DataNode &node, Set<Wormhole> &wormholes, const Conditio
 	if(node.Size() < 2)
 		return;
 	trueName = node.Token(1);
+	descriptionTranslation = Translation::Handle("planet.desc.", trueName);
+	spaceportDescriptionTranslation = Translation::Handle("planet.spaceport.", trueName);
 	// The planet's name is needed to save references to this object, so a
 	// flag is used to test whether Load() was called at least once for it.
 	isDefined = true;
@@ -416,6 +421,21 @@ bool Planet::IsValid() const
 
 
 
+void Planet::AssignIndex()
+{
+	if(index < 0)
+		index = nextIndex++;
+}
+
+
+
+int Planet::Index() const
+{
+	return index;
+}
+
+
+
 // Get the name used for this planet in the data files.
 const string &Planet::TrueName() const
 {
@@ -429,6 +449,8 @@ void Planet::SetTrueName(const string &name)
 	trueName = name;
 	if(displayName.empty())
 		displayName = trueName;
+	descriptionTranslation = Translation::Handle("planet.desc.", name);
+	spaceportDescriptionTranslation = Translation::Handle("planet.spaceport.", name);
 }
 
 
@@ -449,6 +471,22 @@ const Paragraphs &Planet::Description() const
 
 
 
+string Planet::TranslatedDescription() const
+{
+	const string *translation = descriptionTranslation.Get();
+	return translation ? *translation : description.ToString();
+}
+
+
+
+string Planet::TranslatedSpaceportDescription() const
+{
+	const string *translation = spaceportDescriptionTranslation.Get();
+	return translation ? *translation : port.Description().ToString();
+}
+
+
+
 // Get the landscape sprite.
 const Sprite *Planet::Landscape() const
 {
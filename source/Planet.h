@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Port.h"
 #include "Sale.h"
 #include "Shop.h"
+#include "text/Translation.h"
 
 #include <list>
 #include <memory>
@@ -63,6 +64,12 @@ public:
 	// Check if both this planet and its containing system(s) have been defined.
 	bool IsValid() const;
 
+	// Give this planet a number from 0 up, unless it already has one, so that
+	// data about each planet can be kept in an array instead of a map.
+	void AssignIndex();
+	// Get this planet's number, or -1 if it has not been given one.
+	int Index() const;
+
 	// Get the name used for this planet in the data files.
 	// When saving missions or writing the player's save, the true name
 	// associated with this planet is used even if the planet was not fully
@@ -73,6 +80,9 @@ public:
 	const std::string &DisplayName() const;
 	// Return the description text for the planet, but not the spaceport:
 	const Paragraphs &Description() const;
+	// Get the description of the planet or of its spaceport in the current language.
+	std::string TranslatedDescription() const;
+	std::string TranslatedSpaceportDescription() const;
 	// Get the landscape sprite.
 	const Sprite *Landscape() const;
 	// Get the name of the ambient audio to play on this planet.
@@ -178,6 +188,9 @@ private:
 	std::string trueName;
 	std::string displayName;
 	Paragraphs description;
+	// The translations of the descriptions, which are keyed by the true name.
+	Translation::Handle descriptionTranslation;
+	Translation::Handle spaceportDescriptionTranslation;
 	Port port;
 	const Sprite *landscape = nullptr;
 	std::string music;
@@ -230,4 +243,6 @@ private:
 
 	Wormhole *wormhole = nullptr;
 	std::vector<const System *> systems;
+
+	int index = -1;
 };
@@ -16,7 +16,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PlanetLabel.h"
 
 #include "Angle.h"
-#include "text/Translation.h"
 #include "text/Font.h"
 #include "text/FontSet.h"
 #include "Government.h"
@@ -33,6 +32,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
+#include <map>
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -46,6 +47,21 @@ namespace {
 	constexpr double GAP = 6.;
 	constexpr double MIN_DISTANCE = 30.;
 	constexpr double BORDER = 2.;
+	// How many label placements to remember before starting over.
+	constexpr size_t MAX_CACHED_PLACEMENTS = 1000;
+
+	// The angles that were chosen for labels before. Each label's angle depends
+	// only on its size and on where everything else in the system is, so the key
+	// holds all of those. This saves searching for a place again when
+	// returning to a system, or when only the language or a name has changed
+	// back and forth.
+	map<pair<const StellarObject *, vector<double>>, double> placements;
+
+	void Append(vector<double> &key, const Point &point)
+	{
+		key.push_back(point.X());
+		key.push_back(point.Y());
+	}
 
 	// Find the intersection of a ray and a rectangle, both centered on the origin.
 	Point GetOffset(const Point &unit, const Point &dimensions)
@@ -145,7 +161,7 @@ void PlanetLabel::UpdateData(const vector<PlanetLabel> &labels, const System &sy
 		color = *planet.GetWormhole()->GetLinkColor();
 	else if(planet.GetGovernment())
 	{
-		string newGovernment = "(" + Translation::TrGovernment(planet.GetGovernment()->DisplayName()) + ")";
+		string newGovernment = "(" + planet.GetGovernment()->TranslatedDisplayName() + ")";
 		if(newGovernment != government)
 			reposition = true;
 		government = newGovernment;
@@ -172,28 +188,57 @@ void PlanetLabel::UpdateData(const vector<PlanetLabel> &labels, const System &sy
 	const double labelHeight = nameHeight + (government.empty() ? 0. : 1. + font.Height());
 	const Point labelDimensions = {labelWidth + BORDER * 2., labelHeight + BORDER * 2.};
 
-	// Try to find a label direction that is not overlapping under any zoom.
+	// Check whether this label has been placed with the same surroundings before.
 	const vector<double> &allZooms = Preferences::Zooms();
-	for(const double angle : LINE_ANGLES)
+	vector<double> key = allZooms;
+	Append(key, labelDimensions);
+	key.push_back(innerAngle);
+	for(const PlanetLabel &label : labels)
 	{
-		SetBoundingBox(labelDimensions, angle);
-		if(none_of(allZooms.begin(), allZooms.end(),
-				[&](const double zoom)
-				{
-					return HasOverlaps(labels, system, *object, zoom);
-				}))
-		{
-			innerAngle = angle;
-			break;
-		}
+		Append(key, label.box.Center());
+		Append(key, label.box.Dimensions());
+		Append(key, label.zoomOffset);
 	}
-
-	// No non-overlapping choices, so set this to the default.
-	if(innerAngle < 0.)
+	for(const StellarObject &other : system.Objects())
+	{
+		Append(key, other.Position());
+		key.push_back(other.Radius());
+	}
+	auto placement = make_pair(object, std::move(key));
+	auto it = placements.find(placement);
+	if(it != placements.end())
 	{
-		innerAngle = LINE_ANGLES[0];
+		innerAngle = it->second;
 		SetBoundingBox(labelDimensions, innerAngle);
 	}
+	else
+	{
+		// Try to find a label direction that is not overlapping under any zoom.
+		for(const double angle : LINE_ANGLES)
+		{
+			SetBoundingBox(labelDimensions, angle);
+			if(none_of(allZooms.begin(), allZooms.end(),
+					[&](const double zoom)
+					{
+						return HasOverlaps(labels, system, *object, zoom);
+					}))
+			{
+				innerAngle = angle;
+				break;
+			}
+		}
+
+		// No non-overlapping choices, so set this to the default.
+		if(innerAngle < 0.)
+		{
+			innerAngle = LINE_ANGLES[0];
+			SetBoundingBox(labelDimensions, innerAngle);
+		}
+
+		if(placements.size() >= MAX_CACHED_PLACEMENTS)
+			placements.clear();
+		placements.emplace(std::move(placement), innerAngle);
+	}
 
 	// Cache the offsets for both labels; center labels.
 	const Point offset = GetOffset(Angle(innerAngle).Unit(), labelDimensions) - labelDimensions * .5;
@@ -70,7 +70,7 @@ PlanetPanel::PlanetPanel(PlayerInfo &player, function<void()> callback)
 	description->SetFont(FontSet::Get(14));
 	description->SetColor(*GameData::Colors().Get("bright"));
 	description->SetAlignment(Alignment::JUSTIFIED);
-	description->SetText(Translation::TrPlanetDescription(planet.TrueName(), planet.Description().ToString()));
+	description->SetText(planet.TranslatedDescription());
 	AddChild(description);
 
 	// Since the loading of landscape images is deferred, make sure that the
@@ -246,7 +246,7 @@ void PlanetPanel::Draw()
 	if(!selectedPanel)
 	{
 		description->SetFont(FontSet::Get(14));
-		description->SetText(Translation::TrPlanetDescription(planet.TrueName(), planet.Description().ToString()));
+		description->SetText(planet.TranslatedDescription());
 	}
 }
 
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PlayerInfo.h"
 
 #include "AI.h"
+#include "BinaryDataFile.h"
 #include "text/Translation.h"
 #include "audio/Audio.h"
 #include "ConversationPanel.h"
@@ -29,6 +30,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameData.h"
 #include "Gamerules.h"
 #include "Government.h"
+#include "JumpTable.h"
 #include "Logger.h"
 #include "Messages.h"
 #include "Outfit.h"
@@ -40,13 +42,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Preferences.h"
 #include "RaidFleet.h"
 #include "Random.h"
-#include "SavedGame.h"
 #include "Ship.h"
 #include "ShipEvent.h"
+#include "image/Sprite.h"
 #include "image/SpriteLoadManager.h"
 #include "StartConditions.h"
 #include "StellarObject.h"
 #include "System.h"
+#include "TaskQueue.h"
 #include "UI.h"
 #include "Weapon.h"
 
@@ -56,6 +59,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <cstring>
 #include <ctime>
 #include <functional>
+#include <future>
 #include <iterator>
 #include <limits>
 #include <sstream>
@@ -64,6 +68,67 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	// Saved games are written to disk in the background, one at a time and in
+	// the order in which they were saved.
+	TaskQueue &SaveQueue()
+	{
+		static TaskQueue queue;
+		return queue;
+	}
+	shared_future<void> lastSave;
+
+	// Queue the writing of a save, to start once the previous save has been written.
+	void QueueSave(function<void()> write)
+	{
+		lastSave = SaveQueue().Run([previous = lastSave, write = std::move(write)]() -> void
+		{
+			if(previous.valid())
+				previous.wait();
+			write();
+		});
+	}
+
+	// Get what to write to a saved game file, given its text.
+	string SaveContents(const string &text, bool isCompact)
+	{
+		return isCompact ? BinaryDataFile::Encode(text) : text;
+	}
+
+	// Write a whole file under a temporary name, then move it into place, so
+	// that an interrupted save never leaves a partly written file behind.
+	void WriteReplacing(const filesystem::path &path, const string &contents)
+	{
+		filesystem::path temporary = path;
+		temporary += ".tmp";
+		Files::Write(temporary, contents);
+		Files::Move(temporary, path);
+	}
+
+	// Files that most saves leave unchanged, and what was last written to each of
+	// them. Only the save tasks use these, and they run one at a time.
+	string writtenRecent;
+	string writtenGlobalConditions;
+
+	// Write the given file only if its contents have changed since the last save.
+	void WriteIfChanged(const filesystem::path &path, const string &contents, string &written)
+	{
+		if(written == contents && Files::Exists(path))
+			return;
+		WriteReplacing(path, contents);
+		written = contents;
+	}
+
+	// Read the date of a saved game. Unlike a SavedGame, this only reads the
+	// file, so it is safe to do while saving in the background.
+	Date SavedDate(const filesystem::path &path)
+	{
+		DataFile file(path);
+		for(const DataNode &node : file)
+			if(node.Token(0) == "date" && node.Size() >= 4)
+				return Date(node.Value(1), node.Value(2), node.Value(3));
+		return Date();
+	}
+
 	// Move the flagship to the start of your list of ships. It does not make sense
 	// that the flagship would change if you are reunited with a different ship that
 	// was higher up the list.
@@ -212,7 +277,8 @@ void PlayerInfo::Clear()
 {
 	*this = PlayerInfo();
 
-	Random::Seed(time(nullptr));
+	// A benchmark needs every run to simulate exactly the same thing.
+	Random::Seed(Random::IsDeterministic() ? 0 : time(nullptr));
 	GameData::Revert();
 	Messages::Reset();
 }
@@ -275,6 +341,18 @@ void PlayerInfo::New(const StartConditions &start, const Gamerules &gamerules)
 // Load player information from a saved game file.
 void PlayerInfo::Load(const filesystem::path &path)
 {
+	// The file may still be being written.
+	FinishSaving();
+	Load(path, DataFile(path));
+}
+
+
+
+void PlayerInfo::Load(const filesystem::path &path, const DataFile &file)
+{
+	// Make sure that the previous pilot is done being saved.
+	FinishSaving();
+
 	// Make sure any previously loaded data is cleared.
 	Clear();
 
@@ -300,7 +378,6 @@ void PlayerInfo::Load(const filesystem::path &path)
 	// Register derived conditions now, so old primary versions can load into them.
 	RegisterDerivedConditions();
 
-	DataFile file(path);
 	for(const DataNode &child : file)
 	{
 		const string &key = child.Token(0);
@@ -580,6 +657,7 @@ void PlayerInfo::Reload()
 // Load the most recently saved player (if any). Returns false when no save was loaded.
 bool PlayerInfo::LoadRecent()
 {
+	FinishSaving();
 	string recentPath = Files::Read(Files::Config() / "recent.txt");
 	// Trim trailing whitespace (including newlines) from the path.
 	while(!recentPath.empty() && recentPath.back() <= ' ')
@@ -604,36 +682,68 @@ void PlayerInfo::Save() const
 	if(!CanBeSaved())
 		return;
 
-	// Remember that this was the most recently saved player.
-	Files::Write(Files::Config() / "recent.txt", filePath + '\n');
-
-	if(filePath.rfind(".txt") == filePath.length() - 4)
+	// Take a snapshot of everything that is saved. Only the file operations are
+	// left for the background task, so the game can change in the meantime.
+	DataWriter globalConditions;
+	GameData::GlobalConditions().Save(globalConditions);
+	QueueSave([path = filePath, text = SaveToString(), globalConditions = globalConditions.SaveToString(),
+		date = date, hasServices = planet && planet->HasServices(), entry = IndexEntry(),
+		isCompact = Preferences::Has("Compact save files")]() -> void
 	{
-		// Only update the backups if this save will have a newer date.
-		SavedGame saved(filePath);
-		if(saved.GetDate() != date.ToString())
+		const string contents = SaveContents(text, isCompact);
+
+		// Remember that this was the most recently saved player.
+		WriteIfChanged(Files::Config() / "recent.txt", path + '\n', writtenRecent);
+
+		// Write the new save in full before the old one is moved to the backups.
+		filesystem::path temporary = path;
+		temporary += ".tmp";
+		Files::Write(temporary, contents);
+
+		if(path.rfind(".txt") == path.length() - 4)
 		{
-			string root = filePath.substr(0, filePath.length() - 4);
-			const int previousCount = Preferences::GetPreviousSaveCount();
-			const string rootPrevious = root + "~~previous-";
-			for(int i = previousCount - 1; i > 0; --i)
+			// Only update the backups if this save will have a newer date.
+			if(SavedDate(path) != date)
 			{
-				const string toMove = rootPrevious + to_string(i) + ".txt";
-				if(Files::Exists(toMove))
-					Files::Move(toMove, rootPrevious + to_string(i + 1) + ".txt");
+				string root = path.substr(0, path.length() - 4);
+				const int previousCount = Preferences::GetPreviousSaveCount();
+				const string rootPrevious = root + "~~previous-";
+				for(int i = previousCount - 1; i > 0; --i)
+				{
+					const string toMove = rootPrevious + to_string(i) + ".txt";
+					if(Files::Exists(toMove))
+					{
+						Files::Move(toMove, rootPrevious + to_string(i + 1) + ".txt");
+						SaveIndex::Move(toMove, rootPrevious + to_string(i + 1) + ".txt");
+					}
+				}
+				if(Files::Exists(path))
+				{
+					Files::Move(path, rootPrevious + "1.txt");
+					SaveIndex::Move(path, rootPrevious + "1.txt");
+				}
+				if(hasServices)
+				{
+					// The backup has the same contents as the new save, so share them.
+					if(!Files::Link(temporary, rootPrevious + "spaceport.txt"))
+						WriteReplacing(rootPrevious + "spaceport.txt", contents);
+					SaveIndex::Update(rootPrevious + "spaceport.txt", entry);
+				}
 			}
-			if(Files::Exists(filePath))
-				Files::Move(filePath, rootPrevious + "1.txt");
-			if(planet->HasServices())
-				Save(rootPrevious + "spaceport.txt");
 		}
-	}
 
-	Save(filePath);
+		Files::Move(temporary, path);
+		SaveIndex::Update(path, entry);
+		WriteIfChanged(Files::Config() / "global conditions.txt", globalConditions, writtenGlobalConditions);
+	});
+}
 
-	// Save global conditions:
-	DataWriter globalConditions(Files::Config() / "global conditions.txt");
-	GameData::GlobalConditions().Save(globalConditions);
+
+
+void PlayerInfo::FinishSaving()
+{
+	if(lastSave.valid())
+		lastSave.wait();
 }
 
 
@@ -1464,6 +1574,15 @@ pair<double, double> PlayerInfo::RaidFleetFactors() const
 
 
 double PlayerInfo::RaidFleetAttraction(const RaidFleet &raid, const System *system) const
+{
+	return RaidFleetAttraction(raid, system, RaidFleetFactors());
+}
+
+
+
+// The same, given factors from RaidFleetFactors(), so that checking many raid
+// fleets does not add up the player's whole fleet again for each of them.
+double PlayerInfo::RaidFleetAttraction(const RaidFleet &raid, const System *system, const pair<double, double> &factors)
 {
 	double attraction = 0.;
 	const Fleet *raidFleet = raid.GetFleet();
@@ -1472,7 +1591,6 @@ double PlayerInfo::RaidFleetAttraction(const RaidFleet &raid, const System *syst
 	{
 		// The player's base attraction to a fleet is determined by their fleet attraction minus
 		// their fleet deterrence, minus whatever the minimum attraction of this raid fleet is.
-		pair<double, double> factors = RaidFleetFactors();
 		// If there is a maximum attraction for this fleet, and we are above it, it will not spawn.
 		if(raid.MaxAttraction() > 0 && factors.first > raid.MaxAttraction())
 			return 0;
@@ -2126,7 +2244,14 @@ bool PlayerInfo::HasAvailableInflightMissions() const
 void PlayerInfo::CacheMissionInformation(bool onlyDeadlines)
 {
 	remainingDeadlines.clear();
-	DistanceMap here(*this, system);
+	// This is done every day, so only search for routes to every system when
+	// there is a deadline whose remaining travel time must be estimated.
+	const bool hasDeadline = any_of(missions.begin(), missions.end(),
+		[](const Mission &mission) -> bool { return static_cast<bool>(mission.Deadline()); });
+	if(onlyDeadlines && !hasDeadline)
+		return;
+	const bool needsRoutes = hasDeadline && Preferences::Has("Deadline blink by distance");
+	const DistanceMap here = needsRoutes ? DistanceMap(*this, system) : DistanceMap(nullptr);
 	for(Mission &mission : missions)
 		CacheMissionInformation(mission, here, onlyDeadlines);
 }
@@ -2277,22 +2402,43 @@ void PlayerInfo::SortAvailable()
 			}
 		}
 	}
-	availableJobs.sort([&](const Mission &lhs, const Mission &rhs) {
+	// Checking whether a mission can be accepted means testing its conditions,
+	// so find out everything the order depends on once for each mission rather
+	// than in every comparison.
+	struct SortKey {
+		list<Mission>::iterator mission;
+		bool hasDeadline;
+		bool canAccept;
+		int convenience;
+		int jumps;
+		int64_t payment;
+	};
+	vector<SortKey> keys;
+	keys.reserve(availableJobs.size());
+	for(auto it = availableJobs.begin(); it != availableJobs.end(); ++it)
+	{
+		// 0 : No convenient mission; 1: same system; 2: same planet (because both system+planet means 1+1 = 2)
+		const int convenience = destinations.empty() ? 0
+			: destinations.count(it->Destination()) + destinations.count(it->Destination()->GetSystem());
+		keys.push_back({it, static_cast<bool>(it->Deadline()), sortSeparatePossible && it->CanAccept(*this),
+			convenience, it->ExpectedJumps(), it->DisplayedPayment()});
+	}
+	sort(keys.begin(), keys.end(), [&](const SortKey &lhs, const SortKey &rhs) {
 		// First, separate rush orders with deadlines, if wanted
 		if(sortSeparateDeadline)
 		{
 			// availableSortAsc instead of true, to counter the reverse below
-			if(!lhs.Deadline() && rhs.Deadline())
+			if(!lhs.hasDeadline && rhs.hasDeadline)
 				return availableSortAsc;
-			if(lhs.Deadline() && !rhs.Deadline())
+			if(lhs.hasDeadline && !rhs.hasDeadline)
 				return !availableSortAsc;
 		}
 		// Then, separate greyed-out jobs you can't accept
 		if(sortSeparatePossible)
 		{
-			if(lhs.CanAccept(*this) && !rhs.CanAccept(*this))
+			if(lhs.canAccept && !rhs.canAccept)
 				return availableSortAsc;
-			if(!lhs.CanAccept(*this) && rhs.CanAccept(*this))
+			if(!lhs.canAccept && rhs.canAccept)
 				return !availableSortAsc;
 		}
 		// Sort by desired type:
@@ -2302,12 +2448,9 @@ void PlayerInfo::SortAvailable()
 			{
 				// Sorting by "convenience" means you already have a mission to a
 				// planet. Missions at the same planet are sorted higher.
-				// 0 : No convenient mission; 1: same system; 2: same planet (because both system+planet means 1+1 = 2)
-				const int lConvenient = destinations.count(lhs.Destination()) + destinations.count(lhs.Destination()->GetSystem());
-				const int rConvenient = destinations.count(rhs.Destination()) + destinations.count(rhs.Destination()->GetSystem());
-				if(lConvenient < rConvenient)
+				if(lhs.convenience < rhs.convenience)
 					return true;
-				if(lConvenient > rConvenient)
+				if(lhs.convenience > rhs.convenience)
 					return false;
 			}
 			// Tiebreaker for equal CONVENIENT is SPEED.
@@ -2315,8 +2458,8 @@ void PlayerInfo::SortAvailable()
 			{
 				// A higher "Speed" means the mission takes less time, i.e. fewer
 				// jumps.
-				const int lJumps = lhs.ExpectedJumps();
-				const int rJumps = rhs.ExpectedJumps();
+				const int lJumps = lhs.jumps;
+				const int rJumps = rhs.jumps;
 
 				if(lJumps == rJumps)
 				{
@@ -2347,8 +2490,8 @@ void PlayerInfo::SortAvailable()
 			// Tiebreaker for equal SPEED is PAY.
 			case PAY:
 			{
-				const int64_t lPay = lhs.DisplayedPayment();
-				const int64_t rPay = rhs.DisplayedPayment();
+				const int64_t lPay = lhs.payment;
+				const int64_t rPay = rhs.payment;
 				if(lPay < rPay)
 					return true;
 				else if(lPay > rPay)
@@ -2357,16 +2500,20 @@ void PlayerInfo::SortAvailable()
 			// Tiebreaker for equal PAY is ABC.
 			case ABC:
 			{
-				if(lhs.DisplayName() < rhs.DisplayName())
+				if(lhs.mission->DisplayName() < rhs.mission->DisplayName())
 					return true;
-				else if(lhs.DisplayName() > rhs.DisplayName())
+				else if(lhs.mission->DisplayName() > rhs.mission->DisplayName())
 					return false;
 			}
 			// Tiebreaker fallback to keep sorting consistent is unique UUID:
 			default:
-				return lhs.UUID() < rhs.UUID();
+				return lhs.mission->UUID() < rhs.mission->UUID();
 		}
 	});
+	// Moving each mission to the end of the list, in order, sorts the list
+	// without moving any of the missions themselves.
+	for(const SortKey &key : keys)
+		availableJobs.splice(availableJobs.end(), availableJobs, key.mission);
 
 	if(!availableSortAsc)
 		availableJobs.reverse();
@@ -3022,14 +3169,14 @@ void PlayerInfo::Unvisit(const Planet &planet)
 
 
 
-const set<const System *> &PlayerInfo::VisitedSystems() const
+const IndexedSet<System> &PlayerInfo::VisitedSystems() const
 {
 	return visitedSystems;
 }
 
 
 
-const set<const Planet *> &PlayerInfo::VisitedPlanets() const
+const IndexedSet<Planet> &PlayerInfo::VisitedPlanets() const
 {
 	return visitedPlanets;
 }
@@ -4001,10 +4148,11 @@ void PlayerInfo::RegisterDerivedConditions()
 
 		// This variable represents the probability of no raid fleets spawning.
 		double safeChance = 1.;
+		const pair<double, double> factors = RaidFleetFactors();
 		for(const auto &raidFleet : system->RaidFleets())
 		{
 			// The attraction is the % chance for a single instance of this fleet to appear.
-			double attraction = RaidFleetAttraction(raidFleet, system);
+			double attraction = RaidFleetAttraction(raidFleet, system, factors);
 			// Calculate the % chance for no instances to appear from 10 rolls.
 			double noFleetProb = pow(1. - attraction, 10.);
 			// The chance of neither of two fleets appearing is the chance of the first not appearing
@@ -4369,10 +4517,7 @@ void PlayerInfo::RegisterDerivedConditions()
 		if(!origin)
 			return -1;
 
-		auto distanceMap = DistanceMap(origin);
-		if(!distanceMap.HasRoute(*destination))
-			return -1;
-		return distanceMap.Days(*destination);
+		return JumpTable::Jumps(*origin, *destination);
 	};
 
 	conditions["hyperjumps to system: "].ProvidePrefixed([this, HyperspaceTravelDays](const ConditionEntry &ce) -> int {
@@ -4465,6 +4610,12 @@ void PlayerInfo::RegisterDerivedConditions()
 	{
 		GameData::GlobalConditions().Set(ce.NameWithoutPrefix(), value);
 	});
+
+	// These look at every ship in the fleet, but are often checked many times
+	// in one frame, e.g. by the conditions of every raid fleet in a system.
+	for(const char *name : {"cargo attractiveness", "armament deterrence", "pirate attraction",
+			"raid chance in system: ", "player strength"})
+		conditions[name].CacheUntilNextFrame();
 }
 
 
@@ -4520,11 +4671,9 @@ void PlayerInfo::CreateMissions()
 	bool skipJobs = planet && !planet->GetPort().HasService(Port::ServicesType::JobBoard);
 	bool hasPriorityMissions = false;
 	unsigned nonBlockingMissions = 0;
-	for(const auto &[name, mission] : GameData::Missions())
+	for(const Mission *candidate : GameData::MissionsOfferedAt(planet))
 	{
-		if(mission.IsAtLocation(Mission::BOARDING) || mission.IsAtLocation(Mission::ASSISTING)
-				|| mission.IsAtLocation(Mission::ENTERING) || mission.IsAtLocation(Mission::TRANSITION))
-			continue;
+		const Mission &mission = *candidate;
 		if(skipJobs && mission.IsAtLocation(Mission::JOB))
 			continue;
 
@@ -4681,13 +4830,49 @@ void PlayerInfo::Autosave() const
 
 void PlayerInfo::Save(const string &filePath) const
 {
-	if(transactionSnapshot)
-		transactionSnapshot->SaveToPath(filePath);
-	else
+	QueueSave([path = filePath, text = SaveToString(), entry = IndexEntry(),
+		isCompact = Preferences::Has("Compact save files")]() -> void
 	{
-		DataWriter out(filePath);
-		Save(out);
+		WriteReplacing(path, SaveContents(text, isCompact));
+		SaveIndex::Update(path, entry);
+	});
+}
+
+
+
+SaveIndex::Entry PlayerInfo::IndexEntry() const
+{
+	SaveIndex::Entry entry;
+	entry.firstName = firstName;
+	entry.lastName = lastName;
+	entry.day = date.Day();
+	entry.month = date.Month();
+	entry.year = date.Year();
+	if(system)
+		entry.system = system->TrueName();
+	if(planet)
+		entry.planet = planet->TrueName();
+	entry.playTime = playTime;
+	entry.credits = accounts.Credits();
+	if(flagship)
+	{
+		entry.shipName = flagship->GivenName();
+		if(flagship->GetSprite())
+			entry.shipSprite = flagship->GetSprite()->Name();
 	}
+	return entry;
+}
+
+
+
+string PlayerInfo::SaveToString() const
+{
+	if(transactionSnapshot)
+		return transactionSnapshot->SaveToString();
+
+	DataWriter out;
+	Save(out);
+	return out.SaveToString();
 }
 
 
@@ -4959,7 +5144,7 @@ void PlayerInfo::Save(DataWriter &out) const
 	out.WriteComment("What you know:");
 
 	// Save a list of systems the player has visited.
-	WriteSorted(visitedSystems,
+	WriteSorted(vector<const System *>(visitedSystems.begin(), visitedSystems.end()),
 		[](const System *const *lhs, const System *const *rhs)
 			{ return (*lhs)->TrueName() < (*rhs)->TrueName(); },
 		[&out](const System *system)
@@ -4968,7 +5153,7 @@ void PlayerInfo::Save(DataWriter &out) const
 		});
 
 	// Save a list of planets the player has visited.
-	WriteSorted(visitedPlanets,
+	WriteSorted(vector<const Planet *>(visitedPlanets.begin(), visitedPlanets.end()),
 		[](const Planet *const *lhs, const Planet *const *rhs)
 			{ return (*lhs)->TrueName() < (*rhs)->TrueName(); },
 		[&out](const Planet *planet)
@@ -5086,7 +5271,7 @@ void PlayerInfo::Fine(UI &ui)
 				ui.Push(new ConversationPanel(*this, *message.first));
 			else
 			{
-				message.second = "Before you can leave your ship, the " + Translation::TrGovernment(gov->DisplayName())
+				message.second = "Before you can leave your ship, the " + gov->TranslatedDisplayName()
 					+ " authorities show up and begin scanning it. They say, \"Captain "
 					+ LastName()
 					+ ", we detect highly illegal material on your ship.\""
@@ -5256,7 +5441,7 @@ void PlayerInfo::DoAccounting()
 			if(!governments.empty())
 			{
 				message = "You have lost reputation with "
-					+ Format::List(governments, [](const Government *gov){ return "the " + Translation::TrGovernment(gov->DisplayName()); })
+					+ Format::List(governments, [](const Government *gov){ return "the " + gov->TranslatedDisplayName(); })
 					+ " due to active tributes.";
 				Messages::Add({message, GameData::MessageCategories().Get("normal")});
 			}
@@ -27,7 +27,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ExclusiveItem.h"
 #include "GameEvent.h"
 #include "Gamerules.h"
+#include "IndexedSet.h"
 #include "Mission.h"
+#include "SaveIndex.h"
 #include "SystemEntry.h"
 
 #include <chrono>
@@ -40,6 +42,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <utility>
 #include <vector>
 
+class DataFile;
 class DistanceMap;
 class Outfit;
 class Planet;
@@ -92,12 +95,18 @@ public:
 	void New(const StartConditions &start, const Gamerules &gamerules);
 	// Load an existing player.
 	void Load(const std::filesystem::path &path);
+	// Load an existing player from the given file, which was already read from
+	// the given path, for example in the background while it was selected.
+	void Load(const std::filesystem::path &path, const DataFile &file);
 	// Reload from the same file from which the current pilot was loaded.
 	void Reload();
 	// Load the most recently saved player. If no save could be loaded, returns false.
 	bool LoadRecent();
-	// Save this player (using the Identifier() as the file name).
+	// Save this player (using the Identifier() as the file name). The player's
+	// state is captured right away, and written to disk in the background.
 	void Save() const;
+	// Wait until every save that has been started is written to disk.
+	static void FinishSaving();
 
 	// Get the root filename used for this player's saved game files. (If there
 	// are multiple pilots with the same name it may have a digit appended.)
@@ -191,6 +200,10 @@ public:
 	// Get the attraction factors of the player's fleet to raid fleets.
 	std::pair<double, double> RaidFleetFactors() const;
 	double RaidFleetAttraction(const RaidFleet &raidFleet, const System *system) const;
+	// The same, given factors from RaidFleetFactors(), so that checking many raid
+	// fleets does not add up the player's whole fleet again for each of them.
+	static double RaidFleetAttraction(const RaidFleet &raidFleet, const System *system,
+		const std::pair<double, double> &factors);
 
 	// Get cargo information.
 	CargoHold &Cargo();
@@ -316,8 +329,8 @@ public:
 	// Mark a system and its planets as unvisited, even if visited previously.
 	void Unvisit(const System &system);
 	void Unvisit(const Planet &planet);
-	const std::set<const System *> &VisitedSystems() const;
-	const std::set<const Planet *> &VisitedPlanets() const;
+	const IndexedSet<System> &VisitedSystems() const;
+	const IndexedSet<Planet> &VisitedPlanets() const;
 
 	// Check whether the player has visited the <mapSize> systems around the current one.
 	bool HasMapped(int mapSize, bool mapMinables) const;
@@ -424,6 +437,10 @@ private:
 	void Autosave() const;
 	void Save(const std::string &path) const;
 	void Save(DataWriter &out) const;
+	// Get the contents of the saved game file for the player's current state,
+	// and the details of it that the load panel shows.
+	std::string SaveToString() const;
+	SaveIndex::Entry IndexEntry() const;
 
 	// Check for and apply any punitive actions from planetary security.
 	void Fine(UI &ui);
@@ -528,8 +545,8 @@ private:
 	std::map<std::string, EsUuid> giftedShips;
 
 	std::set<const System *> seen;
-	std::set<const System *> visitedSystems;
-	std::set<const Planet *> visitedPlanets;
+	IndexedSet<System> visitedSystems;
+	IndexedSet<Planet> visitedPlanets;
 	std::vector<const System *> travelPlan;
 	const Planet *travelDestination = nullptr;
 
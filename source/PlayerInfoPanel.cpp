@@ -36,6 +36,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ShipInfoPanel.h"
 #include "System.h"
 #include "text/Table.h"
+#include "text/TextBatch.h"
 #include "text/Translation.h"
 #include "text/Truncate.h"
 #include "UI.h"
@@ -301,6 +302,7 @@ void PlayerInfoPanel::Draw()
 	// Draw the player and fleet info sections.
 	menuZones.clear();
 
+	TextBatch batch;
 	DrawPlayer(infoPanelUi->GetBox("player"));
 	DrawFleet(infoPanelUi->GetBox("fleet"));
 }
@@ -16,7 +16,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Politics.h"
 
 #include "text/Format.h"
-#include "text/Translation.h"
 #include "GameData.h"
 #include "Government.h"
 #include "Planet.h"
@@ -72,6 +71,31 @@ void Politics::Reset()
 	// were already checked for when you first landed).
 	for(const auto &it : GameData::Governments())
 		fined.insert(&it.second);
+
+	UpdateAttitudes();
+}
+
+
+
+// Work out again which governments are enemies, because the attitudes of
+// the governments toward each other may have changed.
+void Politics::UpdateAttitudes()
+{
+	governments.clear();
+	for(const auto &it : GameData::Governments())
+	{
+		const Government *gov = &it.second;
+		if(gov->Id() >= governments.size())
+			governments.resize(gov->Id() + 1);
+		governments[gov->Id()] = gov;
+	}
+
+	rowWords = (governments.size() + 63) / 64;
+	enemies.assign(governments.size() * rowWords, 0);
+	for(size_t i = 0; i < governments.size(); ++i)
+		for(size_t j = i + 1; j < governments.size(); ++j)
+			if(governments[i] && governments[j] && FindEnemy(governments[i], governments[j]))
+				SetEnemy(i, j, true);
 }
 
 
@@ -84,6 +108,22 @@ bool Politics::IsEnemy(const Government *first, const Government *second) const
 	if(first == second)
 		return false;
 
+	// Governments that were created since the table was made are not in it.
+	const unsigned a = first->Id();
+	const unsigned b = second->Id();
+	if(a < governments.size() && b < governments.size()
+			&& governments[a] == first && governments[b] == second)
+		return (enemies[a * rowWords + b / 64] >> (b % 64)) & 1;
+
+	return FindEnemy(first, second);
+}
+
+
+
+// Check whether two different governments are enemies, without using the
+// table of enemies.
+bool Politics::FindEnemy(const Government *first, const Government *second) const
+{
 	// Just for simplicity, if one of the governments is the player, make sure
 	// it is the first one.
 	if(second->IsPlayer())
@@ -106,6 +146,39 @@ bool Politics::IsEnemy(const Government *first, const Government *second) const
 
 
 
+// Update the table of enemies for the player's relationship with the given
+// government.
+void Politics::UpdatePlayer(const Government *gov)
+{
+	const Government *player = GameData::PlayerGovernment();
+	if(!gov || !player || gov == player)
+		return;
+	if(gov->Id() < governments.size() && player->Id() < governments.size())
+		SetEnemy(gov->Id(), player->Id(), FindEnemy(player, gov));
+}
+
+
+
+void Politics::UpdatePlayer()
+{
+	for(const Government *gov : governments)
+		UpdatePlayer(gov);
+}
+
+
+
+void Politics::SetEnemy(unsigned first, unsigned second, bool isEnemy)
+{
+	const uint64_t firstBit = uint64_t(1) << (first % 64);
+	const uint64_t secondBit = uint64_t(1) << (second % 64);
+	uint64_t &firstWord = enemies[second * rowWords + first / 64];
+	uint64_t &secondWord = enemies[first * rowWords + second / 64];
+	firstWord = isEnemy ? (firstWord | firstBit) : (firstWord & ~firstBit);
+	secondWord = isEnemy ? (secondWord | secondBit) : (secondWord & ~secondBit);
+}
+
+
+
 // Commit the given "offense" against the given government (which may not
 // actually consider it to be an offense). This may result in temporary
 // hostilities (if the even type is PROVOKE), or a permanent change to your
@@ -149,6 +222,7 @@ void Politics::Offend(const Government *gov, int eventType, int count)
 			Politics::AddReputation(other, -reputationChange);
 		}
 	}
+	UpdatePlayer();
 }
 
 
@@ -159,6 +233,7 @@ void Politics::Bribe(const Government *gov)
 	bribed.insert(gov);
 	provoked.erase(gov);
 	fined.insert(gov);
+	UpdatePlayer(gov);
 }
 
 
@@ -382,7 +457,7 @@ pair<const Conversation *, string> Politics::Fine(PlayerInfo &player,
 				deathSentence = gov->DeathSentence();
 		}
 		else
-			reason = "After scanning your ship, the " + Translation::TrGovernment(gov->DisplayName())
+			reason = "After scanning your ship, the " + gov->TranslatedDisplayName()
 				+ " captain hails you with a grim expression on his face. He says, "
 				"\"I'm afraid we're going to have to put you to death " + reason + " Goodbye.\"";
 	}
@@ -390,7 +465,7 @@ pair<const Conversation *, string> Politics::Fine(PlayerInfo &player,
 	{
 		// Scale the fine based on how lenient this government is.
 		maxFine = lround(maxFine * gov->GetFineFraction());
-		reason = "The " + Translation::TrGovernment(gov->DisplayName()) + " authorities fine you "
+		reason = "The " + gov->TranslatedDisplayName() + " authorities fine you "
 			+ Format::CreditString(maxFine) + reason;
 		player.Accounts().AddFine(maxFine);
 		fined.insert(gov);
@@ -421,6 +496,7 @@ void Politics::SetReputation(const Government *gov, double value)
 	value = min(value, gov->ReputationMax());
 	value = max(value, gov->ReputationMin());
 	reputationWith[gov] = value;
+	UpdatePlayer(gov);
 }
 
 
@@ -432,4 +508,5 @@ void Politics::ResetDaily()
 	bribed.clear();
 	bribedPlanets.clear();
 	fined.clear();
+	UpdatePlayer();
 }
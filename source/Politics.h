@@ -15,9 +15,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 class Conversation;
 class Government;
@@ -35,6 +37,9 @@ class Politics {
 public:
 	// Reset to the initial political state defined in the game data.
 	void Reset();
+	// Work out again which governments are enemies, because the attitudes of
+	// the governments toward each other may have changed.
+	void UpdateAttitudes();
 
 	bool IsEnemy(const Government *first, const Government *second) const;
 
@@ -73,6 +78,17 @@ public:
 	void ResetDaily();
 
 
+private:
+	// Check whether two different governments are enemies, without using the
+	// table of enemies.
+	bool FindEnemy(const Government *first, const Government *second) const;
+	// Update the table of enemies for the player's relationship with the given
+	// government, or with every government.
+	void UpdatePlayer(const Government *gov);
+	void UpdatePlayer();
+	void SetEnemy(unsigned first, unsigned second, bool isEnemy);
+
+
 private:
 	// attitude[target][other] stores how much an action toward the given target
 	// government will affect your reputation with the given other government.
@@ -85,4 +101,10 @@ private:
 	std::map<const Planet *, bool> bribedPlanets;
 	std::set<const Planet *> dominatedPlanets;
 	std::set<const Government *> fined;
+
+	// Which governments are enemies of each other, as a matrix of bits with a
+	// row for each government's id, so that checking is a single lookup.
+	std::vector<const Government *> governments;
+	size_t rowWords = 0;
+	std::vector<uint64_t> enemies;
 };
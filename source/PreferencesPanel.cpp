@@ -822,6 +822,7 @@ void PreferencesPanel::DrawSettings()
 		"Graphics",
 		CAMERA_ACCELERATION,
 		"Render motion blur",
+		"Smooth high refresh rates",
 		"Draw background haze",
 		"Draw starfield",
 		"Fixed starfield zoom",
@@ -835,6 +836,7 @@ void PreferencesPanel::DrawSettings()
 		"Show CPU / GPU load",
 		LARGE_GRAPHICS_REDUCTION,
 		"Defer loading images",
+		"Compress sprite textures",
 		SHIP_OUTLINES,
 		HUD_SHIP_OUTLINES,
 		"",
@@ -894,6 +896,8 @@ void PreferencesPanel::DrawSettings()
 		"Show parenthesis",
 		NOTIFY_ON_DEST,
 		"Save message log",
+		"Compact save files",
+		"Reduce distant ship AI",
 #ifdef _WIN32
 		"\t",
 		"Windows Options",
@@ -1531,7 +1535,7 @@ void PreferencesPanel::HandleSettingsString(const string &str, Point cursorPosit
 			i = (i + 1) % codes.size();
 			string next = codes[i];
 			Preferences::SetLanguage(next);
-			Translation::SetLanguage(next);
+			Translation::SetLanguage(GetUI().AsyncQueue(), next);
 			if(next == "en")
 				Preferences::SetLetterSpacing(1);
 			else if(next == "ru")
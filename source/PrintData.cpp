@@ -668,8 +668,8 @@ namespace {
 		StellarObject::UsingMatchesCommand();
 		DataFile file(cin);
 		LocationFilter filter;
-		const set<const System *> *visitedSystems = &player.VisitedSystems();
-		const set<const Planet *> *visitedPlanets = &player.VisitedPlanets();
+		const IndexedSet<System> *visitedSystems = &player.VisitedSystems();
+		const IndexedSet<Planet> *visitedPlanets = &player.VisitedPlanets();
 		for(const DataNode &node : file)
 		{
 			const string &key = node.Token(0);
@@ -712,7 +712,8 @@ namespace {
 
 		DataFile file(recentPath);
 
-		DataWriter out;
+		// The changes can add up to a lot of text, so write them out as they go.
+		DataWriter out(cout);
 		out.Write("changes");
 		out.BeginChild();
 		for(const DataNode &node : file)
@@ -737,8 +738,8 @@ namespace {
 			}
 		}
 		out.EndChild();
-
-		cout << out.SaveToString() << '\n';
+		// End the output with a blank line.
+		out.Write();
 	}
 
 
@@ -0,0 +1,292 @@
+/* Profiler.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Profiler.h"
+
+#include "Files.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// The number of events each thread keeps before overwriting its oldest ones.
+	// At 60 frames per second and a few dozen sections per frame, this covers
+	// roughly the last half minute of play.
+	constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+	struct Event {
+		const char *name;
+		// Both of these are in nanoseconds, and the start is relative to the
+		// moment the profiler was enabled.
+		int64_t start;
+		int64_t duration;
+		// Counters store their value in place of a duration.
+		bool isCounter = false;
+	};
+
+	struct SectionTotal {
+		int64_t count = 0;
+		int64_t duration = 0;
+		int64_t longest = 0;
+	};
+
+	// The events recorded by a single thread. Only that thread adds events, so
+	// the lock is only ever contended while the trace is being written.
+	struct ThreadEvents {
+		explicit ThreadEvents(int id) : id(id) { events.reserve(EVENTS_PER_THREAD); }
+
+		mutex lock;
+		vector<Event> events;
+		// The index at which the next event will be stored once the buffer is full.
+		size_t next = 0;
+		int id;
+		// The number of times each section ran, the total time spent in it, and
+		// the longest single run, since the totals were last reset.
+		unordered_map<const char *, SectionTotal> totals;
+	};
+
+	atomic<bool> isEnabled = false;
+	filesystem::path tracePath;
+	chrono::steady_clock::time_point epoch;
+
+	// Every thread that has recorded an event. These are never removed, so that
+	// the events of threads that have already exited can still be written.
+	mutex threadsMutex;
+	vector<unique_ptr<ThreadEvents>> threads;
+	thread_local ThreadEvents *localEvents = nullptr;
+	// The sections timed on the GPU are shown as if they ran on a thread of their own.
+	unique_ptr<ThreadEvents> gpuEvents;
+
+	ThreadEvents &LocalEvents()
+	{
+		if(!localEvents)
+		{
+			lock_guard<mutex> lock(threadsMutex);
+			threads.emplace_back(make_unique<ThreadEvents>(threads.size() + 1));
+			localEvents = threads.back().get();
+		}
+		return *localEvents;
+	}
+
+	// Add an event to the given thread's buffer. Its lock must be held.
+	void Store(ThreadEvents &thread, const Event &event)
+	{
+		if(thread.events.size() < EVENTS_PER_THREAD)
+			thread.events.push_back(event);
+		else
+		{
+			thread.events[thread.next] = event;
+			thread.next = (thread.next + 1) % EVENTS_PER_THREAD;
+		}
+	}
+
+	void Record(const char *name, chrono::steady_clock::time_point start, chrono::steady_clock::time_point end)
+	{
+		Event event{name, chrono::duration_cast<chrono::nanoseconds>(start - epoch).count(),
+			chrono::duration_cast<chrono::nanoseconds>(end - start).count()};
+
+		ThreadEvents &local = LocalEvents();
+		lock_guard<mutex> lock(local.lock);
+		SectionTotal &total = local.totals[name];
+		++total.count;
+		total.duration += event.duration;
+		total.longest = max(total.longest, event.duration);
+		Store(local, event);
+	}
+
+	// Trace event timestamps are given in microseconds.
+	string Microseconds(int64_t nanoseconds)
+	{
+		return to_string(nanoseconds / 1000) + '.' + to_string(nanoseconds / 100 % 10);
+	}
+
+	// Append every event of the given thread to the trace. Its lock must be held.
+	void WriteEvents(const ThreadEvents &thread, string &out)
+	{
+		const string tid = to_string(thread.id);
+		// Write the events from oldest to newest.
+		const size_t size = thread.events.size();
+		for(size_t i = 0; i < size; ++i)
+		{
+			const Event &event = thread.events[(thread.next + i) % size];
+			out += ",\n{\"name\":\"";
+			out += event.name;
+			if(event.isCounter)
+				out += "\",\"ph\":\"C\",\"pid\":1,\"tid\":" + tid
+					+ ",\"ts\":" + Microseconds(event.start)
+					+ ",\"args\":{\"value\":" + to_string(event.duration) + "}}";
+			else
+				out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid
+					+ ",\"ts\":" + Microseconds(event.start)
+					+ ",\"dur\":" + Microseconds(event.duration) + '}';
+		}
+	}
+}
+
+
+
+Profiler::Scope::Scope(const char *name) noexcept
+	: name(name)
+{
+	if(isEnabled.load(memory_order_relaxed))
+		start = chrono::steady_clock::now();
+}
+
+
+
+Profiler::Scope::~Scope() noexcept
+{
+	// If the profiler was enabled while this section was running, it has no start time.
+	if(isEnabled.load(memory_order_relaxed) && start.time_since_epoch().count())
+		Record(name, start, chrono::steady_clock::now());
+}
+
+
+
+// Start recording events. If a path is given, WriteTrace() writes them to it.
+void Profiler::Enable(const filesystem::path &path)
+{
+	tracePath = path;
+	epoch = chrono::steady_clock::now();
+	if(!gpuEvents)
+		gpuEvents = make_unique<ThreadEvents>(0);
+	isEnabled = true;
+}
+
+
+
+bool Profiler::IsEnabled() noexcept
+{
+	return isEnabled.load(memory_order_relaxed);
+}
+
+
+
+// Record a section that ran on the GPU, on a separate track of the trace.
+// Its start is when the commands for it were issued, since that is the
+// closest the CPU's clock can tell. These are not included in the totals.
+void Profiler::AddGpuSection(const char *name, chrono::steady_clock::time_point start, chrono::nanoseconds duration)
+{
+	if(!IsEnabled())
+		return;
+
+	lock_guard<mutex> lock(gpuEvents->lock);
+	Store(*gpuEvents, {name, chrono::duration_cast<chrono::nanoseconds>(start - epoch).count(), duration.count()});
+}
+
+
+
+// Record the current value of a counter, such as the number of draw calls
+// in the last frame. The name must last for as long as the program runs.
+void Profiler::AddCounter(const char *name, int64_t value)
+{
+	if(!IsEnabled())
+		return;
+
+	ThreadEvents &local = LocalEvents();
+	lock_guard<mutex> lock(local.lock);
+	Store(local, {name, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count(),
+		value, true});
+}
+
+
+
+// Write every recorded event to the trace file, if one was given.
+void Profiler::WriteTrace()
+{
+	if(!IsEnabled() || tracePath.empty())
+		return;
+
+	string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	// Give the GPU's track a name, so it is not mistaken for a thread.
+	out += "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+	size_t count = 0;
+	{
+		lock_guard<mutex> threadsLock(threadsMutex);
+		for(const unique_ptr<ThreadEvents> &thread : threads)
+		{
+			lock_guard<mutex> lock(thread->lock);
+			WriteEvents(*thread, out);
+			count += thread->events.size();
+		}
+	}
+	{
+		lock_guard<mutex> lock(gpuEvents->lock);
+		WriteEvents(*gpuEvents, out);
+		count += gpuEvents->events.size();
+	}
+	out += "\n]}\n";
+
+	Files::Write(tracePath, out);
+	Logger::Log("Wrote " + to_string(count) + " profiler events to \"" + tracePath.string() + "\".",
+		Logger::Level::INFO);
+}
+
+
+
+// Get the totals of every section that has been recorded since the last
+// call to ResetTotals(), from the most time spent to the least.
+vector<Profiler::Total> Profiler::Totals()
+{
+	vector<Total> result;
+	{
+		lock_guard<mutex> threadsLock(threadsMutex);
+		for(const unique_ptr<ThreadEvents> &thread : threads)
+		{
+			lock_guard<mutex> lock(thread->lock);
+			for(const auto &[name, total] : thread->totals)
+			{
+				// The same name may be used by sections on several threads, and
+				// even by different string literals.
+				auto it = find_if(result.begin(), result.end(),
+					[name](const Total &other) { return !strcmp(other.name, name); });
+				if(it == result.end())
+					result.push_back({name, total.count, chrono::nanoseconds(total.duration),
+						chrono::nanoseconds(total.longest)});
+				else
+				{
+					it->count += total.count;
+					it->duration += chrono::nanoseconds(total.duration);
+					it->longest = max(it->longest, chrono::nanoseconds(total.longest));
+				}
+			}
+		}
+	}
+	sort(result.begin(), result.end(),
+		[](const Total &a, const Total &b) { return a.duration > b.duration; });
+	return result;
+}
+
+
+
+void Profiler::ResetTotals()
+{
+	lock_guard<mutex> threadsLock(threadsMutex);
+	for(const unique_ptr<ThreadEvents> &thread : threads)
+	{
+		lock_guard<mutex> lock(thread->lock);
+		thread->totals.clear();
+	}
+}
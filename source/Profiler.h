@@ -0,0 +1,80 @@
+/* Profiler.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+
+
+// A low-overhead profiler for finding out which parts of a frame take the most
+// time. When it is enabled, every thread records the timed sections it runs in
+// its own ring buffer, which only keeps the most recent events. The events can
+// then be written out in the Chrome trace event format, which can be viewed in
+// chrome://tracing or https://ui.perfetto.dev. When the profiler is disabled,
+// timing a section only costs a single check of a flag.
+class Profiler {
+public:
+	// Times the section of code from the construction of this object until it
+	// goes out of scope. The name must be a string literal (or otherwise last
+	// for as long as the program runs).
+	class Scope {
+	public:
+		explicit Scope(const char *name) noexcept;
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+		~Scope() noexcept;
+
+	private:
+		const char *name;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	// The total time spent in every section with a certain name.
+	class Total {
+	public:
+		const char *name;
+		int64_t count;
+		std::chrono::nanoseconds duration;
+		// The longest that any single run of the section took.
+		std::chrono::nanoseconds longest;
+	};
+
+
+public:
+	// Start recording events. If a path is given, WriteTrace() writes them to it.
+	static void Enable(const std::filesystem::path &path = {});
+	static bool IsEnabled() noexcept;
+
+	// Record a section that ran on the GPU, on a separate track of the trace.
+	// Its start is when the commands for it were issued, since that is the
+	// closest the CPU's clock can tell. These are not included in the totals.
+	static void AddGpuSection(const char *name, std::chrono::steady_clock::time_point start,
+		std::chrono::nanoseconds duration);
+	// Record the current value of a counter, such as the number of draw calls
+	// in the last frame. The name must last for as long as the program runs.
+	static void AddCounter(const char *name, int64_t value);
+
+	// Write every recorded event to the trace file, if one was given.
+	static void WriteTrace();
+
+	// Get the totals of every section that has been recorded since the last
+	// call to ResetTotals(), from the most time spent to the least.
+	static std::vector<Total> Totals();
+	static void ResetTotals();
+};
@@ -143,8 +143,25 @@ Projectile::Projectile(Point position, const Weapon *weapon)
 
 
 
-// This returns false if it is time to delete this projectile.
+// Move the projectile. It may create effects or submunitions.
 void Projectile::Move(vector<Visual> &visuals, vector<Projectile> &projectiles)
+{
+	Point acceleration;
+	double drag;
+	if(!Steer(visuals, projectiles, acceleration, drag))
+		return;
+
+	const Point newVelocity = velocity * (1. - drag) + acceleration;
+	FinishMove(position + newVelocity, newVelocity);
+}
+
+
+
+// Do everything that Move() does except for changing the projectile's position
+// and velocity. This returns false if the projectile is not going to move this
+// step. Otherwise, its velocity should be multiplied by (1 - drag), and then the
+// acceleration added to it, before FinishMove() is called.
+bool Projectile::Steer(vector<Visual> &visuals, vector<Projectile> &projectiles, Point &acceleration, double &drag)
 {
 	if(--lifetime <= 0)
 	{
@@ -171,7 +188,7 @@ void Projectile::Move(vector<Visual> &visuals, vector<Projectile> &projectiles)
 					}
 		}
 		MarkForRemoval();
-		return;
+		return false;
 	}
 	// Spawn live effects. By using the current position of the projectile and not
 	// adding any offset from the projectile's velocity, effects will appear to spawn
@@ -187,9 +204,14 @@ void Projectile::Move(vector<Visual> &visuals, vector<Projectile> &projectiles)
 	const Entity *currentTarget = cachedTarget;
 	if(currentTarget)
 	{
-		currentTarget = TargetPtr().get();
-		if(!currentTarget)
+		// The cached pointer is valid for as long as the target still exists.
+		// Checking that does not need the reference count to be changed, as
+		// locking the pointer would.
+		if(target.expired())
+		{
 			BreakTarget();
+			currentTarget = nullptr;
+		}
 		else if(targetIsShip)
 		{
 			auto targetShip = static_cast<const Ship *>(currentTarget);
@@ -290,25 +312,35 @@ void Projectile::Move(vector<Visual> &visuals, vector<Projectile> &projectiles)
 			angle += Angle(turn);
 	}
 
+	acceleration = Point();
+	drag = 0.;
 	if(accel)
 	{
-		double d = 1. - weapon->Drag();
-		Point a = accel * angle.Unit();
-		velocity *= d;
-		velocity += a;
+		drag = weapon->Drag();
+		double d = 1. - drag;
+		acceleration = accel * angle.Unit();
 		dV *= d;
-		dV += a;
+		dV += acceleration;
 	}
+	return true;
+}
 
-	position += velocity;
+
+
+// Finish moving the projectile, once its new position and velocity are known.
+void Projectile::FinishMove(const Point &newPosition, const Point &newVelocity)
+{
+	position = newPosition;
+	velocity = newVelocity;
 	// Only measure the distance that this projectile traveled under its own
 	// power, as opposed to including any velocity that came from the firing
 	// ship.
 	distanceTraveled += dV.Length();
 
 	// If this projectile is now within its "split range," it should split into
-	// sub-munitions next turn.
-	if(currentTarget && (position - currentTarget->Position()).Length() < weapon->SplitRange())
+	// sub-munitions next turn. If the target is no longer valid, Steer() has
+	// already stopped following it.
+	if(cachedTarget && (position - cachedTarget->Position()).Length() < weapon->SplitRange())
 		lifetime = 0;
 
 	// A projectile will begin to fade out when the remaining lifetime is smaller
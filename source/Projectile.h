@@ -68,6 +68,14 @@ public:
 
 	// Move the projectile. It may create effects or submunitions.
 	void Move(std::vector<Visual> &visuals, std::vector<Projectile> &projectiles);
+	// Move() can also be done in two parts, so that the positions and velocities
+	// of many projectiles can be updated together. Steer() does everything except
+	// for updating the position and velocity. It returns false if the projectile
+	// is not going to move this step. Otherwise, its velocity should be multiplied
+	// by (1 - drag) and then the acceleration added to it, and FinishMove() called
+	// with the resulting velocity and position.
+	bool Steer(std::vector<Visual> &visuals, std::vector<Projectile> &projectiles, Point &acceleration, double &drag);
+	void FinishMove(const Point &newPosition, const Point &newVelocity);
 	// This projectile hit something. Create the explosion, if any. This also
 	// marks the projectile as needing deletion if it has run out of penetrations.
 	void Explode(std::vector<Visual> &visuals, double intersection, Point hitVelocity = Point());
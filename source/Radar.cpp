@@ -84,9 +84,17 @@ void Radar::AddViewportBoundary(const Point &vertex)
 
 
 
-// Draw the radar display at the given coordinates.
+// Draw the radar display at the given coordinates. Each kind of element is
+// drawn with a single batched call to the shader for it.
 void Radar::Draw(const Point &center, double scale, double radius, double pointerRadius) const
 {
+	static vector<LineShader::Item> lineItems;
+	static vector<RingShader::Item> ringItems;
+	static vector<PointerShader::Item> pointerItems;
+	lineItems.clear();
+	ringItems.clear();
+	pointerItems.clear();
+
 	// Draw any desired line vectors.
 	for(const Line &line : lines)
 	{
@@ -108,11 +116,11 @@ void Radar::Draw(const Point &center, double scale, double radius, double pointe
 		else if(endExcess > 0)
 			v -= endExcess * v.Unit();
 
-		LineShader::Draw(start + center, start + v + center, 1.f, line.color);
+		lineItems.push_back(LineShader::Prepare(start + center, start + v + center, 1.f, line.color));
 	}
+	LineShader::Draw(lineItems);
 
 	// Draw StellarObjects and ships.
-	RingShader::Bind();
 	for(const Object &object : objects)
 	{
 		Point position = object.position * scale;
@@ -121,15 +129,14 @@ void Radar::Draw(const Point &center, double scale, double radius, double pointe
 			position *= radius / length;
 		position += center;
 
-		RingShader::Add(position, object.outer, object.inner, object.color);
+		ringItems.push_back(RingShader::Prepare(position, object.outer, object.inner, object.color));
 	}
-	RingShader::Unbind();
+	RingShader::Draw(ringItems);
 
 	// Draw neighboring system indicators.
-	PointerShader::Bind();
 	for(const Pointer &pointer : pointers)
-		PointerShader::Add(center, pointer.unit, 10.f, 10.f, pointerRadius, pointer.color);
-	PointerShader::Unbind();
+		pointerItems.push_back(PointerShader::Prepare(center, pointer.unit, 10.f, 10.f, pointerRadius, pointer.color));
+	PointerShader::Draw(pointerItems);
 }
 
 
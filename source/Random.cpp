@@ -15,28 +15,94 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Random.h"
 
+#include <atomic>
+#include <chrono>
 #include <random>
 
-#ifndef __linux__
-#include <mutex>
-#endif
-
 using namespace std;
 
-// Right now thread_local storage is only supported under Linux.
 namespace {
-#ifndef __linux__
-	mutex workaroundMutex;
-	mt19937_64 gen;
-	uniform_int_distribution<uint32_t> uniform;
-	uniform_real_distribution<double> real;
-	normal_distribution<double> normal;
-#else
-	thread_local mt19937_64 gen;
-	thread_local uniform_int_distribution<uint32_t> uniform;
-	thread_local uniform_real_distribution<double> real;
+	// The xoshiro256** generator by David Blackman and Sebastiano Vigna. It is
+	// several times faster than mt19937_64, and its small state makes seeding
+	// it cheap, which matters because deterministic mode seeds it for every
+	// engine step and for every ship that aims its turrets.
+	class Generator {
+	public:
+		using result_type = uint64_t;
+		static constexpr uint64_t min() { return 0; }
+		static constexpr uint64_t max() { return UINT64_MAX; }
+
+		constexpr Generator() { Seed(0, 0); }
+
+		// Fill the state from the seed and stream with SplitMix64, which the
+		// authors recommend because it never produces the all-zero state.
+		constexpr void Seed(uint64_t seed, uint64_t stream)
+		{
+			uint64_t x = seed ^ SplitMix(stream);
+			for(uint64_t &word : state)
+				word = SplitMix(x);
+		}
+
+		constexpr uint64_t operator()()
+		{
+			const uint64_t result = RotateLeft(state[1] * 5, 7) * 9;
+			const uint64_t t = state[1] << 17;
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = RotateLeft(state[3], 45);
+			return result;
+		}
+
+
+	private:
+		static constexpr uint64_t RotateLeft(uint64_t x, int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+		static constexpr uint64_t SplitMix(uint64_t &x)
+		{
+			uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+
+	private:
+		uint64_t state[4] = {};
+	};
+
+	thread_local Generator gen;
+	thread_local bool isSeeded = false;
 	thread_local normal_distribution<double> normal;
-#endif
+
+	atomic<bool> isDeterministic = false;
+	// Each thread that seeds its own generator gets a different stream, so
+	// that threads started at the same moment still differ.
+	atomic<uint64_t> nextStream = 1;
+
+	// Get this thread's generator. Unless the game is deterministic, a thread
+	// that has not been given a seed seeds its generator the first time that it
+	// is used, so that worker threads do not repeat the same numbers every time
+	// the game is run.
+	Generator &Gen()
+	{
+		if(!isSeeded)
+		{
+			isSeeded = true;
+			if(!isDeterministic.load(memory_order_relaxed))
+			{
+				const uint64_t seed = (static_cast<uint64_t>(random_device()()) << 32)
+					^ static_cast<uint64_t>(chrono::steady_clock::now().time_since_epoch().count());
+				gen.Seed(seed, nextStream.fetch_add(1, memory_order_relaxed));
+			}
+		}
+		return gen;
+	}
 }
 
 
@@ -45,30 +111,53 @@ namespace {
 // numbers it produced previously).
 void Random::Seed(uint64_t seed)
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
-	gen.seed(seed);
+	gen.Seed(seed, 0);
+	isSeeded = true;
+	normal.reset();
+}
+
+
+
+// Seed the generator with one of the many separate streams of numbers that the
+// given seed provides. Work that is split between threads can give each part a
+// stream of its own, so that the results do not depend on which thread did it.
+void Random::Seed(uint64_t seed, uint64_t stream)
+{
+	gen.Seed(seed, stream);
+	isSeeded = true;
+	normal.reset();
+}
+
+
+
+// In deterministic mode, work that may run on any thread (such as an engine
+// step) seeds the generator itself before using it, so that the same random
+// numbers are produced no matter which thread the work is done on.
+void Random::SetDeterministic(bool deterministic)
+{
+	isDeterministic = deterministic;
+}
+
+
+
+bool Random::IsDeterministic()
+{
+	return isDeterministic.load(memory_order_relaxed);
 }
 
 
 
 uint32_t Random::Int()
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
-	return uniform(gen);
+	// The high bits of xoshiro256** are its best ones.
+	return Gen()() >> 32;
 }
 
 
 
 uint32_t Random::Int(uint32_t upper_bound)
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
-	const uint32_t x = uniform(gen);
+	const uint32_t x = Int();
 	return (static_cast<uint64_t>(x) * static_cast<uint64_t>(upper_bound)) >> 32;
 }
 
@@ -76,10 +165,8 @@ uint32_t Random::Int(uint32_t upper_bound)
 
 double Random::Real()
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
-	return real(gen);
+	// Use the top 53 bits, which is exactly as many as a double can hold.
+	return (Gen()() >> 11) * 0x1.0p-53;
 }
 
 
@@ -89,10 +176,7 @@ double Random::Real()
 uint32_t Random::Polya(uint32_t k, double p)
 {
 	negative_binomial_distribution<uint32_t> polya(k, p);
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
-	return polya(gen);
+	return polya(Gen());
 }
 
 
@@ -101,10 +185,17 @@ uint32_t Random::Polya(uint32_t k, double p)
 uint32_t Random::Binomial(uint32_t t, double p)
 {
 	binomial_distribution<uint32_t> binomial(t, p);
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
-	return binomial(gen);
+	return binomial(Gen());
+}
+
+
+
+// Return the number of tries up to and including the first success, when
+// the probability of success is p. The mean value will be 1 / p.
+uint32_t Random::Geometric(double p)
+{
+	geometric_distribution<uint32_t> geometric(p);
+	return geometric(Gen()) + 1;
 }
 
 
@@ -112,8 +203,5 @@ uint32_t Random::Binomial(uint32_t t, double p)
 // Get a normally distributed number with standard or specified mean and stddev.
 double Random::Normal(double mean, double sigma)
 {
-#ifndef __linux__
-	lock_guard<mutex> lock(workaroundMutex);
-#endif
-	return sigma * normal(gen) + mean;
+	return sigma * normal(Gen()) + mean;
 }
@@ -20,13 +20,22 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 
 // Collection of functions for generating random numbers with a variety of
-// different distributions. (This is done partly because on some systems the
-// random number generation is not thread-safe.)
+// different distributions. Each thread has a generator of its own, so that
+// threads never have to wait for each other to get random numbers.
 class Random {
 public:
 	// Seed the generator (e.g. to make it produce exactly the same random
 	// numbers it produced previously).
 	static void Seed(uint64_t seed);
+	// Seed the generator with one of the many separate streams of numbers that the
+	// given seed provides. Work that is split between threads can give each part a
+	// stream of its own, so that the results do not depend on which thread did it.
+	static void Seed(uint64_t seed, uint64_t stream);
+	// In deterministic mode, work that may run on any thread (such as an engine
+	// step) seeds the generator itself before using it, so that the same random
+	// numbers are produced no matter which thread the work is done on.
+	static void SetDeterministic(bool deterministic);
+	static bool IsDeterministic();
 
 	static uint32_t Int();
 	static uint32_t Int(uint32_t modulus);
@@ -41,6 +50,9 @@ public:
 	static uint32_t Polya(uint32_t k, double p = .5);
 	// Get a number from a binomial distribution (i.e. integer bell curve).
 	static uint32_t Binomial(uint32_t t, double p = .5);
+	// Return the number of tries up to and including the first success, when
+	// the probability of success is p. The mean value will be 1 / p.
+	static uint32_t Geometric(double p);
 	// Get a number from a normal distribution with standard or specified mean and stddev.
 	static double Normal(double mean = 0, double sigma = 1);
 };
@@ -0,0 +1,87 @@
+/* RandomEventSchedule.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "RandomEventSchedule.h"
+
+#include "Random.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+// Remove all the events.
+void RandomEventSchedule::Clear()
+{
+	chances.clear();
+	queue = {};
+	due.clear();
+}
+
+
+
+// Add an event with the given chance of happening on each step. Events are
+// numbered in the order they were added.
+void RandomEventSchedule::Add(double chance)
+{
+	chances.push_back(clamp(chance, 0., 1.));
+	Schedule(chances.size() - 1);
+}
+
+
+
+size_t RandomEventSchedule::Size() const
+{
+	return chances.size();
+}
+
+
+
+// Check whether this schedule has exactly the given events, with each
+// one's chance given in the order that they were added.
+bool RandomEventSchedule::Matches(const vector<double> &otherChances) const
+{
+	return equal(chances.begin(), chances.end(), otherChances.begin(), otherChances.end(),
+		[](double chance, double other) { return chance == clamp(other, 0., 1.); });
+}
+
+
+
+// Advance by one step, and get the numbers of the events that happen on
+// it, in the order that they were added.
+const vector<size_t> &RandomEventSchedule::Step()
+{
+	++step;
+	due.clear();
+	while(!queue.empty() && queue.top().first <= step)
+	{
+		due.push_back(queue.top().second);
+		queue.pop();
+	}
+	sort(due.begin(), due.end());
+	for(size_t event : due)
+		Schedule(event);
+	return due;
+}
+
+
+
+void RandomEventSchedule::Schedule(size_t event)
+{
+	// An event that can never happen is not scheduled at all.
+	if(chances[event] > 0.)
+		queue.emplace(step + Random::Geometric(chances[event]), event);
+}
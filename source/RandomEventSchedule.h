@@ -0,0 +1,62 @@
+/* RandomEventSchedule.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+
+
+// A schedule of events that each have some chance of happening on any given
+// step, such as the fleets that may enter a system. Rather than rolling for
+// every event on every step, the number of steps until each one next happens
+// is drawn ahead of time, so a step only has to look at the events that are due.
+// Each step is independent of the ones before it, so this gives each event the
+// same chance of happening on any step as rolling for it would.
+class RandomEventSchedule {
+public:
+	// Remove all the events.
+	void Clear();
+	// Add an event with the given chance of happening on each step. Events are
+	// numbered in the order they were added.
+	void Add(double chance);
+
+	size_t Size() const;
+	// Check whether this schedule has exactly the given events, with each
+	// one's chance given in the order that they were added.
+	bool Matches(const std::vector<double> &otherChances) const;
+	// Advance by one step, and get the numbers of the events that happen on
+	// it, in the order that they were added.
+	const std::vector<size_t> &Step();
+
+
+private:
+	void Schedule(size_t event);
+
+
+private:
+	std::vector<double> chances;
+	int64_t step = 0;
+	// The step on which each event next happens, soonest first.
+	std::priority_queue<std::pair<int64_t, size_t>, std::vector<std::pair<int64_t, size_t>>,
+		std::greater<std::pair<int64_t, size_t>>> queue;
+	// The events that happen on the current step.
+	std::vector<size_t> due;
+};
@@ -0,0 +1,106 @@
+/* RangeGrid.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "RangeGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+
+
+// Remove all the items.
+void RangeGrid::Clear()
+{
+	positions.clear();
+	ranges.clear();
+	cells.clear();
+}
+
+
+
+// Add an item with the given position and range.
+void RangeGrid::Add(const Point &position, double range)
+{
+	positions.push_back(position);
+	ranges.push_back(range);
+}
+
+
+
+// Sort the items into cells. This must be done after adding them, and
+// before looking for any.
+void RangeGrid::Finish()
+{
+	cellSize = 1.;
+	for(double range : ranges)
+		cellSize = max(cellSize, range);
+
+	cells.clear();
+	cells.reserve(positions.size());
+	for(size_t i = 0; i < positions.size(); ++i)
+	{
+		const auto [x, y] = Cell(positions[i]);
+		cells.emplace_back(Key(x, y), static_cast<int>(i));
+	}
+	// Within a cell, the items stay in the order they were added.
+	sort(cells.begin(), cells.end());
+}
+
+
+
+bool RangeGrid::Empty() const
+{
+	return positions.empty();
+}
+
+
+
+// Get the numbers of the items that can reach the given point, in the
+// order that they were added.
+const vector<int> &RangeGrid::InRange(const Point &point)
+{
+	found.clear();
+	if(cells.empty())
+		return found;
+
+	const auto [x, y] = Cell(point);
+	for(int64_t dy = -1; dy <= 1; ++dy)
+		for(int64_t dx = -1; dx <= 1; ++dx)
+		{
+			const uint64_t key = Key(x + dx, y + dy);
+			auto it = lower_bound(cells.begin(), cells.end(), make_pair(key, 0));
+			for( ; it != cells.end() && it->first == key; ++it)
+				if(positions[it->second].Distance(point) <= ranges[it->second])
+					found.push_back(it->second);
+		}
+	sort(found.begin(), found.end());
+	return found;
+}
+
+
+
+uint64_t RangeGrid::Key(int64_t x, int64_t y)
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+
+
+pair<int64_t, int64_t> RangeGrid::Cell(const Point &point) const
+{
+	return {static_cast<int64_t>(floor(point.X() / cellSize)), static_cast<int64_t>(floor(point.Y() / cellSize))};
+}
@@ -0,0 +1,62 @@
+/* RangeGrid.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Point.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+
+// A grid of items that each reach everything within some range of their
+// position, such as ships with anti-missile systems, so that finding the ones
+// that can reach a given point only has to check those in nearby cells. Items
+// are numbered in the order they were added, and are always found in that
+// order, so that the result does not depend on where they are.
+class RangeGrid {
+public:
+	// Remove all the items.
+	void Clear();
+	// Add an item with the given position and range.
+	void Add(const Point &position, double range);
+	// Sort the items into cells. This must be done after adding them, and
+	// before looking for any.
+	void Finish();
+
+	bool Empty() const;
+	// Get the numbers of the items that can reach the given point, in the
+	// order that they were added.
+	const std::vector<int> &InRange(const Point &point);
+
+
+private:
+	static uint64_t Key(int64_t x, int64_t y);
+	std::pair<int64_t, int64_t> Cell(const Point &point) const;
+
+
+private:
+	std::vector<Point> positions;
+	std::vector<double> ranges;
+	// The cells are as wide as the longest range, so that any item that can
+	// reach a point is in the same cell as it or in one of the eight next to it.
+	double cellSize = 1.;
+	// The key of each item's cell, and the item's number, sorted by key.
+	std::vector<std::pair<uint64_t, int>> cells;
+	// The result of the last search.
+	std::vector<int> found;
+};
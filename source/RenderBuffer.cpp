@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "GameData.h"
 #include "GameWindow.h"
+#include "shader/GpuProfiler.h"
 #include "Logger.h"
 #include "Screen.h"
 #include "shader/Shader.h"
@@ -226,6 +227,7 @@ void RenderBuffer::Draw(const Point &position, const Point &clipsize, const Poin
 	}
 
 	glBindTexture(GL_TEXTURE_2D, texid);
+	GpuProfiler::CountTextureBind();
 
 	glUniform2f(sizeI, clipsize.X(), clipsize.Y());
 	glUniform2f(positionI, position.X(), position.Y());
@@ -242,6 +244,7 @@ void RenderBuffer::Draw(const Point &position, const Point &clipsize, const Poin
 	);
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	GpuProfiler::CountDrawCall();
 
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
@@ -24,30 +24,44 @@ using namespace std;
 // RoutePlan is a wrapper on DistanceMap that uses destination
 RoutePlan::RoutePlan(const System &center, const System &destination, const PlayerInfo *player)
 {
-	Init(DistanceMap(center, destination, player));
+	const DistanceMap distance(center, destination, player);
+	Init(distance, distance.destination);
 }
 
 
 
 RoutePlan::RoutePlan(const Ship &ship, const System &destination, const PlayerInfo *player)
 {
-	Init(DistanceMap(ship, destination, player));
+	const DistanceMap distance(ship, destination, player);
+	Init(distance, distance.destination);
 }
 
 
 
-void RoutePlan::Init(const DistanceMap &distance)
+// Take the route to the given destination from a map that was searched
+// without a destination.
+RoutePlan::RoutePlan(const DistanceMap &distance, const System &destination)
 {
-	auto it = distance.route.find(distance.destination);
-	if(it == distance.route.end())
+	// A search with a destination finds no route to the system it starts in.
+	if(&destination != distance.center)
+		Init(distance, &destination);
+}
+
+
+
+void RoutePlan::Init(const DistanceMap &distance, const System *destination)
+{
+	const RouteEdge *edge = distance.Find(destination);
+	if(!edge)
 		return;
 
 	hasRoute = true;
 
-	while(it->first != distance.center)
+	while(destination != distance.center)
 	{
-		plan.emplace_back(it->first, it->second);
-		it = distance.route.find(it->second.prev);
+		plan.emplace_back(destination, *edge);
+		destination = edge->prev;
+		edge = distance.Find(destination);
 	}
 }
 
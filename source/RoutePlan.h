@@ -33,6 +33,9 @@ public:
 	RoutePlan() = default;
 	RoutePlan(const System &center, const System &destination, const PlayerInfo *player = nullptr);
 	RoutePlan(const Ship &ship, const System &destination, const PlayerInfo *player = nullptr);
+	// Take the route to the given destination from a map that was searched
+	// without a destination.
+	RoutePlan(const DistanceMap &distance, const System &destination);
 
 	// Find out if the destination is reachable.
 	bool HasRoute() const;
@@ -51,7 +54,7 @@ public:
 
 private:
 	// Initializer for new RoutePlans.
-	void Init(const DistanceMap &distance);
+	void Init(const DistanceMap &distance, const System *destination);
 
 
 private:
@@ -0,0 +1,100 @@
+/* RouteTable.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "RouteTable.h"
+
+#include "DistanceMap.h"
+#include "GameData.h"
+#include "Hasher.h"
+#include "RoutePlan.h"
+#include "Ship.h"
+#include "ShipJumpNavigation.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+	// The most tables to keep at once. Each table is only a few tens of
+	// kilobytes, but there is one for every system that NPCs have left with
+	// each combination of capabilities, so this keeps the memory use bounded.
+	constexpr size_t MAX_TABLES = 2048;
+
+	// Invalidate() may be called from any thread, so it only marks the tables
+	// as out of date. They are thrown out on the next lookup.
+	atomic<unsigned> generation = 0;
+	unsigned tablesGeneration = 0;
+}
+
+
+
+// Get the route that the given NPC ship should take to the given system.
+RoutePlan RouteTable::Get(const Ship &ship, const System &destination)
+{
+	static mutex tablesMutex;
+	static unordered_map<Key, unique_ptr<DistanceMap>, Key::HashFunction> tables;
+
+	Key key;
+	key.jumpHash = ship.JumpNavigation().Hash();
+	key.personalityHash = 0;
+	Hasher::Hash(key.personalityHash, ship.GetGovernment());
+	Hasher::Hash(key.personalityHash, ship.GetPersonality().IsRestricted());
+	Hasher::Hash(key.personalityHash, ship.GetPersonality().IsUnrestricted());
+	Hasher::Hash(key.personalityHash, ship.IsSpecial());
+	// The routes could depend on the wormholes which this ship can travel
+	// through: the intersection of all known wormhole required attributes and
+	// the attributes which this ship satisfies.
+	const auto &shipAttributes = ship.Attributes();
+	for(const auto &requirement : GameData::UniverseWormholeRequirements())
+		if(shipAttributes.Get(requirement))
+			key.wormholeKeys.emplace_back(requirement);
+
+	lock_guard<mutex> lock(tablesMutex);
+	const unsigned currentGeneration = generation.load();
+	if(tablesGeneration != currentGeneration || tables.size() >= MAX_TABLES)
+	{
+		tables.clear();
+		tablesGeneration = currentGeneration;
+	}
+
+	auto it = tables.find(key);
+	if(it == tables.end())
+		it = tables.emplace(std::move(key), unique_ptr<DistanceMap>(new DistanceMap(ship))).first;
+	return RoutePlan(*it->second, destination);
+}
+
+
+
+// Forget every precomputed route. This must be done whenever the links
+// between systems, the wormholes, or travel restrictions may have changed.
+void RouteTable::Invalidate()
+{
+	++generation;
+}
+
+
+
+size_t RouteTable::Key::HashFunction::operator()(const Key &key) const
+{
+	size_t hash = 0;
+	Hasher::Hash(hash, key.jumpHash);
+	Hasher::Hash(hash, key.personalityHash);
+	for(const string &k : key.wormholeKeys)
+		Hasher::Hash(hash, k);
+	return hash;
+}
@@ -0,0 +1,62 @@
+/* RouteTable.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class RoutePlan;
+class Ship;
+class System;
+
+
+
+// Precomputed routes for NPC ships. Finding a route to a single destination
+// still takes a search of most of the map, so instead the routes from a system
+// to every other system are found at once, and shared by every NPC ship that
+// leaves that system with the same travel capabilities: the same drives and fuel
+// costs, the same travel restrictions, and access to the same wormholes. After
+// the first search, finding a route for any of those ships is a lookup. Player
+// ships only travel along routes the player knows, so they cannot use this.
+class RouteTable {
+public:
+	// Get the route that the given NPC ship should take to the given system.
+	static RoutePlan Get(const Ship &ship, const System &destination);
+
+	// Forget every precomputed route. This must be done whenever the links
+	// between systems, the wormholes, or travel restrictions may have changed.
+	static void Invalidate();
+
+
+private:
+	// The travel capabilities that a table of routes was found for.
+	class Key {
+	public:
+		bool operator==(const Key &other) const = default;
+
+		class HashFunction {
+		public:
+			size_t operator()(const Key &key) const;
+		};
+
+	public:
+		// This includes the system the routes start from.
+		size_t jumpHash;
+		size_t personalityHash;
+		std::vector<std::string> wormholeKeys;
+	};
+};
@@ -0,0 +1,244 @@
+/* SaveIndex.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SaveIndex.h"
+
+#include "DataFile.h"
+#include "DataNode.h"
+#include "DataWriter.h"
+#include "Files.h"
+
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <system_error>
+
+using namespace std;
+
+namespace {
+	// An entry, along with the state of the file that it was made from.
+	class Record {
+	public:
+		uint64_t size = 0;
+		int64_t timestamp = 0;
+		SaveIndex::Entry entry;
+	};
+
+	mutex indexMutex;
+	// The records of every indexed save, by file name.
+	map<string, Record> records;
+	bool isLoaded = false;
+
+	filesystem::path IndexPath()
+	{
+		return Files::Config() / "save index.txt";
+	}
+
+	// Get the size and timestamp of a save file. Returns false if it does not exist.
+	bool Stat(const filesystem::path &path, uint64_t &size, int64_t &timestamp)
+	{
+		error_code error;
+		size = filesystem::file_size(path, error);
+		if(error)
+			return false;
+		timestamp = Files::Timestamp(path).time_since_epoch().count();
+		return true;
+	}
+
+	// Read the index file, the first time that it is needed.
+	void LoadIndex()
+	{
+		if(isLoaded)
+			return;
+		isLoaded = true;
+
+		const filesystem::path path = IndexPath();
+		if(!Files::Exists(path))
+			return;
+		DataFile file(path);
+		for(const DataNode &node : file)
+		{
+			if(node.Token(0) != "save" || node.Size() < 4)
+				continue;
+			// The size and timestamp are read from their text, since a timestamp
+			// has more digits than the double that DataNode::Value() returns.
+			Record &record = records[node.Token(1)];
+			record.size = strtoull(node.Token(2).c_str(), nullptr, 10);
+			record.timestamp = strtoll(node.Token(3).c_str(), nullptr, 10);
+			SaveIndex::Entry &entry = record.entry;
+			for(const DataNode &child : node)
+			{
+				const string &key = child.Token(0);
+				const bool hasValue = child.Size() >= 2;
+				if(key == "pilot" && child.Size() >= 3)
+				{
+					entry.firstName = child.Token(1);
+					entry.lastName = child.Token(2);
+				}
+				else if(key == "date" && child.Size() >= 4)
+				{
+					entry.day = child.Value(1);
+					entry.month = child.Value(2);
+					entry.year = child.Value(3);
+				}
+				else if(key == "system" && hasValue)
+					entry.system = child.Token(1);
+				else if(key == "planet" && hasValue)
+					entry.planet = child.Token(1);
+				else if(key == "playtime" && hasValue)
+					entry.playTime = child.Value(1);
+				else if(key == "credits" && hasValue)
+					entry.credits = child.Value(1);
+				else if(key == "ship" && child.Size() >= 3)
+				{
+					entry.shipName = child.Token(1);
+					entry.shipSprite = child.Token(2);
+				}
+			}
+		}
+	}
+
+	void SaveIndexFile()
+	{
+		DataWriter out;
+		for(const auto &[name, record] : records)
+		{
+			const SaveIndex::Entry &entry = record.entry;
+			out.Write("save", name, to_string(record.size), to_string(record.timestamp));
+			out.BeginChild();
+			{
+				out.Write("pilot", entry.firstName, entry.lastName);
+				out.Write("date", entry.day, entry.month, entry.year);
+				if(!entry.system.empty())
+					out.Write("system", entry.system);
+				if(!entry.planet.empty())
+					out.Write("planet", entry.planet);
+				out.Write("playtime", entry.playTime);
+				out.Write("credits", entry.credits);
+				if(!entry.shipName.empty() || !entry.shipSprite.empty())
+					out.Write("ship", entry.shipName, entry.shipSprite);
+			}
+			out.EndChild();
+		}
+
+		// Write through a temporary file, so that a partly written index is never read.
+		filesystem::path temporary = IndexPath();
+		temporary += ".tmp";
+		out.SaveToPath(temporary);
+		Files::Move(temporary, IndexPath());
+	}
+}
+
+
+
+bool SaveIndex::Find(const filesystem::path &path, Entry &entry)
+{
+	uint64_t size;
+	int64_t timestamp;
+	if(!Stat(path, size, timestamp))
+		return false;
+
+	lock_guard<mutex> lock(indexMutex);
+	LoadIndex();
+	auto it = records.find(Files::Name(path));
+	if(it == records.end() || it->second.size != size || it->second.timestamp != timestamp)
+		return false;
+
+	entry = it->second.entry;
+	return true;
+}
+
+
+
+SaveIndex::Entry SaveIndex::Read(const DataFile &file)
+{
+	Entry entry;
+	int flagshipIndex = 0;
+	int shipIndex = -1;
+	for(const DataNode &node : file)
+	{
+		const string &key = node.Token(0);
+		const bool hasValue = node.Size() >= 2;
+		if(key == "pilot" && node.Size() >= 3)
+		{
+			entry.firstName = node.Token(1);
+			entry.lastName = node.Token(2);
+		}
+		else if(key == "date" && node.Size() >= 4)
+		{
+			entry.day = node.Value(1);
+			entry.month = node.Value(2);
+			entry.year = node.Value(3);
+		}
+		else if(key == "system" && hasValue)
+			entry.system = node.Token(1);
+		else if(key == "planet" && hasValue)
+			entry.planet = node.Token(1);
+		else if(key == "playtime" && hasValue)
+			entry.playTime = node.Value(1);
+		else if(key == "flagship index" && hasValue)
+			flagshipIndex = node.Value(1);
+		else if(key == "account")
+		{
+			for(const DataNode &child : node)
+				if(child.Token(0) == "credits" && child.Size() >= 2)
+				{
+					entry.credits = child.Value(1);
+					break;
+				}
+		}
+		else if(key == "ship" && ++shipIndex == flagshipIndex)
+		{
+			for(const DataNode &child : node)
+			{
+				const string &childKey = child.Token(0);
+				if(childKey == "name" && child.Size() >= 2)
+					entry.shipName = child.Token(1);
+				else if(childKey == "sprite" && child.Size() >= 2)
+					entry.shipSprite = child.Token(1);
+			}
+		}
+	}
+	return entry;
+}
+
+
+
+void SaveIndex::Update(const filesystem::path &path, const Entry &entry)
+{
+	Record record;
+	if(!Stat(path, record.size, record.timestamp))
+		return;
+	record.entry = entry;
+
+	lock_guard<mutex> lock(indexMutex);
+	LoadIndex();
+	records[Files::Name(path)] = std::move(record);
+	SaveIndexFile();
+}
+
+
+
+void SaveIndex::Move(const filesystem::path &from, const filesystem::path &to)
+{
+	lock_guard<mutex> lock(indexMutex);
+	LoadIndex();
+	auto it = records.find(Files::Name(from));
+	if(it == records.end())
+		return;
+
+	records[Files::Name(to)] = std::move(it->second);
+	records.erase(Files::Name(from));
+}
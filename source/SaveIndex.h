@@ -0,0 +1,60 @@
+/* SaveIndex.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+class DataFile;
+
+
+
+// An index of the few details of each saved game that the load panel shows, so
+// that a save does not need to be parsed just to preview it. The index is kept
+// in a single small file in the config folder, and is updated whenever the game
+// is saved. Each entry also holds the size and timestamp of its save file, and
+// is ignored once the file no longer matches them, for example because it was
+// edited or copied into a new snapshot. All of these functions are thread-safe.
+class SaveIndex {
+public:
+	// The details of one saved game, as they are stored in the file.
+	class Entry {
+	public:
+		std::string firstName;
+		std::string lastName;
+		int day = 0;
+		int month = 0;
+		int year = 0;
+		std::string system;
+		std::string planet;
+		double playTime = 0.;
+		int64_t credits = 0;
+		std::string shipName;
+		std::string shipSprite;
+	};
+
+
+public:
+	// Get the entry for the given save file, if there is one that is up to date.
+	static bool Find(const std::filesystem::path &path, Entry &entry);
+	// Read the details of a save from its contents.
+	static Entry Read(const DataFile &file);
+	// Record the details of the given save file, as it is on disk now.
+	static void Update(const std::filesystem::path &path, const Entry &entry);
+	// Keep the entry of a save file that has been renamed.
+	static void Move(const std::filesystem::path &from, const std::filesystem::path &to);
+};
@@ -16,11 +16,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SavedGame.h"
 
 #include "DataFile.h"
-#include "DataNode.h"
 #include "Date.h"
 #include "text/Format.h"
 #include "GameData.h"
 #include "Planet.h"
+#include "SaveIndex.h"
 #include "image/SpriteSet.h"
 #include "System.h"
 
@@ -38,61 +38,42 @@ SavedGame::SavedGame(const filesystem::path &path)
 void SavedGame::Load(const filesystem::path &path)
 {
 	Clear();
-	DataFile file(path);
-	if(file.begin() != file.end())
-		this->path = path;
 
-	int flagshipIterator = -1;
-	int flagshipTarget = 0;
-
-	for(const DataNode &node : file)
+	// Only parse the save itself if the index has no up to date entry for it.
+	SaveIndex::Entry entry;
+	if(!SaveIndex::Find(path, entry))
+	{
+		DataFile file(path);
+		if(file.begin() == file.end())
+			return;
+		entry = SaveIndex::Read(file);
+		SaveIndex::Update(path, entry);
+	}
+	this->path = path;
+
+	if(!entry.firstName.empty() || !entry.lastName.empty())
+		name = entry.firstName + " " + entry.lastName;
+	if(entry.year)
+		date = Date(entry.day, entry.month, entry.year).ToString();
+	system = entry.system;
+	const System *savedSystem = GameData::Systems().Find(system);
+	if(savedSystem && savedSystem->IsValid())
+	{
+		system = savedSystem->DisplayName();
+		startingSystem = savedSystem;
+	}
+	planet = entry.planet;
+	const Planet *savedPlanet = GameData::Planets().Find(planet);
+	if(savedPlanet && savedPlanet->IsValid())
 	{
-		const string &key = node.Token(0);
-		bool hasValue = node.Size() >= 2;
-		if(key == "pilot" && node.Size() >= 3)
-			name = node.Token(1) + " " + node.Token(2);
-		else if(key == "date" && node.Size() >= 4)
-			date = Date(node.Value(1), node.Value(2), node.Value(3)).ToString();
-		else if(key == "system" && hasValue)
-		{
-			system = node.Token(1);
-			const System *savedSystem = GameData::Systems().Find(system);
-			if(savedSystem && savedSystem->IsValid())
-				system = savedSystem->DisplayName();
-		}
-		else if(key == "planet" && hasValue)
-		{
-			planet = node.Token(1);
-			const Planet *savedPlanet = GameData::Planets().Find(planet);
-			if(savedPlanet && savedPlanet->IsValid())
-				planet = savedPlanet->DisplayName();
-		}
-		else if(key == "playtime" && hasValue)
-			playTime = Format::PlayTime(node.Value(1));
-		else if(key == "flagship index" && hasValue)
-			flagshipTarget = node.Value(1);
-		else if(key == "account")
-		{
-			for(const DataNode &child : node)
-				if(child.Token(0) == "credits" && child.Size() >= 2)
-				{
-					credits = Format::AbbreviatedNumber(child.Value(1));
-					break;
-				}
-		}
-		else if(key == "ship" && ++flagshipIterator == flagshipTarget)
-		{
-			for(const DataNode &child : node)
-			{
-				const string &childKey = child.Token(0);
-				bool childHasValue = child.Size() >= 2;
-				if(childKey == "name" && childHasValue)
-					shipName = child.Token(1);
-				else if(childKey == "sprite" && childHasValue)
-					shipSprite = SpriteSet::Get(child.Token(1));
-			}
-		}
+		planet = savedPlanet->DisplayName();
+		startingPlanet = savedPlanet;
 	}
+	playTime = Format::PlayTime(entry.playTime);
+	credits = Format::AbbreviatedNumber(entry.credits);
+	shipName = entry.shipName;
+	if(!entry.shipSprite.empty())
+		shipSprite = SpriteSet::Get(entry.shipSprite);
 }
 
 
@@ -122,6 +103,8 @@ void SavedGame::Clear()
 	system.clear();
 	planet.clear();
 	playTime = "0s";
+	startingSystem = nullptr;
+	startingPlanet = nullptr;
 
 	shipSprite = nullptr;
 	shipName.clear();
@@ -171,6 +154,20 @@ const string &SavedGame::GetPlayTime() const
 
 
 
+const System *SavedGame::StartingSystem() const
+{
+	return startingSystem;
+}
+
+
+
+const Planet *SavedGame::StartingPlanet() const
+{
+	return startingPlanet;
+}
+
+
+
 const Sprite *SavedGame::ShipSprite() const
 {
 	return shipSprite;
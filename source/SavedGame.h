@@ -18,7 +18,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <filesystem>
 #include <string>
 
+class Planet;
 class Sprite;
+class System;
 
 
 
@@ -44,6 +46,9 @@ public:
 	const std::string &GetSystem() const;
 	const std::string &GetPlanet() const;
 	const std::string &GetPlayTime() const;
+	// The system and planet that the pilot is in, if they exist.
+	const System *StartingSystem() const;
+	const Planet *StartingPlanet() const;
 
 	const Sprite *ShipSprite() const;
 	const std::string &ShipName() const;
@@ -59,6 +64,8 @@ private:
 	std::string system;
 	std::string planet;
 	std::string playTime;
+	const System *startingSystem = nullptr;
+	const Planet *startingPlanet = nullptr;
 
 	const Sprite *shipSprite = nullptr;
 	std::string shipName;
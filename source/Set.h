@@ -15,26 +15,41 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 
 // Template representing a set of named objects of a given type, where you can
 // query it for a pointer to any object and it will return one, whether or not that
-// object has been loaded yet. (This allows cyclic pointers.)
+// object has been loaded yet. (This allows cyclic pointers.) The objects are
+// stored in a map, so that pointers to them stay valid and iterating over them
+// visits them in order of their names, but looking them up by name goes through
+// a hash table instead of comparing the name to log(n) other names.
 template<class Type>
 class Set {
 public:
+	Set() = default;
+	// The hash index refers to the objects of this set, so copying it must
+	// rebuild the index. A moved map keeps its nodes, so moving does not.
+	Set(const Set &other) : data(other.data) { Reindex(); }
+	Set &operator=(const Set &other);
+	Set(Set &&) noexcept = default;
+	Set &operator=(Set &&) noexcept = default;
+
 	// Allow non-const access to the owner of this set; it can hand off only
 	// const references to avoid anyone else modifying the objects.
-	Type *Get(const std::string &name) { return &data[name]; }
-	const Type *Get(const std::string &name) const { return &data[name]; }
+	Type *Get(const std::string &name) { return const_cast<Type *>(std::as_const(*this).Get(name)); }
+	const Type *Get(const std::string &name) const;
 	// If an item already exists in this set, get it. Otherwise, return a null
 	// pointer rather than creating the item.
-	const Type *Find(const std::string &name) const;
+	const Type *Find(const std::string &name) const { return Lookup(name, std::hash<std::string>{}(name)); }
 
-	bool Has(const std::string &name) const { return data.contains(name); }
+	bool Has(const std::string &name) const { return Find(name) != nullptr; }
 
 	typename std::map<std::string, Type>::iterator begin() { return data.begin(); }
 	typename std::map<std::string, Type>::const_iterator begin() const { return data.begin(); }
@@ -49,17 +64,56 @@ public:
 	void Revert(const Set<Type> &other);
 
 
+private:
+	// An entry of the hash index, which uses open addressing with linear probing.
+	// Each entry points at the name and object stored in the map, so the names
+	// are not copied. Entries without a name are empty.
+	class Entry {
+	public:
+		size_t hash = 0;
+		const std::string *name = nullptr;
+		Type *value = nullptr;
+	};
+
+	Type *Lookup(const std::string &name, size_t hash) const;
+	void AddToIndex(const std::string &name, Type &value, size_t hash) const;
+	void Reindex() const;
+
+
 private:
 	mutable std::map<std::string, Type> data;
+	// The number of entries in the index is always a power of two, and at
+	// least twice the number of objects, so that probe sequences stay short.
+	mutable std::vector<Entry> index;
 };
 
 
 
 template<class Type>
-const Type *Set<Type>::Find(const std::string &name) const
+Set<Type> &Set<Type>::operator=(const Set &other)
+{
+	if(this != &other)
+	{
+		data = other.data;
+		Reindex();
+	}
+	return *this;
+}
+
+
+
+template<class Type>
+const Type *Set<Type>::Get(const std::string &name) const
 {
-	auto it = data.find(name);
-	return (it == data.end() ? nullptr : &it->second);
+	const size_t hash = std::hash<std::string>{}(name);
+	Type *value = Lookup(name, hash);
+	if(!value)
+	{
+		auto it = data.try_emplace(name).first;
+		value = &it->second;
+		AddToIndex(it->first, *value, hash);
+	}
+	return value;
 }
 
 
@@ -86,4 +140,61 @@ void Set<Type>::Revert(const Set<Type> &other)
 		// There should never be a case when an entry in the set we are
 		// reverting to has a name that is not also in this set.
 	}
+	// Some of the indexed objects may have been erased.
+	Reindex();
+}
+
+
+
+template<class Type>
+Type *Set<Type>::Lookup(const std::string &name, size_t hash) const
+{
+	if(index.empty())
+		return nullptr;
+
+	const size_t mask = index.size() - 1;
+	for(size_t i = hash & mask; index[i].name; i = (i + 1) & mask)
+		if(index[i].hash == hash && *index[i].name == name)
+			return index[i].value;
+	return nullptr;
+}
+
+
+
+template<class Type>
+void Set<Type>::AddToIndex(const std::string &name, Type &value, size_t hash) const
+{
+	// The object has already been added to the map, so it is counted in its size.
+	if(index.size() < 2 * data.size())
+	{
+		Reindex();
+		return;
+	}
+
+	const size_t mask = index.size() - 1;
+	size_t i = hash & mask;
+	while(index[i].name)
+		i = (i + 1) & mask;
+	index[i] = {hash, &name, &value};
+}
+
+
+
+template<class Type>
+void Set<Type>::Reindex() const
+{
+	size_t capacity = 16;
+	while(capacity < 2 * data.size())
+		capacity *= 2;
+	index.assign(data.empty() ? 0 : capacity, {});
+
+	const size_t mask = capacity - 1;
+	for(auto &[name, value] : data)
+	{
+		const size_t hash = std::hash<std::string>{}(name);
+		size_t i = hash & mask;
+		while(index[i].name)
+			i = (i + 1) & mask;
+		index[i] = {hash, &name, &value};
+	}
 }
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Ship.h"
 
+#include "AttributeKey.h"
 #include "audio/Audio.h"
 #include "CategoryList.h"
 #include "CategoryType.h"
@@ -233,7 +234,7 @@ Ship::Ship(const DataNode &node, const ConditionsStore *playerConditions)
 void Ship::Load(const DataNode &node, const ConditionsStore *playerConditions)
 {
 	if(node.Size() >= 2)
-		trueModelName = node.Token(1);
+		SetTrueModelName(node.Token(1));
 	if(node.Size() >= 3)
 	{
 		base = GameData::Ships().Get(trueModelName);
@@ -285,11 +286,11 @@ void Ship::Load(const DataNode &node, const ConditionsStore *playerConditions)
 		else if(key == "attributes" || add)
 		{
 			if(!add)
-				baseAttributes.Load(child, playerConditions);
+				MutableBaseAttributes().Load(child, playerConditions);
 			else
 			{
 				addAttributes = true;
-				attributes.Load(child, playerConditions);
+				MutableAttributes().Load(child, playerConditions);
 			}
 		}
 		else if((key == "engine" || key == "reverse engine" || key == "steering engine") && child.Size() >= 3)
@@ -525,14 +526,14 @@ void Ship::Load(const DataNode &node, const ConditionsStore *playerConditions)
 		{
 			if(!hasOutfits)
 			{
-				outfits.clear();
+				MutableOutfits().clear();
 				hasOutfits = true;
 			}
 			for(const DataNode &grand : child)
 			{
 				int count = (grand.Size() >= 2) ? grand.Value(1) : 1;
 				if(count > 0)
-					outfits[GameData::Outfits().Get(grand.Token(0))] += count;
+					MutableOutfits()[GameData::Outfits().Get(grand.Token(0))] += count;
 				else
 					grand.PrintTrace("Skipping invalid outfit count:");
 			}
@@ -542,8 +543,8 @@ void Ship::Load(const DataNode &node, const ConditionsStore *playerConditions)
 			if(!hasArmament)
 				for(const auto &pair : GetEquipped(Weapons()))
 				{
-					auto it = outfits.find(pair.first);
-					if(it == outfits.end() || it->second < pair.second)
+					auto it = outfits->find(pair.first);
+					if(it == outfits->end() || it->second < pair.second)
 					{
 						armament.UninstallAll();
 						break;
@@ -645,7 +646,7 @@ void Ship::FinishLoading(bool isNewInstance)
 			static_cast<Body &>(*this) = *base;
 		if(customSwizzleName.empty())
 			customSwizzleName = base->CustomSwizzleName();
-		if(baseAttributes.Attributes().empty())
+		if(baseAttributes->Attributes().empty())
 			baseAttributes = base->baseAttributes;
 		if(bays.empty() && !base->bays.empty() && !removeBays)
 			bays = base->bays;
@@ -662,9 +663,13 @@ void Ship::FinishLoading(bool isNewInstance)
 		}
 		if(finalExplosions.empty())
 			finalExplosions = base->finalExplosions;
-		const bool inheritsOutfits = outfits.empty();
+		const bool inheritsOutfits = outfits->empty();
 		if(inheritsOutfits)
 			outfits = base->outfits;
+		// Most saved ships, and fighters in particular, still have the outfits
+		// of their model, so share the model's list rather than keeping a copy.
+		else if(outfits != base->outfits && *outfits == *base->outfits)
+			outfits = base->outfits;
 		if(description.IsEmpty())
 			description = base->description;
 
@@ -719,8 +724,8 @@ void Ship::FinishLoading(bool isNewInstance)
 	auto equipped = GetEquipped(Weapons());
 	for(auto &it : equipped)
 	{
-		auto outfitIt = outfits.find(it.first);
-		int amount = (outfitIt != outfits.end() ? outfitIt->second : 0);
+		auto outfitIt = outfits->find(it.first);
+		int amount = (outfitIt != outfits->end() ? outfitIt->second : 0);
 		int excess = it.second - amount;
 		if(excess > 0)
 		{
@@ -742,31 +747,34 @@ void Ship::FinishLoading(bool isNewInstance)
 
 	// Mark any drone that has no "automaton" value as an automaton, to
 	// grandfather in the drones from before that attribute existed.
-	if(baseAttributes.Category() == "Drone" && !baseAttributes.Get("automaton"))
-		baseAttributes.Set("automaton", 1.);
+	if(baseAttributes->Category() == "Drone" && !baseAttributes->Get("automaton"))
+		MutableBaseAttributes().Set("automaton", 1.);
 
-	baseAttributes.Set("gun ports", armament.GunCount());
-	baseAttributes.Set("turret mounts", armament.TurretCount());
+	// Only copy the shared base attributes if the hardpoints differ from the model's.
+	if(baseAttributes->Get("gun ports") != armament.GunCount())
+		MutableBaseAttributes().Set("gun ports", armament.GunCount());
+	if(baseAttributes->Get("turret mounts") != armament.TurretCount())
+		MutableBaseAttributes().Set("turret mounts", armament.TurretCount());
 
 	if(addAttributes)
 	{
 		// Store attributes from an "add attributes" node in the ship's
 		// baseAttributes so they can be written to the save file.
-		baseAttributes.Add(attributes);
-		baseAttributes.AddLicenses(attributes);
+		MutableBaseAttributes().Add(*attributes);
+		MutableBaseAttributes().AddLicenses(*attributes);
 		addAttributes = false;
 	}
 	// Add the attributes of all your outfits to the ship's base attributes.
-	attributes = baseAttributes;
+	attributes = make_shared<Outfit>(*baseAttributes);
 	vector<string> undefinedOutfits;
-	for(const auto &it : outfits)
+	for(const auto &it : *outfits)
 	{
 		if(!it.first->IsDefined())
 		{
 			undefinedOutfits.emplace_back("\"" + it.first->TrueName() + "\"");
 			continue;
 		}
-		attributes.Add(*it.first, it.second);
+		attributes->Add(*it.first, it.second);
 		// Some ship variant definitions do not specify which weapons
 		// are placed in which hardpoint. Add any weapons that are not
 		// yet installed to the ship's armament.
@@ -828,7 +836,7 @@ void Ship::FinishLoading(bool isNewInstance)
 			Logger::Log(warning, Logger::Level::WARNING);
 		}
 	}
-	cargo.SetSize(attributes.Get("cargo space"));
+	cargo.SetSize(attributes->Get("cargo space"));
 	armament.FinishLoading();
 
 	// Figure out how far from center the farthest hardpoint is.
@@ -863,26 +871,28 @@ void Ship::FinishLoading(bool isNewInstance)
 		if(bay.side == Bay::INSIDE && bay.launchEffects.empty() && Crew())
 			bay.launchEffects.emplace_back(GameData::Effects().Get("basic launch"));
 	}
+	CountBays();
 
-	canBeCarried = bayCategories.Contains(attributes.Category());
+	canBeCarried = bayCategories.Contains(attributes->Category());
 
 	// Issue warnings if this ship has is misconfigured, e.g. is missing required values
 	// or has negative outfit, cargo, weapon, or engine capacity.
 	for(auto &&attr : set<string>{"outfit space", "cargo space", "weapon capacity", "engine capacity"})
 	{
-		double val = attributes.Get(attr);
+		double val = attributes->Get(attr);
 		if(val < 0)
 			warning += attr + ": " + Format::Number(val) + "\n";
 	}
-	if(attributes.Get("drag") <= 0.)
+	if(attributes->Get("drag") <= 0.)
 	{
-		warning += "Defaulting " + string(attributes.Get("drag") ? "invalid" : "missing") + " \"drag\" attribute to 100.0\n";
-		attributes.Set("drag", 100.);
+		warning += "Defaulting " + string(attributes->Get("drag") ? "invalid" : "missing") + " \"drag\" attribute to 100.0\n";
+		MutableAttributes().Set("drag", 100.);
 	}
 
-	// Calculate the values used to determine this ship's value and danger.
-	attraction = CalculateAttraction();
-	deterrence = CalculateDeterrence();
+	// The values used to determine this ship's value and danger are calculated
+	// once they are needed, which for most ships is never.
+	attractionIsStale = true;
+	deterrenceIsStale = true;
 
 	if(!warning.empty())
 	{
@@ -891,7 +901,7 @@ void Ship::FinishLoading(bool isNewInstance)
 		string message = (!givenName.empty() ? "Ship \"" + givenName + "\" " : "") + "(" + VariantName() + "):\n";
 		ostringstream outfitNames;
 		outfitNames << "has outfits:\n";
-		for(const auto &it : outfits)
+		for(const auto &it : *outfits)
 			outfitNames << '\t' << it.second << " " + it.first->TrueName() << endl;
 		Logger::Log(message + warning + outfitNames.str(), Logger::Level::WARNING);
 	}
@@ -940,7 +950,7 @@ void Ship::FinishLoading(bool isNewInstance)
 // Check if this ship (model) and its outfits have been defined.
 bool Ship::IsValid() const
 {
-	for(auto &&outfit : outfits)
+	for(auto &&outfit : *outfits)
 		if(!outfit.first->IsDefined())
 			return false;
 
@@ -978,57 +988,57 @@ void Ship::Save(DataWriter &out) const
 		out.Write("attributes");
 		out.BeginChild();
 		{
-			out.Write("category", baseAttributes.Category());
-			out.Write("cost", baseAttributes.Cost());
-			out.Write("mass", baseAttributes.Mass());
-			for(const auto &it : baseAttributes.FlareSprites())
+			out.Write("category", baseAttributes->Category());
+			out.Write("cost", baseAttributes->Cost());
+			out.Write("mass", baseAttributes->Mass());
+			for(const auto &it : baseAttributes->FlareSprites())
 				for(int i = 0; i < it.second; ++i)
 					it.first.SaveSprite(out, "flare sprite");
-			for(const auto &it : baseAttributes.FlareSounds())
+			for(const auto &it : baseAttributes->FlareSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("flare sound", it.first->Name());
-			for(const auto &it : baseAttributes.ReverseFlareSprites())
+			for(const auto &it : baseAttributes->ReverseFlareSprites())
 				for(int i = 0; i < it.second; ++i)
 					it.first.SaveSprite(out, "reverse flare sprite");
-			for(const auto &it : baseAttributes.ReverseFlareSounds())
+			for(const auto &it : baseAttributes->ReverseFlareSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("reverse flare sound", it.first->Name());
-			for(const auto &it : baseAttributes.SteeringFlareSprites())
+			for(const auto &it : baseAttributes->SteeringFlareSprites())
 				for(int i = 0; i < it.second; ++i)
 					it.first.SaveSprite(out, "steering flare sprite");
-			for(const auto &it : baseAttributes.SteeringFlareSounds())
+			for(const auto &it : baseAttributes->SteeringFlareSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("steering flare sound", it.first->Name());
-			for(const auto &it : baseAttributes.AfterburnerEffects())
+			for(const auto &it : baseAttributes->AfterburnerEffects())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("afterburner effect", it.first->TrueName());
-			for(const auto &[effect, amount] : baseAttributes.JumpEffects())
+			for(const auto &[effect, amount] : baseAttributes->JumpEffects())
 				out.Write("jump effect", effect->TrueName(), amount);
-			for(const auto &it : baseAttributes.JumpSounds())
+			for(const auto &it : baseAttributes->JumpSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump sound", it.first->Name());
-			for(const auto &it : baseAttributes.JumpInSounds())
+			for(const auto &it : baseAttributes->JumpInSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump in sound", it.first->Name());
-			for(const auto &it : baseAttributes.JumpOutSounds())
+			for(const auto &it : baseAttributes->JumpOutSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump out sound", it.first->Name());
-			for(const auto &it : baseAttributes.HyperSounds())
+			for(const auto &it : baseAttributes->HyperSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("hyperdrive sound", it.first->Name());
-			for(const auto &it : baseAttributes.HyperInSounds())
+			for(const auto &it : baseAttributes->HyperInSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("hyperdrive in sound", it.first->Name());
-			for(const auto &it : baseAttributes.HyperOutSounds())
+			for(const auto &it : baseAttributes->HyperOutSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("hyperdrive out sound", it.first->Name());
-			for(const auto &it : baseAttributes.CargoScanSounds())
+			for(const auto &it : baseAttributes->CargoScanSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("cargo scan sound", it.first->Name());
-			for(const auto &it : baseAttributes.OutfitScanSounds())
+			for(const auto &it : baseAttributes->OutfitScanSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("outfit scan sound", it.first->Name());
-			for(const auto &it : baseAttributes.Attributes())
+			for(const auto &it : baseAttributes->Attributes())
 				if(it.second)
 					out.Write(it.first, it.second);
 		}
@@ -1038,7 +1048,7 @@ void Ship::Save(DataWriter &out) const
 		out.BeginChild();
 		{
 			using OutfitElement = pair<const Outfit *const, int>;
-			WriteSorted(outfits,
+			WriteSorted(*outfits,
 				[](const OutfitElement *lhs, const OutfitElement *rhs)
 					{ return lhs->first->TrueName() < rhs->first->TrueName(); },
 				[&out](const OutfitElement &it)
@@ -1216,6 +1226,9 @@ void Ship::SetGivenName(const string &name)
 void Ship::SetTrueModelName(const string &model)
 {
 	this->trueModelName = model;
+	displayModelNameTranslation = Translation::Handle("ship.name.", model);
+	pluralModelNameTranslation = Translation::Handle("ship.plural.", model);
+	descriptionTranslation = Translation::Handle("ship.desc.", model);
 }
 
 
@@ -1241,16 +1254,16 @@ const string &Ship::PluralModelName() const
 
 
 
-string Ship::TranslatedDisplayModelName() const
+const string &Ship::TranslatedDisplayModelName() const
 {
-	return Translation::TrShipName(trueModelName, displayModelName);
+	return displayModelNameTranslation.Get(displayModelName);
 }
 
 
 
-string Ship::TranslatedPluralModelName() const
+const string &Ship::TranslatedPluralModelName() const
 {
-	return Translation::TrShipPluralName(trueModelName, pluralModelName);
+	return pluralModelNameTranslation.Get(pluralModelName);
 }
 
 
@@ -1290,7 +1303,8 @@ string Ship::Description() const
 
 string Ship::TranslatedDescription() const
 {
-	return Translation::TrShipDescription(trueModelName, description.ToString());
+	const string *translation = descriptionTranslation.Get();
+	return translation ? *translation : description.ToString();
 }
 
 
@@ -1306,7 +1320,7 @@ const Sprite *Ship::Thumbnail() const
 // Get this ship's cost.
 int64_t Ship::Cost() const
 {
-	return attributes.Cost();
+	return attributes->Cost();
 }
 
 
@@ -1314,7 +1328,7 @@ int64_t Ship::Cost() const
 // Get the cost of this ship's chassis, with no outfits installed.
 int64_t Ship::ChassisCost() const
 {
-	return baseAttributes.Cost();
+	return baseAttributes->Cost();
 }
 
 
@@ -1328,6 +1342,11 @@ int64_t Ship::Strength() const
 
 double Ship::Attraction() const
 {
+	if(attractionIsStale)
+	{
+		attraction = CalculateAttraction();
+		attractionIsStale = false;
+	}
 	return attraction;
 }
 
@@ -1335,6 +1354,11 @@ double Ship::Attraction() const
 
 double Ship::Deterrence() const
 {
+	if(deterrenceIsStale)
+	{
+		deterrence = CalculateDeterrence();
+		deterrenceIsStale = false;
+	}
 	return deterrence;
 }
 
@@ -1346,25 +1370,25 @@ vector<string> Ship::FlightCheck() const
 {
 	auto checks = vector<string>{};
 
-	double generation = attributes.Get("energy generation") - attributes.Get("energy consumption");
-	double consuming = attributes.Get("fuel energy");
-	double solar = attributes.Get("solar collection");
-	double battery = attributes.Get("energy capacity");
+	double generation = attributes->Get("energy generation") - attributes->Get("energy consumption");
+	double consuming = attributes->Get("fuel energy");
+	double solar = attributes->Get("solar collection");
+	double battery = attributes->Get("energy capacity");
 	double energy = generation + consuming + solar + battery;
-	double fuelChange = attributes.Get("fuel generation") - attributes.Get("fuel consumption");
-	double fuelCapacity = attributes.Get("fuel capacity");
+	double fuelChange = attributes->Get("fuel generation") - attributes->Get("fuel consumption");
+	double fuelCapacity = attributes->Get("fuel capacity");
 	double fuel = fuelCapacity + fuelChange;
-	double thrust = attributes.Get("thrust");
-	double reverseThrust = attributes.Get("reverse thrust");
-	double afterburner = attributes.Get("afterburner thrust");
-	double thrustEnergy = attributes.Get("thrusting energy");
-	double thrustHeat = attributes.Get("thrusting heat");
-	double turn = attributes.Get("turn");
-	double turnEnergy = attributes.Get("turning energy");
-	double turnHeat = attributes.Get("turning heat");
+	double thrust = attributes->Get("thrust");
+	double reverseThrust = attributes->Get("reverse thrust");
+	double afterburner = attributes->Get("afterburner thrust");
+	double thrustEnergy = attributes->Get("thrusting energy");
+	double thrustHeat = attributes->Get("thrusting heat");
+	double turn = attributes->Get("turn");
+	double turnEnergy = attributes->Get("turning energy");
+	double turnHeat = attributes->Get("turning heat");
 	double hyperDrive = navigation.HasHyperdrive();
 	double jumpDrive = navigation.HasJumpDrive();
-	int bunks = attributes.Get("bunks");
+	int bunks = attributes->Get("bunks");
 
 	// Report the first error condition that will prevent takeoff:
 	if(!bunks && RequiredCrew())
@@ -1408,7 +1432,7 @@ vector<string> Ship::FlightCheck() const
 			if(fuelCapacity < navigation.JumpFuel())
 				checks.emplace_back("no fuel?");
 		}
-		for(const auto &it : outfits)
+		for(const auto &it : *outfits)
 		{
 			const Weapon *weapon = it.first->GetWeapon().get();
 			if(weapon && weapon->FiringEnergy() > energy)
@@ -1775,12 +1799,12 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 	// eject any ships still docked, possibly destroying them in the process.
 	bool ejecting = IsDestroyed();
 	if(!ejecting && (!commands.Has(Command::DEPLOY) || zoom != 1.f || hyperspaceCount ||
-			(cloak && !attributes.Get("cloaked deployment"))))
+			(cloak && !attributes->Get("cloaked deployment"))))
 		return;
 
 	for(Bay &bay : bays)
 		if(bay.ship
-			&& ((bay.ship->Commands().Has(Command::DEPLOY) && !Random::Int(40 + 20 * !bay.ship->attributes.Get("automaton")))
+			&& ((bay.ship->Commands().Has(Command::DEPLOY) && !Random::Int(40 + 20 * !bay.ship->attributes->Get("automaton")))
 			|| (ejecting && !Random::Int(6))))
 		{
 			// Resupply any ships launching of their own accord.
@@ -1806,7 +1830,7 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 
 				// This ship will refuel naturally based on the carrier's fuel
 				// collection, but the carrier may have some reserves to spare.
-				double maxFuel = bay.ship->attributes.Get("fuel capacity");
+				double maxFuel = bay.ship->attributes->Get("fuel capacity");
 				if(maxFuel)
 				{
 					double spareFuel = fuel - navigation.JumpFuel();
@@ -1842,6 +1866,7 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 				visuals.emplace_back(*effect, exitPoint, velocity, launchAngle);
 
 			bay.ship.reset();
+			++GetBayCount(bay.category)->free;
 		}
 }
 
@@ -1886,7 +1911,7 @@ shared_ptr<Ship> Ship::Board(bool autoPlunder, bool nonDocking)
 		if(victim->Attributes().Get("energy capacity") > 0 && victim->energy < 200.)
 		{
 			helped = true;
-			double toGive = max(attributes.Get("energy capacity") * 0.1, victim->Attributes().Get("energy capacity") * 0.2);
+			double toGive = max(attributes->Get("energy capacity") * 0.1, victim->Attributes().Get("energy capacity") * 0.2);
 			TransferEnergy(max(200., toGive), victim.get());
 		}
 		if(helped)
@@ -1933,18 +1958,18 @@ int Ship::Scan(const PlayerInfo &player)
 
 	// The range of a scanner is proportional to the square root of its power.
 	// Because of Pythagoras, if we use square-distance, we can skip this square root.
-	double cargoDistanceSquared = attributes.Get("cargo scan power");
-	double outfitDistanceSquared = attributes.Get("outfit scan power");
+	double cargoDistanceSquared = attributes->Get("cargo scan power");
+	double outfitDistanceSquared = attributes->Get("outfit scan power");
 
 	// Bail out if this ship has no scanners.
 	if(!cargoDistanceSquared && !outfitDistanceSquared)
 		return 0;
 
-	double cargoSpeed = attributes.Get("cargo scan efficiency");
+	double cargoSpeed = attributes->Get("cargo scan efficiency");
 	if(!cargoSpeed)
 		cargoSpeed = cargoDistanceSquared;
 
-	double outfitSpeed = attributes.Get("outfit scan efficiency");
+	double outfitSpeed = attributes->Get("outfit scan efficiency");
 	if(!outfitSpeed)
 		outfitSpeed = outfitDistanceSquared;
 
@@ -1960,8 +1985,8 @@ int Ship::Scan(const PlayerInfo &player)
 	// of 0.
 	// If instantly scanning very small ships is desirable, this can be removed.
 	// One point of scan opacity is the equivalent of an additional ton of cargo / outfit space
-	const double outfitsSize = target->baseAttributes.Get("outfit space") + target->attributes.Get("outfit scan opacity");
-	const double cargoSize = target->attributes.Get("cargo space") + target->attributes.Get("cargo scan opacity");
+	const double outfitsSize = target->baseAttributes->Get("outfit space") + target->attributes->Get("outfit scan opacity");
+	const double cargoSize = target->attributes->Get("cargo space") + target->attributes->Get("cargo scan opacity");
 	double outfits = max(SCAN_MIN_OUTFIT_SPACE, outfitsSize) * SCAN_OUTFIT_FACTOR;
 	double cargo = max(SCAN_MIN_CARGO_SPACE, cargoSize) * SCAN_CARGO_FACTOR;
 
@@ -2021,16 +2046,16 @@ int Ship::Scan(const PlayerInfo &player)
 			for(const auto &sound : sounds)
 				Audio::Play(sound.first, position, SoundCategory::SCAN);
 	};
-	if(attributes.Get("silent scans"))
+	if(attributes->Get("silent scans"))
 	{
 		// No sounds.
 	}
 	else if(isYours || (target->isYours))
 	{
 		if(activeScanning & ShipEvent::SCAN_CARGO)
-			playScanSounds(attributes.CargoScanSounds(), position);
+			playScanSounds(attributes->CargoScanSounds(), position);
 		if(activeScanning & ShipEvent::SCAN_OUTFITS)
-			playScanSounds(attributes.OutfitScanSounds(), position);
+			playScanSounds(attributes->OutfitScanSounds(), position);
 	}
 
 	bool isImportant = false;
@@ -2050,7 +2075,7 @@ int Ship::Scan(const PlayerInfo &player)
 		{
 			// If this ship has no name, show its model name instead.
 			string tag;
-			const string &gov = Translation::TrGovernment(target->GetGovernment()->DisplayName());
+			const string &gov = target->GetGovernment()->TranslatedDisplayName();
 			if(!target->GivenName().empty())
 				tag = gov + " " + target->Noun() + " \"" + target->GivenName() + "\": ";
 			else
@@ -2060,18 +2085,18 @@ int Ship::Scan(const PlayerInfo &player)
 		}
 	}
 	else if(startedScanning && target->isYours && isImportant)
-		Messages::Add({"The " + Translation::TrGovernment(government->DisplayName()) + " " + Noun() + " \""
+		Messages::Add({"The " + government->TranslatedDisplayName() + " " + Noun() + " \""
 			+ GivenName() + "\" is attempting to scan your ship \"" + target->GivenName() + "\".",
 			GameData::MessageCategories().Get("low")});
 
 	if(target->isYours && !isYours && isImportant)
 	{
 		if(result & ShipEvent::SCAN_CARGO)
-			Messages::Add({"The " + Translation::TrGovernment(government->DisplayName()) + " " + Noun() + " \""
+			Messages::Add({"The " + government->TranslatedDisplayName() + " " + Noun() + " \""
 				+ GivenName() + "\" completed its cargo scan of your ship \"" + target->GivenName() + "\".",
 				GameData::MessageCategories().Get("normal")});
 		if(result & ShipEvent::SCAN_OUTFITS)
-			Messages::Add({"The " + Translation::TrGovernment(government->DisplayName()) + " " + Noun() + " \""
+			Messages::Add({"The " + government->TranslatedDisplayName() + " " + Noun() + " \""
 				+ GivenName() + "\" completed its outfit scan of your ship \"" + target->GivenName()
 				+ (target->Attributes().Get("inscrutable") > 0. ? "\" with no useful results." : "\"."),
 				GameData::MessageCategories().Get("normal")});
@@ -2144,7 +2169,7 @@ void Ship::Fire(vector<Projectile> &projectiles, vector<Visual> &visuals, vector
 				armament.Fire(i, *this, projectiles, visuals, Random::Real() < jamChance);
 				if(cloak)
 				{
-					double cloakingFiring = attributes.Get("cloaked firing");
+					double cloakingFiring = attributes->Get("cloaked firing");
 					// Any negative value means shooting does not decloak.
 					if(cloakingFiring > 0)
 						cloak -= cloakingFiring;
@@ -2179,6 +2204,22 @@ bool Ship::HasTractorBeam() const
 
 
 
+// Get how far away the anti-missile or tractor beam systems that are ready
+// to fire can reach.
+double Ship::AntiMissileRange() const
+{
+	return antiMissileRange;
+}
+
+
+
+double Ship::TractorBeamRange() const
+{
+	return tractorBeamRange;
+}
+
+
+
 // Fire an anti-missile.
 bool Ship::FireAntiMissile(const Projectile &projectile, vector<Visual> &visuals)
 {
@@ -2307,10 +2348,10 @@ bool Ship::IsIonized() const
 		return false;
 
 	// A ship can only be fully ionized if its engines or weapons require energy.
-	bool usesEnergy = attributes.Get("thrusting energy") > 0
-		|| attributes.Get("reverse thrusting energy") > 0
-		|| attributes.Get("turning energy") > 0
-		|| any_of(outfits.begin(), outfits.end(), [](const auto &it) -> bool {
+	bool usesEnergy = attributes->Get("thrusting energy") > 0
+		|| attributes->Get("reverse thrusting energy") > 0
+		|| attributes->Get("turning energy") > 0
+		|| any_of(outfits->begin(), outfits->end(), [](const auto &it) -> bool {
 			const Weapon *weapon = it.first->GetWeapon().get();
 			return weapon && weapon->FiringEnergy() > 0;
 		});
@@ -2384,22 +2425,22 @@ bool Ship::CannotAct(ActionType actionType) const
 		switch(actionType)
 		{
 			case ActionType::AFTERBURNER:
-				canActCloaked = attributes.Get("cloaked afterburner");
+				canActCloaked = attributes->Get("cloaked afterburner");
 				break;
 			case ActionType::BOARD:
-				canActCloaked = attributes.Get("cloaked boarding");
+				canActCloaked = attributes->Get("cloaked boarding");
 				break;
 			case ActionType::COMMUNICATION:
-				canActCloaked = attributes.Get("cloaked communication");
+				canActCloaked = attributes->Get("cloaked communication");
 				break;
 			case ActionType::FIRE:
-				canActCloaked = attributes.Get("cloaked firing");
+				canActCloaked = attributes->Get("cloaked firing");
 				break;
 			case ActionType::PICKUP:
-				canActCloaked = attributes.Get("cloaked pickup");
+				canActCloaked = attributes->Get("cloaked pickup");
 				break;
 			case ActionType::SCAN:
-				canActCloaked = attributes.Get("cloaked scanning");
+				canActCloaked = attributes->Get("cloaked scanning");
 				break;
 		}
 	return (cloak == 1. && !canActCloaked) || (cloak != 1. && cloak && !cloakDisruption && !canActCloaked);
@@ -2493,7 +2534,7 @@ bool Ship::IsReadyToJump(bool waitingIsReady) const
 
 	Point direction = targetSystem->Position() - currentSystem->Position();
 	bool isJump = (jumpUsed.first == JumpType::JUMP_DRIVE);
-	double scramThreshold = attributes.Get("scram drive");
+	double scramThreshold = attributes->Get("scram drive");
 
 	// If the system has a departure distance the ship is only allowed to leave the system
 	// if it is beyond this distance.
@@ -2512,7 +2553,7 @@ bool Ship::IsReadyToJump(bool waitingIsReady) const
 		if(deviation > scramThreshold)
 			return false;
 	}
-	else if(velocity.Length() > attributes.Get("jump speed"))
+	else if(velocity.Length() > attributes->Get("jump speed"))
 		return false;
 
 	if(!isJump)
@@ -2660,18 +2701,18 @@ void Ship::Recharge(int rechargeType, bool hireCrew)
 		return;
 
 	if(hireCrew)
-		crew = min<int>(max(crew, RequiredCrew()), attributes.Get("bunks"));
+		crew = min<int>(max(crew, RequiredCrew()), attributes->Get("bunks"));
 	pilotError = 0;
 	pilotOkay = 0;
 
-	if((rechargeType & Port::RechargeType::Shields) || attributes.Get("shield generation"))
+	if((rechargeType & Port::RechargeType::Shields) || attributes->Get("shield generation"))
 		shields = MaxShields();
-	if((rechargeType & Port::RechargeType::Hull) || attributes.Get("hull repair rate"))
+	if((rechargeType & Port::RechargeType::Hull) || attributes->Get("hull repair rate"))
 		hull = MaxHull();
-	if((rechargeType & Port::RechargeType::Energy) || attributes.Get("energy generation"))
-		energy = attributes.Get("energy capacity");
-	if((rechargeType & Port::RechargeType::Fuel) || attributes.Get("fuel generation"))
-		fuel = attributes.Get("fuel capacity");
+	if((rechargeType & Port::RechargeType::Energy) || attributes->Get("energy generation"))
+		energy = attributes->Get("energy capacity");
+	if((rechargeType & Port::RechargeType::Fuel) || attributes->Get("fuel generation"))
+		fuel = attributes->Get("fuel capacity");
 
 	lastHitBy = nullptr;
 	heat = IdleHeat();
@@ -2699,7 +2740,7 @@ bool Ship::CanRefuel(const Ship &other) const
 
 bool Ship::CanGiveEnergy(const Ship &other) const
 {
-	double toGive = min(other.attributes.Get("energy capacity"), max(200., other.attributes.Get("energy capacity") * 0.2));
+	double toGive = min(other.attributes->Get("energy capacity"), max(200., other.attributes->Get("energy capacity") * 0.2));
 	return energy >= 2 * toGive;
 }
 
@@ -2707,10 +2748,10 @@ bool Ship::CanGiveEnergy(const Ship &other) const
 
 double Ship::TransferFuel(double amount, Ship *to)
 {
-	amount = max(fuel - attributes.Get("fuel capacity"), amount);
+	amount = max(fuel - attributes->Get("fuel capacity"), amount);
 	if(to)
 	{
-		amount = min(to->attributes.Get("fuel capacity") - to->fuel, amount);
+		amount = min(to->attributes->Get("fuel capacity") - to->fuel, amount);
 		to->fuel += amount;
 	}
 	fuel -= amount;
@@ -2721,10 +2762,10 @@ double Ship::TransferFuel(double amount, Ship *to)
 
 double Ship::TransferEnergy(double amount, Ship *to)
 {
-	amount = max(energy - attributes.Get("energy capacity"), amount);
+	amount = max(energy - attributes->Get("energy capacity"), amount);
 	if(to)
 	{
-		amount = min(to->attributes.Get("energy capacity") - to->energy, amount);
+		amount = min(to->attributes->Get("energy capacity") - to->energy, amount);
 		to->energy += amount;
 	}
 	energy -= amount;
@@ -2804,7 +2845,7 @@ void Ship::ClearTargetsAndOrders()
 
 
 
-list<ShipEvent> &Ship::HandleEvents()
+vector<ShipEvent> &Ship::HandleEvents()
 {
 	return unhandledEvents;
 }
@@ -2830,7 +2871,7 @@ double Ship::Hull() const
 
 double Ship::Fuel() const
 {
-	double maximum = attributes.Get("fuel capacity");
+	double maximum = attributes->Get("fuel capacity");
 	return maximum ? min(1., fuel / maximum) : 0.;
 }
 
@@ -2838,7 +2879,7 @@ double Ship::Fuel() const
 
 double Ship::Energy() const
 {
-	double maximum = attributes.Get("energy capacity");
+	double maximum = attributes->Get("energy capacity");
 	return maximum ? min(1., energy / maximum) : (hull > 0.) ? 1. : 0.;
 }
 
@@ -2875,13 +2916,13 @@ double Ship::DisabledHull() const
 // Get the maximum shield and hull values of the ship, accounting for multipliers.
 double Ship::MaxShields() const
 {
-	return attributes.Get("shields") * (1 + attributes.Get("shield multiplier"));
+	return attributes->Get(AttributeKey::SHIELDS) * (1 + attributes->Get(AttributeKey::SHIELD_MULTIPLIER));
 }
 
 
 double Ship::MaxHull() const
 {
-	return attributes.Get("hull") * (1 + attributes.Get("hull multiplier"));
+	return attributes->Get(AttributeKey::HULL) * (1 + attributes->Get(AttributeKey::HULL_MULTIPLIER));
 }
 
 
@@ -2979,15 +3020,15 @@ bool Ship::NeedsFuel(bool followParent) const
 	}
 	if(!jumpFuel)
 		jumpFuel = navigation.JumpFuel(targetSystem);
-	return (fuel < jumpFuel) && (attributes.Get("fuel capacity") >= jumpFuel);
+	return (fuel < jumpFuel) && (attributes->Get("fuel capacity") >= jumpFuel);
 }
 
 
 
 bool Ship::NeedsEnergy() const
 {
-	return attributes.Get("energy capacity") && !energy && !attributes.Get("energy generation")
-			&& !attributes.Get("fuel energy") && !attributes.Get("solar collection");
+	return attributes->Get("energy capacity") && !energy && !attributes->Get("energy generation")
+			&& !attributes->Get("fuel energy") && !attributes->Get("solar collection");
 }
 
 
@@ -2997,7 +3038,7 @@ double Ship::JumpFuelMissing() const
 	// Used for smart refueling: transfer only as much as really needed
 	// includes checking if fuel cap is high enough at all
 	double jumpFuel = navigation.JumpFuel(targetSystem);
-	if(!jumpFuel || fuel > jumpFuel || jumpFuel > attributes.Get("fuel capacity"))
+	if(!jumpFuel || fuel > jumpFuel || jumpFuel > attributes->Get("fuel capacity"))
 		return 0.;
 
 	return jumpFuel - fuel;
@@ -3010,14 +3051,14 @@ double Ship::IdleHeat() const
 {
 	// This ship's cooling ability:
 	double coolingEfficiency = CoolingEfficiency();
-	double cooling = coolingEfficiency * attributes.Get("cooling");
-	double activeCooling = coolingEfficiency * attributes.Get("active cooling");
+	double cooling = coolingEfficiency * attributes->Get(AttributeKey::COOLING);
+	double activeCooling = coolingEfficiency * attributes->Get(AttributeKey::ACTIVE_COOLING);
 
 	// Idle heat is the heat level where:
 	// heat = heat - heat * diss + heatGen - cool - activeCool * heat / maxHeat
 	// heat = heat - heat * (diss + activeCool / maxHeat) + (heatGen - cool)
 	// heat * (diss + activeCool / maxHeat) = (heatGen - cool)
-	double production = max(0., attributes.Get("heat generation") - cooling);
+	double production = max(0., attributes->Get(AttributeKey::HEAT_GENERATION) - cooling);
 	double dissipation = HeatDissipation() + activeCooling / MaximumHeat();
 	if(!dissipation) return production ? numeric_limits<double>::max() : 0;
 	return production / dissipation;
@@ -3028,7 +3069,7 @@ double Ship::IdleHeat() const
 // Get the heat dissipation, in heat units per heat unit per frame.
 double Ship::HeatDissipation() const
 {
-	return .001 * attributes.Get("heat dissipation");
+	return .001 * attributes->Get(AttributeKey::HEAT_DISSIPATION);
 }
 
 
@@ -3036,7 +3077,7 @@ double Ship::HeatDissipation() const
 // Get the maximum heat level, in heat units (not temperature).
 double Ship::MaximumHeat() const
 {
-	return MAXIMUM_TEMPERATURE * (cargo.Used() + attributes.Mass() + attributes.Get("heat capacity"));
+	return MAXIMUM_TEMPERATURE * (cargo.Used() + attributes->Mass() + attributes->Get(AttributeKey::HEAT_CAPACITY));
 }
 
 
@@ -3050,7 +3091,7 @@ bool Ship::IsCloaked() const
 
 double Ship::CloakingSpeed() const
 {
-	return attributes.Get("cloak") + attributes.Get("cloak by mass") * 1000. / Mass();
+	return attributes->Get(AttributeKey::CLOAK) + attributes->Get(AttributeKey::CLOAK_BY_MASS) * 1000. / Mass();
 }
 
 
@@ -3058,18 +3099,18 @@ double Ship::CloakingSpeed() const
 bool Ship::Phases(Projectile &projectile) const
 {
 	// No Phasing if we are not cloaked, or not having cloak phasing.
-	if(!IsCloaked() || attributes.Get("cloak phasing") == 0)
+	if(!IsCloaked() || attributes->Get(AttributeKey::CLOAK_PHASING) == 0)
 		return false;
 
 	// Check for full phasing first, to avoid more expensive lookups.
-	if(attributes.Get("cloak phasing") >= 1 || projectile.Phases(*this))
+	if(attributes->Get(AttributeKey::CLOAK_PHASING) >= 1 || projectile.Phases(*this))
 		return true;
 
 	// Perform the most expensive checks last.
 	// If multiple ships with partial phasing are stacked on top of each other, then the chance of collision increases
 	// significantly, because each ship in the firing-line resets the SetPhase of the previous one. But such stacks
 	// are rare, so we are not going to do anything special for this.
-	if(attributes.Get("cloak phasing") >= Random::Real())
+	if(attributes->Get(AttributeKey::CLOAK_PHASING) >= Random::Real())
 	{
 		projectile.SetPhases(this);
 		return true;
@@ -3086,7 +3127,7 @@ double Ship::CoolingEfficiency() const
 	// This is an S-curve where the efficiency is 100% if you have no outfits
 	// that create "cooling inefficiency", and as that value increases the
 	// efficiency stays high for a while, then drops off, then approaches 0.
-	double x = attributes.Get("cooling inefficiency");
+	double x = attributes->Get(AttributeKey::COOLING_INEFFICIENCY);
 	return 2. + 2. / (1. + exp(x / -2.)) - 4. / (1. + exp(x / -4.));
 }
 
@@ -3102,7 +3143,7 @@ int Ship::Crew() const
 // Calculate the drag on this ship. The drag can be no greater than the mass.
 double Ship::Drag() const
 {
-	double drag = attributes.Get("drag") / (1. + attributes.Get("drag reduction"));
+	double drag = attributes->Get(AttributeKey::DRAG) / (1. + attributes->Get(AttributeKey::DRAG_REDUCTION));
 	double mass = InertialMass();
 	return drag >= mass ? mass : drag;
 }
@@ -3113,7 +3154,7 @@ double Ship::Drag() const
 // divided by the mass, up to a value of 1.
 double Ship::DragForce() const
 {
-	double drag = attributes.Get("drag") / (1. + attributes.Get("drag reduction"));
+	double drag = attributes->Get(AttributeKey::DRAG) / (1. + attributes->Get(AttributeKey::DRAG_REDUCTION));
 	double mass = InertialMass();
 	return drag >= mass ? 1. : drag / mass;
 }
@@ -3122,19 +3163,19 @@ double Ship::DragForce() const
 
 int Ship::RequiredCrew() const
 {
-	if(attributes.Get("automaton"))
+	if(attributes->Get("automaton"))
 		return 0;
 
 	// Drones do not need crew, but all other ships need at least one.
-	return max<int>(1, attributes.Get("required crew"));
+	return max<int>(1, attributes->Get("required crew"));
 }
 
 
 
 int Ship::CrewValue() const
 {
-	int crewEquivalent = attributes.Get("crew equivalent");
-	if(attributes.Get("use crew equivalent as crew"))
+	int crewEquivalent = attributes->Get("crew equivalent");
+	if(attributes->Get("use crew equivalent as crew"))
 		return crewEquivalent;
 	return max(Crew(), RequiredCrew()) + crewEquivalent;
 }
@@ -3143,7 +3184,7 @@ int Ship::CrewValue() const
 
 void Ship::AddCrew(int count)
 {
-	crew = min<int>(crew + count, attributes.Get("bunks"));
+	crew = min<int>(crew + count, attributes->Get("bunks"));
 }
 
 
@@ -3158,7 +3199,7 @@ bool Ship::CanBeFlagship() const
 
 double Ship::Mass() const
 {
-	return carriedMass + cargo.Used() + attributes.Mass();
+	return carriedMass + cargo.Used() + attributes->Mass();
 }
 
 
@@ -3166,15 +3207,15 @@ double Ship::Mass() const
 // Account for inertia reduction, which affects movement but has no effect on the ship's heat capacity.
 double Ship::InertialMass() const
 {
-	return Mass() / (1. + attributes.Get("inertia reduction"));
+	return Mass() / (1. + attributes->Get(AttributeKey::INERTIA_REDUCTION));
 }
 
 
 
 double Ship::TurnRate() const
 {
-	return attributes.Get("turn") / InertialMass()
-		* (1. + attributes.Get("turn multiplier"));
+	return attributes->Get(AttributeKey::TURN) / InertialMass()
+		* (1. + attributes->Get(AttributeKey::TURN_MULTIPLIER));
 }
 
 
@@ -3196,9 +3237,9 @@ double Ship::CrewTurnRate() const
 
 double Ship::Acceleration() const
 {
-	double thrust = attributes.Get("thrust");
-	return (thrust ? thrust : attributes.Get("afterburner thrust")) / InertialMass()
-		* (1. + attributes.Get("acceleration multiplier"));
+	double thrust = attributes->Get(AttributeKey::THRUST);
+	return (thrust ? thrust : attributes->Get(AttributeKey::AFTERBURNER_THRUST)) / InertialMass()
+		* (1. + attributes->Get(AttributeKey::ACCELERATION_MULTIPLIER));
 }
 
 
@@ -3223,8 +3264,8 @@ double Ship::MaxVelocity(bool withAfterburner) const
 	// v * drag / mass == thrust / mass
 	// v * drag == thrust
 	// v = thrust / drag
-	double thrust = attributes.Get("thrust");
-	double afterburnerThrust = attributes.Get("afterburner thrust");
+	double thrust = attributes->Get(AttributeKey::THRUST);
+	double afterburnerThrust = attributes->Get(AttributeKey::AFTERBURNER_THRUST);
 	return (thrust ? thrust + afterburnerThrust * withAfterburner : afterburnerThrust) / Drag();
 }
 
@@ -3232,15 +3273,15 @@ double Ship::MaxVelocity(bool withAfterburner) const
 
 double Ship::ReverseAcceleration() const
 {
-	return attributes.Get("reverse thrust") / InertialMass()
-		* (1. + attributes.Get("acceleration multiplier"));
+	return attributes->Get(AttributeKey::REVERSE_THRUST) / InertialMass()
+		* (1. + attributes->Get(AttributeKey::ACCELERATION_MULTIPLIER));
 }
 
 
 
 double Ship::MaxReverseVelocity() const
 {
-	return attributes.Get("reverse thrust") / Drag();
+	return attributes->Get("reverse thrust") / Drag();
 }
 
 
@@ -3288,13 +3329,13 @@ int Ship::TakeDamage(vector<Visual> &visuals, const DamageDealt &damage, const G
 	shields -= damage.Shield();
 	if(damage.Shield() && !isDisabled)
 	{
-		int disabledDelay = attributes.Get("depleted shield delay");
+		int disabledDelay = attributes->Get("depleted shield delay");
 		shieldDelay = max<int>(shieldDelay, (shields <= 0. && disabledDelay)
-			? disabledDelay : attributes.Get("shield delay"));
+			? disabledDelay : attributes->Get("shield delay"));
 	}
 	hull -= damage.Hull();
 	if(damage.Hull() && !isDisabled)
-		hullDelay = max(hullDelay, static_cast<int>(attributes.Get("repair delay")));
+		hullDelay = max(hullDelay, static_cast<int>(attributes->Get("repair delay")));
 
 	energy -= damage.Energy();
 	heat += damage.Heat();
@@ -3331,7 +3372,7 @@ int Ship::TakeDamage(vector<Visual> &visuals, const DamageDealt &damage, const G
 	if(!wasDisabled && isDisabled)
 	{
 		type |= ShipEvent::DISABLE;
-		hullDelay = max(hullDelay, static_cast<int>(attributes.Get("disabled repair delay")));
+		hullDelay = max(hullDelay, static_cast<int>(attributes->Get("disabled repair delay")));
 	}
 	if(!wasDestroyed && IsDestroyed())
 	{
@@ -3408,10 +3449,8 @@ bool Ship::HasBays() const
 // one of your escorts plans to use that bay.
 int Ship::BaysFree(const string &category) const
 {
-	int count = 0;
-	for(const Bay &bay : bays)
-		count += (bay.category == category) && !bay.ship;
-	return count;
+	const BayCount *count = GetBayCount(category);
+	return count ? count->free : 0;
 }
 
 
@@ -3419,10 +3458,8 @@ int Ship::BaysFree(const string &category) const
 // Check how many bays this ship has of a given category.
 int Ship::BaysTotal(const string &category) const
 {
-	int count = 0;
-	for(const Bay &bay : bays)
-		count += (bay.category == category);
-	return count;
+	const BayCount *count = GetBayCount(category);
+	return count ? count->total : 0;
 }
 
 
@@ -3434,11 +3471,14 @@ bool Ship::CanCarry(const Ship &ship) const
 	if(!HasBays() || !ship.CanBeCarried() || (IsYours() && !ship.IsYours()))
 		return false;
 	// Check only for the category that we are interested in.
-	const string &category = ship.attributes.Category();
+	const string &category = ship.attributes->Category();
 
 	int free = BaysTotal(category);
 	if(!free)
 		return false;
+	// If there are fewer escorts than bays, some bay must be left for this ship.
+	if(escorts.size() < static_cast<size_t>(free))
+		return true;
 
 	for(const auto &it : escorts)
 	{
@@ -3447,7 +3487,7 @@ bool Ship::CanCarry(const Ship &ship) const
 			continue;
 		if(escort.get() == &ship)
 			break;
-		if(escort->attributes.Category() == category && !escort->IsDestroyed() &&
+		if(escort->attributes->Category() == category && !escort->IsDestroyed() &&
 				(!IsYours() || (IsYours() && escort->IsYours())))
 			--free;
 		if(!free)
@@ -3471,7 +3511,10 @@ bool Ship::Carry(const shared_ptr<Ship> &ship)
 		return false;
 
 	// Check only for the category that we are interested in.
-	const string &category = ship->attributes.Category();
+	const string &category = ship->attributes->Category();
+	BayCount *count = GetBayCount(category);
+	if(!count || !count->free)
+		return false;
 
 	// NPC ships should always transfer cargo. Player ships should only
 	// transfer cargo if they set the AI preference.
@@ -3481,6 +3524,7 @@ bool Ship::Carry(const shared_ptr<Ship> &ship)
 		if((bay.category == category) && !bay.ship)
 		{
 			bay.ship = ship;
+			--count->free;
 			ship->SetSystem(nullptr);
 			ship->SetPlanet(nullptr);
 			ship->SetTargetSystem(nullptr);
@@ -3530,6 +3574,8 @@ void Ship::UnloadBays()
 			bay.ship->UnmarkForRemoval();
 			bay.ship.reset();
 		}
+	for(BayCount &count : bayCounts)
+		count.free = count.total;
 }
 
 
@@ -3632,7 +3678,7 @@ void Ship::Jettison(const Outfit *outfit, int count, bool wasAppeasing)
 
 const Outfit &Ship::BaseAttributes() const
 {
-	return baseAttributes;
+	return *baseAttributes;
 }
 
 
@@ -3640,15 +3686,15 @@ const Outfit &Ship::BaseAttributes() const
 // Get outfit information.
 const map<const Outfit *, int> &Ship::Outfits() const
 {
-	return outfits;
+	return *outfits;
 }
 
 
 
 int Ship::OutfitCount(const Outfit *outfit) const
 {
-	auto it = outfits.find(outfit);
-	return (it == outfits.end()) ? 0 : it->second;
+	auto it = outfits->find(outfit);
+	return (it == outfits->end()) ? 0 : it->second;
 }
 
 
@@ -3658,32 +3704,32 @@ void Ship::AddOutfit(const Outfit *outfit, int count)
 {
 	if(outfit && count)
 	{
-		auto it = outfits.find(outfit);
-		int before = outfits.count(outfit);
-		if(it == outfits.end())
-			outfits[outfit] = count;
+		map<const Outfit *, int> &installed = MutableOutfits();
+		auto it = installed.find(outfit);
+		int before = installed.count(outfit);
+		if(it == installed.end())
+			installed[outfit] = count;
 		else
 		{
 			it->second += count;
 			if(!it->second)
-				outfits.erase(it);
+				installed.erase(it);
 		}
-		int after = outfits.count(outfit);
-		attributes.Add(*outfit, count);
+		int after = installed.count(outfit);
+		// The attributes only change by this outfit's share, so there is no need
+		// to add up the whole ship again. Anything derived from them that is not
+		// needed right away is only marked as out of date.
+		MutableAttributes().Add(*outfit, count);
 		if(outfit->GetWeapon())
 		{
 			armament.Add(outfit, count);
-			// Only the player's ships make use of attraction and deterrence.
-			if(isYours)
-				deterrence = CalculateDeterrence();
+			deterrenceIsStale = true;
 		}
 
 		if(outfit->Get("cargo space"))
 		{
-			cargo.SetSize(attributes.Get("cargo space"));
-			// Only the player's ships make use of attraction and deterrence.
-			if(isYours)
-				attraction = CalculateAttraction();
+			cargo.SetSize(attributes->Get("cargo space"));
+			attractionIsStale = true;
 		}
 		if(outfit->Get("hull"))
 			hull += outfit->Get("hull") * count;
@@ -3724,16 +3770,16 @@ Ship::CanFireResult Ship::CanFire(const Weapon *weapon) const
 {
 	if(weapon->Ammo())
 	{
-		auto it = outfits.find(weapon->Ammo());
-		if(it == outfits.end() || it->second < weapon->AmmoUsage())
+		auto it = outfits->find(weapon->Ammo());
+		if(it == outfits->end() || it->second < weapon->AmmoUsage())
 			return CanFireResult::NO_AMMO;
 	}
 
 	if(weapon->ConsumesEnergy()
-			&& energy < weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * attributes.Get("energy capacity"))
+			&& energy < weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * attributes->Get("energy capacity"))
 		return CanFireResult::NO_ENERGY;
 	if(weapon->ConsumesFuel()
-			&& fuel < weapon->FiringFuel() + weapon->RelativeFiringFuel() * attributes.Get("fuel capacity"))
+			&& fuel < weapon->FiringFuel() + weapon->RelativeFiringFuel() * attributes->Get("fuel capacity"))
 		return CanFireResult::NO_FUEL;
 	// We do check hull, but we don't check shields. Ships can survive with all shields depleted.
 	// Ships should not disable themselves, so we check if we stay above minimumHull.
@@ -3765,8 +3811,8 @@ void Ship::ExpendAmmo(const Weapon &weapon)
 {
 	// Compute this ship's initial capacities, in case the consumption of the ammunition outfit(s)
 	// modifies them, so that relative costs are calculated based on the pre-firing state of the ship.
-	const double relativeEnergyChange = weapon.RelativeFiringEnergy() * attributes.Get("energy capacity");
-	const double relativeFuelChange = weapon.RelativeFiringFuel() * attributes.Get("fuel capacity");
+	const double relativeEnergyChange = weapon.RelativeFiringEnergy() * attributes->Get("energy capacity");
+	const double relativeFuelChange = weapon.RelativeFiringFuel() * attributes->Get("fuel capacity");
 	const double relativeHeatChange = !weapon.RelativeFiringHeat() ? 0. : weapon.RelativeFiringHeat() * MaximumHeat();
 	const double relativeHullChange = weapon.RelativeFiringHull() * MaxHull();
 	const double relativeShieldChange = weapon.RelativeFiringShields() * MaxShields();
@@ -4023,9 +4069,26 @@ void Ship::Linger()
 
 
 
+// The index of the AI's record of this ship, or -1 if it has none yet. A
+// copy of a ship starts out with the same index, so the AI must check that
+// the record really belongs to this ship before using it.
+int Ship::AISlot() const
+{
+	return aiSlot;
+}
+
+
+
+void Ship::SetAISlot(int slot) const
+{
+	aiSlot = slot;
+}
+
+
+
 bool Ship::Imitates(const Ship &other) const
 {
-	return displayModelName == other.DisplayModelName() && outfits == other.Outfits();
+	return displayModelName == other.DisplayModelName() && *outfits == other.Outfits();
 }
 
 
@@ -4073,7 +4136,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 			double size = Width() + Height();
 			double scale = .03 * size + .5;
 			double radius = .2 * size;
-			int debrisCount = attributes.Mass() * .07;
+			int debrisCount = attributes->Mass() * .07;
 
 			// Estimate how many new visuals will be added during destruction.
 			visuals.reserve(visuals.size() + debrisCount + explosionTotal + finalExplosions.size());
@@ -4098,7 +4161,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 			for(const auto &it : cargo.Outfits())
 				Jettison(it.first, Random::Binomial(it.second, .25));
 			// Ammunition has a default 5% chance to survive as flotsam.
-			for(const auto &it : outfits)
+			for(const auto &it : *outfits)
 			{
 				double flotsamChance = it.first->Get("flotsam chance");
 				if(flotsamChance > 0.)
@@ -4193,36 +4256,36 @@ void Ship::DoGeneration()
 		// 4. Shields of carried fighters
 		// 5. Transfer of excess energy and fuel to carried fighters.
 
-		const double hullAvailable = (attributes.Get("hull repair rate")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull repair rate")))
-			* (1. + attributes.Get("hull repair multiplier"))
-			* (1. + attributes.Get("cloaked repair multiplier") * Cloaking());
-		const double hullEnergy = (attributes.Get("hull energy")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull energy")))
-			* (1. + attributes.Get("hull energy multiplier")) / hullAvailable;
-		const double hullFuel = (attributes.Get("hull fuel")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull fuel")))
-			* (1. + attributes.Get("hull fuel multiplier")) / hullAvailable;
-		const double hullHeat = (attributes.Get("hull heat")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull heat")))
-			* (1. + attributes.Get("hull heat multiplier")) / hullAvailable;
+		const double hullAvailable = (attributes->Get(AttributeKey::HULL_REPAIR_RATE)
+			+ (hullDelay ? 0 : attributes->Get(AttributeKey::DELAYED_HULL_REPAIR_RATE)))
+			* (1. + attributes->Get(AttributeKey::HULL_REPAIR_MULTIPLIER))
+			* (1. + attributes->Get(AttributeKey::CLOAKED_REPAIR_MULTIPLIER) * Cloaking());
+		const double hullEnergy = (attributes->Get(AttributeKey::HULL_ENERGY)
+			+ (hullDelay ? 0 : attributes->Get(AttributeKey::DELAYED_HULL_ENERGY)))
+			* (1. + attributes->Get(AttributeKey::HULL_ENERGY_MULTIPLIER)) / hullAvailable;
+		const double hullFuel = (attributes->Get(AttributeKey::HULL_FUEL)
+			+ (hullDelay ? 0 : attributes->Get(AttributeKey::DELAYED_HULL_FUEL)))
+			* (1. + attributes->Get(AttributeKey::HULL_FUEL_MULTIPLIER)) / hullAvailable;
+		const double hullHeat = (attributes->Get(AttributeKey::HULL_HEAT)
+			+ (hullDelay ? 0 : attributes->Get(AttributeKey::DELAYED_HULL_HEAT)))
+			* (1. + attributes->Get(AttributeKey::HULL_HEAT_MULTIPLIER)) / hullAvailable;
 		double hullRemaining = hullAvailable;
 		DoRepair(hull, hullRemaining, MaxHull(),
 			energy, hullEnergy, fuel, hullFuel, heat, hullHeat);
 
-		const double shieldsAvailable = (attributes.Get("shield generation")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield generation")))
-			* (1. + attributes.Get("shield generation multiplier"))
-			* (1. + attributes.Get("cloaked regen multiplier") * Cloaking());
-		const double shieldsEnergy = (attributes.Get("shield energy")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield energy")))
-			* (1. + attributes.Get("shield energy multiplier")) / shieldsAvailable;
-		const double shieldsFuel = (attributes.Get("shield fuel")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield fuel")))
-			* (1. + attributes.Get("shield fuel multiplier")) / shieldsAvailable;
-		const double shieldsHeat = (attributes.Get("shield heat")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield heat")))
-			* (1. + attributes.Get("shield heat multiplier")) / shieldsAvailable;
+		const double shieldsAvailable = (attributes->Get(AttributeKey::SHIELD_GENERATION)
+			+ (shieldDelay ? 0 : attributes->Get(AttributeKey::DELAYED_SHIELD_GENERATION)))
+			* (1. + attributes->Get(AttributeKey::SHIELD_GENERATION_MULTIPLIER))
+			* (1. + attributes->Get(AttributeKey::CLOAKED_REGEN_MULTIPLIER) * Cloaking());
+		const double shieldsEnergy = (attributes->Get(AttributeKey::SHIELD_ENERGY)
+			+ (shieldDelay ? 0 : attributes->Get(AttributeKey::DELAYED_SHIELD_ENERGY)))
+			* (1. + attributes->Get(AttributeKey::SHIELD_ENERGY_MULTIPLIER)) / shieldsAvailable;
+		const double shieldsFuel = (attributes->Get(AttributeKey::SHIELD_FUEL)
+			+ (shieldDelay ? 0 : attributes->Get(AttributeKey::DELAYED_SHIELD_FUEL)))
+			* (1. + attributes->Get(AttributeKey::SHIELD_FUEL_MULTIPLIER)) / shieldsAvailable;
+		const double shieldsHeat = (attributes->Get(AttributeKey::SHIELD_HEAT)
+			+ (shieldDelay ? 0 : attributes->Get(AttributeKey::DELAYED_SHIELD_HEAT)))
+			* (1. + attributes->Get(AttributeKey::SHIELD_HEAT_MULTIPLIER)) / shieldsAvailable;
 		double shieldsRemaining = shieldsAvailable;
 		DoRepair(shields, shieldsRemaining, MaxShields(),
 			energy, shieldsEnergy, fuel, shieldsFuel, heat, shieldsHeat);
@@ -4258,15 +4321,15 @@ void Ship::DoGeneration()
 
 			// Now that there is no more need to use energy for hull and shield
 			// repair, if there is still excess energy, transfer it.
-			double energyRemaining = energy - attributes.Get("energy capacity");
-			double fuelRemaining = fuel - attributes.Get("fuel capacity");
+			double energyRemaining = energy - attributes->Get(AttributeKey::ENERGY_CAPACITY);
+			double fuelRemaining = fuel - attributes->Get(AttributeKey::FUEL_CAPACITY);
 			for(const pair<double, Ship *> &it : carried)
 			{
 				Ship &ship = *it.second;
 				if(energyRemaining > 0.)
-					DoRepair(ship.energy, energyRemaining, ship.attributes.Get("energy capacity"));
+					DoRepair(ship.energy, energyRemaining, ship.attributes->Get(AttributeKey::ENERGY_CAPACITY));
 				if(fuelRemaining > 0.)
-					DoRepair(ship.fuel, fuelRemaining, ship.attributes.Get("fuel capacity"));
+					DoRepair(ship.fuel, fuelRemaining, ship.attributes->Get(AttributeKey::FUEL_CAPACITY));
 			}
 
 			// Carried ships can recharge energy from their parent's batteries,
@@ -4275,7 +4338,7 @@ void Ship::DoGeneration()
 			{
 				Ship &ship = *it.second;
 				if(ship.HasDeployOrder())
-					DoRepair(ship.energy, energy, ship.attributes.Get("energy capacity"));
+					DoRepair(ship.energy, energy, ship.attributes->Get(AttributeKey::ENERGY_CAPACITY));
 			}
 		}
 		// Decrease the shield and hull delays by 1 now that shield generation
@@ -4284,28 +4347,28 @@ void Ship::DoGeneration()
 		hullDelay = max(0, hullDelay - 1);
 	}
 	// Let the ship repair itself when disabled if it has the appropriate attribute.
-	if(isDisabled && attributes.Get("disabled recovery time"))
+	if(isDisabled && attributes->Get(AttributeKey::DISABLED_RECOVERY_TIME))
 	{
 		disabledRecoveryCounter += 1;
-		double disabledRepairEnergy = attributes.Get("disabled recovery energy");
-		double disabledRepairFuel = attributes.Get("disabled recovery fuel");
+		double disabledRepairEnergy = attributes->Get("disabled recovery energy");
+		double disabledRepairFuel = attributes->Get("disabled recovery fuel");
 
 		// Repair only if the counter has reached the limit and if the ship can meet the energy and fuel costs.
-		if(disabledRecoveryCounter >= attributes.Get("disabled recovery time")
+		if(disabledRecoveryCounter >= attributes->Get(AttributeKey::DISABLED_RECOVERY_TIME)
 			&& energy >= disabledRepairEnergy && fuel >= disabledRepairFuel)
 		{
 			energy -= disabledRepairEnergy;
 			fuel -= disabledRepairFuel;
 
-			heat += attributes.Get("disabled recovery heat");
-			ionization += attributes.Get("disabled recovery ionization");
-			scrambling += attributes.Get("disabled recovery scrambling");
-			disruption += attributes.Get("disabled recovery disruption");
-			slowness += attributes.Get("disabled recovery slowing");
-			discharge += attributes.Get("disabled recovery discharge");
-			corrosion += attributes.Get("disabled recovery corrosion");
-			leakage += attributes.Get("disabled recovery leak");
-			burning += attributes.Get("disabled recovery burning");
+			heat += attributes->Get("disabled recovery heat");
+			ionization += attributes->Get("disabled recovery ionization");
+			scrambling += attributes->Get("disabled recovery scrambling");
+			disruption += attributes->Get("disabled recovery disruption");
+			slowness += attributes->Get("disabled recovery slowing");
+			discharge += attributes->Get("disabled recovery discharge");
+			corrosion += attributes->Get("disabled recovery corrosion");
+			leakage += attributes->Get("disabled recovery leak");
+			burning += attributes->Get("disabled recovery burning");
 
 			disabledRecoveryCounter = 0;
 			hull = min(max(hull, minHull * 1.5), MaxHull());
@@ -4325,80 +4388,80 @@ void Ship::DoGeneration()
 	// TODO: Mothership gives status resistance to carried ships?
 	if(ionization)
 	{
-		double ionResistance = attributes.Get("ion resistance");
-		double ionEnergy = attributes.Get("ion resistance energy") / ionResistance;
-		double ionFuel = attributes.Get("ion resistance fuel") / ionResistance;
-		double ionHeat = attributes.Get("ion resistance heat") / ionResistance;
+		double ionResistance = attributes->Get("ion resistance");
+		double ionEnergy = attributes->Get("ion resistance energy") / ionResistance;
+		double ionFuel = attributes->Get("ion resistance fuel") / ionResistance;
+		double ionHeat = attributes->Get("ion resistance heat") / ionResistance;
 		DoStatusEffect(isDisabled, ionization, ionResistance,
 			energy, ionEnergy, fuel, ionFuel, heat, ionHeat);
 	}
 
 	if(scrambling)
 	{
-		double scramblingResistance = attributes.Get("scramble resistance");
-		double scramblingEnergy = attributes.Get("scramble resistance energy") / scramblingResistance;
-		double scramblingFuel = attributes.Get("scramble resistance fuel") / scramblingResistance;
-		double scramblingHeat = attributes.Get("scramble resistance heat") / scramblingResistance;
+		double scramblingResistance = attributes->Get("scramble resistance");
+		double scramblingEnergy = attributes->Get("scramble resistance energy") / scramblingResistance;
+		double scramblingFuel = attributes->Get("scramble resistance fuel") / scramblingResistance;
+		double scramblingHeat = attributes->Get("scramble resistance heat") / scramblingResistance;
 		DoStatusEffect(isDisabled, scrambling, scramblingResistance,
 			energy, scramblingEnergy, fuel, scramblingFuel, heat, scramblingHeat);
 	}
 
 	if(disruption)
 	{
-		double disruptionResistance = attributes.Get("disruption resistance");
-		double disruptionEnergy = attributes.Get("disruption resistance energy") / disruptionResistance;
-		double disruptionFuel = attributes.Get("disruption resistance fuel") / disruptionResistance;
-		double disruptionHeat = attributes.Get("disruption resistance heat") / disruptionResistance;
+		double disruptionResistance = attributes->Get("disruption resistance");
+		double disruptionEnergy = attributes->Get("disruption resistance energy") / disruptionResistance;
+		double disruptionFuel = attributes->Get("disruption resistance fuel") / disruptionResistance;
+		double disruptionHeat = attributes->Get("disruption resistance heat") / disruptionResistance;
 		DoStatusEffect(isDisabled, disruption, disruptionResistance,
 			energy, disruptionEnergy, fuel, disruptionFuel, heat, disruptionHeat);
 	}
 
 	if(slowness)
 	{
-		double slowingResistance = attributes.Get("slowing resistance");
-		double slowingEnergy = attributes.Get("slowing resistance energy") / slowingResistance;
-		double slowingFuel = attributes.Get("slowing resistance fuel") / slowingResistance;
-		double slowingHeat = attributes.Get("slowing resistance heat") / slowingResistance;
+		double slowingResistance = attributes->Get("slowing resistance");
+		double slowingEnergy = attributes->Get("slowing resistance energy") / slowingResistance;
+		double slowingFuel = attributes->Get("slowing resistance fuel") / slowingResistance;
+		double slowingHeat = attributes->Get("slowing resistance heat") / slowingResistance;
 		DoStatusEffect(isDisabled, slowness, slowingResistance,
 			energy, slowingEnergy, fuel, slowingFuel, heat, slowingHeat);
 	}
 
 	if(discharge)
 	{
-		double dischargeResistance = attributes.Get("discharge resistance");
-		double dischargeEnergy = attributes.Get("discharge resistance energy") / dischargeResistance;
-		double dischargeFuel = attributes.Get("discharge resistance fuel") / dischargeResistance;
-		double dischargeHeat = attributes.Get("discharge resistance heat") / dischargeResistance;
+		double dischargeResistance = attributes->Get("discharge resistance");
+		double dischargeEnergy = attributes->Get("discharge resistance energy") / dischargeResistance;
+		double dischargeFuel = attributes->Get("discharge resistance fuel") / dischargeResistance;
+		double dischargeHeat = attributes->Get("discharge resistance heat") / dischargeResistance;
 		DoStatusEffect(isDisabled, discharge, dischargeResistance,
 			energy, dischargeEnergy, fuel, dischargeFuel, heat, dischargeHeat);
 	}
 
 	if(corrosion)
 	{
-		double corrosionResistance = attributes.Get("corrosion resistance");
-		double corrosionEnergy = attributes.Get("corrosion resistance energy") / corrosionResistance;
-		double corrosionFuel = attributes.Get("corrosion resistance fuel") / corrosionResistance;
-		double corrosionHeat = attributes.Get("corrosion resistance heat") / corrosionResistance;
+		double corrosionResistance = attributes->Get("corrosion resistance");
+		double corrosionEnergy = attributes->Get("corrosion resistance energy") / corrosionResistance;
+		double corrosionFuel = attributes->Get("corrosion resistance fuel") / corrosionResistance;
+		double corrosionHeat = attributes->Get("corrosion resistance heat") / corrosionResistance;
 		DoStatusEffect(isDisabled, corrosion, corrosionResistance,
 			energy, corrosionEnergy, fuel, corrosionFuel, heat, corrosionHeat);
 	}
 
 	if(leakage)
 	{
-		double leakResistance = attributes.Get("leak resistance");
-		double leakEnergy = attributes.Get("leak resistance energy") / leakResistance;
-		double leakFuel = attributes.Get("leak resistance fuel") / leakResistance;
-		double leakHeat = attributes.Get("leak resistance heat") / leakResistance;
+		double leakResistance = attributes->Get("leak resistance");
+		double leakEnergy = attributes->Get("leak resistance energy") / leakResistance;
+		double leakFuel = attributes->Get("leak resistance fuel") / leakResistance;
+		double leakHeat = attributes->Get("leak resistance heat") / leakResistance;
 		DoStatusEffect(isDisabled, leakage, leakResistance,
 			energy, leakEnergy, fuel, leakFuel, heat, leakHeat);
 	}
 
 	if(burning)
 	{
-		double burnResistance = attributes.Get("burn resistance");
-		double burnEnergy = attributes.Get("burn resistance energy") / burnResistance;
-		double burnFuel = attributes.Get("burn resistance fuel") / burnResistance;
-		double burnHeat = attributes.Get("burn resistance heat") / burnResistance;
+		double burnResistance = attributes->Get("burn resistance");
+		double burnEnergy = attributes->Get("burn resistance energy") / burnResistance;
+		double burnFuel = attributes->Get("burn resistance fuel") / burnResistance;
+		double burnHeat = attributes->Get("burn resistance heat") / burnResistance;
 		DoStatusEffect(isDisabled, burning, burnResistance,
 			energy, burnEnergy, fuel, burnFuel, heat, burnHeat);
 	}
@@ -4407,16 +4470,16 @@ void Ship::DoGeneration()
 	// maximum capacity for the rest of the turn, but must be clamped to the
 	// maximum here before they gain more. This is so that, for example, a ship
 	// with no batteries but a good generator can still move.
-	energy = min(energy, attributes.Get("energy capacity"));
-	fuel = min(fuel, attributes.Get("fuel capacity"));
+	energy = min(energy, attributes->Get(AttributeKey::ENERGY_CAPACITY));
+	fuel = min(fuel, attributes->Get(AttributeKey::FUEL_CAPACITY));
 
 	heat -= heat * HeatDissipation();
 	if(heat > MaximumHeat())
 	{
 		isOverheated = true;
-		double heatRatio = Heat() / (1. + attributes.Get("overheat damage threshold"));
+		double heatRatio = Heat() / (1. + attributes->Get(AttributeKey::OVERHEAT_DAMAGE_THRESHOLD));
 		if(heatRatio > 1.)
-			hull -= attributes.Get("overheat damage rate") * heatRatio;
+			hull -= attributes->Get(AttributeKey::OVERHEAT_DAMAGE_RATE) * heatRatio;
 	}
 	else if(heat < .9 * MaximumHeat())
 		isOverheated = false;
@@ -4443,34 +4506,34 @@ void Ship::DoGeneration()
 		if(currentSystem)
 		{
 			System::SolarGeneration generation = currentSystem->GetSolarGeneration(position,
-				attributes.Get("ramscoop"), attributes.Get("solar collection"), attributes.Get("solar heat"));
+				attributes->Get(AttributeKey::RAMSCOOP), attributes->Get(AttributeKey::SOLAR_COLLECTION), attributes->Get(AttributeKey::SOLAR_HEAT));
 			fuel += generation.fuel;
 			energy += generation.energy;
 			heat += generation.heat;
 		}
 
 		double coolingEfficiency = CoolingEfficiency();
-		energy += attributes.Get("energy generation") - attributes.Get("energy consumption");
-		fuel += attributes.Get("fuel generation");
-		heat += attributes.Get("heat generation");
-		heat -= coolingEfficiency * attributes.Get("cooling");
+		energy += attributes->Get(AttributeKey::ENERGY_GENERATION) - attributes->Get(AttributeKey::ENERGY_CONSUMPTION);
+		fuel += attributes->Get(AttributeKey::FUEL_GENERATION);
+		heat += attributes->Get(AttributeKey::HEAT_GENERATION);
+		heat -= coolingEfficiency * attributes->Get(AttributeKey::COOLING);
 
 		// Convert fuel into energy and heat only when the required amount of fuel is available.
-		if(attributes.Get("fuel consumption") <= fuel)
+		if(attributes->Get(AttributeKey::FUEL_CONSUMPTION) <= fuel)
 		{
-			fuel -= attributes.Get("fuel consumption");
-			energy += attributes.Get("fuel energy");
-			heat += attributes.Get("fuel heat");
+			fuel -= attributes->Get(AttributeKey::FUEL_CONSUMPTION);
+			energy += attributes->Get(AttributeKey::FUEL_ENERGY);
+			heat += attributes->Get(AttributeKey::FUEL_HEAT);
 		}
 
 		// Apply active cooling. The fraction of full cooling to apply equals
 		// your ship's current fraction of its maximum temperature.
-		double activeCooling = coolingEfficiency * attributes.Get("active cooling");
+		double activeCooling = coolingEfficiency * attributes->Get(AttributeKey::ACTIVE_COOLING);
 		if(activeCooling > 0. && heat > 0. && energy >= 0.)
 		{
 			// Handle the case where "active cooling"
 			// does not require any energy.
-			double coolingEnergy = attributes.Get("cooling energy");
+			double coolingEnergy = attributes->Get(AttributeKey::COOLING_ENERGY);
 			if(coolingEnergy)
 			{
 				double spentEnergy = min(energy, coolingEnergy * min(1., Heat()));
@@ -4550,15 +4613,15 @@ void Ship::DoCloakDecision()
 
 	// Attempting to cloak when the cloaking device can no longer operate (because of hull damage)
 	// will result in it being uncloaked.
-	const double minimalHullForCloak = attributes.Get("cloak hull threshold");
-	if(minimalHullForCloak && (hull / attributes.Get("hull") < minimalHullForCloak))
+	const double minimalHullForCloak = attributes->Get("cloak hull threshold");
+	if(minimalHullForCloak && (hull / attributes->Get("hull") < minimalHullForCloak))
 		cloakDisruption = 1.;
 
 	const double cloakingSpeed = CloakingSpeed();
-	const double cloakingFuel = attributes.Get("cloaking fuel");
-	const double cloakingEnergy = attributes.Get("cloaking energy");
-	const double cloakingHull = attributes.Get("cloaking hull");
-	const double cloakingShield = attributes.Get("cloaking shields");
+	const double cloakingFuel = attributes->Get("cloaking fuel");
+	const double cloakingEnergy = attributes->Get("cloaking energy");
+	const double cloakingHull = attributes->Get("cloaking hull");
+	const double cloakingShield = attributes->Get("cloaking shields");
 	bool canCloak = (!isDisabled && cloakingSpeed > 0. && !cloakDisruption
 		&& fuel >= cloakingFuel && energy >= cloakingEnergy
 		&& MinimumHull() < hull - cloakingHull && shields >= cloakingShield);
@@ -4569,9 +4632,9 @@ void Ship::DoCloakDecision()
 		energy -= cloakingEnergy;
 		shields -= cloakingShield;
 		hull -= cloakingHull;
-		heat += attributes.Get("cloaking heat");
-		double cloakingShieldDelay = attributes.Get("cloaking shield delay");
-		double cloakingHullDelay = attributes.Get("cloaking repair delay");
+		heat += attributes->Get("cloaking heat");
+		double cloakingShieldDelay = attributes->Get("cloaking shield delay");
+		double cloakingHullDelay = attributes->Get("cloaking repair delay");
 		cloakingShieldDelay = (cloakingShieldDelay < 1.) ?
 			(Random::Real() <= cloakingShieldDelay) : cloakingShieldDelay;
 		cloakingHullDelay = (cloakingHullDelay < 1.) ?
@@ -4618,7 +4681,7 @@ bool Ship::DoHyperspaceLogic(vector<Visual> &visuals)
 	if(isUsingJumpDrive && !forget)
 	{
 		double sparkAmount = hyperspaceCount * Width() * Height() * .000006;
-		const map<const Effect *, double> &jumpEffects = attributes.JumpEffects();
+		const map<const Effect *, double> &jumpEffects = attributes->JumpEffects();
 		if(jumpEffects.empty())
 			CreateSparks(visuals, "jump drive", sparkAmount);
 		else
@@ -4753,7 +4816,7 @@ bool Ship::DoLandingLogic()
 	if(isDisabled)
 		landingPlanet = nullptr;
 
-	float landingSpeed = attributes.Get("landing speed");
+	float landingSpeed = attributes->Get("landing speed");
 	landingSpeed = landingSpeed > 0 ? landingSpeed : .02f;
 	// Special ships do not disappear forever when they land; they
 	// just slowly refuel.
@@ -4804,7 +4867,7 @@ bool Ship::DoLandingLogic()
 		}
 	}
 	// Only refuel if this planet has a spaceport.
-	else if(fuel >= attributes.Get("fuel capacity")
+	else if(fuel >= attributes->Get("fuel capacity")
 			|| !landingPlanet
 			|| !landingPlanet->GetPort().CanRecharge(Port::RechargeType::Fuel, isYours))
 	{
@@ -4813,7 +4876,7 @@ bool Ship::DoLandingLogic()
 		landingPlanet = nullptr;
 	}
 	else
-		fuel = min(fuel + 1., attributes.Get("fuel capacity"));
+		fuel = min(fuel + 1., attributes->Get("fuel capacity"));
 
 	// Move the ship at the velocity it had when it began landing, but
 	// scaled based on how small it is now.
@@ -4891,23 +4954,23 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 		if(commands.Turn())
 		{
 			// Check if we are able to turn.
-			double cost = attributes.Get("turning energy");
+			double cost = attributes->Get("turning energy");
 			if(cost > 0. && energy < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(energy / cost, commands.Turn()));
 
-			cost = attributes.Get("turning shields");
+			cost = attributes->Get("turning shields");
 			if(cost > 0. && shields < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(shields / cost, commands.Turn()));
 
-			cost = attributes.Get("turning hull");
+			cost = attributes->Get("turning hull");
 			if(cost > 0. && hull < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(hull / cost, commands.Turn()));
 
-			cost = attributes.Get("turning fuel");
+			cost = attributes->Get("turning fuel");
 			if(cost > 0. && fuel < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(fuel / cost, commands.Turn()));
 
-			cost = -attributes.Get("turning heat");
+			cost = -attributes->Get("turning heat");
 			if(cost > 0. && heat < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(heat / cost, commands.Turn()));
 
@@ -4921,19 +4984,19 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				// of the turning energy and produce a fraction of the heat.
 				double scale = fabs(commands.Turn());
 
-				shields -= scale * attributes.Get("turning shields");
-				hull -= scale * attributes.Get("turning hull");
-				energy -= scale * attributes.Get("turning energy");
-				fuel -= scale * attributes.Get("turning fuel");
-				heat += scale * attributes.Get("turning heat");
-				discharge += scale * attributes.Get("turning discharge");
-				corrosion += scale * attributes.Get("turning corrosion");
-				ionization += scale * attributes.Get("turning ion");
-				scrambling += scale * attributes.Get("turning scramble");
-				leakage += scale * attributes.Get("turning leakage");
-				burning += scale * attributes.Get("turning burn");
-				slowness += scale * attributes.Get("turning slowing");
-				disruption += scale * attributes.Get("turning disruption");
+				shields -= scale * attributes->Get("turning shields");
+				hull -= scale * attributes->Get("turning hull");
+				energy -= scale * attributes->Get("turning energy");
+				fuel -= scale * attributes->Get("turning fuel");
+				heat += scale * attributes->Get("turning heat");
+				discharge += scale * attributes->Get("turning discharge");
+				corrosion += scale * attributes->Get("turning corrosion");
+				ionization += scale * attributes->Get("turning ion");
+				scrambling += scale * attributes->Get("turning scramble");
+				leakage += scale * attributes->Get("turning leakage");
+				burning += scale * attributes->Get("turning burn");
+				slowness += scale * attributes->Get("turning slowing");
+				disruption += scale * attributes->Get("turning disruption");
 
 				Turn(commands.Turn() * TurnRate() * slowMultiplier);
 			}
@@ -4943,27 +5006,27 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 		if(thrustCommand)
 		{
 			// Check if we are able to apply this thrust.
-			double cost = attributes.Get((thrustCommand > 0.) ?
+			double cost = attributes->Get((thrustCommand > 0.) ?
 				"thrusting energy" : "reverse thrusting energy");
 			if(cost > 0. && energy < cost * fabs(thrustCommand))
 				thrustCommand = copysign(energy / cost, thrustCommand);
 
-			cost = attributes.Get((thrustCommand > 0.) ?
+			cost = attributes->Get((thrustCommand > 0.) ?
 				"thrusting shields" : "reverse thrusting shields");
 			if(cost > 0. && shields < cost * fabs(thrustCommand))
 				thrustCommand = copysign(shields / cost, thrustCommand);
 
-			cost = attributes.Get((thrustCommand > 0.) ?
+			cost = attributes->Get((thrustCommand > 0.) ?
 				"thrusting hull" : "reverse thrusting hull");
 			if(cost > 0. && hull < cost * fabs(thrustCommand))
 				thrustCommand = copysign(hull / cost, thrustCommand);
 
-			cost = attributes.Get((thrustCommand > 0.) ?
+			cost = attributes->Get((thrustCommand > 0.) ?
 				"thrusting fuel" : "reverse thrusting fuel");
 			if(cost > 0. && fuel < cost * fabs(thrustCommand))
 				thrustCommand = copysign(fuel / cost, thrustCommand);
 
-			cost = -attributes.Get((thrustCommand > 0.) ?
+			cost = -attributes->Get((thrustCommand > 0.) ?
 				"thrusting heat" : "reverse thrusting heat");
 			if(cost > 0. && heat < cost * fabs(thrustCommand))
 				thrustCommand = copysign(heat / cost, thrustCommand);
@@ -4973,27 +5036,27 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				// If a reverse thrust is commanded and the capability does not
 				// exist, ignore it (do not even slow under drag).
 				isThrusting = (thrustCommand > 0.);
-				isReversing = !isThrusting && attributes.Get("reverse thrust");
-				thrust = attributes.Get(isThrusting ? "thrust" : "reverse thrust");
+				isReversing = !isThrusting && attributes->Get("reverse thrust");
+				thrust = attributes->Get(isThrusting ? "thrust" : "reverse thrust");
 				IncrementThrusterHeld(isReversing ? ThrustKind::REVERSE : ThrustKind::FORWARD);
 				if(thrust)
 				{
 					double scale = fabs(thrustCommand);
 
-					shields -= scale * attributes.Get(isThrusting ? "thrusting shields" : "reverse thrusting shields");
-					hull -= scale * attributes.Get(isThrusting ? "thrusting hull" : "reverse thrusting hull");
-					energy -= scale * attributes.Get(isThrusting ? "thrusting energy" : "reverse thrusting energy");
-					fuel -= scale * attributes.Get(isThrusting ? "thrusting fuel" : "reverse thrusting fuel");
-					heat += scale * attributes.Get(isThrusting ? "thrusting heat" : "reverse thrusting heat");
-					discharge += scale * attributes.Get(isThrusting ? "thrusting discharge" : "reverse thrusting discharge");
-					corrosion += scale * attributes.Get(isThrusting ? "thrusting corrosion" : "reverse thrusting corrosion");
-					ionization += scale * attributes.Get(isThrusting ? "thrusting ion" : "reverse thrusting ion");
-					scrambling += scale * attributes.Get(isThrusting ? "thrusting scramble" :
+					shields -= scale * attributes->Get(isThrusting ? "thrusting shields" : "reverse thrusting shields");
+					hull -= scale * attributes->Get(isThrusting ? "thrusting hull" : "reverse thrusting hull");
+					energy -= scale * attributes->Get(isThrusting ? "thrusting energy" : "reverse thrusting energy");
+					fuel -= scale * attributes->Get(isThrusting ? "thrusting fuel" : "reverse thrusting fuel");
+					heat += scale * attributes->Get(isThrusting ? "thrusting heat" : "reverse thrusting heat");
+					discharge += scale * attributes->Get(isThrusting ? "thrusting discharge" : "reverse thrusting discharge");
+					corrosion += scale * attributes->Get(isThrusting ? "thrusting corrosion" : "reverse thrusting corrosion");
+					ionization += scale * attributes->Get(isThrusting ? "thrusting ion" : "reverse thrusting ion");
+					scrambling += scale * attributes->Get(isThrusting ? "thrusting scramble" :
 						"reverse thrusting scramble");
-					burning += scale * attributes.Get(isThrusting ? "thrusting burn" : "reverse thrusting burn");
-					leakage += scale * attributes.Get(isThrusting ? "thrusting leakage" : "reverse thrusting leakage");
-					slowness += scale * attributes.Get(isThrusting ? "thrusting slowing" : "reverse thrusting slowing");
-					disruption += scale * attributes.Get(isThrusting ? "thrusting disruption" : "reverse thrusting disruption");
+					burning += scale * attributes->Get(isThrusting ? "thrusting burn" : "reverse thrusting burn");
+					leakage += scale * attributes->Get(isThrusting ? "thrusting leakage" : "reverse thrusting leakage");
+					slowness += scale * attributes->Get(isThrusting ? "thrusting slowing" : "reverse thrusting slowing");
+					disruption += scale * attributes->Get(isThrusting ? "thrusting disruption" : "reverse thrusting disruption");
 
 					acceleration += angle.Unit() * thrustCommand * (isThrusting ? Acceleration() : ReverseAcceleration());
 				}
@@ -5003,22 +5066,22 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				&& !CannotAct(Ship::ActionType::AFTERBURNER);
 		if(applyAfterburner)
 		{
-			thrust = attributes.Get("afterburner thrust");
-			double shieldCost = attributes.Get("afterburner shields");
-			double hullCost = attributes.Get("afterburner hull");
-			double energyCost = attributes.Get("afterburner energy");
-			double fuelCost = attributes.Get("afterburner fuel");
-			double heatCost = -attributes.Get("afterburner heat");
-
-			double dischargeCost = attributes.Get("afterburner discharge");
-			double corrosionCost = attributes.Get("afterburner corrosion");
-			double ionCost = attributes.Get("afterburner ion");
-			double scramblingCost = attributes.Get("afterburner scramble");
-			double leakageCost = attributes.Get("afterburner leakage");
-			double burningCost = attributes.Get("afterburner burn");
-
-			double slownessCost = attributes.Get("afterburner slowing");
-			double disruptionCost = attributes.Get("afterburner disruption");
+			thrust = attributes->Get("afterburner thrust");
+			double shieldCost = attributes->Get("afterburner shields");
+			double hullCost = attributes->Get("afterburner hull");
+			double energyCost = attributes->Get("afterburner energy");
+			double fuelCost = attributes->Get("afterburner fuel");
+			double heatCost = -attributes->Get("afterburner heat");
+
+			double dischargeCost = attributes->Get("afterburner discharge");
+			double corrosionCost = attributes->Get("afterburner corrosion");
+			double ionCost = attributes->Get("afterburner ion");
+			double scramblingCost = attributes->Get("afterburner scramble");
+			double leakageCost = attributes->Get("afterburner leakage");
+			double burningCost = attributes->Get("afterburner burn");
+
+			double slownessCost = attributes->Get("afterburner slowing");
+			double disruptionCost = attributes->Get("afterburner disruption");
 
 			if(thrust && shields >= shieldCost && hull >= hullCost
 				&& energy >= energyCost && fuel >= fuelCost && heat >= heatCost)
@@ -5039,7 +5102,7 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				slowness += slownessCost;
 				disruption += disruptionCost;
 
-				acceleration += angle.Unit() * (1. + attributes.Get("acceleration multiplier")) * thrust / mass;
+				acceleration += angle.Unit() * (1. + attributes->Get("acceleration multiplier")) * thrust / mass;
 
 				// Only create the afterburner effects if the ship is in the player's system.
 				isUsingAfterburner = !forget;
@@ -5050,7 +5113,7 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 	{
 		acceleration *= slowMultiplier;
 		// Acceleration multiplier needs to modify effective drag, otherwise it changes top speeds.
-		Point dragAcceleration = acceleration - velocity * dragForce * (1. + attributes.Get("acceleration multiplier"));
+		Point dragAcceleration = acceleration - velocity * dragForce * (1. + attributes->Get("acceleration multiplier"));
 		// Make sure dragAcceleration has nonzero length, to avoid divide by zero.
 		if(dragAcceleration)
 		{
@@ -5125,7 +5188,7 @@ void Ship::StepTargeting()
 
 			if(distance < 10. && speed < 1. && ((CanBeCarried() && government == target->government) || !turn))
 			{
-				if(cloak && !attributes.Get("cloaked boarding"))
+				if(cloak && !attributes->Get("cloaked boarding"))
 				{
 					// Allow the player to get all the way to the end of the
 					// boarding sequence (including locking on to the ship) but
@@ -5217,16 +5280,16 @@ double Ship::MinimumHull() const
 		return 0.;
 
 	double maximumHull = MaxHull();
-	double absoluteThreshold = attributes.Get("absolute threshold");
+	double absoluteThreshold = attributes->Get(AttributeKey::ABSOLUTE_THRESHOLD);
 	if(absoluteThreshold > 0.)
 		return absoluteThreshold;
 
-	double thresholdPercent = attributes.Get("threshold percentage");
+	double thresholdPercent = attributes->Get(AttributeKey::THRESHOLD_PERCENTAGE);
 	double transition = 1 / (1 + 0.0005 * maximumHull);
 	double minimumHull = maximumHull * (thresholdPercent > 0.
 		? min(thresholdPercent, 1.) : 0.1 * (1. - transition) + 0.5 * transition);
 
-	return max(0., floor(minimumHull + attributes.Get("hull threshold")));
+	return max(0., floor(minimumHull + attributes->Get("hull threshold")));
 }
 
 
@@ -5303,7 +5366,7 @@ void Ship::CreateSparks(vector<Visual> &visuals, const Effect *effect, double am
 
 double Ship::CalculateAttraction() const
 {
-	return max(0., .4 * sqrt(attributes.Get("cargo space")) - 1.8);
+	return max(0., .4 * sqrt(attributes->Get("cargo space")) - 1.8);
 }
 
 
@@ -5337,13 +5400,13 @@ double Ship::CalculateDeterrence() const
 			// Other damage types don't outright destroy ships, so they aren't considered
 			// as heavily in the strength of a weapon.
 			double energyFactor = weapon->EnergyDamage()
-					+ weapon->RelativeEnergyDamage() * attributes.Get("energy capacity")
+					+ weapon->RelativeEnergyDamage() * attributes->Get("energy capacity")
 					+ weapon->IonDamage() * 100.;
 			double heatFactor = weapon->HeatDamage()
 					+ weapon->RelativeHeatDamage() * MaximumHeat()
 					+ weapon->BurnDamage() * 100.;
 			double fuelFactor = weapon->FuelDamage()
-					+ weapon->RelativeFuelDamage() * attributes.Get("fuel capacity")
+					+ weapon->RelativeFuelDamage() * attributes->Get("fuel capacity")
 					+ weapon->LeakDamage() * 100.;
 			double scramblingFactor = weapon->ScramblingDamage() * 100.;
 			double slowingFactor = weapon->SlowingDamage() * 100.;
@@ -5391,3 +5454,54 @@ void Ship::Jettison(shared_ptr<Flotsam> toJettison)
 		++bayIndex;
 	}
 }
+
+
+
+Outfit &Ship::MutableBaseAttributes()
+{
+	if(baseAttributes.use_count() > 1)
+		baseAttributes = make_shared<Outfit>(*baseAttributes);
+	return *baseAttributes;
+}
+
+
+
+map<const Outfit *, int> &Ship::MutableOutfits()
+{
+	if(outfits.use_count() > 1)
+		outfits = make_shared<map<const Outfit *, int>>(*outfits);
+	return *outfits;
+}
+
+
+
+// Count the bays of each category, once the bays are known.
+void Ship::CountBays()
+{
+	bayCounts.clear();
+	for(const Bay &bay : bays)
+	{
+		BayCount *count = GetBayCount(bay.category);
+		if(!count)
+			count = &bayCounts.emplace_back(bay.category);
+		++count->total;
+		count->free += !bay.ship;
+	}
+}
+
+
+
+Ship::BayCount *Ship::GetBayCount(const string &category)
+{
+	return const_cast<BayCount *>(as_const(*this).GetBayCount(category));
+}
+
+
+
+const Ship::BayCount *Ship::GetBayCount(const string &category) const
+{
+	for(const BayCount &count : bayCounts)
+		if(count.category == category)
+			return &count;
+	return nullptr;
+}
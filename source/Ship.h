@@ -31,6 +31,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ship/ShipAICache.h"
 #include "ShipEvent.h"
 #include "ShipJumpNavigation.h"
+#include "text/Translation.h"
 
 #include <array>
 #include <list>
@@ -177,9 +178,9 @@ public:
 	const std::string &DisplayModelName() const;
 	const std::string &PluralModelName() const;
 	/// Display/model name for current language (from lang: ship.name.<trueModelName>).
-	std::string TranslatedDisplayModelName() const;
+	const std::string &TranslatedDisplayModelName() const;
 	/// Plural model name for current language (from lang: ship.plural.<trueModelName>).
-	std::string TranslatedPluralModelName() const;
+	const std::string &TranslatedPluralModelName() const;
 	// Get the name of this ship as a variant.
 	const std::string &VariantName() const;
 	// Get the variant name to be displayed on the Shipyard tab of the Map screen.
@@ -197,7 +198,9 @@ public:
 	int64_t ChassisCost() const;
 	int64_t Strength() const;
 	// Get the attraction and deterrence of this ship, for pirate raids.
-	// This is only useful for the player's ships.
+	// This is only useful for the player's ships. Both are recalculated the
+	// first time they are asked for after the outfits change, so only call
+	// these from the main thread.
 	double Attraction() const;
 	double Deterrence() const;
 
@@ -270,6 +273,10 @@ public:
 	// Return true if any anti-missile or tractor beam systems are ready to fire.
 	bool HasAntiMissile() const;
 	bool HasTractorBeam() const;
+	// Get how far away the anti-missile or tractor beam systems that are ready
+	// to fire can reach.
+	double AntiMissileRange() const;
+	double TractorBeamRange() const;
 	// Fire an anti-missile at the given missile. Returns true if the missile was killed.
 	bool FireAntiMissile(const Projectile &projectile, std::vector<Visual> &visuals);
 	// Fire tractor beams at the given flotsam. Returns a Point representing the net
@@ -360,7 +367,7 @@ public:
 	void ClearTargetsAndOrders();
 	// Return events that happened recently, but haven't been handled by the Engine yet.
 	// Events should be removed from the given list after they are handled.
-	std::list<ShipEvent> &HandleEvents();
+	std::vector<ShipEvent> &HandleEvents();
 
 	// Get characteristics of this ship, as a fraction between 0 and 1.
 	double Shields() const;
@@ -553,11 +560,35 @@ public:
 	int GetLingerSteps() const;
 	// The AI wants the ship to linger for one AI step.
 	void Linger();
+	// The index of the AI's record of this ship, or -1 if it has none yet. A
+	// copy of a ship starts out with the same index, so the AI must check that
+	// the record really belongs to this ship before using it.
+	int AISlot() const;
+	void SetAISlot(int slot) const;
 
 	// Check if this ship looks the same as another, based on model display names and outfits.
 	bool Imitates(const Ship &other) const;
 
 
+private:
+	// The number of bays of one category, and how many of them are empty, so
+	// that checking for room does not have to look at every bay.
+	class BayCount {
+	public:
+		BayCount(const std::string &category) : category(category) {}
+		// Copying a ship does not copy the ships in its bays, so all of the
+		// copy's bays are empty.
+		BayCount(const BayCount &other) : category(other.category), total(other.total), free(other.total) {}
+		BayCount &operator=(const BayCount &other) { return *this = BayCount(other); }
+		BayCount(BayCount &&) = default;
+		BayCount &operator=(BayCount &&) = default;
+
+		std::string category;
+		int total = 0;
+		int free = 0;
+	};
+
+
 private:
 	// Various steps of Ship::Move:
 
@@ -607,6 +638,18 @@ private:
 	// Helper function for jettisoning flotsam.
 	void Jettison(std::shared_ptr<Flotsam> toJettison);
 
+	// Get the base attributes for modifying them, first making a copy of them
+	// if they are still shared with the ship this one was copied from.
+	Outfit &MutableBaseAttributes();
+	// The same, for the list of installed outfits.
+	std::map<const Outfit *, int> &MutableOutfits();
+
+	// Count the bays of each category, once the bays are known.
+	void CountBays();
+	// Get the count of bays of the given category, if this ship has any.
+	BayCount *GetBayCount(const std::string &category);
+	const BayCount *GetBayCount(const std::string &category) const;
+
 
 private:
 	// Protected member variables of the Body class:
@@ -627,6 +670,10 @@ private:
 	std::string variantMapShopName;
 	std::string noun;
 	Paragraphs description;
+	// The translations of the model names and description, which are keyed by the true model name.
+	Translation::Handle displayModelNameTranslation;
+	Translation::Handle pluralModelNameTranslation;
+	Translation::Handle descriptionTranslation;
 	const Sprite *thumbnail = nullptr;
 	// Characteristics of this particular ship:
 	EsUuid uuid;
@@ -665,11 +712,17 @@ private:
 	double cargoScan = 0.;
 	double outfitScan = 0.;
 
-	double attraction = 0.;
-	double deterrence = 0.;
+	// These are only calculated when needed, since outfitting a ship may
+	// add or remove many outfits one at a time.
+	mutable double attraction = 0.;
+	mutable double deterrence = 0.;
+	mutable bool attractionIsStale = true;
+	mutable bool deterrenceIsStale = true;
 
 	// Number of AI steps this ship has spent lingering
 	int lingerSteps = 0;
+	// The AI may assign this even to a ship it is only allowed to read.
+	mutable int aiSlot = -1;
 
 	Command commands;
 	FireCommand firingCommands;
@@ -679,15 +732,19 @@ private:
 	ShipAICache aiCache;
 
 	// Installed outfits, cargo, etc.:
-	Outfit baseAttributes;
+	// The base attributes and the installed outfits are shared by all the copies
+	// of a ship model, such as the ships in a fleet, until one of them changes them.
+	std::shared_ptr<Outfit> baseAttributes = std::make_shared<Outfit>();
 	bool addAttributes = false;
 	const Weapon *explosionWeapon = nullptr;
-	std::map<const Outfit *, int> outfits;
+	std::shared_ptr<std::map<const Outfit *, int>> outfits = std::make_shared<std::map<const Outfit *, int>>();
 	CargoHold cargo;
 	std::list<std::shared_ptr<Flotsam>> jettisoned;
 	std::list<std::pair<std::shared_ptr<Flotsam>, size_t>> jettisonedFromBay;
 
 	std::vector<Bay> bays;
+	// There are usually only one or two categories of bays, so this is a list.
+	std::vector<BayCount> bayCounts;
 	// Cache the mass of carried ships to avoid repeatedly recomputing it.
 	double carriedMass = 0.;
 
@@ -791,5 +848,5 @@ private:
 	// If this ship is disabled or dies as a result of something like corrosion damage,
 	// attribute the event to the last government that hit this ship.
 	const Government *lastHitBy = nullptr;
-	std::list<ShipEvent> unhandledEvents;
+	std::vector<ShipEvent> unhandledEvents;
 };
@@ -41,6 +41,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "image/Sprite.h"
 #include "shader/SpriteShader.h"
 #include "text/Table.h"
+#include "text/TextBatch.h"
 #include "text/Truncate.h"
 #include "UI.h"
 
@@ -134,11 +135,15 @@ void ShipInfoPanel::Draw()
 	ClearZones();
 	if(shipIt == panelState.Ships().end())
 		return;
-	Rectangle cargoBounds = infoPanelUi->GetBox("cargo");
-	DrawShipStats(infoPanelUi->GetBox("stats"));
-	DrawOutfits(infoPanelUi->GetBox("outfits"), cargoBounds);
-	DrawWeapons(infoPanelUi->GetBox("weapons"));
-	DrawCargo(cargoBounds);
+	{
+		// The tooltips are drawn over the sections, so they are not part of the batch.
+		TextBatch batch;
+		Rectangle cargoBounds = infoPanelUi->GetBox("cargo");
+		DrawShipStats(infoPanelUi->GetBox("stats"));
+		DrawOutfits(infoPanelUi->GetBox("outfits"), cargoBounds);
+		DrawWeapons(infoPanelUi->GetBox("weapons"));
+		DrawCargo(cargoBounds);
+	}
 
 	// If the player hovers their mouse over a ship attribute, show its tooltip.
 	info.DrawTooltips();
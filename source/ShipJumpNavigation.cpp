@@ -21,10 +21,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 
 using namespace std;
 
+namespace {
+	// Invalidate() may be called from any thread, so it only marks the cached
+	// neighbors as out of date. They are found again on the next SetSystem().
+	atomic<unsigned> generation = 0;
+}
+
 
 
 // Calibrate this ship's jump navigation information, caching its jump costs, range, and capabilities.
@@ -48,6 +55,9 @@ void ShipJumpNavigation::Calibrate(const Ship &ship)
 	// Check each outfit from this ship to determine if it has jump capabilities.
 	for(const auto &it : ship.Outfits())
 		ParseOutfit(*it.first);
+
+	jumpDriveSteps.assign(jumpDriveCosts.begin(), jumpDriveCosts.end());
+	CacheNeighbors();
 }
 
 
@@ -66,7 +76,10 @@ void ShipJumpNavigation::Recalibrate(const Ship &ship)
 // Pass the current system that the ship is in to the navigation.
 void ShipJumpNavigation::SetSystem(const System *system)
 {
+	if(system == currentSystem && neighborGeneration == generation.load(memory_order_relaxed))
+		return;
 	currentSystem = system;
+	CacheNeighbors();
 }
 
 
@@ -111,8 +124,9 @@ double ShipJumpNavigation::JumpDriveFuel(double distance) const
 	if(!hasJumpDrive)
 		return 0.;
 	// Otherwise, find the first jump range that covers the distance.
-	auto it = jumpDriveCosts.lower_bound(distance);
-	return (it == jumpDriveCosts.end()) ? 0. : it->second;
+	auto it = lower_bound(jumpDriveSteps.begin(), jumpDriveSteps.end(), distance,
+		[](const pair<double, double> &step, double value) { return step.first < value; });
+	return (it == jumpDriveSteps.end()) ? 0. : it->second;
 }
 
 
@@ -133,20 +147,13 @@ pair<JumpType, double> ShipJumpNavigation::GetCheapestJumpType(const System *fro
 {
 	if(!from || !to)
 		return make_pair(JumpType::NONE, 0.);
-	bool linked = from->Links().contains(to);
-	double hyperFuelNeeded = HyperdriveFuel();
-	// If these two systems are linked, or if the system we're jumping from has its own jump range,
-	// then use the cheapest jump drive available, which is mapped to a distance of 0.
-	const double distance = from->Position().Distance(to->Position());
-	double jumpFuelNeeded = JumpDriveFuel((linked || from->JumpRange())
-			? 0. : distance);
-	bool canJump = jumpFuelNeeded && (linked || !from->JumpRange() || from->JumpRange() >= distance);
-	if(linked && hasHyperdrive && (!canJump || hyperFuelNeeded <= jumpFuelNeeded))
-		return make_pair(JumpType::HYPERDRIVE, hyperFuelNeeded);
-	else if(hasJumpDrive && canJump)
-		return make_pair(JumpType::JUMP_DRIVE, jumpFuelNeeded);
-	else
-		return make_pair(JumpType::NONE, 0.);
+	if(from == currentSystem && neighborGeneration == generation.load(memory_order_relaxed))
+	{
+		auto it = neighborJumps.find(to);
+		if(it != neighborJumps.end())
+			return it->second;
+	}
+	return FindCheapestJumpType(from, to);
 }
 
 
@@ -157,6 +164,13 @@ bool ShipJumpNavigation::CanJump(const System *from, const System *to) const
 	if(!from || !to)
 		return false;
 
+	if(from == currentSystem && neighborGeneration == generation.load(memory_order_relaxed))
+	{
+		auto it = neighborJumps.find(to);
+		if(it != neighborJumps.end())
+			return it->second.first != JumpType::NONE;
+	}
+
 	if(from->Links().contains(to) && (hasHyperdrive || hasJumpDrive))
 		return true;
 
@@ -164,7 +178,7 @@ bool ShipJumpNavigation::CanJump(const System *from, const System *to) const
 		return false;
 
 	const double distanceSquared = from->Position().DistanceSquared(to->Position());
-	double maxRange = from->JumpRange() ? from->JumpRange() : jumpDriveCosts.rbegin()->first;
+	double maxRange = from->JumpRange() ? from->JumpRange() : jumpDriveSteps.back().first;
 	return maxRange * maxRange >= distanceSquared;
 }
 
@@ -225,6 +239,15 @@ size_t ShipJumpNavigation::Hash() const
 
 
 
+// Mark every ship's cached jumps out of its current system as out of date.
+// This must be done whenever the links between systems may have changed.
+void ShipJumpNavigation::Invalidate()
+{
+	++generation;
+}
+
+
+
 // Parse the given outfit to determine if it has the capability to jump, and update any
 // jump information accordingly.
 void ShipJumpNavigation::ParseOutfit(const Outfit &outfit)
@@ -297,3 +320,42 @@ void ShipJumpNavigation::UpdateJumpDriveCosts(double distance, double cost)
 		}
 	}
 }
+
+
+
+// Work out the cheapest jump between two systems from scratch.
+pair<JumpType, double> ShipJumpNavigation::FindCheapestJumpType(const System *from, const System *to) const
+{
+	bool linked = from->Links().contains(to);
+	double hyperFuelNeeded = HyperdriveFuel();
+	// If these two systems are linked, or if the system we're jumping from has its own jump range,
+	// then use the cheapest jump drive available, which is mapped to a distance of 0.
+	const double distance = from->Position().Distance(to->Position());
+	double jumpFuelNeeded = JumpDriveFuel((linked || from->JumpRange())
+			? 0. : distance);
+	bool canJump = jumpFuelNeeded && (linked || !from->JumpRange() || from->JumpRange() >= distance);
+	if(linked && hasHyperdrive && (!canJump || hyperFuelNeeded <= jumpFuelNeeded))
+		return make_pair(JumpType::HYPERDRIVE, hyperFuelNeeded);
+	else if(hasJumpDrive && canJump)
+		return make_pair(JumpType::JUMP_DRIVE, jumpFuelNeeded);
+	else
+		return make_pair(JumpType::NONE, 0.);
+}
+
+
+
+// Cache the cheapest jump from the current system to each of its neighbors, since
+// the AI and the route finding ask about those jumps over and over.
+void ShipJumpNavigation::CacheNeighbors()
+{
+	neighborJumps.clear();
+	neighborGeneration = generation.load(memory_order_relaxed);
+	if(!currentSystem || !HasAnyDrive())
+		return;
+
+	for(const System *link : currentSystem->Links())
+		neighborJumps.emplace(link, FindCheapestJumpType(currentSystem, link));
+	if(hasJumpDrive)
+		for(const System *neighbor : currentSystem->JumpNeighbors(maxJumpRange))
+			neighborJumps.emplace(neighbor, FindCheapestJumpType(currentSystem, neighbor));
+}
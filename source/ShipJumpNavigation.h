@@ -18,6 +18,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "JumpType.h"
 
 #include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 class Outfit;
 class Ship;
@@ -65,6 +68,10 @@ public:
 	// Create a hash of the capabilities of this ship, for use in caching pathfinding.
 	std::size_t Hash() const;
 
+	// Mark every ship's cached jumps out of its current system as out of date.
+	// This must be done whenever the links between systems may have changed.
+	static void Invalidate();
+
 
 private:
 	// Parse the given outfit to determine if it has the capability to jump, and update any
@@ -73,6 +80,10 @@ private:
 	// Add the given distance, cost pair to the jump drive costs and update the fuel cost
 	// of each jump distance if necessary.
 	void UpdateJumpDriveCosts(double distance, double cost);
+	// Work out the cheapest jump between two systems from scratch.
+	std::pair<JumpType, double> FindCheapestJumpType(const System *from, const System *to) const;
+	// Cache the cheapest jump from the current system to each of its neighbors.
+	void CacheNeighbors();
 
 
 private:
@@ -85,7 +96,14 @@ private:
 	double hyperdriveCost = 0.;
 	// Map allowable jump ranges to the fuel required to jump at that range.
 	std::map<double, double> jumpDriveCosts;
+	// The same costs as a step function sorted by distance, which is faster to
+	// search than the map.
+	std::vector<std::pair<double, double>> jumpDriveSteps;
 	double maxJumpRange = 0.;
+	// The cheapest jump to each neighbor of the current system, and the
+	// generation of the links that it was found for.
+	std::unordered_map<const System *, std::pair<JumpType, double>> neighborJumps;
+	unsigned neighborGeneration = 0;
 
 	// What drive types and characteristics the ship has.
 	bool hasHyperdrive = false;
@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "ConditionSet.h"
 #include "DataNode.h"
+#include "IndexedSet.h"
 #include "LocationFilter.h"
 #include "Sale.h"
 #include "Set.h"
@@ -37,10 +38,10 @@ class Shop {
 public:
 	Shop();
 	Shop(const DataNode &node, const Set<Item> &items, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 
 	void Load(const DataNode &node, const Set<Item> &items, const ConditionsStore *playerConditions,
-		const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets);
+		const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets);
 
 	// This shop's name.
 	const std::string &Name() const;
@@ -71,7 +72,7 @@ Shop<Item>::Shop()
 
 template<class Item>
 Shop<Item>::Shop(const DataNode &node, const Set<Item> &items, const ConditionsStore *playerConditions,
-	const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	Load(node, items, playerConditions, visitedSystems, visitedPlanets);
 }
@@ -80,7 +81,7 @@ Shop<Item>::Shop(const DataNode &node, const Set<Item> &items, const ConditionsS
 
 template<class Item>
 void Shop<Item>::Load(const DataNode &node, const Set<Item> &items, const ConditionsStore *playerConditions,
-	const std::set<const System *> *visitedSystems, const std::set<const Planet *> *visitedPlanets)
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets)
 {
 	name = node.Token(1);
 	// If an event or second definition updates this shop, clear the stock
@@ -301,6 +301,7 @@ bool ShopPanel::ShouldHighlight(const Ship *ship)
 // Only override the ones you need; the default action is to return false.
 bool ShopPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool isNewPress)
 {
+	shownItemsAreStale = true;
 	if(key == 'l' || key == 'd' || key == SDLK_ESCAPE
 			|| (key == 'w' && (mod & (KMOD_CTRL | KMOD_GUI))))
 	{
@@ -460,6 +461,7 @@ bool ShopPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 
 bool ShopPanel::Click(int x, int y, MouseButton button, int clicks)
 {
+	shownItemsAreStale = true;
 	auto ScrollbarClick = [x, y, button, clicks](ScrollBar &scrollbar, ScrollVar<double> &scroll)
 	{
 		return ScrollbarMaybeUpdate([x, y, button, clicks](ScrollBar &scrollbar)
@@ -902,6 +904,7 @@ void ShopPanel::DrawMain()
 	const Sprite *expandedArrow = SpriteSet::Get("ui/expanded");
 
 	mainScroll.Step();
+	UpdateShownItems();
 
 	// Draw all the available items.
 	// First, figure out how many columns we can draw.
@@ -923,8 +926,8 @@ void ShopPanel::DrawMain()
 	for(const auto &cat : categories)
 	{
 		const string &category = cat.Name();
-		map<string, vector<string>>::const_iterator it = catalog.find(category);
-		if(it == catalog.end())
+		map<string, vector<string>>::const_iterator it = shownItems.find(category);
+		if(it == shownItems.end())
 			continue;
 
 		// This should never happen, but bail out if we don't know what planet
@@ -932,19 +935,16 @@ void ShopPanel::DrawMain()
 		if(!planet)
 			break;
 
-		const string displayCategory = Translation::TrCategory(category);
+		const string &displayCategory = cat.TranslatedName();
 
 		Point side(Screen::Left() + 5., point.Y() - TILE_SIZE / 2 + 10);
 		point.Y() += bigFont.Height() + 20;
 		nextY += bigFont.Height() + 20;
 
 		bool isCollapsed = collapsed.contains(category);
-		bool isEmpty = true;
+		bool isEmpty = it->second.empty();
 		for(const string &name : it->second)
 		{
-			if(!HasItem(name))
-				continue;
-			isEmpty = false;
 			if(isCollapsed)
 				break;
 
@@ -1004,6 +1004,29 @@ void ShopPanel::DrawMain()
 
 
 
+void ShopPanel::UpdateShownItems()
+{
+	// Anything may have changed while a dialog was shown over this panel.
+	bool isTop = GetUI().IsTop(this);
+	if(!isTop || !wasTop)
+		shownItemsAreStale = true;
+	wasTop = isTop;
+	if(!shownItemsAreStale)
+		return;
+
+	shownItemsAreStale = false;
+	shownItems.clear();
+	for(const auto &[category, names] : catalog)
+	{
+		vector<string> &shown = shownItems[category];
+		for(const string &name : names)
+			if(HasItem(name))
+				shown.push_back(name);
+	}
+}
+
+
+
 int ShopPanel::DrawPlayerShipInfo(const Point &point)
 {
 	shipInfo.Update(*playerShip, player, collapsed.contains("description"), true);
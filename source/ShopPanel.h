@@ -206,6 +206,9 @@ private:
 	void DrawShipsSidebar();
 	void DrawDetailsSidebar();
 	void DrawMain();
+	// Find the items in each category that HasItem() accepts, if anything
+	// that this may depend on could have changed since they were last found.
+	void UpdateShownItems();
 
 	int DrawPlayerShipInfo(const Point &point);
 
@@ -237,4 +240,11 @@ private:
 	const Color &back;
 
 	bool checkedHelp = false;
+
+	// The items in each category that HasItem() accepted. Which items are shown
+	// only changes when the player does something in this panel, or in a dialog
+	// that is shown over it, so the catalog is not checked again every frame.
+	std::map<std::string, std::vector<std::string>> shownItems;
+	bool shownItemsAreStale = true;
+	bool wasTop = false;
 };
@@ -26,7 +26,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Random.h"
 #include "Screen.h"
 #include "TextArea.h"
-#include "text/Translation.h"
 #include "UI.h"
 
 using namespace std;
@@ -105,8 +104,7 @@ void SpaceportPanel::Draw()
 	// in the meantime, for example if the player accepts a mission on the Job Board.
 	// Use current language font so Cyrillic (and other scripts) render correctly.
 	description->SetFont(FontSet::Get(14));
-	description->SetText(Translation::TrSpaceportDescription(player.GetPlanet()->TrueName(),
-		port.Description().ToString()));
+	description->SetText(player.GetPlanet()->TranslatedSpaceportDescription());
 
 	if(hasNews)
 	{
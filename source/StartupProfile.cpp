@@ -0,0 +1,212 @@
+/* StartupProfile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "StartupProfile.h"
+
+#include "DiskCache.h"
+#include "Files.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+using namespace std;
+
+namespace {
+	struct Record {
+		const char *stage;
+		filesystem::path file;
+		uintmax_t bytes;
+		chrono::nanoseconds duration;
+	};
+
+	// The totals for one line of the report.
+	struct Total {
+		int64_t count = 0;
+		uintmax_t bytes = 0;
+		chrono::nanoseconds duration{};
+	};
+
+	atomic<bool> isEnabled = false;
+	filesystem::path reportPath;
+	chrono::steady_clock::time_point epoch;
+
+	mutex recordsMutex;
+	vector<Record> records;
+
+	// Get the name to show for the source folder that a file was loaded from.
+	string SourceName(const filesystem::path &source)
+	{
+		if(source == Files::Resources())
+			return "(base game)";
+		// Plugin folders may be given with a trailing separator.
+		filesystem::path name = source.filename();
+		if(name.empty())
+			name = source.parent_path().filename();
+		return name.string();
+	}
+
+	void AddTo(map<string, Total> &totals, const string &name, const Record &record)
+	{
+		Total &total = totals[name];
+		++total.count;
+		total.bytes += record.bytes;
+		total.duration += record.duration;
+	}
+
+	string Pad(string text, size_t width)
+	{
+		if(text.length() < width)
+			text.insert(0, width - text.length(), ' ');
+		return text;
+	}
+
+	string Milliseconds(chrono::nanoseconds duration)
+	{
+		const int64_t tenths = duration.count() / 100000;
+		return to_string(tenths / 10) + '.' + to_string(tenths % 10);
+	}
+
+	// Write a table of the given totals, from the most time spent to the least.
+	void WriteTable(string &out, const string &title, const map<string, Total> &totals)
+	{
+		vector<const pair<const string, Total> *> sorted;
+		sorted.reserve(totals.size());
+		for(const auto &it : totals)
+			sorted.push_back(&it);
+		sort(sorted.begin(), sorted.end(),
+			[](const auto *a, const auto *b) { return a->second.duration > b->second.duration; });
+
+		out += '\n' + title + ":\n";
+		out += Pad("time (ms)", 12) + Pad("bytes", 14) + Pad("count", 8) + "  name\n";
+		for(const auto *it : sorted)
+			out += Pad(Milliseconds(it->second.duration), 12) + Pad(to_string(it->second.bytes), 14)
+				+ Pad(to_string(it->second.count), 8) + "  " + it->first + '\n';
+	}
+}
+
+
+
+StartupProfile::Scope::Scope(const char *stage, const filesystem::path &file, bool countBytes)
+	: stage(stage)
+{
+	if(!isEnabled.load(memory_order_relaxed))
+		return;
+
+	this->file = file;
+	if(countBytes && !file.empty())
+		bytes = FileSize(file);
+	start = chrono::steady_clock::now();
+}
+
+
+
+StartupProfile::Scope::~Scope() noexcept
+{
+	// If the profile was enabled while this stage was running, it has no start time.
+	if(!isEnabled.load(memory_order_relaxed) || !start.time_since_epoch().count())
+		return;
+
+	const chrono::nanoseconds duration = chrono::steady_clock::now() - start;
+	try {
+		lock_guard<mutex> lock(recordsMutex);
+		records.push_back({stage, std::move(file), bytes, duration});
+	}
+	catch(...)
+	{
+		// Losing a single stage is better than losing the whole game.
+	}
+}
+
+
+
+// Count additional bytes that were read by this stage.
+void StartupProfile::Scope::AddBytes(uintmax_t bytes) noexcept
+{
+	this->bytes += bytes;
+}
+
+
+
+// Start recording the startup stages, to be written to the given path.
+void StartupProfile::Enable(const filesystem::path &path)
+{
+	reportPath = path;
+	epoch = chrono::steady_clock::now();
+	isEnabled = true;
+}
+
+
+
+bool StartupProfile::IsEnabled() noexcept
+{
+	return isEnabled.load(memory_order_relaxed);
+}
+
+
+
+// Get the size of the given file, or 0 if it is not a regular file (for
+// example, if it is inside a zipped plugin).
+uintmax_t StartupProfile::FileSize(const filesystem::path &path) noexcept
+{
+	error_code error;
+	const uintmax_t size = filesystem::file_size(path, error);
+	return error ? 0 : size;
+}
+
+
+
+// Write the report and stop recording. Each file is attributed to the
+// innermost of the given source folders that contains it.
+void StartupProfile::WriteReport(const vector<filesystem::path> &sources)
+{
+	if(!isEnabled.exchange(false))
+		return;
+
+	const chrono::nanoseconds elapsed = chrono::steady_clock::now() - epoch;
+	map<string, Total> stages;
+	map<string, Total> plugins;
+	map<string, Total> files;
+	{
+		lock_guard<mutex> lock(recordsMutex);
+		for(const Record &record : records)
+		{
+			AddTo(stages, record.stage, record);
+			if(record.file.empty())
+				continue;
+
+			AddTo(files, record.file.generic_string(), record);
+			const filesystem::path *source = nullptr;
+			for(const filesystem::path &it : sources)
+				if(Files::IsParent(it, record.file) && (!source || Files::IsParent(*source, it)))
+					source = &it;
+			AddTo(plugins, source ? SourceName(*source) : "(other)", record);
+		}
+		records.clear();
+	}
+
+	string out = "Startup took " + Milliseconds(elapsed) + " ms.\n"
+		"Stages that run in parallel may add up to more than that.\n";
+	WriteTable(out, "Stages", stages);
+	WriteTable(out, "Plugins", plugins);
+	WriteTable(out, "Files", files);
+	out += '\n' + DiskCache::Report();
+
+	Files::Write(reportPath, out);
+	Logger::Log("Wrote the startup profile to \"" + reportPath.string() + "\".", Logger::Level::INFO);
+}
@@ -0,0 +1,69 @@
+/* StartupProfile.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+
+
+// Records how long each stage of starting the game takes, and how many bytes
+// of data it reads, so that a slow startup can be traced back to the files and
+// plugins that cause it. Stages may be recorded from any thread. The report,
+// which lists the stages, plugins and files from the most time spent to the
+// least, is written once the game has finished loading. When the profile is
+// disabled, timing a stage only costs a single check of a flag.
+class StartupProfile {
+public:
+	// Times one stage of startup from the construction of this object until it
+	// goes out of scope. The stage name must be a string literal. If the stage
+	// works on a file, the time is also added to the file and to the plugin that
+	// contains it, and unless the file was already counted by another stage, its
+	// size is added to the bytes read.
+	class Scope {
+	public:
+		explicit Scope(const char *stage, const std::filesystem::path &file = {}, bool countBytes = true);
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+		~Scope() noexcept;
+
+		// Count additional bytes that were read by this stage.
+		void AddBytes(uintmax_t bytes) noexcept;
+
+
+	private:
+		const char *stage;
+		std::filesystem::path file;
+		uintmax_t bytes = 0;
+		std::chrono::steady_clock::time_point start;
+	};
+
+
+public:
+	// Start recording the startup stages, to be written to the given path.
+	static void Enable(const std::filesystem::path &path);
+	static bool IsEnabled() noexcept;
+
+	// Get the size of the given file, or 0 if it is not a regular file (for
+	// example, if it is inside a zipped plugin).
+	static uintmax_t FileSize(const std::filesystem::path &path) noexcept;
+
+	// Write the report and stop recording. Each file is attributed to the
+	// innermost of the given source folders that contains it.
+	static void WriteReport(const std::vector<std::filesystem::path> &sources);
+};
@@ -15,33 +15,82 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "StringInterner.h"
 
+#include <deque>
 #include <mutex>
-#include <set>
 #include <shared_mutex>
-#include <string>
+#include <string_view>
+#include <vector>
 
 using namespace std;
 
+namespace {
+	// The number of shards must be a power of two.
+	constexpr size_t SHARDS = 32;
 
+	// A part of the set of interned strings, which is an open-addressing hash
+	// table. The records themselves are stored in a deque, so they never move.
+	class Shard {
+	public:
+		const StringInterner::Record *Find(string_view key, size_t hash) const
+		{
+			if(table.empty())
+				return nullptr;
+			const size_t mask = table.size() - 1;
+			for(size_t i = (hash / SHARDS) & mask; table[i]; i = (i + 1) & mask)
+				if(table[i]->hash == hash && table[i]->text == key)
+					return table[i];
+			return nullptr;
+		}
 
-// String interning: return a pointer to a character string that matches the
-// given string but has static storage duration.
-const char *StringInterner::Intern(const char *key)
-{
-	static set<string> interned;
-	static shared_mutex m;
+		const StringInterner::Record *Add(string_view key, size_t hash)
+		{
+			records.push_back({hash, string(key)});
+			if(table.size() < 2 * records.size())
+			{
+				table.assign(table.empty() ? 64 : 2 * table.size(), nullptr);
+				for(const StringInterner::Record &record : records)
+					Insert(record);
+			}
+			else
+				Insert(records.back());
+			return &records.back();
+		}
 
-	// Search using a shared lock, allows parallel access by multiple threads.
+	public:
+		shared_mutex lock;
+
+	private:
+		void Insert(const StringInterner::Record &record)
+		{
+			const size_t mask = table.size() - 1;
+			size_t i = (record.hash / SHARDS) & mask;
+			while(table[i])
+				i = (i + 1) & mask;
+			table[i] = &record;
+		}
+
+	private:
+		deque<StringInterner::Record> records;
+		vector<const StringInterner::Record *> table;
+	};
+
+	// The shards are only created when first used, since strings may be interned
+	// during static initialization.
+	Shard &GetShard(size_t hash)
 	{
-		shared_lock readLock(m);
-		auto it = interned.find(key);
-		if(it != interned.end())
-			return it->c_str();
+		static Shard shards[SHARDS];
+		return shards[hash % SHARDS];
 	}
+}
+
 
-	// Insert using an exclusive lock, if needed. Blocks all parallel access.
-	unique_lock writeLock(m);
-	return interned.insert(key).first->c_str();
+
+// String interning: return a pointer to a character string that matches the
+// given string but has static storage duration.
+const char *StringInterner::Intern(const char *key)
+{
+	const Record *record = InternRecord(key);
+	return record ? record->text.c_str() : "";
 }
 
 
@@ -50,3 +99,28 @@ const char *StringInterner::Intern(const string key)
 {
 	return Intern(key.c_str());
 }
+
+
+
+// Intern a string and get its record. The empty string has no record.
+const StringInterner::Record *StringInterner::InternRecord(const char *key)
+{
+	const string_view view(key);
+	if(view.empty())
+		return nullptr;
+	const size_t hash = std::hash<string_view>{}(view);
+	Shard &shard = GetShard(hash);
+
+	// Search using a shared lock, allows parallel access by multiple threads.
+	{
+		shared_lock readLock(shard.lock);
+		if(const Record *record = shard.Find(view, hash))
+			return record;
+	}
+
+	// Insert using an exclusive lock, if needed. Only blocks access to this shard.
+	unique_lock writeLock(shard.lock);
+	if(const Record *record = shard.Find(view, hash))
+		return record;
+	return shard.Add(view, hash);
+}
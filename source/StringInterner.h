@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <string>
 
 
@@ -22,9 +24,53 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // This class stores a set of interned strings. Interning can be a slow operation during string creation/interning, but
 // it will allow fast char-pointer based comparisons when comparing two interned strings (because interning ensures that
 // each interned string only appears once in the set). Full string compares will still be needed when comparing interned
-// strings to non-interned strings.
+// strings to non-interned strings. The strings are split between a number of independently locked shards, so that
+// threads interning different strings rarely wait for each other.
 class StringInterner {
+public:
+	// An interned string, along with its precomputed hash.
+	class Record {
+	public:
+		size_t hash;
+		std::string text;
+	};
+
+
 public:
 	static const char *Intern(const char *key);
 	static const char *Intern(const std::string key);
+	// Intern a string and get its record. The empty string has no record.
+	static const Record *InternRecord(const char *key);
+};
+
+
+
+// A handle to an interned string. Two handles are equal only if they refer to
+// the same string, which is checked by comparing a single pointer, and their
+// hash is computed only once, when the string is first interned.
+class InternedString {
+public:
+	InternedString() noexcept = default;
+	explicit InternedString(const char *text) : record(StringInterner::InternRecord(text)) {}
+	explicit InternedString(const std::string &text) : InternedString(text.c_str()) {}
+
+	const char *c_str() const noexcept { return record ? record->text.c_str() : ""; }
+	const std::string &str() const noexcept { return record ? record->text : EMPTY; }
+	size_t Hash() const noexcept { return record ? record->hash : 0; }
+	bool empty() const noexcept { return !record; }
+
+	bool operator==(const InternedString &other) const noexcept { return record == other.record; }
+
+
+private:
+	static inline const std::string EMPTY;
+
+	const StringInterner::Record *record = nullptr;
+};
+
+
+
+template<>
+struct std::hash<InternedString> {
+	size_t operator()(const InternedString &string) const noexcept { return string.Hash(); }
 };
@@ -30,6 +30,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
+#include <mutex>
 
 using namespace std;
 
@@ -42,6 +43,20 @@ namespace {
 	const double VOLUME = 2000.;
 	// Above this supply amount, price differences taper off:
 	const double LIMIT = 20000.;
+
+	// The number that the next system to be indexed will get.
+	int nextIndex = 0;
+
+	// Find the index of the commodity with the given name. There are only a few
+	// commodities, so a linear search beats looking them up in a map.
+	size_t CommodityIndex(const string &name)
+	{
+		const vector<Trade::Commodity> &commodities = GameData::Commodities();
+		for(size_t i = 0; i < commodities.size(); ++i)
+			if(commodities[i].name == name)
+				return i;
+		return commodities.size();
+	}
 }
 
 const double System::DEFAULT_NEIGHBOR_DISTANCE = 100.;
@@ -96,6 +111,8 @@ void System::Load(const DataNode &node, Set<Planet> &planets, const ConditionsSt
 	if(node.Size() < 2)
 		return;
 	trueName = node.Token(1);
+	// The objects may be changed, so their positions need to be worked out again.
+	positionsUpdated.isSet = false;
 	isDefined = true;
 
 	// Track planets associated with removed objects. Check if remaining objects
@@ -161,7 +178,7 @@ void System::Load(const DataNode &node, Set<Planet> &planets, const ConditionsSt
 				ramscoopMultiplier = 1.;
 			}
 			else if(key == "trade")
-				trade.clear();
+				tradeBase.clear();
 			else if(key == "fleet")
 				fleets.clear();
 			else if(key == "hazard")
@@ -404,7 +421,7 @@ void System::Load(const DataNode &node, Set<Planet> &planets, const ConditionsSt
 		else if(key == "starfield density")
 			starfieldDensity = child.Value(valueIndex);
 		else if(key == "trade" && child.Size() >= 3)
-			trade[value].SetBase(child.Value(valueIndex + 1));
+			tradeBase[value] = child.Value(valueIndex + 1);
 		else if(key == "arrival")
 		{
 			if(hasValue)
@@ -521,6 +538,23 @@ void System::Load(const DataNode &node, Set<Planet> &planets, const ConditionsSt
 // if the system is inhabited.
 void System::UpdateSystem(const Set<System> &systems, const set<double> &neighborDistances)
 {
+	// Put the prices in the order of the commodities, keeping the current
+	// supply of each one that was already traded here.
+	const vector<Trade::Commodity> &commodities = GameData::Commodities();
+	trade.resize(commodities.size());
+	for(size_t i = 0; i < commodities.size(); ++i)
+	{
+		Price &price = trade[i];
+		const auto it = tradeBase.find(commodities[i].name);
+		if(it == tradeBase.end())
+			price = Price();
+		else if(!price.isTraded || price.base != it->second)
+		{
+			price.isTraded = true;
+			price.SetBase(it->second);
+		}
+	}
+
 	accessibleLinks.clear();
 	neighbors.clear();
 
@@ -603,6 +637,21 @@ void System::Unlink(System *other)
 
 
 
+void System::AssignIndex()
+{
+	if(index < 0)
+		index = nextIndex++;
+}
+
+
+
+int System::Index() const
+{
+	return index;
+}
+
+
+
 // Check that this system has been loaded and given a position.
 bool System::IsValid() const
 {
@@ -728,7 +777,7 @@ System::SolarGeneration System::GetSolarGeneration(const Point &shipPosition,
 	double shipRamscoop, double shipCollection, double shipCollectionHeat) const
 {
 	SolarGeneration generation{ramscoopAddend, 0., 0.};
-	for(const auto &stellar : objects)
+	for(const auto &stellar : Objects())
 	{
 		double power = GameData::SolarPower(stellar.GetSprite());
 		double wind = GameData::SolarWind(stellar.GetSprite());
@@ -794,37 +843,64 @@ const set<const System *> &System::VisibleNeighbors() const
 
 
 
-// Move the stellar objects to their positions on the given date.
+// Set the date that the stellar objects' positions are for. Most systems are
+// never looked at on a given day, so their positions are only worked out once
+// something asks for them.
 void System::SetDate(const Date &date)
 {
 	double now = date.DaysSinceEpoch();
+	if(now != day)
+	{
+		day = now;
+		positionsUpdated.isSet = false;
+	}
 
 	for(StellarObject &object : objects)
+		if(object.planet)
+			object.planet->ResetDefense();
+}
+
+
+
+// Get the stellar object locations on the most recently set date.
+const vector<StellarObject> &System::Objects() const
+{
+	if(!positionsUpdated.isSet.load(memory_order_acquire))
+		UpdatePositions();
+	return objects;
+}
+
+
+
+// Move the stellar objects to their positions on the day that was last set.
+// The AI and drawing threads may both ask for them first, so only one of them
+// does the work.
+void System::UpdatePositions() const
+{
+	static mutex updateMutex;
+	lock_guard<mutex> lock(updateMutex);
+	if(positionsUpdated.isSet.load(memory_order_relaxed))
+		return;
+
+	// The positions only depend on the date, so they are not part of what makes
+	// a system const.
+	vector<StellarObject> &moving = const_cast<vector<StellarObject> &>(objects);
+	for(StellarObject &object : moving)
 	{
 		// "offset" is used to allow binary orbits; the second object is offset
 		// by 180 degrees.
-		object.angle = Angle(now * object.speed + object.offset);
+		object.angle = Angle(day * object.speed + object.offset);
 		object.position = object.angle.Unit() * object.distance;
 
 		// Because of the order of the vector, the parent's position has always
 		// been updated before this loop reaches any of its children, so:
 		if(object.parent >= 0)
-			object.position += objects[object.parent].position;
+			object.position += moving[object.parent].position;
 
 		if(object.position)
 			object.angle = Angle(object.position);
-
-		if(object.planet)
-			object.planet->ResetDefense();
 	}
-}
-
-
-
-// Get the stellar object locations on the most recently set date.
-const vector<StellarObject> &System::Objects() const
-{
-	return objects;
+	positionsUpdated.isSet.store(true, memory_order_release);
 }
 
 
@@ -833,7 +909,7 @@ const vector<StellarObject> &System::Objects() const
 const StellarObject *System::FindStellar(const Planet *planet) const
 {
 	if(planet)
-		for(const StellarObject &object : objects)
+		for(const StellarObject &object : Objects())
 			if(object.GetPlanet() == planet)
 				return &object;
 
@@ -968,15 +1044,21 @@ const Sprite *System::Haze() const
 // Get the price of the given commodity in this system.
 int System::Trade(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.price;
+	return Trade(CommodityIndex(commodity));
+}
+
+
+
+int System::Trade(size_t commodity) const
+{
+	return commodity < trade.size() ? trade[commodity].price : 0;
 }
 
 
 
 bool System::HasTrade() const
 {
-	return !trade.empty();
+	return any_of(trade.begin(), trade.end(), [](const Price &price) { return price.isTraded; });
 }
 
 
@@ -984,12 +1066,14 @@ bool System::HasTrade() const
 // Update the economy.
 void System::StepEconomy()
 {
-	for(auto &it : trade)
+	for(Price &price : trade)
 	{
-		it.second.exports = EXPORT * it.second.supply;
-		it.second.supply *= KEEP;
-		it.second.supply += Random::Normal() * VOLUME;
-		it.second.Update();
+		if(!price.isTraded)
+			continue;
+		price.exports = EXPORT * price.supply;
+		price.supply *= KEEP;
+		price.supply += Random::Normal() * VOLUME;
+		price.Update();
 	}
 }
 
@@ -997,28 +1081,46 @@ void System::StepEconomy()
 
 void System::SetSupply(const string &commodity, double tons)
 {
-	auto it = trade.find(commodity);
-	if(it == trade.end())
+	SetSupply(CommodityIndex(commodity), tons);
+}
+
+
+
+void System::SetSupply(size_t commodity, double tons)
+{
+	if(commodity >= trade.size() || !trade[commodity].isTraded)
 		return;
 
-	it->second.supply = tons;
-	it->second.Update();
+	trade[commodity].supply = tons;
+	trade[commodity].Update();
 }
 
 
 
 double System::Supply(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.supply;
+	return Supply(CommodityIndex(commodity));
+}
+
+
+
+double System::Supply(size_t commodity) const
+{
+	return commodity < trade.size() ? trade[commodity].supply : 0.;
 }
 
 
 
 double System::Exports(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.exports;
+	return Exports(CommodityIndex(commodity));
+}
+
+
+
+double System::Exports(size_t commodity) const
+{
+	return commodity < trade.size() ? trade[commodity].exports : 0.;
 }
 
 
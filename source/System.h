@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "StellarObject.h"
 #include "WeightedList.h"
 
+#include <atomic>
 #include <set>
 #include <string>
 #include <vector>
@@ -77,13 +78,19 @@ public:
 	// Load a system's description.
 	void Load(const DataNode &node, Set<Planet> &planets, const ConditionsStore *playerConditions);
 	// Update any information about the system that may have changed due to events,
-	// e.g. neighbors, solar wind and power, or if the system is inhabited.
+	// e.g. neighbors, solar wind and power, commodity prices, or if the system is inhabited.
 	void UpdateSystem(const Set<System> &systems, const std::set<double> &neighborDistances);
 
 	// Modify a system's links.
 	void Link(System *other);
 	void Unlink(System *other);
 
+	// Give this system a number from 0 up, unless it already has one, so that
+	// data about each system can be kept in an array instead of a map.
+	void AssignIndex();
+	// Get this system's number, or -1 if it has not been given one.
+	int Index() const;
+
 	bool IsValid() const;
 	const std::string &TrueName() const;
 	void SetTrueName(const std::string &name);
@@ -132,7 +139,8 @@ public:
 	// direct hyperspace link to them.
 	const std::set<const System *> &VisibleNeighbors() const;
 
-	// Move the stellar objects to their positions on the given date.
+	// Set the date that the stellar objects' positions are for. The positions
+	// are only worked out once they are needed.
 	void SetDate(const Date &date);
 	// Get the stellar object locations on the most recently set date.
 	const std::vector<StellarObject> &Objects() const;
@@ -166,14 +174,20 @@ public:
 	// Get the background haze sprite for this system.
 	const Sprite *Haze() const;
 
-	// Get the price of the given commodity in this system.
+	// Get the price of the given commodity in this system. A commodity may be
+	// given by its name or by its index in GameData::Commodities(), which is
+	// faster when checking many systems or commodities.
 	int Trade(const std::string &commodity) const;
+	int Trade(size_t commodity) const;
 	bool HasTrade() const;
 	// Update the economy. Returns the amount of trade goods this system exports.
 	void StepEconomy();
 	void SetSupply(const std::string &commodity, double tons);
+	void SetSupply(size_t commodity, double tons);
 	double Supply(const std::string &commodity) const;
+	double Supply(size_t commodity) const;
 	double Exports(const std::string &commodity) const;
+	double Exports(size_t commodity) const;
 
 	// Get the probabilities of various fleets entering this system.
 	const std::vector<RandomEvent<Fleet>> &Fleets() const;
@@ -193,6 +207,8 @@ private:
 	void LoadObject(const DataNode &node, Set<Planet> &planets,
 		const ConditionsStore *playerConditions, int parent = -1);
 	void LoadObjectHelper(const DataNode &node, StellarObject &object, bool removing = false) const;
+	// Move the stellar objects to their positions on the day that was last set.
+	void UpdatePositions() const;
 	// Once the star map is fully loaded or an event has changed systems
 	// or links, figure out which stars are "neighbors" of this one, i.e.
 	// close enough to see or to reach via jump drive.
@@ -205,6 +221,7 @@ private:
 		void SetBase(int base);
 		void Update();
 
+		bool isTraded = false;
 		int base = 0;
 		int price = 0;
 		double supply = 0.;
@@ -213,6 +230,7 @@ private:
 
 
 private:
+	int index = -1;
 	bool isDefined = false;
 	bool hasPosition = false;
 	std::string trueName;
@@ -250,6 +268,18 @@ private:
 	// order, updating positions, an object's parents will already be at the
 	// proper position before that object is updated).
 	std::vector<StellarObject> objects;
+	// The day that the stellar objects should be positioned for, and whether
+	// they have been moved there yet.
+	double day = 0.;
+	class UpdateFlag {
+	public:
+		UpdateFlag() = default;
+		UpdateFlag(const UpdateFlag &other) : isSet(other.isSet.load()) {}
+		UpdateFlag &operator=(const UpdateFlag &other) { isSet = other.isSet.load(); return *this; }
+
+		mutable std::atomic<bool> isSet = false;
+	};
+	UpdateFlag positionsUpdated;
 	std::vector<Asteroid> asteroids;
 	std::set<const Outfit *> payloads;
 	const Sprite *haze = nullptr;
@@ -280,9 +310,15 @@ private:
 	double jumpDepartureDistance = 0.;
 	double hyperDepartureDistance = 0.;
 
-	// Commodity prices.
-	std::map<std::string, Price> trade;
+	// The base price of each commodity, as loaded. The commodities may not all
+	// be defined yet when the system is, so their prices are only put in
+	// order by UpdateSystem().
+	std::map<std::string, int> tradeBase;
+	// Commodity prices, in the same order as GameData::Commodities().
+	std::vector<Price> trade;
 
 	// Attributes, for use in location filters.
 	std::set<std::string> attributes;
+
+	friend class TradeNetwork;
 };
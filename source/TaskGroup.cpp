@@ -0,0 +1,88 @@
+/* TaskGroup.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "TaskGroup.h"
+
+#include "TaskQueue.h"
+
+#include <thread>
+
+using namespace std;
+
+
+
+// Waits for all of the group's tasks to finish, ignoring any exceptions.
+TaskGroup::~TaskGroup()
+{
+	WaitUntilDone();
+}
+
+
+
+// Queue a function to execute in parallel as part of this group.
+void TaskGroup::Run(function<void()> task)
+{
+	pending.fetch_add(1, memory_order_relaxed);
+	TaskQueue::Schedule(*this, std::move(task));
+}
+
+
+
+// Wait for every task of this group to finish. If any of them threw an
+// exception, the first one is rethrown here.
+void TaskGroup::Wait()
+{
+	WaitUntilDone();
+
+	exception_ptr first;
+	{
+		lock_guard<mutex> lock(exceptionMutex);
+		swap(first, exception);
+	}
+	if(first)
+		rethrow_exception(first);
+}
+
+
+
+// Mark one of this group's tasks as finished.
+void TaskGroup::Finish(exception_ptr thrown) noexcept
+{
+	if(thrown)
+	{
+		lock_guard<mutex> lock(exceptionMutex);
+		if(!exception)
+			exception = thrown;
+	}
+	pending.fetch_sub(1, memory_order_release);
+}
+
+
+
+bool TaskGroup::IsDone() const noexcept
+{
+	return !pending.load(memory_order_acquire);
+}
+
+
+
+void TaskGroup::WaitUntilDone() noexcept
+{
+	// Instead of going idle, help with any queued tasks. Those are most likely
+	// this group's own tasks that no other thread has picked up yet.
+	while(!IsDone())
+		if(!TaskQueue::ExecuteScheduled())
+			this_thread::yield();
+}
@@ -0,0 +1,61 @@
+/* TaskGroup.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+
+
+// A set of small tasks that are executed in parallel by the same worker threads
+// as the TaskQueue, and that can be waited on as a whole. Unlike TaskQueue::Run,
+// no future is created for each task. A thread that waits on a group helps
+// execute any pending tasks instead of going idle, so a task may itself run
+// another group and wait on it.
+class TaskGroup {
+public:
+	TaskGroup() = default;
+	TaskGroup(const TaskGroup &) = delete;
+	TaskGroup &operator=(const TaskGroup &) = delete;
+	// Waits for all of the group's tasks to finish, ignoring any exceptions.
+	~TaskGroup();
+
+	// Queue a function to execute in parallel as part of this group.
+	void Run(std::function<void()> task);
+	// Wait for every task of this group to finish. If any of them threw an
+	// exception, the first one is rethrown here.
+	void Wait();
+
+
+private:
+	// Mark one of this group's tasks as finished.
+	void Finish(std::exception_ptr exception) noexcept;
+	bool IsDone() const noexcept;
+	void WaitUntilDone() noexcept;
+
+
+private:
+	// The number of tasks that have been queued but have not finished yet.
+	std::atomic<int> pending = 0;
+
+	// The first exception thrown by any task in this group.
+	std::exception_ptr exception;
+	std::mutex exceptionMutex;
+
+	friend class TaskQueue;
+};
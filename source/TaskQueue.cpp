@@ -15,10 +15,18 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "TaskQueue.h"
 
+#include "TaskGroup.h"
+
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <exception>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
@@ -30,13 +38,36 @@ namespace {
 	condition_variable asyncCondition;
 	bool shouldQuit = false;
 
+	// A task that belongs to a TaskGroup.
+	struct GroupTask {
+		TaskGroup *group;
+		function<void()> work;
+	};
+
+	// Each worker thread has its own deque of group tasks. Its owner adds and
+	// removes tasks at the back, while idle threads steal from the front.
+	struct WorkDeque {
+		deque<GroupTask> tasks;
+		mutex lock;
+	};
+	// The total number of group tasks waiting in any of the deques.
+	atomic<size_t> scheduledCount = 0;
+
+	// The index of the deque owned by the current thread. Threads that are not
+	// worker threads share the last deque.
+	thread_local size_t dequeIndex = numeric_limits<size_t>::max();
+
 	// Worker threads for executing tasks.
 	struct WorkerThreads {
 		WorkerThreads() noexcept
 		{
 			threads.resize(max(4u, thread::hardware_concurrency()));
-			for(thread &t : threads)
-				t = thread(&TaskQueue::ThreadLoop);
+			// Create one deque for each thread, and a shared one for any other threads.
+			deques.resize(threads.size() + 1);
+			for(auto &it : deques)
+				it = make_unique<WorkDeque>();
+			for(size_t i = 0; i < threads.size(); ++i)
+				threads[i] = thread(&TaskQueue::ThreadLoop, i);
 		}
 		~WorkerThreads()
 		{
@@ -49,8 +80,35 @@ namespace {
 				t.join();
 		}
 
+		WorkDeque &Own()
+		{
+			return *deques[min(dequeIndex, deques.size() - 1)];
+		}
+
+		vector<unique_ptr<WorkDeque>> deques;
 		vector<thread> threads;
 	} threads;
+
+	// The state shared by every thread working on the same ParallelFor call.
+	struct ParallelForState {
+		size_t end;
+		size_t grain;
+		void (*invoke)(void *fn, size_t begin, size_t end);
+		void *fn;
+		atomic<size_t> next;
+
+		// Claim and process chunks of the range until none are left.
+		void Work()
+		{
+			while(true)
+			{
+				size_t begin = next.fetch_add(grain, memory_order_relaxed);
+				if(begin >= end)
+					return;
+				invoke(fn, begin, min(end, begin + grain));
+			}
+		}
+	};
 }
 
 
@@ -88,11 +146,15 @@ shared_future<void> TaskQueue::Run(function<void()> asyncTask, function<void()>
 
 
 // Process any tasks to be scheduled to be executed on the main thread.
-void TaskQueue::ProcessSyncTasks()
+void TaskQueue::ProcessSyncTasks(int timeLimit)
 {
+	const auto start = chrono::steady_clock::now();
 	unique_lock<mutex> lock(syncMutex);
 	for(int i = 0; !syncTasks.empty() && i < MAX_SYNC_TASKS; ++i)
 	{
+		if(timeLimit && i && chrono::steady_clock::now() - start >= chrono::milliseconds(timeLimit))
+			break;
+
 		// Extract the one item we should work on right now.
 		auto task = std::move(syncTasks.front());
 		syncTasks.pop();
@@ -123,59 +185,172 @@ bool TaskQueue::IsDone() const
 
 
 
+// Queue a task belonging to the given group on this thread's work deque.
+void TaskQueue::Schedule(TaskGroup &group, function<void()> task)
+{
+	WorkDeque &own = threads.Own();
+	{
+		lock_guard<mutex> lock(own.lock);
+		own.tasks.push_back(GroupTask{&group, std::move(task)});
+	}
+	scheduledCount.fetch_add(1, memory_order_release);
+	// Briefly take the lock so that a worker that just found nothing to do
+	// cannot miss this notification before it goes to sleep.
+	{
+		lock_guard<mutex> lock(asyncMutex);
+	}
+	asyncCondition.notify_one();
+}
+
+
+
+// Execute one task from this thread's work deque, or steal one from another
+// thread's deque. Returns false if there was nothing to execute.
+bool TaskQueue::ExecuteScheduled()
+{
+	if(!scheduledCount.load(memory_order_acquire))
+		return false;
+
+	GroupTask task;
+	bool found = false;
+	// Prefer the most recently queued task of this thread, which is the most
+	// likely to be something that this thread is waiting on.
+	{
+		WorkDeque &own = threads.Own();
+		lock_guard<mutex> lock(own.lock);
+		if(!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			found = true;
+		}
+	}
+	// Otherwise, steal the oldest task of another thread.
+	const size_t count = threads.deques.size();
+	const size_t start = min(dequeIndex, count - 1);
+	for(size_t i = 1; !found && i < count; ++i)
+	{
+		WorkDeque &other = *threads.deques[(start + i) % count];
+		lock_guard<mutex> lock(other.lock);
+		if(!other.tasks.empty())
+		{
+			task = std::move(other.tasks.front());
+			other.tasks.pop_front();
+			found = true;
+		}
+	}
+	if(!found)
+		return false;
+
+	scheduledCount.fetch_sub(1, memory_order_relaxed);
+	exception_ptr exception;
+	try {
+		task.work();
+	}
+	catch(...)
+	{
+		exception = current_exception();
+	}
+	task.group->Finish(exception);
+	return true;
+}
+
+
+
+void TaskQueue::ParallelForChunks(size_t begin, size_t end, size_t grain,
+	void (*invoke)(void *fn, size_t begin, size_t end), void *fn)
+{
+	if(begin >= end)
+		return;
+	grain = max<size_t>(grain, 1);
+	const size_t chunks = (end - begin + grain - 1) / grain;
+	if(chunks == 1)
+	{
+		invoke(fn, begin, end);
+		return;
+	}
+
+	// Rather than queuing a task for every chunk, queue one task per helping thread
+	// that keeps claiming chunks until there are none left. This thread helps too.
+	ParallelForState state{end, grain, invoke, fn, begin};
+	TaskGroup group;
+	const size_t helpers = min(chunks, threads.threads.size() + 1) - 1;
+	for(size_t i = 0; i < helpers; ++i)
+		group.Run([&state] { state.Work(); });
+	exception_ptr exception;
+	try {
+		state.Work();
+	}
+	catch(...)
+	{
+		exception = current_exception();
+		// Make sure no other thread starts on any of the remaining chunks.
+		state.next.store(end, memory_order_relaxed);
+	}
+	group.Wait();
+	if(exception)
+		rethrow_exception(exception);
+}
+
+
+
 // Thread entry point.
-void TaskQueue::ThreadLoop() noexcept
+void TaskQueue::ThreadLoop(size_t index) noexcept
 {
+	dequeIndex = index;
 	while(true)
 	{
+		// Small group tasks take priority, since other threads are waiting on them.
+		if(ExecuteScheduled())
+			continue;
+
 		unique_lock<mutex> lock(asyncMutex);
-		while(true)
+		// Check whether it is time for this thread to quit.
+		if(shouldQuit)
+			return;
+		// No more tasks to execute, just go to sleep.
+		if(tasks.empty())
 		{
-			// Check whether it is time for this thread to quit.
-			if(shouldQuit)
-				return;
-			// No more tasks to execute, just go to sleep.
-			if(tasks.empty())
-				break;
-
-			// Extract the one item we should work on reading right now.
-			auto task = std::move(tasks.front());
-			tasks.pop();
-
-			// Unlock the mutex so other threads can access the queue.
-			lock.unlock();
-
-			// Execute the task.
-			try {
-				if(task.async)
-					task.async();
-			}
-			catch(...)
-			{
-				// Any exception by the task is caught and rethrown inside the main thread
-				// so we can handle it appropriately.
-				auto exception = current_exception();
-				task.sync = [exception] { rethrow_exception(exception); };
-			}
+			asyncCondition.wait(lock, [] { return shouldQuit || !tasks.empty()
+				|| scheduledCount.load(memory_order_acquire); });
+			continue;
+		}
 
-			// If there is a followup function to execute, queue it for execution
-			// in the main thread.
-			if(task.sync)
-			{
-				unique_lock<mutex> lock(task.queue->syncMutex);
-				task.queue->syncTasks.push(std::move(task.sync));
-			}
+		// Extract the one item we should work on reading right now.
+		auto task = std::move(tasks.front());
+		tasks.pop();
 
-			// We are done and can mark the future as ready.
-			task.futurePromise.set_value();
+		// Unlock the mutex so other threads can access the queue.
+		lock.unlock();
 
-			lock.lock();
+		// Execute the task.
+		try {
+			if(task.async)
+				task.async();
+		}
+		catch(...)
+		{
+			// Any exception by the task is caught and rethrown inside the main thread
+			// so we can handle it appropriately.
+			auto exception = current_exception();
+			task.sync = [exception] { rethrow_exception(exception); };
+		}
 
-			// Now that the task has been executed, stop tracking the future internally.
-			// Anybody who still cares about the future will have a copy themselves.
-			task.queue->futures.erase(task.futureIt);
+		// If there is a followup function to execute, queue it for execution
+		// in the main thread.
+		if(task.sync)
+		{
+			unique_lock<mutex> lock(task.queue->syncMutex);
+			task.queue->syncTasks.push(std::move(task.sync));
 		}
 
-		asyncCondition.wait(lock, [] { return shouldQuit || !tasks.empty(); });
+		// We are done and can mark the future as ready.
+		task.futurePromise.set_value();
+
+		lock.lock();
+
+		// Now that the task has been executed, stop tracking the future internally.
+		// Anybody who still cares about the future will have a copy themselves.
+		task.queue->futures.erase(task.futureIt);
 	}
 }
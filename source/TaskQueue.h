@@ -15,11 +15,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <future>
 #include <list>
 #include <mutex>
 #include <queue>
+#include <type_traits>
+
+class TaskGroup;
 
 
 
@@ -48,6 +52,9 @@ public:
 
 	// The maximum amount of sync tasks to execute in one go.
 	static constexpr int MAX_SYNC_TASKS = 100;
+	// The milliseconds that the sync tasks of work done in the background may
+	// take each frame, out of the roughly 16 that a frame has.
+	static constexpr int BACKGROUND_SYNC_TIME = 4;
 
 public:
 	// Initialize the threads used to execute the tasks.
@@ -63,20 +70,41 @@ public:
 	std::shared_future<void> Run(std::function<void()> asyncTask, std::function<void()> syncTask = {});
 
 	// Process any tasks to be scheduled to be executed on the main thread.
-	void ProcessSyncTasks();
+	// If a time limit is given, stop once the tasks have taken that many
+	// milliseconds (after at least one task), leaving the rest for the next
+	// call, so that work that is done in the background, such as uploading
+	// prefetched sprites, is spread out over several frames.
+	void ProcessSyncTasks(int timeLimit = 0);
 
 	// Waits for all of this queue's task to finish. Ignores any sync tasks to be processed.
 	void Wait();
 
+	// Call the given function for every chunk of at most "grain" indices in the
+	// range [begin, end), as fn(chunkBegin, chunkEnd), spreading the chunks over
+	// the worker threads. The calling thread also works on the chunks, and this
+	// returns once all of them are done. If any call throws, the first exception
+	// is rethrown here once every other chunk has finished.
+	template<class Function>
+	static void ParallelFor(size_t begin, size_t end, size_t grain, Function &&fn);
+
 
 private:
 	// Whether there are any outstanding async tasks left in this queue.
 	bool IsDone() const;
 
 
+	// Queue a task belonging to the given group on this thread's work deque.
+	static void Schedule(TaskGroup &group, std::function<void()> task);
+	// Execute one task from this thread's work deque, or steal one from another
+	// thread's deque. Returns false if there was nothing to execute.
+	static bool ExecuteScheduled();
+	static void ParallelForChunks(size_t begin, size_t end, size_t grain,
+		void (*invoke)(void *fn, size_t begin, size_t end), void *fn);
+
+
 public:
 	// Thread entry point.
-	static void ThreadLoop() noexcept;
+	static void ThreadLoop(size_t index) noexcept;
 
 
 private:
@@ -85,4 +113,19 @@ private:
 	// Tasks from this queue that need to be executed on the main thread.
 	std::queue<std::function<void()>> syncTasks;
 	mutable std::mutex syncMutex;
+
+	friend class TaskGroup;
 };
+
+
+
+template<class Function>
+void TaskQueue::ParallelFor(size_t begin, size_t end, size_t grain, Function &&fn)
+{
+	// Pass the function along by address, so that no copy of it needs to be allocated.
+	using Type = std::remove_reference_t<Function>;
+	ParallelForChunks(begin, end, grain, [](void *function, size_t chunkBegin, size_t chunkEnd) -> void
+		{
+			(*static_cast<Type *>(function))(chunkBegin, chunkEnd);
+		}, const_cast<void *>(static_cast<const void *>(&fn)));
+}
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "TextReplacements.h"
 
+#include "ConditionEntry.h"
 #include "ConditionSet.h"
 #include "DataNode.h"
 
@@ -67,6 +68,7 @@ void TextReplacements::Load(const DataNode &node, const ConditionsStore *playerC
 			toSubstitute.Load(child, playerConditions);
 		substitutions.emplace_back(key, make_pair(std::move(toSubstitute), child.Token(1)));
 	}
+	isActiveKnown = false;
 }
 
 
@@ -76,6 +78,7 @@ void TextReplacements::Revert(TextReplacements &other)
 {
 	substitutions.clear();
 	substitutions.insert(substitutions.begin(), other.substitutions.begin(), other.substitutions.end());
+	isActiveKnown = false;
 }
 
 
@@ -85,12 +88,25 @@ void TextReplacements::Revert(TextReplacements &other)
 // if the map and this TextReplacements share a key.
 void TextReplacements::Substitutions(map<string, string> &subs) const
 {
-	for(const auto &sub : substitutions)
+	const uint64_t changes = ConditionEntry::Changes();
+	if(!isActiveKnown || changes != activeChanges)
 	{
-		const string &key = sub.first;
-		const ConditionSet &toSub = sub.second.first;
-		const string &replacement = sub.second.second;
-		if(toSub.Test())
-			subs[key] = replacement;
+		active.clear();
+		isActiveKnown = true;
+		activeChanges = changes;
+		for(size_t i = 0; i < substitutions.size(); ++i)
+		{
+			const ConditionSet &toSub = substitutions[i].second.first;
+			if(toSub.Test())
+				active.push_back(i);
+			isActiveKnown &= toSub.HasStableResult();
+		}
+	}
+
+	for(size_t i : active)
+	{
+		const string &key = substitutions[i].first;
+		const string &replacement = substitutions[i].second.second;
+		subs[key] = replacement;
 	}
 }
@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -48,4 +50,11 @@ public:
 private:
 	// Vector with "string to be replaced", "condition when to replace", and "replacement text".
 	std::vector<std::pair<std::string, std::pair<ConditionSet, std::string>>> substitutions;
+
+	// Which substitutions applied the last time, by their index. This stays the
+	// same until a condition is set, unless one of the conditions comes from a
+	// provider, so testing every substitution can usually be skipped.
+	mutable std::vector<std::size_t> active;
+	mutable uint64_t activeChanges = 0;
+	mutable bool isActiveKnown = false;
 };
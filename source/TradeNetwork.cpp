@@ -0,0 +1,109 @@
+/* TradeNetwork.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "TradeNetwork.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+// Forget the layout of the network. This must be done whenever systems are
+// added or changed, or the links between them may have changed.
+void TradeNetwork::Invalidate()
+{
+	isBuilt = false;
+}
+
+
+
+// Send the exports of every system to its neighbors.
+void TradeNetwork::Distribute(Set<System> &systems, const vector<Trade::Commodity> &commodities)
+{
+	if(!isBuilt)
+		Build(systems, commodities);
+
+	for(size_t i = 0; i < prices.size(); ++i)
+		exports[i] = prices[i] ? prices[i]->exports : 0.;
+
+	// Exports do not change in this step, so it does not matter which system
+	// receives its goods first. Each neighbor's share is added in the same order
+	// as before, so that the result is exactly the same.
+	for(size_t i = 0; i < receivers.size(); ++i)
+	{
+		System::Price **row = &prices[receivers[i] * width];
+		for(size_t c = 0; c < width; ++c)
+			supply[c] = row[c] ? row[c]->supply : 0.;
+
+		for(size_t link = firstLink[i]; link < firstLink[i + 1]; ++link)
+		{
+			const size_t neighbor = links[link];
+			const double share = scale[neighbor];
+			if(!share)
+				continue;
+			const double *neighborExports = &exports[neighbor * width];
+			for(size_t c = 0; c < width; ++c)
+				supply[c] += neighborExports[c] / share;
+		}
+
+		for(size_t c = 0; c < width; ++c)
+			if(row[c])
+			{
+				row[c]->supply = supply[c];
+				row[c]->Update();
+			}
+	}
+}
+
+
+
+void TradeNetwork::Build(Set<System> &systems, const vector<Trade::Commodity> &commodities)
+{
+	width = commodities.size();
+	size_t count = 0;
+	for(const auto &it : systems)
+		count = max(count, static_cast<size_t>(it.second.Index() + 1));
+
+	prices.assign(count * width, nullptr);
+	scale.assign(count, 0.);
+	receivers.clear();
+	firstLink.clear();
+	links.clear();
+	for(auto &it : systems)
+	{
+		System &system = it.second;
+		if(system.Index() < 0)
+			continue;
+		const size_t index = system.Index();
+		scale[index] = system.Links().size();
+		for(size_t c = 0; c < width && c < system.trade.size(); ++c)
+			if(system.trade[c].isTraded)
+				prices[index * width + c] = &system.trade[c];
+
+		if(system.Links().empty())
+			continue;
+		receivers.push_back(index);
+		firstLink.push_back(links.size());
+		for(const System *neighbor : system.Links())
+			if(neighbor->Index() >= 0)
+				links.push_back(neighbor->Index());
+	}
+	firstLink.push_back(links.size());
+
+	exports.resize(prices.size());
+	supply.resize(width);
+	isBuilt = true;
+}
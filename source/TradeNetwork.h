@@ -0,0 +1,63 @@
+/* TradeNetwork.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Set.h"
+#include "System.h"
+#include "Trade.h"
+
+#include <cstddef>
+#include <vector>
+
+
+
+// The trade goods that flow between neighboring systems each day. Each system
+// sends an equal share of its exports of each commodity to each of the systems
+// it is linked to. Looking up each commodity of each system by name would take
+// most of the time of that step, so instead the supply and exports are copied
+// into arrays with a row for each system and a column for each commodity, and
+// the goods that a system receives are summed along a whole row at once.
+class TradeNetwork {
+public:
+	// Forget the layout of the network. This must be done whenever systems are
+	// added or changed, or the links between them may have changed.
+	void Invalidate();
+	// Send the exports of every system to its neighbors.
+	void Distribute(Set<System> &systems, const std::vector<Trade::Commodity> &commodities);
+
+
+private:
+	void Build(Set<System> &systems, const std::vector<Trade::Commodity> &commodities);
+
+
+private:
+	bool isBuilt = false;
+	size_t width = 0;
+	// The price of each commodity in each system, by system index, or nullptr
+	// if that system does not trade in that commodity.
+	std::vector<System::Price *> prices;
+	// The number of links each system shares its exports among.
+	std::vector<double> scale;
+	// The systems that receive goods from their neighbors, and the indices of
+	// those neighbors. The neighbors of receivers[i] start at firstLink[i].
+	std::vector<size_t> receivers;
+	std::vector<size_t> firstLink;
+	std::vector<size_t> links;
+
+	// Scratch space for the exports of every system, and one system's supply.
+	std::vector<double> exports;
+	std::vector<double> supply;
+};
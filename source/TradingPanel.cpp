@@ -163,7 +163,7 @@ void TradingPanel::Draw()
 	for(const Trade::Commodity &commodity : GameData::Commodities())
 	{
 		y += 20;
-		int price = system.Trade(commodity.name);
+		int price = system.Trade(static_cast<size_t>(i));
 		int hold = player.Cargo().Get(commodity.name);
 
 		bool isSelected = (i++ == selectedRow);
@@ -322,7 +322,7 @@ void TradingPanel::Buy(int64_t amount)
 
 	amount *= Modifier();
 	const string &type = GameData::Commodities()[selectedRow].name;
-	int64_t price = system.Trade(type);
+	int64_t price = system.Trade(static_cast<size_t>(selectedRow));
 	if(!price)
 		return;
 
@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "audio/Audio.h"
 #include "Command.h"
+#include "ConditionEntry.h"
 #include "Panel.h"
 #include "Screen.h"
 
@@ -32,6 +33,8 @@ using namespace std;
 // of them handles it. If none do, this returns false.
 bool UI::Handle(const SDL_Event &event)
 {
+	// Handling this event may change what the cached conditions depend on.
+	ConditionEntry::NextFrame();
 	bool handled = false;
 
 	vector<shared_ptr<Panel>>::iterator it = stack.end();
@@ -93,6 +96,8 @@ bool UI::Handle(const SDL_Event &event)
 // Step all the panels forward (advance animations, move objects, etc.).
 void UI::StepAll()
 {
+	ConditionEntry::NextFrame();
+
 	// Handle any queued push or pop commands.
 	PushOrPop();
 
@@ -103,7 +108,7 @@ void UI::StepAll()
 	// Process any tasks queued up by the panels.
 	syncQueue.Wait();
 	syncQueue.ProcessSyncTasks();
-	asyncQueue.ProcessSyncTasks();
+	asyncQueue.ProcessSyncTasks(TaskQueue::BACKGROUND_SYNC_TIME);
 }
 
 
@@ -111,6 +116,8 @@ void UI::StepAll()
 // Draw all the panels.
 void UI::DrawAll()
 {
+	ConditionEntry::NextFrame();
+
 	// First, clear all the clickable zones. New ones will be added in the
 	// course of drawing the screen.
 	for(const shared_ptr<Panel> &it : stack)
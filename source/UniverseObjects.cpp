@@ -16,13 +16,18 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "UniverseObjects.h"
 
 #include "DataFile.h"
+#include "DataFileCache.h"
 #include "DataNode.h"
 #include "Files.h"
 #include "Information.h"
+#include "JumpTable.h"
+#include "LocationFilter.h"
 #include "Logger.h"
 #include "PlayerInfo.h"
 #include "image/Sprite.h"
 #include "image/SpriteSet.h"
+#include "StartupProfile.h"
+#include "TaskGroup.h"
 #include "TaskQueue.h"
 
 #include <algorithm>
@@ -35,17 +40,66 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	// How many data files are parsed in parallel before any of them are applied.
+	constexpr size_t PARSE_BATCH_SIZE = 64;
+	// How many objects each thread finishes at a time.
+	constexpr size_t FINISH_CHUNK_SIZE = 16;
+
+	// Call the given function for each of the objects, spread over the worker
+	// threads. The messages that it logs are written afterwards, in the order of
+	// the objects, so that the log is the same from one run to the next.
+	template<class Type, class Function>
+	void ForEachInParallel(const vector<Type *> &objects, Function &&fn)
+	{
+		vector<Logger::Messages> messages(objects.size());
+		TaskQueue::ParallelFor(0, objects.size(), FINISH_CHUNK_SIZE, [&](size_t begin, size_t end)
+		{
+			for(size_t i = begin; i < end; ++i)
+			{
+				Logger::Capture capture(messages[i]);
+				fn(*objects[i]);
+			}
+		});
+		for(const Logger::Messages &it : messages)
+			Logger::Log(it);
+	}
+
+	// Get the tokens of each root node of the given file, which identify the
+	// objects that it defines.
+	set<string> RootNames(const DataFile &data)
+	{
+		set<string> roots;
+		for(const DataNode &node : data)
+			if(node.Size() >= 2)
+			{
+				string root = node.Token(0);
+				for(int i = 1; i < node.Size(); ++i)
+					root += ' ' + node.Token(i);
+				roots.insert(std::move(root));
+			}
+		return roots;
+	}
+
+	void AddTokens(const DataNode &node, set<string> &tokens)
+	{
+		tokens.insert(node.Tokens().begin(), node.Tokens().end());
+		for(const DataNode &child : node)
+			AddTokens(child, tokens);
+	}
+}
+
 
 
 shared_future<void> UniverseObjects::Load(TaskQueue &queue, const vector<filesystem::path> &sources,
-	const PlayerInfo &player, const ConditionsStore *globalConditions, bool debugMode)
+	const PlayerInfo &player, const ConditionsStore *globalConditions, bool debugMode, bool loadLazily)
 {
 	progress = 0.;
 
 	// We need to copy any variables used for loading to avoid a race condition.
 	// 'this' is not copied, so 'this' shouldn't be accessed after calling this
 	// function (except for calling GetProgress which is safe due to the atomic).
-	return queue.Run([this, &player, &sources, globalConditions, debugMode]() noexcept -> void
+	return queue.Run([this, &player, &sources, globalConditions, debugMode, loadLazily]() noexcept -> void
 		{
 			vector<filesystem::path> files;
 			for(const auto &source : sources)
@@ -60,15 +114,52 @@ shared_future<void> UniverseObjects::Load(TaskQueue &queue, const vector<filesys
 						make_move_iterator(list.end()));
 			}
 
+			// The files are parsed in batches on the worker threads, while the
+			// previous batch is applied on this one. The parsed files are applied
+			// in their original order, so that later files still override earlier ones.
+			vector<DataFile> parsed(files.size());
+			auto parseBatch = [&files, &parsed](TaskGroup &group, size_t begin) -> void
+			{
+				const size_t end = min(begin + PARSE_BATCH_SIZE, files.size());
+				for(size_t i = begin; i < end; ++i)
+				{
+					// Only text files contain data; anything else is ignored.
+					if(files[i].extension() == ".txt")
+						group.Run([&files, &parsed, i]() -> void
+							{
+								StartupProfile::Scope scope("DataFileCache::Load", files[i]);
+								DataFileCache::Load(files[i], parsed[i]);
+							});
+				}
+			};
+			TaskGroup groups[2];
+			parseBatch(groups[0], 0);
+
 			const double step = 1. / (static_cast<int>(files.size()) + 1);
-			for(const auto &path : files)
+			for(size_t begin = 0, batch = 0; begin < files.size(); begin += PARSE_BATCH_SIZE, ++batch)
 			{
-				LoadFile(path, player, globalConditions, debugMode);
+				if(begin + PARSE_BATCH_SIZE < files.size())
+					parseBatch(groups[(batch + 1) % 2], begin + PARSE_BATCH_SIZE);
+				groups[batch % 2].Wait();
 
-				// Increment the atomic progress by one step.
-				// We use acquire + release to prevent any reordering.
-				auto val = progress.load(memory_order_acquire);
-				progress.store(val + step, memory_order_release);
+				const size_t end = min(begin + PARSE_BATCH_SIZE, files.size());
+				for(size_t i = begin; i < end; ++i)
+				{
+					if(files[i].extension() == ".txt")
+					{
+						LoadFile(files[i], parsed[i], player, globalConditions, debugMode, loadLazily);
+						// Files inside a zipped plugin can't be edited, so they aren't watched.
+						if(isWatching && filesystem::is_regular_file(files[i]))
+							watchedFiles.push_back({files[i], Files::Timestamp(files[i]), RootNames(parsed[i])});
+					}
+					// Free each file's nodes as soon as they have been applied.
+					parsed[i] = DataFile();
+
+					// Increment the atomic progress by one step.
+					// We use acquire + release to prevent any reordering.
+					auto val = progress.load(memory_order_acquire);
+					progress.store(val + step, memory_order_release);
+				}
 			}
 			FinishLoading();
 			progress = 1.;
@@ -86,6 +177,9 @@ double UniverseObjects::GetProgress() const
 
 void UniverseObjects::FinishLoading()
 {
+	LocationFilter::Invalidate();
+	JumpTable::Invalidate();
+	tradeNetwork.Invalidate();
 	for(auto &&it : planets)
 		it.second.FinishLoading(wormholes);
 
@@ -95,9 +189,45 @@ void UniverseObjects::FinishLoading()
 	neighborDistances.insert(System::DEFAULT_NEIGHBOR_DISTANCE);
 	UpdateSystems();
 
-	// And, update the ships with the outfits we've now finished loading.
+	// Every weapon's submunitions are loaded now, so the totals that depend on
+	// them can be worked out before any thread reads them.
+	for(auto &&it : outfits)
+		if(it.second.GetWeapon())
+			it.second.GetWeapon()->FinishLoading();
+	for(auto &&it : hazards)
+		it.second.FinishLoading();
+
+	// And, update the ships with the outfits we've now finished loading. Each
+	// variant copies whatever it does not define from its model, so the ships
+	// are finished in waves: models first, then the variants of those models.
+	// A variant is stored under its own name rather than that of its model.
+	vector<vector<Ship *>> waves;
 	for(auto &&it : ships)
-		it.second.FinishLoading(true);
+	{
+		Ship &ship = it.second;
+		// Looking up something that does not exist yet adds it to its set, which
+		// must not happen while the ships are being finished on several threads.
+		if(!ship.CustomSwizzleName().empty())
+			swizzles.Get(ship.CustomSwizzleName());
+		// A ship's explosion is a weapon of its own.
+		if(ship.BaseAttributes().GetWeapon())
+			ship.BaseAttributes().GetWeapon()->FinishLoading();
+
+		size_t depth = 0;
+		const string *name = &it.first;
+		for(const Ship *model = &ship; model && *name != model->TrueModelName()
+				&& depth < static_cast<size_t>(ships.size()); ++depth)
+		{
+			name = &model->TrueModelName();
+			model = ships.Find(*name);
+		}
+		if(waves.size() <= depth)
+			waves.resize(depth + 1);
+		waves[depth].push_back(&ship);
+	}
+	effects.Get("basic launch");
+	for(const vector<Ship *> &wave : waves)
+		ForEachInParallel(wave, [](Ship &ship) { ship.FinishLoading(true); });
 	for(auto &&it : persons)
 		it.second.FinishLoading();
 
@@ -132,6 +262,8 @@ void UniverseObjects::FinishLoading()
 	// Sort all category lists.
 	for(auto &list : categories)
 		list.second.Sort();
+
+	missionIndex.Build(missions);
 }
 
 
@@ -140,8 +272,14 @@ void UniverseObjects::FinishLoading()
 void UniverseObjects::Change(const DataNode &node, PlayerInfo &player)
 {
 	const ConditionsStore *playerConditions = &player.Conditions();
-	const set<const System *> *visitedSystems = &player.VisitedSystems();
-	const set<const Planet *> *visitedPlanets = &player.VisitedPlanets();
+	const IndexedSet<System> *visitedSystems = &player.VisitedSystems();
+	const IndexedSet<Planet> *visitedPlanets = &player.VisitedPlanets();
+
+	// Any change to the galaxy may change which systems and planets a filter
+	// matches, and how far apart systems are.
+	LocationFilter::Invalidate();
+	JumpTable::Invalidate();
+	tradeNetwork.Invalidate();
 
 	const string &key = node.Token(0);
 	bool hasValue = node.Size() >= 2;
@@ -186,6 +324,13 @@ void UniverseObjects::Change(const DataNode &node, PlayerInfo &player)
 // (This must be done any time a GameEvent creates or moves a system.)
 void UniverseObjects::UpdateSystems()
 {
+	LocationFilter::Invalidate();
+	JumpTable::Invalidate();
+	tradeNetwork.Invalidate();
+	for(auto &it : systems)
+		it.second.AssignIndex();
+	for(auto &it : planets)
+		it.second.AssignIndex();
 	for(auto &it : systems)
 	{
 		// Skip systems that have no name.
@@ -218,12 +363,13 @@ void UniverseObjects::RecomputeWormholeRequirements()
 // Check for objects that are referred to but never defined. Some elements, like
 // fleets, don't need to be given a name if undefined. Others (like outfits and
 // planets) are written to the player's save and need a name to prevent data loss.
-void UniverseObjects::CheckReferences()
+void UniverseObjects::CheckReferences(const set<string> *scope)
 {
 	// Log a warning for an "undefined" class object that was never loaded from disk.
-	auto Warn = [](const string &noun, const string &name)
+	auto Warn = [scope](const string &noun, const string &name)
 	{
-		Logger::Log(noun + " \"" + name + "\" is referred to, but not fully defined.", Logger::Level::WARNING);
+		if(!scope || scope->contains(name))
+			Logger::Log(noun + " \"" + name + "\" is referred to, but not fully defined.", Logger::Level::WARNING);
 	};
 	// Class objects with a deferred definition should still get named when content is loaded.
 	auto NameIfDeferred = [](const set<string> &deferred, auto &it)
@@ -269,14 +415,20 @@ void UniverseObjects::CheckReferences()
 		if(it.second.TrueName().empty())
 			NameAndWarn("effect", it);
 	// Fleets are not serialized. Any changes via events are written as DataNodes and thus self-define.
+	// Checking their variants means checking every ship in them, so they are checked in parallel.
+	vector<pair<const string, Fleet> *> fleetList;
+	fleetList.reserve(fleets.size());
 	for(auto &&it : fleets)
+		fleetList.push_back(&it);
+	const set<string> &deferredFleets = deferred["fleet"];
+	ForEachInParallel(fleetList, [&Warn, &deferredFleets](pair<const string, Fleet> &it)
 	{
 		// Plugins may alter stock fleets with new variants that exclusively use plugin ships.
 		// Rather than disable the whole fleet due to these non-instantiable variants, remove them.
 		it.second.RemoveInvalidVariants();
-		if(!it.second.IsValid() && !deferred["fleet"].contains(it.first))
+		if(!it.second.IsValid() && !deferredFleets.contains(it.first))
 			Warn("fleet", it.first);
-	}
+	});
 	// Government names are used in mission NPC blocks and LocationFilters.
 	for(auto &&it : governments)
 		if(it.second.TrueName().empty() && !NameIfDeferred(deferred["government"], it))
@@ -349,6 +501,68 @@ void UniverseObjects::CheckReferences()
 
 
 
+// Remember which data files are loaded, so that they can be reloaded when
+// they change. This must be called before loading.
+void UniverseObjects::WatchFiles()
+{
+	isWatching = true;
+}
+
+
+
+// Get the watched data files that have been modified since they were loaded.
+vector<filesystem::path> UniverseObjects::ChangedFiles() const
+{
+	vector<filesystem::path> changed;
+	for(const WatchedFile &file : watchedFiles)
+	{
+		// A file that is being replaced may briefly not exist.
+		error_code error;
+		filesystem::file_time_type timestamp = filesystem::last_write_time(file.path, error);
+		if(!error && timestamp != file.timestamp)
+			changed.push_back(file.path);
+	}
+	return changed;
+}
+
+
+
+// Reload the given data files, as well as any later file that defines some of
+// the same objects, so that it still overrides them. Returns every token in
+// the reloaded files.
+set<string> UniverseObjects::Reload(const vector<filesystem::path> &changed, const PlayerInfo &player,
+	const ConditionsStore *globalConditions)
+{
+	set<string> affected;
+	set<string> tokens;
+	for(WatchedFile &file : watchedFiles)
+	{
+		const bool isChanged = ranges::find(changed, file.path) != changed.end();
+		if(!isChanged && ranges::none_of(file.roots, [&affected](const string &root) { return affected.contains(root); }))
+			continue;
+
+		DataFile data;
+		DataFileCache::Load(file.path, data);
+		if(isChanged)
+		{
+			// Objects that are no longer defined by this file may still be overridden by later files.
+			affected.insert(file.roots.begin(), file.roots.end());
+			file.timestamp = Files::Timestamp(file.path);
+			file.roots = RootNames(data);
+		}
+		affected.insert(file.roots.begin(), file.roots.end());
+		for(const DataNode &node : data)
+			AddTokens(node, tokens);
+
+		Logger::Log("Reloading: " + file.path.string(), Logger::Level::INFO);
+		LoadFile(file.path, data, player, globalConditions);
+	}
+	FinishLoading();
+	return tokens;
+}
+
+
+
 void UniverseObjects::DrawMenuBackground(Panel *panel) const
 {
 	lock_guard<mutex> lock(menuBackgroundMutex);
@@ -357,20 +571,17 @@ void UniverseObjects::DrawMenuBackground(Panel *panel) const
 
 
 
-void UniverseObjects::LoadFile(const filesystem::path &path, const PlayerInfo &player,
-		const ConditionsStore *globalConditions, bool debugMode)
+void UniverseObjects::LoadFile(const filesystem::path &path, const DataFile &data, const PlayerInfo &player,
+		const ConditionsStore *globalConditions, bool debugMode, bool loadLazily)
 {
-	// This is an ordinary file. Check to see if it is an image.
-	if(path.extension() != ".txt")
-		return;
-
-	DataFile data(path);
+	// The bytes of each file are counted when it is parsed.
+	StartupProfile::Scope scope("UniverseObjects::LoadFile", path, false);
 	if(debugMode)
 		Logger::Log("Parsing: " + path.string(), Logger::Level::INFO);
 
 	const ConditionsStore *playerConditions = &player.Conditions();
-	const set<const System *> *visitedSystems = &player.VisitedSystems();
-	const set<const Planet *> *visitedPlanets = &player.VisitedPlanets();
+	const IndexedSet<System> *visitedSystems = &player.VisitedSystems();
+	const IndexedSet<Planet> *visitedPlanets = &player.VisitedPlanets();
 	// If at any point an "overwrite" node is encountered, that means that the next
 	// loaded node must have its previous definition cleared before loading the new values.
 	// For some root nodes, this doesn't require any special handling, as a duplicate
@@ -534,7 +745,7 @@ void UniverseObjects::LoadFile(const filesystem::path &path, const PlayerInfo &p
 			Mission *mission = missions.Get(node.Token(1));
 			if(overwrite)
 				*mission = Mission();
-			mission->Load(node, playerConditions, visitedSystems, visitedPlanets);
+			mission->Load(node, playerConditions, visitedSystems, visitedPlanets, loadLazily);
 		}
 		else if(key == "outfit" && hasValue)
 		{
@@ -34,6 +34,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Message.h"
 #include "Minable.h"
 #include "Mission.h"
+#include "MissionIndex.h"
 #include "News.h"
 #include "Outfit.h"
 #include "Person.h"
@@ -48,6 +49,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "test/TestData.h"
 #include "TextReplacements.h"
 #include "Trade.h"
+#include "TradeNetwork.h"
 #include "Wormhole.h"
 
 #include <atomic>
@@ -59,6 +61,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <string>
 #include <vector>
 
+class DataFile;
 class ConditionsStore;
 class Panel;
 class PlayerInfo;
@@ -74,9 +77,11 @@ class UniverseObjects {
 	friend class GameData;
 	friend class TestData;
 public:
-	// Load game objects from the given directories of definitions.
+	// Load game objects from the given directories of definitions. If loading
+	// lazily, stock missions are only parsed as far as needed to offer them.
 	std::shared_future<void> Load(TaskQueue &queue, const std::vector<std::filesystem::path> &sources,
-		const PlayerInfo &player, const ConditionsStore *globalConditions, bool debugMode = false);
+		const PlayerInfo &player, const ConditionsStore *globalConditions, bool debugMode = false,
+		bool loadLazily = false);
 	// Determine the fraction of data files read from disk.
 	double GetProgress() const;
 	// Resolve every game object dependency.
@@ -90,8 +95,20 @@ public:
 	// Determine which attributes may be required in order to use a wormhole.
 	void RecomputeWormholeRequirements();
 
-	// Check for objects that are referred to but never defined.
-	void CheckReferences();
+	// Check for objects that are referred to but never defined. If a scope is
+	// given, only objects with one of those names are warned about.
+	void CheckReferences(const std::set<std::string> *scope = nullptr);
+
+	// Remember which data files are loaded, so that they can be reloaded when
+	// they change. This must be called before loading.
+	void WatchFiles();
+	// Get the watched data files that have been modified since they were loaded.
+	std::vector<std::filesystem::path> ChangedFiles() const;
+	// Reload the given data files, as well as any later file that defines some of
+	// the same objects, so that it still overrides them. Returns every token in
+	// the reloaded files.
+	std::set<std::string> Reload(const std::vector<std::filesystem::path> &changed, const PlayerInfo &player,
+		const ConditionsStore *globalConditions);
 
 	// Draws the current menu background. Unlike accessing the menu background
 	// through GameData, this function is thread-safe.
@@ -99,14 +116,31 @@ public:
 
 
 private:
-	void LoadFile(const std::filesystem::path &path, const PlayerInfo &player,
-		const ConditionsStore *globalConditions, bool debugMode = false);
+	// Apply the nodes of a data file that has already been parsed.
+	void LoadFile(const std::filesystem::path &path, const DataFile &data, const PlayerInfo &player,
+		const ConditionsStore *globalConditions, bool debugMode = false, bool loadLazily = false);
+
+
+private:
+	// A data file that is watched for changes.
+	class WatchedFile {
+	public:
+		std::filesystem::path path;
+		std::filesystem::file_time_type timestamp;
+		// The tokens of each of this file's root nodes, which identify the objects it defines.
+		std::set<std::string> roots;
+	};
 
 
 private:
 	// A value in [0, 1] representing how many source files have been processed for content.
 	std::atomic<double> progress;
 
+	// Every data file that was loaded, in the order that they were loaded, if
+	// they are being watched for changes.
+	bool isWatching = false;
+	std::vector<WatchedFile> watchedFiles;
+
 
 private:
 	Set<Color> colors;
@@ -124,6 +158,8 @@ private:
 	Set<Message> messages;
 	Set<Minable> minables;
 	Set<Mission> missions;
+	// The missions that may be offered on landing, by where they are offered.
+	MissionIndex missionIndex;
 	Set<News> news;
 	Set<Outfit> outfits;
 	Set<Person> persons;
@@ -145,6 +181,7 @@ private:
 
 	TextReplacements substitutions;
 	Trade trade;
+	TradeNetwork tradeNetwork;
 	std::vector<StartConditions> startConditions;
 	std::map<std::string, std::vector<std::string>> ratings;
 	std::map<const Sprite *, std::string> landingMessages;
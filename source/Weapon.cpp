@@ -458,6 +458,17 @@ bool Weapon::IsLoaded() const
 
 
 
+// Work out the values that depend on this weapon's submunitions, such as its
+// total damage and lifetime, once every weapon has been loaded. Otherwise
+// they are worked out when first asked for, which may be by several threads.
+void Weapon::FinishLoading() const
+{
+	TotalDamage(0);
+	TotalLifetime();
+}
+
+
+
 // Get assets used by this weapon.
 const Body &Weapon::WeaponSprite() const
 {
@@ -66,6 +66,10 @@ public:
 	// Load from a "weapon" node, either in an outfit, a ship (explosion), or a hazard.
 	void Load(const DataNode &node);
 	bool IsLoaded() const;
+	// Work out the values that depend on this weapon's submunitions, such as its
+	// total damage and lifetime, once every weapon has been loaded. Otherwise
+	// they are worked out when first asked for, which may be by several threads.
+	void FinishLoading() const;
 
 	// Get assets used by this weapon.
 	const Body &WeaponSprite() const;
@@ -83,18 +83,27 @@ void Weather::Step(vector<Visual> &visuals, const Point &center)
 	double maxRange = hazard->MaxRange();
 	double effectMultiplier = currentStrength;
 
+	// Find the farthest possible point from the screen center. Multiply by 2 to
+	// account for the max view zoom level. Effects beyond this can't be seen.
+	const double viewRange = 2. * Screen::Dimensions().Length();
 	// If a hazard is system-wide, the max range becomes the edge of the screen,
 	// and the number of effects drawn is scaled accordingly.
 	if(hazard->SystemWide() && maxRange > 0.)
 	{
-		// Find the farthest possible point from the screen center and use that as
-		// our new max range. Multiply by 2 to account for the max view zoom level.
-		double newMax = 2. * Screen::Dimensions().Length();
 		// Maintain the same density of effects by dividing the new area
 		// by the old. (The pis cancel out and therefore need not be taken
 		// into account.)
-		effectMultiplier *= (newMax * newMax) / (maxRange * maxRange);
-		maxRange = newMax;
+		effectMultiplier *= (viewRange * viewRange) / (maxRange * maxRange);
+		maxRange = viewRange;
+	}
+
+	// Don't create effects for a hazard that is entirely out of view, either
+	// because it is too far away or because the view is inside its minimum range.
+	bool isVisible = true;
+	if(!hazard->SystemWide())
+	{
+		double distance = origin.Distance(center);
+		isVisible = (distance - maxRange < viewRange && distance + viewRange > minRange);
 	}
 
 	// Don't draw effects if a system-wide hazard moved the max range to
@@ -103,20 +112,31 @@ void Weather::Step(vector<Visual> &visuals, const Point &center)
 	{
 		// Estimate the number of visuals to be generated this frame.
 		// MAYBE: create only a subset of possible effects per frame.
-		float totalAmount = 0;
-		for(auto &&effect : hazard->EnvironmentalEffects())
-			totalAmount += effect.second;
-		totalAmount *= effectMultiplier;
-		visuals.reserve(visuals.size() + static_cast<int>(totalAmount));
-
+		if(isVisible)
+		{
+			float totalAmount = 0;
+			for(auto &&effect : hazard->EnvironmentalEffects())
+				totalAmount += effect.second;
+			totalAmount *= effectMultiplier;
+			visuals.reserve(visuals.size() + static_cast<int>(totalAmount));
+		}
+
+		// The random numbers for every effect are drawn even if it will not be
+		// seen, so that how many are used does not depend on where the camera
+		// is. Otherwise, replaying recorded input would not give the same game.
 		for(auto &&effect : hazard->EnvironmentalEffects())
 			for(int i = 0; i < effect.second * effectMultiplier; ++i)
 			{
 				Point angle = Angle::Random().Unit();
 				double magnitude = (maxRange - minRange) * sqrt(Random::Real());
+				Angle facing = Angle::Random();
+				if(!isVisible)
+					continue;
 				Point pos = (hazard->SystemWide() ? center : origin)
 					+ (minRange + magnitude) * angle;
-				visuals.emplace_back(*effect.first, std::move(pos), Point(), Angle::Random());
+				if(pos.Distance(center) > viewRange)
+					continue;
+				visuals.emplace_back(*effect.first, std::move(pos), Point(), facing);
 			}
 	}
 
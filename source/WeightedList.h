@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Random.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <iterator>
 #include <numeric>
@@ -31,6 +32,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // list is weighted with an integer. This list can be queried to randomly return
 // one object from the list where the probability of an object being returned is
 // the weight of the object over the sum of the weights of all objects in the list.
+// The running totals of the weights are kept as well, so that a random object
+// can be found with a binary search rather than by adding up the weights.
 template<class Type>
 class WeightedList {
 	using iterator = typename std::vector<Type>::iterator;
@@ -58,8 +61,8 @@ public:
 	iterator end() noexcept { return choices.end(); }
 	const_iterator end() const noexcept { return choices.end(); }
 
-	void clear() noexcept { choices.clear(); weights.clear(); total = 0; }
-	void reserve(std::size_t n) { choices.reserve(n); weights.reserve(n); }
+	void clear() noexcept { choices.clear(); weights.clear(); cumulative.clear(); total = 0; }
+	void reserve(std::size_t n) { choices.reserve(n); weights.reserve(n); cumulative.reserve(n); }
 	std::size_t size() const noexcept { return choices.size(); }
 	bool empty() const noexcept { return choices.empty(); }
 	Type &back() noexcept { return choices.back(); }
@@ -79,6 +82,8 @@ private:
 private:
 	std::vector<Type> choices;
 	std::vector<std::size_t> weights;
+	// The sum of the weights of each choice and all the choices before it.
+	std::vector<std::size_t> cumulative;
 	std::size_t total = 0;
 };
 
@@ -129,11 +134,11 @@ const Type &WeightedList<Type>::Get() const
 	if(empty())
 		throw std::runtime_error("Attempted to call Get on an empty weighted list.");
 
-	unsigned index = 0;
-	for(unsigned choice = Random::Int(total); choice >= weights[index]; ++index)
-		choice -= weights[index];
-
-	return choices[index];
+	// The first choice whose running total exceeds the random number is the
+	// same one that subtracting each weight in turn would land on.
+	const std::size_t choice = Random::Int(total);
+	const auto it = std::upper_bound(cumulative.begin(), cumulative.end(), choice);
+	return choices[std::distance(cumulative.begin(), it)];
 }
 
 
@@ -167,6 +172,7 @@ Type &WeightedList<Type>::emplace_back(int weight, Args &&...args)
 	choices.emplace_back(std::forward<Args>(args)...);
 	weights.emplace_back(weight);
 	total += weights.back();
+	cumulative.emplace_back(total);
 	return choices.back();
 }
 
@@ -176,8 +182,8 @@ template<class Type>
 typename std::vector<Type>::iterator WeightedList<Type>::eraseAt(typename std::vector<Type>::iterator position) noexcept
 {
 	unsigned index = std::distance(choices.begin(), position);
-	total -= weights[index];
 	weights.erase(std::next(weights.begin(), index));
+	RecalculateWeight();
 	return choices.erase(position);
 }
 
@@ -199,5 +205,8 @@ typename std::vector<Type>::iterator WeightedList<Type>::erase(typename std::vec
 template<class Type>
 void WeightedList<Type>::RecalculateWeight()
 {
-	total = std::accumulate(weights.begin(), weights.end(), 0);
+	// Removing choices only ever shrinks the running totals, so this cannot throw.
+	cumulative.resize(weights.size());
+	std::partial_sum(weights.begin(), weights.end(), cumulative.begin());
+	total = cumulative.empty() ? 0 : cumulative.back();
 }
@@ -17,13 +17,36 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Files.h"
 
+#include <algorithm>
 #include <functional>
+#include <map>
+#include <mutex>
 #include <numeric>
 
 using namespace std;
 
 
 
+class ZipFile::Index {
+public:
+	/// Every file and directory in the zip, sorted by name.
+	vector<Entry> entries;
+	/// The name of the top-level directory inside the zip, or an empty string if it doesn't have such a directory
+	filesystem::path topLevelDirectory;
+	/// The modification time and size of the zip when it was indexed, so that
+	/// an index is not reused once the zip has been replaced.
+	filesystem::file_time_type modified;
+	uintmax_t size = 0;
+
+	/// Check whether this index was built from the given version of the zip.
+	bool Matches(filesystem::file_time_type otherModified, uintmax_t otherSize) const
+	{
+		return modified == otherModified && size == otherSize;
+	}
+};
+
+
+
 ZipFile::ZipFile(const filesystem::path &zipPath)
 	: basePath(zipPath)
 {
@@ -31,17 +54,69 @@ ZipFile::ZipFile(const filesystem::path &zipPath)
 	if(!zipFile)
 		throw runtime_error("Failed to open ZIP file" + zipPath.generic_string());
 
+	// The index of each zip is only built by the first ZipFile that opens it,
+	// unless the zip has changed on disk since then.
+	static mutex indexMutex;
+	static map<filesystem::path, shared_ptr<const Index>> indices;
+	error_code error;
+	const filesystem::file_time_type modified = filesystem::last_write_time(basePath, error);
+	const uintmax_t size = error ? 0 : filesystem::file_size(basePath, error);
+	{
+		lock_guard<mutex> lock(indexMutex);
+		auto it = indices.find(basePath);
+		if(it != indices.end() && !error && it->second->Matches(modified, size))
+		{
+			index = it->second;
+			return;
+		}
+	}
+
+	auto newIndex = make_shared<Index>();
+	newIndex->modified = modified;
+	newIndex->size = size;
+	if(unzGoToFirstFile(zipFile) != UNZ_OK)
+	{
+		unzClose(zipFile);
+		throw runtime_error("Failed to go to first file in ZIP");
+	}
+	do {
+		unz_file_info64 fileInfo;
+		if(unzGetCurrentFileInfo64(zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+			continue;
+		Entry entry;
+		entry.name.resize(fileInfo.size_filename);
+		unzGetCurrentFileInfo64(zipFile, nullptr, entry.name.data(), entry.name.size(), nullptr, 0, nullptr, 0);
+		unzGetFilePos64(zipFile, &entry.position);
+		entry.size = fileInfo.uncompressed_size;
+		newIndex->entries.push_back(std::move(entry));
+	} while(unzGoToNextFile(zipFile) == UNZ_OK);
+	sort(newIndex->entries.begin(), newIndex->entries.end(),
+		[](const Entry &a, const Entry &b) { return a.name < b.name; });
+
 	// Check whether this zip has a single top-level directory (such as high-dpi.zip/high-dpi)
 	filesystem::path topLevel;
-	for(const filesystem::path &path : ListFiles("", true, false))
+	for(const Entry &entry : newIndex->entries)
 	{
-		filesystem::path zipPath = path.lexically_relative(basePath);
+		if(entry.name.empty() || entry.name.back() == '/')
+			continue;
+		filesystem::path zipEntry = entry.name;
 		if(topLevel.empty())
-			topLevel = *zipPath.begin();
-		else if(*zipPath.begin() != topLevel)
-			return;
+			topLevel = *zipEntry.begin();
+		else if(*zipEntry.begin() != topLevel)
+		{
+			topLevel.clear();
+			break;
+		}
 	}
-	topLevelDirectory = topLevel;
+	newIndex->topLevelDirectory = topLevel;
+
+	// If another thread indexed the same version of this zip in the meantime,
+	// use its index instead. Otherwise, replace any index of an older version.
+	lock_guard<mutex> lock(indexMutex);
+	shared_ptr<const Index> &cached = indices[basePath];
+	if(!cached || !cached->Matches(modified, size))
+		cached = std::move(newIndex);
+	index = cached;
 }
 
 
@@ -61,21 +136,16 @@ vector<filesystem::path> ZipFile::ListFiles(const filesystem::path &directory, b
 	filesystem::path relative = GetPathInZip(directory);
 	vector<filesystem::path> fileList;
 
-	if(unzGoToFirstFile(zipFile) != UNZ_OK)
-		throw runtime_error("Failed to go to first file in ZIP");
-	do {
-		char filename[256];
-		unz_file_info fileInfo;
-		unzGetCurrentFileInfo(zipFile, &fileInfo, filename, sizeof(filename), NULL, 0, NULL, 0);
-
-		filesystem::path zipEntry = filename;
-		bool isDirectory = string(filename).back() == '/';
+	for(const Entry &entry : index->entries)
+	{
+		filesystem::path zipEntry = entry.name;
+		bool isDirectory = !entry.name.empty() && entry.name.back() == '/';
 		bool isValidSubtree = Files::IsParent(relative, zipEntry);
 		bool isRecursive = distance(zipEntry.begin(), zipEntry.end()) == distance(relative.begin(), relative.end()) + 1;
 
 		if(isValidSubtree && isDirectory == directories && (!isRecursive || recursive))
 			fileList.push_back(GetGlobalPath(zipEntry));
-	} while(unzGoToNextFile(zipFile) == UNZ_OK);
+	}
 
 	return fileList;
 }
@@ -87,39 +157,51 @@ bool ZipFile::Exists(const filesystem::path &filePath) const
 	filesystem::path relative = GetPathInZip(filePath);
 	string name = relative.generic_string();
 
-	return unzLocateFile(zipFile, name.c_str(), 0) == UNZ_OK ||
-			unzLocateFile(zipFile, (name + "/").c_str(), 0) == UNZ_OK;
+	return Find(name) || Find(name + "/");
 }
 
 
 
 string ZipFile::ReadFile(const filesystem::path &filePath) const
 {
-	filesystem::path relative = GetPathInZip(filePath);
-
-	if(unzLocateFile(zipFile, relative.generic_string().c_str(), 0) != UNZ_OK)
-		return {};
-
-	if(unzOpenCurrentFile(zipFile) != UNZ_OK)
-		return {};
+	string contents;
+	ReadFile(filePath, contents);
+	return contents;
+}
 
-	unz_file_info64 info;
 
-	info.uncompressed_size = 0;
-	unzGetCurrentFileInfo64(zipFile, &info, nullptr, 0, nullptr, 0, nullptr, 0);
 
-	char buffer[8192];
-	string contents;
+bool ZipFile::ReadFile(const filesystem::path &filePath, string &buffer) const
+{
+	buffer.clear();
+	const Entry *entry = Find(GetPathInZip(filePath).generic_string());
+	if(!entry)
+		return false;
+
+	// Jump straight to the file, instead of searching the central directory for it.
+	if(unzGoToFilePos64(zipFile, &entry->position) != UNZ_OK || unzOpenCurrentFile(zipFile) != UNZ_OK)
+		return false;
+
+	// The uncompressed size is known in advance, so the file can be decompressed in place.
+	buffer.resize(entry->size);
+	size_t totalRead = 0;
 	int bytesRead = 0;
-	while((bytesRead = unzReadCurrentFile(zipFile, buffer, sizeof(buffer))) > 0)
-		contents.append(buffer, bytesRead);
-
-	unzCloseCurrentFile(zipFile);
-
-	if(bytesRead < 0)
-		return {};
+	while(totalRead < buffer.size())
+	{
+		const unsigned chunk = min<size_t>(buffer.size() - totalRead, 1 << 30);
+		bytesRead = unzReadCurrentFile(zipFile, buffer.data() + totalRead, chunk);
+		if(bytesRead <= 0)
+			break;
+		totalRead += bytesRead;
+	}
 
-	return contents;
+	// Closing the file also checks its CRC, if it was read completely.
+	if(unzCloseCurrentFile(zipFile) != UNZ_OK || bytesRead < 0 || totalRead != buffer.size())
+	{
+		buffer.clear();
+		return false;
+	}
+	return true;
 }
 
 
@@ -127,8 +209,8 @@ string ZipFile::ReadFile(const filesystem::path &filePath) const
 filesystem::path ZipFile::GetPathInZip(const filesystem::path &path) const
 {
 	filesystem::path relative = path.lexically_relative(basePath);
-	if(!topLevelDirectory.empty())
-		relative = topLevelDirectory / relative;
+	if(!index->topLevelDirectory.empty())
+		relative = index->topLevelDirectory / relative;
 	return relative;
 }
 
@@ -140,7 +222,16 @@ filesystem::path ZipFile::GetGlobalPath(const filesystem::path &path) const
 		return path;
 
 	// If this zip has a top-level directory, remove it from the path.
-	if(!topLevelDirectory.empty())
+	if(!index->topLevelDirectory.empty())
 		return basePath / accumulate(next(path.begin()), path.end(), filesystem::path{}, std::divides{});
 	return basePath / path;
 }
+
+
+
+const ZipFile::Entry *ZipFile::Find(const string &name) const
+{
+	auto it = lower_bound(index->entries.begin(), index->entries.end(), name,
+		[](const Entry &entry, const string &name) { return entry.name < name; });
+	return (it != index->entries.end() && it->name == name) ? &*it : nullptr;
+}
@@ -17,8 +17,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <minizip/unzip.h>
 
+#include <cstdint>
 #include <filesystem>
-#include <mutex>
+#include <memory>
+#include <string>
 #include <vector>
 
 
@@ -27,7 +29,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 /// This class supports zips both with and without a top-level directory, as long as
 /// the directory's name matches the zip's name. The necessary path translations are
 /// performed within this class, and aren't visible to the user.
-/// ZipFiles are not thread safe. A zip file may only be used on one thread at a time.
+/// The zip's central directory is only read once, no matter how many times the zip is
+/// opened, and the resulting index is shared by every ZipFile for it. Each ZipFile has its
+/// own handle, so several of them can read from the same zip on different threads, but
+/// a single ZipFile may only be used on one thread at a time.
 class ZipFile {
 public:
 	explicit ZipFile(const std::filesystem::path &zipPath);
@@ -45,9 +50,26 @@ public:
 	/// @param filePath The complete file path, including the zip's path.
 	bool Exists(const std::filesystem::path &filePath) const;
 
-	/// Reads a frp, from the zip.
+	/// Reads a file from the zip.
 	/// @param filePath The complete file path, including the zip's path.
 	std::string ReadFile(const std::filesystem::path &filePath) const;
+	/// Decompresses a file from the zip directly into the given buffer, which is resized to fit it.
+	/// @param filePath The complete file path, including the zip's path.
+	/// @return Whether the file exists and could be read. If not, the buffer is left empty.
+	bool ReadFile(const std::filesystem::path &filePath, std::string &buffer) const;
+
+
+private:
+	/// The central directory of a zip file.
+	class Index;
+	/// One file or directory in the central directory.
+	class Entry {
+	public:
+		/// The path within the zip. Directories end with a '/'.
+		std::string name;
+		unz64_file_pos position;
+		uint64_t size;
+	};
 
 
 private:
@@ -58,12 +80,15 @@ private:
 	/// @param path The in-zip path, without the zip's own path.
 	std::filesystem::path GetGlobalPath(const std::filesystem::path &path) const;
 
+	/// Finds the given in-zip path in the index, if it exists.
+	const Entry *Find(const std::string &name) const;
+
 
 private:
 	/// The zip handle
 	unzFile zipFile = nullptr;
 	/// The path of the zip file in the filesystem
 	std::filesystem::path basePath;
-	/// The name of the top-level directory inside the zip, or an empty string if it doesn't have such a directory
-	std::filesystem::path topLevelDirectory;
+	/// The index of the zip's contents, shared with every other ZipFile for the same zip.
+	std::shared_ptr<const Index> index;
 };
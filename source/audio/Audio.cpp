@@ -19,21 +19,29 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "supplier/effect/Fade.h"
 #include "../Files.h"
 #include "../Logger.h"
+#include "../MemoryProfile.h"
 #include "Music.h"
 #include "player/MusicPlayer.h"
 #include "../Point.h"
+#include "../Profiler.h"
 #include "Sound.h"
+#include "../StartupProfile.h"
+#include "supplier/AsyncAudioSupplier.h"
+#include "../TaskQueue.h"
 
 #include <AL/al.h>
 #include <AL/alc.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -52,6 +60,10 @@ namespace {
 		SoundCategory category = SoundCategory::MASTER;
 	};
 
+	// How much quieter a sound at the given offset from the listener is. This is
+	// also the weight that the sound is given in its queue entry.
+	double Attenuation(Point offset);
+
 	void Move(const AudioPlayer &player, QueueEntry entry)
 	{
 		Point angle = entry.sum / entry.weight;
@@ -61,8 +73,44 @@ namespace {
 		player.Move(angle.X() * scale, angle.Y() * scale, -scale);
 	}
 
-	// Thread entry point for loading the sound files.
-	void Load();
+	// How many sounds can play at once. This includes the music.
+	constexpr size_t VOICES = 256;
+	// Each step, a sound becomes this much less important, so that a sound that
+	// is nearly over is interrupted before one that just started. Looping sounds
+	// are given a new priority every step, for as long as they keep playing.
+	constexpr double PRIORITY_DECAY = .97;
+	// Sounds whose gain at the listener would be below this are not played at all.
+	constexpr double MIN_GAIN = .005;
+	// How many copies of the same sound can play at once. A new copy takes the
+	// place of the least important old one, if it is more important.
+	constexpr size_t MAX_INSTANCES = 6;
+
+	// How important each category of sound is, when there are more sounds than
+	// there are sources to play them on.
+	double CategoryPriority(SoundCategory category)
+	{
+		switch(category)
+		{
+			case SoundCategory::MUSIC:
+				return numeric_limits<double>::infinity();
+			case SoundCategory::UI:
+			case SoundCategory::ALERT:
+				return 8.;
+			case SoundCategory::JUMP:
+			case SoundCategory::EXPLOSION:
+				return 4.;
+			case SoundCategory::SCAN:
+				return 3.;
+			case SoundCategory::WEAPON:
+			case SoundCategory::ANTI_MISSILE:
+				return 2.;
+			case SoundCategory::ENGINE:
+			case SoundCategory::AFTERBURNER:
+				return 1.5;
+			default:
+				return 1.;
+		}
+	}
 
 
 	// Mutex to make sure different threads don't modify the audio at the same time.
@@ -92,10 +140,15 @@ namespace {
 	vector<shared_ptr<AudioPlayer>> players;
 	/// The looping players for reuse. Looping sources always have the Fade effect.
 	map<const Sound *, shared_ptr<AudioPlayer>> loopingPlayers;
+	/// The players of each sound that is not looping, to limit how many copies of it play at once.
+	map<const Sound *, vector<shared_ptr<AudioPlayer>>> instances;
 
-	// Queue and thread for loading sound files in the background.
-	map<string, filesystem::path> loadQueue;
-	thread loadThread;
+	// The tasks loading sound files in the background, and how many sounds they have loaded.
+	vector<shared_future<void>> loadTasks;
+	size_t soundsToLoad = 0;
+	atomic<size_t> soundsLoaded = 0;
+	// Set when quitting, so that the sounds that are not loaded yet are skipped.
+	atomic<bool> stopLoading = false;
 
 	// The current position of the "listener," i.e. the center of the screen.
 	Point listener;
@@ -110,13 +163,78 @@ namespace {
 	// If we paused the audio multiple times, only resume it after the same number of Resume() calls.
 	// We start with -2, so when MenuPanel and PlanetPanel opens up the first time, it doesn't pause the loading sounds.
 	int pauseCount = -2;
+
+	// The sounds that start playing this step, from most to least important.
+	vector<pair<double, const Sound *>> newSounds;
+
+	// Statistics for the performance display and the profiler. Sounds can be
+	// dropped from any thread, and everything else only happens in the main one.
+	atomic<int64_t> droppedSounds = 0;
+	int64_t stolenSounds = 0;
+	int64_t steps = 0;
+	chrono::steady_clock::duration stepTime{};
+	// The streaming statistics when they were last reset.
+	int64_t underrunsAtReset = 0;
+	chrono::nanoseconds decodeTimeAtReset{};
+	double decodedChunksAtReset = 0.;
+
+	// How important it is to play the sound in the given queue entry. Louder
+	// sounds are more important, whether because they are closer to the
+	// listener, because there are many of them, or because of their volume.
+	double Priority(const QueueEntry &entry)
+	{
+		return CategoryPriority(entry.category) * entry.weight * Audio::Volume(entry.category);
+	}
+
+	// If no source is free, interrupt the least important sound that is less
+	// important than the given priority. Returns true if a source is now free.
+	bool MakeRoom(double priority)
+	{
+		if(AudioPlayer::AvailableSources())
+			return true;
+
+		auto victim = players.end();
+		for(auto it = players.begin(); it != players.end(); ++it)
+			if((*it)->HasSource() && (*it)->Category() != SoundCategory::MUSIC && (*it)->Priority() < priority
+					&& (victim == players.end() || (*it)->Priority() < (*victim)->Priority()))
+				victim = it;
+		if(victim == players.end())
+			return false;
+
+		erase_if(loopingPlayers, [&victim](const auto &it){ return it.second == *victim; });
+		(*victim)->Interrupt();
+		players.erase(victim);
+		++stolenSounds;
+		return true;
+	}
+
+	// If the given sound is already playing as often as it can, interrupt its
+	// least important copy, if that is less important than the given priority.
+	// Returns true if another copy of the sound can now be played.
+	bool MakeInstanceRoom(vector<shared_ptr<AudioPlayer>> &copies, double priority)
+	{
+		if(copies.size() < MAX_INSTANCES)
+			return true;
+
+		auto victim = min_element(copies.begin(), copies.end(),
+			[](const auto &a, const auto &b){ return a->Priority() < b->Priority(); });
+		if((*victim)->Priority() >= priority)
+			return false;
+
+		// The interrupted player is finished, so it is dropped from the list of players in the next step.
+		(*victim)->Interrupt();
+		copies.erase(victim);
+		++stolenSounds;
+		return true;
+	}
 }
 
 
 
-// Begin loading sounds (in a separate thread).
-void Audio::Init(const vector<filesystem::path> &sources)
+// Open the audio device.
+void Audio::Init()
 {
+	StartupProfile::Scope scope("Audio::Init");
 	device = alcOpenDevice(nullptr);
 	if(!device)
 		return;
@@ -128,6 +246,7 @@ void Audio::Init(const vector<filesystem::path> &sources)
 	// If we don't make it to this point, no audio will be played.
 	isInitialized = true;
 	mainThreadID = this_thread::get_id();
+	AudioPlayer::ReserveSources(VOICES);
 
 	// The listener is looking "into" the screen. This orientation vector is
 	// used to determine what sounds should be in the right or left speaker.
@@ -140,20 +259,22 @@ void Audio::Init(const vector<filesystem::path> &sources)
 	alListenerfv(AL_ORIENTATION, orientation);
 	alDistanceModel(AL_INVERSE_DISTANCE_CLAMPED);
 	alDopplerFactor(0.);
-
-	LoadSounds(sources);
 }
 
 
 
-// Get all the sound files in the game data and all plugins.
-void Audio::LoadSounds(const vector<filesystem::path> &sources)
+// Get all the sound files in the game data and all plugins, and begin loading
+// them on the queue's threads.
+void Audio::LoadSounds(TaskQueue &queue, const vector<filesystem::path> &sources)
 {
+	StartupProfile::Scope scope("Audio::LoadSounds");
+	// If a plugin has a file with the same name as the game data or an
+	// earlier plugin, only the plugin's file is used.
+	map<string, filesystem::path> files;
 	for(const auto &source : sources)
 	{
 		filesystem::path root = source / "sounds";
-		vector<filesystem::path> files = Files::RecursiveList(root);
-		for(const auto &path : files)
+		for(const auto &path : Files::RecursiveList(root))
 		{
 			if(path.extension() == ".wav")
 			{
@@ -162,19 +283,45 @@ void Audio::LoadSounds(const vector<filesystem::path> &sources)
 				string name = (path.parent_path() / path.stem()).lexically_relative(root).generic_string();
 				if(name.ends_with('~'))
 					name.resize(name.length() - 1);
-				loadQueue[name] = path;
+				files[name] = path;
 			}
 		}
 	}
-	// Begin loading the files.
-	if(!loadQueue.empty())
-		loadThread = thread(&Load);
+
+	// @3x sounds are merged with their regular variant, so both files of a sound
+	// are loaded by the same task.
+	map<string, vector<filesystem::path>> soundFiles;
+	for(auto &[name, path] : files)
+		soundFiles[name.ends_with("@3x") ? name.substr(0, name.size() - 3) : name].emplace_back(std::move(path));
+
+	unique_lock<mutex> lock(audioMutex);
+	soundsToLoad += soundFiles.size();
+	for(auto &it : soundFiles)
+	{
+		Sound *sound = &sounds[it.first];
+		loadTasks.emplace_back(queue.Run([sound, name = it.first, paths = std::move(it.second)]() -> void
+			{
+				MemoryProfile::Scope memoryScope(MemoryProfile::Tag::AUDIO);
+				for(const filesystem::path &path : paths)
+				{
+					if(stopLoading)
+						break;
+					StartupProfile::Scope scope("Sound::Load", path);
+					if(!sound->Load(path, name))
+						Logger::Log("Unable to load sound \"" + name + "\" from path: " + path.string(),
+							Logger::Level::WARNING);
+				}
+				sound->SetLoaded();
+				++soundsLoaded;
+			}));
+	}
 }
 
 
 
 void Audio::CheckReferences(bool parseOnly)
 {
+	StartupProfile::Scope scope("Audio::CheckReferences");
 	if(!isInitialized && !parseOnly)
 	{
 		Logger::Log("Audio could not be initialized. No audio will play.", Logger::Level::WARNING);
@@ -191,14 +338,10 @@ void Audio::CheckReferences(bool parseOnly)
 // Report the progress of loading sounds.
 double Audio::GetProgress()
 {
-	unique_lock<mutex> lock(audioMutex);
-
-	if(loadQueue.empty())
+	if(!soundsToLoad)
 		return 1.;
 
-	double done = sounds.size();
-	double total = done + loadQueue.size();
-	return done / total;
+	return static_cast<double>(soundsLoaded) / soundsToLoad;
 }
 
 
@@ -261,17 +404,26 @@ void Audio::Play(const Sound *sound, SoundCategory category)
 // "listener". This will make it softer and change the left / right balance.
 void Audio::Play(const Sound *sound, const Point &position, SoundCategory category)
 {
-	if(!isInitialized || !sound || sound->Buffer().empty() || !volume[SoundCategory::MASTER])
+	if(!isInitialized || !sound || !sound->HasAudio() || !volume[SoundCategory::MASTER])
+		return;
+
+	// Skip sounds that are too far away to be heard. OpenAL's distance model
+	// makes the gain fall off with the square root of the attenuation.
+	const Point offset = position - listener;
+	if(sqrt(Attenuation(offset)) * volume[SoundCategory::MASTER] < MIN_GAIN)
+	{
+		++droppedSounds;
 		return;
+	}
 
 	// Place sounds from the main thread directly into the queue. They are from
 	// the UI, and the Engine may not be running right now to call Update().
 	if(this_thread::get_id() == mainThreadID)
-		soundQueue[sound].Add(position - listener, category);
+		soundQueue[sound].Add(offset, category);
 	else
 	{
 		unique_lock<mutex> lock(audioMutex);
-		deferred[sound].Add(position - listener, category);
+		deferred[sound].Add(offset, category);
 	}
 }
 
@@ -297,7 +449,9 @@ void Audio::PlayMusic(const string &name)
 		Fade *fade = new Fade();
 		fade->AddSource(Music::CreateSupplier(name, true));
 		musicPlayer = shared_ptr<AudioPlayer>(new MusicPlayer(unique_ptr<AudioSupplier>{fade}));
-		musicPlayer->Init();
+		musicPlayer->SetPriority(CategoryPriority(SoundCategory::MUSIC));
+		if(MakeRoom(musicPlayer->Priority()))
+			musicPlayer->Init();
 		musicPlayer->SetVolume(Volume(SoundCategory::MUSIC));
 		musicPlayer->Play();
 		players.emplace_back(musicPlayer);
@@ -306,6 +460,17 @@ void Audio::PlayMusic(const string &name)
 
 
 
+// Start decoding the given music, because it is likely to be played soon.
+void Audio::PrefetchMusic(const string &name)
+{
+	if(!isInitialized || name.empty() || name == currentTrack)
+		return;
+
+	Music::Prefetch(name, true);
+}
+
+
+
 // Pause all active playback streams. Doesn't cause new streams to be paused, and doesn't pause the music source.
 void Audio::Pause()
 {
@@ -331,6 +496,9 @@ void Audio::Step(bool isFastForward)
 	if(!isInitialized)
 		return;
 
+	Profiler::Scope profilerScope("Audio::Step");
+	const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
 	for(const auto &[category, expected] : volume)
 		if(cachedVolume[category] != expected)
 		{
@@ -363,6 +531,10 @@ void Audio::Step(bool isFastForward)
 	}
 	pauseChangeCount = 0;
 
+	// Hold back the changes to the players' positions and state, so that OpenAL
+	// applies them all at once at the end of this step.
+	alcSuspendContext(context);
+
 	// For each sound that is looping, see if it is going to continue. For other
 	// sounds, check if they are done playing.
 	for(auto it = loopingPlayers.begin(); it != loopingPlayers.end();)
@@ -372,6 +544,7 @@ void Audio::Step(bool isFastForward)
 		if(queueIt != soundQueue.end())
 		{
 			Move(*player, queueIt->second);
+			player->SetPriority(Priority(queueIt->second));
 			soundQueue.erase(queueIt);
 			++it;
 		}
@@ -387,14 +560,42 @@ void Audio::Step(bool isFastForward)
 	{
 		player->Supplier()->Set3x(isFastForward);
 		player->Update();
+		player->SetPriority(player->Priority() * PRIORITY_DECAY);
 	}
 
 	erase_if(players, [](const auto &player){ return player->IsFinished(); });
+	for(auto it = instances.begin(); it != instances.end(); )
+	{
+		erase_if(it->second, [](const auto &player){ return player->IsFinished(); });
+		if(it->second.empty())
+			it = instances.erase(it);
+		else
+			++it;
+	}
 
 	// Now, what is left in the queue is sounds that want to play, and that do
-	// not correspond to an existing source.
+	// not correspond to an existing source. The most important ones get the
+	// free sources first, and then take them from less important sounds.
+	newSounds.clear();
 	for(const auto &[sound, entry] : soundQueue)
+		newSounds.emplace_back(Priority(entry), sound);
+	sort(newSounds.begin(), newSounds.end(), [](const auto &a, const auto &b){ return a.first > b.first; });
+	for(auto it = newSounds.begin(); it != newSounds.end(); ++it)
 	{
+		const auto &[priority, sound] = *it;
+		vector<shared_ptr<AudioPlayer>> *copies = sound->IsLooping() ? nullptr : &instances[sound];
+		if(copies && !MakeInstanceRoom(*copies, priority))
+		{
+			++droppedSounds;
+			continue;
+		}
+		if(!MakeRoom(priority))
+		{
+			droppedSounds += newSounds.end() - it;
+			break;
+		}
+
+		const QueueEntry &entry = soundQueue[sound];
 		unique_ptr<AudioSupplier> supplier = sound->CreateSupplier();
 		supplier->Set3x(isFastForward);
 		shared_ptr<AudioPlayer> player;
@@ -408,17 +609,67 @@ void Audio::Step(bool isFastForward)
 		else
 			player = make_shared<AudioPlayer>(entry.category, std::move(supplier));
 
+		player->SetPriority(priority);
 		player->Init();
 		player->SetVolume(Volume(entry.category));
 		Move(*player, entry);
 		player->Play();
 
 		players.emplace_back(player);
+		if(copies)
+			copies->emplace_back(std::move(player));
 	}
 	soundQueue.clear();
 
 	if(musicPlayer && musicPlayer->IsFinished())
 		musicPlayer.reset();
+
+	alcProcessContext(context);
+
+	++steps;
+	stepTime += chrono::steady_clock::now() - start;
+	if(Profiler::IsEnabled())
+	{
+		Profiler::AddCounter("Audio players", players.size());
+		Profiler::AddCounter("Audio sources in use", AudioPlayer::ReservedSources() - AudioPlayer::AvailableSources());
+		Profiler::AddCounter("Audio sounds dropped", droppedSounds);
+		Profiler::AddCounter("Audio sounds stolen", stolenSounds);
+		Profiler::AddCounter("Audio underruns", AsyncAudioSupplier::Underruns());
+	}
+}
+
+
+
+Audio::Stats Audio::GetStats()
+{
+	Stats stats;
+	stats.players = players.size();
+	stats.sources = AudioPlayer::ReservedSources();
+	stats.sourcesInUse = stats.sources - AudioPlayer::AvailableSources();
+	stats.dropped = droppedSounds;
+	stats.stolen = stolenSounds;
+	stats.underruns = AsyncAudioSupplier::Underruns() - underrunsAtReset;
+
+	const double chunks = AsyncAudioSupplier::DecodedChunks() - decodedChunksAtReset;
+	if(chunks > 0.)
+		stats.decodeTimePerChunk = chrono::duration_cast<chrono::nanoseconds>(
+			(AsyncAudioSupplier::DecodeTime() - decodeTimeAtReset) / chunks);
+	if(steps)
+		stats.stepTime = chrono::duration_cast<chrono::nanoseconds>(stepTime) / steps;
+	return stats;
+}
+
+
+
+void Audio::ResetStats()
+{
+	droppedSounds = 0;
+	stolenSounds = 0;
+	steps = 0;
+	stepTime = {};
+	underrunsAtReset = AsyncAudioSupplier::Underruns();
+	decodeTimeAtReset = AsyncAudioSupplier::DecodeTime();
+	decodedChunksAtReset = AsyncAudioSupplier::DecodedChunks();
 }
 
 
@@ -426,21 +677,17 @@ void Audio::Step(bool isFastForward)
 // Shut down the audio system (because we're about to quit).
 void Audio::Quit()
 {
-	// First, check if sounds are still being loaded in a separate thread, and
-	// if so interrupt that thread and wait for it to quit.
-	unique_lock<mutex> lock(audioMutex);
-	if(!loadQueue.empty())
-		loadQueue.clear();
-	if(loadThread.joinable())
-	{
-		lock.unlock();
-		loadThread.join();
-		lock.lock();
-	}
+	// First, check if sounds are still being loaded in the background, and if
+	// so skip the ones that have not started yet and wait for the rest.
+	stopLoading = true;
+	for(const shared_future<void> &task : loadTasks)
+		task.wait();
+	loadTasks.clear();
 
 	// Now, stop and delete any OpenAL sources that are playing.
 	players.clear();
 	loopingPlayers.clear();
+	instances.clear();
 	musicPlayer.reset();
 
 	// Free the memory buffers for all the sound resources.
@@ -464,12 +711,8 @@ namespace {
 	// The preserved category is the category of the last source.
 	void QueueEntry::Add(Point position, SoundCategory category)
 	{
-		// A distance of 500 counts as 1 OpenAL unit of distance.
-		position *= .002;
-		// To avoid having sources at a distance of 0 be infinitely loud, have
-		// the minimum distance be 1 unit away.
-		double d = 1. / (1. + position.Dot(position));
-		sum += d * position;
+		double d = Attenuation(position);
+		sum += d * .002 * position;
 		weight += d;
 		this->category = category;
 	}
@@ -482,39 +725,14 @@ namespace {
 		category = other.category;
 	}
 
-	// Thread entry point for loading sounds.
-	void Load()
-	{
-		string name;
-		filesystem::path path;
-		Sound *sound;
-		while(true)
-		{
-			{
-				unique_lock<mutex> lock(audioMutex);
-				// If this is not the first time through, remove the previous item
-				// in the queue. This is a signal that it has been loaded, so we
-				// must not remove it until after loading the file.
-				if(!path.empty() && !loadQueue.empty())
-					loadQueue.erase(loadQueue.begin());
-				if(loadQueue.empty())
-					return;
-				name = loadQueue.begin()->first;
-				path = loadQueue.begin()->second;
-
-				// @3x sounds should be merged with their regular variant here.
-				if(name.ends_with("@3x"))
-					name.resize(name.size() - 3);
-
-				// Since we need to unlock the mutex below, create the map entry to
-				// avoid a race condition when accessing sounds' size.
-				sound = &sounds[name];
-			}
 
-			// Unlock the mutex for the time-intensive part of the loop.
-			if(!sound->Load(path, name))
-				Logger::Log("Unable to load sound \"" + name + "\" from path: " + path.string(),
-					Logger::Level::WARNING);
-		}
+
+	double Attenuation(Point offset)
+	{
+		// A distance of 500 counts as 1 OpenAL unit of distance.
+		offset *= .002;
+		// To avoid having sources at a distance of 0 be infinitely loud, have
+		// the minimum distance be 1 unit away.
+		return 1. / (1. + offset.Dot(offset));
 	}
 }
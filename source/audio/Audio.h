@@ -17,12 +17,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "SoundCategory.h"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <string>
 #include <vector>
 
 class Point;
 class Sound;
+class TaskQueue;
 
 
 
@@ -35,9 +39,30 @@ class Sound;
 // their source stops calling the "play" function for them.
 class Audio {
 public:
-	// Begin loading sounds (in a separate thread).
-	static void Init(const std::vector<std::filesystem::path> &sources);
-	static void LoadSounds(const std::vector<std::filesystem::path> &sources);
+	// What the audio system has been doing since the last call to ResetStats().
+	class Stats {
+	public:
+		// The current number of players, and how many of the reserved sources they use.
+		size_t players = 0;
+		size_t sourcesInUse = 0;
+		size_t sources = 0;
+		// Sounds that were not played because they were too quiet or there was no
+		// room for them, and sounds that were interrupted to make room for others.
+		int64_t dropped = 0;
+		int64_t stolen = 0;
+		// How many times a streamed sound ran out of decoded samples.
+		int64_t underruns = 0;
+		// The average time spent decoding each chunk of streamed audio, and in each step.
+		std::chrono::nanoseconds decodeTimePerChunk{};
+		std::chrono::nanoseconds stepTime{};
+	};
+
+
+public:
+	// Open the audio device. Sounds can be loaded before or after this.
+	static void Init();
+	// Begin loading the sounds in the given sources, on the queue's threads.
+	static void LoadSounds(TaskQueue &queue, const std::vector<std::filesystem::path> &sources);
 	static void CheckReferences(bool parseOnly = false);
 
 	// Report the progress of loading sounds.
@@ -66,6 +91,8 @@ public:
 
 	// Play the given music. An empty string means to play nothing.
 	static void PlayMusic(const std::string &name);
+	// Start decoding the given music, because it is likely to be played soon.
+	static void PrefetchMusic(const std::string &name);
 
 	// Pause all active sound sources. Doesn't cause new streams to be paused, and doesn't pause the music source.
 	static void Pause();
@@ -78,6 +105,9 @@ public:
 	/// If the game is in fast forward mode, the fast version of sounds is played.
 	static void Step(bool isFastForward);
 
+	static Stats GetStats();
+	static void ResetStats();
+
 	// Shut down the audio system (because we're about to quit).
 	static void Quit();
 };
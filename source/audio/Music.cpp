@@ -20,8 +20,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../text/Format.h"
 #include "supplier/Mp3Supplier.h"
 
-
+#include <algorithm>
+#include <list>
 #include <map>
+#include <mutex>
+#include <tuple>
 
 using namespace std;
 
@@ -31,6 +34,37 @@ namespace {
 	};
 
 	map<string, pair<filesystem::path, MusicFileType>> paths;
+
+	// The number of prefetched tracks to keep. Each one holds a decoding thread
+	// that is waiting for its buffer to be read.
+	constexpr size_t MAX_PREFETCHED = 3;
+	// Suppliers that were created ahead of time, with the most recent first.
+	list<tuple<string, bool, unique_ptr<AudioSupplier>>> prefetched;
+	mutex prefetchMutex;
+
+	unique_ptr<AudioSupplier> Open(const string &name, bool looping)
+	{
+		auto it = paths.find(name);
+		if(it != paths.end())
+			switch(it->second.second)
+			{
+				case MusicFileType::MP3:
+					return unique_ptr<AudioSupplier>{
+						new Mp3Supplier{Files::Open(it->second.first), looping}};
+				case MusicFileType::FLAC:
+					return unique_ptr<AudioSupplier>{
+						new FlacSupplier{Files::Open(it->second.first), looping}};
+			}
+		return {};
+	}
+
+	auto FindPrefetched(const string &name, bool looping)
+	{
+		return find_if(prefetched.begin(), prefetched.end(), [&name, looping](const auto &it)
+			{
+				return get<0>(it) == name && get<1>(it) == looping;
+			});
+	}
 }
 
 
@@ -59,15 +93,42 @@ void Music::Init(const vector<filesystem::path> &sources)
 
 unique_ptr<AudioSupplier> Music::CreateSupplier(const string &name, bool looping)
 {
-	if(paths.contains(name))
-		switch(paths[name].second)
+	{
+		lock_guard<mutex> lock(prefetchMutex);
+		auto it = FindPrefetched(name, looping);
+		if(it != prefetched.end())
 		{
-			case MusicFileType::MP3:
-				return unique_ptr<AudioSupplier>{
-					new Mp3Supplier{Files::Open(paths[name].first), looping}};
-			case MusicFileType::FLAC:
-				return unique_ptr<AudioSupplier>{
-					new FlacSupplier{Files::Open(paths[name].first), looping}};
+			unique_ptr<AudioSupplier> supplier = std::move(get<2>(*it));
+			prefetched.erase(it);
+			return supplier;
 		}
-	return {};
+	}
+	return Open(name, looping);
+}
+
+
+
+// Start decoding the given music ahead of time, so that when a supplier for
+// it is created, the start of it is ready to play right away. Only the few
+// most recently prefetched tracks are kept.
+void Music::Prefetch(const string &name, bool looping)
+{
+	if(!paths.contains(name))
+		return;
+
+	unique_ptr<AudioSupplier> dropped;
+	lock_guard<mutex> lock(prefetchMutex);
+	auto it = FindPrefetched(name, looping);
+	if(it != prefetched.end())
+	{
+		prefetched.splice(prefetched.begin(), prefetched, it);
+		return;
+	}
+	if(prefetched.size() >= MAX_PREFETCHED)
+	{
+		// Stopping the decoding thread can wait for it, so do that after unlocking.
+		dropped = std::move(get<2>(prefetched.back()));
+		prefetched.pop_back();
+	}
+	prefetched.emplace_front(name, looping, Open(name, looping));
 }
@@ -30,6 +30,10 @@ public:
 	static void Init(const std::vector<std::filesystem::path> &sources);
 
 	static std::unique_ptr<AudioSupplier> CreateSupplier(const std::string &name, bool looping);
+	// Start decoding the given music ahead of time, so that when a supplier for
+	// it is created, the start of it is ready to play right away. Only the few
+	// most recently prefetched tracks are kept.
+	static void Prefetch(const std::string &name, bool looping);
 
 
 public:
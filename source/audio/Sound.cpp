@@ -17,13 +17,27 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Files.h"
 #include "../Logger.h"
+#include "supplier/WavStreamSupplier.h"
 #include "supplier/WavSupplier.h"
 
-#include <cstdint>
+#include <list>
+#include <mutex>
+#include <utility>
 
 using namespace std;
 
 namespace {
+	using Samples = shared_ptr<const vector<AudioSupplier::sample_t>>;
+
+	// The samples of streamed sounds that have been played through, from most
+	// to least recently played, and their total size in bytes.
+	mutex cacheMutex;
+	list<pair<const Sound *, Samples>> cache;
+	size_t cacheSize = 0;
+
+	// Get the cached samples of the given sound, if there are any, and mark them as used.
+	Samples FindCached(const Sound &sound);
+
 	// Read a WAV header, and return the size of the data, in bytes. If the file
 	// is an unsupported format (anything but little-endian 16-bit PCM at 44100 HZ),
 	// this will return 0.
@@ -55,6 +69,15 @@ bool Sound::Load(const filesystem::path &path, const string &name)
 		return false;
 	}
 
+	// Long sounds are left in the file, unless this is a 3x variant, which is
+	// not played for streamed sounds.
+	if(2 * static_cast<size_t>(bytes) > STREAM_THRESHOLD)
+	{
+		if(!isFast)
+			stream = Stream{path, static_cast<size_t>(in->tellg()), bytes};
+		return true;
+	}
+
 	// Read 16-bit mono from the file.
 	vector<char> data(bytes);
 	in->read(data.data(), bytes);
@@ -71,6 +94,13 @@ bool Sound::Load(const filesystem::path &path, const string &name)
 
 
 
+void Sound::SetLoaded()
+{
+	isLoaded.store(true, memory_order_release);
+}
+
+
+
 const string &Sound::Name() const
 {
 	return name;
@@ -99,14 +129,81 @@ bool Sound::IsLooping() const
 
 
 
+bool Sound::HasAudio() const
+{
+	return isLoaded.load(memory_order_acquire) && (!Buffer().empty() || IsStreamed());
+}
+
+
+
+bool Sound::IsStreamed() const
+{
+	return stream.bytes;
+}
+
+
+
+const Sound::Stream &Sound::StreamSource() const
+{
+	return stream;
+}
+
+
+
 unique_ptr<AudioSupplier> Sound::CreateSupplier() const
 {
-	return unique_ptr<AudioSupplier>{new WavSupplier{*this, false, IsLooping()}};
+	if(!IsStreamed())
+		return unique_ptr<AudioSupplier>{new WavSupplier{*this, false, IsLooping()}};
+
+	Samples cached = FindCached(*this);
+	if(cached)
+		return unique_ptr<AudioSupplier>{new WavSupplier{std::move(cached), IsLooping()}};
+	return unique_ptr<AudioSupplier>{new WavStreamSupplier{*this, IsLooping()}};
+}
+
+
+
+void Sound::Cache(const Sound &sound, vector<AudioSupplier::sample_t> &&samples)
+{
+	const size_t size = samples.size() * sizeof(AudioSupplier::sample_t);
+	if(samples.empty() || size > CACHE_BUDGET)
+		return;
+
+	auto cached = make_shared<const vector<AudioSupplier::sample_t>>(std::move(samples));
+	lock_guard<mutex> lock(cacheMutex);
+	// Another copy of this sound may have finished first.
+	for(const auto &entry : cache)
+		if(entry.first == &sound)
+			return;
+
+	// Make room by dropping the least recently played sounds. Any that are
+	// still playing keep their samples until they finish.
+	while(cacheSize + size > CACHE_BUDGET)
+	{
+		cacheSize -= cache.back().second->size() * sizeof(AudioSupplier::sample_t);
+		cache.pop_back();
+	}
+	cache.emplace_front(&sound, std::move(cached));
+	cacheSize += size;
 }
 
 
 
 namespace {
+	Samples FindCached(const Sound &sound)
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		for(auto it = cache.begin(); it != cache.end(); ++it)
+			if(it->first == &sound)
+			{
+				cache.splice(cache.begin(), cache, it);
+				return it->second;
+			}
+		return nullptr;
+	}
+
+
+
 	// Read a WAV header, and return the size of the data, in bytes. If the file
 	// is an unsupported format (anything but little-endian 16-bit PCM at 44100 HZ),
 	// this will return 0.
@@ -17,30 +17,69 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "supplier/AudioSupplier.h"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <vector>
 
 
 
 // This is a sound that can be played. The sound's file name will determine
 // whether it is looping (ends in '~') or not.
+//
+// Short sounds are decoded into memory when they are loaded. Sounds that would
+// take up more than STREAM_THRESHOLD bytes, such as long ambient loops or voice
+// lines, are instead read from their file each time they play. Once a streamed
+// sound has been played all the way through, its samples are kept in a shared
+// cache of up to CACHE_BUDGET bytes, from which the least recently played sounds
+// are dropped first.
 class Sound {
+public:
+	static constexpr size_t STREAM_THRESHOLD = 4 << 20;
+	static constexpr size_t CACHE_BUDGET = 32 << 20;
+
+	// Where the 16-bit mono samples of a streamed sound are in its file.
+	class Stream {
+	public:
+		std::filesystem::path path;
+		size_t offset = 0;
+		uint32_t bytes = 0;
+	};
+
+
 public:
 	bool Load(const std::filesystem::path &path, const std::string &name);
+	// Allow the sound to be played, once all of its files have been loaded.
+	// Sounds may still be loading in the background when the game starts.
+	void SetLoaded();
 
 	const std::string &Name() const;
 
 	const std::vector<AudioSupplier::sample_t> &Buffer() const;
 	const std::vector<AudioSupplier::sample_t> &Buffer3x() const;
 	bool IsLooping() const;
+	// Check if there is anything to play, whether in memory or in a file. This is
+	// false until the sound has finished loading.
+	bool HasAudio() const;
+	bool IsStreamed() const;
+	const Stream &StreamSource() const;
 
 	std::unique_ptr<AudioSupplier> CreateSupplier() const;
 
+	// Keep the decoded samples of a streamed sound for the next time it plays,
+	// if they fit in the cache's budget. This is safe to call from any thread.
+	static void Cache(const Sound &sound, std::vector<AudioSupplier::sample_t> &&samples);
+
 
 private:
 	std::string name;
 	std::vector<AudioSupplier::sample_t> buffer;
 	std::vector<AudioSupplier::sample_t> buffer3x;
+	// A streamed sound only plays its regular variant, which is read from this file.
+	Stream stream;
 	bool isLooped = false;
+	std::atomic<bool> isLoaded = false;
 };
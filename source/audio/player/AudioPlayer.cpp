@@ -25,6 +25,40 @@ using namespace std;
 namespace {
 	/// The currently unclaimed OpenAL sources for reuse.
 	vector<ALuint> availableSources;
+	/// How many sources have been created.
+	size_t sourceCount = 0;
+}
+
+
+
+void AudioPlayer::ReserveSources(size_t count)
+{
+	availableSources.reserve(count);
+	alGetError();
+	while(sourceCount < count)
+	{
+		ALuint source = 0;
+		alGenSources(1, &source);
+		// If the device has fewer sources than requested, make do with the ones it has.
+		if(alGetError() != AL_NO_ERROR || !source)
+			break;
+		availableSources.emplace_back(source);
+		++sourceCount;
+	}
+}
+
+
+
+size_t AudioPlayer::AvailableSources()
+{
+	return availableSources.size();
+}
+
+
+
+size_t AudioPlayer::ReservedSources()
+{
+	return sourceCount;
 }
 
 
@@ -102,6 +136,27 @@ bool AudioPlayer::IsFinished() const
 
 
 
+bool AudioPlayer::HasSource() const
+{
+	return alSource;
+}
+
+
+
+double AudioPlayer::Priority() const
+{
+	return priority;
+}
+
+
+
+void AudioPlayer::SetPriority(double priority)
+{
+	this->priority = priority;
+}
+
+
+
 double AudioPlayer::Volume() const
 {
 	if(!alSource)
@@ -194,6 +249,26 @@ void AudioPlayer::Stop(bool stop)
 
 
 
+void AudioPlayer::Interrupt()
+{
+	done = true;
+	if(!alSource)
+		return;
+
+	// Once the source is stopped, every queued buffer counts as processed.
+	alSourceStop(alSource);
+	ALint buffersQueued = 0;
+	alGetSourcei(alSource, AL_BUFFERS_QUEUED, &buffersQueued);
+	vector<ALuint> buffers(buffersQueued);
+	alSourceUnqueueBuffers(alSource, buffers.size(), buffers.data());
+	for(ALuint buffer : buffers)
+		AudioSupplier::DestroyBuffer(buffer);
+
+	ReleaseSource();
+}
+
+
+
 AudioSupplier *AudioPlayer::Supplier()
 {
 	return audioSupplier.get();
@@ -206,17 +281,14 @@ bool AudioPlayer::ClaimSource()
 	if(alSource)
 		return true;
 
-	if(!availableSources.empty())
-	{
-		alSource = availableSources.back();
-		availableSources.pop_back();
-		ConfigureSource();
-		return true;
-	}
-	alGenSources(1, &alSource);
-	ConfigureSource();
+	// All the reserved sources are in use.
+	if(availableSources.empty())
+		return false;
 
-	return alSource;
+	alSource = availableSources.back();
+	availableSources.pop_back();
+	ConfigureSource();
+	return true;
 }
 
 
@@ -28,6 +28,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 /// This class contains a base implementation suitable for playback of sound effects;
 /// it is meant to be inherited by specialized classes for other purposes.
 class AudioPlayer {
+public:
+	/// Creates up to the given number of OpenAL sources, which are then shared by all the players.
+	/// Players only ever use these sources, so a player may fail to get one until another is finished.
+	static void ReserveSources(size_t count);
+	/// The number of reserved sources that no player is using.
+	static size_t AvailableSources();
+	/// The number of sources that were reserved, whether or not they are in use.
+	static size_t ReservedSources();
+
+
 public:
 	/// Creates a new audio player with the given audio.
 	/// Please note that the audio isn't loaded from the supplier until the Play() call.
@@ -40,6 +50,14 @@ public:
 	/// Checks whether the player is finished. Finished players will not be able to play audio again,
 	/// and should not be stored.
 	bool IsFinished() const;
+	/// Whether the player has a source to play on. If there was none available when Init() was called,
+	/// it can be called again once another player has given up its source.
+	bool HasSource() const;
+
+	/// How important this player's sound is, compared to other sounds. When there are no sources
+	/// left, the least important sound is interrupted to make room for a more important one.
+	double Priority() const;
+	void SetPriority(double priority);
 
 	/// The volume of the playback, or 0 if the player is not initialized.
 	double Volume() const;
@@ -60,6 +78,8 @@ public:
 	/// Instructs the player to stop. No new buffers will be queued, but queued buffers will finish playback.
 	/// Until the player is marked finished, calling this function with 'false' can undo its effect.
 	void Stop(bool stop = true);
+	/// Stops playback immediately and releases the source, marking the player as finished.
+	void Interrupt();
 
 	/// The supplier of the player. Never null.
 	AudioSupplier *Supplier();
@@ -87,6 +107,8 @@ protected:
 	/// The data supplier; never null.
 	std::unique_ptr<AudioSupplier> audioSupplier;
 
+	double priority = 0.;
+
 	/// Whether the player has terminated.
 	bool done = false;
 	/// Whether the player should stop queueing up more buffers (and terminate, once they all run out).
@@ -15,16 +15,22 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "AsyncAudioSupplier.h"
 
-#include <cmath>
+#include <algorithm>
 #include <thread>
 #include <utility>
 
 using namespace std;
 
+namespace {
+	atomic<int64_t> underruns = 0;
+	atomic<int64_t> decodeNanoseconds = 0;
+	atomic<int64_t> decodedSamples = 0;
+}
+
 
 
 AsyncAudioSupplier::AsyncAudioSupplier(shared_ptr<iostream> data, bool looping)
-	: looping(looping), data(std::move(data))
+	: looping(looping), data(std::move(data)), ring(RING_SIZE)
 {
 }
 
@@ -33,20 +39,40 @@ AsyncAudioSupplier::AsyncAudioSupplier(shared_ptr<iostream> data, bool looping)
 AsyncAudioSupplier::~AsyncAudioSupplier()
 {
 	// Tell the decoding thread to stop.
-	{
-		lock_guard<mutex> lock(bufferMutex);
-		done = true;
-	}
-	bufferCondition.notify_all();
+	quit = true;
+	done = true;
+	++readSignal;
+	readSignal.notify_all();
 	if(audioThread.joinable())
 		audioThread.join();
 }
 
 
 
+int64_t AsyncAudioSupplier::Underruns()
+{
+	return underruns;
+}
+
+
+
+chrono::nanoseconds AsyncAudioSupplier::DecodeTime()
+{
+	return chrono::nanoseconds(decodeNanoseconds);
+}
+
+
+
+double AsyncAudioSupplier::DecodedChunks()
+{
+	return decodedSamples / static_cast<double>(OUTPUT_CHUNK);
+}
+
+
+
 size_t AsyncAudioSupplier::MaxChunks() const
 {
-	if(done && buffer.size() < OUTPUT_CHUNK)
+	if(done && Buffered() < OUTPUT_CHUNK)
 		return 0;
 
 	return max(static_cast<size_t>(2), AvailableChunks());
@@ -56,29 +82,37 @@ size_t AsyncAudioSupplier::MaxChunks() const
 
 size_t AsyncAudioSupplier::AvailableChunks() const
 {
-	return buffer.size() / OUTPUT_CHUNK;
+	return Buffered() / OUTPUT_CHUNK;
 }
 
 
-vector<AudioSupplier::sample_t> AsyncAudioSupplier::NextDataChunk()
+
+void AsyncAudioSupplier::NextDataChunk(vector<sample_t> &samples)
 {
-	if(AvailableChunks())
+	samples.resize(OUTPUT_CHUNK);
+	if(!AvailableChunks())
 	{
-		lock_guard<mutex> lock(bufferMutex);
-
-		vector<sample_t> temp{buffer.begin(), buffer.begin() + OUTPUT_CHUNK};
-		buffer.erase(buffer.begin(), buffer.begin() + OUTPUT_CHUNK);
-		bufferCondition.notify_all();
-		return temp;
+		// The decoding thread has fallen behind, so there will be a gap in the sound.
+		if(!done)
+			++underruns;
+		fill(samples.begin(), samples.end(), 0);
+		return;
 	}
-	else
-		return vector<sample_t>(OUTPUT_CHUNK);
+
+	// Chunks are always read whole, and the ring holds a whole number of them,
+	// so a chunk never wraps around the end of the ring.
+	const size_t start = samplesRead.load(memory_order_relaxed) % RING_SIZE;
+	copy_n(ring.begin() + start, OUTPUT_CHUNK, samples.begin());
+	samplesRead.fetch_add(OUTPUT_CHUNK, memory_order_release);
+	++readSignal;
+	readSignal.notify_one();
 }
 
 
 
 void AsyncAudioSupplier::StartAudioThread()
 {
+	decodeStart = chrono::steady_clock::now();
 	audioThread = thread(&AsyncAudioSupplier::Decode, this);
 }
 
@@ -86,18 +120,29 @@ void AsyncAudioSupplier::StartAudioThread()
 
 void AsyncAudioSupplier::AwaitBufferSpace()
 {
-	unique_lock<mutex> lock(bufferMutex);
-	while(!done && buffer.size() > (BUFFER_CHUNK_SIZE - 1) * OUTPUT_CHUNK)
-		bufferCondition.wait(lock);
+	while(!done)
+	{
+		const uint32_t lastRead = readSignal.load();
+		if(Buffered() <= (BUFFER_CHUNK_SIZE - 1) * OUTPUT_CHUNK)
+			break;
+		AwaitRead(lastRead);
+	}
 }
 
 
 
 void AsyncAudioSupplier::AddBufferData(vector<sample_t> &samples)
 {
-	lock_guard<mutex> lock(bufferMutex);
-	buffer.insert(buffer.end(), samples.begin(), samples.end());
+	if(!samples.empty())
+	{
+		const auto decodeTime = chrono::steady_clock::now() - decodeStart - waited;
+		decodeNanoseconds += chrono::duration_cast<chrono::nanoseconds>(decodeTime).count();
+		decodedSamples += samples.size();
+	}
+	Write(samples.data(), samples.size());
 	samples.clear();
+	decodeStart = chrono::steady_clock::now();
+	waited = {};
 	if(done)
 		PadBuffer();
 }
@@ -106,11 +151,55 @@ void AsyncAudioSupplier::AddBufferData(vector<sample_t> &samples)
 
 void AsyncAudioSupplier::PadBuffer()
 {
-	buffer.resize(OUTPUT_CHUNK * ceil(static_cast<double>(buffer.size()) / static_cast<double>(OUTPUT_CHUNK)));
+	static const vector<sample_t> SILENCE(OUTPUT_CHUNK);
+	const size_t partial = samplesWritten.load(memory_order_relaxed) % OUTPUT_CHUNK;
+	if(partial)
+		Write(SILENCE.data(), OUTPUT_CHUNK - partial);
 }
 
 
 
+void AsyncAudioSupplier::Write(const sample_t *samples, size_t count)
+{
+	while(count && !quit)
+	{
+		const uint32_t lastRead = readSignal.load();
+		const size_t space = RING_SIZE - Buffered();
+		if(!space)
+		{
+			AwaitRead(lastRead);
+			continue;
+		}
+
+		// Copy as much as fits, up to the end of the ring.
+		const size_t start = samplesWritten.load(memory_order_relaxed) % RING_SIZE;
+		const size_t length = min({count, space, RING_SIZE - start});
+		copy_n(samples, length, ring.begin() + start);
+		samplesWritten.fetch_add(length, memory_order_release);
+		samples += length;
+		count -= length;
+	}
+}
+
+
+
+size_t AsyncAudioSupplier::Buffered() const
+{
+	return samplesWritten.load(memory_order_acquire) - samplesRead.load(memory_order_acquire);
+}
+
+
+
+void AsyncAudioSupplier::AwaitRead(uint32_t lastRead)
+{
+	if(quit)
+		return;
+	const auto start = chrono::steady_clock::now();
+	readSignal.wait(lastRead);
+	waited += chrono::steady_clock::now() - start;
+}
+
+
 
 size_t AsyncAudioSupplier::ReadInput(char *output, size_t bytesToRead)
 {
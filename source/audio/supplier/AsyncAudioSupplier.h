@@ -17,7 +17,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "AudioSupplier.h"
 
-#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <thread>
@@ -25,15 +27,23 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 
 /// Generic implementation for async suppliers that stream data decoded on another thread.
+/// The decoded samples are passed from the decoding thread to the player through a ring buffer
+/// that is allocated once, so streaming needs no locks and no memory allocation.
 class AsyncAudioSupplier : public AudioSupplier {
 public:
 	explicit AsyncAudioSupplier(std::shared_ptr<std::iostream> data, bool looping = false);
 	~AsyncAudioSupplier() override;
 
+	/// How many times, across all the async suppliers, a player needed a chunk that was not decoded yet.
+	static int64_t Underruns();
+	/// The total time that all the decoding threads spent decoding, and how many output chunks they produced.
+	static std::chrono::nanoseconds DecodeTime();
+	static double DecodedChunks();
+
 	// Inherited pure virtual methods
 	size_t MaxChunks() const override;
 	size_t AvailableChunks() const override;
-	std::vector<sample_t> NextDataChunk() override;
+	void NextDataChunk(std::vector<sample_t> &samples) override;
 
 
 protected:
@@ -41,8 +51,10 @@ protected:
 	/// This is the entry point for the decoding thread.
 	virtual void Decode() = 0;
 
+	/// Waits until the output buffer is running low, so that there is room for more data.
 	void AwaitBufferSpace();
-	/// Adds data to the output buffer, then clears the given sample vector.
+	/// Adds data to the output buffer, then clears the given sample vector. This waits for the
+	/// player to make room in the buffer if it is full.
 	/// If the supplier is done, pads the output buffer to a full chunk with silence.
 	void AddBufferData(std::vector<sample_t> &samples);
 	/// Pads the buffer to a full output chunk with silence.
@@ -55,20 +67,40 @@ protected:
 
 
 protected:
-	bool done = false;
+	std::atomic<bool> done = false;
 	const bool looping;
 
 	std::shared_ptr<std::iostream> data;
 
 
 private:
-	/// The number of chunks to queue up in the buffer.
+	/// Copies samples into the output buffer, waiting for room if necessary.
+	void Write(const sample_t *samples, size_t count);
+	/// The number of samples in the output buffer that have not been read yet.
+	size_t Buffered() const;
+	/// Waits until the player reads from the buffer, or the supplier is destroyed.
+	void AwaitRead(uint32_t lastRead);
+
+
+private:
+	/// The number of chunks to queue up in the buffer before decoding more.
 	static constexpr size_t BUFFER_CHUNK_SIZE = 3;
-	/// The decoded data.
-	std::vector<sample_t> buffer;
+	/// The number of chunks the buffer can hold.
+	static constexpr size_t RING_CHUNKS = 8;
+	static constexpr size_t RING_SIZE = RING_CHUNKS * OUTPUT_CHUNK;
+
+	/// The decoded data. Only the decoding thread writes samples, and only the player reads them.
+	std::vector<sample_t> ring;
+	/// The total number of samples ever written and read. Their difference is the amount buffered.
+	std::atomic<size_t> samplesWritten = 0;
+	std::atomic<size_t> samplesRead = 0;
+	/// Changed every time a chunk is read, and when the supplier is destroyed, to wake up the decoding thread.
+	std::atomic<uint32_t> readSignal = 0;
+	std::atomic<bool> quit = false;
+	/// When the decoding thread last added data to the buffer, and how long it
+	/// has waited for the player since then. The rest of that time was spent decoding.
+	std::chrono::steady_clock::time_point decodeStart;
+	std::chrono::steady_clock::duration waited{};
 
-	// Sync management
 	std::thread audioThread;
-	std::mutex bufferMutex;
-	std::condition_variable bufferCondition;
 };
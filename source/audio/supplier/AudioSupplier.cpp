@@ -17,10 +17,21 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	/// Buffers that are no longer queued on any source, kept for reuse.
+	vector<ALuint> availableBuffers;
+}
+
 
 
 ALuint AudioSupplier::CreateBuffer()
 {
+	if(!availableBuffers.empty())
+	{
+		ALuint buffer = availableBuffers.back();
+		availableBuffers.pop_back();
+		return buffer;
+	}
 	ALuint buffer;
 	alGenBuffers(1, &buffer);
 	return buffer;
@@ -30,7 +41,7 @@ ALuint AudioSupplier::CreateBuffer()
 
 void AudioSupplier::DestroyBuffer(ALuint buffer)
 {
-	alDeleteBuffers(1, &buffer);
+	availableBuffers.emplace_back(buffer);
 }
 
 
@@ -53,17 +64,17 @@ void AudioSupplier::NextChunk(ALuint buffer, bool spatial)
 {
 	if(AvailableChunks())
 	{
-		vector<sample_t> samples = NextDataChunk();
+		NextDataChunk(chunk);
 		// Spatial audio is mono, but we get stereo data by default.
 		// (This difference is due to a limitation in OpenAL.)
 		if(spatial)
 		{
-			for(size_t i = 0; i < samples.size() / 2; ++i)
-				samples[i] = (static_cast<int>(samples[2 * i]) + static_cast<int>(samples[2 * i + 1])) / 2;
-			samples.resize(samples.size() / 2);
+			for(size_t i = 0; i < chunk.size() / 2; ++i)
+				chunk[i] = (static_cast<int>(chunk[2 * i]) + static_cast<int>(chunk[2 * i + 1])) / 2;
+			chunk.resize(chunk.size() / 2);
 		}
-		alBufferData(buffer, spatial ? FORMAT_SPATIAL : FORMAT, samples.data(),
-			sizeof(sample_t) * samples.size(), SAMPLE_RATE);
+		alBufferData(buffer, spatial ? FORMAT_SPATIAL : FORMAT, chunk.data(),
+			sizeof(sample_t) * chunk.size(), SAMPLE_RATE);
 	}
 	else
 		SetSilence(buffer, OUTPUT_CHUNK);
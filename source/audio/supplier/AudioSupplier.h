@@ -29,6 +29,8 @@ class AudioSupplier {
 public:
 	using sample_t = int16_t;
 
+	/// Get a buffer to queue on a source. Destroyed buffers are kept and reused,
+	/// since every sound that is played needs a few of them.
 	static ALuint CreateBuffer();
 	static void DestroyBuffer(ALuint buffer);
 
@@ -46,8 +48,9 @@ public:
 	/// The number of chunks currently ready for access via NextChunk().
 	virtual size_t AvailableChunks() const = 0;
 	/// Gets the next, fixed-size chunk of audio samples. If there is no available chunk, a silence chunk is returned.
-	/// This returns the raw samples that would be put into an OpenAL buffer via a NextChunk() call.
-	virtual std::vector<sample_t> NextDataChunk() = 0;
+	/// These are the raw samples that would be put into an OpenAL buffer via a NextChunk() call. They are
+	/// stored in the given vector, so that a caller that reuses it does not need to allocate any memory.
+	virtual void NextDataChunk(std::vector<sample_t> &samples) = 0;
 
 	/// Configures 3x audio playback.
 	virtual void Set3x(bool is3x);
@@ -86,4 +89,9 @@ protected:
 
 	/// The index of the first sample to be processed
 	size_t currentSample = 0;
+
+
+private:
+	/// The samples of the chunk that NextChunk() is filling a buffer with.
+	std::vector<sample_t> chunk;
 };
@@ -37,7 +37,6 @@ FLAC__StreamDecoderWriteStatus FlacSupplier::write_callback(const FLAC__Frame *f
 	const size_t blocksize = frame->header.blocksize;
 
 	AwaitBufferSpace();
-	static vector<sample_t> samples;
 	for(size_t i = 0; i < blocksize; ++i)
 		for(size_t ch = 0; ch < channels; ++ch)
 			samples.push_back(static_cast<sample_t>(buffer[ch][i]));
@@ -52,4 +52,6 @@ private:
 private:
 	/// If the last read reached the end of the file, we may have to loop back by resetting the decoder.
 	bool lastReadWasEof = false;
+	/// The samples of the frame being decoded. This is reused for every frame.
+	std::vector<sample_t> samples;
 };
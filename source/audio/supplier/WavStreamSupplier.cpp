@@ -0,0 +1,88 @@
+/* WavStreamSupplier.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "WavStreamSupplier.h"
+
+#include "../../Files.h"
+#include "../Sound.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+
+
+WavStreamSupplier::WavStreamSupplier(const Sound &sound, bool looping)
+	: AsyncAudioSupplier(Files::Open(sound.StreamSource().path), looping), sound(sound)
+{
+	StartAudioThread();
+}
+
+
+
+void WavStreamSupplier::Decode()
+{
+	const Sound::Stream &source = sound.StreamSource();
+	// Read one output chunk's worth of mono samples at a time.
+	vector<char> input(OUTPUT_CHUNK);
+	vector<sample_t> samples;
+	samples.reserve(OUTPUT_CHUNK);
+	// Collect the whole sound while it is first read, if the cache could hold it.
+	vector<sample_t> decoded;
+	bool isCaching = 2 * static_cast<size_t>(source.bytes) <= Sound::CACHE_BUDGET;
+
+	while(data && !done)
+	{
+		// Each pass starts from the beginning of the samples.
+		data->clear();
+		data->seekg(source.offset);
+		size_t remaining = source.bytes;
+		while(remaining && !done)
+		{
+			AwaitBufferSpace();
+			if(done)
+				break;
+
+			data->read(input.data(), min(remaining, input.size()));
+			const size_t read = data->gcount() & ~static_cast<size_t>(1);
+			// A truncated file ends the sound early.
+			if(!read)
+				break;
+			remaining -= read;
+
+			// Expand the 16-bit mono input into stereo.
+			for(size_t i = 0; i < read; i += sizeof(sample_t))
+			{
+				sample_t sample;
+				memcpy(&sample, input.data() + i, sizeof(sample_t));
+				samples.push_back(sample);
+				samples.push_back(sample);
+			}
+			if(isCaching)
+				decoded.insert(decoded.end(), samples.begin(), samples.end());
+			AddBufferData(samples);
+		}
+		if(isCaching && !remaining)
+			Sound::Cache(sound, std::move(decoded));
+		isCaching = false;
+
+		if(!looping || remaining)
+			break;
+	}
+
+	done = true;
+	PadBuffer();
+}
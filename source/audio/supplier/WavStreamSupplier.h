@@ -0,0 +1,39 @@
+/* WavStreamSupplier.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "AsyncAudioSupplier.h"
+
+class Sound;
+
+
+
+/// Streams a sound that is too long to keep in memory from its waveform file.
+/// After the first time the whole sound has been read, its samples are offered
+/// to the sound's cache, so that later playbacks may not need to read the file.
+class WavStreamSupplier : public AsyncAudioSupplier {
+public:
+	explicit WavStreamSupplier(const Sound &sound, bool looping = false);
+
+
+private:
+	/// This is the entry point for the decoding thread.
+	void Decode() override;
+
+
+private:
+	const Sound &sound;
+};
@@ -19,13 +19,21 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 using namespace std;
 
 
 
 WavSupplier::WavSupplier(const Sound &sound, bool is3x, bool looping)
-	: AudioSupplier(is3x, looping), sound(sound), wasStarted(false)
+	: AudioSupplier(is3x, looping), sound(&sound), wasStarted(false)
+{
+}
+
+
+
+WavSupplier::WavSupplier(shared_ptr<const vector<sample_t>> cached, bool looping)
+	: AudioSupplier(false, looping), cached(std::move(cached)), wasStarted(false)
 {
 }
 
@@ -38,7 +46,7 @@ size_t WavSupplier::MaxChunks() const
 	else if(wasStarted && !currentSample)
 		return 0;
 	else
-		return ceil(((is3x ? sound.Buffer3x() : sound.Buffer()).size() - currentSample) / static_cast<float>(OUTPUT_CHUNK));
+		return ceil((Input().size() - currentSample) / static_cast<float>(OUTPUT_CHUNK));
 }
 
 
@@ -50,12 +58,12 @@ size_t WavSupplier::AvailableChunks() const
 
 
 
-vector<AudioSupplier::sample_t> WavSupplier::NextDataChunk()
+void WavSupplier::NextDataChunk(vector<sample_t> &samples)
 {
-	vector<sample_t> samples(OUTPUT_CHUNK);
+	samples.assign(OUTPUT_CHUNK, 0);
 	// If we are at the beginning of the buffer and it was already played, this is a loop.
 	if(!currentSample && wasStarted && !isLooping)
-		return samples;
+		return;
 
 	size_t currentSampleCount = 0;
 	do {
@@ -65,12 +73,19 @@ vector<AudioSupplier::sample_t> WavSupplier::NextDataChunk()
 			is3x = nextPlaybackIs3x;
 			wasStarted = true;
 		}
-		const vector<sample_t> &input = is3x ? sound.Buffer3x() : sound.Buffer();
+		const vector<sample_t> &input = Input();
 		size_t readChunk = min(input.size() - currentSample, samples.size() - currentSampleCount);
 		std::copy_n(input.begin() + currentSample, readChunk, samples.begin() + currentSampleCount);
 		currentSampleCount += readChunk;
 		currentSample = (currentSample + readChunk) % input.size();
 	} while(currentSampleCount < samples.size() && isLooping);
-	return samples;
 }
 
+
+
+const vector<AudioSupplier::sample_t> &WavSupplier::Input() const
+{
+	if(cached)
+		return *cached;
+	return is3x ? sound->Buffer3x() : sound->Buffer();
+}
@@ -17,6 +17,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "AudioSupplier.h"
 
+#include <memory>
+
 class Sound;
 
 
@@ -25,14 +27,21 @@ class Sound;
 class WavSupplier : public AudioSupplier {
 public:
 	WavSupplier(const Sound &sound, bool is3x, bool looping = false);
+	/// Play samples that are not owned by a sound, such as the cached samples of a streamed sound.
+	explicit WavSupplier(std::shared_ptr<const std::vector<sample_t>> cached, bool looping = false);
 
 	// Inherited pure virtual methods
 	size_t MaxChunks() const override;
 	size_t AvailableChunks() const override;
-	std::vector<sample_t> NextDataChunk() override;
+	void NextDataChunk(std::vector<sample_t> &samples) override;
+
+
+private:
+	const std::vector<sample_t> &Input() const;
 
 
 private:
-	const Sound &sound;
+	const Sound *sound = nullptr;
+	std::shared_ptr<const std::vector<sample_t>> cached;
 	bool wasStarted;
 };
@@ -43,7 +43,7 @@ public:
 	// Inherited pure virtual methods
 	size_t MaxChunks() const override;
 	size_t AvailableChunks() const override;
-	std::vector<sample_t> NextDataChunk() override;
+	void NextDataChunk(std::vector<sample_t> &samples) override;
 
 
 private:
@@ -57,4 +57,7 @@ private:
 	std::vector<std::tuple<std::unique_ptr<AudioSupplier>, size_t, size_t>> fadeProgress;
 	/// The primary source; this one is not faded out by itself, but can be cross-faded with the other sources.
 	std::unique_ptr<AudioSupplier> primarySource;
+	/// The chunks of the fading sources that are being blended, kept so that they do not need to be reallocated.
+	std::vector<sample_t> fadedSamples;
+	std::vector<sample_t> otherSamples;
 };
@@ -18,12 +18,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Files.h"
 #include "ImageFileData.h"
 #include "../Logger.h"
+#include "../MappedFile.h"
+#include "PixelKernels.h"
 
 #include <avif/avif.h>
 #include <jpeglib.h>
 #include <png.h>
 
 #include <cmath>
+#include <cstring>
 #include <memory>
 #include <set>
 #include <stdexcept>
@@ -44,11 +47,14 @@ namespace {
 	}();
 	const set<string> IMAGE_SEQUENCE_EXTENSIONS = AVIF_EXTENSIONS;
 
+	bool ReadPNGDimensions(const filesystem::path &path, int &width, int &height);
+	bool ReadJPGDimensions(const filesystem::path &path, int &width, int &height);
 	bool ReadPNG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool onlyDimensions);
 	bool ReadJPG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool onlyDimensions);
 	int ReadAVIF(const filesystem::path &path, ImageBuffer &buffer, int frame, bool alphaPreMultiplied,
 		bool onlyDimensions);
 	void Premultiply(ImageBuffer &buffer, int frame, BlendingMode additive);
+	void CompressBlock(const ImageBuffer &buffer, int x, int y, int frame, uint8_t *out);
 }
 
 
@@ -86,6 +92,8 @@ void ImageBuffer::Clear(int frames)
 {
 	delete [] pixels;
 	pixels = nullptr;
+	compressed.clear();
+	compressed.shrink_to_fit();
 	this->frames = frames;
 }
 
@@ -161,21 +169,10 @@ void ImageBuffer::ShrinkToHalfSize()
 	ImageBuffer result(frames);
 	result.Allocate(width / 2, height / 2);
 
-	unsigned char *begin = reinterpret_cast<unsigned char *>(pixels);
-	unsigned char *out = reinterpret_cast<unsigned char *>(result.pixels);
 	// Loop through every line of every frame of the buffer.
 	for(int y = 0; y < result.height * frames; ++y)
-	{
-		unsigned char *aIt = begin + (4 * width) * (2 * y);
-		unsigned char *aEnd = aIt + 4 * 2 * result.width;
-		unsigned char *bIt = begin + (4 * width) * (2 * y + 1);
-		for( ; aIt != aEnd; aIt += 4, bIt += 4)
-		{
-			for(int channel = 0; channel < 4; ++channel, ++aIt, ++bIt, ++out)
-				*out = (static_cast<unsigned>(aIt[0]) + static_cast<unsigned>(bIt[0])
-					+ static_cast<unsigned>(aIt[4]) + static_cast<unsigned>(bIt[4]) + 2) / 4;
-		}
-	}
+		PixelKernels::Shrink(pixels + width * (2 * y), pixels + width * (2 * y + 1),
+			result.pixels + result.width * y, result.width);
 	swap(width, result.width);
 	swap(height, result.height);
 	swap(pixels, result.pixels);
@@ -183,6 +180,75 @@ void ImageBuffer::ShrinkToHalfSize()
 
 
 
+// Compress every frame into the BC3 texture format, which takes a quarter of
+// the memory. Afterwards, the uncompressed pixels are no longer available.
+void ImageBuffer::Compress()
+{
+	if(!pixels)
+		return;
+
+	// Each block of 4x4 pixels is compressed into 16 bytes. Blocks at the right
+	// and bottom edges of the image may be partial.
+	const int columns = (width + 3) / 4;
+	const int rows = (height + 3) / 4;
+	vector<uint8_t> blocks(16 * columns * rows * frames);
+	uint8_t *out = blocks.data();
+	for(int frame = 0; frame < frames; ++frame)
+		for(int y = 0; y < height; y += 4)
+			for(int x = 0; x < width; x += 4, out += 16)
+				CompressBlock(*this, x, y, frame, out);
+
+	delete [] pixels;
+	pixels = nullptr;
+	compressed = std::move(blocks);
+}
+
+
+
+// Replace this buffer's contents with frames that were already compressed.
+void ImageBuffer::SetCompressed(int width, int height, vector<uint8_t> blocks)
+{
+	Clear(frames);
+	this->width = width;
+	this->height = height;
+	compressed = std::move(blocks);
+}
+
+
+
+// Set the dimensions of this buffer without allocating any pixels.
+void ImageBuffer::SetDimensions(int width, int height)
+{
+	Clear(frames);
+	this->width = width;
+	this->height = height;
+}
+
+
+
+bool ImageBuffer::IsCompressed() const
+{
+	return !compressed.empty();
+}
+
+
+
+// The compressed 4x4 pixel blocks of every frame, in order.
+const vector<uint8_t> &ImageBuffer::CompressedBlocks() const
+{
+	return compressed;
+}
+
+
+
+// Whether this buffer holds any image data, compressed or not.
+bool ImageBuffer::HasData() const
+{
+	return pixels || !compressed.empty();
+}
+
+
+
 int ImageBuffer::Read(const ImageFileData &data, int frame, bool onlyDimensions)
 {
 	// First, make sure this is a supported file.
@@ -223,8 +289,102 @@ namespace {
 		static_cast<iostream *>(png_get_io_ptr(pngStruct))->read(reinterpret_cast<char *>(outBytes), byteCountToRead);
 	}
 
+	int ReadBigEndian16(const unsigned char *bytes)
+	{
+		return (bytes[0] << 8) | bytes[1];
+	}
+
+	uint32_t ReadBigEndian32(const unsigned char *bytes)
+	{
+		return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16)
+			| (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+	}
+
+	// Read the dimensions of a PNG from its header chunk, which always comes
+	// right after the file signature, without decoding any of the image.
+	bool ReadPNGDimensions(const filesystem::path &path, int &width, int &height)
+	{
+		shared_ptr<iostream> file = Files::Open(path);
+		if(!file)
+			return false;
+
+		static const unsigned char SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+		unsigned char header[24];
+		if(!file->read(reinterpret_cast<char *>(header), sizeof(header)))
+			return false;
+		if(memcmp(header, SIGNATURE, sizeof(SIGNATURE)) || memcmp(header + 12, "IHDR", 4))
+			return false;
+
+		// The largest dimensions that a PNG allows still fit in an int.
+		width = ReadBigEndian32(header + 16);
+		height = ReadBigEndian32(header + 20);
+		return width > 0 && height > 0;
+	}
+
+	// Read the dimensions of a JPEG from its frame header, skipping over any
+	// segments that come before it, without decoding any of the image.
+	bool ReadJPGDimensions(const filesystem::path &path, int &width, int &height)
+	{
+		shared_ptr<iostream> file = Files::Open(path);
+		if(!file)
+			return false;
+
+		// The file must start with a "start of image" marker.
+		if(file->get() != 0xFF || file->get() != 0xD8)
+			return false;
+
+		while(true)
+		{
+			if(file->get() != 0xFF)
+				return false;
+			// Any number of fill bytes may come before the marker itself.
+			int marker = file->get();
+			while(marker == 0xFF)
+				marker = file->get();
+			if(marker == char_traits<char>::eof())
+				return false;
+			// These markers stand alone, without a segment.
+			if(marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+				continue;
+			// The frame header must come before the end of the image or the image data.
+			if(marker == 0xD9 || marker == 0xDA)
+				return false;
+
+			unsigned char bytes[7];
+			if(!file->read(reinterpret_cast<char *>(bytes), 2))
+				return false;
+			int length = ReadBigEndian16(bytes);
+			if(length < 2)
+				return false;
+
+			// Every "start of frame" marker except for those that share its range
+			// (huffman tables, arithmetic coding, and arithmetic conditioning).
+			if(marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+			{
+				// The sample precision comes first, then the height and the width.
+				if(length < 7 || !file->read(reinterpret_cast<char *>(bytes + 2), 5))
+					return false;
+				height = ReadBigEndian16(bytes + 3);
+				width = ReadBigEndian16(bytes + 5);
+				return width > 0 && height > 0;
+			}
+			if(!file->ignore(length - 2))
+				return false;
+		}
+	}
+
 	bool ReadPNG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool onlyDimensions)
 	{
+		if(onlyDimensions)
+		{
+			int width = 0;
+			int height = 0;
+			if(!ReadPNGDimensions(path, width, height))
+				return false;
+			buffer.SetDimensions(width, height);
+			return true;
+		}
+
 		// Open the file, and make sure it really is a PNG.
 		shared_ptr<iostream> file = Files::Open(path.string());
 		if(!file)
@@ -278,13 +438,6 @@ namespace {
 					+ " but was " + to_string(height), Logger::Level::WARNING);
 			return false;
 		}
-		if(onlyDimensions)
-		{
-			// Clean up. The file will be closed automatically.
-			png_destroy_read_struct(&png, &info, nullptr);
-			return true;
-		}
-
 		// Adjust settings to make sure the result will be an RGBA file.
 		int colorType = png_get_color_type(png, info);
 		int bitDepth = png_get_bit_depth(png, info);
@@ -331,8 +484,18 @@ namespace {
 
 	bool ReadJPG(const filesystem::path &path, ImageBuffer &buffer, int frame, bool onlyDimensions)
 	{
-		string data = Files::Read(path);
-		if(data.empty())
+		if(onlyDimensions)
+		{
+			int width = 0;
+			int height = 0;
+			if(!ReadJPGDimensions(path, width, height))
+				return false;
+			buffer.SetDimensions(width, height);
+			return true;
+		}
+
+		MappedFile data(path);
+		if(!data.Size())
 			return false;
 
 		jpeg_decompress_struct cinfo;
@@ -343,7 +506,7 @@ namespace {
 		jpeg_create_decompress(&cinfo);
 #pragma GCC diagnostic pop
 
-		jpeg_mem_src(&cinfo, reinterpret_cast<const unsigned char *>(data.data()), data.size());
+		jpeg_mem_src(&cinfo, reinterpret_cast<const unsigned char *>(data.Data()), data.Size());
 		jpeg_read_header(&cinfo, true);
 		cinfo.out_color_space = JCS_EXT_RGBA;
 
@@ -376,12 +539,6 @@ namespace {
 					+ " but was " + to_string(height), Logger::Level::WARNING);
 			return false;
 		}
-		if(onlyDimensions)
-		{
-			jpeg_destroy_decompress(&cinfo);
-			return true;
-		}
-
 		// Read the file.
 		vector<JSAMPLE *> rows(height, nullptr);
 		for(int y = 0; y < height; ++y)
@@ -416,9 +573,9 @@ namespace {
 		}
 		// Maintenance note: this is where decoder defaults should be overwritten (codec, exif/xmp, etc.)
 
-		string data = Files::Read(path);
-		avifResult result = avifDecoderSetIOMemory(decoder.get(), reinterpret_cast<const uint8_t *>(data.c_str()),
-			data.size());
+		MappedFile data(path);
+		avifResult result = avifDecoderSetIOMemory(decoder.get(), reinterpret_cast<const uint8_t *>(data.Data()),
+			data.Size());
 		if(result != AVIF_RESULT_OK)
 		{
 			Logger::Log("Could not read file: " + path.generic_string(), Logger::Level::WARNING);
@@ -467,6 +624,15 @@ namespace {
 			bufferFrameCount += repeats[i];
 		}
 
+		// The dimensions are known now, without decoding any of the frames.
+		if(onlyDimensions)
+		{
+			if(bufferFrameCount > 1)
+				buffer.Clear(bufferFrameCount);
+			buffer.SetDimensions(decoder->image->width, decoder->image->height);
+			return bufferFrameCount;
+		}
+
 		// Now that we know the buffer's frame count, we can allocate the memory for it.
 		// If this is an image sequence, the preconfigured frame count is wrong.
 		try {
@@ -486,9 +652,6 @@ namespace {
 			Logger::Log("Invalid dimensions for \"" + path.generic_string() + "\"", Logger::Level::WARNING);
 			return 0;
 		}
-		if(onlyDimensions)
-			return bufferFrameCount;
-
 		// Load each image in the sequence.
 		int avifFrameIndex = 0;
 		size_t bufferFrame = 0;
@@ -535,27 +698,114 @@ namespace {
 
 	void Premultiply(ImageBuffer &buffer, int frame, BlendingMode blend)
 	{
-		for(int y = 0; y < buffer.Height(); ++y)
-		{
-			uint32_t *it = buffer.Begin(y, frame);
+		// Every frame is stored contiguously.
+		PixelKernels::Premultiply(buffer.Begin(0, frame), static_cast<size_t>(buffer.Width()) * buffer.Height(), blend);
+	}
 
-			for(uint32_t *end = it + buffer.Width(); it != end; ++it)
-			{
-				uint64_t value = *it;
-				uint64_t alpha = (value & 0xFF000000) >> 24;
 
-				uint64_t red = (((value & 0xFF0000) * alpha) / 255) & 0xFF0000;
-				uint64_t green = (((value & 0xFF00) * alpha) / 255) & 0xFF00;
-				uint64_t blue = (((value & 0xFF) * alpha) / 255) & 0xFF;
 
-				value = red | green | blue;
-				if(blend == BlendingMode::HALF_ADDITIVE)
-					alpha >>= 2;
-				if(blend != BlendingMode::ADDITIVE)
-					value |= (alpha << 24);
+	// Convert an 8-bit color channel to 5 or 6 bits and back, the way the GPU would.
+	int To565(const int color[3])
+	{
+		return ((color[0] * 31 + 127) / 255 << 11) | ((color[1] * 63 + 127) / 255 << 5) | ((color[2] * 31 + 127) / 255);
+	}
+
+	void From565(int packed, int color[3])
+	{
+		color[0] = ((packed >> 11) & 31) * 255 / 31;
+		color[1] = ((packed >> 5) & 63) * 255 / 63;
+		color[2] = (packed & 31) * 255 / 31;
+	}
+
 
-				*it = static_cast<uint32_t>(value);
+
+	// Compress the 4x4 block of pixels starting at the given position into the
+	// 16 bytes of a BC3 block: 8 bytes of alpha, followed by 8 bytes of color.
+	// The endpoints are simply the corners of the block's bounding box.
+	void CompressBlock(const ImageBuffer &buffer, int x, int y, int frame, uint8_t *out)
+	{
+		// Gather the block's pixels, repeating the edge pixels of partial blocks.
+		int pixel[16][4];
+		for(int i = 0; i < 16; ++i)
+		{
+			const int px = min(x + i % 4, buffer.Width() - 1);
+			const int py = min(y + i / 4, buffer.Height() - 1);
+			const uint8_t *it = reinterpret_cast<const uint8_t *>(buffer.Begin(py, frame) + px);
+			for(int channel = 0; channel < 4; ++channel)
+				pixel[i][channel] = it[channel];
+		}
+
+		// The alpha block uses eight levels between the largest and smallest alpha.
+		int minAlpha = 255;
+		int maxAlpha = 0;
+		for(const auto &it : pixel)
+		{
+			minAlpha = min(minAlpha, it[3]);
+			maxAlpha = max(maxAlpha, it[3]);
+		}
+		out[0] = maxAlpha;
+		out[1] = minAlpha;
+		uint64_t alphaIndices = 0;
+		if(maxAlpha > minAlpha)
+			for(int i = 0; i < 16; ++i)
+			{
+				// Level 0 is the first endpoint and level 7 the second one. Levels 2
+				// through 7 of the block are the ones in between them.
+				const int level = ((maxAlpha - pixel[i][3]) * 14 + (maxAlpha - minAlpha)) / (2 * (maxAlpha - minAlpha));
+				const uint64_t index = (level == 0) ? 0 : (level == 7) ? 1 : level + 1;
+				alphaIndices |= index << (3 * i);
 			}
+		for(int i = 0; i < 6; ++i)
+			out[2 + i] = alphaIndices >> (8 * i);
+
+		// Inset the color bounding box slightly, to reduce the error of its interpolated colors.
+		int low[3] = {255, 255, 255};
+		int high[3] = {0, 0, 0};
+		for(const auto &it : pixel)
+			for(int channel = 0; channel < 3; ++channel)
+			{
+				low[channel] = min(low[channel], it[channel]);
+				high[channel] = max(high[channel], it[channel]);
+			}
+		for(int channel = 0; channel < 3; ++channel)
+		{
+			const int inset = (high[channel] - low[channel]) / 16;
+			low[channel] += inset;
+			high[channel] -= inset;
 		}
+		const int first = To565(high);
+		const int second = To565(low);
+		out[8] = first;
+		out[9] = first >> 8;
+		out[10] = second;
+		out[11] = second >> 8;
+
+		// Each pixel uses whichever of the four colors along the line between the
+		// endpoints its position on that line is closest to.
+		int start[3];
+		int end[3];
+		From565(second, start);
+		From565(first, end);
+		int direction[3];
+		int length = 0;
+		for(int channel = 0; channel < 3; ++channel)
+		{
+			direction[channel] = end[channel] - start[channel];
+			length += direction[channel] * direction[channel];
+		}
+		uint32_t colorIndices = 0;
+		if(length)
+			for(int i = 0; i < 16; ++i)
+			{
+				int dot = 0;
+				for(int channel = 0; channel < 3; ++channel)
+					dot += (pixel[i][channel] - start[channel]) * direction[channel];
+				// Steps 0 through 3 go from the second endpoint to the first one.
+				const int step = clamp((dot * 6 + length) / (2 * length), 0, 3);
+				static const uint32_t INDEX[4] = {1, 3, 2, 0};
+				colorIndices |= INDEX[step] << (2 * i);
+			}
+		for(int i = 0; i < 4; ++i)
+			out[12 + i] = colorIndices >> (8 * i);
 	}
 }
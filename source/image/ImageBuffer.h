@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <cstdint>
 #include <set>
 #include <string>
+#include <vector>
 
 class ImageFileData;
 
@@ -28,7 +29,8 @@ class ImageFileData;
 // time in different threads). It also handles converting images to
 // premultiplied alpha or additive or half-additive color mixing mode depending
 // on the file name, so that content creators do not have to save the images in
-// some sort of special format.
+// some sort of special format. The frames can also be compressed into the BC3
+// (DXT5) texture format, so that they take up less memory on the GPU.
 class ImageBuffer {
 public:
 	// The supported image extensions, in lower case and with a leading period.
@@ -64,6 +66,19 @@ public:
 
 	void ShrinkToHalfSize();
 
+	// Compress every frame into the BC3 texture format, which takes a quarter of
+	// the memory. Afterwards, the uncompressed pixels are no longer available.
+	void Compress();
+	// Replace this buffer's contents with frames that were already compressed.
+	void SetCompressed(int width, int height, std::vector<uint8_t> blocks);
+	// Set the dimensions of this buffer without allocating any pixels.
+	void SetDimensions(int width, int height);
+	bool IsCompressed() const;
+	// The compressed 4x4 pixel blocks of every frame, in order.
+	const std::vector<uint8_t> &CompressedBlocks() const;
+	// Whether this buffer holds any image data, compressed or not.
+	bool HasData() const;
+
 	// Read frames from a file. Return the number of frames read,
 	// or 0 if an error is encountered - either the
 	// image is the wrong size, or it is not a supported image format.
@@ -77,4 +92,5 @@ private:
 	int height;
 	int frames;
 	uint32_t *pixels;
+	std::vector<uint8_t> compressed;
 };
@@ -21,8 +21,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ImageFileData.h"
 #include "../Logger.h"
 #include "Mask.h"
+#include "MaskCache.h"
 #include "MaskManager.h"
+#include "../MemoryProfile.h"
 #include "Sprite.h"
+#include "../StartupProfile.h"
+#include "../TaskGroup.h"
+#include "TextureCache.h"
 
 #include <algorithm>
 #include <cassert>
@@ -76,6 +81,35 @@ namespace {
 				+ (ignored > 1 ? " frames" : " frame") + " ignored in total).", Logger::Level::WARNING);
 		}
 	}
+
+	// Read up to the given number of frames into the buffer, and return how
+	// many frames were read from each file. Once one frame has been read, the
+	// buffer is allocated, so the rest can be decoded in parallel, each into
+	// its own part of the buffer. Image sequences can change the number of
+	// frames, so they are always read one at a time.
+	vector<int> ReadFrames(const vector<filesystem::path> &toLoad, size_t count, ImageBuffer &buffer)
+	{
+		count = min(count, toLoad.size());
+		vector<int> loaded(count, 0);
+		const bool hasSequence = any_of(toLoad.begin(), toLoad.begin() + count,
+			[](const filesystem::path &path) -> bool
+			{
+				return ImageBuffer::ImageSequenceExtensions().contains(Format::LowerCase(path.extension().string()));
+			});
+
+		size_t i = 0;
+		for( ; i < count && (hasSequence || !buffer.Pixels()); ++i)
+			loaded[i] = buffer.Read(toLoad[i], i);
+
+		TaskGroup group;
+		for( ; i < count; ++i)
+			group.Run([&toLoad, &buffer, &loaded, i]() -> void
+				{
+					loaded[i] = buffer.Read(toLoad[i], i);
+				});
+		group.Wait();
+		return loaded;
+	}
 }
 
 
@@ -175,6 +209,14 @@ void ImageSet::ValidateFrames() noexcept(false)
 void ImageSet::Load() noexcept(false)
 {
 	assert(framePaths[0].empty() && "should call ValidateFrames before calling Load");
+	MemoryProfile::Scope memoryScope(MemoryProfile::Tag::SPRITES);
+	// The time is attributed to the first frame, but the size of every frame is counted.
+	StartupProfile::Scope scope("ImageSet::Load", paths[0].front());
+	if(StartupProfile::IsEnabled())
+		for(const auto &list : paths)
+			for(const filesystem::path &path : list)
+				if(&path != &paths[0].front())
+					scope.AddBytes(StartupProfile::FileSize(path));
 
 	// Determine how many frames there will be, total. The image buffers will
 	// not actually be allocated until the first image is loaded (at which point
@@ -206,48 +248,73 @@ void ImageSet::Load() noexcept(false)
 	buffer[0].Clear(frames);
 	UpdateFrameCount();
 
+	// Collision masks that were traced before are read from the cache.
+	const bool traceMasks = makeMasks && !MaskCache::Load(paths[0], masks);
+
+	// If textures are compressed, only the 2x frames are uploaded if there are
+	// any. If they are already in the cache, the 1x frames only need to be
+	// decoded to trace the collision masks.
+	const bool compress = TextureCache::IsEnabled();
+	const int texture = paths[1].empty() ? 0 : 1;
+	const bool isCached = compress && (texture == 1 || !traceMasks)
+		&& TextureCache::Load(paths[texture], noReduction, buffer[0], buffer[texture]);
+
 	// Load the 1x sprites first, then the 2x sprites, because they are likely
-	// to be in separate locations on the disk. Create masks if needed.
-	for(size_t i = 0; i < paths[0].size(); ++i)
+	// to be in separate locations on the disk.
+	vector<size_t> loaded;
+	const vector<int> loadedFrames = (!isCached || traceMasks)
+		? ReadFrames(paths[0], paths[0].size(), buffer[0]) : vector<int>();
+	for(size_t i = 0; i < loadedFrames.size(); ++i)
 	{
-		int loadedFrames = buffer[0].Read(paths[0][i], i);
 		const string fileName = "\"" + name + "\" frame #" + to_string(i);
-		if(!loadedFrames)
+		if(!loadedFrames[i])
 		{
 			Logger::Log("Failed to read image data for " + fileName, Logger::Level::WARNING);
 			continue;
 		}
 		// If we loaded an image sequence, clear all other buffers.
-		if(loadedFrames > 1)
+		if(loadedFrames[i] > 1)
 		{
-			frames = loadedFrames;
+			frames = loadedFrames[i];
 			UpdateFrameCount();
 		}
+		loaded.push_back(i);
+	}
 
-		if(makeMasks)
-		{
-			masks[i].Create(buffer[0], i, fileName);
-			if(!masks[i].IsLoaded())
-				Logger::Log("Failed to create collision mask for " + fileName, Logger::Level::WARNING);
-		}
+	// Trace the masks of all the frames in parallel.
+	if(traceMasks)
+	{
+		TaskGroup group;
+		for(size_t i : loaded)
+			group.Run([this, i]() -> void
+				{
+					const string fileName = "\"" + name + "\" frame #" + to_string(i);
+					masks[i].Create(buffer[0], i, fileName);
+					if(!masks[i].IsLoaded())
+						Logger::Log("Failed to create collision mask for " + fileName, Logger::Level::WARNING);
+				});
+		group.Wait();
+		MaskCache::Store(paths[0], masks);
 	}
 
 	auto LoadSprites = [&](const vector<filesystem::path> &toLoad, ImageBuffer &buffer, const string &specifier)
 	{
-		for(size_t i = 0; i < frames && i < toLoad.size(); ++i)
-			if(!buffer.Read(toLoad[i], i))
-			{
-				Logger::Log("Removing " + specifier + " frames for \"" + name + "\" due to read error",
-					Logger::Level::WARNING);
-				buffer.Clear();
-				break;
-			}
+		const vector<int> loadedFrames = ReadFrames(toLoad, frames, buffer);
+		if(ranges::find(loadedFrames, 0) != loadedFrames.end())
+		{
+			Logger::Log("Removing " + specifier + " frames for \"" + name + "\" due to read error",
+				Logger::Level::WARNING);
+			buffer.Clear();
+		}
 	};
 	// Now, load the mask and 2x sprites, if they exist. Because the number of 1x frames
 	// is definitive, don't load any frames beyond the size of the 1x list.
-	LoadSprites(paths[1], buffer[1], "@2x");
+	if(!isCached)
+		LoadSprites(paths[1], buffer[1], "@2x");
 	LoadSprites(paths[2], buffer[2], "mask");
 	LoadSprites(paths[3], buffer[3], "@2x mask");
+	if(compress && !isCached)
+		TextureCache::Compress(paths[texture], noReduction, buffer[0], buffer[texture]);
 
 	// Warn about a "high-profile" image that will be blurry due to rendering at 50% scale.
 	bool willBlur = (buffer[0].Width() & 1) || (buffer[0].Height() & 1);
@@ -261,6 +328,7 @@ void ImageSet::Load() noexcept(false)
 void ImageSet::LoadDimensions(Sprite *sprite) noexcept(false)
 {
 	assert(framePaths[0].empty() && "should call ValidateFrames before calling LoadDimensions");
+	StartupProfile::Scope scope("ImageSet::LoadDimensions", paths[0][0]);
 
 	// Read only the first frame of the 1x resolution image in order to determine the dimensions of the sprite.
 	// (All frames are expected to have the same dimensions.)
@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "ImageBuffer.h"
 #include "../Logger.h"
+#include "../MemoryProfile.h"
 
 #include <algorithm>
 #include <cmath>
@@ -25,6 +26,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	// The largest number of segments in a leaf of a mask's tree.
+	constexpr uint32_t LEAF_SIZE = 8;
+	// The tree's bounding boxes are padded slightly, so that rounding errors
+	// can't make a query skip a segment that it touches.
+	const Point PADDING(1e-6, 1e-6);
+	// The deepest a tree can be; each level at least halves the segments.
+	constexpr int MAX_DEPTH = 64;
+
 	// Trace out outlines from an image frame.
 	void Trace(const ImageBuffer &image, int frame, vector<vector<Point>> &raw, const string &fileName)
 	{
@@ -283,6 +292,7 @@ namespace {
 // Construct a mask from the alpha channel of an RGBA-formatted image.
 void Mask::Create(const ImageBuffer &image, int frame, const string &fileName)
 {
+	MemoryProfile::Scope memoryScope(MemoryProfile::Tag::MASKS);
 	outlines.clear();
 	radius = 0.;
 
@@ -306,6 +316,20 @@ void Mask::Create(const ImageBuffer &image, int frame, const string &fileName)
 		outlines.back().shrink_to_fit();
 	}
 	outlines.shrink_to_fit();
+	BuildTree();
+}
+
+
+
+// Construct a mask from outlines that were already traced and simplified.
+void Mask::Create(vector<vector<Point>> outlines)
+{
+	MemoryProfile::Scope memoryScope(MemoryProfile::Tag::MASKS);
+	this->outlines = std::move(outlines);
+	radius = 0.;
+	for(const vector<Point> &outline : this->outlines)
+		radius = max(radius, ComputeRadius(outline));
+	BuildTree();
 }
 
 
@@ -446,6 +470,7 @@ Mask Mask::operator*(Point scale) const
 		if(radius > newMask.radius)
 			newMask.radius = radius;
 	}
+	newMask.BuildTree();
 	return newMask;
 }
 
@@ -458,35 +483,125 @@ Mask operator*(Point scale, const Mask &mask)
 
 
 
+// Build the hierarchy of segments that collision queries use to skip the
+// parts of the outlines that they can't possibly touch.
+void Mask::BuildTree()
+{
+	segments.clear();
+	tree.clear();
+	for(const vector<Point> &outline : outlines)
+	{
+		if(outline.empty())
+			continue;
+		Point prev = outline.back();
+		for(const Point &next : outline)
+		{
+			segments.emplace_back(prev, next);
+			prev = next;
+		}
+	}
+	segments.shrink_to_fit();
+	if(segments.empty())
+		return;
+	tree.reserve(2 * (segments.size() / LEAF_SIZE) + 1);
+
+	// Split each node's segments in half along the longer axis of their centers.
+	auto Build = [this](auto &Build, uint32_t begin, uint32_t end) -> void
+	{
+		const size_t index = tree.size();
+		tree.emplace_back();
+		Point low = segments[begin].first;
+		Point high = low;
+		Point centerLow = (segments[begin].first + segments[begin].second) * .5;
+		Point centerHigh = centerLow;
+		for(uint32_t i = begin; i < end; ++i)
+		{
+			const auto &[start, finish] = segments[i];
+			low = min(low, min(start, finish));
+			high = max(high, max(start, finish));
+			const Point center = (start + finish) * .5;
+			centerLow = min(centerLow, center);
+			centerHigh = max(centerHigh, center);
+		}
+		tree[index].min = low - PADDING;
+		tree[index].max = high + PADDING;
+
+		if(end - begin <= LEAF_SIZE)
+		{
+			tree[index].first = begin;
+			tree[index].count = end - begin;
+			return;
+		}
+
+		const Point extent = centerHigh - centerLow;
+		const bool splitX = extent.X() >= extent.Y();
+		const uint32_t middle = begin + (end - begin) / 2;
+		nth_element(segments.begin() + begin, segments.begin() + middle, segments.begin() + end,
+			[splitX](const pair<Point, Point> &a, const pair<Point, Point> &b)
+			{
+				return splitX ? a.first.X() + a.second.X() < b.first.X() + b.second.X()
+					: a.first.Y() + a.second.Y() < b.first.Y() + b.second.Y();
+			});
+		Build(Build, begin, middle);
+		tree[index].first = tree.size();
+		Build(Build, middle, end);
+	};
+	Build(Build, 0, segments.size());
+	tree.shrink_to_fit();
+}
+
+
+
 double Mask::Intersection(Point sA, Point vA) const
 {
 	// Keep track of the closest intersection point found.
 	double closest = 1.;
+	if(tree.empty())
+		return closest;
 
-	for(auto &&outline : outlines)
+	uint32_t stack[MAX_DEPTH];
+	int depth = 0;
+	uint32_t index = 0;
+	while(true)
 	{
-		Point prev = outline.back();
-		for(auto &&next : outline)
+		// Skip any node that the part of the segment before the closest
+		// intersection so far doesn't overlap.
+		const Node &node = tree[index];
+		const Point end = sA + vA * closest;
+		const Point low = min(sA, end);
+		const Point high = max(sA, end);
+		const bool overlaps = low.X() <= node.max.X() && high.X() >= node.min.X()
+			&& low.Y() <= node.max.Y() && high.Y() >= node.min.Y();
+		if(overlaps && !node.count)
 		{
-			// Check if there is an intersection. (If not, the cross would be 0.) If
-			// there is, handle it only if it is a point where the segment is
-			// entering the polygon rather than exiting it (i.e. cross > 0).
-			Point vB = next - prev;
-			double cross = vB.Cross(vA);
-			if(cross > 0.)
+			stack[depth++] = node.first;
+			++index;
+			continue;
+		}
+		if(overlaps)
+			for(uint32_t i = node.first; i < node.first + node.count; ++i)
 			{
-				Point vS = prev - sA;
-				double uB = vA.Cross(vS);
-				double uA = vB.Cross(vS);
-				// If the intersection occurs somewhere within this segment of the
-				// outline, find out how far along the query vector it occurs and
-				// remember it if it is the closest so far.
-				if((uB >= 0.) & (uB < cross) & (uA >= 0.))
-					closest = min(closest, uA / cross);
+				const auto &[prev, next] = segments[i];
+				// Check if there is an intersection. (If not, the cross would be 0.) If
+				// there is, handle it only if it is a point where the segment is
+				// entering the polygon rather than exiting it (i.e. cross > 0).
+				Point vB = next - prev;
+				double cross = vB.Cross(vA);
+				if(cross > 0.)
+				{
+					Point vS = prev - sA;
+					double uB = vA.Cross(vS);
+					double uA = vB.Cross(vS);
+					// If the intersection occurs somewhere within this segment of the
+					// outline, find out how far along the query vector it occurs and
+					// remember it if it is the closest so far.
+					if((uB >= 0.) & (uB < cross) & (uA >= 0.))
+						closest = min(closest, uA / cross);
+				}
 			}
-
-			prev = next;
-		}
+		if(!depth)
+			break;
+		index = stack[--depth];
 	}
 	return closest;
 }
@@ -508,20 +623,36 @@ bool Mask::Contains(Point point) const
 	// Compute the number of intersections across all outlines, not just one, as the
 	// outlines may be nested (i.e. holes) or discontinuous (multiple separate shapes).
 	int intersections = 0;
-	for(auto &&outline : outlines)
+	uint32_t stack[MAX_DEPTH];
+	int depth = 0;
+	uint32_t index = 0;
+	while(true)
 	{
-		Point prev = outline.back();
-		for(auto &&next : outline)
+		// Only segments that span the point horizontally and are not entirely
+		// above it can cross the ray.
+		const Node &node = tree[index];
+		const bool overlaps = node.min.X() <= point.X() && point.X() <= node.max.X() && node.max.Y() >= point.Y();
+		if(overlaps && !node.count)
 		{
-			if(prev.X() != next.X())
-				if((prev.X() <= point.X()) == (point.X() < next.X()))
-				{
-					double y = prev.Y() + (next.Y() - prev.Y()) *
-						(point.X() - prev.X()) / (next.X() - prev.X());
-					intersections += (y >= point.Y());
-				}
-			prev = next;
+			stack[depth++] = node.first;
+			++index;
+			continue;
 		}
+		if(overlaps)
+			for(uint32_t i = node.first; i < node.first + node.count; ++i)
+			{
+				const auto &[prev, next] = segments[i];
+				if(prev.X() != next.X())
+					if((prev.X() <= point.X()) == (point.X() < next.X()))
+					{
+						double y = prev.Y() + (next.Y() - prev.Y()) *
+							(point.X() - prev.X()) / (next.X() - prev.X());
+						intersections += (y >= point.Y());
+					}
+			}
+		if(!depth)
+			break;
+		index = stack[--depth];
 	}
 	// If the number of intersections is odd, the point is within the mask.
 	return (intersections & 1);
@@ -18,7 +18,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Angle.h"
 #include "../Point.h"
 
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 class ImageBuffer;
@@ -34,6 +36,8 @@ class Mask {
 public:
 	// Construct a mask from the alpha channel of an RGBA-formatted image.
 	void Create(const ImageBuffer &image, int frame, const std::string &fileName);
+	// Construct a mask from outlines that were already traced and simplified.
+	void Create(std::vector<std::vector<Point>> outlines);
 
 	// Check whether a mask was successfully generated from the image.
 	bool IsLoaded() const;
@@ -67,6 +71,23 @@ public:
 
 
 private:
+	// A node in the bounding volume hierarchy of the outline segments. If it is
+	// a leaf, it contains the given number of segments; otherwise, its children
+	// are the node after it and the node at the given index.
+	class Node {
+	public:
+		Point min;
+		Point max;
+		uint32_t first = 0;
+		uint32_t count = 0;
+	};
+
+
+private:
+	// Build the hierarchy of segments that collision queries use to skip the
+	// parts of the outlines that they can't possibly touch.
+	void BuildTree();
+
 	double Intersection(Point sA, Point vA) const;
 	bool Contains(Point point) const;
 
@@ -74,4 +95,9 @@ private:
 private:
 	std::vector<std::vector<Point>> outlines;
 	double radius = 0.;
+
+	// Every segment of every outline, as its start and end points, in the
+	// order of the leaves of the tree.
+	std::vector<std::pair<Point, Point>> segments;
+	std::vector<Node> tree;
 };
@@ -0,0 +1,233 @@
+/* MaskCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "MaskCache.h"
+
+#include "../DiskCache.h"
+#include "Mask.h"
+#include "../Point.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+	// This must be changed whenever the layout of the cache file changes.
+	const char MAGIC[8] = {'E', 'S', 'M', 'A', 'S', 'K', '0', '1'};
+
+	class Entry {
+	public:
+		vector<vector<Point>> outlines;
+		// Whether this mask has been used since the cache was read.
+		bool isUsed = false;
+	};
+
+	mutex cacheMutex;
+	bool isRead = false;
+	bool isChanged = false;
+	unordered_map<uint64_t, Entry> entries;
+
+	filesystem::path CachePath()
+	{
+		return DiskCache::Path("masks.bin");
+	}
+
+	// Identify the exact contents of the given image file. Returns 0 if it can't
+	// be cached: if it is missing, or is an image sequence, which has more than
+	// one frame that a mask could be traced from.
+	uint64_t Key(const filesystem::path &path)
+	{
+		const string extension = path.extension().string();
+		if(extension == ".avif" || extension == ".avifs")
+			return 0;
+		error_code error;
+		const uint64_t size = filesystem::file_size(path, error);
+		if(error)
+			return 0;
+		const int64_t timestamp = filesystem::last_write_time(path, error).time_since_epoch().count();
+		if(error)
+			return 0;
+
+		uint64_t key = DiskCache::Hash(path.string());
+		key = DiskCache::HashValue(size, key);
+		return DiskCache::HashValue(timestamp, key);
+	}
+
+	template<class Type>
+	bool Read(istream &in, Type &value)
+	{
+		return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+	}
+
+	template<class Type>
+	void Write(string &out, const Type &value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+	// Get how many bytes of a file of the given size have not been read yet.
+	uint64_t Remaining(istream &in, uint64_t size)
+	{
+		const streamoff position = in.tellg();
+		return position < 0 || static_cast<uint64_t>(position) > size ? 0 : size - position;
+	}
+
+	// Read the cache file into memory. If it is corrupt, whatever was read
+	// before the error is kept. The cache mutex must be held.
+	void ReadCache()
+	{
+		isRead = true;
+		const filesystem::path path = CachePath();
+		error_code error;
+		const uint64_t size = filesystem::file_size(path, error);
+		if(error)
+			return;
+		ifstream in(path, ios::in | ios::binary);
+		char magic[sizeof(MAGIC)];
+		if(!in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)))
+			return;
+
+		uint64_t key;
+		uint32_t outlineCount;
+		while(Read(in, key) && Read(in, outlineCount))
+		{
+			// Every outline takes up at least four bytes and every point sixteen,
+			// so a count that does not fit in the rest of the file means it is
+			// corrupt. Checking first keeps it from causing a huge allocation.
+			if(outlineCount > Remaining(in, size) / sizeof(uint32_t))
+				return;
+			vector<vector<Point>> outlines(outlineCount);
+			for(vector<Point> &outline : outlines)
+			{
+				uint32_t pointCount;
+				if(!Read(in, pointCount) || pointCount > Remaining(in, size) / (2 * sizeof(double)))
+					return;
+				outline.reserve(pointCount);
+				for(uint32_t i = 0; i < pointCount; ++i)
+				{
+					double x;
+					double y;
+					if(!Read(in, x) || !Read(in, y))
+						return;
+					outline.emplace_back(x, y);
+				}
+			}
+			entries[key].outlines = std::move(outlines);
+		}
+	}
+}
+
+
+
+// Get the masks for every one of the given image files. Returns false if
+// any of them is not in the cache, in which case no masks are changed.
+bool MaskCache::Load(const vector<filesystem::path> &paths, vector<Mask> &masks)
+{
+	vector<uint64_t> keys;
+	keys.reserve(paths.size());
+	for(const filesystem::path &path : paths)
+	{
+		keys.push_back(Key(path));
+		if(!keys.back())
+			return false;
+	}
+
+	lock_guard<mutex> lock(cacheMutex);
+	if(!isRead)
+		ReadCache();
+	for(uint64_t key : keys)
+		if(!entries.contains(key))
+		{
+			DiskCache::Miss("masks");
+			return false;
+		}
+	DiskCache::Hit("masks", CachePath());
+
+	masks.resize(paths.size());
+	for(size_t i = 0; i < keys.size(); ++i)
+	{
+		Entry &entry = entries[keys[i]];
+		entry.isUsed = true;
+		masks[i].Create(entry.outlines);
+	}
+	return true;
+}
+
+
+
+// Add the masks that were traced from the given image files.
+void MaskCache::Store(const vector<filesystem::path> &paths, const vector<Mask> &masks)
+{
+	lock_guard<mutex> lock(cacheMutex);
+	if(!isRead)
+		ReadCache();
+	for(size_t i = 0; i < paths.size() && i < masks.size(); ++i)
+	{
+		// Failed masks are not cached, so that the warnings are repeated.
+		const uint64_t key = masks[i].IsLoaded() ? Key(paths[i]) : 0;
+		if(!key)
+			continue;
+		Entry &entry = entries[key];
+		entry.outlines = masks[i].Outlines();
+		entry.isUsed = true;
+		isChanged = true;
+	}
+}
+
+
+
+// Write the cache file, if anything changed. Only masks that were used since
+// the cache was read are kept, so that masks of deleted images are dropped.
+// This also frees the memory used by the cache.
+void MaskCache::Save()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	bool isStale = false;
+	for(const auto &it : entries)
+		isStale |= !it.second.isUsed;
+
+	if(isChanged || isStale)
+	{
+		string out(MAGIC, sizeof(MAGIC));
+		for(const auto &[key, entry] : entries)
+		{
+			if(!entry.isUsed)
+				continue;
+			Write(out, key);
+			Write(out, static_cast<uint32_t>(entry.outlines.size()));
+			for(const vector<Point> &outline : entry.outlines)
+			{
+				Write(out, static_cast<uint32_t>(outline.size()));
+				for(const Point &point : outline)
+				{
+					Write(out, point.X());
+					Write(out, point.Y());
+				}
+			}
+		}
+
+		DiskCache::Store(CachePath(), out);
+	}
+
+	entries.clear();
+	isRead = false;
+	isChanged = false;
+}
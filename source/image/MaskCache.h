@@ -0,0 +1,43 @@
+/* MaskCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+class Mask;
+
+
+
+// An on-disk cache of the collision masks traced from sprite frames, so that
+// they do not need to be traced again every time the game starts. Each mask is
+// identified by the path, size and timestamp of the image file it was traced
+// from. All the masks are stored in a single file in the config directory's
+// "cache" folder, which is read the first time a mask is needed and rewritten
+// by Save() if any masks were added.
+class MaskCache {
+public:
+	// Get the masks for every one of the given image files. Returns false if
+	// any of them is not in the cache, in which case no masks are changed.
+	static bool Load(const std::vector<std::filesystem::path> &paths, std::vector<Mask> &masks);
+	// Add the masks that were traced from the given image files.
+	static void Store(const std::vector<std::filesystem::path> &paths, const std::vector<Mask> &masks);
+
+	// Write the cache file, if anything changed. Only masks that were used since
+	// the cache was read are kept, so that masks of deleted images are dropped.
+	// This also frees the memory used by the cache.
+	static void Save();
+};
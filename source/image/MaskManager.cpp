@@ -17,13 +17,24 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Logger.h"
 #include "Sprite.h"
+#include "../TaskGroup.h"
 
 using namespace std;
 
 namespace {
 	const Point DEFAULT = Point(1., 1.);
+	// Masks are looked up from worker threads, so the record of which sprites
+	// have already been warned about needs its own lock.
+	mutex warnedMutex;
 	map<const Sprite *, bool> warned;
 
+	// Check whether this is the first warning about the given sprite.
+	bool ShouldWarn(const Sprite *sprite)
+	{
+		lock_guard<mutex> lock(warnedMutex);
+		return warned.insert(make_pair(sprite, true)).second;
+	}
+
 	string PrintScale(Point s)
 	{
 		return to_string(100. * s.X()) + "x" + to_string(100. * s.Y()) + "%";
@@ -64,6 +75,8 @@ void MaskManager::RegisterScale(const Sprite *sprite, Point scale)
 // Create the scaled versions of all masks from the 1x versions.
 void MaskManager::ScaleMasks()
 {
+	// Each sprite's masks are scaled in parallel.
+	TaskGroup group;
 	for(auto &spriteScales : spriteMasks)
 	{
 		auto &scales = spriteScales.second;
@@ -71,20 +84,23 @@ void MaskManager::ScaleMasks()
 		if(baseIt == scales.end() || baseIt->second.empty())
 			continue;
 
-		const auto &baseMasks = baseIt->second;
-		for(auto &it : scales)
-		{
-			auto &masks = it.second;
-
-			// Skip mask generation for scales that have already been generated previously.
-			if(!masks.empty())
-				continue;
-
-			masks.reserve(baseMasks.size());
-			for(auto &&mask : baseMasks)
-				masks.push_back(mask * it.first);
-		}
+		group.Run([&scales, &baseMasks = baseIt->second]() -> void
+			{
+				for(auto &it : scales)
+				{
+					auto &masks = it.second;
+
+					// Skip mask generation for scales that have already been generated previously.
+					if(!masks.empty())
+						continue;
+
+					masks.reserve(baseMasks.size());
+					for(auto &&mask : baseMasks)
+						masks.push_back(mask * it.first);
+				}
+			});
 	}
+	group.Wait();
 }
 
 
@@ -97,7 +113,7 @@ const vector<Mask> &MaskManager::GetMasks(const Sprite *sprite, Point scale) con
 	const auto scalesIt = spriteMasks.find(sprite);
 	if(scalesIt == spriteMasks.end())
 	{
-		if(warned.insert(make_pair(sprite, true)).second)
+		if(ShouldWarn(sprite))
 			Logger::Log("Sprite \"" + sprite->Name() + "\": no collision masks found.", Logger::Level::WARNING);
 		return EMPTY;
 	}
@@ -108,7 +124,7 @@ const vector<Mask> &MaskManager::GetMasks(const Sprite *sprite, Point scale) con
 		return maskIt->second;
 
 	// Shouldn't happen, but just in case, print some details about the scales for this sprite (once).
-	if(warned.insert(make_pair(sprite, true)).second)
+	if(ShouldWarn(sprite))
 	{
 		string warning = "Sprite \"" + sprite->Name() + "\": collision mask not found.";
 		if(scales.empty()) warning += " (No scaled masks.)";
@@ -0,0 +1,209 @@
+/* PixelKernels.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "PixelKernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+namespace {
+	// The alpha that is stored for a pixel drawn with the given blending mode.
+	uint32_t BlendAlpha(uint32_t alpha, BlendingMode blend)
+	{
+		if(blend == BlendingMode::ADDITIVE)
+			return 0;
+		if(blend == BlendingMode::HALF_ADDITIVE)
+			return alpha >> 2;
+		return alpha;
+	}
+
+#if defined(__SSE2__) && !defined(__AVX2__)
+	// Divide each 16-bit product of two bytes by 255, rounding down.
+	__m128i DivideBy255(__m128i product)
+	{
+		return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)),
+			_mm_set1_epi16(1)), 8);
+	}
+
+	// Multiply the color channels of two pixels, widened to 16 bits, by their alpha.
+	__m128i PremultiplyTwo(__m128i pixels)
+	{
+		const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xFF), 0xFF);
+		return DivideBy255(_mm_mullo_epi16(pixels, alpha));
+	}
+#endif
+
+#ifdef __AVX2__
+	// Divide each 16-bit product of two bytes by 255, rounding down.
+	__m256i DivideBy255(__m256i product)
+	{
+		return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)),
+			_mm256_set1_epi16(1)), 8);
+	}
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+	// Divide each 16-bit product of two bytes by 255, rounding down, and narrow it.
+	uint8x8_t DivideBy255(uint16x8_t product)
+	{
+		return vshrn_n_u16(vaddq_u16(vsraq_n_u16(product, product, 8), vdupq_n_u16(1)), 8);
+	}
+#endif
+}
+
+
+
+// Premultiply the color of the given pixels by their alpha, then convert
+// the alpha for the given blending mode.
+void PixelKernels::Premultiply(uint32_t *pixels, size_t count, BlendingMode blend)
+{
+	size_t i = 0;
+#ifdef __AVX2__
+	const __m256i colorMask = _mm256_set1_epi32(0x00FFFFFF);
+	const __m256i zero = _mm256_setzero_si256();
+	for( ; i + 8 <= count; i += 8)
+	{
+		const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pixels + i));
+		const __m256i low = _mm256_unpacklo_epi8(in, zero);
+		const __m256i high = _mm256_unpackhi_epi8(in, zero);
+		const __m256i lowAlpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(low, 0xFF), 0xFF);
+		const __m256i highAlpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(high, 0xFF), 0xFF);
+		__m256i out = _mm256_packus_epi16(DivideBy255(_mm256_mullo_epi16(low, lowAlpha)),
+			DivideBy255(_mm256_mullo_epi16(high, highAlpha)));
+		out = _mm256_and_si256(out, colorMask);
+		if(blend == BlendingMode::HALF_ADDITIVE)
+			out = _mm256_or_si256(out, _mm256_slli_epi32(_mm256_srli_epi32(in, 26), 24));
+		else if(blend != BlendingMode::ADDITIVE)
+			out = _mm256_or_si256(out, _mm256_andnot_si256(colorMask, in));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(pixels + i), out);
+	}
+#elif defined(__SSE2__)
+	const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+	const __m128i zero = _mm_setzero_si128();
+	for( ; i + 4 <= count; i += 4)
+	{
+		const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i));
+		__m128i out = _mm_packus_epi16(PremultiplyTwo(_mm_unpacklo_epi8(in, zero)),
+			PremultiplyTwo(_mm_unpackhi_epi8(in, zero)));
+		out = _mm_and_si128(out, colorMask);
+		if(blend == BlendingMode::HALF_ADDITIVE)
+			out = _mm_or_si128(out, _mm_slli_epi32(_mm_srli_epi32(in, 26), 24));
+		else if(blend != BlendingMode::ADDITIVE)
+			out = _mm_or_si128(out, _mm_andnot_si128(colorMask, in));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i), out);
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	for( ; i + 8 <= count; i += 8)
+	{
+		uint8_t *it = reinterpret_cast<uint8_t *>(pixels + i);
+		uint8x8x4_t channels = vld4_u8(it);
+		const uint8x8_t alpha = channels.val[3];
+		for(int channel = 0; channel < 3; ++channel)
+			channels.val[channel] = DivideBy255(vmull_u8(channels.val[channel], alpha));
+		if(blend == BlendingMode::HALF_ADDITIVE)
+			channels.val[3] = vshr_n_u8(alpha, 2);
+		else if(blend == BlendingMode::ADDITIVE)
+			channels.val[3] = vdup_n_u8(0);
+		vst4_u8(it, channels);
+	}
+#endif
+	PremultiplyScalar(pixels + i, count - i, blend);
+}
+
+
+
+void PixelKernels::PremultiplyScalar(uint32_t *pixels, size_t count, BlendingMode blend)
+{
+	for(uint32_t *it = pixels, *end = pixels + count; it != end; ++it)
+	{
+		uint64_t value = *it;
+		uint64_t alpha = (value & 0xFF000000) >> 24;
+
+		uint64_t red = (((value & 0xFF0000) * alpha) / 255) & 0xFF0000;
+		uint64_t green = (((value & 0xFF00) * alpha) / 255) & 0xFF00;
+		uint64_t blue = (((value & 0xFF) * alpha) / 255) & 0xFF;
+
+		*it = static_cast<uint32_t>(red | green | blue | (BlendAlpha(alpha, blend) << 24));
+	}
+}
+
+
+
+// Average each 2x2 square of pixels in the given pair of rows into the
+// output row, which holds the given number of pixels.
+void PixelKernels::Shrink(const uint32_t *top, const uint32_t *bottom, uint32_t *out, size_t count)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+	// Sum every pair of horizontally adjacent pixels in four pixels of both rows.
+	const auto SumPairs = [zero](const uint32_t *a, const uint32_t *b)
+	{
+		// Reorder the pixels to 0, 2, 1, 3 so that each pair ends up in the same
+		// lane of the low and high halves.
+		const __m128i x = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a)), 0xD8);
+		const __m128i y = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b)), 0xD8);
+		return _mm_add_epi16(
+			_mm_add_epi16(_mm_unpacklo_epi8(x, zero), _mm_unpackhi_epi8(x, zero)),
+			_mm_add_epi16(_mm_unpacklo_epi8(y, zero), _mm_unpackhi_epi8(y, zero)));
+	};
+	for( ; i + 4 <= count; i += 4)
+	{
+		const __m128i first = _mm_srli_epi16(_mm_add_epi16(SumPairs(top + 2 * i, bottom + 2 * i), two), 2);
+		const __m128i second = _mm_srli_epi16(_mm_add_epi16(SumPairs(top + 2 * i + 4, bottom + 2 * i + 4), two), 2);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(first, second));
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	const uint16x8_t two = vdupq_n_u16(2);
+	for( ; i + 4 <= count; i += 4)
+	{
+		// Load eight pixels of each row, with the even and odd pixels separated.
+		const uint32x4x2_t a = vld2q_u32(top + 2 * i);
+		const uint32x4x2_t b = vld2q_u32(bottom + 2 * i);
+		const uint8x16_t aEven = vreinterpretq_u8_u32(a.val[0]);
+		const uint8x16_t aOdd = vreinterpretq_u8_u32(a.val[1]);
+		const uint8x16_t bEven = vreinterpretq_u8_u32(b.val[0]);
+		const uint8x16_t bOdd = vreinterpretq_u8_u32(b.val[1]);
+		const uint16x8_t low = vaddq_u16(vaddl_u8(vget_low_u8(aEven), vget_low_u8(aOdd)),
+			vaddl_u8(vget_low_u8(bEven), vget_low_u8(bOdd)));
+		const uint16x8_t high = vaddq_u16(vaddl_u8(vget_high_u8(aEven), vget_high_u8(aOdd)),
+			vaddl_u8(vget_high_u8(bEven), vget_high_u8(bOdd)));
+		vst1q_u32(out + i, vreinterpretq_u32_u8(vcombine_u8(
+			vshrn_n_u16(vaddq_u16(low, two), 2), vshrn_n_u16(vaddq_u16(high, two), 2))));
+	}
+#endif
+	ShrinkScalar(top + 2 * i, bottom + 2 * i, out + i, count - i);
+}
+
+
+
+void PixelKernels::ShrinkScalar(const uint32_t *top, const uint32_t *bottom, uint32_t *out, size_t count)
+{
+	const unsigned char *aIt = reinterpret_cast<const unsigned char *>(top);
+	const unsigned char *bIt = reinterpret_cast<const unsigned char *>(bottom);
+	unsigned char *outIt = reinterpret_cast<unsigned char *>(out);
+	for(const unsigned char *aEnd = aIt + 8 * count; aIt != aEnd; aIt += 4, bIt += 4)
+		for(int channel = 0; channel < 4; ++channel, ++aIt, ++bIt, ++outIt)
+			*outIt = (static_cast<unsigned>(aIt[0]) + static_cast<unsigned>(bIt[0])
+				+ static_cast<unsigned>(aIt[4]) + static_cast<unsigned>(bIt[4]) + 2) / 4;
+}
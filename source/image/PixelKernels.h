@@ -0,0 +1,39 @@
+/* PixelKernels.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "BlendingMode.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+
+// The per-pixel passes that are applied to every image after it is decoded.
+// Each pass has a vectorized version, which is used when the target supports
+// it, and a scalar reference version that gives exactly the same results.
+class PixelKernels {
+public:
+	// Premultiply the color of the given pixels by their alpha, then convert
+	// the alpha for the given blending mode.
+	static void Premultiply(uint32_t *pixels, size_t count, BlendingMode blend);
+	static void PremultiplyScalar(uint32_t *pixels, size_t count, BlendingMode blend);
+
+	// Average each 2x2 square of pixels in the given pair of rows into the
+	// output row, which holds the given number of pixels.
+	static void Shrink(const uint32_t *top, const uint32_t *bottom, uint32_t *out, size_t count);
+	static void ShrinkScalar(const uint32_t *top, const uint32_t *bottom, uint32_t *out, size_t count);
+};
@@ -15,9 +15,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Sprite.h"
 
+#include "../shader/GpuProfiler.h"
 #include "ImageBuffer.h"
 #include "../Preferences.h"
 #include "../Screen.h"
+#include "SpriteAtlas.h"
 
 #include "../opengl.h"
 
@@ -28,22 +30,30 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
-	void AddBuffer(ImageBuffer &buffer, uint32_t *target, bool noReduction)
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+	constexpr GLenum GL_COMPRESSED_RGBA_S3TC_DXT5_EXT = 0x83F3;
+#endif
+
+	void AddBuffer(ImageBuffer &buffer, uint32_t *target, bool noReduction, const Sprite *atlasSprite = nullptr)
 	{
 		// Check whether this sprite is large enough to require size reduction.
-		Preferences::LargeGraphicsReduction setting = Preferences::GetLargeGraphicsReduction();
-		if(!noReduction && (setting == Preferences::LargeGraphicsReduction::ALL
-				|| (setting == Preferences::LargeGraphicsReduction::LARGEST_ONLY
-				&& buffer.Width() * buffer.Height() >= 1000000)))
+		// Compressed frames have already been reduced, if needed.
+		if(!buffer.IsCompressed() && Sprite::IsReduced(buffer.Width(), buffer.Height(), noReduction))
 			buffer.ShrinkToHalfSize();
+		// Small sprites are also packed into a shared texture for batched drawing.
+		if(atlasSprite)
+			SpriteAtlas::Add(*atlasSprite, buffer);
 
 		// Upload the images as a single array texture.
 		int type = OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D;
 		glGenTextures(1, target);
 		glBindTexture(type, *target);
 
-		// Use linear interpolation and no wrapping.
-		glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		// Use linear interpolation and no wrapping. Sprites that are drawn much
+		// smaller than their size, such as when the view is zoomed out, are drawn
+		// from smaller copies of the image, which is faster and avoids shimmering.
+		const bool isMipmapped = Sprite::IsMipmapped(buffer.IsCompressed());
+		glTexParameteri(type, GL_TEXTURE_MIN_FILTER, isMipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
 		glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTexParameteri(type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -51,9 +61,18 @@ namespace {
 			glTexParameteri(type, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
 		// Upload the image data.
-		glTexImage3D(type, 0, GL_RGBA8, // target, mipmap level, internal format,
-			buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
-			0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
+		if(buffer.IsCompressed())
+			glCompressedTexImage3D(type, 0, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, // target, mipmap level, internal format,
+				buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
+				0, buffer.CompressedBlocks().size(), buffer.CompressedBlocks().data()); // border, data size, data.
+		else
+			glTexImage3D(type, 0, GL_RGBA8, // target, mipmap level, internal format,
+				buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
+				0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
+		if(isMipmapped)
+			glGenerateMipmap(type);
+		GpuProfiler::CountUpload(buffer.IsCompressed() ? buffer.CompressedBlocks().size()
+			: sizeof(uint32_t) * buffer.Width() * buffer.Height() * buffer.Frames());
 
 		// Unbind the texture.
 		glBindTexture(type, 0);
@@ -65,6 +84,28 @@ namespace {
 
 
 
+// Whether an image of the given size is shrunk to half its size when it is
+// uploaded, according to the "Reduce large graphics" preference.
+bool Sprite::IsReduced(int width, int height, bool noReduction)
+{
+	Preferences::LargeGraphicsReduction setting = Preferences::GetLargeGraphicsReduction();
+	return !noReduction && (setting == Preferences::LargeGraphicsReduction::ALL
+		|| (setting == Preferences::LargeGraphicsReduction::LARGEST_ONLY && width * height >= 1000000));
+}
+
+
+
+// Whether textures get smaller copies of themselves for drawing at a distance.
+// The driver can only make them for uncompressed textures, and only in a
+// texture array keeps each frame's copies apart, instead of blending them
+// with the frames next to it.
+bool Sprite::IsMipmapped(bool isCompressed)
+{
+	return !isCompressed && OpenGL::HasTexture2DArraySupport();
+}
+
+
+
 Sprite::Sprite(const string &name)
 	: name(name)
 {
@@ -104,19 +145,20 @@ void Sprite::AddFrames(ImageBuffer &buffer1x, ImageBuffer &buffer2x, bool noRedu
 	width = buffer1x.Width();
 	height = buffer1x.Height();
 	frames = buffer1x.Frames();
-	// Do nothing else if the buffer is empty.
-	// (The buffer can be empty yet still have a width and height if uploading is disabled.)
-	if(!buffer1x.Pixels())
+	// Do nothing else if the buffers are empty.
+	// (The buffer can be empty yet still have a width and height if uploading is disabled,
+	// and the 1x buffer only has its dimensions if the 2x frames were already compressed.)
+	if(!buffer1x.HasData() && !buffer2x.HasData())
 		return;
 
 	// Only use the 2x resolution image if it is provided.
-	if(buffer2x.Pixels())
+	if(buffer2x.HasData())
 	{
-		AddBuffer(buffer2x, &texture, noReduction);
+		AddBuffer(buffer2x, &texture, noReduction, this);
 		buffer1x.Clear();
 	}
 	else
-		AddBuffer(buffer1x, &texture, noReduction);
+		AddBuffer(buffer1x, &texture, noReduction, this);
 }
 
 
@@ -167,6 +209,7 @@ void Sprite::Unload()
 		glDeleteTextures(1, &swizzleMask);
 		swizzleMask = 0;
 	}
+	SpriteAtlas::Remove(*this);
 	isLoaded = false;
 	// Dimension and frame information is retained.
 }
@@ -29,6 +29,15 @@ class ImageBuffer;
 // not be as efficient as sprite sheets, but with modern graphics cards it will
 // not matter much and it makes working with the graphics a lot simpler.
 class Sprite {
+public:
+	// Whether an image of the given size is shrunk to half its size when it is
+	// uploaded, according to the "Reduce large graphics" preference.
+	static bool IsReduced(int width, int height, bool noReduction);
+	// Whether a texture is uploaded along with smaller copies of itself, for
+	// drawing it at a fraction of its size.
+	static bool IsMipmapped(bool isCompressed);
+
+
 public:
 	explicit Sprite(const std::string &name = "");
 
@@ -0,0 +1,196 @@
+/* SpriteAtlas.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SpriteAtlas.h"
+
+#include "../shader/GpuProfiler.h"
+#include "ImageBuffer.h"
+#include "../opengl.h"
+#include "Sprite.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// Only sprites that are usually drawn by the BatchDrawList are atlased.
+	const string PREFIXES[] = {"projectile/", "effect/"};
+	// The largest sprite that is packed, in uploaded pixels.
+	constexpr int MAX_SIZE = 128;
+	constexpr int MAX_FRAMES = 16;
+	// Each sprite is surrounded by a copy of its edge pixels, so that linear
+	// filtering never blends in the neighboring sprites.
+	constexpr int PADDING = 1;
+
+	// A row of sprites within a page, all of which are at most as tall as it is.
+	struct Shelf {
+		int y;
+		int height;
+		int width;
+	};
+
+	// One array texture, which stores sprites with a single frame count.
+	struct Page {
+		uint32_t texture;
+		int size;
+		vector<Shelf> shelves;
+		int height = 0;
+	};
+
+	mutex atlasMutex;
+	// The pages for each frame count.
+	map<int, vector<Page>> pages;
+	unordered_map<const Sprite *, SpriteAtlas::Region> regions;
+
+	// Pages are kept to four megabytes or less, so that a page that only has a
+	// few sprites in it wastes little memory.
+	int PageSize(int frames)
+	{
+		return frames == 1 ? 1024 : frames <= 4 ? 512 : 256;
+	}
+
+	bool IsEligible(const Sprite &sprite, const ImageBuffer &buffer)
+	{
+		if(!buffer.Pixels() || buffer.Frames() > MAX_FRAMES
+				|| buffer.Width() > MAX_SIZE || buffer.Height() > MAX_SIZE)
+			return false;
+		for(const string &prefix : PREFIXES)
+			if(sprite.Name().starts_with(prefix))
+				return true;
+		return false;
+	}
+
+	// Find room for a rectangle of the given size in a page, if there is any.
+	// The shelf with the least wasted height is used.
+	bool Allocate(Page &page, int width, int height, int &x, int &y)
+	{
+		Shelf *best = nullptr;
+		for(Shelf &shelf : page.shelves)
+			if(shelf.height >= height && page.size - shelf.width >= width
+					&& (!best || shelf.height < best->height))
+				best = &shelf;
+		if(!best)
+		{
+			if(page.size - page.height < height)
+				return false;
+			page.shelves.push_back({page.height, height, 0});
+			page.height += height;
+			best = &page.shelves.back();
+		}
+		x = best->width;
+		y = best->y;
+		best->width += width;
+		return true;
+	}
+
+	Page CreatePage(int frames)
+	{
+		Page page;
+		page.size = PageSize(frames);
+
+		int type = OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D;
+		glGenTextures(1, &page.texture);
+		glBindTexture(type, page.texture);
+		glTexParameteri(type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		if(type == GL_TEXTURE_3D)
+			glTexParameteri(type, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		glTexImage3D(type, 0, GL_RGBA8, page.size, page.size, frames, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindTexture(type, 0);
+
+		return page;
+	}
+}
+
+
+
+// Copy the given frames into the atlas, if the sprite is eligible for it.
+// This must be called from the thread that owns the OpenGL context.
+void SpriteAtlas::Add(const Sprite &sprite, const ImageBuffer &buffer)
+{
+	if(!IsEligible(sprite, buffer))
+		return;
+
+	const int width = buffer.Width() + 2 * PADDING;
+	const int height = buffer.Height() + 2 * PADDING;
+	const int frames = buffer.Frames();
+
+	lock_guard<mutex> lock(atlasMutex);
+	vector<Page> &list = pages[frames];
+	int x = 0;
+	int y = 0;
+	auto it = find_if(list.begin(), list.end(),
+		[&](Page &page) { return Allocate(page, width, height, x, y); });
+	if(it == list.end())
+	{
+		list.push_back(CreatePage(frames));
+		it = prev(list.end());
+		Allocate(*it, width, height, x, y);
+	}
+
+	// Copy the frames with their edges extended into the padding.
+	vector<uint32_t> padded(static_cast<size_t>(width) * height * frames);
+	uint32_t *out = padded.data();
+	for(int frame = 0; frame < frames; ++frame)
+		for(int row = 0; row < height; ++row)
+		{
+			const uint32_t *in = buffer.Begin(clamp(row - PADDING, 0, buffer.Height() - 1), frame);
+			for(int column = 0; column < width; ++column)
+				*out++ = in[clamp(column - PADDING, 0, buffer.Width() - 1)];
+		}
+
+	int type = OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D;
+	glBindTexture(type, it->texture);
+	glTexSubImage3D(type, 0, x, y, 0, width, height, frames, GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+	glBindTexture(type, 0);
+	GpuProfiler::CountUpload(padded.size() * sizeof(uint32_t));
+
+	const float scale = 1.f / it->size;
+	Region &region = regions[&sprite];
+	region.texture = it->texture;
+	region.frames = frames;
+	region.left = (x + PADDING) * scale;
+	region.top = (y + PADDING) * scale;
+	region.right = (x + width - PADDING) * scale;
+	region.bottom = (y + height - PADDING) * scale;
+}
+
+
+
+// Stop drawing the given sprite from the atlas. Its space is not reused.
+void SpriteAtlas::Remove(const Sprite &sprite)
+{
+	lock_guard<mutex> lock(atlasMutex);
+	regions.erase(&sprite);
+}
+
+
+
+// Find the region of the atlas that contains the given sprite, if any.
+optional<SpriteAtlas::Region> SpriteAtlas::Find(const Sprite *sprite)
+{
+	lock_guard<mutex> lock(atlasMutex);
+	auto it = regions.find(sprite);
+	if(it == regions.end())
+		return nullopt;
+	return it->second;
+}
@@ -0,0 +1,56 @@
+/* SpriteAtlas.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+class ImageBuffer;
+class Sprite;
+
+
+
+// A set of shared array textures that small sprites are packed into when they
+// are uploaded, so that the BatchDrawList can draw many different projectiles
+// and effects with a single draw call. Each frame of a sprite occupies the same
+// rectangle in consecutive layers of the texture, starting with the first, so
+// sprites are grouped into pages by their frame count. Atlased sprites still
+// have their own texture as well, since most other shaders expect to sample
+// the whole texture.
+class SpriteAtlas {
+public:
+	// The part of an atlas page that contains a certain sprite.
+	class Region {
+	public:
+		uint32_t texture = 0;
+		int frames = 0;
+		// The texture coordinates of the sprite's top left and bottom right corners.
+		float left = 0.f;
+		float top = 0.f;
+		float right = 1.f;
+		float bottom = 1.f;
+	};
+
+
+public:
+	// Copy the given frames into the atlas, if the sprite is eligible for it.
+	// This must be called from the thread that owns the OpenGL context.
+	static void Add(const Sprite &sprite, const ImageBuffer &buffer);
+	// Stop drawing the given sprite from the atlas. Its space is not reused.
+	static void Remove(const Sprite &sprite);
+	// Find the region of the atlas that contains the given sprite, if any.
+	static std::optional<Region> Find(const Sprite *sprite);
+};
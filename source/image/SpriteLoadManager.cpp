@@ -15,16 +15,26 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "SpriteLoadManager.h"
 
+#include "../DistanceMap.h"
 #include "ImageSet.h"
+#include "../Planet.h"
+#include "../PlayerInfo.h"
 #include "../Preferences.h"
+#include "../Ship.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
+#include "../StartupProfile.h"
+#include "../StellarObject.h"
+#include "../System.h"
 #include "../TaskQueue.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <map>
 #include <queue>
 #include <set>
+#include <vector>
 
 using namespace std;
 
@@ -45,17 +55,27 @@ namespace {
 	set<string> deferredFolders;
 	// The sprites that use deferred loading.
 	map<const Sprite *, shared_ptr<ImageSet>> deferred;
-	// Up to 20 landscape images will be preloaded at a time, with the oldest being culled to make room for new ones.
-	const int LANDSCAPE_LIMIT = 20;
-	map<const Sprite *, int> preloadedLandscapes;
-	// Stellar objects and thumbnails remain loaded for up to 100 in-game days before they're culled. This prevents
-	// us from repeatedly reloading sprites that the player is frequently encountering.
-	const int DAY_LIMIT = 100;
-	map<const Sprite *, int> loadedStellarObjects;
-	map<const Sprite *, int> loadedThumbnails;
-	// Scenes remain loaded for only one in-game day before they're culled, as they are not commonly requested.
-	// Most scenes are only ever used in a single conversation, for example.
-	set<const Sprite *> loadedScenes;
+
+	// Deferred sprites stay loaded until they no longer fit in this much video
+	// memory. Then, the ones that cost the most to keep and were requested the
+	// longest ago are unloaded first.
+	const int64_t VRAM_BUDGET = int64_t(768) << 20;
+	// How many systems along the player's travel plan to prefetch sprites for.
+	const int PREFETCH_JUMPS = 3;
+	class LoadedSprite {
+	public:
+		// An estimate of how much video memory the sprite takes up.
+		int64_t bytes;
+		// The value of the request clock when this sprite was last requested.
+		int64_t lastUse;
+	};
+	map<const Sprite *, LoadedSprite> loadedSprites;
+	int64_t vramUsed = 0;
+	// This counts up with each request for a deferred sprite.
+	int64_t requestClock = 0;
+	// Sprites requested at or after this time are needed for the current
+	// system (or a panel shown in it), so they are never unloaded.
+	int64_t inUseSince = 0;
 	// Missions and events can add new sprites to the player's current area that may need to be loaded.
 	// The code that makes these changes may not have access to the TaskQueue in UI, so they
 	// instead send a message to the SpriteLoadManager to tell the current Panel to recheck which
@@ -83,6 +103,68 @@ namespace {
 		queue.Run({}, [name = sprite->Name()] { SpriteSet::Modify(name)->Unload(); });
 	}
 
+	// Estimate how much video memory the given sprite will take up once it is
+	// loaded, from the dimensions that were read when the game started.
+	int64_t EstimateBytes(const Sprite *sprite)
+	{
+		int64_t pixels = static_cast<int64_t>(sprite->Width()) * static_cast<int64_t>(sprite->Height());
+		if(Sprite::IsReduced(sprite->Width(), sprite->Height(), false))
+			pixels /= 4;
+		// The smaller copies of a mipmapped texture add up to a third of its size.
+		if(Sprite::IsMipmapped(false))
+			pixels += pixels / 3;
+		return pixels * max(1, sprite->Frames()) * 4;
+	}
+
+	// Unload the sprites that are not in use, from the one that costs the most to keep
+	// to the one that costs the least, until the given number of bytes will fit in the
+	// budget. The cost of a sprite is its size times how long ago it was requested.
+	// Return false if there is no way to make enough room.
+	bool MakeRoom(TaskQueue &queue, int64_t bytes)
+	{
+		if(vramUsed + bytes <= VRAM_BUDGET)
+			return true;
+
+		vector<pair<double, const Sprite *>> candidates;
+		for(const auto &[sprite, loaded] : loadedSprites)
+			if(loaded.lastUse < inUseSince)
+				candidates.emplace_back(static_cast<double>(loaded.bytes) * (requestClock - loaded.lastUse), sprite);
+		sort(candidates.begin(), candidates.end(), greater<>());
+
+		for(const auto &[cost, sprite] : candidates)
+		{
+			if(vramUsed + bytes <= VRAM_BUDGET)
+				break;
+			auto it = loadedSprites.find(sprite);
+			vramUsed -= it->second.bytes;
+			loadedSprites.erase(it);
+			UnloadSprite(queue, sprite);
+		}
+		return vramUsed + bytes <= VRAM_BUDGET;
+	}
+
+	// Mark that the given deferred sprite was requested at the given time, loading
+	// it if it is not loaded already. Unless the sprite is needed right away, it
+	// is only loaded if there is room for it in the budget.
+	bool Request(TaskQueue &queue, const Sprite *sprite, const shared_ptr<ImageSet> &image,
+		int64_t time, bool isNeeded)
+	{
+		auto it = loadedSprites.find(sprite);
+		if(it != loadedSprites.end())
+		{
+			it->second.lastUse = max(it->second.lastUse, time);
+			return true;
+		}
+
+		int64_t bytes = EstimateBytes(sprite);
+		if(!MakeRoom(queue, bytes) && !isNeeded)
+			return false;
+		loadedSprites[sprite] = {bytes, time};
+		vramUsed += bytes;
+		SpriteLoadManager::LoadSprite(queue, image);
+		return true;
+	}
+
 	// Functions for queueing the loading of sprites at game start.
 	void LoadSpriteQueued(TaskQueue &queue, const shared_ptr<ImageSet> &image);
 	// Loads a sprite from the image queue, recursively.
@@ -134,6 +216,7 @@ namespace {
 
 void SpriteLoadManager::Init(TaskQueue &queue, map<string, shared_ptr<ImageSet>> images)
 {
+	StartupProfile::Scope scope("SpriteLoadManager::Init");
 	// From the name, strip out any frame number, plus the extension.
 	for(auto &[name, imageSet] : images)
 	{
@@ -218,42 +301,72 @@ void SpriteLoadManager::LoadDeferred(TaskQueue &queue, const Sprite *sprite)
 	if(!sprite || dit == deferred.end())
 		return;
 
-	const string &name = sprite->Name();
-	const shared_ptr<ImageSet> &image = dit->second;
-	if(name.starts_with("land/"))
-		LoadLandscape(queue, sprite, image);
-	else if(name.starts_with("thumbnail/") || name.starts_with("outfit/"))
-		LoadThumbnail(queue, sprite, image);
-	else if(name.starts_with("star/") || name.starts_with("planet/"))
-		LoadStellarObject(queue, sprite, image);
-	else if(name.starts_with("scene/"))
-		LoadScene(queue, sprite, image);
+	Request(queue, sprite, dit->second, ++requestClock, true);
 }
 
 
 
-void SpriteLoadManager::CullOldImages(TaskQueue &queue)
+// Prefetch the sprites the player is likely to need soon: those of the current
+// system, of the next few systems in the travel plan, and of the systems that can
+// be reached from here in a single jump. The sooner a sprite will be needed, the
+// sooner it is loaded, and the later it is unloaded. Anything requested before
+// this that is not needed again may now be unloaded to stay within the budget.
+void SpriteLoadManager::Prefetch(TaskQueue &queue, const PlayerInfo &player)
 {
-	auto Cull = [&queue](map<const Sprite *, int> &loadedSprites) -> void {
-		for(auto it = loadedSprites.begin(); it != loadedSprites.end(); )
+	const System *system = player.GetSystem();
+	if(!system)
+		return;
+
+	// Find how many jumps away each sprite will be needed.
+	map<const Sprite *, double> timeToNeed;
+	auto AddSystem = [&timeToNeed](const System *system, double time) -> void
+	{
+		for(const StellarObject &object : system->Objects())
 		{
-			++it->second;
-			if(it->second >= DAY_LIMIT)
+			if(object.HasSprite() && IsDeferred(object.GetSprite()))
 			{
-				UnloadSprite(queue, it->first);
-				it = loadedSprites.erase(it);
+				auto it = timeToNeed.emplace(object.GetSprite(), time).first;
+				it->second = min(it->second, time);
+			}
+			// A landscape is only needed once the player lands.
+			if(object.HasValidPlanet() && IsDeferred(object.GetPlanet()->Landscape()))
+			{
+				auto it = timeToNeed.emplace(object.GetPlanet()->Landscape(), time + .5).first;
+				it->second = min(it->second, time + .5);
 			}
-			else
-				++it;
 		}
 	};
-
-	Cull(loadedStellarObjects);
-	Cull(loadedThumbnails);
-
-	for(const Sprite *sprite : loadedScenes)
-		UnloadSprite(queue, sprite);
-	loadedScenes.clear();
+	AddSystem(system, 0.);
+	// The travel plan is stored in reverse order, with the next system last.
+	const vector<const System *> &plan = player.TravelPlan();
+	for(int i = 0; i < PREFETCH_JUMPS && i < static_cast<int>(plan.size()); ++i)
+		AddSystem(plan[plan.size() - 1 - i], i + 1.);
+	// The neighboring systems are less likely to be visited if there is a plan.
+	const Ship *flagship = player.Flagship();
+	const bool hasJumpDrive = flagship && flagship->JumpNavigation().HasJumpDrive();
+	const double neighborTime = plan.empty() ? 1. : 2.;
+	for(const System *neighbor : DistanceMap(system, WormholeStrategy::ONLY_UNRESTRICTED, hasJumpDrive, -1, 1).Systems())
+		if(neighbor != system)
+			AddSystem(neighbor, neighborTime);
+
+	vector<pair<double, const Sprite *>> order;
+	order.reserve(timeToNeed.size());
+	for(const auto &[sprite, time] : timeToNeed)
+		order.emplace_back(time, sprite);
+	sort(order.begin(), order.end());
+
+	// Everything requested from here on counts as being in use, and the sprites
+	// needed soonest count as the most recently requested.
+	inUseSince = requestClock + 1;
+	requestClock += order.size();
+	for(size_t i = 0; i < order.size(); ++i)
+	{
+		const auto &[time, sprite] = order[i];
+		// Anything in the current system is needed right away, so it is loaded even if
+		// it doesn't fit. Prefetching stops once nothing else can be made room for.
+		if(!Request(queue, sprite, deferred.find(sprite)->second, requestClock - i, time < 1.))
+			break;
+	}
 }
 
 
@@ -288,80 +401,3 @@ bool SpriteLoadManager::RecheckStellarObjects()
 	recheckStellarObjects = false;
 	return ret;
 }
-
-
-
-void SpriteLoadManager::LoadLandscape(TaskQueue &queue, const Sprite *sprite, const shared_ptr<ImageSet> &image)
-{
-	// If this sprite is one of the currently loaded ones, there is no need to
-	// load it again. But, make note of the fact that it is the most recently
-	// asked-for sprite.
-	map<const Sprite *, int>::iterator pit = preloadedLandscapes.find(sprite);
-	if(pit != preloadedLandscapes.end())
-	{
-		for(pair<const Sprite *const, int> &it : preloadedLandscapes)
-			if(it.second < pit->second)
-				++it.second;
-
-		pit->second = 0;
-		return;
-	}
-
-	// This sprite is not currently preloaded. Check to see whether we already
-	// have the maximum number of sprites loaded, in which case the oldest one
-	// must be unloaded to make room for this one.
-	pit = preloadedLandscapes.begin();
-	while(pit != preloadedLandscapes.end())
-	{
-		++pit->second;
-		if(pit->second >= LANDSCAPE_LIMIT)
-		{
-			UnloadSprite(queue, pit->first);
-			pit = preloadedLandscapes.erase(pit);
-		}
-		else
-			++pit;
-	}
-
-	// Now, load all the files for this sprite.
-	preloadedLandscapes[sprite] = 0;
-	LoadSprite(queue, image);
-}
-
-
-
-void SpriteLoadManager::LoadStellarObject(TaskQueue &queue, const Sprite *sprite, const shared_ptr<ImageSet> &image)
-{
-	map<const Sprite *, int>::iterator it = loadedStellarObjects.find(sprite);
-	if(it != loadedStellarObjects.end())
-	{
-		it->second = 0;
-		return;
-	}
-	loadedStellarObjects[sprite] = 0;
-	LoadSprite(queue, image);
-}
-
-
-
-void SpriteLoadManager::LoadThumbnail(TaskQueue &queue, const Sprite *sprite, const shared_ptr<ImageSet> &image)
-{
-	map<const Sprite *, int>::iterator it = loadedThumbnails.find(sprite);
-	if(it != loadedThumbnails.end())
-	{
-		it->second = 0;
-		return;
-	}
-	loadedThumbnails[sprite] = 0;
-	LoadSprite(queue, image);
-}
-
-
-
-void SpriteLoadManager::LoadScene(TaskQueue &queue, const Sprite *sprite, const shared_ptr<ImageSet> &image)
-{
-	if(!loadedScenes.insert(sprite).second)
-		return;
-
-	LoadSprite(queue, image);
-}
@@ -28,6 +28,8 @@ class TaskQueue;
 
 // The class responsible for loading sprites at the start of the game, and
 // for managing the loading and unloading of sprites that use deferred loading.
+// Deferred sprites are kept loaded within a budget of video memory, and the ones
+// the player is likely to need soon are loaded before they are asked for.
 class SpriteLoadManager {
 public:
 	static void Init(TaskQueue &queue, std::map<std::string, std::shared_ptr<ImageSet>> images);
@@ -43,8 +45,12 @@ public:
 	// Begin loading a sprite that was previously deferred. This is done for various images to speed up
 	// the program's startup and reduce VRAM usage.
 	static void LoadDeferred(TaskQueue &queue, const Sprite *sprite);
-	// Cull old stellar objects and thumbnails that haven't been seen in a while.
-	static void CullOldImages(TaskQueue &queue);
+	// Prefetch the sprites the player is likely to need soon: those of the current
+	// system, of the next few systems in the travel plan, and of the systems that can
+	// be reached from here in a single jump. The sooner a sprite will be needed, the
+	// sooner it is loaded, and the later it is unloaded. Anything requested before
+	// this that is not needed again may now be unloaded to stay within the budget.
+	static void Prefetch(TaskQueue &queue, const PlayerInfo &player);
 
 	// Changes can be made by missions or events that cause new assets to appear.
 	// When this happens, a class can signal to the SpriteLoadManager than a panel
@@ -53,16 +59,4 @@ public:
 	static bool RecheckThumbnails();
 	static void SetRecheckStellarObjects();
 	static bool RecheckStellarObjects();
-
-
-private:
-	// Preload a landscape image. If 20 landscape images have already been preloaded
-	// previously, unload the least recently seen image.
-	static void LoadLandscape(TaskQueue &queue, const Sprite *sprite, const std::shared_ptr<ImageSet> &image);
-	// Load a stellar object. Stellar objects remain loaded for 100 in-game days.
-	static void LoadStellarObject(TaskQueue &queue, const Sprite *sprite, const std::shared_ptr<ImageSet> &image);
-	// Load a ship or outfit thumbnail. Stellar objects remain loaded for 100 in-game days.
-	static void LoadThumbnail(TaskQueue &queue, const Sprite *sprite, const std::shared_ptr<ImageSet> &image);
-	// Load a starting scenario, conversation, or logbook scene.
-	static void LoadScene(TaskQueue &queue, const Sprite *sprite, const std::shared_ptr<ImageSet> &image);
 };
@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Logger.h"
 #include "Sprite.h"
+#include "../StartupProfile.h"
 
 #include <map>
 #include <mutex>
@@ -40,6 +41,7 @@ const Sprite *SpriteSet::Get(const string &name)
 
 void SpriteSet::CheckReferences()
 {
+	StartupProfile::Scope scope("SpriteSet::CheckReferences");
 	for(const auto &[name, sprite] : sprites)
 		if(!sprite.HasDimensions())
 			Logger::Log("Image \"" + name + "\" is referred to, but has no pixels.", Logger::Level::WARNING);
@@ -0,0 +1,161 @@
+/* TextureCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "TextureCache.h"
+
+#include "../DiskCache.h"
+#include "ImageBuffer.h"
+#include "../opengl.h"
+#include "../Preferences.h"
+#include "Sprite.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+using namespace std;
+
+namespace {
+	// This must be changed whenever the layout of the cached files changes.
+	const char MAGIC[8] = {'E', 'S', 'T', 'E', 'X', 'B', 'C', '3'};
+
+	// The values stored in front of the compressed blocks of a cached texture.
+	// The header is written out byte for byte, so it must have no implicit
+	// padding, which would hold whatever happened to be in memory.
+	struct Header {
+		char magic[8];
+		uint64_t key;
+		int32_t baseWidth;
+		int32_t baseHeight;
+		int32_t width;
+		int32_t height;
+		int32_t frames;
+		int32_t unused;
+		uint64_t size;
+	};
+	static_assert(sizeof(Header) == 48, "The texture cache header must not have any padding.");
+
+	// Identify the exact contents of the given image files and the way they
+	// will be reduced. Returns 0 if they can't be cached: if any of them is
+	// missing, or is an image sequence, whose frame count isn't known in advance.
+	uint64_t Key(const vector<filesystem::path> &paths, bool noReduction)
+	{
+		uint64_t key = DiskCache::Hash("");
+		for(const filesystem::path &path : paths)
+		{
+			const string extension = path.extension().string();
+			if(extension == ".avif" || extension == ".avifs")
+				return 0;
+			error_code error;
+			const uint64_t size = filesystem::file_size(path, error);
+			if(error)
+				return 0;
+			const int64_t timestamp = filesystem::last_write_time(path, error).time_since_epoch().count();
+			if(error)
+				return 0;
+			key = DiskCache::Hash(path.string(), key);
+			key = DiskCache::HashValue(size, key);
+			key = DiskCache::HashValue(timestamp, key);
+		}
+		const int reduction = static_cast<int>(Preferences::GetLargeGraphicsReduction());
+		key = DiskCache::HashValue(reduction, key);
+		return DiskCache::HashValue(noReduction, key);
+	}
+
+	// The file in which the texture decoded from the given image files is cached.
+	filesystem::path CachePath(const vector<filesystem::path> &paths)
+	{
+		return DiskCache::Path(DiskCache::Hash(paths.front().string()), ".tex");
+	}
+}
+
+
+
+// Whether sprite textures should be compressed.
+bool TextureCache::IsEnabled()
+{
+	return Preferences::Has("Compress sprite textures") && OpenGL::HasS3TCSupport();
+}
+
+
+
+// Load the compressed texture decoded from the given image files, if it is
+// up to date. The dimensions of the sprite's 1x frames are stored in base.
+bool TextureCache::Load(const vector<filesystem::path> &paths, bool noReduction,
+	ImageBuffer &base, ImageBuffer &texture)
+{
+	if(paths.empty())
+		return false;
+	const uint64_t key = Key(paths, noReduction);
+	if(!key)
+		return false;
+
+	const filesystem::path cachePath = CachePath(paths);
+	ifstream in(cachePath, ios::in | ios::binary);
+	Header header;
+	if(!in.read(reinterpret_cast<char *>(&header), sizeof(header)) || memcmp(header.magic, MAGIC, sizeof(MAGIC))
+			|| header.key != key || header.frames != texture.Frames() || header.width <= 0 || header.height <= 0)
+	{
+		DiskCache::Miss("textures");
+		return false;
+	}
+	// Make sure a corrupt file can't cause a huge allocation.
+	const uint64_t blocks = static_cast<uint64_t>((header.width + 3) / 4) * ((header.height + 3) / 4) * header.frames;
+	vector<uint8_t> data(header.size == 16 * blocks ? header.size : 0);
+	if(data.empty() || !in.read(reinterpret_cast<char *>(data.data()), data.size()))
+	{
+		DiskCache::Miss("textures");
+		return false;
+	}
+	DiskCache::Hit("textures", cachePath);
+
+	if(&base != &texture)
+		base.SetDimensions(header.baseWidth, header.baseHeight);
+	texture.SetCompressed(header.width, header.height, std::move(data));
+	return true;
+}
+
+
+
+// Reduce the given texture if needed, compress it, and store it in the cache.
+void TextureCache::Compress(const vector<filesystem::path> &paths, bool noReduction,
+	const ImageBuffer &base, ImageBuffer &texture)
+{
+	if(!texture.Pixels())
+		return;
+	if(Sprite::IsReduced(texture.Width(), texture.Height(), noReduction))
+		texture.ShrinkToHalfSize();
+	texture.Compress();
+
+	const uint64_t key = paths.empty() ? 0 : Key(paths, noReduction);
+	if(!key)
+		return;
+
+	Header header{};
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.key = key;
+	header.baseWidth = base.Width();
+	header.baseHeight = base.Height();
+	header.width = texture.Width();
+	header.height = texture.Height();
+	header.frames = texture.Frames();
+	header.size = texture.CompressedBlocks().size();
+
+	string out(reinterpret_cast<const char *>(&header), sizeof(header));
+	out.append(reinterpret_cast<const char *>(texture.CompressedBlocks().data()), header.size);
+	DiskCache::Store(CachePath(paths), out);
+}
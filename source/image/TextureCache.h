@@ -0,0 +1,44 @@
+/* TextureCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+class ImageBuffer;
+
+
+
+// An on-disk cache of sprite textures that have already been decoded and
+// compressed into the BC3 (DXT5) format, which takes a quarter of the video
+// memory of uncompressed frames. Each sprite's frames are stored in the "cache"
+// folder of the config directory, along with the size and timestamp of every
+// image file they were decoded from. If any of those files change, the frames
+// are decoded and compressed again. Compression is only used if the player has
+// enabled it and the GPU supports it, since it slightly reduces image quality.
+class TextureCache {
+public:
+	// Whether sprite textures should be compressed.
+	static bool IsEnabled();
+
+	// Load the compressed texture decoded from the given image files, if it is
+	// up to date. The dimensions of the sprite's 1x frames are stored in base.
+	static bool Load(const std::vector<std::filesystem::path> &paths, bool noReduction,
+		ImageBuffer &base, ImageBuffer &texture);
+	// Reduce the given texture if needed, compress it, and store it in the cache.
+	static void Compress(const std::vector<std::filesystem::path> &paths, bool noReduction,
+		const ImageBuffer &base, ImageBuffer &texture);
+};
@@ -15,14 +15,18 @@ You should have received a copy of the GNU General Public License along with
 this program. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "text/Alignment.h"
 #include "audio/Audio.h"
+#include "BinaryDataFile.h"
 #include "Command.h"
 #include "Conversation.h"
 #include "CustomEvents.h"
 #include "DataFile.h"
 #include "DataNode.h"
+#include "DiskCache.h"
 #include "Engine.h"
 #include "Files.h"
+#include "shader/FillShader.h"
 #include "text/Font.h"
 #include "text/FontSet.h"
 #include "text/Format.h"
@@ -31,19 +35,28 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameLoadingPanel.h"
 #include "GameVersion.h"
 #include "GameWindow.h"
+#include "shader/GpuProfiler.h"
 #include "Interface.h"
 #include "Logger.h"
 #include "MainPanel.h"
+#include "MemoryProfile.h"
 #include "MenuPanel.h"
+#include "PackFile.h"
 #include "Panel.h"
 #include "PlayerInfo.h"
 #include "Plugins.h"
 #include "Preferences.h"
 #include "PrintData.h"
+#include "Profiler.h"
+#include "Random.h"
 #include "Screen.h"
 #include "image/SpriteSet.h"
 #include "shader/SpriteShader.h"
+#include "StartupProfile.h"
+#include "text/Table.h"
 #include "TaskQueue.h"
+#include "test/Benchmark.h"
+#include "test/InputRecording.h"
 #include "test/Test.h"
 #include "test/TestContext.h"
 #include "UI.h"
@@ -54,9 +67,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "windows/WinVersion.h"
 #endif
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <stdexcept>
 
 #include <cassert>
 #include <future>
@@ -85,9 +102,10 @@ using namespace std;
 void PrintHelp();
 void PrintVersion();
 void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversation,
-	const string &testToRun, bool debugMode);
+	const string &testToRun, bool debugMode, Benchmark *benchmark, InputRecording *recording, bool watchData);
 Conversation LoadConversation(const PlayerInfo &player);
 void PrintTestsTable();
+void DrawPassTotals(const vector<GpuProfiler::Total> &totals);
 
 
 
@@ -109,6 +127,13 @@ int main(int argc, char *argv[])
 	bool printData = false;
 	bool noTestMute = false;
 	string testToRunName;
+	int benchmarkFrames = 0;
+	string recordPath;
+	string replayPath;
+	bool watchData = false;
+	string saveToConvert;
+	string packSource;
+	string packPath;
 
 	// Whether the game has encountered errors while loading.
 	bool hasErrors = false;
@@ -146,12 +171,78 @@ int main(int argc, char *argv[])
 			printTests = true;
 		else if(arg == "--nomute")
 			noTestMute = true;
+		else if(arg == "--profile" && *++it)
+			Profiler::Enable(*it);
+		else if(arg == "--watch")
+			watchData = true;
+		else if(arg == "--startup-profile" && *++it)
+			StartupProfile::Enable(*it);
+		else if(arg == "--benchmark" && *++it)
+			benchmarkFrames = max(1, atoi(*it));
+		else if(arg == "--record" && *++it)
+			recordPath = *it;
+		else if(arg == "--replay" && *++it)
+			replayPath = *it;
+		else if(arg == "--convert-save" && *++it)
+			saveToConvert = *it;
+		else if(arg == "--memory-report" && *++it)
+			MemoryProfile::Enable(*it);
+		else if(arg == "--build-pack" && it[1] && it[2])
+		{
+			packSource = *++it;
+			packPath = *++it;
+		}
 	}
+	// Packing resources does not need the game's own resources to be found.
+	if(!packSource.empty())
+		return PackFile::Build(packSource, packPath) ? 0 : 1;
 	printData = PrintData::IsPrintDataArgument(argv);
 	Files::Init(argv);
 
+	// Converting a saved game between the text and binary formats needs no game data.
+	if(!saveToConvert.empty())
+		return BinaryDataFile::Convert(saveToConvert) ? 0 : 1;
+
 	// Whether we are running an integration test.
 	const bool isTesting = !testToRunName.empty();
+	// The player's commands can be recorded after a test has set up the scenario,
+	// and replayed from the same point later.
+	unique_ptr<InputRecording> recording;
+	if(!recordPath.empty() || !replayPath.empty())
+	{
+		if(!isTesting)
+		{
+			cerr << "The --record and --replay options require a test to set up the scenario with --test." << endl;
+			return 1;
+		}
+		try {
+			if(!replayPath.empty())
+				recording = make_unique<InputRecording>(replayPath, true);
+			else
+				recording = make_unique<InputRecording>(recordPath, false);
+		}
+		catch(const runtime_error &error)
+		{
+			cerr << error.what() << endl;
+			return 1;
+		}
+		// Unless asked for a different number of frames, time the whole replay.
+		if(recording->IsReplay() && !benchmarkFrames)
+			benchmarkFrames = recording->Steps();
+		Random::SetDeterministic(true);
+	}
+	// A benchmark times the frames simulated after its test has set up the scenario.
+	unique_ptr<Benchmark> benchmark;
+	if(benchmarkFrames)
+	{
+		if(!isTesting)
+		{
+			cerr << "The --benchmark option requires a test to set up the scenario with --test." << endl;
+			return 1;
+		}
+		benchmark = make_unique<Benchmark>(benchmarkFrames);
+		Random::SetDeterministic(true);
+	}
 	bool isConsoleOnly = loadOnly || printTests || printData;
 
 	Logger::Session logSession{isConsoleOnly || isTesting};
@@ -163,9 +254,18 @@ int main(int argc, char *argv[])
 
 		TaskQueue queue;
 
-		// Begin loading the game data.
+		// Begin loading the game data. Stock missions are only parsed in full once they
+		// are offered, unless every definition needs to be checked for errors. Printed
+		// data never includes missions, so they need not be parsed in full for it.
+		const bool checkEverything = loadOnly || printTests || checkAssets || isTesting || debugMode;
+		if(watchData && !isConsoleOnly && !isTesting)
+			GameData::WatchDataFiles();
 		auto dataFuture = GameData::BeginLoad(queue, player, isConsoleOnly, debugMode,
-			isConsoleOnly || checkAssets || (isTesting && !debugMode));
+			isConsoleOnly || checkAssets || (isTesting && !debugMode), !checkEverything);
+
+		// Sounds are loaded alongside the game data, unless none will be played.
+		if(checkAssets || (!isConsoleOnly && !benchmark))
+			Audio::LoadSounds(queue, GameData::Sources());
 
 		// If we are not using the UI, or performing some automated task, we should load
 		// all data now.
@@ -193,7 +293,6 @@ int main(int argc, char *argv[])
 		{
 			if(checkAssets)
 			{
-				Audio::LoadSounds(GameData::Sources());
 				while(GameData::GetProgress() < 1.)
 				{
 					queue.ProcessSyncTasks();
@@ -215,6 +314,9 @@ int main(int argc, char *argv[])
 			// then check the default state of the universe.
 			if(!player.LoadRecent())
 				GameData::CheckReferences();
+			StartupProfile::WriteReport(GameData::Sources());
+			MemoryProfile::WriteReport();
+			Logger::Flush();
 			cout << "Parse completed with " << (hasErrors ? "at least one" : "no") << " error(s)." << endl;
 			if(checkAssets)
 				Audio::Quit();
@@ -245,14 +347,16 @@ int main(int argc, char *argv[])
 			GameWindow::Step();
 		}
 
-		Audio::Init(GameData::Sources());
+		// A benchmark should not spend any time on audio.
+		if(!benchmark)
+			Audio::Init();
 
 		if(isTesting && !noTestMute)
 			Audio::SetVolume(0, SoundCategory::MASTER);
 
 		CustomEvents::Init();
 		// This is the main loop where all the action begins.
-		GameLoop(player, queue, conversation, testToRunName, debugMode);
+		GameLoop(player, queue, conversation, testToRunName, debugMode, benchmark.get(), recording.get(), watchData);
 	}
 	catch(Test::known_failure_tag)
 	{
@@ -265,12 +369,16 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 
+	Profiler::WriteTrace();
+	MemoryProfile::WriteReport();
+
 	// Remember the window state and preferences if quitting normally.
 	Preferences::Set("maximized", GameWindow::IsMaximized());
 	Preferences::Set("fullscreen", GameWindow::IsFullscreen());
 	Screen::SetRaw(GameWindow::Width(), GameWindow::Height(), true);
 	Preferences::Save();
 	Plugins::Save();
+	DiskCache::Trim();
 
 	Audio::Quit();
 	GameWindow::Quit();
@@ -281,7 +389,7 @@ int main(int argc, char *argv[])
 
 
 void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversation,
-		const string &testToRunName, bool debugMode)
+		const string &testToRunName, bool debugMode, Benchmark *benchmark, InputRecording *recording, bool watchData)
 {
 	// gamePanels is used for the main panel where you fly your spaceship.
 	// All other game content related dialogs are placed on top of the gamePanels.
@@ -297,6 +405,7 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 	// Whether the game data is done loading. This is used to trigger any
 	// tests to run.
 	bool dataFinishedLoading = false;
+	bool soundsFinishedLoading = false;
 	menuPanels.Push(new GameLoadingPanel(player, queue, conversation, gamePanels, dataFinishedLoading));
 
 	bool showCursor = true;
@@ -312,9 +421,11 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 	// Data to track progress of testing if/when a test is running.
 	TestContext testContext;
 	if(!testToRunName.empty())
-		testContext = TestContext(GameData::Tests().Get(testToRunName));
+		testContext = TestContext(GameData::Tests().Get(testToRunName), !benchmark && !recording);
 
-	const bool isHeadless = (testContext.CurrentTest() && !debugMode);
+	// The player needs to see the game to fly it while their commands are recorded.
+	const bool isRecording = recording && !recording->IsReplay();
+	const bool isHeadless = (testContext.CurrentTest() && !debugMode && !isRecording);
 
 	auto ProcessEvents = [&menuPanels, &gamePanels, &player, &cursorTime, &toggleTimeout, &debugMode, &isDebugPaused,
 			&isFastForward]
@@ -391,13 +502,46 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 		string cpuLoadString;
 		chrono::steady_clock::duration gpuLoadSum{};
 		string gpuLoadString;
+		string drawCallString;
+		string uploadString;
+		vector<GpuProfiler::Total> passTotals;
 		string memoryString;
+		string audioString;
+		string audioLossString;
+		string audioTimeString;
+		string frameTimeString;
+		string heapString;
 		bool isPerformanceDisplayReady = false;
 		int step = 0;
 		int drawStep = 0;
+		// When the next step should be calculated, if frames are drawn in between steps.
+		const chrono::steady_clock::duration stepTime = chrono::nanoseconds(1000000000 / 60);
+		chrono::steady_clock::time_point nextStep = chrono::steady_clock::now();
 
 		while(!menuPanels.IsDone())
 		{
+			// On displays that refresh faster than the game is simulated, vsync paces the
+			// frames, and the ones drawn in between steps show objects part of the way
+			// to where they will be in the next step.
+			MainPanel *flightPanel = static_cast<MainPanel *>(gamePanels.Root().get());
+			const bool isSmooth = flightPanel && Preferences::Has("Smooth high refresh rates")
+				&& Preferences::VSyncState() != Preferences::VSync::off
+				&& menuPanels.IsEmpty() && gamePanels.Root() == gamePanels.Top()
+				&& !isFastForward && !isDebugPaused && frameRate == 60 && !flightPanel->GetEngine().IsPaused();
+			chrono::steady_clock::time_point frameStart = chrono::steady_clock::now();
+			if(isSmooth && frameStart < nextStep)
+			{
+				ProcessEvents();
+				flightPanel->GetEngine().SetDrawProgress(
+					1. - chrono::duration<double>(nextStep - frameStart) / chrono::duration<double>(stepTime));
+				gamePanels.DrawAll();
+				flightPanel->GetEngine().SetDrawProgress(0.);
+				GameWindow::Step();
+				player.AddPlayTime(chrono::steady_clock::now() - frameStart);
+				continue;
+			}
+			nextStep = max(nextStep, frameStart - stepTime) + stepTime;
+
 			if(++step == 60)
 				step = 0;
 			if(toggleTimeout)
@@ -406,6 +550,23 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 
 			ProcessEvents();
 
+			// Once a second, reload any data files that have changed. This is only
+			// done while a menu is open, so that the universe doesn't change mid-flight.
+			if(watchData && !step && dataFinishedLoading && !menuPanels.IsEmpty() && GameData::HasChangedData())
+			{
+				// The main panel must be deleted first, so its background thread is no longer running.
+				gamePanels.Reset();
+				gamePanels.CanSave(true);
+
+				GameData::ReloadChangedData(player);
+
+				gamePanels.Push(new MainPanel(player));
+				// It takes one step to figure out the planet panel should be created, and
+				// another step to actually place it. So, take two steps to avoid a flicker.
+				gamePanels.StepAll();
+				gamePanels.StepAll();
+			}
+
 			SDL_Keymod mod = SDL_GetModState();
 			Font::ShowUnderlines(mod & KMOD_ALT);
 
@@ -427,8 +588,17 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 			if(Preferences::Has("Interrupt fast-forward") && !inFlight && isFastForward && !allowFastForward)
 				isFastForward = false;
 
+			// When fast-forwarding, only every third step is drawn, so the engine need
+			// not prepare anything for drawing the other two.
+			const bool skipsFrames = isFastForward && inFlight && !((mod & KMOD_CAPS) && debugMode);
+			if(MainPanel *mainPanel = static_cast<MainPanel *>(gamePanels.Root().get()))
+				mainPanel->GetEngine().SetDrawnSteps(!(skipsFrames && step % 3), !(skipsFrames && (step + 1) % 3));
+
 			// Tell all the panels to step forward, then draw them.
-			((!isDebugPaused && menuPanels.IsEmpty()) ? gamePanels : menuPanels).StepAll();
+			{
+				Profiler::Scope scope("Step panels");
+				((!isDebugPaused && menuPanels.IsEmpty()) ? gamePanels : menuPanels).StepAll();
+			}
 
 			// Caps lock slows the frame rate in debug mode.
 			// Slowing eases in and out over a couple of frames.
@@ -455,6 +625,14 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 				}
 			}
 
+			// The main menu is shown before all the sounds have loaded, so they are
+			// checked once the rest of them have finished loading in the background.
+			if(dataFinishedLoading && !soundsFinishedLoading && Audio::GetProgress() == 1.)
+			{
+				soundsFinishedLoading = true;
+				Audio::CheckReferences();
+				StartupProfile::WriteReport(GameData::Sources());
+			}
 			Audio::Step(isFastForward);
 
 			cpuLoadSum += chrono::steady_clock::now() - start;
@@ -463,7 +641,11 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 
 			// Events in this frame may have cleared out the menu, in which case
 			// we should draw the game panels instead:
-			(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
+			GpuProfiler::SetTimingEnabled(Preferences::Has("Show CPU / GPU load") || Profiler::IsEnabled());
+			{
+				GpuProfiler::Pass pass("Draw panels");
+				(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
+			}
 
 			MainPanel *mainPanel = static_cast<MainPanel *>(gamePanels.Root().get());
 			if(mainPanel && mainPanel->GetEngine().IsPaused())
@@ -478,11 +660,20 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 				Information performanceInfo;
 				performanceInfo.SetString("cpu", cpuLoadString);
 				performanceInfo.SetString("gpu", gpuLoadString);
+				performanceInfo.SetString("draws", drawCallString);
+				performanceInfo.SetString("upload", uploadString);
 				performanceInfo.SetString("mem", memoryString);
+				performanceInfo.SetString("audio", audioString);
+				performanceInfo.SetString("audio loss", audioLossString);
+				performanceInfo.SetString("audio time", audioTimeString);
+				performanceInfo.SetString("frames", frameTimeString);
+				performanceInfo.SetString("heap", heapString);
 				if(isPerformanceDisplayReady)
 					performanceInfo.SetCondition("ready");
 				static const Interface &performanceDisplay = *GameData::Interfaces().Get("performance info");
 				performanceDisplay.Draw(performanceInfo);
+				if(isPerformanceDisplayReady)
+					DrawPassTotals(passTotals);
 				if(drawStep == 60)
 				{
 					drawStep = 0;
@@ -495,10 +686,19 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 					cpuLoadString = "CPU: " + Format::Number(cpuNano / (isFastForward && inFlight ? 1.8e8 : 6e7), 2, false)
 						+ " ms (" + Format::Percentage(cpuNano / 1e9, 0) + ")";
 					cpuLoadSum = {};
-					auto gpuNano = chrono::duration_cast<chrono::nanoseconds>(gpuLoadSum).count();
+					// If the GPU's own clock can be read, show how long it spent drawing
+					// rather than how long the CPU spent issuing the commands.
+					const GpuProfiler::Total frameTotal = GpuProfiler::FrameTotal();
+					auto gpuNano = GpuProfiler::IsTiming() ? frameTotal.gpuTime.count() * 60
+						: chrono::duration_cast<chrono::nanoseconds>(gpuLoadSum).count();
 					gpuLoadString = "GPU: " + Format::Number(gpuNano / 6e7, 2, false)
 						+ " ms (" + Format::Percentage(gpuNano / 1e9, 0) + ")";
 					gpuLoadSum = {};
+					drawCallString = "Draws: " + Format::Number(frameTotal.drawCalls, 0, false)
+						+ ", binds: " + Format::Number(frameTotal.textureBinds, 0, false);
+					uploadString = "Upload: " + Format::Number(frameTotal.uploadedBytes / 1024., 1, false) + " KB";
+					passTotals = GpuProfiler::Totals();
+					GpuProfiler::ResetTotals();
 					// Get how much memory we have (in bytes).
 					static size_t virtualMemoryUse;
 #ifdef _WIN32
@@ -518,6 +718,28 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 #endif
 					// bytes / (1024 * 1024) = megabytes
 					memoryString = "MEM: " + Format::Number(virtualMemoryUse / 1048576., 2, false) + " MB";
+					// Show what the audio was doing over the same second, to help explain hitches.
+					const Audio::Stats audioStats = Audio::GetStats();
+					audioString = "Audio: " + to_string(audioStats.players) + " playing, "
+						+ to_string(audioStats.sourcesInUse) + " / " + to_string(audioStats.sources) + " sources";
+					audioLossString = "Dropped: " + to_string(audioStats.dropped) + ", stolen: "
+						+ to_string(audioStats.stolen) + ", gaps: " + to_string(audioStats.underruns);
+					audioTimeString = "Step: " + Format::Number(audioStats.stepTime.count() / 1e6, 2, false)
+						+ " ms, decode: " + Format::Number(audioStats.decodeTimePerChunk.count() / 1e6, 2, false) + " ms";
+					Audio::ResetStats();
+					// Show how evenly the frames were paced, rather than just how long they took on average.
+					const FrameTimer::Percentiles frameTimes = timer.FrameTimes();
+					auto Milliseconds = [](chrono::steady_clock::duration time) -> string
+					{
+						return Format::Number(chrono::duration_cast<chrono::microseconds>(time).count() / 1e3, 1, false);
+					};
+					frameTimeString = "Frame: " + Milliseconds(frameTimes.p50) + " / " + Milliseconds(frameTimes.p95)
+						+ " / " + Milliseconds(frameTimes.p99) + " ms";
+					// If the game was built to count its allocations, show how many the last step made.
+					if(MemoryProfile::IsAvailable())
+						heapString = "Heap: " + Format::Number(MemoryProfile::TotalBytes() / 1048576., 2, false)
+							+ " MB, " + Format::Number(mainPanel ? mainPanel->GetEngine().StepAllocations() : 0)
+							+ " allocs / step";
 					isPerformanceDisplayReady = true;
 				}
 			}
@@ -527,13 +749,20 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 				drawStep = 0;
 				cpuLoadSum = {};
 				gpuLoadSum = {};
+				GpuProfiler::ResetTotals();
+				Audio::ResetStats();
 				isPerformanceDisplayReady = false;
 			}
 
-			GameWindow::Step();
+			{
+				Profiler::Scope scope("Swap buffers");
+				GameWindow::Step();
+			}
+			GpuProfiler::EndFrame();
 
-			// Lock the game loop to 60 FPS.
-			timer.Wait();
+			// Lock the game loop to 60 FPS, unless vsync is pacing it.
+			if(!isSmooth)
+				timer.Wait();
 
 			// If the player ended this frame in-game, count the elapsed time as played time.
 			if(menuPanels.IsEmpty())
@@ -549,7 +778,7 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 			ProcessEvents();
 
 			// Handle any integration test steps.
-			if(dataFinishedLoading)
+			if(dataFinishedLoading && testContext.CurrentTest())
 			{
 				// Run a single integration step every 30 frames.
 				integrationStepCounter = (integrationStepCounter + 1) % 30;
@@ -565,11 +794,8 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 					if(menuPanels.IsEmpty())
 						mainPanel->GetEngine().Wait();
 
-					// The current test that is running, if any.
-					const Test *runningTest = testContext.CurrentTest();
-					assert(runningTest && "no running test while running an integration test?");
 					Command command;
-					runningTest->Step(testContext, player, command);
+					testContext.CurrentTest()->Step(testContext, player, command);
 
 					// Send any commands to the engine, if it is active.
 					if(menuPanels.IsEmpty())
@@ -577,9 +803,42 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 				}
 			}
 
+			// Once the test has set up the scenario, start the benchmark.
+			if(benchmark && !benchmark->HasStarted() && dataFinishedLoading && !testContext.CurrentTest())
+			{
+				if(!menuPanels.IsEmpty())
+					throw runtime_error("The benchmark's test must end in flight, with no menus open.");
+				benchmark->Start(static_cast<MainPanel *>(gamePanels.Root().get())->GetEngine());
+			}
+			// Start recording or replaying from the same point.
+			if(recording && !recording->HasStarted() && dataFinishedLoading && !testContext.CurrentTest())
+			{
+				if(!menuPanels.IsEmpty())
+					throw runtime_error("The recording's test must end in flight, with no menus open.");
+				recording->Start();
+			}
+			const bool isRecordingStep = recording && recording->HasStarted() && menuPanels.IsEmpty();
+			if(isRecordingStep && recording->IsReplay())
+				static_cast<MainPanel *>(gamePanels.Root().get())->GetEngine().GiveCommand(recording->Next());
+
 			// Tell all the panels to step forward, then draw them.
 			(menuPanels.IsEmpty() ? gamePanels : menuPanels).StepAll();
 
+			if(isRecordingStep && !recording->IsReplay())
+				recording->Record(static_cast<MainPanel *>(gamePanels.Root().get())->GetEngine().StepCommands());
+
+			if(benchmark && benchmark->HasStarted() && menuPanels.IsEmpty())
+			{
+				benchmark->CountFrame();
+				if(benchmark->IsDone())
+				{
+					Engine &engine = static_cast<MainPanel *>(gamePanels.Root().get())->GetEngine();
+					engine.Wait();
+					benchmark->PrintResults(engine);
+					menuPanels.Quit();
+				}
+			}
+
 			if(!isHeadless)
 			{
 				Audio::Step(isFastForward);
@@ -600,6 +859,9 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 	// If player quit while landed on a planet, save the game if there are changes.
 	if(player.GetPlanet() && gamePanels.CanSave())
 		player.Save();
+	PlayerInfo::FinishSaving();
+	if(recording && recording->HasStarted())
+		recording->Save();
 }
 
 
@@ -620,6 +882,24 @@ void PrintHelp()
 	cerr << "    --tests: print table of available tests, then exit." << endl;
 	cerr << "    --test <name>: run given test from resources directory." << endl;
 	cerr << "    --nomute: don't mute the game while running tests." << endl;
+	cerr << "    --profile <path>: record how long each part of recent frames took, and write it"
+		" to the given file on exit, for viewing in chrome://tracing or Perfetto." << endl;
+	cerr << "    --watch: reload any data files that are changed while the game is running,"
+		" whenever a menu is open." << endl;
+	cerr << "    --startup-profile <path>: record how long each stage of loading the game took, and how"
+		" much data it read, and write a report sorted by stage, plugin and file to the given file." << endl;
+	cerr << "    --benchmark <frames>: once the test given with --test has finished, simulate the given"
+		" number of frames as fast as possible with a fixed random seed, then print how long they took." << endl;
+	cerr << "    --record <path>: once the test given with --test has finished, record the commands"
+		" given in each frame of flight to the given file, until the game is closed." << endl;
+	cerr << "    --replay <path>: once the test given with --test has finished, give the commands that were"
+		" recorded in the given file, and time the frames like --benchmark does." << endl;
+	cerr << "    --convert-save <path>: convert a saved game from text to the compact binary format, or back." << endl;
+	cerr << "    --memory-report <path>: on exit, write how much memory each part of the game still has allocated"
+		" to the given file. This needs a build with the ES_MEMORY_PROFILE option." << endl;
+	cerr << "    --build-pack <directory> <path>: pack the data, images, shaders and sounds in the given"
+		" directory into a single file, which loads faster than the loose files. Giving a pack to"
+		" --resources or placing one in a plugins folder loads it like a directory." << endl;
 	PrintData::Help();
 	cerr << endl;
 	cerr << "Report bugs to: <https://github.com/endless-sky/endless-sky/issues>" << endl;
@@ -690,3 +970,39 @@ void PrintTestsTable()
 			cout << it.second.Name() << '\n';
 	cout.flush();
 }
+
+
+
+// Draw how much each render pass cost on average in the last second, below
+// the CPU / GPU load display.
+void DrawPassTotals(const vector<GpuProfiler::Total> &totals)
+{
+	if(totals.empty())
+		return;
+
+	const Point topLeft = Screen::TopLeft() + Point(560., 130.);
+	const Point size(320., 20. + 14. * totals.size());
+	FillShader::Fill(topLeft + .5 * size, size, *GameData::Colors().Get("performance info background"));
+
+	Table table;
+	table.SetFontSize(14);
+	table.SetRowHeight(14);
+	table.AddColumn(10);
+	table.AddColumn(170, {Alignment::RIGHT});
+	table.AddColumn(220, {Alignment::RIGHT});
+	table.AddColumn(265, {Alignment::RIGHT});
+	table.AddColumn(310, {Alignment::RIGHT});
+	table.DrawAt(topLeft + Point(0., 5.));
+	table.SetColor(*GameData::Colors().Get("dim"));
+	for(const char *heading : {"Pass", "GPU ms", "Draws", "Binds", "KB"})
+		table.Draw(heading);
+	table.SetColor(*GameData::Colors().Get("medium"));
+	for(const GpuProfiler::Total &total : totals)
+	{
+		table.Draw(total.name);
+		table.Draw(Format::Number(chrono::duration<double, milli>(total.gpuTime).count(), 2, false));
+		table.Draw(Format::Number(total.drawCalls, 0, false));
+		table.Draw(Format::Number(total.textureBinds, 0, false));
+		table.Draw(Format::Number(total.uploadedBytes / 1024., 1, false));
+	}
+}
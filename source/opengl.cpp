@@ -80,6 +80,67 @@ bool OpenGL::HasTexture2DArraySupport()
 
 
 
+// Whether array textures can be compressed in the S3TC (BC1 to BC3) formats.
+bool OpenGL::HasS3TCSupport()
+{
+#ifdef ES_GLES
+	// OpenGL ES devices generally only support ETC2 and ASTC compression.
+	return false;
+#elif defined(__APPLE__)
+	return HasTexture2DArraySupport();
+#else
+	return HasTexture2DArraySupport() && GLEW_EXT_texture_compression_s3tc;
+#endif
+}
+
+
+
+// Whether instanced arrays can be drawn (OpenGL 3.3 or OpenGL ES 3.0).
+bool OpenGL::HasInstancingSupport()
+{
+#if defined(ES_GLES) || defined(__APPLE__)
+	return hasOpenGL3Support;
+#else
+	return hasOpenGL3Support && GLEW_VERSION_3_3;
+#endif
+}
+
+
+
+// Whether the GPU time spent on commands can be measured (OpenGL 3.3 or ARB_timer_query).
+bool OpenGL::HasTimerQuerySupport()
+{
+#ifdef ES_GLES
+	// OpenGL ES only has this through EXT_disjoint_timer_query, which is not loaded.
+	return false;
+#elif defined(__APPLE__)
+	return hasOpenGL3Support;
+#else
+	return hasOpenGL3Support && (GLEW_VERSION_3_3 || GLEW_ARB_timer_query);
+#endif
+}
+
+
+
+// Whether linked shader programs can be saved and loaded in a binary format
+// (OpenGL 4.1, ARB_get_program_binary or OpenGL ES 3.0).
+bool OpenGL::HasProgramBinarySupport()
+{
+#if defined(ES_GLES) || defined(__APPLE__)
+	if(!hasOpenGL3Support)
+		return false;
+#else
+	if(!hasOpenGL3Support || !(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary))
+		return false;
+#endif
+	// Some drivers support the functions, but not a single binary format.
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	return formats > 0;
+}
+
+
+
 bool OpenGL::HasClearBufferSupport()
 {
 	return hasOpenGL3Support;
@@ -38,5 +38,14 @@ public:
 	static bool HasAdaptiveVSyncSupport();
 	static bool HasVaoSupport();
 	static bool HasTexture2DArraySupport();
+	// Whether array textures can be compressed in the S3TC (BC1 to BC3) formats.
+	static bool HasS3TCSupport();
+	// Whether instanced arrays can be drawn (OpenGL 3.3 or OpenGL ES 3.0).
+	static bool HasInstancingSupport();
+	// Whether the GPU time spent on commands can be measured (OpenGL 3.3 or ARB_timer_query).
+	static bool HasTimerQuerySupport();
+	// Whether linked shader programs can be saved and loaded in a binary format
+	// (OpenGL 4.1, ARB_get_program_binary or OpenGL ES 3.0).
+	static bool HasProgramBinarySupport();
 	static bool HasClearBufferSupport();
 };
@@ -19,20 +19,23 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Body.h"
 #include "../Screen.h"
 #include "../image/Sprite.h"
+#include "../image/SpriteAtlas.h"
 
 #include <cmath>
+#include <optional>
 
 using namespace std;
 
 namespace {
-	void Push(vector<float> &v, const Point &pos, float s, float t, float frame, float alpha)
+	float *Push(float *out, const Point &pos, float s, float t, float frame, float alpha)
 	{
-		v.push_back(pos.X());
-		v.push_back(pos.Y());
-		v.push_back(s);
-		v.push_back(t);
-		v.push_back(frame);
-		v.push_back(alpha);
+		*out++ = pos.X();
+		*out++ = pos.Y();
+		*out++ = s;
+		*out++ = t;
+		*out++ = frame;
+		*out++ = alpha;
+		return out;
 	}
 }
 
@@ -41,16 +44,58 @@ namespace {
 // Clear the list, also setting the global time step for animation.
 void BatchDrawList::Clear(int step, double zoom)
 {
-	data.clear();
+	// Keep the memory of each texture that was drawn in the last frame, since
+	// it is likely to be drawn again. Forget any that were not.
+	erase_if(data, [](const auto &it) { return it.second.empty(); });
+	erase_if(velocities, [](const auto &it) { return it.second.empty(); });
+	for(auto &it : data)
+		it.second.clear();
+	for(auto &it : velocities)
+		it.second.clear();
+	last = nullptr;
+	lastVelocities = nullptr;
 	this->step = step;
 	this->zoom = zoom;
 }
 
 
 
-void BatchDrawList::SetCenter(const Point &center)
+void BatchDrawList::SetCenter(const Point &center, const Point &centerVelocity)
 {
 	this->center = center;
+	this->centerVelocity = centerVelocity;
+}
+
+
+
+// Clear this list and give it the same step, zoom, and center as the given
+// one, so that it can collect part of that list's items on another thread.
+void BatchDrawList::ClearFor(const BatchDrawList &whole)
+{
+	Clear(whole.step, whole.zoom);
+	SetCenter(whole.center, whole.centerVelocity);
+}
+
+
+
+// Move all the items in the given list onto the end of this one.
+// The given list keeps its items, so that the memory for them is kept for the
+// next time it is filled in.
+void BatchDrawList::Append(const BatchDrawList &part)
+{
+	for(const auto &[texture, vertices] : part.data)
+	{
+		if(vertices.empty())
+			continue;
+		vector<float> &to = data[texture];
+		to.insert(to.end(), vertices.begin(), vertices.end());
+		const vector<Point> &offsets = part.velocities.at(texture);
+		vector<Point> &toOffsets = velocities[texture];
+		toOffsets.insert(toOffsets.end(), offsets.begin(), offsets.end());
+	}
+	// The vector that the last item went into may have moved.
+	last = nullptr;
+	lastVelocities = nullptr;
 }
 
 
@@ -82,12 +127,36 @@ bool BatchDrawList::AddVisual(const Body &visual)
 
 
 // Draw all the items in this list.
-void BatchDrawList::Draw() const
+void BatchDrawList::Draw(double progress) const
 {
 	BatchShader::Bind();
 
-	for(const pair<const Sprite *const, vector<float>> &it : data)
-		BatchShader::Add(it.first, it.second);
+	vector<float> moved;
+	for(const auto &[texture, vertices] : data)
+	{
+		if(vertices.empty())
+			continue;
+		if(!progress)
+		{
+			BatchShader::Add(texture.first, texture.second, vertices);
+			continue;
+		}
+
+		// Each sprite has six vertices of six values each, starting with its position.
+		moved = vertices;
+		const vector<Point> &offsets = velocities.at(texture);
+		for(size_t i = 0; i < offsets.size(); ++i)
+		{
+			const float dx = static_cast<float>(offsets[i].X() * progress);
+			const float dy = static_cast<float>(offsets[i].Y() * progress);
+			for(size_t vertex = 0; vertex < 6; ++vertex)
+			{
+				moved[36 * i + 6 * vertex] += dx;
+				moved[36 * i + 6 * vertex + 1] += dy;
+			}
+		}
+		BatchShader::Add(texture.first, texture.second, moved);
+	}
 
 	BatchShader::Unbind();
 }
@@ -122,8 +191,23 @@ bool BatchDrawList::Add(const Body &body, Point position, float clip)
 	if(Cull(body, position))
 		return false;
 
-	// Get the data vector for this particular sprite.
-	vector<float> &v = data[body.GetSprite()];
+	// Get the data vector for this particular sprite's texture, and the part
+	// of that texture that contains it.
+	const Sprite *sprite = body.GetSprite();
+	const optional<SpriteAtlas::Region> region = SpriteAtlas::Find(sprite);
+	const pair<uint32_t, int> key = region ? make_pair(region->texture, region->frames)
+		: make_pair(sprite->Texture(), sprite->Frames());
+	if(!last || key != lastKey)
+	{
+		last = &data[key];
+		lastVelocities = &velocities[key];
+		lastKey = key;
+	}
+	vector<float> &v = *last;
+	const float left = region ? region->left : 0.f;
+	const float top = region ? region->top : 0.f;
+	const float width = region ? region->right - left : 1.f;
+	const float height = region ? region->bottom - top : 1.f;
 	// The sprite frame is the same for every vertex.
 	float frame = body.GetFrame(step);
 
@@ -147,12 +231,20 @@ bool BatchDrawList::Add(const Body &body, Point position, float clip)
 
 	// Push two copies of the first and last vertices to mark the break between
 	// the sprites.
-	Push(v, topLeft, 0.f, 1.f, frame, alpha);
-	Push(v, topLeft, 0.f, 1.f, frame, alpha);
-	Push(v, topRight, 1.f, 1.f, frame, alpha);
-	Push(v, bottomLeft, 0.f, 1.f - clip, frame, alpha);
-	Push(v, bottomRight, 1.f, 1.f - clip, frame, alpha);
-	Push(v, bottomRight, 1.f, 1.f - clip, frame, alpha);
+	const float s0 = left;
+	const float s1 = left + width;
+	const float t0 = top + height;
+	const float t1 = top + height * (1.f - clip);
+	const size_t start = v.size();
+	v.resize(start + 6 * 6);
+	float *out = &v[start];
+	out = Push(out, topLeft, s0, t0, frame, alpha);
+	out = Push(out, topLeft, s0, t0, frame, alpha);
+	out = Push(out, topRight, s1, t0, frame, alpha);
+	out = Push(out, bottomLeft, s0, t1, frame, alpha);
+	out = Push(out, bottomRight, s1, t1, frame, alpha);
+	Push(out, bottomRight, s1, t1, frame, alpha);
+	lastVelocities->push_back((body.Velocity() - centerVelocity) * zoom);
 
 	return true;
 }
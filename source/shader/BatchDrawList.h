@@ -17,7 +17,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Point.h"
 
+#include <cstdint>
 #include <map>
+#include <utility>
 #include <vector>
 
 class Body;
@@ -26,19 +28,26 @@ class Sprite;
 
 
 // This class collects a set of OpenGL draw commands to issue and groups them by
-// sprite, so all instances of each sprite can be drawn with a single command.
+// texture, so all instances of each sprite can be drawn with a single command.
+// Small sprites that share a SpriteAtlas page are drawn together, too.
 class BatchDrawList {
 public:
 	// Clear the list, also setting the global time step for animation.
 	void Clear(int step = 0, double zoom = 1.);
-	void SetCenter(const Point &center);
+	void SetCenter(const Point &center, const Point &centerVelocity = Point());
+	// Clear this list and give it the same step, zoom, and center as the given
+	// one, so that it can collect part of that list's items on another thread.
+	void ClearFor(const BatchDrawList &whole);
+	// Move all the items in the given list onto the end of this one.
+	void Append(const BatchDrawList &part);
 
 	// Add an unswizzled object based on the Body class.
 	bool Add(const Body &body, float clip = 1.f);
 	bool AddVisual(const Body &visual);
 
-	// Draw all the items in this list.
-	void Draw() const;
+	// Draw all the items in this list. If the progress is nonzero, each item is
+	// moved that fraction of the way along its velocity, relative to the center.
+	void Draw(double progress = 0.) const;
 
 
 private:
@@ -53,10 +62,20 @@ private:
 	int step = 0;
 	double zoom = 1.;
 	Point center;
+	Point centerVelocity;
 
 	// Each sprite consists of six vertices (four vertices to form a quad and
 	// two dummy vertices to mark the break in between them). Each of those
 	// vertices has six attributes: (x, y) position in pixels, (s, t) texture
-	// coordinates, the index of the sprite frame, and the alpha value.
-	std::map<const Sprite *, std::vector<float>> data;
+	// coordinates, the index of the sprite frame, and the alpha value. They are
+	// grouped by texture and the number of frames in it. The vectors are kept
+	// from one frame to the next so that their memory can be reused.
+	std::map<std::pair<uint32_t, int>, std::vector<float>> data;
+	// How far each sprite in the data moves on screen in one step.
+	std::map<std::pair<uint32_t, int>, std::vector<Point>> velocities;
+	// Consecutive bodies often use the same sprite, such as the particles of
+	// an explosion, so remember which vector the last one was added to.
+	std::pair<uint32_t, int> lastKey;
+	std::vector<float> *last = nullptr;
+	std::vector<Point> *lastVelocities = nullptr;
 };
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "BatchShader.h"
 
 #include "../GameData.h"
+#include "GpuProfiler.h"
 #include "../Screen.h"
 #include "Shader.h"
 #include "../image/Sprite.h"
@@ -113,21 +114,31 @@ void BatchShader::Bind()
 
 
 void BatchShader::Add(const Sprite *sprite, const vector<float> &data)
+{
+	Add(sprite->Texture(), sprite->Frames(), data);
+}
+
+
+
+void BatchShader::Add(uint32_t texture, int frames, const vector<float> &data)
 {
 	// Do nothing if there are no sprites to draw.
 	if(data.empty())
 		return;
 
 	// First, bind the proper texture.
-	glBindTexture(OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D, sprite->Texture());
+	glBindTexture(OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D, texture);
+	GpuProfiler::CountTextureBind();
 	// The shader also needs to know how many frames the texture has.
-	glUniform1f(frameCountI, sprite->Frames());
+	glUniform1f(frameCountI, frames);
 
 	// Upload the vertex data.
 	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_STREAM_DRAW);
+	GpuProfiler::CountUpload(sizeof(float) * data.size());
 
 	// Draw all the vertices.
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, data.size() / 6);
+	GpuProfiler::CountDrawCall();
 }
 
 
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 class Sprite;
@@ -22,7 +23,7 @@ class Sprite;
 
 
 // Class for drawing sprites in a batch. The input to each draw command is a
-// sprite and the vertex data.
+// sprite, or an array texture and its number of frames, and the vertex data.
 class BatchShader {
 public:
 	// Initialize the shaders.
@@ -30,5 +31,6 @@ public:
 
 	static void Bind();
 	static void Add(const Sprite *sprite, const std::vector<float> &data);
+	static void Add(uint32_t texture, int frames, const std::vector<float> &data);
 	static void Unbind();
 };
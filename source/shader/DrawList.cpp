@@ -31,6 +31,7 @@ using namespace std;
 void DrawList::Clear(int step, double zoom)
 {
 	items.clear();
+	velocities.clear();
 	this->step = step;
 	this->zoom = zoom;
 }
@@ -93,15 +94,21 @@ bool DrawList::AddSwizzled(const Body &body, const Swizzle *swizzle, double cloa
 
 
 // Draw all the items in this list.
-void DrawList::Draw() const
+void DrawList::Draw(double progress) const
 {
-	SpriteShader::Bind();
-
-	bool withBlur = Preferences::Has("Render motion blur");
-	for(const SpriteShader::Item &item : items)
-		SpriteShader::Add(item, withBlur);
-
-	SpriteShader::Unbind();
+	if(!progress)
+	{
+		SpriteShader::Draw(items, Preferences::Has("Render motion blur"));
+		return;
+	}
+
+	vector<SpriteShader::Item> moved = items;
+	for(size_t i = 0; i < moved.size(); ++i)
+	{
+		moved[i].position[0] += static_cast<float>(velocities[i].X() * progress);
+		moved[i].position[1] += static_cast<float>(velocities[i].Y() * progress);
+	}
+	SpriteShader::Draw(moved, Preferences::Has("Render motion blur"));
 }
 
 
@@ -167,4 +174,5 @@ void DrawList::Push(const Body &body, Point pos, Point blur, double cloak, const
 	item.clip = 1.;
 
 	items.push_back(item);
+	velocities.push_back((body.Velocity() - centerVelocity) * zoom);
 }
@@ -48,8 +48,9 @@ public:
 	// Add an object using a specific swizzle (rather than its own).
 	bool AddSwizzled(const Body &body, const Swizzle *swizzle, double cloak = 0.);
 
-	// Draw all the items in this list.
-	void Draw() const;
+	// Draw all the items in this list. If the progress is nonzero, each item is
+	// moved that fraction of the way along its velocity, relative to the center.
+	void Draw(double progress = 0.) const;
 
 
 private:
@@ -63,6 +64,8 @@ private:
 	int step = 0;
 	double zoom = 1.;
 	std::vector<SpriteShader::Item> items;
+	// How far each item moves on screen in one step.
+	std::vector<Point> velocities;
 
 	Point center;
 	Point centerVelocity;
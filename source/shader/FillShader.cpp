@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Color.h"
 #include "../GameData.h"
+#include "GpuProfiler.h"
 #include "../Rectangle.h"
 #include "../Screen.h"
 #include "Shader.h"
@@ -119,6 +120,7 @@ void FillShader::Fill(const Point &center, const Point &size, const Color &color
 	glUniform4fv(colorI, 1, color.Get());
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	GpuProfiler::CountDrawCall();
 
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "FogShader.h"
 
 #include "../GameData.h"
+#include "GpuProfiler.h"
 #include "../PlayerInfo.h"
 #include "../Point.h"
 #include "../Screen.h"
@@ -31,140 +32,91 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
-	// Scale of the mask image:
+	// Scale of the mask image, in map units:
 	const int GRID = 16;
 	// Distance represented by one orthogonal or diagonal step:
 	const int ORTH = 5;
 	const int DIAG = 7;
 	// Limit distances to the size of an unsigned char.
 	const int LIMIT = 255;
-	// Pad beyond the screen enough to include any system that might "cast light"
-	// on the on-screen view.
+	// Pad beyond the outermost systems so that the edges of the mask are fully
+	// fogged, and so is everything beyond them.
 	const int PAD = LIMIT / ORTH;
 
 	// OpenGL objects:
 	const Shader *shader;
 	GLuint cornerI;
 	GLuint dimensionsI;
+	GLuint texCornerI;
+	GLuint texDimensionsI;
 	GLuint vao;
 	GLuint vbo;
 	GLuint texture = 0;
 	GLint vertI;
 
-	// Keep track of the previous frame's view so that if it is unchanged we can
-	// skip regenerating the mask.
-	double previousZoom = 0.;
-	double previousLeft = 0.;
-	double previousTop = 0.;
-	int previousColumns = 0;
-	int previousRows = 0;
-	Point previousCenter;
+	// The mask covers the whole galaxy rather than just the screen, so it only
+	// has to be generated again when the systems the player can view change,
+	// not whenever the map is panned or zoomed.
+	bool isStale = true;
+	// The map position of the first pixel of the mask, and its size.
+	Point origin;
+	int columns = 0;
+	int rows = 0;
 
 	void EnableAttribArrays()
 	{
 		glEnableVertexAttribArray(vertI);
 		glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
 	}
-}
-
-
-
-void FogShader::Init()
-{
-	// Compile the shader and store indices to its variables.
-	shader = GameData::Shaders().Get("fog");
-	if(!shader->Object())
-		throw runtime_error("Could not find fog shader!");
-	cornerI = shader->Uniform("corner");
-	dimensionsI = shader->Uniform("dimensions");
-	vertI = shader->Attrib("vert");
 
-	glUseProgram(shader->Object());
-	glUniform1i(shader->Uniform("tex"), 0);
-	glUseProgram(0);
-
-	// Generate the vertex data for drawing sprites.
-	if(OpenGL::HasVaoSupport())
+	// Generate the mask image and upload it.
+	void Generate(const PlayerInfo &player)
 	{
-		glGenVertexArrays(1, &vao);
-		glBindVertexArray(vao);
-	}
-
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-	// Corners of a rectangle to draw.
-	GLfloat vertexData[] = {
-		0.f, 0.f,
-		0.f, 1.f,
-		1.f, 0.f,
-		1.f, 1.f
-	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
-
-	if(OpenGL::HasVaoSupport())
-		EnableAttribArrays();
-
-	// Unbind the VBO and VAO.
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	if(OpenGL::HasVaoSupport())
-		glBindVertexArray(0);
-}
-
-
-
-void FogShader::Redraw()
-{
-	previousZoom = 0.;
-}
-
-
-
-void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
-{
-	// Generate a scaled-down mask image that represents the entire screen plus
-	// enough pixels beyond the screen to include any systems that may be off
-	// screen but close enough to "illuminate" part of the on-screen map.
-	double left = Screen::Left() - GRID * PAD * zoom + fmod(center.X(), GRID) * zoom;
-	double top = Screen::Top() - GRID * PAD * zoom + fmod(center.Y(), GRID) * zoom;
-	int columns = ceil(Screen::Width() / (GRID * zoom)) + 1 + 2 * PAD;
-	int rows = ceil(Screen::Height() / (GRID * zoom)) + 1 + 2 * PAD;
-	// Round up to a multiple of 4 so the rows will be 32-bit aligned.
-	columns = (columns + 3) & ~3;
-
-	// To avoid extra work, don't regenerate the mask buffer if the view has not
-	// moved. This might cause an inaccurate mask if you explore more systems,
-	// come back to the original, and view the map again without viewing it in
-	// between. But, that's an unlikely situation.
-	bool shouldRegenerate = (
-		zoom != previousZoom || center.X() != previousCenter.X() || center.Y() != previousCenter.Y() ||
-		left != previousLeft || top != previousTop || columns != previousColumns || rows != previousRows);
-	if(shouldRegenerate)
-	{
-		bool sizeChanged = (!texture || columns != previousColumns || rows != previousRows);
+		// Find the systems that "cast light," and the area that they span.
+		vector<Point> lit;
+		double minX = 0.;
+		double minY = 0.;
+		double maxX = 0.;
+		double maxY = 0.;
+		for(const auto &it : GameData::Systems())
+		{
+			const System &system = it.second;
+			if(!system.IsValid() || !player.CanView(system))
+				continue;
+			const Point &pos = system.Position();
+			if(lit.empty())
+			{
+				minX = maxX = pos.X();
+				minY = maxY = pos.Y();
+			}
+			else
+			{
+				minX = min(minX, pos.X());
+				minY = min(minY, pos.Y());
+				maxX = max(maxX, pos.X());
+				maxY = max(maxY, pos.Y());
+			}
+			lit.push_back(pos);
+		}
 
-		// Remember the current viewport attributes.
-		previousZoom = zoom;
-		previousCenter = center;
-		previousLeft = left;
-		previousTop = top;
-		previousColumns = columns;
-		previousRows = rows;
+		origin = Point(floor(minX / GRID) - PAD, floor(minY / GRID) - PAD) * GRID;
+		int newColumns = ceil((maxX - origin.X()) / GRID) + 1 + PAD;
+		int newRows = ceil((maxY - origin.Y()) / GRID) + 1 + PAD;
+		// Round up to a multiple of 4 so the rows will be 32-bit aligned.
+		newColumns = (newColumns + 3) & ~3;
+		bool sizeChanged = (!texture || newColumns != columns || newRows != rows);
+		columns = newColumns;
+		rows = newRows;
 
 		// This buffer will hold the mask image.
 		auto buffer = vector<unsigned char>(static_cast<size_t>(rows) * columns, LIMIT);
 
 		// For each system the player knows about, its "distance" pixel in the
 		// buffer should be set to 0.
-		for(const auto &it : GameData::Systems())
+		for(const Point &pos : lit)
 		{
-			const System &system = it.second;
-			if(!system.IsValid() || !player.CanView(system))
-				continue;
-			Point pos = zoom * (system.Position() + center);
-
-			int x = round((pos.X() - left) / (GRID * zoom));
-			int y = round((pos.Y() - top) / (GRID * zoom));
+			int x = round((pos.X() - origin.X()) / GRID);
+			int y = round((pos.Y() - origin.Y()) / GRID);
 			if(x >= 0 && y >= 0 && x < columns && y < rows)
 				buffer[x + y * columns] = 0;
 		}
@@ -200,6 +152,7 @@ void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 			glBindTexture(GL_TEXTURE_2D, texture);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			// Anything beyond the edges of the mask is as fogged as its edges are.
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
@@ -211,9 +164,73 @@ void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 			glBindTexture(GL_TEXTURE_2D, texture);
 			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, columns, rows, GL_RED, GL_UNSIGNED_BYTE, data);
 		}
+		GpuProfiler::CountUpload(static_cast<size_t>(columns) * rows);
+		isStale = false;
 	}
+}
+
+
+
+void FogShader::Init()
+{
+	// Compile the shader and store indices to its variables.
+	shader = GameData::Shaders().Get("fog");
+	if(!shader->Object())
+		throw runtime_error("Could not find fog shader!");
+	cornerI = shader->Uniform("corner");
+	dimensionsI = shader->Uniform("dimensions");
+	texCornerI = shader->Uniform("texCorner");
+	texDimensionsI = shader->Uniform("texDimensions");
+	vertI = shader->Attrib("vert");
+
+	glUseProgram(shader->Object());
+	glUniform1i(shader->Uniform("tex"), 0);
+	glUseProgram(0);
+
+	// Generate the vertex data for drawing sprites.
+	if(OpenGL::HasVaoSupport())
+	{
+		glGenVertexArrays(1, &vao);
+		glBindVertexArray(vao);
+	}
+
+	glGenBuffers(1, &vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+	// Corners of a rectangle to draw.
+	GLfloat vertexData[] = {
+		0.f, 0.f,
+		0.f, 1.f,
+		1.f, 0.f,
+		1.f, 1.f
+	};
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+
+	if(OpenGL::HasVaoSupport())
+		EnableAttribArrays();
+
+	// Unbind the VBO and VAO.
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if(OpenGL::HasVaoSupport())
+		glBindVertexArray(0);
+}
+
+
+
+void FogShader::Redraw()
+{
+	isStale = true;
+}
+
+
+
+void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
+{
+	if(isStale)
+		Generate(player);
 	else
 		glBindTexture(GL_TEXTURE_2D, texture);
+	GpuProfiler::CountTextureBind();
 
 	// Set up to draw the image.
 	glUseProgram(shader->Object());
@@ -225,17 +242,26 @@ void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 		EnableAttribArrays();
 	}
 
-	GLfloat corner[2] = {
-		static_cast<float>(left - .5 * GRID * zoom) / (.5f * Screen::Width()),
-		static_cast<float>(top - .5 * GRID * zoom) / (-.5f * Screen::Height())};
+	// Cover the whole screen.
+	GLfloat corner[2] = {-1.f, 1.f};
 	glUniform2fv(cornerI, 1, corner);
-	GLfloat dimensions[2] = {
-		GRID * static_cast<float>(zoom) * (columns + 1.f) / (.5f * Screen::Width()),
-		GRID * static_cast<float>(zoom) * (rows + 1.f) / (-.5f * Screen::Height())};
+	GLfloat dimensions[2] = {2.f, -2.f};
 	glUniform2fv(dimensionsI, 1, dimensions);
+	// Find where the corner of the screen is on the map, and how much of the
+	// mask the screen spans. Each pixel of the mask is centered on its position.
+	Point texCornerPos = Point(Screen::Left(), Screen::Top()) / zoom - center - origin + Point(.5, .5) * GRID;
+	GLfloat texCorner[2] = {
+		static_cast<float>(texCornerPos.X() / (GRID * columns)),
+		static_cast<float>(texCornerPos.Y() / (GRID * rows))};
+	glUniform2fv(texCornerI, 1, texCorner);
+	GLfloat texDimensions[2] = {
+		static_cast<float>(Screen::Width() / (zoom * GRID * columns)),
+		static_cast<float>(Screen::Height() / (zoom * GRID * rows))};
+	glUniform2fv(texDimensionsI, 1, texDimensions);
 
 	// Call the shader program to draw the image.
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	GpuProfiler::CountDrawCall();
 
 	// Clean up.
 	if(OpenGL::HasVaoSupport())
@@ -0,0 +1,255 @@
+/* GpuProfiler.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "GpuProfiler.h"
+
+#include "../opengl.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+	// Timer query results are read this many frames after they were issued.
+	constexpr size_t FRAME_LATENCY = 4;
+
+	// The running counts since the program started.
+	int64_t drawCalls = 0;
+	int64_t textureBinds = 0;
+	int64_t uploadedBytes = 0;
+
+	// The totals of a single pass since they were last reset.
+	struct PassTotals {
+		const char *name;
+		int64_t gpuTime = 0;
+		int64_t drawCalls = 0;
+		int64_t textureBinds = 0;
+		int64_t uploadedBytes = 0;
+	};
+	vector<PassTotals> passes;
+	// The totals of whole frames.
+	PassTotals frame{"Frame"};
+	int64_t frameDrawCalls = 0;
+	int64_t frameTextureBinds = 0;
+	int64_t frameUploadedBytes = 0;
+	int64_t frames = 0;
+	// The number of frames whose GPU times have been collected.
+	int64_t timedFrames = 0;
+
+	// A pass whose timer queries are still waiting to be read.
+	struct PendingPass {
+		size_t index;
+		int beginQuery;
+		int endQuery;
+		bool isNested;
+		chrono::steady_clock::time_point start;
+	};
+	// The timer queries issued in each of the last few frames.
+	struct FrameQueries {
+		vector<unsigned> queries;
+		size_t used = 0;
+		vector<PendingPass> passes;
+	};
+	FrameQueries frameQueries[FRAME_LATENCY];
+	size_t currentFrame = 0;
+	bool isTimingEnabled = false;
+	int depth = 0;
+
+	// Issue a query that records the GPU's clock once all preceding commands are done,
+	// and return its index within this frame's queries.
+	int QueryTimestamp()
+	{
+#ifdef ES_GLES
+		return -1;
+#else
+		FrameQueries &current = frameQueries[currentFrame];
+		if(current.used == current.queries.size())
+		{
+			GLuint query;
+			glGenQueries(1, &query);
+			current.queries.push_back(query);
+		}
+		glQueryCounter(current.queries[current.used], GL_TIMESTAMP);
+		return current.used++;
+#endif
+	}
+
+	// Read the results of the queries issued in the given frame, and free them for reuse.
+	void Collect(FrameQueries &queries)
+	{
+#ifndef ES_GLES
+		if(!queries.passes.empty())
+			++timedFrames;
+		for(const PendingPass &pending : queries.passes)
+		{
+			// These were issued several frames ago, so the GPU has almost
+			// certainly finished them already.
+			GLuint64 begin = 0;
+			GLuint64 end = 0;
+			glGetQueryObjectui64v(queries.queries[pending.beginQuery], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(queries.queries[pending.endQuery], GL_QUERY_RESULT, &end);
+			const int64_t elapsed = end > begin ? end - begin : 0;
+
+			PassTotals &totals = passes[pending.index];
+			totals.gpuTime += elapsed;
+			if(!pending.isNested)
+				frame.gpuTime += elapsed;
+			Profiler::AddGpuSection(totals.name, pending.start, chrono::nanoseconds(elapsed));
+		}
+#endif
+		queries.passes.clear();
+		queries.used = 0;
+	}
+
+	GpuProfiler::Total Average(const PassTotals &totals)
+	{
+		const double count = max<int64_t>(frames, 1);
+		return {totals.name, chrono::nanoseconds(totals.gpuTime / max<int64_t>(timedFrames, 1)),
+			totals.drawCalls / count, totals.textureBinds / count, totals.uploadedBytes / count};
+	}
+}
+
+
+
+GpuProfiler::Pass::Pass(const char *name)
+	: scope(name), drawCalls(::drawCalls), textureBinds(::textureBinds), uploadedBytes(::uploadedBytes)
+{
+	// The same pass may be drawn with different string literals in different places.
+	auto it = find_if(passes.begin(), passes.end(),
+		[name](const PassTotals &other) { return other.name == name || !strcmp(other.name, name); });
+	index = it - passes.begin();
+	if(it == passes.end())
+		passes.push_back({name});
+
+	if(IsTiming())
+	{
+		start = chrono::steady_clock::now();
+		beginQuery = QueryTimestamp();
+	}
+	++depth;
+}
+
+
+
+GpuProfiler::Pass::~Pass()
+{
+	--depth;
+	PassTotals &totals = passes[index];
+	totals.drawCalls += ::drawCalls - drawCalls;
+	totals.textureBinds += ::textureBinds - textureBinds;
+	totals.uploadedBytes += ::uploadedBytes - uploadedBytes;
+
+	// If timing was turned off or on during this pass, it is not timed.
+	if(beginQuery >= 0 && IsTiming())
+		frameQueries[currentFrame].passes.push_back({index, beginQuery, QueryTimestamp(), depth > 0, start});
+}
+
+
+
+// Choose whether to measure GPU time. The counts are always kept, since each
+// of them is only a single addition.
+void GpuProfiler::SetTimingEnabled(bool enabled)
+{
+	isTimingEnabled = enabled;
+}
+
+
+
+// Check if GPU time is being measured, which needs timer query support.
+bool GpuProfiler::IsTiming()
+{
+	return isTimingEnabled && OpenGL::HasTimerQuerySupport();
+}
+
+
+
+void GpuProfiler::CountDrawCall(int64_t count) noexcept
+{
+	::drawCalls += count;
+}
+
+
+
+void GpuProfiler::CountTextureBind() noexcept
+{
+	++::textureBinds;
+}
+
+
+
+void GpuProfiler::CountUpload(size_t bytes) noexcept
+{
+	::uploadedBytes += bytes;
+}
+
+
+
+// Mark the end of a frame, and collect the GPU times of an earlier one.
+void GpuProfiler::EndFrame()
+{
+	const int64_t frameDraws = drawCalls - frameDrawCalls;
+	const int64_t frameBinds = textureBinds - frameTextureBinds;
+	const int64_t frameUploads = uploadedBytes - frameUploadedBytes;
+	frame.drawCalls += frameDraws;
+	frame.textureBinds += frameBinds;
+	frame.uploadedBytes += frameUploads;
+	frameDrawCalls = drawCalls;
+	frameTextureBinds = textureBinds;
+	frameUploadedBytes = uploadedBytes;
+	++frames;
+
+	Profiler::AddCounter("Draw calls", frameDraws);
+	Profiler::AddCounter("Texture binds", frameBinds);
+	Profiler::AddCounter("Uploaded bytes", frameUploads);
+
+	// The queries of the oldest frame are reused for the next one.
+	currentFrame = (currentFrame + 1) % FRAME_LATENCY;
+	Collect(frameQueries[currentFrame]);
+}
+
+
+
+// Get the average cost per frame of every pass since the last call to
+// ResetTotals(), in the order in which they were first drawn.
+vector<GpuProfiler::Total> GpuProfiler::Totals()
+{
+	vector<Total> result;
+	result.reserve(passes.size());
+	for(const PassTotals &totals : passes)
+		result.push_back(Average(totals));
+	return result;
+}
+
+
+
+// Get the average number of draw calls, texture binds and uploaded bytes
+// per frame, including any that were not part of a pass. Its GPU time is
+// that of every pass which was not nested inside another.
+GpuProfiler::Total GpuProfiler::FrameTotal()
+{
+	return Average(frame);
+}
+
+
+
+void GpuProfiler::ResetTotals()
+{
+	for(PassTotals &totals : passes)
+		totals = {totals.name};
+	frame = {frame.name};
+	frames = 0;
+	timedFrames = 0;
+}
@@ -0,0 +1,90 @@
+/* GpuProfiler.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "../Profiler.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+// Measures the cost of each render pass: how long the GPU spent on its commands,
+// and how many draw calls, texture binds and uploaded bytes it took. The GPU time
+// is measured with timer queries, whose results are only read a few frames later
+// so that the CPU never has to wait for the GPU to catch up. This tells whether a
+// frame is limited by the CPU issuing commands or by the GPU filling pixels.
+// Everything here must only be used from the thread that owns the OpenGL context.
+class GpuProfiler {
+public:
+	// Measures everything drawn from the construction of this object until it
+	// goes out of scope. The CPU time is also recorded as a Profiler section of
+	// the same name, which must be a string literal. Passes may be nested.
+	class Pass {
+	public:
+		explicit Pass(const char *name);
+		Pass(const Pass &) = delete;
+		Pass &operator=(const Pass &) = delete;
+		~Pass();
+
+	private:
+		Profiler::Scope scope;
+		size_t index;
+		// The timer query issued at the start of this pass, or -1 if not timed.
+		int beginQuery = -1;
+		std::chrono::steady_clock::time_point start;
+		int64_t drawCalls;
+		int64_t textureBinds;
+		int64_t uploadedBytes;
+	};
+
+	// The average cost per frame of one pass, or of whole frames.
+	class Total {
+	public:
+		const char *name;
+		// This is zero if the GPU time could not be measured.
+		std::chrono::nanoseconds gpuTime;
+		double drawCalls;
+		double textureBinds;
+		double uploadedBytes;
+	};
+
+
+public:
+	// Choose whether to measure GPU time. The counts are always kept, since each
+	// of them is only a single addition.
+	static void SetTimingEnabled(bool enabled);
+	// Check if GPU time is being measured, which needs timer query support.
+	static bool IsTiming();
+
+	static void CountDrawCall(int64_t count = 1) noexcept;
+	static void CountTextureBind() noexcept;
+	static void CountUpload(size_t bytes) noexcept;
+
+	// Mark the end of a frame, and collect the GPU times of an earlier one.
+	static void EndFrame();
+
+	// Get the average cost per frame of every pass since the last call to
+	// ResetTotals(), in the order in which they were first drawn.
+	static std::vector<Total> Totals();
+	// Get the average number of draw calls, texture binds and uploaded bytes
+	// per frame, including any that were not part of a pass. Its GPU time is
+	// that of every pass which was not nested inside another.
+	static Total FrameTotal();
+	static void ResetTotals();
+};
@@ -17,10 +17,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Color.h"
 #include "../GameData.h"
+#include "GpuProfiler.h"
 #include "../Point.h"
 #include "../Screen.h"
 #include "Shader.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <stdexcept>
 
 using namespace std;
@@ -45,6 +48,107 @@ namespace {
 		glEnableVertexAttribArray(vertI);
 		glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
 	}
+
+	// The instanced version of the shader, which takes the parameters of each
+	// line as vertex attributes. This is only set if instancing is supported.
+	const Shader *instancedShader = nullptr;
+	GLint instancedScaleI;
+
+	GLuint instancedVao;
+	GLuint instanceVbo;
+
+	void InitInstanced()
+	{
+		const Shader *instanced = GameData::Shaders().Get("lineInstanced");
+		if(!instanced->Object())
+			return;
+		instancedScaleI = instanced->Uniform("scale");
+		GLint instancedVertI = instanced->Attrib("vert");
+		GLint instanceStartI = instanced->Attrib("start");
+		GLint instanceEndI = instanced->Attrib("end");
+		GLint instanceWidthI = instanced->Attrib("width");
+		GLint instanceCapI = instanced->Attrib("cap");
+		GLint instanceStartColorI = instanced->Attrib("startColor");
+		GLint instanceEndColorI = instanced->Attrib("endColor");
+
+		glGenVertexArrays(1, &instancedVao);
+		glBindVertexArray(instancedVao);
+
+		// The quad's vertices are shared with the regular shader.
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glEnableVertexAttribArray(instancedVertI);
+		glVertexAttribPointer(instancedVertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+		// Every other attribute advances once per instance.
+		glGenBuffers(1, &instanceVbo);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		const auto Offset = [](size_t offset) { return reinterpret_cast<const GLvoid *>(offset); };
+		constexpr auto stride = sizeof(LineShader::Item);
+		glVertexAttribPointer(instanceStartI, 2, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(LineShader::Item, start)));
+		glVertexAttribPointer(instanceEndI, 2, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(LineShader::Item, end)));
+		glVertexAttribPointer(instanceWidthI, 1, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(LineShader::Item, width)));
+		glVertexAttribPointer(instanceCapI, 1, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(LineShader::Item, cap)));
+		glVertexAttribPointer(instanceStartColorI, 4, GL_FLOAT, GL_FALSE, stride,
+			Offset(offsetof(LineShader::Item, startColor)));
+		glVertexAttribPointer(instanceEndColorI, 4, GL_FLOAT, GL_FALSE, stride,
+			Offset(offsetof(LineShader::Item, endColor)));
+		for(GLint attrib : {instanceStartI, instanceEndI, instanceWidthI, instanceCapI,
+				instanceStartColorI, instanceEndColorI})
+		{
+			glEnableVertexAttribArray(attrib);
+			glVertexAttribDivisor(attrib, 1);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		instancedShader = instanced;
+	}
+
+	void Bind()
+	{
+		if(!shader->Object())
+			throw runtime_error("LineShader: Draw() called before Init().");
+
+		glUseProgram(shader->Object());
+		if(OpenGL::HasVaoSupport())
+			glBindVertexArray(vao);
+		else
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+			EnableAttribArrays();
+		}
+
+		GLfloat scale[2] = {static_cast<GLfloat>(Screen::Width()), static_cast<GLfloat>(Screen::Height())};
+		glUniform2fv(scaleI, 1, scale);
+	}
+
+	void Add(const LineShader::Item &item)
+	{
+		glUniform2fv(startI, 1, item.start);
+		glUniform2fv(endI, 1, item.end);
+		glUniform1f(widthI, item.width);
+
+		glUniform4fv(fromColorI, 1, item.startColor);
+		glUniform4fv(toColorI, 1, item.endColor);
+
+		glUniform1i(capI, static_cast<GLint>(item.cap));
+
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		GpuProfiler::CountDrawCall();
+	}
+
+	void Unbind()
+	{
+		if(OpenGL::HasVaoSupport())
+			glBindVertexArray(0);
+		else
+		{
+			glDisableVertexAttribArray(vertI);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+		glUseProgram(0);
+	}
 }
 
 
@@ -87,6 +191,9 @@ void LineShader::Init()
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
+
+	if(OpenGL::HasInstancingSupport())
+		InitInstanced();
 }
 
 
@@ -123,44 +230,9 @@ void LineShader::DrawDashed(const Point &from, const Point &to, const Point &uni
 void LineShader::DrawGradient(const Point &from, const Point &to, float width,
 	const Color &fromColor, const Color &toColor, bool roundCap)
 {
-	if(!shader->Object())
-		throw runtime_error("LineShader: Draw() called before Init().");
-
-	glUseProgram(shader->Object());
-	if(OpenGL::HasVaoSupport())
-		glBindVertexArray(vao);
-	else
-	{
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		EnableAttribArrays();
-	}
-
-	GLfloat scale[2] = {static_cast<GLfloat>(Screen::Width()), static_cast<GLfloat>(Screen::Height())};
-	glUniform2fv(scaleI, 1, scale);
-
-	GLfloat start[2] = {static_cast<float>(from.X()), static_cast<float>(from.Y())};
-	glUniform2fv(startI, 1, start);
-
-	GLfloat end[2] = {static_cast<float>(to.X()), static_cast<float>(to.Y())};
-	glUniform2fv(endI, 1, end);
-
-	glUniform1f(widthI, width);
-
-	glUniform4fv(fromColorI, 1, fromColor.Get());
-	glUniform4fv(toColorI, 1, toColor.Get());
-
-	glUniform1i(capI, static_cast<GLint>(roundCap));
-
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-	if(OpenGL::HasVaoSupport())
-		glBindVertexArray(0);
-	else
-	{
-		glDisableVertexAttribArray(vertI);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-	}
-	glUseProgram(0);
+	Bind();
+	Add(PrepareGradient(from, to, width, fromColor, toColor, roundCap));
+	Unbind();
 }
 
 
@@ -190,3 +262,62 @@ void LineShader::DrawGradientDashed(const Point &from, const Point &to, const Po
 			width, mixed, mixed2, roundCap);
 	}
 }
+
+
+
+LineShader::Item LineShader::Prepare(const Point &from, const Point &to, float width, const Color &color, bool roundCap)
+{
+	return PrepareGradient(from, to, width, color, color, roundCap);
+}
+
+
+
+LineShader::Item LineShader::PrepareGradient(const Point &from, const Point &to, float width,
+	const Color &fromColor, const Color &toColor, bool roundCap)
+{
+	Item item;
+	item.start[0] = static_cast<float>(from.X());
+	item.start[1] = static_cast<float>(from.Y());
+	item.end[0] = static_cast<float>(to.X());
+	item.end[1] = static_cast<float>(to.Y());
+	item.width = width;
+	item.cap = roundCap;
+	const float *rgba = fromColor.Get();
+	copy(rgba, rgba + 4, item.startColor);
+	rgba = toColor.Get();
+	copy(rgba, rgba + 4, item.endColor);
+	return item;
+}
+
+
+
+// Draw all the given lines. If instancing is supported, this takes a single draw call.
+void LineShader::Draw(const vector<Item> &items)
+{
+	if(items.empty())
+		return;
+	if(!instancedShader)
+	{
+		Bind();
+		for(const Item &item : items)
+			Add(item);
+		Unbind();
+		return;
+	}
+
+	glUseProgram(instancedShader->Object());
+	glBindVertexArray(instancedVao);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Item) * items.size(), items.data(), GL_STREAM_DRAW);
+	GpuProfiler::CountUpload(sizeof(Item) * items.size());
+
+	GLfloat scale[2] = {static_cast<GLfloat>(Screen::Width()), static_cast<GLfloat>(Screen::Height())};
+	glUniform2fv(instancedScaleI, 1, scale);
+
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, items.size());
+	GpuProfiler::CountDrawCall();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <vector>
+
 class Color;
 class Point;
 
@@ -23,6 +25,21 @@ class Point;
 // Class to be used for drawing lines. The sides of a line are anti-aliased, but
 // the start and end of the line are not.
 class LineShader {
+public:
+	// The parameters of a single line. These are laid out the same way as the
+	// attributes of the instanced shader, so they can be uploaded as they are.
+	class Item {
+	public:
+		float start[2];
+		float end[2];
+		float width;
+		// 1 if the line has round caps, and 0 if it does not.
+		float cap;
+		float startColor[4];
+		float endColor[4];
+	};
+
+
 public:
 	static void Init();
 	static void Draw(const Point &from, const Point &to, float width, const Color &color, bool roundCap = true);
@@ -32,4 +49,10 @@ public:
 		const Color &fromColor, const Color &toColor, bool roundCap = true);
 	static void DrawGradientDashed(const Point &from, const Point &to, const Point &unit, float width,
 		const Color &fromColor, const Color &toColor, double dashLength, double spaceLength, bool roundCap = true);
+
+	static Item Prepare(const Point &from, const Point &to, float width, const Color &color, bool roundCap = true);
+	static Item PrepareGradient(const Point &from, const Point &to, float width,
+		const Color &fromColor, const Color &toColor, bool roundCap = true);
+	// Draw all the given lines. If instancing is supported, this takes a single draw call.
+	static void Draw(const std::vector<Item> &items);
 };
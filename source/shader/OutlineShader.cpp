@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Color.h"
 #include "../GameData.h"
+#include "GpuProfiler.h"
 #include "../Point.h"
 #include "../Screen.h"
 #include "Shader.h"
@@ -142,8 +143,10 @@ void OutlineShader::Draw(const Sprite *sprite, const Point &pos, const Point &si
 	glUniform4fv(colorI, 1, color.Get());
 
 	glBindTexture(OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D, sprite->Texture());
+	GpuProfiler::CountTextureBind();
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	GpuProfiler::CountDrawCall();
 
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
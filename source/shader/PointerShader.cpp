@@ -17,10 +17,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Color.h"
 #include "../GameData.h"
+#include "GpuProfiler.h"
 #include "../Point.h"
 #include "../Screen.h"
 #include "Shader.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <stdexcept>
 
 using namespace std;
@@ -44,6 +47,59 @@ namespace {
 		glEnableVertexAttribArray(vertI);
 		glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
 	}
+
+	// The instanced version of the shader, which takes the parameters of each
+	// pointer as vertex attributes. This is only set if instancing is supported.
+	const Shader *instancedShader = nullptr;
+	GLint instancedScaleI;
+
+	GLuint instancedVao;
+	GLuint instanceVbo;
+
+	void InitInstanced()
+	{
+		const Shader *instanced = GameData::Shaders().Get("pointerInstanced");
+		if(!instanced->Object())
+			return;
+		instancedScaleI = instanced->Uniform("scale");
+		GLint instancedVertI = instanced->Attrib("vert");
+		GLint instanceCenterI = instanced->Attrib("center");
+		GLint instanceAngleI = instanced->Attrib("angle");
+		GLint instanceSizeI = instanced->Attrib("size");
+		GLint instanceOffsetI = instanced->Attrib("offset");
+		GLint instanceColorI = instanced->Attrib("color");
+
+		glGenVertexArrays(1, &instancedVao);
+		glBindVertexArray(instancedVao);
+
+		// The triangle's vertices are shared with the regular shader.
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glEnableVertexAttribArray(instancedVertI);
+		glVertexAttribPointer(instancedVertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+		// Every other attribute advances once per instance.
+		glGenBuffers(1, &instanceVbo);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		const auto Offset = [](size_t offset) { return reinterpret_cast<const GLvoid *>(offset); };
+		constexpr auto stride = sizeof(PointerShader::Item);
+		glVertexAttribPointer(instanceCenterI, 2, GL_FLOAT, GL_FALSE, stride,
+			Offset(offsetof(PointerShader::Item, center)));
+		glVertexAttribPointer(instanceAngleI, 2, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(PointerShader::Item, angle)));
+		glVertexAttribPointer(instanceSizeI, 2, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(PointerShader::Item, size)));
+		glVertexAttribPointer(instanceOffsetI, 1, GL_FLOAT, GL_FALSE, stride,
+			Offset(offsetof(PointerShader::Item, offset)));
+		glVertexAttribPointer(instanceColorI, 4, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(PointerShader::Item, color)));
+		for(GLint attrib : {instanceCenterI, instanceAngleI, instanceSizeI, instanceOffsetI, instanceColorI})
+		{
+			glEnableVertexAttribArray(attrib);
+			glVertexAttribDivisor(attrib, 1);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		instancedShader = instanced;
+	}
 }
 
 
@@ -85,6 +141,9 @@ void PointerShader::Init()
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
+
+	if(OpenGL::HasInstancingSupport())
+		InitInstanced();
 }
 
 
@@ -101,6 +160,57 @@ void PointerShader::Draw(const Point &center, const Point &angle,
 
 
 
+PointerShader::Item PointerShader::Prepare(const Point &center, const Point &angle,
+	float width, float height, float offset, const Color &color)
+{
+	Item item;
+	item.center[0] = static_cast<float>(center.X());
+	item.center[1] = static_cast<float>(center.Y());
+	item.angle[0] = static_cast<float>(angle.X());
+	item.angle[1] = static_cast<float>(angle.Y());
+	item.size[0] = width;
+	item.size[1] = height;
+	item.offset = offset;
+	const float *rgba = color.Get();
+	copy(rgba, rgba + 4, item.color);
+	return item;
+}
+
+
+
+// Draw all the given pointers. If instancing is supported, this takes a single draw call.
+void PointerShader::Draw(const vector<Item> &items)
+{
+	if(items.empty())
+		return;
+	if(!instancedShader)
+	{
+		Bind();
+		for(const Item &item : items)
+			Add(item);
+		Unbind();
+		return;
+	}
+
+	glUseProgram(instancedShader->Object());
+	glBindVertexArray(instancedVao);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Item) * items.size(), items.data(), GL_STREAM_DRAW);
+	GpuProfiler::CountUpload(sizeof(Item) * items.size());
+
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(instancedScaleI, 1, scale);
+
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 3, items.size());
+	GpuProfiler::CountDrawCall();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+
+
 void PointerShader::Bind()
 {
 	if(!shader || !shader->Object())
@@ -124,20 +234,21 @@ void PointerShader::Bind()
 void PointerShader::Add(const Point &center, const Point &angle,
 	float width, float height, float offset, const Color &color)
 {
-	GLfloat c[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
-	glUniform2fv(centerI, 1, c);
-
-	GLfloat a[2] = {static_cast<float>(angle.X()), static_cast<float>(angle.Y())};
-	glUniform2fv(angleI, 1, a);
+	Add(Prepare(center, angle, width, height, offset, color));
+}
 
-	GLfloat size[2] = {width, height};
-	glUniform2fv(sizeI, 1, size);
 
-	glUniform1f(offsetI, offset);
 
-	glUniform4fv(colorI, 1, color.Get());
+void PointerShader::Add(const Item &item)
+{
+	glUniform2fv(centerI, 1, item.center);
+	glUniform2fv(angleI, 1, item.angle);
+	glUniform2fv(sizeI, 1, item.size);
+	glUniform1f(offsetI, item.offset);
+	glUniform4fv(colorI, 1, item.color);
 
 	glDrawArrays(GL_TRIANGLES, 0, 3);
+	GpuProfiler::CountDrawCall();
 }
 
 
@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <vector>
+
 class Color;
 class Point;
 
@@ -22,12 +24,31 @@ class Point;
 
 // Functions for drawing triangular "pointers," e.g. for target crosshairs.
 class PointerShader {
+public:
+	// The parameters of a single pointer. These are laid out the same way as the
+	// attributes of the instanced shader, so they can be uploaded as they are.
+	class Item {
+	public:
+		float center[2];
+		float angle[2];
+		float size[2];
+		float offset;
+		float color[4];
+	};
+
+
 public:
 	static void Init();
 
 	static void Draw(const Point &center, const Point &angle, float width, float height, float offset, const Color &color);
+	static Item Prepare(const Point &center, const Point &angle, float width, float height, float offset,
+		const Color &color);
+
+	// Draw all the given pointers. If instancing is supported, this takes a single draw call.
+	static void Draw(const std::vector<Item> &items);
 
 	static void Bind();
 	static void Add(const Point &center, const Point &angle, float width, float height, float offset, const Color &color);
+	static void Add(const Item &item);
 	static void Unbind();
 };
@@ -0,0 +1,137 @@
+/* ProgramCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ProgramCache.h"
+
+#include "../DiskCache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// This must be changed whenever the layout of the cached files changes.
+	const char MAGIC[8] = {'E', 'S', 'P', 'R', 'O', 'G', '0', '1'};
+
+	// No linked program comes anywhere near this size, so a larger one must be corrupt.
+	constexpr uint64_t MAX_SIZE = 64 << 20;
+
+	// The values stored in front of a cached program's binary.
+	struct Header {
+		char magic[8];
+		uint64_t key;
+		uint32_t format;
+		uint64_t size;
+	};
+
+	// The hash of the given shader sources, which names the file they are cached in.
+	uint64_t SourceHash(const string &vertex, const string &fragment)
+	{
+		// Include the terminators, so that "ab" + "c" differs from "a" + "bc".
+		const uint64_t hash = DiskCache::Hash(string_view(vertex.c_str(), vertex.size() + 1));
+		return DiskCache::Hash(string_view(fragment.c_str(), fragment.size() + 1), hash);
+	}
+
+	// Identify the driver that a binary was created by. A binary can only be
+	// loaded by the exact same driver, on the same GPU.
+	uint64_t Key(uint64_t sourceHash)
+	{
+		uint64_t key = sourceHash;
+		for(GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION})
+		{
+			const GLubyte *value = glGetString(name);
+			const char *text = value ? reinterpret_cast<const char *>(value) : "";
+			key = DiskCache::Hash(string_view(text, strlen(text) + 1), key);
+		}
+		return key;
+	}
+
+	filesystem::path CachePath(uint64_t sourceHash)
+	{
+		return DiskCache::Path(sourceHash, ".prog");
+	}
+}
+
+
+
+// Load the program linked from the given sources into the given program
+// object. Returns false if it is not cached or could not be loaded.
+bool ProgramCache::Load(GLuint program, const string &vertex, const string &fragment)
+{
+	if(!OpenGL::HasProgramBinarySupport())
+		return false;
+
+	const uint64_t sourceHash = SourceHash(vertex, fragment);
+	const filesystem::path cachePath = CachePath(sourceHash);
+	ifstream in(cachePath, ios::in | ios::binary);
+	Header header;
+	vector<char> data;
+	if(in.read(reinterpret_cast<char *>(&header), sizeof(header)) && !memcmp(header.magic, MAGIC, sizeof(MAGIC))
+			&& header.key == Key(sourceHash) && header.size && header.size <= MAX_SIZE)
+		data.resize(header.size);
+	if(data.empty() || !in.read(data.data(), data.size()))
+	{
+		DiskCache::Miss("shader programs");
+		return false;
+	}
+
+	// The driver may still reject the binary, for example if it was updated
+	// without changing its version string. Then the program stays unlinked.
+	glProgramBinary(program, header.format, data.data(), data.size());
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if(status != GL_TRUE)
+	{
+		DiskCache::Miss("shader programs");
+		return false;
+	}
+	DiskCache::Hit("shader programs", cachePath);
+	return true;
+}
+
+
+
+// Store the given program, which was just linked from the given sources.
+void ProgramCache::Save(GLuint program, const string &vertex, const string &fragment)
+{
+	if(!OpenGL::HasProgramBinarySupport())
+		return;
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if(length <= 0)
+		return;
+	vector<char> data(length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, data.data());
+	if(length <= 0)
+		return;
+
+	const uint64_t sourceHash = SourceHash(vertex, fragment);
+	Header header;
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.key = Key(sourceHash);
+	header.format = format;
+	header.size = length;
+
+	string out(reinterpret_cast<const char *>(&header), sizeof(header));
+	out.append(data.data(), length);
+	DiskCache::Store(CachePath(sourceHash), out);
+}
@@ -0,0 +1,37 @@
+/* ProgramCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "../opengl.h"
+
+#include <string>
+
+
+
+// An on-disk cache of linked shader programs, in whatever binary format the
+// driver uses, so that they do not need to be compiled every time the game
+// starts. Each program is stored in the "cache" folder of the config directory,
+// along with a hash of its source code and of the driver's name and version. If
+// either of those change, or the driver rejects the binary, the program is
+// compiled from source again.
+class ProgramCache {
+public:
+	// Load the program linked from the given sources into the given program
+	// object. Returns false if it is not cached or could not be loaded.
+	static bool Load(GLuint program, const std::string &vertex, const std::string &fragment);
+	// Store the given program, which was just linked from the given sources.
+	static void Save(GLuint program, const std::string &vertex, const std::string &fragment);
+};
@@ -17,11 +17,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "../Color.h"
 #include "../GameData.h"
+#include "GpuProfiler.h"
 #include "../pi.h"
 #include "../Point.h"
 #include "../Screen.h"
 #include "Shader.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <stdexcept>
 
 using namespace std;
@@ -47,6 +50,57 @@ namespace {
 		glEnableVertexAttribArray(vertI);
 		glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
 	}
+
+	// The instanced version of the shader, which takes the parameters of each
+	// ring as vertex attributes. This is only set if instancing is supported.
+	const Shader *instancedShader = nullptr;
+	GLint instancedScaleI;
+
+	GLuint instancedVao;
+	GLuint instanceVbo;
+
+	void InitInstanced()
+	{
+		const Shader *instanced = GameData::Shaders().Get("ringInstanced");
+		if(!instanced->Object())
+			return;
+		instancedScaleI = instanced->Uniform("scale");
+		GLint instancedVertI = instanced->Attrib("vert");
+		GLint instancePositionI = instanced->Attrib("position");
+		GLint instanceShapeI = instanced->Attrib("shape");
+		GLint instanceDashI = instanced->Attrib("dash");
+		GLint instanceColorI = instanced->Attrib("color");
+
+		glGenVertexArrays(1, &instancedVao);
+		glBindVertexArray(instancedVao);
+
+		// The quad's vertices are shared with the regular shader.
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glEnableVertexAttribArray(instancedVertI);
+		glVertexAttribPointer(instancedVertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+		// Every other attribute advances once per instance.
+		glGenBuffers(1, &instanceVbo);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		const auto Offset = [](size_t offset) { return reinterpret_cast<const GLvoid *>(offset); };
+		constexpr auto stride = sizeof(RingShader::Item);
+		glVertexAttribPointer(instancePositionI, 2, GL_FLOAT, GL_FALSE, stride,
+			Offset(offsetof(RingShader::Item, position)));
+		// The radius, width, angle, and start angle are read as a single vector.
+		glVertexAttribPointer(instanceShapeI, 4, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(RingShader::Item, radius)));
+		glVertexAttribPointer(instanceDashI, 1, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(RingShader::Item, dash)));
+		glVertexAttribPointer(instanceColorI, 4, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(RingShader::Item, color)));
+		for(GLint attrib : {instancePositionI, instanceShapeI, instanceDashI, instanceColorI})
+		{
+			glEnableVertexAttribArray(attrib);
+			glVertexAttribDivisor(attrib, 1);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		instancedShader = instanced;
+	}
 }
 
 
@@ -91,6 +145,9 @@ void RingShader::Init()
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
+
+	if(OpenGL::HasInstancingSupport())
+		InitInstanced();
 }
 
 
@@ -115,6 +172,65 @@ void RingShader::Draw(const Point &pos, float radius, float width, float fractio
 
 
 
+RingShader::Item RingShader::Prepare(const Point &pos, float out, float in, const Color &color)
+{
+	float width = .5f * (1.f + out - in) ;
+	return Prepare(pos, out - width, width, 1.f, color);
+}
+
+
+
+RingShader::Item RingShader::Prepare(const Point &pos, float radius, float width, float fraction,
+	const Color &color, float dash, float startAngle)
+{
+	Item item;
+	item.position[0] = static_cast<float>(pos.X());
+	item.position[1] = static_cast<float>(pos.Y());
+	item.radius = radius;
+	item.width = width;
+	item.angle = fraction * 2. * PI;
+	item.startAngle = startAngle * TO_RAD;
+	item.dash = dash ? 2. * PI / dash : 0.;
+	const float *rgba = color.Get();
+	copy(rgba, rgba + 4, item.color);
+	return item;
+}
+
+
+
+// Draw all the given rings. If instancing is supported, this takes a single draw call.
+void RingShader::Draw(const vector<Item> &items)
+{
+	if(items.empty())
+		return;
+	if(!instancedShader)
+	{
+		Bind();
+		for(const Item &item : items)
+			Add(item);
+		Unbind();
+		return;
+	}
+
+	glUseProgram(instancedShader->Object());
+	glBindVertexArray(instancedVao);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Item) * items.size(), items.data(), GL_STREAM_DRAW);
+	GpuProfiler::CountUpload(sizeof(Item) * items.size());
+
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(instancedScaleI, 1, scale);
+
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, items.size());
+	GpuProfiler::CountDrawCall();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+
+
 void RingShader::Bind()
 {
 	if(!shader || !shader->Object())
@@ -146,18 +262,25 @@ void RingShader::Add(const Point &pos, float out, float in, const Color &color)
 void RingShader::Add(const Point &pos, float radius, float width, float fraction,
 	const Color &color, float dash, float startAngle)
 {
-	GLfloat position[2] = {static_cast<float>(pos.X()), static_cast<float>(pos.Y())};
-	glUniform2fv(positionI, 1, position);
+	Add(Prepare(pos, radius, width, fraction, color, dash, startAngle));
+}
+
+
+
+void RingShader::Add(const Item &item)
+{
+	glUniform2fv(positionI, 1, item.position);
 
-	glUniform1f(radiusI, radius);
-	glUniform1f(widthI, width);
-	glUniform1f(angleI, fraction * 2. * PI);
-	glUniform1f(startAngleI, startAngle * TO_RAD);
-	glUniform1f(dashI, dash ? 2. * PI / dash : 0.);
+	glUniform1f(radiusI, item.radius);
+	glUniform1f(widthI, item.width);
+	glUniform1f(angleI, item.angle);
+	glUniform1f(startAngleI, item.startAngle);
+	glUniform1f(dashI, item.dash);
 
-	glUniform4fv(colorI, 1, color.Get());
+	glUniform4fv(colorI, 1, item.color);
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	GpuProfiler::CountDrawCall();
 }
 
 
@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <vector>
+
 class Color;
 class Point;
 
@@ -23,16 +25,40 @@ class Point;
 // Class representing a shader that draws round "dots," either filled in or with
 // transparent centers (i.e. circles or rings).
 class RingShader {
+public:
+	// The parameters of a single ring. These are laid out the same way as the
+	// attributes of the instanced shader, so they can be uploaded as they are.
+	class Item {
+	public:
+		float position[2];
+		float radius;
+		float width;
+		// The angle the ring covers, and the angle at which it starts.
+		float angle;
+		float startAngle;
+		// The angle of each dash, or 0 for a solid ring.
+		float dash;
+		float color[4];
+	};
+
+
 public:
 	static void Init();
 
 	static void Draw(const Point &pos, float out, float in, const Color &color);
 	static void Draw(const Point &pos, float radius, float width, float fraction,
 		const Color &color, float dash = 0.f, float startAngle = 0.f);
+	static Item Prepare(const Point &pos, float out, float in, const Color &color);
+	static Item Prepare(const Point &pos, float radius, float width, float fraction,
+		const Color &color, float dash = 0.f, float startAngle = 0.f);
+
+	// Draw all the given rings. If instancing is supported, this takes a single draw call.
+	static void Draw(const std::vector<Item> &items);
 
 	static void Bind();
 	static void Add(const Point &pos, float out, float in, const Color &color);
 	static void Add(const Point &pos, float radius, float width, float fraction,
 		const Color &color, float dash = 0.f, float startAngle = 0.f);
+	static void Add(const Item &item);
 	static void Unbind();
 };
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Shader.h"
 
 #include "../Logger.h"
+#include "ProgramCache.h"
 
 #include <cctype>
 #include <cstring>
@@ -29,16 +30,25 @@ using namespace std;
 
 void Shader::Load(const char *vertex, const char *fragment)
 {
-	GLuint vertexShader = Compile(vertex, GL_VERTEX_SHADER);
-	GLuint fragmentShader = Compile(fragment, GL_FRAGMENT_SHADER);
-
 	program = glCreateProgram();
 	if(!program)
 		throw runtime_error("Creating OpenGL shader program failed.");
 
+	// Skip compiling the program if the driver has already linked it before.
+	const string vertexSource = vertex;
+	const string fragmentSource = fragment;
+	if(ProgramCache::Load(program, vertexSource, fragmentSource))
+		return;
+
+	GLuint vertexShader = Compile(vertex, GL_VERTEX_SHADER);
+	GLuint fragmentShader = Compile(fragment, GL_FRAGMENT_SHADER);
+
 	glAttachShader(program, vertexShader);
 	glAttachShader(program, fragmentShader);
 
+	// Some drivers only keep the binary of a program if they are told it will be asked for.
+	if(OpenGL::HasProgramBinarySupport())
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(program);
 
 	glDetachShader(program, vertexShader);
@@ -57,6 +67,7 @@ void Shader::Load(const char *vertex, const char *fragment)
 
 		throw runtime_error("Linking OpenGL shader program failed.");
 	}
+	ProgramCache::Save(program, vertexSource, fragmentSource);
 }
 
 
@@ -16,11 +16,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteShader.h"
 
 #include "../GameData.h"
+#include "GpuProfiler.h"
 #include "../Screen.h"
 #include "Shader.h"
 #include "../image/Sprite.h"
 #include "../Swizzle.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
 using namespace std;
 
 namespace {
@@ -50,6 +56,117 @@ namespace {
 		glEnableVertexAttribArray(vertI);
 		glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
 	}
+
+	// The instanced version of the shader, which takes everything that differs
+	// between the items drawn with one texture as vertex attributes instead of
+	// uniforms. This is only set if instancing is supported.
+	const Shader *instancedShader = nullptr;
+	GLint instancedScaleI;
+	GLint instancedFrameCountI;
+	GLint instancedUniqueSwizzleMaskFramesI;
+	GLint instancedSwizzlesI;
+
+	GLint instancedVertI;
+	GLint instancePositionI;
+	GLint instanceTransformI;
+	GLint instanceBlurI;
+	GLint instanceParametersI;
+	GLint instanceSwizzleI;
+
+	GLuint instancedVao;
+	GLuint instanceVbo;
+
+	// The per-instance attributes of a single item.
+	struct Instance {
+		GLfloat position[2];
+		GLfloat transform[4];
+		GLfloat blur[2];
+		// The frame, clip, alpha, and swizzle mode.
+		GLfloat parameters[4];
+		// The index of this item's swizzle in the current palette.
+		GLfloat swizzle;
+	};
+
+	// The number of swizzle matrices that the instanced shader can hold at once.
+	// This must match the size of the array in spriteInstanced.frag.
+	constexpr size_t PALETTE_SIZE = 32;
+
+	// A set of swizzle matrices that are uploaded together, and the first item
+	// that is drawn using them. The items before the next palette's first item
+	// refer to their swizzles by their index in this palette.
+	struct Palette {
+		size_t firstItem;
+		size_t firstMatrix;
+		size_t count;
+	};
+
+	// Point the instance attributes at the given instance in the buffer.
+	void SetInstanceOffset(size_t first)
+	{
+		const auto Offset = [first](size_t offset)
+		{
+			return reinterpret_cast<const GLvoid *>(first * sizeof(Instance) + offset);
+		};
+		constexpr auto stride = sizeof(Instance);
+		glVertexAttribPointer(instancePositionI, 2, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(Instance, position)));
+		glVertexAttribPointer(instanceTransformI, 4, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(Instance, transform)));
+		glVertexAttribPointer(instanceBlurI, 2, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(Instance, blur)));
+		glVertexAttribPointer(instanceParametersI, 4, GL_FLOAT, GL_FALSE, stride,
+			Offset(offsetof(Instance, parameters)));
+		glVertexAttribPointer(instanceSwizzleI, 1, GL_FLOAT, GL_FALSE, stride, Offset(offsetof(Instance, swizzle)));
+	}
+
+	void InitInstanced()
+	{
+		const Shader *instanced = GameData::Shaders().Get("spriteInstanced");
+		if(!instanced->Object())
+			return;
+		instancedScaleI = instanced->Uniform("scale");
+		instancedFrameCountI = instanced->Uniform("frameCount");
+		instancedUniqueSwizzleMaskFramesI = instanced->Uniform("uniqueSwizzleMaskFrames");
+		instancedSwizzlesI = instanced->Uniform("swizzles");
+		instancedVertI = instanced->Attrib("vert");
+		instancePositionI = instanced->Attrib("position");
+		instanceTransformI = instanced->Attrib("transform");
+		instanceBlurI = instanced->Attrib("blur");
+		instanceParametersI = instanced->Attrib("parameters");
+		instanceSwizzleI = instanced->Attrib("swizzle");
+
+		// Make sure the shader uses texture 0 for the sprite and 1 for its swizzle mask.
+		glUseProgram(instanced->Object());
+		glUniform1i(instanced->Uniform("tex"), 0);
+		glUniform1i(instanced->Uniform("swizzleMask"), 1);
+		glUseProgram(0);
+
+		glGenVertexArrays(1, &instancedVao);
+		glBindVertexArray(instancedVao);
+
+		// The quad's vertices are shared with the regular shader.
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glEnableVertexAttribArray(instancedVertI);
+		glVertexAttribPointer(instancedVertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+		// Every other attribute advances once per instance.
+		glGenBuffers(1, &instanceVbo);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		for(GLint attrib : {instancePositionI, instanceTransformI, instanceBlurI, instanceParametersI, instanceSwizzleI})
+		{
+			glEnableVertexAttribArray(attrib);
+			glVertexAttribDivisor(attrib, 1);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+
+		instancedShader = instanced;
+	}
+
+	// Whether two consecutive items can be drawn with the same instanced call.
+	bool IsSameBatch(const SpriteShader::Item &a, const SpriteShader::Item &b)
+	{
+		return a.texture == b.texture && a.swizzleMask == b.swizzleMask && a.frameCount == b.frameCount
+			&& a.uniqueSwizzleMaskFrames == b.uniqueSwizzleMaskFrames;
+	}
 }
 
 // Initialize the shaders.
@@ -99,6 +216,9 @@ void SpriteShader::Init()
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
+
+	if(OpenGL::HasInstancingSupport())
+		InitInstanced();
 }
 
 
@@ -186,6 +306,8 @@ void SpriteShader::Add(const Item &item, bool withBlur)
 	glActiveTexture(GL_TEXTURE1);
 	glBindTexture(type, item.swizzleMask);
 	glActiveTexture(GL_TEXTURE0);
+	GpuProfiler::CountTextureBind();
+	GpuProfiler::CountTextureBind();
 
 	glUniform1f(frameI, item.frame);
 	glUniform1f(frameCountI, item.frameCount);
@@ -199,6 +321,123 @@ void SpriteShader::Add(const Item &item, bool withBlur)
 	glUniform1f(alphaI, item.alpha);
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	GpuProfiler::CountDrawCall();
+}
+
+
+
+// Draw all the given items, in order. Consecutive items that use the same
+// textures are drawn with a single instanced call, if instancing is supported.
+void SpriteShader::Draw(const vector<Item> &items, bool withBlur)
+{
+	if(items.empty())
+		return;
+	if(!instancedShader)
+	{
+		Bind();
+		for(const Item &item : items)
+			Add(item, withBlur);
+		Unbind();
+		return;
+	}
+
+	// Gather the attributes of every item, so they can be uploaded at once. The
+	// swizzle matrices are collected into palettes rather than being stored with
+	// every instance, so that ships with any number of different swizzles can
+	// be drawn in one call.
+	static vector<Instance> instances;
+	static vector<Palette> palettes;
+	static vector<const Swizzle *> palette;
+	static vector<GLfloat> matrices;
+	instances.resize(items.size());
+	palettes.assign(1, Palette{0, 0, 0});
+	palette.clear();
+	matrices.clear();
+	for(size_t i = 0; i < items.size(); ++i)
+	{
+		const Item &item = items[i];
+		Instance &instance = instances[i];
+		copy(item.position, item.position + 2, instance.position);
+		copy(item.transform, item.transform + 4, instance.transform);
+		instance.blur[0] = withBlur ? item.blur[0] : 0.f;
+		instance.blur[1] = withBlur ? item.blur[1] : 0.f;
+		instance.parameters[0] = item.frame;
+		instance.parameters[1] = item.clip;
+		instance.parameters[2] = item.alpha;
+		// Don't mask full color swizzles that always apply to the whole ship sprite.
+		const bool useSwizzle = item.swizzle && !item.swizzle->IsIdentity();
+		const bool useSwizzleMask = useSwizzle && item.swizzleMask && !item.swizzle->OverrideMask();
+		instance.parameters[3] = useSwizzleMask ? 2.f : useSwizzle ? 1.f : 0.f;
+		instance.swizzle = 0.f;
+		if(!useSwizzle)
+			continue;
+
+		auto it = find(palette.begin(), palette.end(), item.swizzle);
+		if(it == palette.end())
+		{
+			// Start a new palette if this one has no room for another swizzle.
+			if(palette.size() == PALETTE_SIZE)
+			{
+				palettes.push_back(Palette{i, matrices.size() / 16, 0});
+				palette.clear();
+			}
+			palette.push_back(item.swizzle);
+			++palettes.back().count;
+			matrices.insert(matrices.end(), item.swizzle->MatrixPtr(), item.swizzle->MatrixPtr() + 16);
+			it = prev(palette.end());
+		}
+		instance.swizzle = static_cast<GLfloat>(it - palette.begin());
+	}
+
+	glUseProgram(instancedShader->Object());
+	glBindVertexArray(instancedVao);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Instance) * instances.size(), instances.data(), GL_STREAM_DRAW);
+	GpuProfiler::CountUpload(sizeof(Instance) * instances.size());
+
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(instancedScaleI, 1, scale);
+
+	int type = OpenGL::HasTexture2DArraySupport() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_3D;
+	size_t nextPalette = 0;
+	size_t paletteEnd = 0;
+	for(size_t first = 0; first < items.size(); )
+	{
+		// Upload the swizzles of the palette that this item refers to.
+		if(first == paletteEnd)
+		{
+			const Palette &current = palettes[nextPalette++];
+			if(current.count)
+			{
+				glUniformMatrix4fv(instancedSwizzlesI, current.count, GL_FALSE, &matrices[16 * current.firstMatrix]);
+				GpuProfiler::CountUpload(16 * sizeof(GLfloat) * current.count);
+			}
+			paletteEnd = nextPalette < palettes.size() ? palettes[nextPalette].firstItem : items.size();
+		}
+
+		const Item &item = items[first];
+		size_t last = first + 1;
+		while(last < paletteEnd && IsSameBatch(item, items[last]))
+			++last;
+
+		glBindTexture(type, item.texture);
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(type, item.swizzleMask);
+		glActiveTexture(GL_TEXTURE0);
+		GpuProfiler::CountTextureBind();
+		GpuProfiler::CountTextureBind();
+		glUniform1f(instancedFrameCountI, item.frameCount);
+		glUniform1i(instancedUniqueSwizzleMaskFramesI, item.uniqueSwizzleMaskFrames);
+
+		SetInstanceOffset(first);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, last - first);
+		GpuProfiler::CountDrawCall();
+		first = last;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glUseProgram(0);
 }
 
 
@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Swizzle.h"
 
 #include <cstdint>
+#include <vector>
 
 class Sprite;
 
@@ -60,6 +61,10 @@ public:
 	static Item Prepare(const Sprite *sprite, const Point &position, float zoom = 1.f,
 		const Swizzle *swizzle = Swizzle::None(), float frame = 0.f, const Point &unit = Point(0., -1.));
 
+	// Draw all the given items, in order. Consecutive items that use the same
+	// textures are drawn with a single instanced call, if instancing is supported.
+	static void Draw(const std::vector<Item> &items, bool withBlur = false);
+
 	static void Bind();
 	static void Add(const Item &item, bool withBlur = false);
 	static void Unbind();
@@ -19,8 +19,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Body.h"
 #include "DrawList.h"
 #include "../GameData.h"
+#include "GpuProfiler.h"
 #include "../Interface.h"
-#include "../pi.h"
 #include "../Preferences.h"
 #include "../Random.h"
 #include "../Screen.h"
@@ -30,12 +30,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
-#include <numeric>
 
 using namespace std;
 
 namespace {
-	const int TILE_SIZE = 256;
+	// The stars are spread over cells of at least this size, each with a few
+	// slots that may hold a star. Sparse star fields use larger cells, so that
+	// the GPU doesn't spend most of its time on slots that are empty.
+	const int MIN_CELL_SIZE = 32;
+	const int MAX_CELL_SIZE = 256;
+	const int MAX_SLOTS = 16;
 	// The star field tiles in 4000 pixel increments. Have the tiling of the haze
 	// field be as different from that as possible. (Note: this may need adjusting
 	// in the future if monitors larger than this width ever become commonplace.)
@@ -76,7 +80,11 @@ namespace {
 void StarField::Init(int stars, int width)
 {
 	SetUpGraphics();
-	MakeStars(stars, width);
+
+	// We can only work with power-of-two widths above the largest cell size.
+	this->width = width;
+	if(width >= MAX_CELL_SIZE && !(width & (width - 1)))
+		starsPerCell = static_cast<double>(stars) * MIN_CELL_SIZE * MIN_CELL_SIZE / (static_cast<double>(width) * width);
 
 	lastSprite = SpriteSet::Get("_menu/haze");
 	for(size_t i = 0; i < HAZE_COUNT; ++i)
@@ -179,12 +187,15 @@ void StarField::Step(Point vel, double zoom)
 		baseZoom = zoom;
 
 	pos += vel;
+	velocity = vel;
 }
 
 
 
-void StarField::Draw(const Point &blur, const System *system) const
+void StarField::Draw(const Point &blur, const System *system, double progress) const
 {
+	const Point position = pos + velocity * progress;
+
 	double density = system ? system->StarfieldDensity() : 1.;
 
 	// Check preferences for the parallax quality.
@@ -195,16 +206,11 @@ void StarField::Draw(const Point &blur, const System *system) const
 
 	// Draw the starfield unless it is disabled in the preferences.
 	double zoom = baseZoom;
-	if(Preferences::Has("Draw starfield") && density > 0.)
+	if(Preferences::Has("Draw starfield") && density > 0. && starsPerCell > 0.)
 	{
 		glUseProgram(shader->Object());
 		if(OpenGL::HasVaoSupport())
 			glBindVertexArray(vao);
-		else
-		{
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			EnableAttribArrays();
-		}
 
 		for(int pass = 1; pass <= layers; pass++)
 		{
@@ -230,45 +236,49 @@ void StarField::Draw(const Point &blur, const System *system) const
 			glUniform1f(elongationI, length * zoom);
 			glUniform1f(brightnessI, min(1., pow(zoom, .5)));
 
+			// Each deeper layer has fewer stars. Pick a cell size that gives each
+			// cell at least half a star on average, and enough slots that even the
+			// densest cells, which have twice as many stars, have room for them.
+			double expected = starsPerCell * density / (layers * pass);
+			int cellSize = MIN_CELL_SIZE;
+			while(cellSize < MAX_CELL_SIZE && expected < .5)
+			{
+				cellSize *= 2;
+				expected *= 4.;
+			}
+			int slots = clamp(static_cast<int>(ceil(2. * expected)), 1, MAX_SLOTS);
+			glUniform1i(slotsI, slots);
+			glUniform1f(cellSizeI, cellSize);
+			glUniform1i(wrapCellsI, width / cellSize);
+			glUniform1i(layerI, pass - 1);
+			glUniform1f(slotChanceI, min(1., 2. * expected / slots));
+
 			// Stars this far beyond the border may still overlap the screen.
 			double borderX = fabs(blur.X()) + 1.;
 			double borderY = fabs(blur.Y()) + 1.;
-			// Find the absolute bounds of the star field we must draw.
-			int minX = pos.X() + (Screen::Left() - borderX) / zoom;
-			int minY = pos.Y() + (Screen::Top() - borderY) / zoom;
-			int maxX = pos.X() + (Screen::Right() + borderX) / zoom;
-			int maxY = pos.Y() + (Screen::Bottom() + borderY) / zoom;
-			// Round down to the start of the nearest tile.
-			minX &= ~(TILE_SIZE - 1l);
-			minY &= ~(TILE_SIZE - 1l);
-
-			for(int gy = minY; gy < maxY; gy += TILE_SIZE)
-			{
-				for(int gx = minX; gx < maxX; gx += TILE_SIZE)
-				{
-					Point off = Point(gx, gy) - pos;
-					GLfloat translate[2] = {
-						static_cast<float>(off.X()),
-						static_cast<float>(off.Y())
-					};
-					glUniform2fv(translateI, 1, translate);
-
-					int index = (gx & widthMod) / TILE_SIZE + ((gy & widthMod) / TILE_SIZE) * tileCols;
-					int first = tileIndex[index];
-					int count = (tileIndex[index + 1] - first) * density / layers;
-					glDrawArrays(GL_TRIANGLES, 6 * (first + (pass - 1) * count), 6 * (count / pass));
-				}
-			}
+			// Find the range of cells that may have stars on screen.
+			int minX = floor((position.X() + (Screen::Left() - borderX) / zoom) / cellSize);
+			int minY = floor((position.Y() + (Screen::Top() - borderY) / zoom) / cellSize);
+			int maxX = floor((position.X() + (Screen::Right() + borderX) / zoom) / cellSize);
+			int maxY = floor((position.Y() + (Screen::Bottom() + borderY) / zoom) / cellSize);
+			int columns = maxX - minX + 1;
+			int rows = maxY - minY + 1;
+			glUniform2i(firstCellI, minX, minY);
+			glUniform1i(columnsI, columns);
+
+			Point off = Point(minX, minY) * cellSize - position;
+			GLfloat translate[2] = {
+				static_cast<float>(off.X()),
+				static_cast<float>(off.Y())
+			};
+			glUniform2fv(translateI, 1, translate);
+
+			// The vertex shader works out every star from the index of its vertices.
+			glDrawArrays(GL_TRIANGLES, 0, 6 * slots * columns * rows);
+			GpuProfiler::CountDrawCall();
 		}
 		if(OpenGL::HasVaoSupport())
 			glBindVertexArray(0);
-		else
-		{
-			glDisableVertexAttribArray(offsetI);
-			glDisableVertexAttribArray(sizeI);
-			glDisableVertexAttribArray(cornerI);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-		}
 		glUseProgram(0);
 	}
 
@@ -282,7 +292,7 @@ void StarField::Draw(const Point &blur, const System *system) const
 
 	DrawList drawList;
 	drawList.Clear(0, zoom);
-	drawList.SetCenter(pos);
+	drawList.SetCenter(position);
 
 	if(transparency > FADE_PER_FRAME)
 		transparency -= FADE_PER_FRAME;
@@ -292,8 +302,8 @@ void StarField::Draw(const Point &blur, const System *system) const
 	// Any object within this range must be drawn. Some haze sprites may repeat
 	// more than once if the view covers a very large area.
 	Point size = Point(1., 1.) * haze[0].front().Radius();
-	Point topLeft = pos + Screen::TopLeft() / zoom - size;
-	Point bottomRight = pos + Screen::BottomRight() / zoom + size;
+	Point topLeft = position + Screen::TopLeft() / zoom - size;
+	Point bottomRight = position + Screen::BottomRight() / zoom + size;
 	if(transparency > 0.)
 		AddHaze(drawList, haze[1], topLeft, bottomRight, 1 - transparency);
 	AddHaze(drawList, haze[0], topLeft, bottomRight, transparency);
@@ -303,155 +313,27 @@ void StarField::Draw(const Point &blur, const System *system) const
 
 
 
-void StarField::EnableAttribArrays() const
-{
-	// Connect the xy to the "vert" attribute of the vertex shader.
-	constexpr auto stride = 4 * sizeof(GLfloat);
-	glEnableVertexAttribArray(offsetI);
-	glVertexAttribPointer(offsetI, 2, GL_FLOAT, GL_FALSE,
-		stride, nullptr);
-
-	glEnableVertexAttribArray(sizeI);
-	glVertexAttribPointer(sizeI, 1, GL_FLOAT, GL_FALSE,
-		stride, reinterpret_cast<const GLvoid *>(2 * sizeof(GLfloat)));
-
-	glEnableVertexAttribArray(cornerI);
-	glVertexAttribPointer(cornerI, 1, GL_FLOAT, GL_FALSE,
-		stride, reinterpret_cast<const GLvoid *>(3 * sizeof(GLfloat)));
-}
-
-
-
 void StarField::SetUpGraphics()
 {
 	shader = GameData::Shaders().Get("starfield");
 	if(!shader->Object())
 		throw runtime_error("Could not find starfield shader!");
 
-	// make and bind the VAO
+	// The shader has no vertex attributes, but a VAO must still be bound to draw.
 	if(OpenGL::HasVaoSupport())
-	{
 		glGenVertexArrays(1, &vao);
-		glBindVertexArray(vao);
-	}
-
-	// make and bind the VBO
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-	offsetI = shader->Attrib("offset");
-	sizeI = shader->Attrib("size");
-	cornerI = shader->Attrib("corner");
 
 	scaleI = shader->Uniform("scale");
 	rotateI = shader->Uniform("rotate");
 	elongationI = shader->Uniform("elongation");
 	translateI = shader->Uniform("translate");
 	brightnessI = shader->Uniform("brightness");
+	firstCellI = shader->Uniform("firstCell");
+	columnsI = shader->Uniform("columns");
+	slotsI = shader->Uniform("slots");
+	cellSizeI = shader->Uniform("cellSize");
+	wrapCellsI = shader->Uniform("wrapCells");
+	layerI = shader->Uniform("layer");
+	slotChanceI = shader->Uniform("slotChance");
 }
 
-
-
-void StarField::MakeStars(int stars, int width)
-{
-	// We can only work with power-of-two widths above 256.
-	if(width < TILE_SIZE || (width & (width - 1)))
-		return;
-
-	widthMod = width - 1;
-
-	tileCols = (width / TILE_SIZE);
-	tileIndex.clear();
-	tileIndex.resize(static_cast<size_t>(tileCols) * tileCols, 0);
-
-	vector<int> off;
-	static const int MAX_OFF = 50;
-	static const int MAX_D = MAX_OFF * MAX_OFF;
-	static const int MIN_D = MAX_D / 4;
-	off.reserve(MAX_OFF * MAX_OFF * 5);
-	for(int x = -MAX_OFF; x <= MAX_OFF; ++x)
-		for(int y = -MAX_OFF; y <= MAX_OFF; ++y)
-		{
-			int d = x * x + y * y;
-			if(d < MIN_D || d > MAX_D)
-				continue;
-
-			off.push_back(x);
-			off.push_back(y);
-		}
-
-	// Generate random points in a temporary vector.
-	// Keep track of how many fall into each tile, for sorting out later.
-	vector<int> temp;
-	temp.reserve(2 * stars);
-
-	int x = Random::Int(width);
-	int y = Random::Int(width);
-	for(int i = 0; i < stars; ++i)
-	{
-		for(int j = 0; j < 10; ++j)
-		{
-			int index = Random::Int(static_cast<uint32_t>(off.size())) & ~1;
-			x += off[index];
-			y += off[index + 1];
-			x &= widthMod;
-			y &= widthMod;
-		}
-		temp.push_back(x);
-		temp.push_back(y);
-		int index = (x / TILE_SIZE) + (y / TILE_SIZE) * tileCols;
-		++tileIndex[index];
-	}
-
-	// Accumulate item counts so that tileIndex[i] is the index in the array of
-	// the first star that falls within tile i, and tileIndex.back() == stars.
-	tileIndex.insert(tileIndex.begin(), 0);
-	tileIndex.pop_back();
-	partial_sum(tileIndex.begin(), tileIndex.end(), tileIndex.begin());
-
-	// Each star consists of six vertices, each with four data elements.
-	vector<GLfloat> data(6 * 4 * stars, 0.f);
-	for(auto it = temp.begin(); it != temp.end(); )
-	{
-		// Figure out what tile this star is in.
-		int x = *it++;
-		int y = *it++;
-		int index = (x / TILE_SIZE) + (y / TILE_SIZE) * tileCols;
-
-		// Randomize its sub-pixel position and its size / brightness.
-		int random = Random::Int(4096);
-		float fx = (x & (TILE_SIZE - 1)) + (random & 15) * 0.0625f;
-		float fy = (y & (TILE_SIZE - 1)) + (random >> 8) * 0.0625f;
-		float size = (((random >> 4) & 15) + 20) * 0.0625f;
-
-		// Fill in the data array.
-		auto dataIt = data.begin() + 6 * 4 * tileIndex[index]++;
-		const float CORNER[6] = {
-			static_cast<float>(0. * PI),
-			static_cast<float>(.5 * PI),
-			static_cast<float>(1.5 * PI),
-			static_cast<float>(.5 * PI),
-			static_cast<float>(1.5 * PI),
-			static_cast<float>(1. * PI)
-		};
-		for(float corner : CORNER)
-		{
-			*dataIt++ = fx;
-			*dataIt++ = fy;
-			*dataIt++ = size;
-			*dataIt++ = corner;
-		}
-	}
-	// Adjust the tile indices so that tileIndex[i] is the start of tile i.
-	tileIndex.insert(tileIndex.begin(), 0);
-
-	glBufferData(GL_ARRAY_BUFFER, sizeof(data.front()) * data.size(), data.data(), GL_STATIC_DRAW);
-
-	if(OpenGL::HasVaoSupport())
-		EnableAttribArrays();
-
-	// unbind the VBO and VAO
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	if(OpenGL::HasVaoSupport())
-		glBindVertexArray(0);
-}
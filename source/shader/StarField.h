@@ -30,11 +30,12 @@ class System;
 
 
 // Object to hold a set of "stars" to be drawn as a backdrop. The star pattern
-// repeats every 4096 pixels. The pattern is generated by a random walk method
-// so that some parts will be much denser than others, which is visually more
-// interesting than if the stars were evenly spread out in perfectly random
-// noise. If the view is moving, the stars are elongated in a motion blur to
-// match the motion; otherwise they would seem to jitter around.
+// repeats every 4096 pixels. The stars are generated on the GPU by hashing the
+// coordinates of the grid cells they are in, with smooth noise making some parts
+// much denser than others, which is visually more interesting than if the stars
+// were evenly spread out in perfectly random noise. If the view is moving, the
+// stars are elongated in a motion blur to match the motion; otherwise they would
+// seem to jitter around.
 class StarField {
 public:
 	void Init(int stars, int width);
@@ -44,25 +45,28 @@ public:
 	void SetHaze(const Sprite *sprite, bool allowAnimation);
 
 	void Step(Point vel, double zoom = 1.);
-	void Draw(const Point &blur, const System *system = nullptr) const;
+	// Draw the stars. The progress is how far along the view is toward its
+	// position in the next step, for drawing frames in between steps.
+	void Draw(const Point &blur, const System *system = nullptr, double progress = 0.) const;
 
 
 private:
-	void EnableAttribArrays() const;
 	void SetUpGraphics();
-	void MakeStars(int stars, int width);
 
 
 private:
-	int widthMod;
-	int tileCols;
-	std::vector<int> tileIndex;
+	// The width after which the star pattern repeats, and the average number
+	// of stars in each of the smallest cells.
+	int width = 0;
+	double starsPerCell = 0.;
 
 	// Constants from an Interface that modify the starfield's behavior.
 	double fixedZoom = 1.;
 	double velocityReducer = 1.;
 
 	Point pos;
+	// How far the view moved in the last step.
+	Point velocity;
 	double baseZoom = 1.;
 
 	double minZoom;
@@ -76,15 +80,17 @@ private:
 
 	const Shader *shader;
 	GLuint vao;
-	GLuint vbo;
-
-	GLuint offsetI;
-	GLuint sizeI;
-	GLuint cornerI;
 
 	GLuint scaleI;
 	GLuint rotateI;
 	GLuint elongationI;
 	GLuint translateI;
 	GLuint brightnessI;
+	GLuint firstCellI;
+	GLuint columnsI;
+	GLuint slotsI;
+	GLuint cellSizeI;
+	GLuint wrapCellsI;
+	GLuint layerI;
+	GLuint slotChanceI;
 };
@@ -28,9 +28,33 @@ using namespace std;
 
 
 
+ShipAICache::WeaponData::WeaponData(const Weapon *weapon)
+	: weapon(weapon)
+{
+	if(!weapon)
+		return;
+
+	velocity = weapon->WeightedVelocity() + .5 * weapon->RandomVelocity();
+	totalLifetime = weapon->TotalLifetime();
+	range = weapon->Range();
+	firingFuel = weapon->FiringFuel();
+	isHoming = weapon->Homing();
+	usesAmmo = weapon->Ammo();
+	isSecondary = weapon->Icon();
+	hasFiringForce = weapon->FiringForce();
+	hasAcceleration = weapon->Acceleration();
+}
+
+
+
 void ShipAICache::Calibrate(const Ship &ship)
 {
 	mass = ship.Mass();
+	weapons.clear();
+	weapons.reserve(ship.Weapons().size());
+	for(const Hardpoint &hardpoint : ship.Weapons())
+		weapons.emplace_back(hardpoint.GetWeapon());
+
 	hasWeapons = false;
 	canFight = false;
 	double totalDPS = 0.;
@@ -134,3 +158,13 @@ void ShipAICache::Recalibrate(const Ship &ship)
 	if(mass != ship.Mass())
 		Calibrate(ship);
 }
+
+
+
+// Get the properties of the weapon in the hardpoint with the given index.
+ShipAICache::WeaponData ShipAICache::GetWeaponData(size_t index, const Weapon *weapon) const
+{
+	if(index < weapons.size() && weapons[index].weapon == weapon)
+		return weapons[index];
+	return WeaponData(weapon);
+}
@@ -15,7 +15,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 class Ship;
+class Weapon;
 
 
 
@@ -23,6 +27,29 @@ class Ship;
 // be those calculations that are needed multiple times a frame or which might only
 // be needed once per frame but don't typically change from frame to frame.
 class ShipAICache {
+public:
+	// The properties of a weapon that the AI checks every frame when deciding
+	// whether and where to fire it, copied so that the weapon need not be read.
+	class WeaponData {
+	public:
+		WeaponData() = default;
+		explicit WeaponData(const Weapon *weapon);
+
+	public:
+		const Weapon *weapon = nullptr;
+		// The average velocity of the weapon's projectiles.
+		double velocity = 0.;
+		double totalLifetime = 0.;
+		double range = 0.;
+		double firingFuel = 0.;
+		bool isHoming = false;
+		bool usesAmmo = false;
+		bool isSecondary = false;
+		bool hasFiringForce = false;
+		bool hasAcceleration = false;
+	};
+
+
 public:
 	ShipAICache() = default;
 
@@ -39,6 +66,10 @@ public:
 	double TurretRange() const;
 	double MinSafeDistance() const;
 	bool NeedsAmmo() const;
+	// Get the properties of the weapon in the hardpoint with the given index.
+	// If the weapons have changed since the cache was calibrated, they are read
+	// from the given weapon instead.
+	WeaponData GetWeaponData(size_t index, const Weapon *weapon) const;
 
 
 private:
@@ -54,6 +85,9 @@ private:
 	double gunRange = 0.;
 	bool hasWeapons = false;
 	bool canFight = false;
+
+	// The weapon in each of the ship's hardpoints.
+	std::vector<WeaponData> weapons;
 };
 
 
@@ -0,0 +1,177 @@
+/* Benchmark.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "../Engine.h"
+#include "../Government.h"
+#include "../Profiler.h"
+#include "../Random.h"
+#include "../Ship.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace std;
+
+namespace {
+	// What became of one government's ships.
+	class Outcome {
+	public:
+		int ships = 0;
+		int active = 0;
+		int disabled = 0;
+		int destroyed = 0;
+	};
+
+	double Percentile(const vector<double> &sorted, double fraction)
+	{
+		const size_t index = min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+		return sorted[index] * 1000.;
+	}
+}
+
+
+
+Benchmark::Benchmark(int frames)
+	: frames(frames)
+{
+}
+
+
+
+// Start timing. Any frames simulated before this are not counted. The ships
+// that are in flight now are the ones whose fate the results report.
+void Benchmark::Start(Engine &engine)
+{
+	engine.Wait();
+	ships.clear();
+	for(const shared_ptr<Ship> &ship : engine.Ships())
+		ships.emplace_back(ship->GetGovernment(), ship);
+	frameTimes.clear();
+	frameTimes.reserve(frames);
+
+	// Loading the game and running the test that set up the scenario may have
+	// drawn any number of random numbers, so start over from a fixed seed.
+	Random::Seed(0);
+	// Keep writing a trace if one was asked for with --profile.
+	if(!Profiler::IsEnabled())
+		Profiler::Enable();
+	Profiler::ResetTotals();
+	framesDone = 0;
+	start = chrono::steady_clock::now();
+	lastFrame = start;
+}
+
+
+
+bool Benchmark::HasStarted() const noexcept
+{
+	return framesDone >= 0;
+}
+
+
+
+// Record that another frame has been simulated.
+void Benchmark::CountFrame()
+{
+	if(!HasStarted() || IsDone())
+		return;
+
+	++framesDone;
+	const auto now = chrono::steady_clock::now();
+	frameTimes.push_back(chrono::duration<double>(now - lastFrame).count());
+	lastFrame = now;
+}
+
+
+
+bool Benchmark::IsDone() const noexcept
+{
+	return framesDone >= frames;
+}
+
+
+
+// Print how fast the frames were simulated, how long each part of a frame
+// took, what became of the ships, and the checksum of the engine's final state.
+void Benchmark::PrintResults(const Engine &engine) const
+{
+	const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+	const double seconds = elapsed.count();
+
+	cout << fixed << setprecision(3);
+	cout << "Simulated " << framesDone << " frames in " << seconds << " s ("
+		<< (seconds > 0. ? framesDone / seconds : 0.) << " frames per second)." << endl;
+	cout << "Time per frame in each part of the simulation:" << endl;
+	for(const Profiler::Total &total : Profiler::Totals())
+	{
+		const double milliseconds = chrono::duration<double, milli>(total.duration).count();
+		cout << "    " << total.name << ": " << (framesDone ? milliseconds / framesDone : 0.)
+			<< " ms (" << total.count << " calls, longest "
+			<< chrono::duration<double, milli>(total.longest).count() << " ms)" << endl;
+	}
+	PrintFrameTimes();
+	PrintBattle();
+	cout << "State checksum: " << hex << setw(16) << setfill('0') << engine.StateChecksum() << dec << endl;
+}
+
+
+
+// The average frame hides occasional slow ones, so also print how slow the
+// slowest frames were.
+void Benchmark::PrintFrameTimes() const
+{
+	if(frameTimes.empty())
+		return;
+
+	vector<double> sorted = frameTimes;
+	sort(sorted.begin(), sorted.end());
+	cout << "Frame times: median " << Percentile(sorted, .5) << " ms, 99th percentile "
+		<< Percentile(sorted, .99) << " ms, longest " << sorted.back() * 1000. << " ms" << endl;
+}
+
+
+
+// Print, for each government, how many of its ships are still fighting, and
+// how many were disabled or destroyed.
+void Benchmark::PrintBattle() const
+{
+	map<string, Outcome> outcomes;
+	for(const auto &[gov, it] : ships)
+	{
+		shared_ptr<const Ship> ship = it.lock();
+		// A ship that nothing refers to any more has finished exploding.
+		const bool isDestroyed = !ship || ship->IsDestroyed();
+		Outcome &outcome = outcomes[gov ? gov->TrueName() : "(none)"];
+		++outcome.ships;
+		if(isDestroyed)
+			++outcome.destroyed;
+		else if(ship->IsDisabled())
+			++outcome.disabled;
+		else
+			++outcome.active;
+	}
+	if(outcomes.empty())
+		return;
+
+	cout << "Ships in flight when the benchmark started:" << endl;
+	for(const auto &[name, outcome] : outcomes)
+		cout << "    " << name << ": " << outcome.ships << " ships, " << outcome.active << " active, "
+			<< outcome.disabled << " disabled, " << outcome.destroyed << " destroyed" << endl;
+}
@@ -0,0 +1,66 @@
+/* Benchmark.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Engine;
+class Government;
+class Ship;
+
+
+
+// Class that times a fixed number of simulated frames, once an integration test
+// has set up the scenario to simulate. The random number generator is reseeded
+// when the benchmark starts, so that every run simulates exactly the same frames
+// and ends with the same state checksum. When the scenario is a battle, the
+// results also say how each government's ships fared, for balance testing.
+class Benchmark {
+public:
+	explicit Benchmark(int frames);
+
+	// Start timing. Any frames simulated before this are not counted. The ships
+	// that are in flight now are the ones whose fate the results report.
+	void Start(Engine &engine);
+	bool HasStarted() const noexcept;
+	// Record that another frame has been simulated.
+	void CountFrame();
+	bool IsDone() const noexcept;
+
+	// Print how fast the frames were simulated, how long each part of a frame
+	// took, what became of the ships, and the checksum of the engine's final state.
+	void PrintResults(const Engine &engine) const;
+
+
+private:
+	void PrintFrameTimes() const;
+	void PrintBattle() const;
+
+
+private:
+	int frames = 0;
+	int framesDone = -1;
+	std::chrono::steady_clock::time_point start;
+	std::chrono::steady_clock::time_point lastFrame;
+	// How long each frame took, in seconds.
+	std::vector<double> frameTimes;
+	// The ships that were in flight when the benchmark started, and which
+	// government each of them belonged to then.
+	std::vector<std::pair<const Government *, std::weak_ptr<const Ship>>> ships;
+};
@@ -0,0 +1,149 @@
+/* InputRecording.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "InputRecording.h"
+
+#include "../DataFile.h"
+#include "../DataNode.h"
+#include "../DataWriter.h"
+#include "../Random.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+
+
+// Record to the given file, or replay the recording in it.
+InputRecording::InputRecording(const filesystem::path &path, bool isReplay)
+	: path(path), isReplay(isReplay)
+{
+	if(!isReplay)
+		return;
+
+	const DataFile file(path);
+	for(const DataNode &node : file)
+		if(node.Token(0) == "recording")
+			for(const DataNode &child : node)
+			{
+				// Each line is the number of steps, then the commands given in them.
+				const int count = child.Value(0);
+				if(count <= 0)
+				{
+					child.PrintTrace("Skipping invalid number of steps:");
+					continue;
+				}
+				Command command;
+				command.Load(child);
+				commands.emplace_back(command, count);
+			}
+	if(commands.empty())
+		throw runtime_error("No steps were recorded in \"" + path.string() + "\".");
+}
+
+
+
+bool InputRecording::IsReplay() const noexcept
+{
+	return isReplay;
+}
+
+
+
+// The number of steps recorded.
+int InputRecording::Steps() const noexcept
+{
+	int steps = 0;
+	for(const auto &it : commands)
+		steps += it.second;
+	return steps;
+}
+
+
+
+// Start recording or replaying. Any steps before this are not included.
+void InputRecording::Start()
+{
+	// The steps before this may have drawn any number of random numbers, so
+	// start over from the same seed as a benchmark does.
+	Random::Seed(0);
+	hasStarted = true;
+}
+
+
+
+bool InputRecording::HasStarted() const noexcept
+{
+	return hasStarted;
+}
+
+
+
+// Record the command the player gave for the step that was just begun.
+void InputRecording::Record(const Command &command)
+{
+	// Only the command bits are replayed, so a different turn amount alone does
+	// not need a new line.
+	if(!commands.empty() && !(commands.back().first < command) && !(command < commands.back().first))
+		++commands.back().second;
+	else
+		commands.emplace_back(command, 1);
+}
+
+
+
+// Get the command to give in the next step of the replay.
+Command InputRecording::Next()
+{
+	if(IsDone())
+		return Command();
+
+	const Command command = commands[index].first;
+	if(++repeated == commands[index].second)
+	{
+		++index;
+		repeated = 0;
+	}
+	return command;
+}
+
+
+
+bool InputRecording::IsDone() const noexcept
+{
+	return isReplay && index >= commands.size();
+}
+
+
+
+// Write the recording to its file.
+void InputRecording::Save() const
+{
+	if(isReplay)
+		return;
+
+	DataWriter out(path);
+	out.Write("recording");
+	out.BeginChild();
+	{
+		for(const auto &[command, count] : commands)
+		{
+			out.WriteToken(count);
+			command.Save(out);
+			out.Write();
+		}
+	}
+	out.EndChild();
+}
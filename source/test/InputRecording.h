@@ -0,0 +1,65 @@
+/* InputRecording.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "../Command.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+
+
+// The commands that the player gave in each step of a flight, so that exactly
+// the same flight can be simulated again, e.g. to find out why it was slow.
+// A recording starts once an integration test has set up the scenario, at the
+// same point where a benchmark starts, and the random number generator is
+// reseeded then in the same way. Replaying it with --benchmark therefore gives
+// the timings of every frame that was recorded.
+class InputRecording {
+public:
+	// Record to the given file, or replay the recording in it.
+	InputRecording(const std::filesystem::path &path, bool isReplay);
+
+	bool IsReplay() const noexcept;
+	// The number of steps recorded.
+	int Steps() const noexcept;
+
+	// Start recording or replaying. Any steps before this are not included.
+	void Start();
+	bool HasStarted() const noexcept;
+	// Record the command the player gave for the step that was just begun.
+	void Record(const Command &command);
+	// Get the command to give in the next step of the replay.
+	Command Next();
+	bool IsDone() const noexcept;
+
+	// Write the recording to its file.
+	void Save() const;
+
+
+private:
+	std::filesystem::path path;
+	bool isReplay = false;
+	bool hasStarted = false;
+	// Each command, and the number of steps in a row that it was given, so that
+	// a recording of a long flight in a straight line is just one line long.
+	std::vector<std::pair<Command, int>> commands;
+	// How far the replay has gotten.
+	std::size_t index = 0;
+	int repeated = 0;
+};
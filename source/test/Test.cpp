@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Logger.h"
 #include "../Planet.h"
 #include "../PlayerInfo.h"
+#include "../Profiler.h"
 #include "../Ship.h"
 #include "../System.h"
 #include "TestContext.h"
@@ -29,6 +30,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <SDL2/SDL.h>
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <map>
 #include <numeric>
@@ -50,11 +52,13 @@ namespace {
 		{Test::TestStep::Type::APPLY, "apply"},
 		{Test::TestStep::Type::ASSERT, "assert"},
 		{Test::TestStep::Type::BRANCH, "branch"},
+		{Test::TestStep::Type::BUDGET, "budget"},
 		{Test::TestStep::Type::CALL, "call"},
 		{Test::TestStep::Type::DEBUG, "debug"},
 		{Test::TestStep::Type::INJECT, "inject"},
 		{Test::TestStep::Type::INPUT, "input"},
 		{Test::TestStep::Type::LABEL, "label"},
+		{Test::TestStep::Type::MEASURE, "measure"},
 		{Test::TestStep::Type::NAVIGATE, "navigate"},
 	};
 
@@ -239,6 +243,29 @@ void Test::LoadSequence(const DataNode &node, const ConditionsStore *playerCondi
 					step.jumpOnFalseTarget = child.Token(2);
 				step.checkConditions.Load(child, playerConditions);
 				break;
+			case TestStep::Type::BUDGET:
+				if(child.Size() < 2)
+				{
+					status = Status::BROKEN;
+					child.PrintTrace("Invalid use of \"budget\" without the name of a profiled section:");
+					return;
+				}
+				step.nameOrLabel = child.Token(1);
+				for(const DataNode &grand : child)
+				{
+					const string &grandKey = grand.Token(0);
+					bool grandHasValue = grand.Size() >= 2;
+					if(grandKey == "average" && grandHasValue)
+						step.averageBudget = grand.Value(1);
+					else if(grandKey == "longest" && grandHasValue)
+						step.longestBudget = grand.Value(1);
+					else
+					{
+						grand.PrintTrace("Invalid or incomplete keywords for budget");
+						status = Status::BROKEN;
+					}
+				}
+				break;
 			case TestStep::Type::CALL:
 				if(child.Size() < 2)
 				{
@@ -288,6 +315,8 @@ void Test::LoadSequence(const DataNode &node, const ConditionsStore *playerCondi
 						jumpTable[step.nameOrLabel] = steps.size() - 1;
 				}
 				break;
+			case TestStep::Type::MEASURE:
+				break;
 			case TestStep::Type::NAVIGATE:
 				for(const DataNode &grand : child)
 				{
@@ -432,8 +461,10 @@ void Test::Step(TestContext &context, PlayerInfo &player, Command &commandToGive
 			if(status >= Status::KNOWN_FAILURE)
 				UnexpectedSuccessResult();
 
-			// Done, no failures, exit the game.
-			SendQuitEvent();
+			// Done, no failures, exit the game (unless something else, like a
+			// benchmark, still needs to run).
+			if(context.quitWhenDone)
+				SendQuitEvent();
 			return;
 		}
 		else
@@ -448,8 +479,8 @@ void Test::Step(TestContext &context, PlayerInfo &player, Command &commandToGive
 	context.branchesSinceGameStep.clear();
 
 	const ConditionsStore *playerConditions = &player.Conditions();
-	const set<const System *> *visitedSystems = &player.VisitedSystems();
-	const set<const Planet *> *visitedPlanets = &player.VisitedPlanets();
+	const IndexedSet<System> *visitedSystems = &player.VisitedSystems();
+	const IndexedSet<Planet> *visitedPlanets = &player.VisitedPlanets();
 	while(context.callstack.back().step < steps.size() && !continueGameLoop)
 	{
 		const TestStep &stepToRun = steps[context.callstack.back().step];
@@ -481,6 +512,24 @@ void Test::Step(TestContext &context, PlayerInfo &player, Command &commandToGive
 				else
 					++(context.callstack.back().step);
 				break;
+			case TestStep::Type::BUDGET:
+				{
+					const vector<Profiler::Total> totals = Profiler::Totals();
+					auto it = find_if(totals.begin(), totals.end(), [&stepToRun](const Profiler::Total &total)
+						{ return stepToRun.nameOrLabel == total.name; });
+					if(!Profiler::IsEnabled() || it == totals.end() || !it->count)
+						Fail(context, player, "no time was measured for \"" + stepToRun.nameOrLabel + "\"");
+					const double average = chrono::duration<double, milli>(it->duration).count() / it->count;
+					const double longest = chrono::duration<double, milli>(it->longest).count();
+					if(stepToRun.averageBudget && average > stepToRun.averageBudget)
+						Fail(context, player, "\"" + stepToRun.nameOrLabel + "\" took " + Format::Number(average, 3)
+							+ " ms on average, over the budget of " + Format::Number(stepToRun.averageBudget) + " ms");
+					if(stepToRun.longestBudget && longest > stepToRun.longestBudget)
+						Fail(context, player, "\"" + stepToRun.nameOrLabel + "\" once took " + Format::Number(longest, 3)
+							+ " ms, over the budget of " + Format::Number(stepToRun.longestBudget) + " ms");
+				}
+				++(context.callstack.back().step);
+				break;
 			case TestStep::Type::CALL:
 				{
 					auto calledTest = GameData::Tests().Find(stepToRun.nameOrLabel);
@@ -526,6 +575,13 @@ void Test::Step(TestContext &context, PlayerInfo &player, Command &commandToGive
 			case TestStep::Type::LABEL:
 				++(context.callstack.back().step);
 				break;
+			case TestStep::Type::MEASURE:
+				// Keep writing a trace if one was asked for with --profile.
+				if(!Profiler::IsEnabled())
+					Profiler::Enable();
+				Profiler::ResetTotals();
+				++(context.callstack.back().step);
+				break;
 			case TestStep::Type::NAVIGATE:
 				player.TravelPlan().clear();
 				player.TravelPlan() = stepToRun.travelPlan;
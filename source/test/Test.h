@@ -60,6 +60,9 @@ public:
 			// When a second label is given, then the second is to jump to on false.
 			// Does not cause the game to step, except when no step was done since last BRANCH or GOTO.
 			BRANCH,
+			// Step that verifies that a profiled section of the game has run within the given
+			// time budget since the last MEASURE step. Does not cause the game to step.
+			BUDGET,
 			// Step that calls another test to handle some generic common actions.
 			CALL,
 			// Step that prints a debug-message to the output.
@@ -70,6 +73,9 @@ public:
 			INPUT,
 			// Label to jump to (similar as is done in conversations). Does not cause the game to step.
 			LABEL,
+			// Step that starts measuring how long each profiled section of the game takes,
+			// for later BUDGET steps to check. Does not cause the game to step.
+			MEASURE,
 			// Instructs the game to set navigation / travel plan to a target system
 			NAVIGATE,
 		};
@@ -98,6 +104,10 @@ public:
 		std::string jumpOnTrueTarget;
 		std::string jumpOnFalseTarget;
 
+		// Time budget variables, in milliseconds. A budget of 0 is not checked.
+		double averageBudget = 0.;
+		double longestBudget = 0.;
+
 		// Input variables.
 		Command command;
 		std::set<std::string> inputKeys;
@@ -20,7 +20,8 @@ class Test;
 
 
 // Constructor to be used when running an actual test.
-TestContext::TestContext(const Test *toRun) : callstack({{toRun, 0}})
+TestContext::TestContext(const Test *toRun, bool quitWhenDone)
+	: callstack({{toRun, 0}}), quitWhenDone(quitWhenDone)
 {
 }
 
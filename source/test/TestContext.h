@@ -25,7 +25,8 @@ class TestContext {
 friend class Test;
 public:
 	TestContext() = default;
-	explicit TestContext(const Test *toRun);
+	// If quitWhenDone is false, the game keeps running once the test has succeeded.
+	explicit TestContext(const Test *toRun, bool quitWhenDone = true);
 	const Test *CurrentTest() const noexcept;
 
 
@@ -48,4 +49,6 @@ private:
 	std::vector<ActiveTestStep> callstack;
 
 	std::set<ActiveTestStep> branchesSinceGameStep;
+
+	bool quitWhenDone = true;
 };
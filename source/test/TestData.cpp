@@ -68,7 +68,7 @@ void TestData::Load(const DataNode &node, const filesystem::path &sourceDataFile
 
 // Inject the test-data to the proper location.
 bool TestData::Inject(const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets) const
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets) const
 {
 	// Check if we have the required data to inject.
 	if(dataSetName.empty() || sourceDataFile.empty())
@@ -125,7 +125,7 @@ bool TestData::InjectSavegame() const
 
 
 bool TestData::InjectMission(const ConditionsStore *playerConditions,
-	const set<const System *> *visitedSystems, const set<const Planet *> *visitedPlanets) const
+	const IndexedSet<System> *visitedSystems, const IndexedSet<Planet> *visitedPlanets) const
 {
 	const DataFile sourceData(sourceDataFile);
 	// Get the contents node in the test data.
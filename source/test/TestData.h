@@ -15,6 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "IndexedSet.h"
+
 #include <filesystem>
 #include <set>
 #include <string>
@@ -34,8 +36,8 @@ public:
 	void Load(const DataNode &node, const std::filesystem::path &sourceDataFilePath);
 	// Function to inject the test-data into the game or into the game's
 	// environment.
-	bool Inject(const ConditionsStore *playerConditions, const std::set<const System *> *visitedSystems,
-		const std::set<const Planet *> *visitedPlanets) const;
+	bool Inject(const ConditionsStore *playerConditions, const IndexedSet<System> *visitedSystems,
+		const IndexedSet<Planet> *visitedPlanets) const;
 
 	// Types of datafiles that can be stored.
 	enum class Type {UNSPECIFIED, SAVEGAME, MISSION};
@@ -49,8 +51,8 @@ private:
 	bool InjectSavegame() const;
 
 	// Loads a mission stored in testdata into a Mission through GameData.
-	bool InjectMission(const ConditionsStore *playerConditions, const std::set<const System *> *visitedSystems,
-		const std::set<const Planet *> *visitedPlanets) const;
+	bool InjectMission(const ConditionsStore *playerConditions, const IndexedSet<System> *visitedSystems,
+		const IndexedSet<Planet> *visitedPlanets) const;
 
 
 private:
@@ -19,19 +19,19 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Utf8.h"
 #include "../Color.h"
 #include "DisplayText.h"
-#include "../Files.h"
 #include "../GameData.h"
+#include "GlyphAtlas.h"
+#include "LayoutCache.h"
+#include "../shader/GpuProfiler.h"
 #include "../image/ImageBuffer.h"
 #include "../image/ImageFileData.h"
 #include "../Point.h"
 #include "../Preferences.h"
 #include "../Screen.h"
+#include "TextBatch.h"
 #include "Truncate.h"
 #include "Utf8.h"
 
-#define STB_TRUETYPE_IMPLEMENTATION
-#include <stb_truetype.h>
-
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
@@ -43,72 +43,6 @@ using namespace std;
 namespace {
 	bool showUnderlines = false;
 
-	enum class VerticalPlacement {
-		BOTTOM,
-		MIDDLE,
-		TOP
-	};
-
-	VerticalPlacement GlyphVerticalPlacement(uint32_t codepoint)
-	{
-		switch(codepoint)
-		{
-			// Midline punctuation / operators / dashes.
-			case 0x002Bu: // +
-			case 0x003Du: // =
-			case 0x002Au: // *
-			case 0x002Fu: // /
-			case 0x005Cu: // '\'
-			case 0x007Cu: // |
-			case 0x003Cu: // <
-			case 0x003Eu: // >
-			case 0x007Eu: // ~
-			case 0x002Du: // -
-			case 0x2010u: // ‐
-			case 0x2011u: // ‑
-			case 0x2012u: // ‒
-			case 0x2013u: // –
-			case 0x2014u: // —
-			case 0x00ABu: // «
-			case 0x00BBu: // »
-			case 0x2039u: // ‹
-			case 0x203Au: // ›
-			case 0x00B7u: // ·
-			case 0x2022u: // •
-			case 0x2219u: // ∙
-				return VerticalPlacement::MIDDLE;
-
-			// Top punctuation / quote-like / accent marks.
-			case 0x0027u: // '
-			case 0x0022u: // "
-			case 0x0060u: // `
-			case 0x005Eu: // ^
-			case 0x00B4u: // ´
-			case 0x00A8u: // ¨
-			case 0x00AFu: // ¯
-			case 0x02BCu: // ʼ
-			case 0x02C7u: // ˇ
-			case 0x02CAu: // ˊ
-			case 0x02CBu: // ˋ
-			case 0x02DCu: // ˜
-			case 0x2018u: // ‘
-			case 0x2019u: // ’
-			case 0x201Au: // ‚
-			case 0x201Bu: // ‛
-			case 0x201Cu: // “
-			case 0x201Du: // ”
-			case 0x201Eu: // „
-			case 0x201Fu: // ‟
-			case 0x2032u: // ′
-			case 0x2033u: // ″
-				return VerticalPlacement::TOP;
-
-			// Default: baseline/bottom-aligned symbols (letters, digits, . , _ etc).
-			default:
-				return VerticalPlacement::BOTTOM;
-		}
-	}
-
 	/// Returns a substitute codepoint for unsupported special characters, or 0 if none.
 	/// Only maps symbols where substitute preserves meaning; otherwise caller uses space.
 	uint32_t SubstituteUnsupported(uint32_t codepoint)
@@ -135,7 +69,8 @@ namespace {
 	GLint glyphI = 0;
 	GLint aspectI = 0;
 	GLint positionI = 0;
-	GLint glyphCountI = 0;
+	GLint gridI = 0;
+	GLint distanceFieldI = 0;
 
 	GLint vertI;
 	GLint cornerI;
@@ -189,6 +124,10 @@ namespace {
 
 
 
+Font::Font() noexcept = default;
+
+
+
 Font::Font(const filesystem::path &imagePath)
 {
 	Load(imagePath);
@@ -196,12 +135,18 @@ Font::Font(const filesystem::path &imagePath)
 
 
 
+Font::~Font() = default;
+
+
+
 void Font::Load(const filesystem::path &imagePath)
 {
 	ImageBuffer image;
 	if(!image.Read(ImageFileData(imagePath)))
 		return;
 
+	LayoutKey::Invalidate();
+	atlas.reset();
 	glyphCount = GLYPHS;
 	LoadTexture(image);
 	CalculateAdvances(image, glyphCount);
@@ -210,6 +155,7 @@ void Font::Load(const filesystem::path &imagePath)
 }
 
 
+
 void Font::LoadFromTtf(const filesystem::path &ttfPath, int pixelHeight)
 {
 	if(texture)
@@ -218,98 +164,24 @@ void Font::LoadFromTtf(const filesystem::path &ttfPath, int pixelHeight)
 		texture = 0;
 	}
 
-	string ttfData = Files::Read(ttfPath);
-	if(ttfData.empty())
+	LayoutKey::Invalidate();
+	atlas = GlyphAtlas::Get(ttfPath);
+	if(!atlas)
 		return;
 
-	const unsigned char *data = reinterpret_cast<const unsigned char *>(ttfData.data());
-	stbtt_fontinfo font;
-	if(!stbtt_InitFont(&font, data, stbtt_GetFontOffsetForIndex(data, 0)))
-		return;
-
-	const float scale = stbtt_ScaleForPixelHeight(&font, static_cast<float>(pixelHeight));
-
-	// Codepoints for 167 glyphs: ASCII 32-126 (95), then 96='?', 97=open quote, 98=close quote;
-	// then А-Я (98-129), Ё(130), а-я(131-162), ё(163); then 164=em dash, 165=«, 166=».
-	vector<uint32_t> codepoints;
-	codepoints.reserve(GLYPHS_EXTENDED);
-	for(int c = 32; c <= 126; ++c)
-		codepoints.push_back(static_cast<uint32_t>(c));
-	codepoints.push_back(63);
-	codepoints.push_back(0x2018u);
-	codepoints.push_back(0x201Cu);
-	for(int c = 0x0410; c <= 0x042F; ++c)
-		codepoints.push_back(static_cast<uint32_t>(c));
-	codepoints.push_back(0x0401u);
-	for(int c = 0x0430; c <= 0x044F; ++c)
-		codepoints.push_back(static_cast<uint32_t>(c));
-	codepoints.push_back(0x0451u);
-	codepoints.push_back(0x2014u); // em dash —
-	codepoints.push_back(0x00ABu); // left guillemet «
-	codepoints.push_back(0x00BBu); // right guillemet »
-
-	const int cellW = pixelHeight * 2;
-	const int cellH = pixelHeight * 2;
-	const int atlasW = GLYPHS_EXTENDED * cellW;
-	const int atlasH = cellH;
-
-	ImageBuffer image;
-	image.Clear(1);
-	image.Allocate(atlasW, atlasH);
-	uint32_t *pixels = image.Pixels();
-	fill(pixels, pixels + atlasW * atlasH, 0u);
-
-	vector<unsigned char> temp(cellW * cellH);
-	for(size_t i = 0; i < codepoints.size(); ++i)
-	{
-		int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
-		stbtt_GetCodepointBitmapBox(&font, codepoints[i], scale, scale, &x0, &y0, &x1, &y1);
-		int w = x1 - x0;
-		int h = y1 - y0;
-		if(w <= 0 || h <= 0)
-			continue;
-		if(w > cellW) w = cellW;
-		if(h > cellH) h = cellH;
-		fill(temp.begin(), temp.end(), 0);
-		stbtt_MakeCodepointBitmap(&font, temp.data(), w, h, cellW, scale, scale, codepoints[i]);
-		int dx = i * cellW + (cellW - w) / 2;
-		const int bottomAnchor = cellH;
-		const int middleAnchor = bottomAnchor - cellH / 2;
-		const int topAnchor = bottomAnchor - cellH;
-
-		int dy = 0;
-		switch(GlyphVerticalPlacement(codepoints[i]))
-		{
-			case VerticalPlacement::BOTTOM:
-				dy = bottomAnchor - h;
-				break;
-			case VerticalPlacement::MIDDLE:
-				dy = static_cast<int>(round(middleAnchor - h / 2.));
-				break;
-			case VerticalPlacement::TOP:
-				dy = topAnchor;
-				break;
-		}
-		// Additional global lift for Russian TTF text: raise all placements by one font height.
-		dy -= cellH / 2;
-		dy = max(0, min(cellH - h, dy));
-		for(int y = 0; y < h; ++y)
-			for(int x = 0; x < w; ++x)
-			{
-				unsigned a = temp[y * cellW + x];
-				pixels[(dy + y) * atlasW + (dx + x)] = (static_cast<uint32_t>(a) << 24)
-					| (static_cast<uint32_t>(a) << 16) | (static_cast<uint32_t>(a) << 8) | a;
-			}
-	}
-
-	glyphCount = GLYPHS_EXTENDED;
-	LoadTexture(image);
-	CalculateAdvances(image, glyphCount);
-	SetUpShader(static_cast<float>(cellW), static_cast<float>(cellH), glyphCount);
+	// The atlas's cells are drawn at half size for a font of its pixel height,
+	// and scaled from there to this font's height.
+	advance.clear();
+	atlasScale = .5 * pixelHeight / GlyphAtlas::PIXEL_HEIGHT;
+	height = pixelHeight;
+	space = (pixelHeight + 3) / 6 + 1;
+	SetUpShader(static_cast<float>(atlas->CellWidth() * 2. * atlasScale),
+		static_cast<float>(atlas->CellHeight() * 2. * atlasScale), glyphCount);
 	widthEllipses = WidthRawString(string("..."));
 }
 
 
+
 void Font::Draw(const DisplayText &text, const Point &point, const Color &color) const
 {
 	DrawAliased(text, round(point.X()), round(point.Y()), color);
@@ -343,51 +215,118 @@ void Font::Draw(const string &str, const Point &point, const Color &color) const
 
 void Font::DrawAliased(const string &str, double x, double y, const Color &color) const
 {
-	glUseProgram(shader->Object());
-	glUniform1i(glyphCountI, glyphCount);
-	glBindTexture(GL_TEXTURE_2D, texture);
-	if(OpenGL::HasVaoSupport())
-		glBindVertexArray(vao);
-	else
+	// Text that is batched is drawn later, by the TextBatch.
+	const bool batched = TextBatch::IsActive();
+	const int columns = atlas ? GlyphAtlas::COLUMNS : glyphCount;
+	const int rows = atlas ? GlyphAtlas::ROWS : 1;
+	const int kern = Preferences::LetterSpacing();
+	const float scaleFactor = Preferences::FontScale() / 100.f;
+
+	// Glyphs in a batch must stay in the atlas until it is drawn, so they are
+	// all treated as part of one string.
+	if(atlas && !batched)
+		atlas->BeginUse();
+	GLuint boundTexture = 0;
+	if(!batched)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		EnableAttribArrays();
-	}
+		glUseProgram(shader->Object());
+		glUniform2i(gridI, columns, rows);
+		glUniform1i(distanceFieldI, atlas != nullptr);
+		if(!atlas)
+		{
+			glBindTexture(GL_TEXTURE_2D, texture);
+			GpuProfiler::CountTextureBind();
+			boundTexture = texture;
+		}
+		if(OpenGL::HasVaoSupport())
+			glBindVertexArray(vao);
+		else
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+			EnableAttribArrays();
+		}
 
-	glUniform4fv(colorI, 1, color.Get());
+		glUniform4fv(colorI, 1, color.Get());
 
-	// Update the scale, only if the screen size has changed.
-	if(Screen::Width() != screenWidth || Screen::Height() != screenHeight)
-	{
-		screenWidth = Screen::Width();
-		screenHeight = Screen::Height();
-		scale[0] = 2.f / screenWidth;
-		scale[1] = -2.f / screenHeight;
+		// Update the scale, only if the screen size has changed.
+		if(Screen::Width() != screenWidth || Screen::Height() != screenHeight)
+		{
+			screenWidth = Screen::Width();
+			screenHeight = Screen::Height();
+			scale[0] = 2.f / screenWidth;
+			scale[1] = -2.f / screenHeight;
+		}
+		glUniform2fv(scaleI, 1, scale);
+		glUniform2f(glyphSizeI, glyphWidth * scaleFactor, glyphHeight * scaleFactor);
 	}
-	const int kern = Preferences::LetterSpacing();
-	const float scaleFactor = Preferences::FontScale() / 100.f;
-	glUniform2fv(scaleI, 1, scale);
-	glUniform2f(glyphSizeI, glyphWidth * scaleFactor, glyphHeight * scaleFactor);
 
 	const double drawY = y;
 	GLfloat textPos[2] = {
 		static_cast<float>(x - 1.),
 		static_cast<float>(drawY)};
+
+	// Draw a glyph at the current position, stretched horizontally by the given
+	// aspect ratio. For a TrueType font, this first uploads any newly rasterized
+	// glyphs, since the glyph may be one of them.
+	auto drawGlyph = [&](int glyph, float aspect)
+	{
+		GLuint glyphTexture = texture;
+		int cell = glyph;
+		if(atlas)
+		{
+			if(atlas->Upload())
+				boundTexture = 0;
+			glyphTexture = atlas->Texture(glyph);
+			cell = atlas->Cell(glyph);
+		}
+
+		if(batched)
+		{
+			const float left = (cell % columns) / static_cast<float>(columns);
+			const float top = (cell / columns) / static_cast<float>(rows);
+			const float corners[4] = {textPos[0], textPos[1],
+				textPos[0] + aspect * glyphWidth * scaleFactor, textPos[1] + glyphHeight * scaleFactor};
+			const float texCoords[4] = {left, top, left + 1.f / columns, top + 1.f / rows};
+			TextBatch::Add(glyphTexture, atlas != nullptr, corners, texCoords, color);
+			return;
+		}
+
+		if(glyphTexture != boundTexture)
+		{
+			glBindTexture(GL_TEXTURE_2D, glyphTexture);
+			GpuProfiler::CountTextureBind();
+			boundTexture = glyphTexture;
+		}
+		glUniform1i(glyphI, cell);
+		glUniform1f(aspectI, aspect);
+		glUniform2fv(positionI, 1, textPos);
+
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		GpuProfiler::CountDrawCall();
+	};
+
 	int previous = 0;
 	bool isAfterSpace = true;
 	bool underlineChar = false;
-	const int underscoreGlyph = max(0, min(glyphCount - 1, static_cast<int>('_' - 32)));
+	const int underscoreGlyph = atlas ? GlyphForCodepoint('_', false)
+		: max(0, min(glyphCount - 1, static_cast<int>('_' - 32)));
 
 	size_t pos = 0;
-	while(pos < str.size())
+	char32_t codePoints[64];
+	size_t count = 0;
+	size_t next = 0;
+	while(next < count || pos < str.size())
 	{
-		char32_t cp = Utf8::DecodeCodePoint(str, pos);
-		if(pos == string::npos)
-			break;
+		if(next == count)
+		{
+			count = Utf8::DecodeCodePoints(str, pos, codePoints, size(codePoints));
+			next = 0;
+		}
+		const char32_t cp = codePoints[next++];
 
 		if(cp == '_')
 		{
-			underlineChar = showUnderlines;
+			underlineChar = showUnderlines && underscoreGlyph;
 			continue;
 		}
 
@@ -400,29 +339,21 @@ void Font::DrawAliased(const string &str, double x, double y, const Color &color
 			continue;
 		}
 
-		glUniform1i(glyphI, glyph);
-		glUniform1f(aspectI, 1.f);
-
-		textPos[0] += (advance[previous * glyphCount + glyph] + kern) * scaleFactor;
-		glUniform2fv(positionI, 1, textPos);
-
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		textPos[0] += (Advance(previous, glyph) + kern) * scaleFactor;
+		drawGlyph(glyph, 1.f);
 
 		if(underlineChar)
 		{
-			glUniform1i(glyphI, underscoreGlyph);
-			glUniform1f(aspectI, static_cast<float>(advance[glyph * glyphCount] + kern)
-				/ (advance[underscoreGlyph * glyphCount] + kern));
-
-			glUniform2fv(positionI, 1, textPos);
-
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			drawGlyph(underscoreGlyph, static_cast<float>(Advance(glyph, 0) + kern)
+				/ (Advance(underscoreGlyph, 0) + kern));
 			underlineChar = false;
 		}
 
 		previous = glyph;
 	}
 
+	if(batched)
+		return;
 	if(OpenGL::HasVaoSupport())
 		glBindVertexArray(0);
 	else
@@ -488,6 +419,19 @@ int Font::Glyph(char c, bool isAfterSpace) noexcept
 
 int Font::GlyphForCodepoint(uint32_t codepoint, bool isAfterSpace) const
 {
+	if(atlas)
+	{
+		// Opening quotes are curly, if the font has curly quotes.
+		if(isAfterSpace && (codepoint == '\'' || codepoint == '"'))
+			if(int glyph = atlas->Find(codepoint == '\'' ? 0x2018u : 0x201Cu))
+				return glyph;
+		if(int glyph = atlas->Find(codepoint))
+			return glyph;
+		// Fall back to a substitute if the font has no glyph for this character.
+		uint32_t sub = SubstituteUnsupported(codepoint);
+		return sub ? atlas->Find(sub) : 0;
+	}
+
 	constexpr char32_t invalidCp = 0xFFFFFFFFu;
 	// Curly quotes (ASCII and Unicode opening quotes).
 	if((codepoint == '\'' || codepoint == 0x2018u) && isAfterSpace)
@@ -497,18 +441,6 @@ int Font::GlyphForCodepoint(uint32_t codepoint, bool isAfterSpace) const
 	// ASCII printable range: use existing glyphs.
 	if(codepoint >= 32 && codepoint <= 126)
 		return max(0, min(glyphCount - 3, static_cast<int>(codepoint - 32)));
-	if(glyphCount == GLYPHS_EXTENDED)
-	{
-		if(codepoint >= 0x0410u && codepoint <= 0x042Fu)
-			return 98 + static_cast<int>(codepoint - 0x0410u);
-		if(codepoint == 0x0401u) return 130;
-		if(codepoint >= 0x0430u && codepoint <= 0x044Fu)
-			return 131 + static_cast<int>(codepoint - 0x0430u);
-		if(codepoint == 0x0451u) return 163;
-		if(codepoint == 0x2014u) return 164; // em dash —
-		if(codepoint == 0x00ABu) return 165; // left guillemet «
-		if(codepoint == 0x00BBu) return 166; // right guillemet »
-	}
 	// Fallback: try substitute for other unsupported special characters.
 	if(codepoint != invalidCp)
 	{
@@ -644,7 +576,8 @@ void Font::SetUpShader(float glyphW, float glyphH, int glyphCountParam)
 		glyphI = shader->Uniform("glyph");
 		aspectI = shader->Uniform("aspect");
 		positionI = shader->Uniform("position");
-		glyphCountI = shader->Uniform("glyphCount");
+		gridI = shader->Uniform("grid");
+		distanceFieldI = shader->Uniform("distanceField");
 	}
 
 	screenWidth = 0;
@@ -653,36 +586,69 @@ void Font::SetUpShader(float glyphW, float glyphH, int glyphCountParam)
 
 
 
+int Font::Advance(int previous, int next) const
+{
+	if(atlas)
+		return static_cast<int>(atlas->Advance(previous, next) * atlasScale);
+	return advance[previous * glyphCount + next];
+}
+
+
+
 int Font::WidthRawString(const string &str, char after) const noexcept
 {
 	int width = 0;
 	int previous = 0;
 	bool isAfterSpace = true;
 	const int kern = Preferences::LetterSpacing();
+	if(atlas && !TextBatch::IsActive())
+		atlas->BeginUse();
 
-	size_t pos = 0;
-	while(pos < str.size())
+	auto add = [&](char32_t cp, int glyph)
 	{
-		char32_t cp = Utf8::DecodeCodePoint(str, pos);
-		if(pos == string::npos)
-			break;
-
-		if(cp == '_')
-			continue;
-
-		int glyph = GlyphForCodepoint(cp, isAfterSpace);
 		if(cp != '"' && cp != '\'')
 			isAfterSpace = !glyph;
 		if(!glyph)
 			width += space;
 		else
 		{
-			width += advance[previous * glyphCount + glyph] + kern;
+			width += Advance(previous, glyph) + kern;
 			previous = glyph;
 		}
+	};
+
+	size_t pos = 0;
+	char32_t codePoints[64];
+	while(pos < str.size())
+	{
+		// Image fonts have their glyphs in ASCII order, so runs of ASCII text
+		// are measured straight from the bytes, without decoding them.
+		if(!atlas)
+		{
+			const size_t end = pos + Utf8::AsciiLength(str, pos);
+			for( ; pos < end; ++pos)
+			{
+				const char c = str[pos];
+				if(c == '_')
+					continue;
+				if(isAfterSpace && (c == '\'' || c == '"'))
+					add(c, c == '\'' ? 96 : 97);
+				else
+					add(c, (c >= 32 && c <= 126) ? c - 32 : 0);
+			}
+			if(pos >= str.size())
+				break;
+		}
+
+		const size_t count = Utf8::DecodeCodePoints(str, pos, codePoints, size(codePoints));
+		for(size_t i = 0; i < count; ++i)
+			if(codePoints[i] != '_')
+				add(codePoints[i], GlyphForCodepoint(codePoints[i], isAfterSpace));
 	}
-	const int afterGlyph = (after >= 32 && after <= 126) ? (after - 32) : 0;
-	width += advance[previous * glyphCount + max(0, min(glyphCount - 1, afterGlyph))];
+	int afterGlyph = 0;
+	if(after > ' ' && after <= '~')
+		afterGlyph = atlas ? GlyphForCodepoint(after, false) : after - 32;
+	width += Advance(previous, afterGlyph);
 
 	return static_cast<int>(width * Preferences::FontScale() / 100.);
 }
@@ -697,20 +663,38 @@ string Font::TruncateText(const DisplayText &text, int &width) const
 	const string &str = text.GetText();
 	if(layout.width < 0 || (layout.align == Alignment::LEFT && layout.truncate == Truncate::NONE))
 		return str;
+
+	// Truncating takes a search over many candidate strings, and the same text
+	// is usually drawn with the same layout every frame, so remember the results.
+	static LayoutCache<pair<string, int>> cache(1024);
+	const LayoutKey key(*this, str, layout.width, layout.align, layout.truncate);
+	if(const auto *result = cache.Find(key))
+	{
+		width = result->second;
+		return result->first;
+	}
+
+	string result;
 	width = layout.width;
 	switch(layout.truncate)
 	{
 		case Truncate::NONE:
 			width = WidthRawString(str);
-			return str;
+			result = str;
+			break;
 		case Truncate::FRONT:
-			return TruncateFront(str, width);
+			result = TruncateFront(str, width);
+			break;
 		case Truncate::MIDDLE:
-			return TruncateMiddle(str, width);
+			result = TruncateMiddle(str, width);
+			break;
 		case Truncate::BACK:
 		default:
-			return TruncateBack(str, width);
+			result = TruncateBack(str, width);
+			break;
 	}
+	cache.Insert(key, make_pair(result, width));
+	return result;
 }
 
 
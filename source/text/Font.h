@@ -22,27 +22,32 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 class Color;
 class DisplayText;
+class GlyphAtlas;
 class ImageBuffer;
 class Point;
 
 
 
-// Class for drawing text in OpenGL. Each font is based on a single image with
-// glyphs for each character in ASCII order (not counting control characters).
-// The kerning between characters is automatically adjusted to look good. At the
-// moment only plain ASCII characters are supported, not Unicode.
+// Class for drawing text in OpenGL. A font is either based on a single image with
+// glyphs for each character in ASCII order (not counting control characters), or
+// on a TrueType font, whose glyphs are rasterized into an atlas as they are
+// needed, so any Unicode character that the font has can be drawn. TrueType
+// glyphs are drawn from signed distance fields, so every size of a font shares
+// one atlas. The kerning between characters is automatically adjusted to look good.
 class Font {
 public:
-	Font() noexcept = default;
+	Font() noexcept;
 	explicit Font(const std::filesystem::path &imagePath);
+	~Font();
 
 	void Load(const std::filesystem::path &imagePath);
-	// Load font from TTF (extended atlas with Cyrillic). Uses glyph count 164.
+	// Load font from TTF, to be drawn at the given pixel height.
 	void LoadFromTtf(const std::filesystem::path &ttfPath, int pixelHeight);
 
 	// Draw a text string, subject to the given layout and truncation strategy.
@@ -70,6 +75,7 @@ private:
 	void LoadTexture(ImageBuffer &image);
 	void CalculateAdvances(ImageBuffer &image, int glyphCount);
 	void SetUpShader(float glyphW, float glyphH, int glyphCount);
+	int Advance(int previous, int next) const;
 
 	int WidthRawString(const std::string &str, char after = ' ') const noexcept;
 
@@ -94,8 +100,11 @@ private:
 	GLfloat glyphHeight = 0.f;
 
 	static const int GLYPHS = 98;
-	static const int GLYPHS_EXTENDED = 167;
 	int glyphCount = GLYPHS;
 	std::vector<int> advance;
+	// For TrueType fonts. The atlas is a cache, so it is filled in even through a const Font.
+	std::shared_ptr<GlyphAtlas> atlas;
+	// The size of one of the atlas's pixels in this font's pixels.
+	double atlasScale = 1.;
 	int widthEllipses = 0;
 };
@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Format.h"
 
 #include "../Preferences.h"
+#include "TextTemplate.h"
 #include "Translation.h"
 
 #include <algorithm>
@@ -813,6 +814,13 @@ string Format::Replace(const string &source, const map<string, string> &keys)
 
 
 
+string Format::Replace(const TextTemplate &source, const map<string, string> &keys)
+{
+	return source.Expand(keys);
+}
+
+
+
 string Format::ReplaceTranslated(const string &source, map<string, string> &keys)
 {
 	Translation::TranslateSubstitutionValues(keys);
@@ -821,6 +829,14 @@ string Format::ReplaceTranslated(const string &source, map<string, string> &keys
 
 
 
+string Format::ReplaceTranslated(const TextTemplate &source, map<string, string> &keys)
+{
+	Translation::TranslateSubstitutionValues(keys);
+	return Replace(source, keys);
+}
+
+
+
 void Format::Expand(map<string, string> &keys)
 {
 	map<string, string> newKeys;
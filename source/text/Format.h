@@ -24,6 +24,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <string>
 #include <vector>
 
+class TextTemplate;
+
 
 
 // Collection of functions for formatting strings for display.
@@ -95,8 +97,12 @@ public:
 	// Replace a set of "keys," which must be strings in the form "<name>", with
 	// a new set of strings, and return the result.
 	static std::string Replace(const std::string &source, const std::map<std::string, std::string> &keys);
+	// Same as above, for text that has already been scanned for its keys. This is
+	// faster for text that is used many times.
+	static std::string Replace(const TextTemplate &source, const std::map<std::string, std::string> &keys);
 	// Same as Replace, but first translates substitution values for known keys (commodity, government, planet, system).
 	static std::string ReplaceTranslated(const std::string &source, std::map<std::string, std::string> &keys);
+	static std::string ReplaceTranslated(const TextTemplate &source, std::map<std::string, std::string> &keys);
 	// Recursively expand substitutions in all key/value pairs. Will detect
 	// infinite recursion; offending substitutions will not be expanded.
 	static void Expand(std::map<std::string, std::string> &keys);
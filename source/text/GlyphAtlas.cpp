@@ -0,0 +1,420 @@
+/* GlyphAtlas.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "GlyphAtlas.h"
+
+#include "../Files.h"
+#include "../opengl.h"
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+using namespace std;
+
+namespace {
+	constexpr int CELLS = GlyphAtlas::COLUMNS * GlyphAtlas::ROWS;
+	// Once this many pages are full, the least recently used glyphs are evicted.
+	constexpr int MAX_PAGES = 4;
+	// The distance field value on a glyph's outline. Pixels with at least this
+	// value are inside the glyph, and count as part of it when kerning.
+	constexpr unsigned char ON_EDGE = 128;
+	// How far outside of its outline a glyph's distance field extends, in pixels.
+	constexpr int PADDING = 4;
+
+	// Each font file's atlas, for as long as some font is using it.
+	map<filesystem::path, weak_ptr<GlyphAtlas>> atlases;
+
+	enum class VerticalPlacement {
+		BOTTOM,
+		MIDDLE,
+		TOP
+	};
+
+	VerticalPlacement GlyphVerticalPlacement(uint32_t codepoint)
+	{
+		switch(codepoint)
+		{
+			// Midline punctuation / operators / dashes.
+			case 0x002Bu: // +
+			case 0x003Du: // =
+			case 0x002Au: // *
+			case 0x002Fu: // /
+			case 0x005Cu: // '\'
+			case 0x007Cu: // |
+			case 0x003Cu: // <
+			case 0x003Eu: // >
+			case 0x007Eu: // ~
+			case 0x002Du: // -
+			case 0x2010u: // ‐
+			case 0x2011u: // ‑
+			case 0x2012u: // ‒
+			case 0x2013u: // –
+			case 0x2014u: // —
+			case 0x00ABu: // «
+			case 0x00BBu: // »
+			case 0x2039u: // ‹
+			case 0x203Au: // ›
+			case 0x00B7u: // ·
+			case 0x2022u: // •
+			case 0x2219u: // ∙
+				return VerticalPlacement::MIDDLE;
+
+			// Top punctuation / quote-like / accent marks.
+			case 0x0027u: // '
+			case 0x0022u: // "
+			case 0x0060u: // `
+			case 0x005Eu: // ^
+			case 0x00B4u: // ´
+			case 0x00A8u: // ¨
+			case 0x00AFu: // ¯
+			case 0x02BCu: // ʼ
+			case 0x02C7u: // ˇ
+			case 0x02CAu: // ˊ
+			case 0x02CBu: // ˋ
+			case 0x02DCu: // ˜
+			case 0x2018u: // ‘
+			case 0x2019u: // ’
+			case 0x201Au: // ‚
+			case 0x201Bu: // ‛
+			case 0x201Cu: // “
+			case 0x201Du: // ”
+			case 0x201Eu: // „
+			case 0x201Fu: // ‟
+			case 0x2032u: // ′
+			case 0x2033u: // ″
+				return VerticalPlacement::TOP;
+
+			// Default: baseline/bottom-aligned symbols (letters, digits, . , _ etc).
+			default:
+				return VerticalPlacement::BOTTOM;
+		}
+	}
+}
+
+
+
+shared_ptr<GlyphAtlas> GlyphAtlas::Get(const filesystem::path &ttfPath)
+{
+	shared_ptr<GlyphAtlas> atlas = atlases[ttfPath].lock();
+	if(!atlas)
+	{
+		atlas = make_shared<GlyphAtlas>();
+		if(!atlas->Load(ttfPath))
+			return nullptr;
+		atlases[ttfPath] = atlas;
+	}
+	return atlas;
+}
+
+
+
+GlyphAtlas::GlyphAtlas() noexcept = default;
+
+
+
+GlyphAtlas::~GlyphAtlas() = default;
+
+
+
+bool GlyphAtlas::Load(const filesystem::path &ttfPath)
+{
+	Clear();
+	info.reset();
+	data = Files::Read(ttfPath);
+	if(data.empty())
+		return false;
+
+	// The font info points into the file data, so the data is kept as long as the font is.
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data.data());
+	auto font = make_unique<stbtt_fontinfo>();
+	if(!stbtt_InitFont(font.get(), bytes, stbtt_GetFontOffsetForIndex(bytes, 0)))
+	{
+		data.clear();
+		return false;
+	}
+	info = std::move(font);
+
+	scale = stbtt_ScaleForPixelHeight(info.get(), static_cast<float>(PIXEL_HEIGHT));
+	cellWidth = PIXEL_HEIGHT * 2;
+	cellHeight = PIXEL_HEIGHT * 2;
+	return true;
+}
+
+
+
+int GlyphAtlas::CellWidth() const noexcept
+{
+	return cellWidth;
+}
+
+
+
+int GlyphAtlas::CellHeight() const noexcept
+{
+	return cellHeight;
+}
+
+
+
+void GlyphAtlas::BeginUse()
+{
+	++useCount;
+}
+
+
+
+int GlyphAtlas::Find(uint32_t codepoint)
+{
+	if(!info)
+		return 0;
+
+	auto it = entries.find(codepoint);
+	if(it == entries.end())
+	{
+		Entry entry;
+		if(!Rasterize(codepoint, entry))
+			return 0;
+		it = entries.emplace(codepoint, std::move(entry)).first;
+	}
+	it->second.lastUse = useCount;
+	return it->second.slot + 1;
+}
+
+
+
+int GlyphAtlas::Advance(int previous, int next)
+{
+	if(!previous)
+		return 0;
+
+	// Advances are remembered by code point, so they stay valid if either glyph is evicted.
+	const uint32_t first = slots[previous - 1];
+	const uint32_t second = next ? slots[next - 1] : 0;
+	const uint64_t key = (static_cast<uint64_t>(first) << 32) | second;
+	auto it = advances.find(key);
+	if(it != advances.end())
+		return it->second;
+
+	// This is the same measurement that Font makes for a fixed atlas: the glyphs
+	// are placed as close together as they can be without touching on any row.
+	const Entry &left = entries.at(first);
+	const Entry *right = next ? &entries.at(second) : nullptr;
+	int maxD = 0;
+	for(int y = 0; y < cellHeight; ++y)
+	{
+		int distance = left.right[y];
+		if(right)
+			distance += 1 - right->left[y];
+		maxD = max(maxD, distance);
+	}
+	// This is a fudge factor to avoid over-kerning, especially for the
+	// underscore and for glyph combinations like AV.
+	const int result = max(maxD, left.width - 4);
+	advances.emplace(key, result);
+	return result;
+}
+
+
+
+bool GlyphAtlas::Upload()
+{
+	if(pendingSlots.empty())
+		return false;
+
+	const int pageWidth = cellWidth * COLUMNS;
+	const int pageHeight = cellHeight * ROWS;
+	const size_t pages = (slots.size() + CELLS - 1) / CELLS;
+	while(textures.size() < pages)
+	{
+		GLuint texture = 0;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		// A distance field only needs one channel. Start with every pixel as far
+		// outside of a glyph as can be, so filtering never picks up an empty cell.
+		const vector<uint8_t> blank(static_cast<size_t>(pageWidth) * pageHeight, 0);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, pageWidth, pageHeight, 0,
+			GL_RED, GL_UNSIGNED_BYTE, blank.data());
+		textures.push_back(texture);
+	}
+
+	const size_t cellSize = static_cast<size_t>(cellWidth) * cellHeight;
+	for(size_t i = 0; i < pendingSlots.size(); ++i)
+	{
+		const int slot = pendingSlots[i];
+		const int cell = slot % CELLS;
+		glBindTexture(GL_TEXTURE_2D, textures[slot / CELLS]);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, (cell % COLUMNS) * cellWidth, (cell / COLUMNS) * cellHeight,
+			cellWidth, cellHeight, GL_RED, GL_UNSIGNED_BYTE, pendingPixels.data() + i * cellSize);
+	}
+	pendingSlots.clear();
+	pendingPixels.clear();
+	return true;
+}
+
+
+
+uint32_t GlyphAtlas::Texture(int glyph) const
+{
+	return textures[(glyph - 1) / CELLS];
+}
+
+
+
+int GlyphAtlas::Cell(int glyph) const
+{
+	return (glyph - 1) % CELLS;
+}
+
+
+
+// Draw the glyph for the given code point into a new cell. Code points that the
+// font has nothing to draw for are given no cell. Returns false if a cell was
+// needed but every cell holds a glyph that is in use.
+bool GlyphAtlas::Rasterize(uint32_t codepoint, Entry &entry)
+{
+	int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+	stbtt_GetCodepointBitmapBox(info.get(), static_cast<int>(codepoint), scale, scale, &x0, &y0, &x1, &y1);
+	const int w = min(x1 - x0, cellWidth);
+	const int h = min(y1 - y0, cellHeight);
+	if(w <= 0 || h <= 0 || !stbtt_FindGlyphIndex(info.get(), static_cast<int>(codepoint)))
+		return true;
+
+	int sdfWidth = 0, sdfHeight = 0, sdfX = 0, sdfY = 0;
+	unsigned char *sdf = stbtt_GetCodepointSDF(info.get(), scale, static_cast<int>(codepoint), PADDING,
+		ON_EDGE, static_cast<float>(ON_EDGE) / PADDING, &sdfWidth, &sdfHeight, &sdfX, &sdfY);
+	if(!sdf)
+		return true;
+
+	const int slot = AllocateSlot();
+	if(slot < 0)
+	{
+		stbtt_FreeSDF(sdf, nullptr);
+		return false;
+	}
+	slots[slot] = codepoint;
+	entry.slot = slot;
+
+	// The glyph's outline is positioned within the cell as it always has been.
+	// Its distance field extends past that by the padding on each side.
+	const int dx = (cellWidth - w) / 2;
+	const int bottomAnchor = cellHeight;
+	const int middleAnchor = bottomAnchor - cellHeight / 2;
+	const int topAnchor = bottomAnchor - cellHeight;
+	int dy = 0;
+	switch(GlyphVerticalPlacement(codepoint))
+	{
+		case VerticalPlacement::BOTTOM:
+			dy = bottomAnchor - h;
+			break;
+		case VerticalPlacement::MIDDLE:
+			dy = static_cast<int>(round(middleAnchor - h / 2.));
+			break;
+		case VerticalPlacement::TOP:
+			dy = topAnchor;
+			break;
+	}
+	// Additional global lift for Russian TTF text: raise all placements by one font height.
+	dy -= cellHeight / 2;
+	dy = max(0, min(cellHeight - h, dy));
+
+	const size_t offset = pendingPixels.size();
+	pendingPixels.resize(offset + static_cast<size_t>(cellWidth) * cellHeight, 0);
+	pendingSlots.push_back(slot);
+	uint8_t *pixels = pendingPixels.data() + offset;
+	const int left = dx + sdfX - x0;
+	const int top = dy + sdfY - y0;
+	for(int y = max(0, -top); y < sdfHeight && top + y < cellHeight; ++y)
+		for(int x = max(0, -left); x < sdfWidth && left + x < cellWidth; ++x)
+			pixels[(top + y) * cellWidth + left + x] = sdf[y * sdfWidth + x];
+	stbtt_FreeSDF(sdf, nullptr);
+
+	// Record where the inside of each row begins and ends, for kerning.
+	entry.left.assign(cellHeight, static_cast<int16_t>(cellWidth));
+	entry.right.assign(cellHeight, 1);
+	entry.width = 0;
+	for(int y = 0; y < cellHeight; ++y)
+	{
+		const uint8_t *row = pixels + y * cellWidth;
+		for(int x = 0; x < cellWidth; ++x)
+			if(row[x] >= ON_EDGE)
+			{
+				entry.left[y] = static_cast<int16_t>(x + 1);
+				break;
+			}
+		for(int x = cellWidth - 1; x >= 0; --x)
+			if(row[x] >= ON_EDGE)
+			{
+				entry.right[y] = static_cast<int16_t>(x + 1);
+				break;
+			}
+		entry.width = max<int>(entry.width, entry.right[y]);
+	}
+	return true;
+}
+
+
+
+// Find a cell for a new glyph, evicting the least recently used glyph if every
+// page is full. Returns -1 if all the glyphs are in use by the current string.
+int GlyphAtlas::AllocateSlot()
+{
+	if(slots.size() < static_cast<size_t>(MAX_PAGES * CELLS))
+	{
+		slots.push_back(0);
+		return static_cast<int>(slots.size() - 1);
+	}
+
+	int oldest = -1;
+	int64_t oldestUse = useCount;
+	for(size_t i = 0; i < slots.size(); ++i)
+	{
+		const int64_t lastUse = entries.at(slots[i]).lastUse;
+		if(lastUse < oldestUse)
+		{
+			oldest = static_cast<int>(i);
+			oldestUse = lastUse;
+		}
+	}
+	if(oldest >= 0)
+		entries.erase(slots[oldest]);
+	return oldest;
+}
+
+
+
+// Forget every glyph. The page textures are deleted, so this must be called
+// from the thread that owns the OpenGL context.
+void GlyphAtlas::Clear()
+{
+	if(!textures.empty())
+		glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+	textures.clear();
+	entries.clear();
+	slots.clear();
+	pendingSlots.clear();
+	pendingPixels.clear();
+	advances.clear();
+	useCount = 0;
+}
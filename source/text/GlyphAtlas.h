@@ -0,0 +1,123 @@
+/* GlyphAtlas.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct stbtt_fontinfo;
+
+
+
+// The glyphs of a TrueType font, rasterized the first time each code point is
+// used. Each glyph is stored as a signed distance field: every pixel holds its
+// distance from the glyph's outline, so that the shader can draw a sharp edge
+// at any scale. One atlas therefore serves every size of the font.
+//
+// Glyphs are placed in the fixed-size cells of a few atlas pages, and once
+// every page is full, the least recently used glyph gives up its cell. Only the
+// cells that changed are uploaded, so memory use follows the glyphs that the
+// game actually draws rather than the size of the font.
+//
+// Glyphs are identified by a number from 1 up; 0 stands for "no glyph", which
+// the Font draws as a space. A glyph's number is only valid until the next
+// call to BeginUse(), since its cell may be reused after that.
+class GlyphAtlas {
+public:
+	static constexpr int COLUMNS = 16;
+	static constexpr int ROWS = 16;
+	// The pixel height that glyphs are rasterized at. As with image fonts, cells
+	// are twice this size, and are drawn at half size for a font of this height.
+	static constexpr int PIXEL_HEIGHT = 24;
+
+
+public:
+	// Get the atlas for the given font file, shared by all the fonts that use
+	// it, or nullptr if the file cannot be read.
+	static std::shared_ptr<GlyphAtlas> Get(const std::filesystem::path &ttfPath);
+
+	GlyphAtlas() noexcept;
+	GlyphAtlas(const GlyphAtlas &) = delete;
+	GlyphAtlas &operator=(const GlyphAtlas &) = delete;
+	~GlyphAtlas();
+
+	int CellWidth() const noexcept;
+	int CellHeight() const noexcept;
+
+	// Start measuring or drawing a new string. Glyphs that are used from now
+	// until the next call will not be evicted to make room for others.
+	void BeginUse();
+	// Get the glyph for the given code point, rasterizing it if it is not in
+	// the atlas. Returns 0 if the font has nothing to draw for it.
+	int Find(uint32_t codepoint);
+	// Get the distance from the start of the previous glyph to the start of the
+	// next one, or the full width of the previous glyph if next is 0. This is
+	// measured in the atlas's pixels, so it must be scaled to the font's size.
+	int Advance(int previous, int next);
+
+	// Send the glyphs that were rasterized since the last call to the GPU.
+	// This must be called from the thread that owns the OpenGL context, and
+	// it may change the bound texture. Returns true if anything was uploaded.
+	bool Upload();
+	// Get the page texture and the cell within it that contain a glyph.
+	uint32_t Texture(int glyph) const;
+	int Cell(int glyph) const;
+
+
+private:
+	// A rasterized glyph, with the outline of its inside pixels on each row.
+	class Entry {
+	public:
+		int slot = -1;
+		int64_t lastUse = 0;
+		int width = 0;
+		std::vector<int16_t> left;
+		std::vector<int16_t> right;
+	};
+
+
+private:
+	// Read the font file. The atlas starts out empty.
+	bool Load(const std::filesystem::path &ttfPath);
+	bool Rasterize(uint32_t codepoint, Entry &entry);
+	int AllocateSlot();
+	void Clear();
+
+
+private:
+	std::string data;
+	std::unique_ptr<stbtt_fontinfo> info;
+	float scale = 0.f;
+	int cellWidth = 0;
+	int cellHeight = 0;
+
+	// Code points the font cannot draw are cached as well, with no slot.
+	std::unordered_map<uint32_t, Entry> entries;
+	// The code point in each slot, or 0 if it is free.
+	std::vector<uint32_t> slots;
+	std::vector<uint32_t> textures;
+	int64_t useCount = 0;
+
+	// The cells that must still be uploaded, and their pixels.
+	std::vector<int> pendingSlots;
+	std::vector<uint8_t> pendingPixels;
+
+	std::unordered_map<uint64_t, int> advances;
+};
@@ -0,0 +1,63 @@
+/* LayoutCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "LayoutCache.h"
+
+#include "../Preferences.h"
+
+#include <atomic>
+
+using namespace std;
+
+namespace {
+	atomic<int> currentGeneration = 0;
+}
+
+
+
+LayoutKey::LayoutKey(const Font &font, const string &text, int width, Alignment align, Truncate truncate)
+	: font(&font), text(text), width(width), align(align), truncate(truncate),
+	letterSpacing(Preferences::LetterSpacing()), fontScale(Preferences::FontScale()),
+	generation(currentGeneration)
+{
+}
+
+
+
+void LayoutKey::Invalidate()
+{
+	++currentGeneration;
+}
+
+
+
+size_t hash<LayoutKey>::operator()(const LayoutKey &key) const noexcept
+{
+	size_t result = hash<string>()(key.text);
+	const auto combine = [&result](size_t value)
+	{
+		result ^= value + 0x9E3779B97F4A7C15ull + (result << 6) + (result >> 2);
+	};
+	combine(hash<const Font *>()(key.font));
+	combine(static_cast<size_t>(key.width));
+	combine(static_cast<size_t>(key.align) | static_cast<size_t>(key.truncate) << 4);
+	combine(static_cast<size_t>(key.tabWidth));
+	combine(static_cast<size_t>(key.lineHeight));
+	combine(static_cast<size_t>(key.paragraphBreak));
+	combine(static_cast<size_t>(key.letterSpacing));
+	combine(static_cast<size_t>(key.fontScale));
+	combine(static_cast<size_t>(key.generation));
+	return result;
+}
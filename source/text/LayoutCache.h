@@ -0,0 +1,145 @@
+/* LayoutCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Alignment.h"
+#include "Truncate.h"
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+class Font;
+
+
+
+// Everything that the layout of a piece of text depends on. Besides the given
+// settings, this includes the letter spacing and font scale preferences, and
+// which fonts have been loaded, so a key stops matching when any of those change.
+class LayoutKey {
+public:
+	LayoutKey(const Font &font, const std::string &text, int width,
+		Alignment align = Alignment::LEFT, Truncate truncate = Truncate::NONE);
+
+	bool operator==(const LayoutKey &other) const = default;
+
+	// Make all the existing keys stale, because a font has been (re)loaded.
+	static void Invalidate();
+
+
+public:
+	const Font *font;
+	std::string text;
+	int width;
+	Alignment align;
+	Truncate truncate;
+	// Spacing that only wrapped text depends on.
+	int tabWidth = 0;
+	int lineHeight = 0;
+	int paragraphBreak = 0;
+
+private:
+	int letterSpacing;
+	int fontScale;
+	int generation;
+
+	friend struct std::hash<LayoutKey>;
+};
+
+
+
+template<>
+struct std::hash<LayoutKey> {
+	size_t operator()(const LayoutKey &key) const noexcept;
+};
+
+
+
+// A bounded cache of text layouts, so that text that is drawn every frame is
+// only wrapped or truncated once. Once it is full, the least recently used
+// layout is dropped to make room for a new one.
+template<class Value>
+class LayoutCache {
+public:
+	explicit LayoutCache(size_t capacity);
+
+	// Get the layout stored for the given key, if there is one.
+	const Value *Find(const LayoutKey &key);
+	// Store the layout for the given key.
+	void Insert(const LayoutKey &key, Value value);
+
+
+private:
+	class Entry {
+	public:
+		Value value;
+		// This entry's place in the order of use.
+		std::list<const LayoutKey *>::iterator use;
+	};
+
+
+private:
+	size_t capacity;
+	std::unordered_map<LayoutKey, Entry> entries;
+	// The keys of the entries, from most to least recently used.
+	std::list<const LayoutKey *> order;
+};
+
+
+
+template<class Value>
+LayoutCache<Value>::LayoutCache(size_t capacity)
+	: capacity(capacity)
+{
+}
+
+
+
+template<class Value>
+const Value *LayoutCache<Value>::Find(const LayoutKey &key)
+{
+	auto it = entries.find(key);
+	if(it == entries.end())
+		return nullptr;
+
+	order.splice(order.begin(), order, it->second.use);
+	return &it->second.value;
+}
+
+
+
+template<class Value>
+void LayoutCache<Value>::Insert(const LayoutKey &key, Value value)
+{
+	auto it = entries.find(key);
+	if(it != entries.end())
+	{
+		it->second.value = std::move(value);
+		order.splice(order.begin(), order, it->second.use);
+		return;
+	}
+
+	if(entries.size() >= capacity && !order.empty())
+	{
+		entries.erase(entries.find(*order.back()));
+		order.pop_back();
+	}
+	it = entries.emplace(key, Entry{std::move(value), {}}).first;
+	order.push_front(&it->first);
+	it->second.use = order.begin();
+}
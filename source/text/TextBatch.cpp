@@ -0,0 +1,204 @@
+/* TextBatch.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "TextBatch.h"
+
+#include "../Color.h"
+#include "../GameData.h"
+#include "../shader/GpuProfiler.h"
+#include "../opengl.h"
+#include "../Screen.h"
+#include "../shader/Shader.h"
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// One corner of a glyph, laid out the same way as the shader's attributes.
+	struct Vertex {
+		GLfloat position[2];
+		GLfloat texCoord[2];
+		GLfloat color[4];
+	};
+
+	// The glyphs that are drawn from one texture.
+	struct Group {
+		GLuint texture;
+		bool distanceField;
+		vector<Vertex> vertices;
+	};
+
+	const Shader *shader = nullptr;
+	GLuint vao = 0;
+	GLuint vbo = 0;
+
+	GLint scaleI = 0;
+	GLint distanceFieldI = 0;
+	GLint vertI = 0;
+	GLint cornerI = 0;
+	GLint colorI = 0;
+
+	int depth = 0;
+	// Groups stay allocated between batches, so their vertices' memory is reused.
+	vector<Group> groups;
+
+	void EnableAttribArrays()
+	{
+		constexpr auto stride = sizeof(Vertex);
+		glEnableVertexAttribArray(vertI);
+		glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, stride,
+			reinterpret_cast<const GLvoid *>(offsetof(Vertex, position)));
+		glEnableVertexAttribArray(cornerI);
+		glVertexAttribPointer(cornerI, 2, GL_FLOAT, GL_FALSE, stride,
+			reinterpret_cast<const GLvoid *>(offsetof(Vertex, texCoord)));
+		glEnableVertexAttribArray(colorI);
+		glVertexAttribPointer(colorI, 4, GL_FLOAT, GL_FALSE, stride,
+			reinterpret_cast<const GLvoid *>(offsetof(Vertex, color)));
+	}
+
+	void Flush()
+	{
+		bool empty = true;
+		for(const Group &group : groups)
+			empty &= group.vertices.empty();
+		if(empty)
+			return;
+
+		glUseProgram(shader->Object());
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		if(OpenGL::HasVaoSupport())
+			glBindVertexArray(vao);
+		else
+			EnableAttribArrays();
+
+		GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+		glUniform2fv(scaleI, 1, scale);
+
+		for(Group &group : groups)
+		{
+			if(group.vertices.empty())
+				continue;
+
+			glBindTexture(GL_TEXTURE_2D, group.texture);
+			GpuProfiler::CountTextureBind();
+			glUniform1i(distanceFieldI, group.distanceField);
+
+			const size_t size = sizeof(Vertex) * group.vertices.size();
+			glBufferData(GL_ARRAY_BUFFER, size, group.vertices.data(), GL_STREAM_DRAW);
+			GpuProfiler::CountUpload(size);
+			glDrawArrays(GL_TRIANGLES, 0, group.vertices.size());
+			GpuProfiler::CountDrawCall();
+
+			group.vertices.clear();
+		}
+
+		if(OpenGL::HasVaoSupport())
+			glBindVertexArray(0);
+		else
+		{
+			glDisableVertexAttribArray(vertI);
+			glDisableVertexAttribArray(cornerI);
+			glDisableVertexAttribArray(colorI);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glUseProgram(0);
+	}
+}
+
+
+
+void TextBatch::Init()
+{
+	// Without the batch shader, text is simply drawn right away.
+	shader = GameData::Shaders().Get("fontBatch");
+	if(!shader->Object())
+	{
+		shader = nullptr;
+		return;
+	}
+
+	scaleI = shader->Uniform("scale");
+	distanceFieldI = shader->Uniform("distanceField");
+	vertI = shader->Attrib("vert");
+	cornerI = shader->Attrib("corner");
+	colorI = shader->Attrib("vertColor");
+
+	glUseProgram(shader->Object());
+	glUniform1i(shader->Uniform("tex"), 0);
+	glUseProgram(0);
+
+	if(OpenGL::HasVaoSupport())
+	{
+		glGenVertexArrays(1, &vao);
+		glBindVertexArray(vao);
+	}
+	glGenBuffers(1, &vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	if(OpenGL::HasVaoSupport())
+		EnableAttribArrays();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if(OpenGL::HasVaoSupport())
+		glBindVertexArray(0);
+}
+
+
+
+TextBatch::TextBatch()
+{
+	++depth;
+}
+
+
+
+TextBatch::~TextBatch()
+{
+	if(!--depth && shader)
+		Flush();
+}
+
+
+
+bool TextBatch::IsActive()
+{
+	return depth && shader;
+}
+
+
+
+void TextBatch::Add(uint32_t texture, bool distanceField, const float corners[4],
+	const float texCoords[4], const Color &color)
+{
+	auto it = groups.begin();
+	while(it != groups.end() && (it->texture != texture || it->distanceField != distanceField))
+		++it;
+	if(it == groups.end())
+		it = groups.insert(it, Group{texture, distanceField, {}});
+
+	// Each glyph is drawn as two triangles.
+	const float *rgba = color.Get();
+	const auto corner = [&](int x, int y) -> Vertex
+	{
+		return {{corners[x], corners[y]}, {texCoords[x], texCoords[y]},
+			{rgba[0], rgba[1], rgba[2], rgba[3]}};
+	};
+	const Vertex topLeft = corner(0, 1);
+	const Vertex topRight = corner(2, 1);
+	const Vertex bottomLeft = corner(0, 3);
+	const Vertex bottomRight = corner(2, 3);
+	it->vertices.insert(it->vertices.end(), {topLeft, bottomLeft, topRight, topRight, bottomLeft, bottomRight});
+}
@@ -0,0 +1,44 @@
+/* TextBatch.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+class Color;
+
+
+
+// While a TextBatch exists, text that any Font draws is collected instead of
+// drawn right away. When the outermost batch ends, the text is drawn with one
+// call for each texture that its glyphs come from. Batched text is drawn above
+// everything else that was drawn during the batch, so a batch should only be
+// used around code that never draws anything on top of its own text.
+class TextBatch {
+public:
+	static void Init();
+
+	TextBatch();
+	TextBatch(const TextBatch &) = delete;
+	TextBatch &operator=(const TextBatch &) = delete;
+	~TextBatch();
+
+	// Check whether text should be added to a batch rather than drawn.
+	static bool IsActive();
+	// Add one glyph, given the screen coordinates of its top left and bottom right
+	// corners, and the texture coordinates of those corners in the given texture.
+	static void Add(uint32_t texture, bool distanceField, const float corners[4],
+		const float texCoords[4], const Color &color);
+};
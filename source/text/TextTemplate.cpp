@@ -0,0 +1,149 @@
+/* TextTemplate.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "TextTemplate.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+TextTemplate::TextTemplate(string text, Syntax syntax)
+	: text(std::move(text))
+{
+	const string_view open = (syntax == Syntax::ANGLE_BRACKETS) ? "<" : "{{";
+	const string_view close = (syntax == Syntax::ANGLE_BRACKETS) ? ">" : "}}";
+	// Bracketed names include their brackets, but braced names do not.
+	const size_t trim = (syntax == Syntax::ANGLE_BRACKETS) ? 0 : open.size();
+
+	const string_view source = this->text;
+	for(size_t left = source.find(open); left != string::npos; left = source.find(open, left + 1))
+	{
+		size_t right = source.find(close, left + open.size());
+		// No later placeholder can be closed either.
+		if(right == string::npos)
+			break;
+		right += close.size();
+
+		const string_view name = source.substr(left + trim, right - left - 2 * trim);
+		int index = Index(name);
+		if(index < 0)
+		{
+			index = static_cast<int>(names.size());
+			names.emplace_back(name);
+		}
+		placeholders.push_back({left, right, index});
+	}
+}
+
+
+
+const string &TextTemplate::Text() const
+{
+	return text;
+}
+
+
+
+const vector<string> &TextTemplate::Names() const
+{
+	return names;
+}
+
+
+
+int TextTemplate::Index(string_view name) const
+{
+	auto it = find(names.begin(), names.end(), name);
+	return (it == names.end()) ? -1 : static_cast<int>(it - names.begin());
+}
+
+
+
+string TextTemplate::Expand(span<const string_view *const> values) const
+{
+	return Fill([&values](int index) -> const string_view *
+		{
+			return (static_cast<size_t>(index) < values.size()) ? values[index] : nullptr;
+		});
+}
+
+
+
+string TextTemplate::Expand(span<const Replacement> replacements) const
+{
+	// There are usually only a few names, so they are matched up front, rather than for every placeholder.
+	vector<const string_view *> values(names.size(), nullptr);
+	for(const Replacement &replacement : replacements)
+	{
+		const int index = Index(replacement.first);
+		if(index >= 0 && !values[index])
+			values[index] = &replacement.second;
+	}
+	return Expand(values);
+}
+
+
+
+string TextTemplate::Expand(initializer_list<Replacement> replacements) const
+{
+	return Expand(span<const Replacement>(replacements.begin(), replacements.size()));
+}
+
+
+
+string TextTemplate::Expand(const map<string, string> &keys) const
+{
+	vector<string_view> found(names.size());
+	vector<const string_view *> values(names.size(), nullptr);
+	for(size_t i = 0; i < names.size(); ++i)
+	{
+		auto it = keys.find(names[i]);
+		if(it != keys.end())
+		{
+			found[i] = it->second;
+			values[i] = &found[i];
+		}
+	}
+	return Expand(values);
+}
+
+
+
+template<class Lookup>
+string TextTemplate::Fill(Lookup &&lookup) const
+{
+	if(placeholders.empty())
+		return text;
+
+	string result;
+	result.reserve(text.size());
+	size_t start = 0;
+	for(const Placeholder &placeholder : placeholders)
+	{
+		// Skip any placeholder that overlaps one that was already replaced.
+		if(placeholder.begin < start)
+			continue;
+		const string_view *value = lookup(placeholder.index);
+		if(!value)
+			continue;
+		result.append(text, start, placeholder.begin - start);
+		result += *value;
+		start = placeholder.end;
+	}
+	result.append(text, start, string::npos);
+	return result;
+}
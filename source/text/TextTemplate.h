@@ -0,0 +1,92 @@
+/* TextTemplate.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+
+// A piece of text with placeholders in it, such as "<planet>" or "{{amount}}",
+// which is scanned for them only once. Filling in the placeholders then just
+// copies the text between them, instead of searching the whole text for every
+// replacement each time.
+//
+// Any placeholder that is not given a value is left in the text as it is. The
+// text is scanned the same way as Format::Replace() does, so a template gives
+// the same results as replacing the keys in the original text.
+class TextTemplate {
+public:
+	enum class Syntax {
+		// Placeholders like "<name>". Their names include the brackets.
+		ANGLE_BRACKETS,
+		// Placeholders like "{{name}}", as used by translations. Their names do not include the braces.
+		DOUBLE_BRACES
+	};
+
+	// A placeholder's name and the text to put in its place.
+	using Replacement = std::pair<std::string_view, std::string_view>;
+
+
+public:
+	TextTemplate() = default;
+	explicit TextTemplate(std::string text, Syntax syntax = Syntax::ANGLE_BRACKETS);
+
+	const std::string &Text() const;
+	// The names of all the placeholders, each listed once, in the order they first appear.
+	const std::vector<std::string> &Names() const;
+	// Get the index of the given placeholder in Names(), or -1 if the text does not have it.
+	int Index(std::string_view name) const;
+
+	// Fill in the placeholders. The value for each one is given by its index in
+	// Names(), and a null value leaves that placeholder unchanged.
+	std::string Expand(std::span<const std::string_view *const> values) const;
+	// Fill in the placeholders with the values given for their names.
+	std::string Expand(std::span<const Replacement> replacements) const;
+	std::string Expand(std::initializer_list<Replacement> replacements) const;
+	std::string Expand(const std::map<std::string, std::string> &keys) const;
+
+
+private:
+	// Fill in the placeholders with the values the given function returns for
+	// their indices, or null to leave them unchanged.
+	template<class Lookup>
+	std::string Fill(Lookup &&lookup) const;
+
+
+private:
+	class Placeholder {
+	public:
+		size_t begin;
+		size_t end;
+		int index;
+	};
+
+
+private:
+	std::string text;
+	std::vector<std::string> names;
+	// Every possible placeholder in the text. Some of them may overlap, e.g. in
+	// "<a <b>" both "<a <b>" and "<b>" are placeholders, and whichever comes
+	// first and has a value is the one that is replaced.
+	std::vector<Placeholder> placeholders;
+};
@@ -15,24 +15,270 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Translation.h"
 
+#include "../DiskCache.h"
 #include "Files.h"
+#include "../MappedFile.h"
+#include "../MemoryProfile.h"
+#include "../StartupProfile.h"
+#include "../TaskGroup.h"
+#include "../TaskQueue.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <deque>
 #include <filesystem>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 using namespace std;
 
 namespace {
 
+	// This must be changed whenever the layout of the compiled catalogs changes.
+	const char MAGIC[8] = {'E', 'S', 'T', 'R', 'A', 'N', 'S', '1'};
+
+	// Read a value from a compiled catalog, checking that it does not run past the end.
+	template<class Type>
+	bool Read(const char *&it, const char *end, Type &value)
+	{
+		if(static_cast<size_t>(end - it) < sizeof(Type))
+			return false;
+		memcpy(&value, it, sizeof(Type));
+		it += sizeof(Type);
+		return true;
+	}
+
+	template<class Type>
+	void Write(string &out, Type value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(Type));
+	}
+
+	// The translated strings of one language. Each key and value is stored only
+	// once, and the keys are found through a flat open-addressing hash table, so
+	// that looking up a string never allocates any memory.
+	//
+	// A catalog can also be compiled into a binary form, which holds the hash
+	// table as it is and a string table of the keys (in sorted order) and values.
+	// Loading that only copies the strings out, with no parsing or hashing.
+	class Catalog {
+	public:
+		void Build(map<string, string> &&strings)
+		{
+			entries.clear();
+			entries.reserve(strings.size());
+			for(auto &it : strings)
+				entries.emplace_back(it.first, std::move(it.second));
+
+			// Keep the table at most half full, so that probe sequences stay short.
+			size_t capacity = 16;
+			while(capacity < 2 * entries.size())
+				capacity *= 2;
+			slots.assign(capacity, Slot{});
+			const size_t mask = capacity - 1;
+			for(size_t i = 0; i < entries.size(); ++i)
+			{
+				const uint64_t hash = DiskCache::Hash(entries[i].first);
+				size_t index = hash & mask;
+				while(slots[index].entry)
+					index = (index + 1) & mask;
+				slots[index] = {static_cast<uint32_t>(hash), static_cast<uint32_t>(i + 1)};
+			}
+		}
+
+		void Clear()
+		{
+			entries.clear();
+			slots.clear();
+		}
+
+		bool Empty() const
+		{
+			return entries.empty();
+		}
+
+		// Load a compiled catalog, if it was compiled from files with the given signature.
+		// A compiled catalog that is out of date, truncated or corrupt is ignored.
+		bool Read(const char *it, const char *end, uint64_t signature)
+		{
+			Clear();
+			if(!it || static_cast<size_t>(end - it) < sizeof(MAGIC) || memcmp(it, MAGIC, sizeof(MAGIC)))
+				return false;
+			it += sizeof(MAGIC);
+
+			uint64_t storedSignature;
+			uint32_t entryCount;
+			uint32_t slotCount;
+			if(!::Read(it, end, storedSignature) || storedSignature != signature
+					|| !::Read(it, end, entryCount) || !::Read(it, end, slotCount))
+				return false;
+			// The table must have room for every entry, and a size that is a power of two.
+			if(slotCount < entryCount || !slotCount || (slotCount & (slotCount - 1))
+					|| slotCount > static_cast<size_t>(end - it) / sizeof(Slot))
+				return false;
+			slots.resize(slotCount);
+			memcpy(slots.data(), it, slotCount * sizeof(Slot));
+			it += slotCount * sizeof(Slot);
+			for(const Slot &slot : slots)
+				if(slot.entry > entryCount)
+					return Fail();
+
+			// The lengths of each key and value are followed by all of their text.
+			if(entryCount > static_cast<size_t>(end - it) / (2 * sizeof(uint32_t)))
+				return Fail();
+			const char *lengths = it;
+			const char *text = it + entryCount * 2 * sizeof(uint32_t);
+			entries.resize(entryCount);
+			for(pair<string, string> &entry : entries)
+			{
+				uint32_t keyLength;
+				uint32_t valueLength;
+				::Read(lengths, text, keyLength);
+				::Read(lengths, text, valueLength);
+				if(static_cast<size_t>(end - text) < static_cast<size_t>(keyLength) + valueLength)
+					return Fail();
+				entry.first.assign(text, keyLength);
+				text += keyLength;
+				entry.second.assign(text, valueLength);
+				text += valueLength;
+			}
+			return true;
+		}
+
+		// Compile this catalog, so that it can be read back by Read().
+		void Write(string &out, uint64_t signature) const
+		{
+			out.assign(MAGIC, sizeof(MAGIC));
+			::Write(out, signature);
+			::Write(out, static_cast<uint32_t>(entries.size()));
+			::Write(out, static_cast<uint32_t>(slots.size()));
+			out.append(reinterpret_cast<const char *>(slots.data()), slots.size() * sizeof(Slot));
+			for(const pair<string, string> &entry : entries)
+			{
+				::Write(out, static_cast<uint32_t>(entry.first.size()));
+				::Write(out, static_cast<uint32_t>(entry.second.size()));
+			}
+			for(const pair<string, string> &entry : entries)
+			{
+				out += entry.first;
+				out += entry.second;
+			}
+		}
+
+		// Get the value stored for the given key, or null if there is none.
+		const string *Find(string_view key) const
+		{
+			if(entries.empty())
+				return nullptr;
+
+			const uint64_t hash = DiskCache::Hash(key);
+			const size_t mask = slots.size() - 1;
+			for(size_t index = hash & mask; slots[index].entry; index = (index + 1) & mask)
+			{
+				const Slot &slot = slots[index];
+				const pair<string, string> &entry = entries[slot.entry - 1];
+				if(slot.hash == static_cast<uint32_t>(hash) && entry.first == key)
+					return &entry.second;
+			}
+			return nullptr;
+		}
+
+
+	private:
+		class Slot {
+		public:
+			// The low bits of the key's hash, so most mismatches skip the string comparison.
+			uint32_t hash = 0;
+			// The index of the entry plus one, or zero if this slot is empty.
+			uint32_t entry = 0;
+		};
+
+		// Discard a partially read catalog.
+		bool Fail()
+		{
+			Clear();
+			return false;
+		}
+
+		vector<pair<string, string>> entries;
+		vector<Slot> slots;
+	};
+
+	Catalog currentStrings;
+	// The English strings, used for any key the current language is missing.
+	Catalog fallbackStrings;
+	// The language of the current strings.
 	string currentLanguage;
-	map<string, string> currentStrings;
-	map<string, string> fallbackStrings;
-	bool fallbackLoaded = false;
+	// Changed whenever either catalog is replaced.
+	atomic<int> generation = 0;
+	// Every change of language is numbered, so that a catalog that finishes
+	// loading after the language was changed again can be discarded.
+	int latestRequest = 0;
+
+	// Get the translation of the given key, or null if no language has one.
+	const string *Find(string_view key)
+	{
+		const string *value = currentStrings.Find(key);
+		return value ? value : fallbackStrings.Find(key);
+	}
+
+	// Get the translation of a substitution's value, or null if its key is not
+	// one whose values are translated, or no language has a translation for it.
+	const string *FindSubstitutionValue(const string &key, const string &value)
+	{
+		if(key == "<commodity>")
+			return Find("commodity." + value);
+		if(key == "<government>")
+			return Find("government." + value);
+		if(key == "<home planet>" || key == "<planet>")
+			return Find("planet.name." + value);
+		if(key == "<home system>" || key == "<system>")
+			return Find("system.name." + value);
+		return nullptr;
+	}
+
+	// Like Find(), but treating an empty translation as a missing one.
+	const string *FindNonEmpty(string_view key)
+	{
+		const string *value = Find(key);
+		return (value && !value->empty()) ? value : nullptr;
+	}
+
+	// The key and current translation of every registered handle. A deque never
+	// moves its elements, so the handles can point straight at the translations.
+	// Handles may be made by the threads that load the game data.
+	mutex handlesMutex;
+	deque<pair<string, const string *>> handleEntries;
+	unordered_map<string_view, pair<string, const string *> *> handleIndex;
+
+	// The parsed translations that have been used as templates.
+	mutex templatesMutex;
+	unordered_map<string, TextTemplate> templates;
+
+	// The old translations are gone, so every handle needs to find its new one.
+	void Refresh()
+	{
+		{
+			lock_guard<mutex> lock(handlesMutex);
+			for(auto &entry : handleEntries)
+				entry.second = FindNonEmpty(entry.first);
+		}
+		{
+			lock_guard<mutex> lock(templatesMutex);
+			templates.clear();
+		}
+		++generation;
+	}
 
 	filesystem::path MainUiLanguageDir()
 	{
@@ -164,223 +410,319 @@ namespace {
 		}
 	}
 
-	void LoadInto(const string &languageCode, map<string, string> &target)
+	// The file in which the compiled catalog of the given language is stored.
+	filesystem::path CompiledPath(const string &languageCode)
+	{
+		return DiskCache::Path("translation-" + languageCode + ".bin");
+	}
+
+	// Identify the exact set of source files a catalog is made from, by their
+	// paths, sizes and modification times.
+	uint64_t Signature(const vector<filesystem::path> &sources)
+	{
+		uint64_t hash = DiskCache::Hash("");
+		for(const filesystem::path &source : sources)
+		{
+			error_code error;
+			const uint64_t size = filesystem::file_size(source, error);
+			const int64_t timestamp = Files::Timestamp(source).time_since_epoch().count();
+			hash = DiskCache::Hash(source.string(), hash);
+			hash = DiskCache::HashValue(size, hash);
+			hash = DiskCache::HashValue(timestamp, hash);
+		}
+		return hash;
+	}
+
+	// Write a compiled catalog.
+	void StoreCompiled(const filesystem::path &path, uint64_t signature, const Catalog &catalog)
+	{
+		string out;
+		catalog.Write(out, signature);
+		DiskCache::Store(path, out);
+	}
+
+	void LoadInto(const string &languageCode, Catalog &catalog)
 	{
-		target.clear();
-		filesystem::path langRoot = MainUiLanguageDir();
-		filesystem::path langDirPath = langRoot / languageCode;
+		MemoryProfile::Scope memoryScope(MemoryProfile::Tag::TRANSLATIONS);
+		catalog.Clear();
+		filesystem::path langDirPath = MainUiLanguageDir() / languageCode;
+		if(!Files::Exists(langDirPath) || !filesystem::is_directory(langDirPath))
+			return;
 
-		if(Files::Exists(langDirPath) && filesystem::is_directory(langDirPath))
+		vector<filesystem::path> sources;
+		for(const auto &entry : Files::RecursiveList(langDirPath))
+			if(entry.extension() == ".json")
+				sources.push_back(entry);
+		if(sources.empty())
+			return;
+
+		// Use the compiled catalog if it was made from exactly these files.
+		const uint64_t signature = Signature(sources);
+		const filesystem::path compiledPath = CompiledPath(languageCode);
 		{
-			vector<filesystem::path> entries = Files::RecursiveList(langDirPath);
-			for(const auto &entry : entries)
+			StartupProfile::Scope scope("Translation::Load", compiledPath);
+			MappedFile compiled(compiledPath);
+			if(catalog.Read(compiled.Data(), compiled.Data() + compiled.Size(), signature))
 			{
-				if(entry.extension() == ".json")
-				{
-					string data = Files::Read(entry);
-					map<string, string> partial;
-					ParseFlatJson(data, partial);
-					for(const auto &p : partial)
-						target[p.first] = p.second;
-				}
+				DiskCache::Hit("translations", compiledPath);
+				return;
 			}
 		}
+		DiskCache::Miss("translations");
+
+		// Otherwise, parse all the files in parallel. If several of them define
+		// the same key, the one listed last takes precedence.
+		vector<map<string, string>> parsed(sources.size());
+		{
+			TaskGroup group;
+			for(size_t i = 0; i < sources.size(); ++i)
+				group.Run([&sources, &parsed, i]() -> void
+					{
+						MemoryProfile::Scope memoryScope(MemoryProfile::Tag::TRANSLATIONS);
+						StartupProfile::Scope scope("Translation::Load", sources[i]);
+						ParseFlatJson(Files::Read(sources[i]), parsed[i]);
+					});
+			group.Wait();
+		}
+		map<string, string> target = std::move(parsed.front());
+		for(size_t i = 1; i < parsed.size(); ++i)
+			for(auto &p : parsed[i])
+				target.insert_or_assign(p.first, std::move(p.second));
+		catalog.Build(std::move(target));
+		StoreCompiled(compiledPath, signature, catalog);
 	}
 
 }
 
 namespace Translation {
 
+	Handle::Handle(const string &prefix, const string &name)
+	{
+		// Nothing is translated without a name, e.g. for a category that does not exist.
+		if(name.empty())
+			return;
+
+		string key = prefix + name;
+		lock_guard<mutex> lock(handlesMutex);
+		auto it = handleIndex.find(key);
+		if(it == handleIndex.end())
+		{
+			const string *value = FindNonEmpty(key);
+			auto &entry = handleEntries.emplace_back(std::move(key), value);
+			it = handleIndex.emplace(entry.first, &entry).first;
+		}
+		translation = &it->second->second;
+	}
+
+	const string &Handle::Get(const string &fallback) const
+	{
+		const string *value = Get();
+		return value ? *value : fallback;
+	}
+
 	void Load(const string &languageCode)
 	{
+		// Any language that is still loading would replace this one.
+		++latestRequest;
 		LoadInto(languageCode, currentStrings);
+		// Load the English fallback now rather than on the first missing key, so
+		// that no lookup ever has to wait for it.
+		if(languageCode == "en")
+			fallbackStrings.Clear();
+		else
+			LoadInto("en", fallbackStrings);
+		currentLanguage = languageCode;
+		Refresh();
+	}
+
+	void SetLanguage(TaskQueue &queue, const string &code)
+	{
+		const int request = ++latestRequest;
+		if(code == currentLanguage)
+			return;
+
+		// The English strings are kept as the fallback for every other language,
+		// so switching back to English does not need to load anything.
+		if(code == "en" && !fallbackStrings.Empty())
+		{
+			currentStrings = std::move(fallbackStrings);
+			fallbackStrings.Clear();
+			currentLanguage = code;
+			Refresh();
+			return;
+		}
+
+		// Otherwise, only the new language needs to be loaded, because the
+		// English strings are either the fallback already or the current ones.
+		auto loaded = make_shared<Catalog>();
+		queue.Run([loaded, code]() -> void
+			{
+				LoadInto(code, *loaded);
+			},
+			[loaded, code, request]() -> void
+			{
+				if(request != latestRequest)
+					return;
+				if(code == "en")
+					fallbackStrings.Clear();
+				else if(currentLanguage == "en")
+					fallbackStrings = std::move(currentStrings);
+				currentStrings = std::move(*loaded);
+				currentLanguage = code;
+				Refresh();
+			});
 	}
 
-	void SetLanguage(const string &code)
+	int Generation()
 	{
-		currentLanguage = code;
-		Load(code);
+		return generation;
 	}
 
 	string Tr(const string &key)
 	{
-		auto it = currentStrings.find(key);
-		if(it != currentStrings.end())
-			return it->second;
-		if(!fallbackLoaded && currentLanguage != "en")
-		{
-			LoadInto("en", fallbackStrings);
-			fallbackLoaded = true;
-		}
-		auto fit = fallbackStrings.find(key);
-		if(fit != fallbackStrings.end())
-			return fit->second;
-		return key;
+		const string *value = Find(key);
+		return value ? *value : key;
+	}
+
+	string Tr(const char *key)
+	{
+		const string *value = Find(key);
+		return value ? *value : string(key);
+	}
+
+	string_view Tr(string_view key)
+	{
+		const string *value = Find(key);
+		return value ? string_view(*value) : key;
 	}
 
 	string TrCategory(const string &category)
 	{
-		string key = "category." + category;
-		string value = Tr(key);
-		return (value == key) ? category : value;
+		const string *value = Find("category." + category);
+		return value ? *value : category;
 	}
 
 	string TrFormation(const string &formationName)
 	{
-		string key = "formation." + formationName;
-		string value = Tr(key);
-		return (value == key) ? formationName : value;
+		const string *value = Find("formation." + formationName);
+		return value ? *value : formationName;
 	}
 
 	string TrGovernment(const string &displayName)
 	{
-		string key = "government." + displayName;
-		string value = Tr(key);
-		return (value == key) ? displayName : value;
+		const string *value = Find("government." + displayName);
+		return value ? *value : displayName;
 	}
 
 	string TrStartName(const string &identifier, const string &fallback)
 	{
-		string key = "start.name." + identifier;
-		string value = Tr(key);
-		return (value == key) ? fallback : value;
+		const string *value = Find("start.name." + identifier);
+		return value ? *value : fallback;
 	}
 
 	string TrStartDescription(const string &identifier, const string &fallback)
 	{
-		string key = "start.desc." + identifier;
-		string value = Tr(key);
-		return (value == key) ? fallback : value;
+		const string *value = Find("start.desc." + identifier);
+		return value ? *value : fallback;
 	}
 
 	string TrPhrase(const string &phraseName, const string &fallback)
 	{
-		string key = "phrase." + phraseName;
-		string value = Tr(key);
-		return (value == key) ? fallback : value;
+		const string *value = Find("phrase." + phraseName);
+		return value ? *value : fallback;
 	}
 
 	string TrMissionDescription(const string &identifier, const string &fallback)
 	{
-		string key = "mission.desc." + identifier;
-		string value = Tr(key);
-		return (value == key) ? fallback : value;
+		const string *value = Find("mission.desc." + identifier);
+		return value ? *value : fallback;
 	}
 
 	string TrSubstitutionValue(const string &key, const string &value)
 	{
-		if(key == "<commodity>")
-		{
-			string t = Tr("commodity." + value);
-			return (t == "commodity." + value) ? value : t;
-		}
-		if(key == "<government>")
-			return TrGovernment(value);
-		if(key == "<home planet>" || key == "<planet>")
-		{
-			string t = Tr("planet.name." + value);
-			return (t == "planet.name." + value) ? value : t;
-		}
-		if(key == "<home system>" || key == "<system>")
-		{
-			string t = Tr("system.name." + value);
-			return (t == "system.name." + value) ? value : t;
-		}
-		return value;
+		const string *t = FindSubstitutionValue(key, value);
+		return t ? *t : value;
 	}
 
 	void TranslateSubstitutionValues(map<string, string> &subs)
 	{
+		// Only the values that have a translation need to be copied.
 		for(auto &p : subs)
-			p.second = TrSubstitutionValue(p.first, p.second);
+			if(const string *t = FindSubstitutionValue(p.first, p.second))
+				p.second = *t;
 	}
 
 	string TrSeries(const string &seriesName)
 	{
-		string key = "series." + seriesName;
-		string value = Tr(key);
-		return (value == key) ? seriesName : value;
+		const string *value = Find("series." + seriesName);
+		return value ? *value : seriesName;
 	}
 
 	string TrOutfitName(const string &trueName, const string &fallback)
 	{
-		string key = "outfit.name." + trueName;
-		string value = Tr(key);
-		return (value == key) ? fallback : value;
+		const string *value = Find("outfit.name." + trueName);
+		return value ? *value : fallback;
 	}
 
 	string TrOutfitDescription(const string &trueName, const string &fallback)
 	{
-		string key = "outfit.desc." + trueName;
-		string value = Tr(key);
-		return (value == key) ? fallback : value;
+		const string *value = Find("outfit.desc." + trueName);
+		return value ? *value : fallback;
 	}
 
 	string TrOutfitPluralName(const string &trueName, const string &fallback)
 	{
-		string key = "outfit.plural." + trueName;
-		string value = Tr(key);
-		return (value == key) ? fallback : value;
+		const string *value = Find("outfit.plural." + trueName);
+		return value ? *value : fallback;
 	}
 
 	string TrShipName(const string &trueModelName, const string &fallback)
 	{
-		string key = "ship.name." + trueModelName;
-		string value = Tr(key);
-		return (value == key) ? fallback : value;
+		const string *value = Find("ship.name." + trueModelName);
+		return value ? *value : fallback;
 	}
 
 	string TrShipPluralName(const string &trueModelName, const string &fallback)
 	{
-		string key = "ship.plural." + trueModelName;
-		string value = Tr(key);
-		return (value == key) ? fallback : value;
+		const string *value = Find("ship.plural." + trueModelName);
+		return value ? *value : fallback;
 	}
 
 	string TrShipDescription(const string &trueModelName, const string &fallback)
 	{
-		string key = "ship.desc." + trueModelName;
-		string value = Tr(key);
-		if(value == key || value.empty())
-			return fallback;
-		return value;
+		const string *value = Find("ship.desc." + trueModelName);
+		return (value && !value->empty()) ? *value : fallback;
 	}
 
 	string TrPlanetDescription(const string &planetTrueName, const string &fallback)
 	{
-		string key = "planet.desc." + planetTrueName;
-		string value = Tr(key);
-		if(value == key || value.empty())
-			return fallback;
-		return value;
+		const string *value = Find("planet.desc." + planetTrueName);
+		return (value && !value->empty()) ? *value : fallback;
 	}
 
 	string TrSpaceportDescription(const string &planetTrueName, const string &fallback)
 	{
-		string key = "planet.spaceport." + planetTrueName;
-		string value = Tr(key);
-		if(value == key || value.empty())
-			return fallback;
-		return value;
+		const string *value = Find("planet.spaceport." + planetTrueName);
+		return (value && !value->empty()) ? *value : fallback;
 	}
 
 	string Tr(const string &key, const map<string, string> &replacements)
 	{
-		string s = Tr(key);
-		for(const auto &p : replacements)
-		{
-			string placeholder = "{{" + p.first + "}}";
-			size_t pos = 0;
-			for(;;)
-			{
-				pos = s.find(placeholder, pos);
-				if(pos == string::npos)
-					break;
-				s.replace(pos, placeholder.length(), p.second);
-				pos += p.second.length();
-			}
-		}
-		return s;
+		return Template(key).Expand(replacements);
+	}
+
+	string Tr(const string &key, initializer_list<TextTemplate::Replacement> replacements)
+	{
+		return Template(key).Expand(replacements);
+	}
+
+	const TextTemplate &Template(const string &key)
+	{
+		lock_guard<mutex> lock(templatesMutex);
+		auto it = templates.find(key);
+		if(it == templates.end())
+			it = templates.emplace(key, TextTemplate(Tr(key), TextTemplate::Syntax::DOUBLE_BRACES)).first;
+		return it->second;
 	}
 
 	vector<string> AvailableLanguageCodes()
@@ -15,16 +15,59 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "TextTemplate.h"
+
+#include <initializer_list>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
+class TaskQueue;
+
 namespace Translation {
 
+	/// A translation whose key is looked up once, when the handle is made, and again whenever the language
+	/// changes, so that getting it takes no string building or hashing. This is meant for the names and
+	/// descriptions of game objects, which are drawn every frame. An empty translation counts as missing.
+	class Handle {
+	public:
+		Handle() = default;
+		/// Register the key made of the given prefix and name, e.g. "outfit.name." and an outfit's true name.
+		/// Handles with the same key share a single entry.
+		Handle(const std::string &prefix, const std::string &name);
+
+		/// Get the translation, or null if no language has one.
+		const std::string *Get() const { return translation ? *translation : nullptr; }
+		/// Get the translation, or the given fallback if no language has one.
+		const std::string &Get(const std::string &fallback) const;
+
+	private:
+		// The registered entry's translation, which is updated when the language changes.
+		const std::string *const *translation = nullptr;
+	};
+
+
+	/// Load the given language's translations, replacing the current ones right away.
 	void Load(const std::string &languageCode);
-	void SetLanguage(const std::string &code);
+	/// Switch to the given language. Its translations are read on one of the queue's threads, and swapped
+	/// in by one of its main thread tasks, so the current translations stay in use until they are ready.
+	void SetLanguage(TaskQueue &queue, const std::string &code);
+	/// A number that changes whenever the translations do, so that anything built from them can tell
+	/// when it needs to be rebuilt. Handles are always kept up to date.
+	int Generation();
+
 	std::string Tr(const std::string &key);
+	std::string Tr(const char *key);
+	/// Look up a translation without making a copy of it. The result refers into the catalog
+	/// (or to the key itself, if it has no translation), and is valid until the language changes.
+	std::string_view Tr(std::string_view key);
+	/// Translate the given key and fill in its "{{name}}" placeholders.
 	std::string Tr(const std::string &key, const std::map<std::string, std::string> &replacements);
+	std::string Tr(const std::string &key, std::initializer_list<TextTemplate::Replacement> replacements);
+	/// Get the translation of the given key as a template with "{{name}}" placeholders. Each translation is
+	/// only parsed the first time it is used. The result is valid until the language changes.
+	const TextTemplate &Template(const std::string &key);
 
 	/// Return translated category name (e.g. outfit/ship category). Key is "category." + category.
 	/// If no translation exists, returns the original category string.
@@ -21,10 +21,80 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <windows.h>
 #endif
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
 using namespace std;
 
 namespace {
 	constexpr char32_t BOM = 0x0000FEFF;
+
+	// Decode the two-byte code points in the given bytes, 8 at a time, for as long as
+	// every pair is a lead byte (110xxxxx) followed by a continuation byte (10xxxxxx).
+	// Returns the number of code points decoded.
+	size_t DecodeTwoByteRun(const char *it, size_t bytes, char32_t *out, size_t count)
+	{
+		size_t decoded = 0;
+#if defined(__SSE2__)
+		// As little-endian 16-bit words, each pair has its lead byte in the low half.
+		const __m128i leadMask = _mm_set1_epi16(0x001F);
+		const __m128i patternMask = _mm_set1_epi16(static_cast<short>(0xC0E0));
+		const __m128i pattern = _mm_set1_epi16(static_cast<short>(0x80C0));
+		const __m128i zero = _mm_setzero_si128();
+		while(bytes >= 16 && count - decoded >= 8)
+		{
+			const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it));
+			const __m128i valid = _mm_cmpeq_epi16(_mm_and_si128(words, patternMask), pattern);
+			if(_mm_movemask_epi8(valid) != 0xFFFF)
+				break;
+
+			const __m128i low = _mm_and_si128(_mm_srli_epi16(words, 8), _mm_set1_epi16(0x003F));
+			const __m128i high = _mm_slli_epi16(_mm_and_si128(words, leadMask), 6);
+			const __m128i codePoints = _mm_or_si128(high, low);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + decoded), _mm_unpacklo_epi16(codePoints, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + decoded + 4), _mm_unpackhi_epi16(codePoints, zero));
+			it += 16;
+			bytes -= 16;
+			decoded += 8;
+		}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		while(bytes >= 16 && count - decoded >= 8)
+		{
+			// Split the pairs into their lead and continuation bytes.
+			const uint8x8x2_t pairs = vld2_u8(reinterpret_cast<const uint8_t *>(it));
+			const uint8x8_t leadValid = vceq_u8(vand_u8(pairs.val[0], vdup_n_u8(0xE0)), vdup_n_u8(0xC0));
+			const uint8x8_t nextValid = vceq_u8(vand_u8(pairs.val[1], vdup_n_u8(0xC0)), vdup_n_u8(0x80));
+			if(vminv_u8(vand_u8(leadValid, nextValid)) != 0xFF)
+				break;
+
+			const uint16x8_t high = vshlq_n_u16(vmovl_u8(vand_u8(pairs.val[0], vdup_n_u8(0x1F))), 6);
+			const uint16x8_t codePoints = vorrq_u16(high, vmovl_u8(vand_u8(pairs.val[1], vdup_n_u8(0x3F))));
+			vst1q_u32(reinterpret_cast<uint32_t *>(out + decoded), vmovl_u16(vget_low_u16(codePoints)));
+			vst1q_u32(reinterpret_cast<uint32_t *>(out + decoded + 4), vmovl_high_u16(codePoints));
+			it += 16;
+			bytes -= 16;
+			decoded += 8;
+		}
+#endif
+		// Finish the run one code point at a time.
+		while(bytes >= 2 && decoded < count
+				&& (it[0] & 0xE0) == 0xC0 && (it[1] & 0xC0) == 0x80)
+		{
+			out[decoded++] = ((it[0] & 0x1F) << 6) | (it[1] & 0x3F);
+			it += 2;
+			bytes -= 2;
+		}
+		return decoded;
+	}
 }
 
 
@@ -167,4 +237,65 @@ namespace Utf8 {
 			c = (c << 6) + (str[pos++] & 0x3f);
 		return c;
 	}
+
+
+
+	// Count how many bytes starting at pos are plain ASCII.
+	size_t AsciiLength(const string &str, size_t pos)
+	{
+		const size_t start = pos;
+		const char *data = str.data();
+		const size_t size = str.size();
+#ifdef __AVX2__
+		for( ; pos + 32 <= size; pos += 32)
+		{
+			// The sign bit of each byte is set if it is not ASCII.
+			const unsigned mask = _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos)));
+			if(mask)
+				return pos + countr_zero(mask) - start;
+		}
+#endif
+#if defined(__SSE2__)
+		for( ; pos + 16 <= size; pos += 16)
+		{
+			const unsigned mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos)));
+			if(mask)
+				return pos + countr_zero(mask) - start;
+		}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		for( ; pos + 16 <= size; pos += 16)
+			if(vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(data + pos))) & 0x80)
+				break;
+#endif
+		while(pos < size && !(data[pos] & 0x80))
+			++pos;
+		return pos - start;
+	}
+
+
+
+	// Decode up to count code points into out.
+	size_t DecodeCodePoints(const string &str, size_t &pos, char32_t *out, size_t count)
+	{
+		size_t decoded = 0;
+		while(decoded < count && pos < str.size())
+		{
+			// ASCII bytes are their own code points.
+			const size_t ascii = min(AsciiLength(str, pos), count - decoded);
+			for(size_t i = 0; i < ascii; ++i)
+				out[decoded + i] = static_cast<unsigned char>(str[pos + i]);
+			decoded += ascii;
+			pos += ascii;
+			if(decoded == count || pos >= str.size())
+				break;
+
+			const size_t twoByte = DecodeTwoByteRun(str.data() + pos, str.size() - pos, out + decoded, count - decoded);
+			decoded += twoByte;
+			pos += 2 * twoByte;
+			// Anything else, including invalid bytes, is decoded the usual way.
+			if(!twoByte && decoded < count)
+				out[decoded++] = DecodeCodePoint(str, pos);
+		}
+		return decoded;
+	}
 }
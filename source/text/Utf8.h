@@ -39,4 +39,13 @@ namespace Utf8 {
 	// pos skips to the next unicode code point after pos in utf8,
 	// or is set string::npos when there are no more code points.
 	char32_t DecodeCodePoint(const std::string &str, std::size_t &pos);
+
+	// Count how many bytes starting at pos are plain ASCII.
+	std::size_t AsciiLength(const std::string &str, std::size_t pos);
+
+	// Decode up to count code points into out, with the same results as calling
+	// DecodeCodePoint for each one. Runs of ASCII and of two-byte code points
+	// (such as Cyrillic) are decoded many bytes at a time. pos is advanced past
+	// the decoded code points. Returns the number of code points decoded.
+	std::size_t DecodeCodePoints(const std::string &str, std::size_t &pos, char32_t *out, std::size_t count);
 }
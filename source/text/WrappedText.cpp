@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DisplayText.h"
 #include "Font.h"
+#include "LayoutCache.h"
 
 #include <cstring>
 
@@ -221,6 +222,29 @@ void WrappedText::Wrap()
 	if(text.empty() || !font)
 		return;
 
+	// The same text is usually wrapped the same way every frame, so the results
+	// of recent wraps are kept, along with the text buffer they index into.
+	struct Layout {
+		string text;
+		vector<Word> words;
+		int height;
+		int longestLineWidth;
+	};
+	static LayoutCache<Layout> cache(256);
+
+	LayoutKey key(*font, text, wrapWidth, alignment, truncate);
+	key.tabWidth = tabWidth;
+	key.lineHeight = lineHeight;
+	key.paragraphBreak = paragraphBreak;
+	if(const Layout *layout = cache.Find(key))
+	{
+		text = layout->text;
+		words = layout->words;
+		height = layout->height;
+		longestLineWidth = layout->longestLineWidth;
+		return;
+	}
+
 	// Do this as a finite state machine.
 	Word word;
 	bool traversingWord = false;
@@ -323,6 +347,8 @@ void WrappedText::Wrap()
 	// We have over-calculated the actual height by an extra paragraph break,
 	// so subtract that.
 	height = max(0, word.y - paragraphBreak);
+
+	cache.Insert(key, Layout{text, words, height, longestLineWidth});
 }
 
 
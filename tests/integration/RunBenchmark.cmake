@@ -0,0 +1,28 @@
+set(TEST_CONFIG "${TEST_CONFIGS}/${test}")
+
+# Clean the config folder of the integration test.
+file(REMOVE_RECURSE "${TEST_CONFIG}")
+file(COPY "${ES_CONFIG}" DESTINATION "${TEST_CONFIGS}")
+file(RENAME "${TEST_CONFIGS}/config" "${TEST_CONFIG}")
+
+# Run the integration test
+execute_process(COMMAND $ENV{ES_INTEGRATION_PREFIX} "${ES}" --config "${TEST_CONFIG}" --resources "${RESOURCE_PATH}" --test "${test}" ${DEBUG}
+    OUTPUT_VARIABLE TEST_OUTPUT
+    ERROR_VARIABLE TEST_OUTPUT
+    RESULT_VARIABLE TEST_RESULT)
+
+set(TEST_CONFIG "${TEST_CONFIGS}/benchmark")
+
+# Start from a clean copy of the integration test config folder.
+file(REMOVE_RECURSE "${TEST_CONFIG}")
+file(COPY "${ES_CONFIG}" DESTINATION "${TEST_CONFIGS}")
+file(RENAME "${TEST_CONFIGS}/config" "${TEST_CONFIG}")
+
+# Run the benchmark, showing its results as they are printed.
+execute_process(COMMAND "${ES}" --config "${TEST_CONFIG}" --resources "${RESOURCE_PATH}" --test "${test}"
+		--benchmark "${FRAMES}"
+	RESULT_VARIABLE BENCHMARK_RESULT)
+
+if(BENCHMARK_RESULT)
+	message(FATAL_ERROR "Benchmark failed with '${BENCHMARK_RESULT}'.")
+endif()
@@ -49,7 +49,7 @@ function run_single_testrun () {
   local TEST="$1"
 
   # Setup environment for the test
-  local ES_CONFIG_PATH=$(mktemp --directory)
+  local ES_CONFIG_PATH=$(mktemp -d)
   if [ ! $? ]
   then
     echo "not ok ${RUNNING_TEST} Couldn't create temporary directory"
@@ -117,11 +117,33 @@ function run_test () {
 
 
 
+# Prints the TAP result of a test that has finished, and counts it.
+# Parameters:
+# $1 Test(name)
+# $2 Return value of run_test
+function report_result () {
+  if [ $2 -eq 0 ]; then
+    NUM_OK=$((NUM_OK + 1))
+    TEST_RESULT="ok"
+  elif [ $2 -eq 2 ]; then
+    echo "# Bail out! Encountered serious issue that prevents further testing."
+    exit 1
+  else
+    NUM_FAILED=$((NUM_FAILED + 1))
+    TEST_RESULT="not ok"
+  fi
+  echo "${TEST_RESULT} ${RUNNING_TEST} $1"
+  RUNNING_TEST=$(( ${RUNNING_TEST} + 1 ))
+}
+
+
+
 # Retrieve parameters that give the executable and datafile-paths.
 if [ -z "$1" ] || [ -z "$2" ]; then
   echo "You must supply a path to the binary as an argument,"
   echo "and you must supply a path to the ES resources (data-files), e.g."
   echo "~$ ./tests/integration/run_tests.sh ./endless-sky ./"
+  echo "Set ES_TEST_JOBS to run that many tests at the same time."
   exit 1
 fi
 
@@ -168,25 +190,47 @@ fi
 
 echo "1..${NUM_TOTAL}"
 
-# Run all the tests
+# Run all the tests. Each test gets its own game process, so that no state can
+# leak from one test into the next, but up to ES_TEST_JOBS of them may run at
+# the same time. Their output is then collected and reported in order.
 RUNNING_TEST=1
 NUM_FAILED=0
 NUM_OK=0
-for TEST in ${TESTS_OK[@]}
-do
-  if run_test "${TEST}"; then
-    NUM_OK=$((NUM_OK + 1))
-    TEST_RESULT="ok"
-  elif [ $? -eq 2 ]; then
-    echo "# Bail out! Encountered serious issue that prevents further testing."
-    exit 1
-  else
-    NUM_FAILED=$((NUM_FAILED + 1))
-    TEST_RESULT="not ok"
-  fi
-  echo "${TEST_RESULT} ${RUNNING_TEST} ${TEST}"
-  RUNNING_TEST=$(( ${RUNNING_TEST} + 1 ))
-done
+JOBS=${ES_TEST_JOBS:-1}
+if [ "${JOBS}" -gt 1 ]
+then
+  RESULTS_PATH=$(mktemp -d)
+  INDEX=0
+  for TEST in ${TESTS_OK[@]}
+  do
+    while [ $(jobs -rp | wc -l) -ge ${JOBS} ]
+    do
+      wait -n || true
+    done
+    (
+      run_test "${TEST}" > "${RESULTS_PATH}/${INDEX}.out" 2>&1 \
+        && echo 0 > "${RESULTS_PATH}/${INDEX}.result" \
+        || echo $? > "${RESULTS_PATH}/${INDEX}.result"
+    ) &
+    INDEX=$((INDEX + 1))
+  done
+  wait
+
+  INDEX=0
+  for TEST in ${TESTS_OK[@]}
+  do
+    cat "${RESULTS_PATH}/${INDEX}.out"
+    report_result "${TEST}" $(cat "${RESULTS_PATH}/${INDEX}.result")
+    INDEX=$((INDEX + 1))
+  done
+  rm -rf "${RESULTS_PATH}"
+else
+  for TEST in ${TESTS_OK[@]}
+  do
+    run_test "${TEST}" && RESULT=0 || RESULT=$?
+    report_result "${TEST}" ${RESULT}
+  done
+fi
 
 unset IFS
 echo ""
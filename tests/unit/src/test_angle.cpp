@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/Angle.h"
 
 // ... and any system includes needed for the test file.
+#include <cmath>
 
 namespace { // test namespace
 
@@ -114,6 +115,24 @@ TEST_CASE( "Angle::IsInRange", "[angle][isInRange]" ) {
 	REQUIRE_FALSE( Angle(-21.).IsInRange(base, limit) );
 	REQUIRE_FALSE( Angle(180.).IsInRange(base, limit) );
 }
+TEST_CASE( "Angle::Unit", "[angle][unit]" ) {
+	// Every quadrant uses the same table of sines, so check angles in each of them.
+	auto degrees = GENERATE(0., 1., 45., 89.9, 90., 135., 180., 200., 270., 300., 359.9);
+	const double radians = degrees * 3.14159265358979323846 / 180.;
+	const Point unit = Angle(degrees).Unit();
+	CHECK_THAT( unit.X(), Catch::Matchers::WithinAbs(std::sin(radians), 0.0001) );
+	CHECK_THAT( unit.Y(), Catch::Matchers::WithinAbs(-std::cos(radians), 0.0001) );
+	CHECK_THAT( unit.Length(), Catch::Matchers::WithinAbs(1., 1e-12) );
+}
+
+TEST_CASE( "Angle::Distance", "[angle][distance]" ) {
+	CHECK( Angle(30.).Distance(Angle(30.)) == 0 );
+	CHECK( Angle(10.).Distance(Angle(350.)) == Angle(350.).Distance(Angle(10.)) );
+	CHECK( Angle(10.).Distance(Angle(350.)) < Angle(10.).Distance(Angle(40.)) );
+	CHECK( Angle(0.).Distance(Angle(180.)) == Angle(0.).Distance(Angle(-180.)) );
+	CHECK( Angle(0.).Distance(Angle(179.)) < Angle(0.).Distance(Angle(180.)) );
+}
+
 // Test code goes here. Preferably, use scenario-driven language making use of the SCENARIO, GIVEN,
 // WHEN, and THEN macros. (There will be cases where the more traditional TEST_CASE and SECTION macros
 // are better suited to declaration of the public API.)
@@ -126,6 +145,14 @@ TEST_CASE( "Angle::IsInRange", "[angle][isInRange]" ) {
 
 // #region benchmarks
 #ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Angle::Unit", "[!benchmark][angle][unit]" ) {
+	BENCHMARK( "Angle::Unit()", i ) {
+		return Angle(i * 7.3).Unit();
+	};
+	BENCHMARK( "Angle::Angle(Point)", i ) {
+		return Angle(Point(i % 13 - 6., i % 7 - 3.));
+	};
+}
 TEST_CASE( "Benchmark Angle::Random", "[!benchmark][angle][random]" ) {
 	BENCHMARK( "Angle::Random()" ) {
 		return Angle::Random();
@@ -0,0 +1,120 @@
+/* test_binaryDataFile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/BinaryDataFile.h"
+
+// Include the class that is converted to and from the binary form.
+#include "../../../source/DataFile.h"
+
+// ... and any system includes needed for the test file.
+#include <iterator>
+#include <sstream>
+#include <string>
+
+namespace { // test namespace
+// #region mock data
+const std::string text = R"(pilot Jane Doe
+date 16 11 3013
+ship Sparrow
+	name "Buzzing Bee"
+	outfits
+		"Beam Laser" 2
+		"Energy Cell"
+	crew 1
+ship Sparrow
+	name `Another "quoted" name`
+	outfits
+		"Beam Laser" 2
+conditions
+	"" 0
+	"visited system: Sol"
+)";
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Converting a data file to the binary form and back", "[BinaryDataFile]" ) {
+	GIVEN( "A file in the text form" ) {
+		std::istringstream in(text);
+		const DataFile file(in);
+		const std::string expected = BinaryDataFile::ToText(file);
+
+		WHEN( "it is encoded" ) {
+			const std::string binary = BinaryDataFile::Encode(file);
+			THEN( "the result is recognized as binary" ) {
+				CHECK( BinaryDataFile::IsBinary(binary) );
+				CHECK_FALSE( BinaryDataFile::IsBinary(text) );
+			}
+			THEN( "decoding it gives back the same nodes" ) {
+				DataFile decoded;
+				REQUIRE( BinaryDataFile::Decode(binary, decoded) );
+				CHECK( BinaryDataFile::ToText(decoded) == expected );
+			}
+			THEN( "the decoded nodes have the same tokens and children" ) {
+				DataFile decoded;
+				REQUIRE( BinaryDataFile::Decode(binary, decoded) );
+				const DataNode &ship = *std::next(decoded.begin(), 2);
+				REQUIRE( ship.HasChildren() );
+				CHECK( ship.Token(0) == "ship" );
+				CHECK( ship.begin()->Token(0) == "name" );
+				CHECK( ship.begin()->Token(1) == "Buzzing Bee" );
+			}
+		}
+		WHEN( "the text is encoded directly" ) {
+			THEN( "the result is the same as encoding the parsed file" ) {
+				CHECK( BinaryDataFile::Encode(text) == BinaryDataFile::Encode(file) );
+			}
+		}
+	}
+	GIVEN( "Corrupt binary data" ) {
+		std::istringstream in(text);
+		std::string binary = BinaryDataFile::Encode(DataFile(in));
+		WHEN( "it is truncated" ) {
+			binary.resize(binary.size() / 2);
+			THEN( "it cannot be decoded, and nothing is read" ) {
+				DataFile decoded;
+				CHECK_FALSE( BinaryDataFile::Decode(binary, decoded) );
+				CHECK( decoded.begin() == decoded.end() );
+			}
+		}
+		WHEN( "its nodes are nested far more deeply than any real data" ) {
+			std::string deep;
+			for(int i = 0; i < 1000; ++i)
+				deep += std::string(i, '\t') + "node\n";
+			std::istringstream deepIn(deep);
+			binary = BinaryDataFile::Encode(DataFile(deepIn));
+			THEN( "it cannot be decoded, and nothing is read" ) {
+				DataFile decoded;
+				CHECK_FALSE( BinaryDataFile::Decode(binary, decoded) );
+				CHECK( decoded.begin() == decoded.end() );
+			}
+		}
+		WHEN( "it is not binary at all" ) {
+			THEN( "it cannot be decoded" ) {
+				DataFile decoded;
+				CHECK_FALSE( BinaryDataFile::Decode(text, decoded) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -19,6 +19,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/Bitset.h"
 
 // ... and any system includes needed for the test file.
+#include <cstddef>
+#include <vector>
 
 namespace { // test namespace
 
@@ -154,6 +156,88 @@ TEST_CASE( "Large bitsets", "[bitset]") {
 	CHECK( bitset.Any() );
 }
 
+SCENARIO( "Combining Bitsets", "[bitset]" ) {
+	GIVEN( "two bitsets of different sizes" ) {
+		Bitset one;
+		one.Resize(200);
+		for(size_t i : {0, 5, 64, 130, 199})
+			one.Set(i);
+
+		Bitset two;
+		two.Resize(100);
+		for(size_t i : {5, 6, 64})
+			two.Set(i);
+
+		THEN( "the set bits are counted" ) {
+			CHECK( one.Count() == 5 );
+			CHECK( two.Count() == 3 );
+		}
+		THEN( "the set bits can be visited in order" ) {
+			std::vector<size_t> found;
+			for(size_t i = one.FindNext(0); i < one.Size(); i = one.FindNext(i + 1))
+				found.push_back(i);
+			CHECK( found == std::vector<size_t>{0, 5, 64, 130, 199} );
+			CHECK( one.FindNext(65) == 130 );
+			CHECK( two.FindNext(65) == two.Size() );
+		}
+		WHEN( "they are combined with AND" ) {
+			one &= two;
+			THEN( "only the bits set in both remain" ) {
+				CHECK( one.Count() == 2 );
+				CHECK( one.Test(5) );
+				CHECK( one.Test(64) );
+			}
+		}
+		WHEN( "they are combined with OR" ) {
+			one |= two;
+			THEN( "the bits set in either are set" ) {
+				CHECK( one.Count() == 6 );
+				CHECK( one.Test(6) );
+			}
+		}
+		WHEN( "the bits of one are removed from the other" ) {
+			one.AndNot(two);
+			THEN( "only the bits not set in it remain" ) {
+				CHECK( one.Count() == 3 );
+				CHECK_FALSE( one.Test(5) );
+				CHECK_FALSE( one.Test(64) );
+				CHECK( one.Test(199) );
+			}
+		}
+	}
+}
+
+SCENARIO( "Resizing a Bitset keeps its bits", "[bitset]" ) {
+	GIVEN( "a small bitset" ) {
+		Bitset bitset;
+		bitset.Resize(10);
+		bitset.Set(3);
+
+		WHEN( "it grows beyond what is stored in place" ) {
+			bitset.Resize(1000);
+			bitset.Set(900);
+			THEN( "it still has its bits" ) {
+				CHECK( bitset.Test(3) );
+				CHECK( bitset.Test(900) );
+				CHECK( bitset.Count() == 2 );
+			}
+			AND_WHEN( "it shrinks again" ) {
+				bitset.Resize(10);
+				THEN( "only the bits that still fit remain" ) {
+					CHECK( bitset.Test(3) );
+					CHECK( bitset.Count() == 1 );
+				}
+				AND_WHEN( "it grows again" ) {
+					bitset.Resize(100);
+					THEN( "the dropped bits do not come back" ) {
+						CHECK( bitset.Count() == 1 );
+					}
+				}
+			}
+		}
+	}
+}
+
 // Test code goes here. Preferably, use scenario-driven language making use of the SCENARIO, GIVEN,
 // WHEN, and THEN macros. (There will be cases where the more traditional TEST_CASE and SECTION macros
 // are better suited to declaration of the public API.)
@@ -0,0 +1,177 @@
+/* test_collisionSet.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/CollisionSet.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Body.h"
+#include "../../../source/Point.h"
+
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Finding the objects near a point", "[CollisionSet]" ) {
+	GIVEN( "objects spread out in a collision set" ) {
+		std::vector<Body> bodies;
+		for(double x : {300., -100., 50., 2000., 150.})
+			bodies.emplace_back(nullptr, Point(x, 0.));
+		CollisionSet set(256u, 32u, CollisionType::SHIP);
+		set.Clear(-1);
+		for(Body &body : bodies)
+			set.Add(body);
+		set.Finish();
+
+		WHEN( "getting every object within a range" ) {
+			std::vector<Body *> result;
+			set.Nearby(Point(100., 0.), 210., result);
+
+			THEN( "only the objects inside it are found, in the order they were added" ) {
+				REQUIRE( result.size() == 4 );
+				CHECK( result[0] == &bodies[0] );
+				CHECK( result[1] == &bodies[1] );
+				CHECK( result[2] == &bodies[2] );
+				CHECK( result[3] == &bodies[4] );
+			}
+		}
+		WHEN( "the range covers more than the whole grid" ) {
+			std::vector<Body *> result;
+			set.Nearby(Point(100., 0.), 100000., result);
+
+			THEN( "every object is found" ) {
+				CHECK( result.size() == bodies.size() );
+			}
+		}
+		WHEN( "getting the closest objects within a range" ) {
+			std::vector<Body *> result;
+			set.Nearest(Point(100., 0.), 210., 2, result);
+
+			THEN( "they are sorted from nearest to farthest" ) {
+				REQUIRE( result.size() == 2 );
+				CHECK( result[0] == &bodies[2] );
+				CHECK( result[1] == &bodies[4] );
+			}
+		}
+	}
+}
+
+SCENARIO( "Measuring how crowded a collision set is", "[CollisionSet]" ) {
+	GIVEN( "a few objects, two of which share a grid cell" ) {
+		std::vector<Body> bodies;
+		for(double x : {10., 20., 300.})
+			bodies.emplace_back(nullptr, Point(x, 10.));
+		CollisionSet set(256u, 32u, CollisionType::SHIP);
+		set.Clear(-1);
+		for(Body &body : bodies)
+			set.Add(body);
+		set.Finish();
+
+		THEN( "the statistics count the objects and the cells they are in" ) {
+			const CollisionSet::Statistics statistics = set.GetStatistics();
+			CHECK( statistics.objects == 3 );
+			CHECK( statistics.entries == 3 );
+			CHECK( statistics.occupiedCells == 2 );
+			CHECK( statistics.maxCellLoad == 2 );
+			CHECK( statistics.cellsVisited == 0 );
+		}
+		WHEN( "the set is queried" ) {
+			std::vector<Body *> result;
+			set.Circle(Point(10., 10.), 20., result);
+
+			THEN( "the cells that the query looked at are counted until the set is cleared" ) {
+				CHECK( set.GetStatistics().cellsVisited == 4 );
+				set.Clear(0);
+				CHECK( set.GetStatistics().cellsVisited == 0 );
+			}
+		}
+	}
+}
+
+SCENARIO( "Letting a collision set pick its own grid size", "[CollisionSet]" ) {
+	GIVEN( "an adaptive collision set" ) {
+		CollisionSet set(CollisionType::SHIP);
+		THEN( "it starts out with the usual grid size" ) {
+			CHECK( set.CellSize() == 256 );
+			CHECK( set.CellCount() == 32 );
+		}
+		WHEN( "it only ever holds a few small objects" ) {
+			std::vector<Body> bodies;
+			for(double x : {0., 1000., 2000., 3000., 4000.})
+				bodies.emplace_back(nullptr, Point(x, 0.));
+			for(int step = 0; step < 100; ++step)
+			{
+				set.Clear(step);
+				for(Body &body : bodies)
+					set.Add(body);
+				set.Finish();
+			}
+
+			THEN( "the grid shrinks to suit them" ) {
+				CHECK( set.CellSize() == 64 );
+				CHECK( set.CellCount() == 8 );
+			}
+			THEN( "queries still find the objects" ) {
+				std::vector<Body *> result;
+				set.Nearby(Point(2000., 0.), 10., result);
+				REQUIRE( result.size() == 1 );
+				CHECK( result[0] == &bodies[2] );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark CollisionSet", "[!benchmark][CollisionSet]" ) {
+	for(int count : {100, 1000, 10000})
+	{
+		// Spread the objects over a 20000 pixel square, in a fixed pattern.
+		std::vector<Body> bodies;
+		bodies.reserve(count);
+		for(int i = 0; i < count; ++i)
+			bodies.emplace_back(nullptr, Point((i * 7919) % 20000 - 10000., (i * 104729) % 20000 - 10000.));
+
+		CollisionSet set(256u, 32u, CollisionType::SHIP);
+		BENCHMARK( "Add() and Finish() with " + std::to_string(count) + " objects" ) {
+			set.Clear(0);
+			for(Body &body : bodies)
+				set.Add(body);
+			set.Finish();
+			return set.All().size();
+		};
+
+		set.Clear(0);
+		for(Body &body : bodies)
+			set.Add(body);
+		set.Finish();
+		std::vector<Body *> result;
+		BENCHMARK( "Nearby() with " + std::to_string(count) + " objects", i ) {
+			set.Nearby(Point((i * 37) % 20000 - 10000., 0.), 1000., result);
+			return result.size();
+		};
+	}
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
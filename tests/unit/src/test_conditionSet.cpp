@@ -356,6 +356,56 @@ SCENARIO( "Determining if condition requirements are met", "[ConditionSet][Usage
 	}
 }
 
+SCENARIO( "Evaluating a ConditionSet again after the conditions change", "[ConditionSet][Evaluation]" ) {
+	GIVEN( "an expression that uses conditions which are not all set yet" ) {
+		auto store = ConditionsStore{{"someData", 10}};
+		const auto set = ConditionSet{AsDataNode("toplevel\n\tsomeData + laterData * 2 > 20"), &store};
+		REQUIRE( set.Evaluate() == 0 );
+
+		THEN( "changing a condition that was already set changes the result" ) {
+			store.Set("someData", 30);
+			REQUIRE( set.Evaluate() == 1 );
+		}
+		THEN( "setting a condition that did not exist yet changes the result" ) {
+			store.Set("laterData", 6);
+			REQUIRE( set.Evaluate() == 1 );
+		}
+		THEN( "providing a condition through a prefixed provider changes the result" ) {
+			store["later"].ProvidePrefixed([](const ConditionEntry &) -> int64_t { return 7; });
+			REQUIRE( set.Evaluate() == 1 );
+		}
+		THEN( "replacing the contents of the store changes the result" ) {
+			store = ConditionsStore{{"laterData", 50}};
+			REQUIRE( set.Evaluate() == 1 );
+			store = ConditionsStore{};
+			REQUIRE( set.Evaluate() == 0 );
+		}
+		THEN( "a provided condition is read again each time, since it can change without being set" ) {
+			int64_t provided = 0;
+			store["laterData"].ProvideNamed([&provided](const ConditionEntry &) -> int64_t { return provided; });
+			REQUIRE( set.Evaluate() == 0 );
+			provided = 6;
+			REQUIRE( set.Evaluate() == 1 );
+			provided = 0;
+			REQUIRE( set.Evaluate() == 0 );
+		}
+		THEN( "the result stays the same until a condition is set" ) {
+			REQUIRE( set.HasStableResult() );
+		}
+		THEN( "a result that depends on a provided condition is not stable" ) {
+			store["laterData"].ProvideNamed([](const ConditionEntry &) -> int64_t { return 0; });
+			REQUIRE( set.Evaluate() == 0 );
+			REQUIRE_FALSE( set.HasStableResult() );
+		}
+		THEN( "copies of the set give the same results" ) {
+			const ConditionSet copy = set;
+			store.Set("laterData", 6);
+			REQUIRE( copy.Evaluate() == 1 );
+			REQUIRE( set.Evaluate() == 1 );
+		}
+	}
+}
+
 // #endregion unit tests
 
 
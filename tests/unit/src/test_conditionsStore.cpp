@@ -18,9 +18,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // Include only the tested class's header.
 #include "../../../source/ConditionsStore.h"
 
+// Include DataWriter to check the saved conditions.
+#include "../../../source/DataWriter.h"
+
 // ... and any system includes needed for the test file.
 #include <map>
 #include <string>
+#include <vector>
 
 
 
@@ -233,6 +237,118 @@ SCENARIO( "Setting conditions", "[ConditionStore][ConditionSetting]" )
 	}
 }
 
+SCENARIO( "Tracking changes to conditions", "[ConditionStore][ConditionVersions]" )
+{
+	GIVEN( "A conditionsStore with a condition" )
+	{
+		auto store = ConditionsStore{{"myFirstVar", 10}};
+		const ConditionEntry &entry = store["myFirstVar"];
+		const uint64_t version = entry.Version();
+		const uint64_t changes = ConditionEntry::Changes();
+		THEN( "reading conditions does not count as a change" )
+		{
+			REQUIRE( store.Get("myFirstVar") == 10 );
+			REQUIRE( store.Get("mySecondVar") == 0 );
+			REQUIRE( entry.Version() == version );
+			REQUIRE( ConditionEntry::Changes() == changes );
+		}
+		THEN( "setting the condition changes its version" )
+		{
+			store.Set("myFirstVar", 20);
+			REQUIRE( entry.Version() != version );
+			REQUIRE( ConditionEntry::Changes() != changes );
+		}
+		THEN( "setting another condition does not change its version" )
+		{
+			store.Set("mySecondVar", 20);
+			REQUIRE( entry.Version() == version );
+			REQUIRE( ConditionEntry::Changes() != changes );
+		}
+		THEN( "conditions from providers are marked as derived" )
+		{
+			REQUIRE_FALSE( entry.IsDerived() );
+			store["myProvided"].ProvideNamed([](const ConditionEntry &) -> int64_t { return 5; });
+			REQUIRE( store["myProvided"].IsDerived() );
+			REQUIRE( ConditionEntry::Changes() != changes );
+		}
+	}
+}
+
+SCENARIO( "Caching derived conditions", "[ConditionStore][ConditionCaching]" )
+{
+	GIVEN( "A conditionsStore with a cached provider that counts how often it is called" )
+	{
+		auto store = ConditionsStore();
+		int calls = 0;
+		store["counted"].ProvideNamed([&calls](const ConditionEntry &) -> int64_t { return ++calls; });
+		store["counted"].CacheUntilNextFrame();
+		THEN( "reading it again in the same frame reuses the value" )
+		{
+			REQUIRE( store.Get("counted") == 1 );
+			REQUIRE( store.Get("counted") == 1 );
+			REQUIRE( calls == 1 );
+		}
+		THEN( "it is computed again in the next frame" )
+		{
+			REQUIRE( store.Get("counted") == 1 );
+			ConditionEntry::NextFrame();
+			REQUIRE( store.Get("counted") == 2 );
+		}
+		THEN( "it is computed again once any condition is set" )
+		{
+			REQUIRE( store.Get("counted") == 1 );
+			store.Set("other", 3);
+			REQUIRE( store.Get("counted") == 2 );
+		}
+	}
+	GIVEN( "A cached prefixed provider" )
+	{
+		auto store = ConditionsStore();
+		int calls = 0;
+		store["count: "].ProvidePrefixed([&calls](const ConditionEntry &ce) -> int64_t {
+			++calls;
+			return ce.NameWithoutPrefix().length();
+		});
+		store["count: "].CacheUntilNextFrame();
+		THEN( "each condition it provides is cached separately" )
+		{
+			const ConditionEntry &one = store["count: a"];
+			const ConditionEntry &two = store["count: bb"];
+			REQUIRE( one == 1 );
+			REQUIRE( two == 2 );
+			REQUIRE( one == 1 );
+			REQUIRE( calls == 2 );
+		}
+	}
+}
+
+SCENARIO( "Saving conditions", "[ConditionStore][ConditionSaving]" )
+{
+	GIVEN( "A conditionsStore with conditions set in no particular order" )
+	{
+		auto store = ConditionsStore();
+		store.Set("zulu", 3);
+		store.Set("alpha", 1);
+		store.Set("mike", 2);
+		store.Set("empty", 0);
+		store["provided"].ProvideNamed([](const ConditionEntry &) -> int64_t { return 5; });
+		THEN( "they are saved in order of their names, without the empty and provided ones" )
+		{
+			DataWriter out;
+			store.Save(out);
+			REQUIRE( out.SaveToString() == "conditions\n\talpha\n\tmike 2\n\tzulu 3\n" );
+		}
+		THEN( "they can still be found after the store is replaced" )
+		{
+			auto other = ConditionsStore();
+			other = std::move(store);
+			REQUIRE( other.Get("mike") == 2 );
+			REQUIRE( other.Get("provided") == 5 );
+			REQUIRE( store.Get("mike") == 0 );
+		}
+	}
+}
+
 SCENARIO( "Adding and removing on condition values", "[ConditionStore][ConditionArithmetic]" )
 {
 	GIVEN( "A conditionsStore with 1 condition" )
@@ -599,6 +715,30 @@ SCENARIO( "Providing multiple derived conditions", "[ConditionStore][DerivedMult
 
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ConditionsStore", "[!benchmark][ConditionsStore]" ) {
+	constexpr int SIZE = 1000;
+
+	ConditionsStore store;
+	std::vector<std::string> names;
+	for(int i = 0; i < SIZE; ++i)
+	{
+		names.emplace_back("condition " + std::to_string(i));
+		store.Set(names.back(), i);
+	}
+
+	BENCHMARK( "ConditionsStore::Get()", i ) {
+		return store.Get(names[i % SIZE]);
+	};
+	BENCHMARK( "ConditionsStore::Set()", i ) {
+		store.Set(names[i % SIZE], i);
+		return store.PrimariesSize();
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
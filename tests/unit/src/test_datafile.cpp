@@ -104,6 +104,25 @@ node2 hi
 	}
 }
 
+SCENARIO( "Creating a DataFile with many nodes", "[DataFile]") {
+	OutputSink sink(std::cerr);
+	GIVEN( "A stream with many nodes at each level" ) {
+		std::string text;
+		for(int i = 0; i < 100; ++i)
+			text += "node\n\tchild\n\tchild\n";
+		std::istringstream stream(text);
+		const DataFile root(stream);
+
+		THEN( "the first nodes still know their parents" ) {
+			REQUIRE( std::distance(root.begin(), root.end()) == 100 );
+			CHECK( root.begin()->PrintTrace() == 2 );
+			CHECK( IgnoreLogHeaders(sink.Flush()) == "L1:   node\n" );
+			CHECK( root.begin()->begin()->PrintTrace() == 4 );
+			CHECK( IgnoreLogHeaders(sink.Flush()) == "L1:   node\nL2:     child\n" );
+		}
+	}
+}
+
 SCENARIO( "Loading a DataFile with missing quotes", "[DataFile]" ) {
 	OutputSink sink(std::cerr);
 
@@ -291,6 +310,27 @@ now with
 }
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark DataFile parsing", "[!benchmark][datafile]" ) {
+	std::string text;
+	for(int i = 0; i < 1000; ++i)
+		text += "outfit \"Outfit " + std::to_string(i) + "\"\n"
+			"\tcategory \"Power\"\n"
+			"\tcost " + std::to_string(1000 * i) + "\n"
+			"\t\"energy generation\" 1.5\n"
+			"\t\"outfit space\" -12\n"
+			"\tdescription `A description of this outfit, which is long enough to be realistic.`\n";
+
+	BENCHMARK( "DataFile(std::istream &) with 1000 outfits" ) {
+		std::istringstream in(text);
+		const DataFile file(in);
+		return std::distance(file.begin(), file.end());
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
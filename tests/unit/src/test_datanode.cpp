@@ -43,7 +43,7 @@ TEST_CASE( "DataNode Basics", "[DataNode]" ) {
 	SECTION( "Class Traits" ) {
 		CHECK_FALSE( std::is_trivial_v<T> );
 		// The class layout apparently satisfies StandardLayoutType when building/testing for Steam, but false otherwise.
-		// This may change in the future, with the expectation of false everywhere (due to the list<DataNode> field).
+		// This may change in the future, with the expectation of false everywhere (due to the vector<DataNode> field).
 		// CHECK_FALSE( std::is_standard_layout_v<T> );
 		CHECK( std::is_nothrow_destructible_v<T> );
 		CHECK_FALSE( std::is_trivially_destructible_v<T> );
@@ -64,7 +64,7 @@ TEST_CASE( "DataNode Basics", "[DataNode]" ) {
 	}
 	SECTION( "Copy Traits" ) {
 		CHECK( std::is_copy_assignable_v<T> );
-		// The class data can be spread out due to vector + list contents.
+		// The class data can be spread out due to vector contents.
 		CHECK_FALSE( std::is_trivially_copyable_v<T> );
 		// We have work to do when copying.
 		CHECK_FALSE( std::is_trivially_copy_assignable_v<T> );
@@ -109,6 +109,30 @@ SCENARIO( "Creating a DataNode", "[DataNode]") {
 			CHECK_FALSE( root.HasChildren() );
 		}
 	}
+	GIVEN( "A DataNode with many child nodes" ) {
+		std::string text = "parent\n";
+		for(int i = 0; i < 100; ++i)
+			text += "\tchild\n\t\tgrand\n";
+		DataNode parent = AsDataNode(text);
+		THEN( "the first children still print correct traces" ) {
+			const DataNode &child = *parent.begin();
+			CHECK( child.PrintTrace() == 2 );
+			CHECK( IgnoreLogHeaders(traces.Flush()) == "parent\nL2:   child\n");
+			CHECK( child.begin()->PrintTrace() == 4 );
+			CHECK( IgnoreLogHeaders(traces.Flush()) == "parent\nL2:   child\nL3:     grand\n");
+		}
+		WHEN( "more children are added" ) {
+			const DataNode extra = AsDataNode("extra");
+			for(int i = 0; i < 100; ++i)
+				parent.AddChild(extra);
+			THEN( "the old and new children print correct traces" ) {
+				CHECK( parent.begin()->PrintTrace() == 2 );
+				CHECK( IgnoreLogHeaders(traces.Flush()) == "parent\nL2:   child\n");
+				CHECK( (parent.end() - 1)->PrintTrace() == 2 );
+				CHECK( IgnoreLogHeaders(traces.Flush()) == "parent\nL1:   extra\n");
+			}
+		}
+	}
 	GIVEN( "A DataNode with child nodes" ) {
 		DataNode parent = AsDataNode("parent\n\tchild\n\t\tgrand");
 		WHEN( "Copying by assignment" ) {
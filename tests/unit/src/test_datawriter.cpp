@@ -21,6 +21,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // ... and any system includes needed for the test file.
 #include "../../../source/DataNode.h"
 
+#include <sstream>
+#include <string>
+
 namespace { // test namespace
 
 // #region mock data
@@ -184,6 +187,49 @@ TEST_CASE( "DataWriter::Write", "[datawriter][write]" ) {
 		}
 	}
 }
+TEST_CASE( "DataWriter::WriteToken", "[datawriter][writetoken]" ) {
+	DataWriter writer;
+	GIVEN( "integers" ) {
+		writer.Write(0, -12, 123456789012345LL, 7u);
+		THEN( "they are written in full" ) {
+			CHECK( writer.SaveToString() == "0 -12 123456789012345 7\n" );
+		}
+	}
+	GIVEN( "floating point numbers" ) {
+		writer.Write(1.5, -0.25, 1. / 3., 123456789., 1e-7, 2.f);
+		THEN( "they are written with up to 8 significant digits" ) {
+			CHECK( writer.SaveToString() == "1.5 -0.25 0.33333333 1.2345679e+08 1e-07 2\n" );
+		}
+	}
+	GIVEN( "a boolean and a character" ) {
+		writer.Write(true, 'x');
+		THEN( "they are written as a number and a character" ) {
+			CHECK( writer.SaveToString() == "1 x\n" );
+		}
+	}
+}
+
+TEST_CASE( "DataWriter writing to a stream", "[datawriter][stream]" ) {
+	GIVEN( "a DataWriter that writes to a stream" ) {
+		std::ostringstream stream;
+		std::string expected;
+		{
+			DataWriter writer(stream);
+			for(int i = 0; i < 20000; ++i)
+			{
+				writer.Write("line", i);
+				expected += "line " + std::to_string(i) + "\n";
+			}
+			THEN( "large output is written before the writer is done" ) {
+				CHECK( !stream.str().empty() );
+				CHECK( stream.str().size() + writer.SaveToString().size() == expected.size() );
+			}
+		}
+		THEN( "all of the output is written once the writer is destroyed" ) {
+			CHECK( stream.str() == expected );
+		}
+	}
+}
 // #endregion unit tests
 
 
@@ -53,6 +53,58 @@ SCENARIO( "A Dictionary instance is being used", "[dictionary]") {
 	}
 }
 
+SCENARIO( "Reading a Dictionary through attribute keys", "[dictionary]") {
+	GIVEN( "a dictionary with some attributes that have keys and some that do not" ) {
+		Dictionary dict;
+		dict["thrust"] = 10.;
+		dict["zzz plugin attribute"] = 1.;
+		dict["drag"] = 2.;
+		THEN( "the keyed attributes can be read by key or by name" ) {
+			CHECK( dict.Get(AttributeKey::THRUST) == 10. );
+			CHECK( dict.Get(AttributeKey::DRAG) == 2. );
+			CHECK( dict.Get("thrust") == 10. );
+		}
+		THEN( "missing keyed attributes are zero" ) {
+			CHECK( dict.Get(AttributeKey::TURN) == 0. );
+		}
+		WHEN( "attributes are added before and after the keyed ones" ) {
+			dict["aaa plugin attribute"] = 3.;
+			dict["turn"] = 4.;
+			dict["drag"] += 1.;
+			THEN( "the keys still find the right values" ) {
+				CHECK( dict.Get(AttributeKey::THRUST) == 10. );
+				CHECK( dict.Get(AttributeKey::DRAG) == 3. );
+				CHECK( dict.Get(AttributeKey::TURN) == 4. );
+			}
+		}
+		WHEN( "attributes are erased" ) {
+			dict.Erase("drag");
+			dict.Erase("zzz plugin attribute");
+			THEN( "the erased keyed attribute is zero and the others are unchanged" ) {
+				CHECK( dict.Get(AttributeKey::DRAG) == 0. );
+				CHECK( dict.Get(AttributeKey::THRUST) == 10. );
+			}
+		}
+		WHEN( "the dictionary is copied" ) {
+			Dictionary copy = dict;
+			copy["thrust"] = 5.;
+			THEN( "the copy's keys refer to its own values" ) {
+				CHECK( copy.Get(AttributeKey::THRUST) == 5. );
+				CHECK( dict.Get(AttributeKey::THRUST) == 10. );
+			}
+		}
+	}
+	GIVEN( "a dictionary containing every keyed attribute" ) {
+		Dictionary dict;
+		for(size_t i = 0; i < ATTRIBUTE_KEY_NAMES.size(); ++i)
+			dict[ATTRIBUTE_KEY_NAMES[i]] = i + 1.;
+		THEN( "every key refers to the attribute with its name" ) {
+			for(size_t i = 0; i < ATTRIBUTE_KEY_NAMES.size(); ++i)
+				CHECK( dict.Get(static_cast<AttributeKey>(i)) == i + 1. );
+		}
+	}
+}
+
 // #region benchmarks
 #ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
 TEST_CASE( "Benchmark Dictionary::Get", "[!benchmark][dictionary]" ) {
@@ -75,6 +127,9 @@ TEST_CASE( "Benchmark Dictionary::Get", "[!benchmark][dictionary]" ) {
 	BENCHMARK( "Dictionary::Get()", i ) {
 		return dict.Get(strings[i % SIZE]);
 	};
+	BENCHMARK( "Dictionary::Get(AttributeKey)", i ) {
+		return dict.Get(static_cast<AttributeKey>(i % static_cast<int>(AttributeKey::COUNT)));
+	};
 }
 #endif
 // #endregion benchmarks
@@ -0,0 +1,105 @@
+/* test_indexedSet.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/IndexedSet.h"
+
+// ... and any system includes needed for the test file.
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+class Object {
+public:
+	int Index() const { return index; }
+
+	int index = -1;
+};
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Adding and removing objects in an IndexedSet", "[IndexedSet]" ) {
+	GIVEN( "an empty set" ) {
+		IndexedSet<Object> set;
+		std::vector<Object> objects(200);
+		for(size_t i = 0; i < objects.size(); ++i)
+			objects[i].index = i;
+		REQUIRE( set.empty() );
+
+		WHEN( "objects are inserted" ) {
+			CHECK( set.insert(&objects[3]) );
+			CHECK( set.insert(&objects[150]) );
+			CHECK_FALSE( set.insert(&objects[3]) );
+			THEN( "only those objects are in it" ) {
+				CHECK( set.size() == 2 );
+				CHECK( set.contains(&objects[3]) );
+				CHECK( set.contains(&objects[150]) );
+				CHECK_FALSE( set.contains(&objects[4]) );
+				CHECK_FALSE( set.contains(&objects[199]) );
+			}
+			THEN( "they are iterated over in the order they were inserted" ) {
+				std::vector<const Object *> contents(set.begin(), set.end());
+				CHECK( contents == std::vector<const Object *>{&objects[3], &objects[150]} );
+			}
+			AND_WHEN( "one of them is erased" ) {
+				CHECK( set.erase(&objects[3]) );
+				CHECK_FALSE( set.erase(&objects[3]) );
+				THEN( "only the other one remains" ) {
+					CHECK( set.size() == 1 );
+					CHECK_FALSE( set.contains(&objects[3]) );
+					CHECK( set.contains(&objects[150]) );
+				}
+			}
+			AND_WHEN( "the set is cleared" ) {
+				set.clear();
+				THEN( "it is empty" ) {
+					CHECK( set.empty() );
+					CHECK_FALSE( set.contains(&objects[150]) );
+				}
+			}
+		}
+	}
+}
+
+SCENARIO( "An IndexedSet holds objects that have no index yet", "[IndexedSet]" ) {
+	GIVEN( "an object with no index" ) {
+		IndexedSet<Object> set;
+		Object object;
+		REQUIRE( set.insert(&object) );
+		REQUIRE( set.contains(&object) );
+
+		WHEN( "the object is given an index" ) {
+			object.index = 70;
+			THEN( "it is still in the set" ) {
+				CHECK( set.contains(&object) );
+			}
+			THEN( "it can still be erased" ) {
+				CHECK( set.erase(&object) );
+				CHECK_FALSE( set.contains(&object) );
+				CHECK( set.empty() );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,60 @@
+/* test_kinematics.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Kinematics.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Point.h"
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Moving many objects at once", "[Kinematics]" ) {
+	GIVEN( "more objects than fit in a single vector register" ) {
+		Kinematics kinematics;
+		for(int i = 0; i < 11; ++i)
+			kinematics.Add(Point(i, -i), Point(2. * i, 1.), Point(1., -.5 * i), i % 2 ? .5 : 0.);
+		REQUIRE( kinematics.Size() == 11 );
+
+		WHEN( "they are integrated" ) {
+			kinematics.Integrate();
+
+			THEN( "drag, acceleration and velocity are applied to each of them" ) {
+				for(int i = 0; i < 11; ++i)
+				{
+					const double retained = i % 2 ? .5 : 1.;
+					const Point velocity = Point(2. * i, 1.) * retained + Point(1., -.5 * i);
+					CHECK( kinematics.Velocity(i) == velocity );
+					CHECK( kinematics.Position(i) == Point(i, -i) + velocity );
+				}
+			}
+		}
+		WHEN( "they are cleared" ) {
+			kinematics.Clear();
+
+			THEN( "there is nothing left to move" ) {
+				CHECK( kinematics.Size() == 0 );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
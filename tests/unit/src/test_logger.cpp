@@ -0,0 +1,99 @@
+/* test_logger.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Logger.h"
+
+// ... and any system includes needed for the test file.
+#include "output-capture.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace { // test namespace
+
+// #region mock data
+
+
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Capturing the messages that a thread logs", "[Logger]" ) {
+	OutputSink sink(std::cerr);
+
+	GIVEN( "a capture on this thread" ) {
+		Logger::Messages messages;
+		{
+			Logger::Capture capture(messages);
+			Logger::Log("first", Logger::Level::WARNING);
+			Logger::Log("second", Logger::Level::ERROR);
+		}
+		THEN( "the messages are kept in order instead of written" ) {
+			REQUIRE( messages.size() == 2 );
+			CHECK( messages[0].first == "first" );
+			CHECK( messages[0].second == Logger::Level::WARNING );
+			CHECK( messages[1].first == "second" );
+			CHECK( messages[1].second == Logger::Level::ERROR );
+			CHECK( sink.Flush().empty() );
+		}
+		WHEN( "they are logged after the capture has ended" ) {
+			Logger::Log(messages);
+			THEN( "they are written in the same order" ) {
+				const std::string output = sink.Flush();
+				REQUIRE( output.find("first") != std::string::npos );
+				CHECK( output.find("first") < output.find("second") );
+			}
+		}
+	}
+	GIVEN( "a capture inside another capture" ) {
+		Logger::Messages outer;
+		Logger::Messages inner;
+		{
+			Logger::Capture outerCapture(outer);
+			{
+				Logger::Capture innerCapture(inner);
+				Logger::Log("inner", Logger::Level::WARNING);
+			}
+			Logger::Log("outer", Logger::Level::WARNING);
+		}
+		THEN( "each message goes to the capture that was active when it was logged" ) {
+			REQUIRE( inner.size() == 1 );
+			CHECK( inner[0].first == "inner" );
+			REQUIRE( outer.size() == 1 );
+			CHECK( outer[0].first == "outer" );
+		}
+	}
+	GIVEN( "a capture on another thread" ) {
+		Logger::Messages messages;
+		Logger::Capture capture(messages);
+		std::thread other([] { Logger::Log("elsewhere", Logger::Level::WARNING); });
+		other.join();
+		THEN( "the other thread's messages are not captured" ) {
+			CHECK( messages.empty() );
+			CHECK( sink.Flush().find("elsewhere") != std::string::npos );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,165 @@
+/* test_mask.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/image/Mask.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Angle.h"
+#include "../../../source/Point.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// A jagged star with enough points to need a deep tree, and a hole in it.
+std::vector<std::vector<Point>> StarOutlines()
+{
+	std::vector<std::vector<Point>> outlines(2);
+	const int points = 1000;
+	for(int i = 0; i < points; ++i)
+	{
+		const double angle = 2. * std::numbers::pi * i / points;
+		const double radius = 100. + (i % 2 ? 30. : 0.) + 10. * std::sin(7. * angle);
+		outlines[0].emplace_back(radius * std::cos(angle), radius * std::sin(angle));
+	}
+	// The hole runs in the opposite direction.
+	for(int i = 0; i < 40; ++i)
+	{
+		const double angle = -2. * std::numbers::pi * i / 40;
+		outlines[1].emplace_back(20. * std::cos(angle), 20. * std::sin(angle));
+	}
+	return outlines;
+}
+
+// The checks done by the mask, but for every segment of every outline.
+bool ContainsReference(const std::vector<std::vector<Point>> &outlines, Point point)
+{
+	int intersections = 0;
+	for(const auto &outline : outlines)
+	{
+		Point prev = outline.back();
+		for(const Point &next : outline)
+		{
+			if(prev.X() != next.X() && (prev.X() <= point.X()) == (point.X() < next.X()))
+			{
+				double y = prev.Y() + (next.Y() - prev.Y()) * (point.X() - prev.X()) / (next.X() - prev.X());
+				intersections += (y >= point.Y());
+			}
+			prev = next;
+		}
+	}
+	return intersections & 1;
+}
+
+double IntersectionReference(const std::vector<std::vector<Point>> &outlines, Point sA, Point vA)
+{
+	double closest = 1.;
+	for(const auto &outline : outlines)
+	{
+		Point prev = outline.back();
+		for(const Point &next : outline)
+		{
+			Point vB = next - prev;
+			double cross = vB.Cross(vA);
+			if(cross > 0.)
+			{
+				Point vS = prev - sA;
+				double uB = vA.Cross(vS);
+				double uA = vB.Cross(vS);
+				if(uB >= 0. && uB < cross && uA >= 0.)
+					closest = std::min(closest, uA / cross);
+			}
+			prev = next;
+		}
+	}
+	return closest;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Colliding with a detailed mask", "[Mask]" ) {
+	GIVEN( "a mask with many outline segments" ) {
+		Mask mask;
+		mask.Create(StarOutlines());
+		REQUIRE( mask.IsLoaded() );
+		const auto &outlines = mask.Outlines();
+
+		THEN( "points are contained exactly when every segment says they are" ) {
+			for(int x = -150; x <= 150; x += 7)
+				for(int y = -150; y <= 150; y += 5)
+				{
+					const Point point(x + .25, y + .5);
+					CHECK( mask.Contains(point, Angle()) == ContainsReference(outlines, point) );
+				}
+			CHECK( mask.Contains(Point(0., 60.), Angle()) );
+			CHECK_FALSE( mask.Contains(Point(0., 0.), Angle()) );
+		}
+		THEN( "segments collide where every segment says they do" ) {
+			for(int i = 0; i < 360; i += 3)
+			{
+				const Point start = 200. * Point(std::cos(i * std::numbers::pi / 180.), std::sin(i * std::numbers::pi / 180.));
+				const Point end = Point(.3 * i - 50., 40. - .2 * i);
+				const double expected = ContainsReference(outlines, start) ? 0.
+					: IntersectionReference(outlines, start, end - start);
+				CHECK( mask.Collide(start, end - start, Angle()) == expected );
+			}
+		}
+		WHEN( "it is scaled" ) {
+			const Mask scaled = mask * Point(.5, 2.);
+
+			THEN( "collisions use the scaled outlines" ) {
+				CHECK( scaled.Contains(Point(0., 120.), Angle()) );
+				CHECK_FALSE( scaled.Contains(Point(120., 0.), Angle()) );
+				const double hit = scaled.Collide(Point(0., -400.), Point(0., 400.), Angle());
+				CHECK( hit == IntersectionReference(scaled.Outlines(), Point(0., -400.), Point(0., 400.)) );
+				CHECK( hit < 1. );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Mask", "[!benchmark][Mask]" ) {
+	Mask mask;
+	mask.Create(StarOutlines());
+
+	BENCHMARK( "Mask::Collide() from outside the mask", i ) {
+		const double angle = i * std::numbers::pi / 180.;
+		const Point start = 200. * Point(std::cos(angle), std::sin(angle));
+		return mask.Collide(start, -start, Angle());
+	};
+	BENCHMARK( "Mask::Contains()", i ) {
+		return mask.Contains(Point(i % 300 - 150., (i * 7) % 300 - 150.), Angle());
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
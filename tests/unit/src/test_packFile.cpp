@@ -0,0 +1,92 @@
+/* test_packFile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/PackFile.h"
+
+// ... and any system includes needed for the test file.
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace { // test namespace
+// #region mock data
+void WriteFile(const std::filesystem::path &path, const std::string &contents)
+{
+	std::filesystem::create_directories(path.parent_path());
+	std::ofstream(path, std::ios::binary) << contents;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Packing a directory of resources into a single file", "[PackFile]" ) {
+	GIVEN( "A directory with data, images, and other files" ) {
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "es-test-pack";
+		std::filesystem::remove_all(directory);
+		WriteFile(directory / "credits.txt", "credits");
+		WriteFile(directory / "data" / "map.txt", "system Sol");
+		WriteFile(directory / "data" / "human" / "ships.txt", "ship Shuttle");
+		WriteFile(directory / "images" / "ship" / "shuttle.png", std::string("\x89PNG\0\1", 6));
+		WriteFile(directory / "source" / "main.cpp", "int main() {}");
+		const std::filesystem::path packPath = directory / "resources.pack";
+
+		WHEN( "it is packed" ) {
+			REQUIRE( PackFile::Build(directory, packPath) );
+			const PackFile pack(packPath);
+
+			THEN( "the packed files can be read in place" ) {
+				std::string_view contents;
+				REQUIRE( pack.View(packPath / "data" / "human" / "ships.txt", contents) );
+				CHECK( contents == "ship Shuttle" );
+				CHECK( pack.ReadFile(packPath / "images" / "ship" / "shuttle.png") == std::string("\x89PNG\0\1", 6) );
+				CHECK( pack.ReadFile(packPath / "credits.txt") == "credits" );
+			}
+			THEN( "each file starts on an aligned offset" ) {
+				std::string_view contents;
+				REQUIRE( pack.View(packPath / "data" / "map.txt", contents) );
+				std::string_view other;
+				REQUIRE( pack.View(packPath / "credits.txt", other) );
+				CHECK( (contents.data() - other.data()) % 64 == 0 );
+			}
+			THEN( "directories exist, but files outside the asset directories are not packed" ) {
+				CHECK( pack.Exists(packPath / "data") );
+				CHECK( pack.Exists(packPath / "images" / "ship") );
+				CHECK_FALSE( pack.Exists(packPath / "source" / "main.cpp") );
+				CHECK_FALSE( pack.Exists(packPath / "sounds") );
+			}
+			THEN( "directories can be listed" ) {
+				CHECK( pack.ListFiles(packPath / "data", false, false)
+					== std::vector<std::filesystem::path>{packPath / "data/map.txt"} );
+				CHECK( pack.ListFiles(packPath / "data", true, false).size() == 2 );
+				CHECK( pack.ListFiles(packPath, false, true)
+					== std::vector<std::filesystem::path>{packPath / "data", packPath / "images"} );
+				CHECK( pack.ListFiles(packPath / "images", true, true)
+					== std::vector<std::filesystem::path>{packPath / "images/ship"} );
+			}
+		}
+		std::filesystem::remove_all(directory);
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,122 @@
+/* test_pixelKernels.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/image/PixelKernels.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Pixels covering every value of each channel, in more than one vector
+// register's worth plus a few left over.
+std::vector<uint32_t> Pixels(size_t count)
+{
+	std::vector<uint32_t> pixels(count);
+	uint32_t state = 12345;
+	for(uint32_t &pixel : pixels)
+	{
+		state = state * 1664525 + 1013904223;
+		pixel = state;
+	}
+	// Make sure the extremes are included.
+	pixels[0] = 0xFFFFFFFF;
+	pixels[1] = 0x00FFFFFF;
+	pixels[2] = 0xFF000000;
+	return pixels;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Premultiplying pixels", "[PixelKernels]" ) {
+	GIVEN( "a row of arbitrary pixels" ) {
+		const std::vector<uint32_t> original = Pixels(1027);
+
+		const BlendingMode modes[] = {BlendingMode::ALPHA, BlendingMode::HALF_ADDITIVE, BlendingMode::ADDITIVE};
+
+		WHEN( "they are premultiplied for each blending mode" ) {
+			THEN( "the vectorized result matches the scalar reference" ) {
+				for(BlendingMode blend : modes)
+				{
+					std::vector<uint32_t> fast = original;
+					std::vector<uint32_t> reference = original;
+					PixelKernels::Premultiply(fast.data(), fast.size(), blend);
+					PixelKernels::PremultiplyScalar(reference.data(), reference.size(), blend);
+					CHECK( fast == reference );
+				}
+			}
+		}
+		WHEN( "they are premultiplied for alpha blending" ) {
+			std::vector<uint32_t> pixels = original;
+			PixelKernels::PremultiplyScalar(pixels.data(), pixels.size(), BlendingMode::ALPHA);
+
+			THEN( "opaque pixels are unchanged and transparent ones become black" ) {
+				CHECK( pixels[0] == 0xFFFFFFFF );
+				CHECK( pixels[1] == 0 );
+				CHECK( pixels[2] == 0xFF000000 );
+			}
+		}
+		WHEN( "they are premultiplied for additive blending" ) {
+			std::vector<uint32_t> pixels = original;
+			PixelKernels::PremultiplyScalar(pixels.data(), pixels.size(), BlendingMode::ADDITIVE);
+
+			THEN( "their alpha is cleared" ) {
+				CHECK( pixels[0] == 0x00FFFFFF );
+			}
+		}
+	}
+}
+
+SCENARIO( "Shrinking rows of pixels", "[PixelKernels]" ) {
+	GIVEN( "two rows of arbitrary pixels" ) {
+		const std::vector<uint32_t> top = Pixels(2 * 515);
+		const std::vector<uint32_t> bottom(top.rbegin(), top.rend());
+
+		WHEN( "they are averaged into a row of half the width" ) {
+			std::vector<uint32_t> fast(515);
+			std::vector<uint32_t> reference(515);
+			PixelKernels::Shrink(top.data(), bottom.data(), fast.data(), fast.size());
+			PixelKernels::ShrinkScalar(top.data(), bottom.data(), reference.data(), reference.size());
+
+			THEN( "the vectorized result matches the scalar reference" ) {
+				CHECK( fast == reference );
+			}
+		}
+	}
+	GIVEN( "a square of four known pixels" ) {
+		const uint32_t top[2] = {0x00000000, 0x04080C10};
+		const uint32_t bottom[2] = {0xFFFFFFFF, 0x01010101};
+		uint32_t out = 0;
+		PixelKernels::ShrinkScalar(top, bottom, &out, 1);
+
+		THEN( "each channel is rounded to the nearest average" ) {
+			CHECK( out == 0x41424344 );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -19,6 +19,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/Random.h"
 
 // ... and any system includes needed for the test file.
+#include <cstdint>
+#include <thread>
+#include <vector>
 
 namespace { // test namespace
 
@@ -31,6 +34,57 @@ namespace { // test namespace
 TEST_CASE( "Random::Int", "[random][int]") {
 	REQUIRE( Random::Int(1) == 0 );
 }
+
+TEST_CASE( "Random::Real", "[random][real]") {
+	for(int i = 0; i < 1000; ++i)
+	{
+		const double value = Random::Real();
+		CHECK( value >= 0. );
+		CHECK( value < 1. );
+	}
+}
+
+SCENARIO( "Seeding the generator", "[random][seed]" ) {
+	GIVEN( "a seed" ) {
+		constexpr uint64_t SEED = 12345;
+		auto Draw = [] {
+			std::vector<uint32_t> values;
+			for(int i = 0; i < 16; ++i)
+				values.push_back(Random::Int());
+			return values;
+		};
+		Random::Seed(SEED);
+		const auto first = Draw();
+
+		WHEN( "the same seed is given again" ) {
+			Random::Seed(SEED);
+			THEN( "the same numbers are produced" ) {
+				CHECK( Draw() == first );
+			}
+		}
+		WHEN( "a different stream of the seed is used" ) {
+			Random::Seed(SEED, 1);
+			const auto second = Draw();
+			THEN( "different numbers are produced" ) {
+				CHECK( second != first );
+			}
+			AND_WHEN( "that stream is used again" ) {
+				Random::Seed(SEED, 1);
+				THEN( "the same numbers are produced" ) {
+					CHECK( Draw() == second );
+				}
+			}
+		}
+		WHEN( "a stream is used on another thread" ) {
+			std::vector<uint32_t> other;
+			std::thread([&other, &Draw] { Random::Seed(SEED, 2); other = Draw(); }).join();
+			Random::Seed(SEED, 2);
+			THEN( "it produces the same numbers there" ) {
+				CHECK( Draw() == other );
+			}
+		}
+	}
+}
 // Test code goes here. Preferably, use scenario-driven language making use of the SCENARIO, GIVEN,
 // WHEN, and THEN macros. (There will be cases where the more traditional TEST_CASE and SECTION macros
 // are better suited to declaration of the public API.)
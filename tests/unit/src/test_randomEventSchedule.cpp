@@ -0,0 +1,90 @@
+/* test_randomEventSchedule.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/RandomEventSchedule.h"
+
+// Include a helper for seeding the random numbers.
+#include "../../../source/Random.h"
+
+// ... and any system includes needed for the test file.
+#include <vector>
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Scheduling events that happen at random", "[RandomEventSchedule]" ) {
+	GIVEN( "an empty schedule" ) {
+		RandomEventSchedule schedule;
+		THEN( "nothing happens" ) {
+			CHECK( schedule.Size() == 0 );
+			CHECK( schedule.Step().empty() );
+		}
+	}
+	GIVEN( "events that always or never happen" ) {
+		RandomEventSchedule schedule;
+		schedule.Add(0.);
+		schedule.Add(1.);
+		schedule.Add(0.);
+		schedule.Add(1.);
+		THEN( "the certain ones happen on every step, in the order they were added" ) {
+			CHECK( schedule.Size() == 4 );
+			for(int i = 0; i < 10; ++i)
+				CHECK( schedule.Step() == std::vector<size_t>{1, 3} );
+		}
+	}
+	GIVEN( "an event with a small chance of happening" ) {
+		Random::Seed(1);
+		RandomEventSchedule schedule;
+		schedule.Add(.01);
+		THEN( "it happens about as often as that chance says" ) {
+			int count = 0;
+			for(int i = 0; i < 100000; ++i)
+				count += schedule.Step().size();
+			CHECK( count > 900 );
+			CHECK( count < 1100 );
+		}
+	}
+	GIVEN( "a schedule that is cleared and filled again" ) {
+		RandomEventSchedule schedule;
+		schedule.Add(1.);
+		schedule.Step();
+		schedule.Clear();
+		schedule.Add(0.);
+		schedule.Add(1.);
+		THEN( "only the new events happen" ) {
+			CHECK( schedule.Step() == std::vector<size_t>{1} );
+		}
+	}
+	GIVEN( "a schedule for some events" ) {
+		RandomEventSchedule schedule;
+		schedule.Add(.5);
+		schedule.Add(2.);
+		THEN( "it only matches the same chances, in the same order" ) {
+			CHECK( schedule.Matches({.5, 1.}) );
+			CHECK( schedule.Matches({.5, 2.}) );
+			CHECK_FALSE( schedule.Matches({1., .5}) );
+			CHECK_FALSE( schedule.Matches({.5, .25}) );
+			CHECK_FALSE( schedule.Matches({.5}) );
+			CHECK_FALSE( schedule.Matches({.5, 1., 1.}) );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
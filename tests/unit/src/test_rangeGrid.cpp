@@ -0,0 +1,71 @@
+/* test_rangeGrid.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/RangeGrid.h"
+
+// ... and any system includes needed for the test file.
+#include <vector>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Finding the items in a RangeGrid that can reach a point", "[RangeGrid]" ) {
+	GIVEN( "an empty grid" ) {
+		RangeGrid grid;
+		grid.Finish();
+		THEN( "nothing is found" ) {
+			CHECK( grid.Empty() );
+			CHECK( grid.InRange(Point()).empty() );
+		}
+	}
+	GIVEN( "a grid of items with different ranges" ) {
+		RangeGrid grid;
+		grid.Add(Point(1000., 0.), 100.);
+		grid.Add(Point(0., 0.), 50.);
+		grid.Add(Point(-30., 0.), 400.);
+		grid.Add(Point(0., -5000.), 10.);
+		grid.Finish();
+		THEN( "only the items that reach the point are found, in the order they were added" ) {
+			CHECK( grid.InRange(Point(10., 0.)) == std::vector<int>{1, 2} );
+			CHECK( grid.InRange(Point(950., 0.)) == std::vector<int>{0} );
+			CHECK( grid.InRange(Point(-400., 0.)) == std::vector<int>{2} );
+			CHECK( grid.InRange(Point(0., -4995.)) == std::vector<int>{3} );
+			CHECK( grid.InRange(Point(0., -1000.)).empty() );
+		}
+		THEN( "an item exactly at its range reaches the point" ) {
+			CHECK( grid.InRange(Point(1100., 0.)) == std::vector<int>{0} );
+		}
+	}
+	GIVEN( "a grid that is cleared and filled again" ) {
+		RangeGrid grid;
+		grid.Add(Point(0., 0.), 100.);
+		grid.Finish();
+		grid.Clear();
+		grid.Add(Point(500., 500.), 10.);
+		grid.Finish();
+		THEN( "only the new items are found" ) {
+			CHECK( grid.InRange(Point(0., 0.)).empty() );
+			CHECK( grid.InRange(Point(505., 500.)) == std::vector<int>{0} );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 // ... and any system includes needed for the test file.
 #include <string>
+#include <vector>
 
 namespace { // test namespace
 // #region mock data
@@ -169,6 +170,63 @@ SCENARIO( "A Set can be reverted to an earlier state", "[Set]" ) {
 		}
 	}
 }
+
+
+SCENARIO( "A Set finds every object it contains", "[Set]" ) {
+	GIVEN( "a Set with many objects" ) {
+		auto s = Set<T>{};
+		std::vector<T *> pointers;
+		for(int i = 0; i < 1000; ++i)
+		{
+			pointers.push_back(s.Get(std::to_string(i)));
+			pointers.back()->a = i;
+		}
+		REQUIRE( s.size() == 1000 );
+
+		THEN( "the pointers returned by Get stay the same" ) {
+			for(int i = 0; i < 1000; ++i)
+				CHECK( s.Find(std::to_string(i)) == pointers[i] );
+			CHECK( s.size() == 1000 );
+		}
+		THEN( "names that were never added are not found" ) {
+			CHECK_FALSE( s.Has("1000") );
+			CHECK( s.Find("-1") == nullptr );
+		}
+		THEN( "iterating over the Set visits the objects in order of their names" ) {
+			std::string previous;
+			for(const auto &it : s)
+			{
+				CHECK( previous < it.first );
+				previous = it.first;
+			}
+		}
+
+		WHEN( "the Set is copied" ) {
+			auto copy = s;
+			THEN( "the copy finds its own objects" ) {
+				for(int i = 0; i < 1000; ++i)
+				{
+					const T *object = copy.Find(std::to_string(i));
+					REQUIRE( object );
+					CHECK( object != pointers[i] );
+					CHECK( object->a == i );
+				}
+			}
+		}
+
+		WHEN( "the Set is reverted to a smaller one" ) {
+			auto smaller = Set<T>{};
+			smaller.Get("7")->a = -1;
+			s.Revert(smaller);
+			THEN( "only the remaining object can be found" ) {
+				CHECK( s.size() == 1 );
+				CHECK( s.Find("7") == pointers[7] );
+				CHECK( s.Find("7")->a == -1 );
+				CHECK_FALSE( s.Has("8") );
+			}
+		}
+	}
+}
 // #endregion unit tests
 
 
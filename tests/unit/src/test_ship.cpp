@@ -98,6 +98,39 @@ SCENARIO( "A Ship::Bay instance is being copied", "[ship][bay]") {
 		}
 	}
 }
+
+SCENARIO( "A Ship with outfits is being copied", "[ship]" ) {
+	GIVEN( "a ship with an outfit installed" ) {
+		Outfit outfit;
+		outfit.Set("outfit space", -10.);
+		Ship source;
+		source.AddOutfit(&outfit, 2);
+		REQUIRE( source.OutfitCount(&outfit) == 2 );
+		REQUIRE( source.Attributes().Get("outfit space") == -20. );
+
+		WHEN( "a copy of it is made" ) {
+			Ship copy(source);
+			THEN( "the copy has the same outfits and attributes" ) {
+				CHECK( copy.Outfits() == source.Outfits() );
+				CHECK( copy.Attributes().Get("outfit space") == -20. );
+			}
+			THEN( "the copy shares them with the source" ) {
+				CHECK( &copy.Outfits() == &source.Outfits() );
+				CHECK( &copy.Attributes() == &source.Attributes() );
+			}
+		}
+		WHEN( "an outfit is added to the copy" ) {
+			Ship copy(source);
+			copy.AddOutfit(&outfit, 1);
+			THEN( "only the copy changes" ) {
+				CHECK( copy.OutfitCount(&outfit) == 3 );
+				CHECK( copy.Attributes().Get("outfit space") == -30. );
+				CHECK( source.OutfitCount(&outfit) == 2 );
+				CHECK( source.Attributes().Get("outfit space") == -20. );
+			}
+		}
+	}
+}
 // Constructing useful Ship instances requires Ship::Load, which requires all of GameData & runtime deps.
 
 
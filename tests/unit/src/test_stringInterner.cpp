@@ -19,6 +19,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/StringInterner.h"
 
 // ... and any system includes needed for the test file.
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace { // test namespace
 // #region mock data
@@ -66,8 +69,89 @@ SCENARIO( "Interning String", "[StringInterner]" ) {
 		}
 	}
 }
+
+
+SCENARIO( "Interning strings from several threads", "[StringInterner]" ) {
+	GIVEN( "many threads interning the same strings" ) {
+		constexpr int THREADS = 4;
+		constexpr int STRINGS = 1000;
+		std::vector<std::vector<const char *>> results(THREADS);
+		std::vector<std::thread> threads;
+		for(int t = 0; t < THREADS; ++t)
+			threads.emplace_back([&results, t]() {
+				for(int i = 0; i < STRINGS; ++i)
+					results[t].push_back(StringInterner::Intern("threaded " + std::to_string(i)));
+			});
+		for(std::thread &thread : threads)
+			thread.join();
+
+		THEN( "every thread gets the same pointers" ) {
+			for(int t = 1; t < THREADS; ++t)
+				CHECK( results[t] == results[0] );
+		}
+		THEN( "the pointers represent the interned strings" ) {
+			for(int i = 0; i < STRINGS; ++i)
+				CHECK( results[0][i] == "threaded " + std::to_string(i) );
+		}
+	}
+}
+
+
+
+SCENARIO( "Using interned string handles", "[InternedString]" ) {
+	GIVEN( "handles to the same and different strings" ) {
+		const InternedString first("handle");
+		const InternedString second(std::string("handle"));
+		const InternedString other("other handle");
+
+		THEN( "handles to the same string are equal" ) {
+			CHECK( first == second );
+			CHECK( first.c_str() == second.c_str() );
+			CHECK( first.Hash() == second.Hash() );
+			CHECK( std::hash<InternedString>{}(first) == first.Hash() );
+		}
+		THEN( "handles to different strings are not equal" ) {
+			CHECK_FALSE( first == other );
+		}
+		THEN( "a handle refers to the same string as StringInterner::Intern" ) {
+			CHECK( first.c_str() == StringInterner::Intern("handle") );
+			CHECK( first.str() == "handle" );
+		}
+	}
+	GIVEN( "an empty handle" ) {
+		const InternedString empty;
+		THEN( "it is equal to a handle to an empty string" ) {
+			CHECK( empty.empty() );
+			CHECK( empty == InternedString("") );
+			CHECK( empty.str().empty() );
+			CHECK( *empty.c_str() == '\0' );
+		}
+	}
+}
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark StringInterner::Intern", "[!benchmark][StringInterner]" ) {
+	constexpr int SIZE = 1000;
+
+	std::vector<std::string> strings;
+	for(int i = 0; i < SIZE; ++i)
+	{
+		strings.emplace_back("interned string " + std::to_string(i));
+		StringInterner::Intern(strings.back().c_str());
+	}
+
+	BENCHMARK( "StringInterner::Intern() of an interned string", i ) {
+		return StringInterner::Intern(strings[i % SIZE].c_str());
+	};
+	BENCHMARK( "InternedString construction", i ) {
+		return InternedString(strings[i % SIZE].c_str());
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
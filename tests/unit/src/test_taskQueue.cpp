@@ -0,0 +1,134 @@
+/* test_taskQueue.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/TaskQueue.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/TaskGroup.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Running a parallel for loop", "[TaskQueue][ParallelFor]" ) {
+	GIVEN( "a range of indices" ) {
+		std::vector<std::atomic<int>> visits(1000);
+
+		WHEN( "every index is visited" ) {
+			std::atomic<size_t> largestChunk = 0;
+			TaskQueue::ParallelFor(0, visits.size(), 7, [&visits, &largestChunk](size_t begin, size_t end) {
+				size_t size = end - begin;
+				size_t largest = largestChunk;
+				while(size > largest && !largestChunk.compare_exchange_weak(largest, size))
+					continue;
+				for(size_t i = begin; i < end; ++i)
+					++visits[i];
+			});
+			THEN( "each index is visited exactly once" ) {
+				for(const auto &count : visits)
+					CHECK( count == 1 );
+			}
+			THEN( "no chunk is larger than requested" ) {
+				CHECK( largestChunk == 7 );
+			}
+		}
+		WHEN( "the range is empty" ) {
+			bool called = false;
+			TaskQueue::ParallelFor(5, 5, 1, [&called](size_t, size_t) { called = true; });
+			THEN( "the function is never called" ) {
+				CHECK_FALSE( called );
+			}
+		}
+		WHEN( "a chunk throws an exception" ) {
+			auto loop = [] {
+				TaskQueue::ParallelFor(0, 100, 1, [](size_t begin, size_t) {
+					if(begin == 50)
+						throw std::runtime_error("chunk failed");
+				});
+			};
+			THEN( "it is rethrown to the caller" ) {
+				CHECK_THROWS_AS( loop(), std::runtime_error );
+			}
+		}
+	}
+}
+
+SCENARIO( "Waiting on a task group", "[TaskGroup]" ) {
+	GIVEN( "a group of tasks" ) {
+		TaskGroup group;
+		std::atomic<int> sum = 0;
+
+		WHEN( "the tasks run parallel loops of their own" ) {
+			for(int i = 0; i < 8; ++i)
+				group.Run([&sum] {
+					TaskQueue::ParallelFor(0, 100, 10, [&sum](size_t begin, size_t end) {
+						for(size_t j = begin; j < end; ++j)
+							sum += static_cast<int>(j);
+					});
+				});
+			group.Wait();
+			THEN( "every task has finished once the wait returns" ) {
+				CHECK( sum == 8 * 4950 );
+			}
+		}
+		WHEN( "a task throws an exception" ) {
+			group.Run([] { throw std::runtime_error("task failed"); });
+			group.Run([&sum] { ++sum; });
+			THEN( "the exception is rethrown by the wait" ) {
+				CHECK_THROWS_AS( group.Wait(), std::runtime_error );
+				CHECK( sum == 1 );
+			}
+		}
+	}
+}
+
+SCENARIO( "Processing main thread tasks with a time limit", "[TaskQueue][ProcessSyncTasks]" ) {
+	GIVEN( "several main thread tasks that each take a while" ) {
+		TaskQueue queue;
+		int done = 0;
+		for(int i = 0; i < 4; ++i)
+			queue.Run([] {}, [&done] {
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				++done;
+			});
+		queue.Wait();
+
+		WHEN( "they are processed with a limit shorter than one task" ) {
+			queue.ProcessSyncTasks(1);
+			THEN( "only one of them is done" ) {
+				CHECK( done == 1 );
+			}
+			AND_WHEN( "they are processed without a limit" ) {
+				queue.ProcessSyncTasks();
+				THEN( "the rest are done" ) {
+					CHECK( done == 4 );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
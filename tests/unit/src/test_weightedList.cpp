@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 // ... and any system includes needed for the test file.
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <stdexcept>
@@ -422,6 +423,44 @@ SCENARIO( "Obtaining a random value", "[WeightedList][Usage]" ) {
 	}
 }
 
+SCENARIO( "Obtaining a random value after erasing", "[WeightedList][Usage]" ) {
+	GIVEN( "a list with multiple items" ) {
+		auto list = WeightedList<Object>{};
+		for(int i = 0; i < 10; ++i)
+			list.emplace_back(i + 1, i);
+		REQUIRE( list.TotalWeight() == 55 );
+
+		WHEN( "some items are erased" ) {
+			erase_if(list, [](const Object &o) noexcept -> bool { return o.GetValue() % 3 == 0; });
+			const int first = list.begin()->GetValue();
+			list.eraseAt(list.begin());
+			// Each item's weight is one more than its value.
+			std::size_t remaining = 0;
+			for(const Object &o : list)
+				remaining += o.GetValue() + 1;
+			REQUIRE( list.TotalWeight() == remaining );
+
+			THEN( "only the remaining items are selected" ) {
+				for(int i = 0; i < 1000; ++i)
+				{
+					const int value = list.Get().GetValue();
+					CHECK( value % 3 != 0 );
+					CHECK( value != first );
+				}
+			}
+			AND_WHEN( "more items are added" ) {
+				list.emplace_back(1000, 42);
+				THEN( "the new item is selected in accordance with its weight" ) {
+					int picked = 0;
+					for(int i = 0; i < 1000; ++i)
+						picked += list.Get().GetValue() == 42;
+					CHECK( picked > 900 );
+				}
+			}
+		}
+	}
+}
+
 SCENARIO( "Test WeightedList error conditions.", "[WeightedList]" ) {
 	GIVEN( "a new weighted list" ) {
 		auto list = WeightedList<Object>{};
@@ -450,4 +489,26 @@ SCENARIO( "Test WeightedList error conditions.", "[WeightedList]" ) {
 
 
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark WeightedList::Get", "[!benchmark][WeightedList]" ) {
+	auto small = WeightedList<Object>{};
+	for(int i = 0; i < 8; ++i)
+		small.emplace_back(i + 1, i);
+	auto large = WeightedList<Object>{};
+	for(int i = 0; i < 1000; ++i)
+		large.emplace_back(i % 50 + 1, i);
+
+	BENCHMARK( "WeightedList::Get() with 8 choices" ) {
+		return small.Get().GetValue();
+	};
+	BENCHMARK( "WeightedList::Get() with 1000 choices" ) {
+		return large.Get().GetValue();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
 } // test namespace
@@ -0,0 +1,83 @@
+/* test_layoutCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/text/LayoutCache.h"
+
+// Include a helper for creating the fonts that keys refer to.
+#include "../../../../source/text/Font.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Looking up layouts in a LayoutCache", "[text][layoutCache]" ) {
+	GIVEN( "a cache with room for two layouts" ) {
+		const Font font;
+		const Font other;
+		LayoutCache<int> cache(2);
+		cache.Insert(LayoutKey(font, "first", 100), 1);
+		cache.Insert(LayoutKey(font, "second", 100), 2);
+
+		THEN( "stored layouts are found by their key" ) {
+			REQUIRE( cache.Find(LayoutKey(font, "first", 100)) );
+			CHECK( *cache.Find(LayoutKey(font, "first", 100)) == 1 );
+			REQUIRE( cache.Find(LayoutKey(font, "second", 100)) );
+			CHECK( *cache.Find(LayoutKey(font, "second", 100)) == 2 );
+		}
+		THEN( "keys that differ in any setting do not match" ) {
+			CHECK_FALSE( cache.Find(LayoutKey(other, "first", 100)) );
+			CHECK_FALSE( cache.Find(LayoutKey(font, "first", 99)) );
+			CHECK_FALSE( cache.Find(LayoutKey(font, "first", 100, Alignment::RIGHT)) );
+			CHECK_FALSE( cache.Find(LayoutKey(font, "first", 100, Alignment::LEFT, Truncate::BACK)) );
+			LayoutKey key(font, "first", 100);
+			key.lineHeight = 20;
+			CHECK_FALSE( cache.Find(key) );
+		}
+		WHEN( "a third layout is stored" ) {
+			CHECK( cache.Find(LayoutKey(font, "first", 100)) );
+			cache.Insert(LayoutKey(font, "third", 100), 3);
+			THEN( "the least recently used layout is dropped" ) {
+				CHECK( cache.Find(LayoutKey(font, "first", 100)) );
+				CHECK_FALSE( cache.Find(LayoutKey(font, "second", 100)) );
+				CHECK( cache.Find(LayoutKey(font, "third", 100)) );
+			}
+		}
+		WHEN( "a layout is stored again" ) {
+			cache.Insert(LayoutKey(font, "first", 100), 4);
+			THEN( "it replaces the old one" ) {
+				REQUIRE( cache.Find(LayoutKey(font, "first", 100)) );
+				CHECK( *cache.Find(LayoutKey(font, "first", 100)) == 4 );
+				CHECK( cache.Find(LayoutKey(font, "second", 100)) );
+			}
+		}
+		WHEN( "the keys are invalidated" ) {
+			LayoutKey::Invalidate();
+			THEN( "no stored layout matches" ) {
+				CHECK_FALSE( cache.Find(LayoutKey(font, "first", 100)) );
+				CHECK_FALSE( cache.Find(LayoutKey(font, "second", 100)) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,115 @@
+/* test_textTemplate.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/text/TextTemplate.h"
+
+// ... utility classes
+#include "../../../../source/text/Format.h"
+
+// ... and any system includes needed for the test file.
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace { // test namespace
+
+// #region mock data
+const std::map<std::string, std::string> keys = {
+	{"<planet>", "Earth"},
+	{"<system>", "Sol"},
+	{"<b>", "bold"},
+	{"<empty>", ""},
+};
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Scanning a template for placeholders", "[TextTemplate]" ) {
+	GIVEN( "text with angle bracket placeholders" ) {
+		const TextTemplate text("Land on <planet> in the <system> system, then leave <planet>.");
+		THEN( "each placeholder is listed once, in order" ) {
+			REQUIRE( text.Names().size() == 2 );
+			CHECK( text.Names()[0] == "<planet>" );
+			CHECK( text.Names()[1] == "<system>" );
+			CHECK( text.Index("<system>") == 1 );
+			CHECK( text.Index("<npc>") == -1 );
+		}
+	}
+	GIVEN( "text with double brace placeholders" ) {
+		const TextTemplate text("Sold for {{amount}}, {{ amount }} and <amount>.", TextTemplate::Syntax::DOUBLE_BRACES);
+		THEN( "only the braced placeholders are found, without their braces" ) {
+			REQUIRE( text.Names().size() == 2 );
+			CHECK( text.Names()[0] == "amount" );
+			CHECK( text.Names()[1] == " amount " );
+		}
+	}
+}
+
+SCENARIO( "Filling in a template", "[TextTemplate]" ) {
+	GIVEN( "any text" ) {
+		auto source = GENERATE(as<std::string>{},
+			"",
+			"No placeholders at all.",
+			"Land on <planet> in the <system> system, then leave <planet>.",
+			"<planet><system><planet>",
+			"An <unknown> placeholder next to <planet>.",
+			"Nested <a <b> brackets, and <empty> values.",
+			"An unclosed <planet bracket",
+			"A stray > and a < before <system>.");
+		THEN( "the result is the same as replacing the keys in the text" ) {
+			CHECK( TextTemplate(source).Expand(keys) == Format::Replace(source, keys) );
+			CHECK( Format::Replace(TextTemplate(source), keys) == Format::Replace(source, keys) );
+		}
+	}
+	GIVEN( "values given by name" ) {
+		const TextTemplate text("{{count}} {{noun}} will hold position.", TextTemplate::Syntax::DOUBLE_BRACES);
+		THEN( "each placeholder is filled in with the value of the same name" ) {
+			CHECK( text.Expand({{"noun", "ships"}, {"count", "3"}}) == "3 ships will hold position." );
+		}
+		THEN( "a missing value leaves its placeholder in the text" ) {
+			CHECK( text.Expand({{"count", "3"}}) == "3 {{noun}} will hold position." );
+		}
+	}
+	GIVEN( "values given by index" ) {
+		const TextTemplate text("<planet> is in <system>.");
+		const std::string_view system = "Sol";
+		const std::string_view *values[] = {nullptr, &system};
+		THEN( "a null value leaves its placeholder in the text" ) {
+			CHECK( text.Expand(values) == "<planet> is in Sol." );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark TextTemplate::Expand", "[!benchmark][textTemplate]" ) {
+	const std::string source = "Land on <planet> in the <system> system, then return to <planet> for your payment.";
+	const TextTemplate text(source);
+	BENCHMARK( "Format::Replace()" ) {
+		return Format::Replace(source, keys);
+	};
+	BENCHMARK( "TextTemplate::Expand()" ) {
+		return text.Expand(keys);
+	};
+}
+#endif
+// #endregion benchmarks
+
+} // test namespace
@@ -0,0 +1,122 @@
+/* test_utf8.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/text/Utf8.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// Decode a string one code point at a time.
+std::vector<char32_t> DecodeEach(const std::string &str)
+{
+	std::vector<char32_t> result;
+	size_t pos = 0;
+	while(pos < str.size())
+		result.push_back(Utf8::DecodeCodePoint(str, pos));
+	return result;
+}
+
+// Decode a string with DecodeCodePoints, the given number of code points at a time.
+std::vector<char32_t> DecodeBatched(const std::string &str, size_t count)
+{
+	std::vector<char32_t> result;
+	std::vector<char32_t> buffer(count);
+	size_t pos = 0;
+	while(pos < str.size())
+	{
+		size_t decoded = Utf8::DecodeCodePoints(str, pos, buffer.data(), count);
+		result.insert(result.end(), buffer.begin(), buffer.begin() + decoded);
+	}
+	return result;
+}
+
+const std::string ascii = "Shields: 4,500  Hull: 3,200  Fuel: 600 / 600  Crew: 12";
+// "Щиты: 4 500, корпус: 3 200" followed by an em dash and "топливо".
+const std::string cyrillic = "Щиты: 4 500, корпус: 3 200 "
+	"— топливо топливо";
+
+// #region unit tests
+SCENARIO( "Counting ASCII bytes", "[text][utf8]" ) {
+	GIVEN( "a string" ) {
+		THEN( "every byte of plain ASCII is counted" ) {
+			CHECK( Utf8::AsciiLength(ascii, 0) == ascii.size() );
+			CHECK( Utf8::AsciiLength(ascii, 10) == ascii.size() - 10 );
+			CHECK( Utf8::AsciiLength(ascii, ascii.size()) == 0 );
+		}
+		THEN( "counting stops at the first byte that is not ASCII" ) {
+			const std::string text = ascii + ascii + "Щ" + ascii;
+			CHECK( Utf8::AsciiLength(text, 0) == 2 * ascii.size() );
+			CHECK( Utf8::AsciiLength(text, 2 * ascii.size()) == 0 );
+		}
+	}
+}
+
+SCENARIO( "Decoding many code points at once", "[text][utf8]" ) {
+	GIVEN( "text in various scripts" ) {
+		const std::string mixed = ascii + cyrillic + "\U0001F600" + cyrillic + cyrillic + ascii;
+		THEN( "the results match decoding one code point at a time" ) {
+			for(size_t count : {1, 3, 8, 16, 64})
+			{
+				CHECK( DecodeBatched(ascii, count) == DecodeEach(ascii) );
+				CHECK( DecodeBatched(cyrillic, count) == DecodeEach(cyrillic) );
+				CHECK( DecodeBatched(mixed, count) == DecodeEach(mixed) );
+			}
+		}
+	}
+	GIVEN( "text with invalid bytes" ) {
+		std::string invalid = cyrillic;
+		invalid[3] = '\x41';
+		invalid[20] = '\xFF';
+		invalid += '\xD0';
+		THEN( "the invalid bytes are decoded the same way as one at a time" ) {
+			CHECK( DecodeBatched(invalid, 64) == DecodeEach(invalid) );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Utf8::DecodeCodePoints", "[!benchmark][utf8]" ) {
+	std::string longAscii;
+	std::string longCyrillic;
+	for(int i = 0; i < 20; ++i)
+	{
+		longAscii += ascii;
+		longCyrillic += cyrillic;
+	}
+	BENCHMARK( "Utf8::DecodeCodePoint() on ASCII text" ) {
+		return DecodeEach(longAscii);
+	};
+	BENCHMARK( "Utf8::DecodeCodePoints() on ASCII text" ) {
+		return DecodeBatched(longAscii, 64);
+	};
+	BENCHMARK( "Utf8::DecodeCodePoint() on Cyrillic text" ) {
+		return DecodeEach(longCyrillic);
+	};
+	BENCHMARK( "Utf8::DecodeCodePoints() on Cyrillic text" ) {
+		return DecodeBatched(longCyrillic, 64);
+	};
+}
+#endif
+// #endregion benchmarks
+
+} // test namespace